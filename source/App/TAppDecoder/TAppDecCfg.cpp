@@ -41,6 +41,9 @@
 #include "TAppDecCfg.h"
 #include "TAppCommon/program_options_lite.h"
 #include "TLibCommon/TComChromaFormat.h"
+#if SIMD_RUNTIME_DISPATCH
+#include "TLibCommon/TComRom.h"
+#endif
 #ifdef WIN32
 #define strdup _strdup
 #endif
@@ -89,6 +92,18 @@ Bool TAppDecCfg::parseCfg( Int argc, Char* argv[] )
   ("RespectDefDispWindow,w",    m_respectDefDispWindow,                0,          "Only output content inside the default display window\n")
 #if O0043_BEST_EFFORT_DECODING
   ("ForceDecodeBitDepth",       m_forceDecodeBitDepth,                 0U,         "Force the decoder to operate at a particular bit-depth (best effort decoding)")
+#endif
+#if PARALLEL_SUBSTREAM_DECODING
+  ("SubstreamThreads",          m_numSubstreamThreads,                 1,          "Number of threads decoding the substreams (tiles, wavefront rows) of a slice in parallel (1: single-threaded decoding)")
+#endif
+#if PARALLEL_ALF
+  ("ALFThreads",                m_numAlfThreads,                       1,          "Number of threads running the adaptive loop filter (1: single-threaded filtering)")
+#endif
+#if PARALLEL_FRAME_DECODING
+  ("FramePipelining",           m_framePipelining,                     false,      "Loop-filter each picture on a separate thread while the next picture is decoded")
+#endif
+#if SIMD_RUNTIME_DISPATCH
+  ("SIMD",                      m_simdLevel,                           -1,         "Widest SIMD instruction set used, capped to what the CPU supports (-1: auto, 0: C, 1: SSE2, 2: AVX2, 3: AVX-512)")
 #endif
   ("OutputDecodedSEIMessagesFilename",  m_outputDecodedSEIMessagesFilename,    string(""), "When non empty, output decoded SEI messages to the indicated file. If file is '-', then output to stdout\n")
   ("ClipOutputVideoToRec709Range",      m_bClipOutputVideoToRec709Range,  false, "If true then clip output video to the Rec. 709 Range on saving")
@@ -135,6 +150,15 @@ Bool TAppDecCfg::parseCfg( Int argc, Char* argv[] )
     return false;
   }
 
+#if SIMD_RUNTIME_DISPATCH
+  if ( m_simdLevel < SIMD_AUTO || m_simdLevel > SIMD_AVX512 )
+  {
+    fprintf(stderr, "SIMD must be in the range -1 to 3\n");
+    return false;
+  }
+  initSimdLevel( SimdLevel( m_simdLevel ) );
+#endif
+
   if ( !cfg_TargetDecLayerIdSetFile.empty() )
   {
     FILE* targetDecLayerIdSetFile = fopen ( cfg_TargetDecLayerIdSetFile.c_str(), "r" );
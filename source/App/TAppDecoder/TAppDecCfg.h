@@ -69,6 +69,18 @@ protected:
   Int           m_respectDefDispWindow;               ///< Only output content inside the default display window
 #if O0043_BEST_EFFORT_DECODING
   UInt          m_forceDecodeBitDepth;                ///< if non-zero, force the bit depth at the decoder (best effort decoding)
+#endif
+#if PARALLEL_SUBSTREAM_DECODING
+  Int           m_numSubstreamThreads;                ///< number of threads decoding the substreams (tiles, wavefront rows) of a slice
+#endif
+#if PARALLEL_ALF
+  Int           m_numAlfThreads;                      ///< number of threads running the adaptive loop filter
+#endif
+#if PARALLEL_FRAME_DECODING
+  Bool          m_framePipelining;                    ///< loop-filter each picture on a separate thread while the next picture is decoded
+#endif
+#if SIMD_RUNTIME_DISPATCH
+  Int           m_simdLevel;                          ///< widest SIMD instruction set the kernels may use (SimdLevel, -1: widest supported by the CPU)
 #endif
   std::string   m_outputDecodedSEIMessagesFilename;   ///< filename to output decoded SEI messages to. If '-', then use stdout. If empty, do not output details.
   Bool          m_bClipOutputVideoToRec709Range;      ///< If true, clip the output video to the Rec 709 range on saving.
@@ -85,6 +97,18 @@ public:
   , m_respectDefDispWindow(0)
 #if O0043_BEST_EFFORT_DECODING
   , m_forceDecodeBitDepth(0)
+#endif
+#if PARALLEL_SUBSTREAM_DECODING
+  , m_numSubstreamThreads(1)
+#endif
+#if PARALLEL_ALF
+  , m_numAlfThreads(1)
+#endif
+#if PARALLEL_FRAME_DECODING
+  , m_framePipelining(false)
+#endif
+#if SIMD_RUNTIME_DISPATCH
+  , m_simdLevel(SIMD_AUTO)
 #endif
   {
     for (UInt channelTypeIndex = 0; channelTypeIndex < MAX_NUM_CHANNEL_TYPE; channelTypeIndex++)
@@ -236,10 +236,16 @@ Void TAppDecTop::decode()
             || nalu.m_nalUnitType == NAL_UNIT_CODED_SLICE_BLA_W_RADL
             || nalu.m_nalUnitType == NAL_UNIT_CODED_SLICE_BLA_W_LP ) )
       {
+#if PARALLEL_FRAME_DECODING
+        m_cTDecTop.finishLoopFilters();
+#endif
         xFlushOutput( pcListPic );
       }
       if (nalu.m_nalUnitType == NAL_UNIT_EOS)
       {
+#if PARALLEL_FRAME_DECODING
+        m_cTDecTop.finishLoopFilters();
+#endif
         xWriteOutput( pcListPic, nalu.m_temporalId );
         m_cTDecTop.setFirstSliceInPicture (false);
       }
@@ -251,6 +257,9 @@ Void TAppDecTop::decode()
     }
   }
 
+#if PARALLEL_FRAME_DECODING
+  m_cTDecTop.finishLoopFilters();
+#endif
   xFlushOutput( pcListPic );
   // delete buffers
   m_cTDecTop.deletePicBuffer();
@@ -298,6 +307,15 @@ Void TAppDecTop::xInitDecLib()
   m_cTDecTop.setDecodedPictureHashSEIEnabled(m_decodedPictureHashSEIEnabled);
 #if O0043_BEST_EFFORT_DECODING
   m_cTDecTop.setForceDecodeBitDepth(m_forceDecodeBitDepth);
+#endif
+#if PARALLEL_SUBSTREAM_DECODING
+  m_cTDecTop.setNumSubstreamThreads(m_numSubstreamThreads);
+#endif
+#if PARALLEL_ALF
+  m_cTDecTop.setNumAlfThreads(m_numAlfThreads);
+#endif
+#if PARALLEL_FRAME_DECODING
+  m_cTDecTop.setFramePipelining(m_framePipelining);
 #endif
   if (!m_outputDecodedSEIMessagesFilename.empty())
   {
@@ -374,6 +392,12 @@ Void TAppDecTop::xWriteOutput( TComList<TComPic*>* pcListPic, UInt tId )
           (!(pcPicTop->getPOC()%2) && pcPicBottom->getPOC() == pcPicTop->getPOC()+1) &&
           (pcPicTop->getPOC() == m_iPOCLastDisplay+1 || m_iPOCLastDisplay < 0))
       {
+#if PARALLEL_FRAME_DECODING
+        if ( pcPicTop->getLoopFilterPending() || pcPicBottom->getLoopFilterPending() )
+        {
+          break;  // output in display order resumes once the field pair is filtered
+        }
+#endif
         // write to file
         numPicsNotYetDisplayed = numPicsNotYetDisplayed-2;
         if ( m_pchReconFile )
@@ -438,6 +462,12 @@ Void TAppDecTop::xWriteOutput( TComList<TComPic*>* pcListPic, UInt tId )
       if(pcPic->getOutputMark() && pcPic->getPOC() > m_iPOCLastDisplay &&
         (numPicsNotYetDisplayed >  numReorderPicsHighestTid || dpbFullness > maxDecPicBufferingHighestTid))
       {
+#if PARALLEL_FRAME_DECODING
+        if ( pcPic->getLoopFilterPending() )
+        {
+          break;  // output in display order resumes once the picture is filtered
+        }
+#endif
         // write to file
          numPicsNotYetDisplayed--;
         if(pcPic->getSlice(0)->isReferenced() == false)
@@ -951,6 +951,21 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
   ("TileRowHeightArray",                              cfg_RowHeight,                            cfg_RowHeight, "Array containing tile row height values in units of CTU")
   ("LFCrossTileBoundaryFlag",                         m_bLFCrossTileBoundaryFlag,                        true, "1: cross-tile-boundary loop filtering. 0:non-cross-tile-boundary loop filtering")
   ("WaveFrontSynchro",                                m_iWaveFrontSynchro,                                  0, "0: no synchro; 1 synchro with top-right-right")
+#if PARALLEL_SUBSTREAM_ENCODING
+  ("SubstreamThreads",                                m_numSubstreamThreads,                                1, "Number of threads compressing the substreams (wavefront rows, tiles) of a slice in parallel (1: single-threaded)")
+#endif
+#if PARALLEL_ALF
+  ("ALFThreads",                                      m_numAlfThreads,                                      1, "Number of threads running the adaptive loop filter (1: single-threaded)")
+#endif
+#if PARALLEL_SEGMENT_ENCODING
+  ("SegmentThreads",                                  m_numSegmentThreads,                                  1, "Number of threads encoding the intra-period segments of the sequence in parallel into one bitstream (1: sequential encoding)")
+#endif
+#if PARALLEL_PICTURE_ENCODING
+  ("PictureThreads",                                  m_numPictureThreads,                                  1, "Number of threads compressing the pictures of a GOP whose reference pictures are final in parallel, with the coding statistics at the start of the GOP (1: sequential encoding)")
+#endif
+#if SIMD_RUNTIME_DISPATCH
+  ("SIMD",                                            m_simdLevel,                                         -1, "Widest SIMD instruction set used, capped to what the CPU supports (-1: auto, 0: C, 1: SSE2, 2: AVX2, 3: AVX-512)")
+#endif
   ("ScalingList",                                     m_useScalingListId,                    SCALING_LIST_OFF, "0/off: no scaling list, 1/default: default scaling lists, 2/file: scaling lists specified in ScalingListFile")
   ("ScalingListFile",                                 cfg_ScalingListFile,                         string(""), "Scaling list file name. Use an empty string to produce help.")
   ("SignHideFlag,-SBH",                               m_signHideFlag,                                    true)
@@ -1680,6 +1695,9 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
 
   m_uiMaxTotalCUDepth = m_uiMaxCUDepth + uiAddCUDepth + getMaxCUDepthOffset(m_chromaFormatIDC, m_uiQuadtreeTULog2MinSize); // if minimum TU larger than 4x4, allow for additional part indices for 4:2:2 SubTUs.
   m_uiLog2DiffMaxMinCodingBlockSize = m_uiMaxCUDepth - 1;
+#endif
+#if SIMD_RUNTIME_DISPATCH
+  initSimdLevel( SimdLevel( m_simdLevel ) );
 #endif
   // print-out parameters
   xPrintParameter();
@@ -2501,6 +2519,38 @@ Void TAppEncCfg::xCheckParameter()
   }
 
   xConfirmPara( m_iWaveFrontSynchro < 0, "WaveFrontSynchro cannot be negative" );
+#if PARALLEL_SUBSTREAM_ENCODING
+  xConfirmPara( m_numSubstreamThreads < 1, "SubstreamThreads must be at least 1" );
+#endif
+#if PARALLEL_ALF
+  xConfirmPara( m_numAlfThreads < 1, "ALFThreads must be at least 1" );
+#endif
+#if PARALLEL_SEGMENT_ENCODING
+  xConfirmPara( m_numSegmentThreads < 1, "SegmentThreads must be at least 1" );
+  if (m_numSegmentThreads > 1)
+  {
+    xConfirmPara( m_iIntraPeriod <= 0 || m_iIntraPeriod % m_iGOPSize != 0, "SegmentThreads > 1 requires an IntraPeriod that is a multiple of the GOPSize" );
+    xConfirmPara( m_iDecodingRefreshType != 1, "SegmentThreads > 1 requires DecodingRefreshType 1 (CRA pictures starting the segments)" );
+    xConfirmPara( m_RCEnableRateControl, "SegmentThreads > 1 cannot be used with rate control" );
+    xConfirmPara( m_isField, "SegmentThreads > 1 cannot be used with field coding" );
+  }
+#endif
+#if SIMD_RUNTIME_DISPATCH
+  xConfirmPara( m_simdLevel < SIMD_AUTO || m_simdLevel > SIMD_AVX512, "SIMD must be in the range -1 to 3" );
+#endif
+#if PARALLEL_PICTURE_ENCODING
+  xConfirmPara( m_numPictureThreads < 1, "PictureThreads must be at least 1" );
+  if (m_numPictureThreads > 1)
+  {
+    xConfirmPara( m_RCEnableRateControl, "PictureThreads > 1 cannot be used with rate control" );
+#if ADAPTIVE_QP_SELECTION
+    xConfirmPara( m_bUseAdaptQpSelect, "PictureThreads > 1 cannot be used with adaptive QP selection" );
+#endif
+    xConfirmPara( m_uiDeltaQpRD > 0, "PictureThreads > 1 requires DeltaQpRD 0" );
+    xConfirmPara( m_sliceMode != NO_SLICES || m_sliceSegmentMode != NO_SLICES, "PictureThreads > 1 requires a single slice per picture" );
+    xConfirmPara( m_isField, "PictureThreads > 1 cannot be used with field coding" );
+  }
+#endif
 
   xConfirmPara( m_decodedPictureHashSEIEnabled<0 || m_decodedPictureHashSEIEnabled>3, "this hash type is not correct!\n");
 
@@ -2790,6 +2840,21 @@ Void TAppEncCfg::xPrintParameter()
 #endif
   printf(" WaveFrontSynchro:%d WaveFrontSubstreams:%d",
           m_iWaveFrontSynchro, iWaveFrontSubstreams);
+#if PARALLEL_SUBSTREAM_ENCODING
+  printf(" SubstreamThreads:%d", m_numSubstreamThreads);
+#endif
+#if PARALLEL_ALF
+  printf(" ALFThreads:%d", m_numAlfThreads);
+#endif
+#if PARALLEL_SEGMENT_ENCODING
+  printf(" SegmentThreads:%d", m_numSegmentThreads);
+#endif
+#if PARALLEL_PICTURE_ENCODING
+  printf(" PictureThreads:%d", m_numPictureThreads);
+#endif
+#if SIMD_RUNTIME_DISPATCH
+  printf(" SIMD:%s", getSimdLevelName( g_eSimdLevel ));
+#endif
   printf(" ScalingList:%d ", m_useScalingListId );
   printf("TMVPMode:%d ", m_TMVPModeId     );
 #if ADAPTIVE_QP_SELECTION
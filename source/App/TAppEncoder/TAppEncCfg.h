@@ -273,6 +273,21 @@ protected:
   std::vector<Int> m_tileRowHeight;
   Int       m_iWaveFrontSynchro; //< 0: no WPP. >= 1: WPP is enabled, the "Top right" from which inheritance occurs is this LCU offset in the line above the current.
   Int       m_iWaveFrontFlush; //< enable(1)/disable(0) the CABAC flush at the end of each line of LCUs.
+#if PARALLEL_SUBSTREAM_ENCODING
+  Int       m_numSubstreamThreads;                            ///< number of threads compressing the substreams (wavefront rows, tiles) of a slice
+#endif
+#if PARALLEL_ALF
+  Int       m_numAlfThreads;                                  ///< number of threads running the adaptive loop filter
+#endif
+#if PARALLEL_SEGMENT_ENCODING
+  Int       m_numSegmentThreads;                              ///< number of threads encoding the intra-period segments of the sequence
+#endif
+#if PARALLEL_PICTURE_ENCODING
+  Int       m_numPictureThreads;                              ///< number of threads compressing the pictures of a GOP
+#endif
+#if SIMD_RUNTIME_DISPATCH
+  Int       m_simdLevel;                                      ///< widest SIMD instruction set the kernels may use (SimdLevel, -1: widest supported by the CPU)
+#endif
 
   Bool      m_bUseConstrainedIntraPred;                       ///< flag for using constrained intra prediction
   Bool      m_bFastUDIUseMPMEnabled;
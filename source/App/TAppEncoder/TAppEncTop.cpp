@@ -45,6 +45,9 @@
 
 #include "TAppEncTop.h"
 #include "TLibEncoder/AnnexBwrite.h"
+#if PARALLEL_SEGMENT_ENCODING
+#include <algorithm>
+#endif
 
 using namespace std;
 
@@ -372,6 +375,15 @@ Void TAppEncTop::xInitLibCfg()
   }
   m_cTEncTop.setLFCrossTileBoundaryFlag                           ( m_bLFCrossTileBoundaryFlag );
   m_cTEncTop.setWaveFrontSynchro                                  ( m_iWaveFrontSynchro );
+#if PARALLEL_SUBSTREAM_ENCODING
+  m_cTEncTop.setNumSubstreamThreads                               ( m_numSubstreamThreads );
+#endif
+#if PARALLEL_ALF
+  m_cTEncTop.setNumAlfThreads                                     ( m_numAlfThreads );
+#endif
+#if PARALLEL_PICTURE_ENCODING
+  m_cTEncTop.setNumPictureThreads                                 ( m_numPictureThreads );
+#endif
   m_cTEncTop.setTMVPModeId                                        ( m_TMVPModeId );
   m_cTEncTop.setUseScalingListId                                  ( m_useScalingListId  );
   m_cTEncTop.setScalingListFile                                   ( m_scalingListFile   );
@@ -609,6 +621,14 @@ Void TAppEncTop::encode()
   }
 #endif
 
+#if PARALLEL_SEGMENT_ENCODING
+  if ( m_numSegmentThreads > 1 )
+  {
+    xEncodeSegments(bitstreamFile);
+    bEos = true;
+  }
+
+#endif
   while ( !bEos )
   {
     // get buffers
@@ -802,6 +822,251 @@ Void TAppEncTop::xWriteOutput(std::ostream& bitstreamFile, Int iNumEncoded, cons
   }
 }
 
+#if PARALLEL_SEGMENT_ENCODING
+/**
+ - split the sequence into segments of one intra period, the last picture of a segment being the first one of the next segment
+ - encode each segment with its own encoder instance on its own thread, at most SegmentThreads segments at a time
+ - write the segments in order into one bitstream, as parcat does with the bitstreams of separate encoder processes
+ .
+ The input file is read by the calling thread only, the pictures of a segment are read before its thread is started.
+ */
+Void TAppEncTop::xEncodeSegments(std::ostream& bitstreamFile)
+{
+  const InputColourSpaceConversion ipCSC = m_inputColourSpaceConvert;
+  const Int numSegments = std::max(1, (m_framesToBeEncoded - 1 + m_iIntraPeriod - 1) / m_iIntraPeriod);
+
+  std::list<Segment*> startedSegments;      ///< segments being encoded or waiting to be written, in order
+  TComPicYuv* pcBoundaryPicYuvOrg     = xNewPicYuv();
+  TComPicYuv* pcBoundaryPicYuvTrueOrg = xNewPicYuv();
+  Bool bEof = false;
+
+  for (Int iSegment = 0; iSegment < numSegments && !bEof; iSegment++)
+  {
+    if (startedSegments.size() >= UInt(m_numSegmentThreads))
+    {
+      xWriteSegment(bitstreamFile, startedSegments.front());
+      startedSegments.pop_front();
+    }
+
+    Segment* pcSegment = new Segment;
+    pcSegment->iIdx     = iSegment;
+    pcSegment->pcEncTop = NULL;
+
+    const Int iNumFrames = std::min(m_iIntraPeriod, m_framesToBeEncoded - 1 - iSegment * m_iIntraPeriod) + 1;
+    for (Int i = 0; i < iNumFrames; i++)
+    {
+      TComPicYuv* pcPicYuvOrg     = xNewPicYuv();
+      TComPicYuv* pcPicYuvTrueOrg = xNewPicYuv();
+      if (i == 0 && iSegment > 0)
+      {
+        pcBoundaryPicYuvOrg->copyToPic(pcPicYuvOrg);
+        pcBoundaryPicYuvTrueOrg->copyToPic(pcPicYuvTrueOrg);
+      }
+      else
+      {
+        m_cTVideoIOYuvInputFile.read( pcPicYuvOrg, pcPicYuvTrueOrg, ipCSC, m_aiPad, m_InputChromaFormatIDC, m_bClipInputVideoToRec709Range );
+        if (m_cTVideoIOYuvInputFile.isEof())
+        {
+          pcPicYuvOrg->destroy();
+          delete pcPicYuvOrg;
+          pcPicYuvTrueOrg->destroy();
+          delete pcPicYuvTrueOrg;
+          bEof = true;
+          break;
+        }
+        m_iFrameRcvd++;
+
+        if( m_temporalSubsampleRatio > 1 )
+        {
+          m_cTVideoIOYuvInputFile.skipFrames(m_temporalSubsampleRatio-1, m_iSourceWidth - m_aiPad[0], m_iSourceHeight - m_aiPad[1], m_InputChromaFormatIDC);
+        }
+      }
+      pcSegment->orgPictures.push_back(pcPicYuvOrg);
+      pcSegment->trueOrgPictures.push_back(pcPicYuvTrueOrg);
+    }
+
+    // a later segment that got no new picture before the end of the file is not needed
+    if (pcSegment->orgPictures.size() <= (iSegment > 0 ? 1 : 0))
+    {
+      for (UInt i = 0; i < pcSegment->orgPictures.size(); i++)
+      {
+        pcSegment->orgPictures[i]->destroy();
+        delete pcSegment->orgPictures[i];
+        pcSegment->trueOrgPictures[i]->destroy();
+        delete pcSegment->trueOrgPictures[i];
+      }
+      delete pcSegment;
+      break;
+    }
+
+    pcSegment->orgPictures.back()->copyToPic(pcBoundaryPicYuvOrg);
+    pcSegment->trueOrgPictures.back()->copyToPic(pcBoundaryPicYuvTrueOrg);
+
+    pcSegment->thread = std::thread(&TAppEncTop::xEncodeSegment, this, pcSegment);
+    startedSegments.push_back(pcSegment);
+  }
+
+  while (!startedSegments.empty())
+  {
+    xWriteSegment(bitstreamFile, startedSegments.front());
+    startedSegments.pop_front();
+  }
+
+  if (bEof)
+  {
+    m_cTEncTop.setFramesToBeEncoded(m_iFrameRcvd);
+  }
+
+  pcBoundaryPicYuvOrg->destroy();
+  delete pcBoundaryPicYuvOrg;
+  pcBoundaryPicYuvTrueOrg->destroy();
+  delete pcBoundaryPicYuvTrueOrg;
+}
+
+/**
+ Encode the pictures of a segment with a new encoder instance, configured like the main encoder.
+ The pictures of the segment are numbered from 0, the encoder offsets the POC written in the slice headers.
+ */
+Void TAppEncTop::xEncodeSegment(Segment* pcSegment)
+{
+  const InputColourSpaceConversion snrCSC = (!m_snrInternalColourSpace) ? m_inputColourSpaceConvert : IPCOLOURSPACE_UNCHANGED;
+  const Int iNumFrames = Int(pcSegment->orgPictures.size());
+
+  TEncTop* pcEncTop = new TEncTop;
+  static_cast<TEncCfg&>(*pcEncTop) = m_cTEncTop;
+  pcEncTop->setFramesToBeEncoded( iNumFrames );
+  pcEncTop->setFrameSkip( m_FrameSkip + pcSegment->iIdx * m_iIntraPeriod * m_temporalSubsampleRatio );
+  pcEncTop->setSegmentIdx( pcSegment->iIdx );
+  pcEncTop->create();
+  pcEncTop->init( false );
+  pcSegment->pcEncTop = pcEncTop;
+#if VCEG_AZ07_INIT_PREVFRAME
+  TComStats* pcStats = new TComStats (1, NUM_CTX_PBSLICE);
+#elif VCEG_AZ07_BAC_ADAPT_WDOW
+  TComStats* pcStats = new TComStats ();
+#endif
+
+  TComList<TComPicYuv*> cListPicYuvRec;
+  std::list<AccessUnit> outputAccessUnits;
+  Int iNumEncoded = 0;
+
+  for (Int i = 0; i < iNumFrames; i++)
+  {
+    // get buffers, as xGetBuffer() does
+    TComPicYuv* pcPicYuvRec = NULL;
+    if ( cListPicYuvRec.size() >= (UInt)m_iGOPSize )
+    {
+      pcPicYuvRec = cListPicYuvRec.popFront();
+    }
+    else
+    {
+      pcPicYuvRec = xNewPicYuv();
+    }
+    cListPicYuvRec.pushBack( pcPicYuvRec );
+
+#if VCEG_AZ07_BAC_ADAPT_WDOW || VCEG_AZ07_INIT_PREVFRAME
+    pcEncTop->encode( i == iNumFrames - 1, pcSegment->orgPictures[i], pcSegment->trueOrgPictures[i], snrCSC, cListPicYuvRec, outputAccessUnits, iNumEncoded, pcStats );
+#else
+    pcEncTop->encode( i == iNumFrames - 1, pcSegment->orgPictures[i], pcSegment->trueOrgPictures[i], snrCSC, cListPicYuvRec, outputAccessUnits, iNumEncoded );
+#endif
+
+    pcSegment->orgPictures[i]->destroy();
+    delete pcSegment->orgPictures[i];
+    pcSegment->orgPictures[i] = NULL;
+    pcSegment->trueOrgPictures[i]->destroy();
+    delete pcSegment->trueOrgPictures[i];
+    pcSegment->trueOrgPictures[i] = NULL;
+
+    // keep the output until the segment is written
+    if ( iNumEncoded > 0 )
+    {
+      if (m_pchReconFile)
+      {
+        TComList<TComPicYuv*>::iterator iterPicYuvRec = cListPicYuvRec.end();
+        for ( Int j = 0; j < iNumEncoded; j++ )
+        {
+          --iterPicYuvRec;
+        }
+        for ( Int j = 0; j < iNumEncoded; j++ )
+        {
+          TComPicYuv* pcPicYuvRecOut = xNewPicYuv();
+          (*iterPicYuvRec++)->copyToPic( pcPicYuvRecOut );
+          pcSegment->recPictures.push_back( pcPicYuvRecOut );
+        }
+      }
+      pcSegment->accessUnits.splice( pcSegment->accessUnits.end(), outputAccessUnits );
+    }
+  }
+
+  for (TComList<TComPicYuv*>::iterator it = cListPicYuvRec.begin(); it != cListPicYuvRec.end(); it++)
+  {
+    (*it)->destroy();
+    delete *it;
+  }
+#if VCEG_AZ07_BAC_ADAPT_WDOW || VCEG_AZ07_INIT_PREVFRAME
+  delete pcStats;
+#endif
+}
+
+/**
+ Wait for the encoding thread of a segment and write its output.
+ A later segment starts with the last picture of the previous segment, coded as IDR picture with its own parameter sets:
+ its access unit and reconstruction are dropped.
+ */
+Void TAppEncTop::xWriteSegment(std::ostream& bitstreamFile, Segment* pcSegment)
+{
+  pcSegment->thread.join();
+
+  const InputColourSpaceConversion ipCSC = (!m_outputInternalColourSpace) ? m_inputColourSpaceConvert : IPCOLOURSPACE_UNCHANGED;
+  const Bool bDropFirst = pcSegment->iIdx > 0;
+
+  Bool bFirst = true;
+  for (std::list<TComPicYuv*>::iterator it = pcSegment->recPictures.begin(); it != pcSegment->recPictures.end(); it++, bFirst = false)
+  {
+    if (!(bDropFirst && bFirst))
+    {
+      m_cTVideoIOYuvReconFile.write( *it, ipCSC, m_confWinLeft, m_confWinRight, m_confWinTop, m_confWinBottom,
+          NUM_CHROMA_FORMAT, m_bClipOutputVideoToRec709Range );
+    }
+    (*it)->destroy();
+    delete *it;
+  }
+
+  const UInt uiTotalBytes = m_totalBytes;
+  bFirst = true;
+  for (std::list<AccessUnit>::const_iterator it = pcSegment->accessUnits.begin(); it != pcSegment->accessUnits.end(); it++, bFirst = false)
+  {
+    if (!(bDropFirst && bFirst))
+    {
+      const vector<UInt>& stats = writeAnnexB(bitstreamFile, *it);
+      rateStatsAccum(*it, stats);
+    }
+  }
+
+  const Int iNumPics   = Int(pcSegment->accessUnits.size()) - (bDropFirst ? 1 : 0);
+  const Int iFirstPOC  = pcSegment->iIdx * m_iIntraPeriod + (bDropFirst ? 1 : 0);
+  printf("Segment %4d: POC %4d to %4d %10u bits\n", pcSegment->iIdx, iFirstPOC, iFirstPOC + iNumPics - 1, (m_totalBytes - uiTotalBytes) * 8);
+  fflush(stdout);
+
+  m_cTEncTop.addSegmentStatistics( *pcSegment->pcEncTop );
+  pcSegment->pcEncTop->deletePicBuffer();
+  pcSegment->pcEncTop->destroy();
+  delete pcSegment->pcEncTop;
+  delete pcSegment;
+}
+
+TComPicYuv* TAppEncTop::xNewPicYuv()
+{
+  TComPicYuv* pcPicYuv = new TComPicYuv;
+#if JVET_C0024_QTBT
+  pcPicYuv->create( m_iSourceWidth, m_iSourceHeight, m_chromaFormatIDC, m_uiCTUSize, m_uiCTUSize, m_uiMaxTotalCUDepth, true );
+#else
+  pcPicYuv->create( m_iSourceWidth, m_iSourceHeight, m_chromaFormatIDC, m_uiMaxCUWidth, m_uiMaxCUHeight, m_uiMaxTotalCUDepth, true );
+#endif
+  return pcPicYuv;
+}
+
+#endif
 /**
  *
  */
@@ -851,6 +1116,14 @@ Void TAppEncTop::printRateSummary()
   {
     printf("Bytes for SPS/PPS/Slice (Incl. Annex B): %u (%.3f kbps)\n", m_essentialBytes, 0.008 * m_essentialBytes / time);
   }
+#if PRIMARY_TRANSFORM_CACHE
+  if (m_summaryVerboseness > 0)
+  {
+    UInt64 uiLookups, uiHits;
+    TComTrQuant::getPrimaryTransformCacheStats( uiLookups, uiHits );
+    printf("Primary transform cache: %llu hits in %llu look-ups (%.1f%%)\n", (unsigned long long)uiHits, (unsigned long long)uiLookups, uiLookups ? 100.0 * uiHits / uiLookups : 0.0);
+  }
+#endif
 }
 
 Void TAppEncTop::printChromaFormat()
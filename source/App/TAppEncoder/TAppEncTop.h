@@ -45,6 +45,10 @@
 #include "TLibVideoIO/TVideoIOYuv.h"
 #include "TLibCommon/AccessUnit.h"
 #include "TAppEncCfg.h"
+#if PARALLEL_SEGMENT_ENCODING
+#include <thread>
+#include <vector>
+#endif
 
 //! \ingroup TAppEncoder
 //! \{
@@ -72,6 +76,20 @@ private:
   UInt m_essentialBytes;
   UInt m_totalBytes;
 
+#if PARALLEL_SEGMENT_ENCODING
+  /// intra-period segment of the sequence, encoded by its own encoder instance on its own thread
+  struct Segment
+  {
+    Int                       iIdx;                         ///< segment index, the segment starts at POC iIdx * IntraPeriod
+    std::vector<TComPicYuv*>  orgPictures;                  ///< input pictures, released by the encoding thread once passed to the encoder
+    std::vector<TComPicYuv*>  trueOrgPictures;              ///< input pictures in the original colour space
+    std::list<AccessUnit>     accessUnits;                  ///< coded access units, in coding order
+    std::list<TComPicYuv*>    recPictures;                  ///< reconstructed pictures, in output order
+    TEncTop*                  pcEncTop;                     ///< encoder of the segment, kept for its statistics until the segment is written
+    std::thread               thread;                       ///< encoding thread
+  };
+#endif
+
 protected:
   // initialization
   Void  xCreateLib        ();                               ///< create files & encoder class
@@ -85,6 +103,14 @@ protected:
   /// delete allocated buffers
   Void  xDeleteBuffer     ();
 
+#if PARALLEL_SEGMENT_ENCODING
+  // encoding of the intra-period segments on several threads
+  Void  xEncodeSegments   (std::ostream& bitstreamFile);    ///< encode the whole sequence segment by segment
+  Void  xEncodeSegment    (Segment* pcSegment);             ///< encoding thread of a segment
+  Void  xWriteSegment     (std::ostream& bitstreamFile, Segment* pcSegment); ///< write the output of a segment and release it
+  TComPicYuv* xNewPicYuv   ();                               ///< allocate a picture of the size of the coded pictures
+#endif
+
   // file I/O
   Void xWriteOutput(std::ostream& bitstreamFile, Int iNumEncoded, const std::list<AccessUnit>& accessUnits); ///< write bitstream to file
   Void rateStatsAccum(const AccessUnit& au, const std::vector<UInt>& stats);
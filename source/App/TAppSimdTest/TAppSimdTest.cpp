@@ -0,0 +1,999 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2015, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TAppSimdTest.cpp
+    \brief    SIMD kernel test application class
+*/
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <limits>
+#include <vector>
+
+#include "TAppSimdTest.h"
+#include "TLibCommon/TComRom.h"
+#include "TLibCommon/TComInterpolationFilter.h"
+#include "TLibCommon/TComRdCost.h"
+#include "TLibCommon/TComTrQuant.h"
+#include "TLibCommon/TComAdaptiveLoopFilter.h"
+#include "TLibCommon/TComPrediction.h"
+
+//! \ingroup TAppSimdTest
+//! \{
+
+// ====================================================================================================================
+// Library classes with their protected filtering functions made public for the tests
+// ====================================================================================================================
+
+#if SIMD_AVX2_ALF && COM16_C806_ALF_TEMPPRED_NUM
+class TSimdTestAdaptiveLoopFilter : public TComAdaptiveLoopFilter
+{
+public:
+  using TComAdaptiveLoopFilter::m_PADDING_W_ALF;
+  using TComAdaptiveLoopFilter::xALFLuma_qc;
+  using TComAdaptiveLoopFilter::xALFChroma;
+};
+#endif
+
+#if SIMD_AVX2_BIO || SIMD_AVX2_OBMC
+class TSimdTestPrediction : public TComPrediction
+{
+public:
+#if SIMD_AVX2_BIO
+  using TComPrediction::m_pGradX0;
+  using TComPrediction::m_pGradY0;
+  using TComPrediction::m_pGradX1;
+  using TComPrediction::m_pGradY1;
+  using TComPrediction::m_pPred0;
+  using TComPrediction::m_pPred1;
+  using TComPrediction::xPredInterFrac;
+  using TComPrediction::xGradFilterX;
+  using TComPrediction::xGradFilterY;
+  using TComPrediction::xBIOAverage;
+#endif
+#if SIMD_AVX2_OBMC
+  using TComPrediction::xSubblockOBMC;
+#endif
+};
+#endif
+
+// ====================================================================================================================
+// Constructor / destructor / initialization / destroy
+// ====================================================================================================================
+
+TAppSimdTest::TAppSimdTest()
+: m_uiSeed( 1 )
+{
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/**
+ * \brief Run all the tests for each SIMD level the CPU and the build support
+ *
+ * The kernels of a level are selected by initSimdLevel() as in the encoder and the decoder, the C results are
+ * computed with the level SIMD_NONE.
+ */
+Int TAppSimdTest::run()
+{
+  Int iNumFailed = 0;
+  initROM();
+  for( Int iLevel = SIMD_SSE2 ; iLevel <= SIMD_AVX512 ; iLevel++ )
+  {
+    const SimdLevel eLevel = SimdLevel( iLevel );
+    initSimdLevel( eLevel );
+    if( g_eSimdLevel != eLevel )
+    {
+      printf( "%-8s not supported, skipped\n", getSimdLevelName( eLevel ) );
+      continue;
+    }
+    iNumFailed += xRunTest( "interpolation", &TAppSimdTest::xTestInterpolation, eLevel ) ? 0 : 1;
+    iNumFailed += xRunTest( "distortion",    &TAppSimdTest::xTestDistortion,    eLevel ) ? 0 : 1;
+#if VCEG_AZ08_KLT_COMMON
+    iNumFailed += xRunTest( "KLT SAD",       &TAppSimdTest::xTestKltSad,        eLevel ) ? 0 : 1;
+#endif
+#if COM16_C806_EMT
+    iNumFailed += xRunTest( "transform",     &TAppSimdTest::xTestTransform,     eLevel ) ? 0 : 1;
+#endif
+#if COM16_C1044_NSST && JVET_D0120_NSST_IMPROV
+    iNumFailed += xRunTest( "NSST",          &TAppSimdTest::xTestNsst,          eLevel ) ? 0 : 1;
+#endif
+#if RDOQ_BLOCK_QUANT
+    iNumFailed += xRunTest( "RDOQ",          &TAppSimdTest::xTestRdoqQuant,     eLevel ) ? 0 : 1;
+#endif
+#if SIMD_AVX2_ALF && COM16_C806_ALF_TEMPPRED_NUM
+    iNumFailed += xRunTest( "ALF",           &TAppSimdTest::xTestAlf,           eLevel ) ? 0 : 1;
+#endif
+#if SIMD_AVX2_BIO
+    iNumFailed += xRunTest( "BIO",           &TAppSimdTest::xTestBio,           eLevel ) ? 0 : 1;
+#endif
+#if SIMD_AVX2_OBMC
+    iNumFailed += xRunTest( "OBMC",          &TAppSimdTest::xTestObmc,          eLevel ) ? 0 : 1;
+#endif
+#if AFFINE_BATCHED_MC
+    iNumFailed += xRunTest( "affine MC",     &TAppSimdTest::xTestAffineMc,      eLevel ) ? 0 : 1;
+#endif
+  }
+  initSimdLevel( SIMD_NONE );
+  destroyROM();
+  return iNumFailed;
+}
+
+// ====================================================================================================================
+// Private member functions
+// ====================================================================================================================
+
+UInt TAppSimdTest::xRand()
+{
+  m_uiSeed = m_uiSeed * 1664525 + 1013904223;
+  return m_uiSeed >> 8;
+}
+
+Void TAppSimdTest::xFillRandom( Pel* pDst, Int iNum, Int iMin, Int iMax )
+{
+  for( Int i = 0 ; i < iNum ; i++ )
+  {
+    pDst[i] = Pel( iMin + Int( xRand() % UInt( iMax - iMin + 1 ) ) );
+  }
+}
+
+Bool TAppSimdTest::xRunTest( const Char* pcName, Bool ( TAppSimdTest::*pfTest )( SimdLevel ), SimdLevel eLevel )
+{
+  const Bool bPassed = ( this->*pfTest )( eLevel );
+  printf( "%-8s %-24s %s\n", getSimdLevelName( eLevel ), pcName, bPassed ? "ok" : "FAILED" );
+  return bPassed;
+}
+
+/**
+ * \brief Interpolation filters of all the filter stages on blocks of 1 to 80 columns with 8 to 12 bit samples
+ *
+ * The 8-tap luma, 2-tap FRUC and 4-tap chroma filters are run horizontally and vertically with random fractional
+ * positions. The samples of a first stage are in the range of the bit depth, the ones of a second stage in the range
+ * of the intermediate samples, [-2 * IF_INTERNAL_OFFS, 2 * IF_INTERNAL_OFFS), where the sums of the SSE2 kernels do
+ * not saturate.
+ */
+Bool TAppSimdTest::xTestInterpolation( SimdLevel eLevel )
+{
+  const Int iMaxWidth = 80;
+  const Int iHeight   = 4;
+  const Int iStride   = iMaxWidth + NTAPS_LUMA;
+  const Int iMargin   = ( NTAPS_LUMA / 2 - 1 ) * ( iStride + 1 );
+  std::vector<Pel> src ( ( iHeight + NTAPS_LUMA ) * iStride );
+  std::vector<Pel> dstC( iHeight * iMaxWidth );
+  std::vector<Pel> dstSIMD( iHeight * iMaxWidth );
+  TComInterpolationFilter cFilter;
+
+  for( Int bitDepth = 8 ; bitDepth <= 12 ; bitDepth += 2 )
+  {
+    const Int iMaxVal = ( 1 << bitDepth ) - 1;
+#if JVET_D0033_ADAPTIVE_CLIPPING
+    for( Int i = 0 ; i < 6 ; i += 2 )
+    {
+      g_ClipParam[i]     = Int( xRand() % 16 );
+      g_ClipParam[i + 1] = iMaxVal - Int( xRand() % 16 );
+    }
+#endif
+    for( Int iFilter = 0 ; iFilter < 3 ; iFilter++ )
+    {
+      const ComponentID compID     = iFilter < 2 ? COMPONENT_Y : COMPONENT_Cb;
+#if VCEG_AZ07_FRUC_MERGE
+      const Int         nFilterIdx = iFilter == 1 ? 1 : 0;
+#endif
+      const Int         iNumFracs  = ( iFilter < 2 ? LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS : CHROMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS ) << VCEG_AZ07_MV_ADD_PRECISION_BIT_FOR_STORE;
+      for( Int iStage = 0 ; iStage < 6 ; iStage++ )
+      {
+        const Bool isVertical = iStage >= 2;
+        const Bool isFirst    = !isVertical || iStage < 4;
+        const Bool isLast     = ( iStage & 1 ) != 0;
+        for( Int width = 1 ; width <= iMaxWidth ; width++ )
+        {
+          const Int frac = 1 + Int( xRand() % UInt( iNumFracs - 1 ) );
+          xFillRandom( &src[0] , Int( src.size() ) , isFirst ? 0 : -2 * IF_INTERNAL_OFFS , isFirst ? iMaxVal : 2 * IF_INTERNAL_OFFS - 1 );
+          xFillRandom( &dstC[0] , Int( dstC.size() ) , -32768 , 32767 );
+          dstSIMD = dstC;
+          for( Int iRun = 0 ; iRun < 2 ; iRun++ )
+          {
+            initSimdLevel( iRun ? eLevel : SIMD_NONE );
+            Pel* pDst = iRun ? &dstSIMD[0] : &dstC[0];
+            if( isVertical )
+            {
+              cFilter.filterVer( compID , &src[iMargin] , iStride , pDst , iMaxWidth , width , iHeight , frac , isFirst , isLast , CHROMA_420 , bitDepth
+#if VCEG_AZ07_FRUC_MERGE
+                               , nFilterIdx
+#endif
+                               );
+            }
+            else
+            {
+              cFilter.filterHor( compID , &src[iMargin] , iStride , pDst , iMaxWidth , width , iHeight , frac , isLast , CHROMA_420 , bitDepth
+#if VCEG_AZ07_FRUC_MERGE
+                               , nFilterIdx
+#endif
+                               );
+            }
+          }
+          if( dstC != dstSIMD )
+          {
+            printf( "%s interpolation (%s%s, %s, first %d, last %d, %d bit, width %d, frac %d) differs from the C code\n" ,
+                    getSimdLevelName( eLevel ) , iFilter == 2 ? "chroma" : "luma" , iFilter == 1 ? " FRUC" : "" , isVertical ? "vertical" : "horizontal" ,
+                    isFirst , isLast , bitDepth , width , frac );
+            return false;
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * \brief SAD, Hadamard and mean-removed distortions of all the block sizes from 4x4 to the CTU size with 8 to 12 bit samples
+ *
+ * The distortions are computed by TComRdCost::getDistPart() as in the mode decision, and by TComRdCost::calcHAD() for the
+ * sizes that are multiples of 8.
+ */
+Bool TAppSimdTest::xTestDistortion( SimdLevel eLevel )
+{
+  static const DFunc aeDFunc[2]      = { DF_SAD, DF_HADS };
+  static const Char* apcDFuncName[2] = { "SAD", "Hadamard" };
+#if VCEG_AZ06_IC
+  const Int iNumMR = 2;
+#else
+  const Int iNumMR = 1;
+#endif
+  const Int iStride = MAX_CU_SIZE + 1;
+  std::vector<Pel> org( MAX_CU_SIZE * iStride );
+  std::vector<Pel> cur( MAX_CU_SIZE * iStride );
+  TComRdCost cRdCost;
+  cRdCost.init();
+
+  for( Int bitDepth = 8 ; bitDepth <= 12 ; bitDepth += 2 )
+  {
+    const Int iMaxVal = ( 1 << bitDepth ) - 1;
+    for( Int iHeight = 4 ; iHeight <= MAX_CU_SIZE ; iHeight <<= 1 )
+    {
+      for( Int iWidth = 4 ; iWidth <= MAX_CU_SIZE ; iWidth <<= 1 )
+      {
+        xFillRandom( &org[0] , Int( org.size() ) , 0 , iMaxVal );
+        xFillRandom( &cur[0] , Int( cur.size() ) , 0 , iMaxVal );
+        for( Int iFunc = 0 ; iFunc < 3 * iNumMR ; iFunc++ )
+        {
+          const Bool bMRFlag = iFunc >= 3;
+          Distortion auiDist[2];
+          for( Int iRun = 0 ; iRun < 2 ; iRun++ )
+          {
+            initSimdLevel( iRun ? eLevel : SIMD_NONE );
+            if( iFunc % 3 < 2 )
+            {
+              auiDist[iRun] = cRdCost.getDistPart( bitDepth , &cur[0] , iStride , &org[0] , iStride , iWidth , iHeight , COMPONENT_Y , aeDFunc[iFunc % 3]
+#if VCEG_AZ06_IC
+                                                 , bMRFlag
+#endif
+                                                 );
+            }
+            else if( !bMRFlag && iWidth % 8 == 0 && iHeight % 8 == 0 )
+            {
+              auiDist[iRun] = cRdCost.calcHAD( bitDepth , &org[0] , iStride , &cur[0] , iStride , iWidth , iHeight );
+            }
+            else
+            {
+              auiDist[iRun] = 0;
+            }
+          }
+          if( auiDist[0] != auiDist[1] )
+          {
+            printf( "%s %s%s distortion (%dx%d, %d bit) differs from the C code\n" , getSimdLevelName( eLevel ) ,
+                    bMRFlag ? "mean-removed " : "" , iFunc % 3 < 2 ? apcDFuncName[iFunc % 3] : "calcHAD" , iWidth , iHeight , bitDepth );
+            return false;
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+#if VCEG_AZ08_KLT_COMMON
+/**
+ * \brief Template and patch SAD of the KLT candidate search for 4x4 to 32x32 blocks with templates of 1 to 4 samples
+ *
+ * The distances are computed by TComTrQuant::calcTemplateDiff() and TComTrQuant::calcPatchDiff() without bound and with
+ * random bounds, above which the search stops summing.
+ */
+Bool TAppSimdTest::xTestKltSad( SimdLevel eLevel )
+{
+  const Int iMaxPatchSize = 32 + 4;
+  const Int iStride       = iMaxPatchSize + 1;
+  std::vector<Pel>  ref( iMaxPatchSize * iStride );
+  std::vector<Pel>  tar( iMaxPatchSize * iMaxPatchSize );
+  std::vector<Pel*> tarPatch( iMaxPatchSize );
+  TComTrQuant cTrQuant;
+
+  for( Int iRow = 0 ; iRow < iMaxPatchSize ; iRow++ )
+  {
+    tarPatch[iRow] = &tar[iRow * iMaxPatchSize];
+  }
+  for( Int bitDepth = 8 ; bitDepth <= 12 ; bitDepth += 2 )
+  {
+    const Int iMaxVal = ( 1 << bitDepth ) - 1;
+    for( UInt uiBlkSize = 4 ; uiBlkSize <= 32 ; uiBlkSize <<= 1 )
+    {
+      for( UInt uiTempSize = 1 ; uiTempSize <= 4 ; uiTempSize++ )
+      {
+        const UInt uiPatchSize = uiBlkSize + uiTempSize;
+        Pel* pRef = &ref[uiTempSize * iStride + uiTempSize];
+        for( Int iBound = 0 ; iBound < 4 ; iBound++ )
+        {
+          xFillRandom( &ref[0] , Int( ref.size() ) , 0 , iMaxVal );
+          xFillRandom( &tar[0] , Int( tar.size() ) , 0 , iMaxVal );
+          const DistType iMax = iBound ? DistType( xRand() % UInt( uiPatchSize * uiPatchSize * ( iMaxVal + 1 ) / 2 ) ) : std::numeric_limits<DistType>::max();
+          for( Int iPatch = 0 ; iPatch < 2 ; iPatch++ )
+          {
+            DistType aiDist[2];
+            for( Int iRun = 0 ; iRun < 2 ; iRun++ )
+            {
+              initSimdLevel( iRun ? eLevel : SIMD_NONE );
+              aiDist[iRun] = iPatch ? cTrQuant.calcPatchDiff   ( pRef , iStride , &tarPatch[0] , uiPatchSize , uiTempSize , iMax )
+                                    : cTrQuant.calcTemplateDiff( pRef , iStride , &tarPatch[0] , uiPatchSize , uiTempSize , iMax );
+            }
+            if( aiDist[0] != aiDist[1] )
+            {
+              printf( "%s KLT %s SAD (%ux%u, template %u, %d bit, bound %d) differs from the C code: %d instead of %d\n" , getSimdLevelName( eLevel ) ,
+                      iPatch ? "patch" : "template" , uiBlkSize , uiBlkSize , uiTempSize , bitDepth , iMax , aiDist[1] , aiDist[0] );
+              return false;
+            }
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+#endif
+
+#if COM16_C806_EMT
+/**
+ * \brief Forward and inverse EMT transforms of all the TU sizes from 4x4 to the largest TU with 8 to 12 bit residuals
+ *
+ * Each size is transformed with the DCT2 and the four transform pairs of inter blocks and of random intra modes, hence with all
+ * the 1D transforms. The inverse transforms get coefficients in the 16-bit range, zero right of and below a random last
+ * position as the decoder signals them to skip the zero columns and rows.
+ */
+Bool TAppSimdTest::xTestTransform( SimdLevel eLevel )
+{
+  static const UChar aucTrIdx[5] = { DCT2_EMT, 0, 1, 2, 3 };
+  const Int iMaxLog2TrDynamicRange = 15;
+  std::vector<TCoeff> src ( MAX_TU_SIZE * MAX_TU_SIZE );
+  std::vector<TCoeff> dstC( MAX_TU_SIZE * MAX_TU_SIZE );
+  std::vector<TCoeff> dstSIMD( MAX_TU_SIZE * MAX_TU_SIZE );
+
+  for( Int bitDepth = 8 ; bitDepth <= 12 ; bitDepth += 2 )
+  {
+    const Int iMaxVal = ( 1 << bitDepth ) - 1;
+    for( Int iHeight = 4 ; iHeight <= MAX_TU_SIZE ; iHeight <<= 1 )
+    {
+      for( Int iWidth = 4 ; iWidth <= MAX_TU_SIZE ; iWidth <<= 1 )
+      {
+        for( Int iMode = 0 ; iMode < 4 ; iMode++ )
+        {
+          const UChar ucMode = iMode ? UChar( xRand() % UInt( NUM_INTRA_MODE - 1 ) ) : INTER_MODE_IDX;
+          for( Int iTrIdx = 0 ; iTrIdx < 5 ; iTrIdx++ )
+          {
+            for( Int iInverse = 0 ; iInverse < 2 ; iInverse++ )
+            {
+#if JVET_C0024_ITSKIP
+              const UInt uiSkipWidth  = iInverse ? iWidth  - 1 - xRand() % UInt( std::min( iWidth  , JVET_C0024_ZERO_OUT_TH ) ) : 0;
+              const UInt uiSkipHeight = iInverse ? iHeight - 1 - xRand() % UInt( std::min( iHeight , JVET_C0024_ZERO_OUT_TH ) ) : 0;
+#else
+              const UInt uiSkipWidth  = 0;
+              const UInt uiSkipHeight = 0;
+#endif
+              for( Int y = 0 ; y < iHeight ; y++ )
+              {
+                for( Int x = 0 ; x < iWidth ; x++ )
+                {
+                  const Bool bZero = x >= iWidth - Int( uiSkipWidth ) || y >= iHeight - Int( uiSkipHeight );
+                  src[y * iWidth + x] = bZero ? 0 : iInverse ? -32768 + TCoeff( xRand() % 65536 ) : -iMaxVal + TCoeff( xRand() % UInt( 2 * iMaxVal + 1 ) );
+                }
+              }
+              for( Int iRun = 0 ; iRun < 2 ; iRun++ )
+              {
+                initSimdLevel( iRun ? eLevel : SIMD_NONE );
+                std::vector<TCoeff>& dst = iRun ? dstSIMD : dstC;
+                std::fill( dst.begin() , dst.end() , 0 );
+                if( iInverse )
+                {
+                  xITrMxN_EMT( bitDepth , &src[0] , &dst[0] , iWidth , iHeight
+#if JVET_C0024_ITSKIP
+                             , uiSkipWidth , uiSkipHeight
+#endif
+                             , false , iMaxLog2TrDynamicRange , ucMode , aucTrIdx[iTrIdx] );
+                }
+                else
+                {
+                  xTrMxN_EMT( bitDepth , &src[0] , &dst[0] , iWidth , iHeight , false , iMaxLog2TrDynamicRange , ucMode , aucTrIdx[iTrIdx] );
+                }
+              }
+              if( dstC != dstSIMD )
+              {
+                printf( "%s %s transform (%dx%d, mode %d, index %d, %d bit, skip %ux%u) differs from the C code\n" , getSimdLevelName( eLevel ) ,
+                        iInverse ? "inverse" : "forward" , iWidth , iHeight , ucMode , aucTrIdx[iTrIdx] , bitDepth , uiSkipWidth , uiSkipHeight );
+                return false;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+#endif
+
+#if COM16_C1044_NSST && JVET_D0120_NSST_IMPROV
+/**
+ * \brief Forward and inverse 4x4 and 8x8 HyGT secondary transforms of all the NSST mode sets and indices
+ *
+ * The inputs are random coefficients in the 16-bit range of the primary transform output.
+ */
+Bool TAppSimdTest::xTestNsst( SimdLevel eLevel )
+{
+  TComTrQuant cTrQuant;
+  const UInt uiNumModes   = sizeof( g_nsstHyGTPar4x4 ) / sizeof( g_nsstHyGTPar4x4[0] );
+  const UInt uiNumIndices = sizeof( g_nsstHyGTPar4x4[0] ) / sizeof( g_nsstHyGTPar4x4[0][0] );
+  Int aiSrc[64];
+  Int aiDstC[64];
+  Int aiDstSIMD[64];
+
+  for( Int i8x8 = 0 ; i8x8 < 2 ; i8x8++ )
+  {
+    const Int iNum = i8x8 ? 64 : 16;
+    for( Int iInverse = 0 ; iInverse < 2 ; iInverse++ )
+    {
+      for( UInt uiMode = 0 ; uiMode < uiNumModes ; uiMode++ )
+      {
+        for( UChar ucIndex = 0 ; ucIndex < uiNumIndices ; ucIndex++ )
+        {
+          for( Int iBlock = 0 ; iBlock < 4 ; iBlock++ )
+          {
+            for( Int i = 0 ; i < iNum ; i++ )
+            {
+              aiSrc[i] = -32768 + Int( xRand() % 65536 );
+            }
+            for( Int iRun = 0 ; iRun < 2 ; iRun++ )
+            {
+              initSimdLevel( iRun ? eLevel : SIMD_NONE );
+              Int* piDst = iRun ? aiDstSIMD : aiDstC;
+              memcpy( piDst , aiSrc , iNum * sizeof( Int ) );
+              if( i8x8 && iInverse )
+              {
+                cTrQuant.InvNsst8x8( piDst , uiMode , ucIndex );
+              }
+              else if( i8x8 )
+              {
+                cTrQuant.FwdNsst8x8( piDst , uiMode , ucIndex );
+              }
+              else if( iInverse )
+              {
+                cTrQuant.InvNsst4x4( piDst , uiMode , ucIndex );
+              }
+              else
+              {
+                cTrQuant.FwdNsst4x4( piDst , uiMode , ucIndex );
+              }
+            }
+            if( memcmp( aiDstC , aiDstSIMD , iNum * sizeof( Int ) ) )
+            {
+              printf( "%s %s %s NSST (mode %u, index %d) differs from the C code\n" , getSimdLevelName( eLevel ) ,
+                      iInverse ? "inverse" : "forward" , i8x8 ? "8x8" : "4x4" , uiMode , ucIndex );
+              return false;
+            }
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+#endif
+
+#if RDOQ_BLOCK_QUANT
+/**
+ * \brief Quantisation pass of RDOQ on all the TU sizes, with and without scaling lists and adaptive QP selection levels
+ *
+ * The quantisation coefficients go beyond the ones of the QPs so that some products are clipped, and every other TU has
+ * small coefficients only, which all quantise to zero with the larger shifts.
+ */
+Bool TAppSimdTest::xTestRdoqQuant( SimdLevel eLevel )
+{
+  const Int    iMaxCoeff = MAX_TU_SIZE * MAX_TU_SIZE;
+  const TCoeff iMaxLevel = ( 1 << 15 ) - 1;
+  std::vector<TCoeff>           src( iMaxCoeff );
+  std::vector<Int>              qCoef( iMaxCoeff );
+  std::vector<Double>           errScale( iMaxCoeff );
+  std::vector<TCoeff>           arl[2];
+  std::vector<Intermediate_Int> levelDouble[2];
+  std::vector<UInt>             maxAbsLevel[2];
+  std::vector<Double>           uncodedCost[2];
+  Bool                          bAnyLevel[2];
+
+  for( Int iRun = 0 ; iRun < 2 ; iRun++ )
+  {
+    arl        [iRun].resize( iMaxCoeff );
+    levelDouble[iRun].resize( iMaxCoeff );
+    maxAbsLevel[iRun].resize( iMaxCoeff );
+    uncodedCost[iRun].resize( iMaxCoeff );
+  }
+
+  for( UInt uiNumCoeff = 16 ; uiNumCoeff <= UInt( iMaxCoeff ) ; uiNumCoeff <<= 1 )
+  {
+    for( Int iBlock = 0 ; iBlock < 8 ; iBlock++ )
+    {
+      const Bool   bScalingList = ( iBlock & 1 ) != 0;
+      const Bool   bArl         = ( iBlock & 2 ) != 0;
+      const TCoeff iMaxSrc      = ( iBlock & 4 ) ? 15 : ( 1 << 16 );
+      const Int    iQBits       = 14 + Int( xRand() % 16 );
+      const Int    iQCoef       = 1 + Int( xRand() % ( 1 << 16 ) );
+      const Double dErrScale    = Double( 1 + xRand() % 4096 ) / Double( 1 << 20 );
+      for( UInt n = 0 ; n < uiNumCoeff ; n++ )
+      {
+        src     [n] = -iMaxSrc + TCoeff( xRand() % UInt( 2 * iMaxSrc + 1 ) );
+        qCoef   [n] = 1 + Int( xRand() % ( 1 << 16 ) );
+        errScale[n] = Double( 1 + xRand() % 4096 ) / Double( 1 << 20 );
+      }
+      for( Int iRun = 0 ; iRun < 2 ; iRun++ )
+      {
+        initSimdLevel( iRun ? eLevel : SIMD_NONE );
+        std::fill( arl[iRun].begin() , arl[iRun].end() , 0 );
+        bAnyLevel[iRun] = quantBlockRDOQ( &src[0] , uiNumCoeff , bScalingList ? &qCoef[0] : NULL , iQCoef , bScalingList ? &errScale[0] : NULL , dErrScale ,
+                                          iQBits , iMaxLevel , bArl ? &arl[iRun][0] : NULL , iQBits - ARL_C_PRECISION , 1 << ( iQBits - ARL_C_PRECISION - 1 ) ,
+                                          &levelDouble[iRun][0] , &maxAbsLevel[iRun][0] , &uncodedCost[iRun][0] );
+      }
+      if( bAnyLevel[0] != bAnyLevel[1] || arl[0] != arl[1]
+       || memcmp( &levelDouble[0][0] , &levelDouble[1][0] , uiNumCoeff * sizeof( Intermediate_Int ) )
+       || memcmp( &maxAbsLevel[0][0] , &maxAbsLevel[1][0] , uiNumCoeff * sizeof( UInt ) )
+       || memcmp( &uncodedCost[0][0] , &uncodedCost[1][0] , uiNumCoeff * sizeof( Double ) ) )
+      {
+        printf( "%s RDOQ quantisation (%u coefficients, shift %d, scaling list %d, ARL %d) differs from the C code\n" , getSimdLevelName( eLevel ) ,
+                uiNumCoeff , iQBits , bScalingList , bArl );
+        return false;
+      }
+    }
+  }
+  return true;
+}
+#endif
+
+#if SIMD_AVX2_ALF && COM16_C806_ALF_TEMPPRED_NUM
+/**
+ * \brief GALF luma and chroma filtering of a 4:2:0 picture with 8 and 10 bit samples
+ *
+ * The luma classes get random 9x9, 7x7 or 5x5 diamond filters and the chroma a random 5x5 one, with the DC coefficient
+ * completing the sum to one. The width is not a multiple of 8, so the C code filters the right columns of the windows
+ * after the SIMD kernel. With the adaptive clipping, the bounds are random and narrower than the sample range.
+ */
+Bool TAppSimdTest::xTestAlf( SimdLevel eLevel )
+{
+  const Int  iWidth   = 200;
+  const Int  iHeight  = 72;
+  const UInt uiCUSize = 64;
+  const UInt uiDepth  = 4;
+  const Int  iOne     = 1 << ( TComAdaptiveLoopFilter::m_NUM_BITS - 1 );
+
+  for( Int bitDepth = 8 ; bitDepth <= 10 ; bitDepth += 2 )
+  {
+    for( Int iFiltNo = 0 ; iFiltNo < TComAdaptiveLoopFilter::m_NO_TEST_FILT ; iFiltNo++ )
+    {
+      TSimdTestAdaptiveLoopFilter cAlf;
+      ALFParam cAlfParam;
+      TComPicYuv cPicDec;
+      TComPicYuv cPicRest[2];
+      cAlf.create( iWidth, iHeight, CHROMA_420, uiCUSize, uiCUSize, uiDepth, bitDepth, bitDepth );
+      cAlf.setNumCUsInFrame( ( ( iWidth + uiCUSize - 1 ) / uiCUSize ) * ( ( iHeight + uiCUSize - 1 ) / uiCUSize ) );
+      cAlf.allocALFParam( &cAlfParam );
+      cAlf.m_max_NO_VAR_BINS = TComAdaptiveLoopFilter::m_NO_VAR_BINS;
+      cAlf.m_max_NO_FILTERS  = TComAdaptiveLoopFilter::m_NO_FILTERS;
+      cPicDec.create( iWidth, iHeight, CHROMA_420, uiCUSize, uiCUSize, uiDepth, true );
+      for( Int iRun = 0 ; iRun < 2 ; iRun++ )
+      {
+        cPicRest[iRun].create( iWidth, iHeight, CHROMA_420, uiCUSize, uiCUSize, uiDepth, true );
+      }
+      for( UInt ch = 0 ; ch < cPicDec.getNumberValidComponents() ; ch++ )
+      {
+        const ComponentID compID = ComponentID( ch );
+        for( Int y = 0 ; y < cPicDec.getHeight( compID ) ; y++ )
+        {
+          xFillRandom( cPicDec.getAddr( compID ) + y * cPicDec.getStride( compID ), cPicDec.getWidth( compID ), 0, ( 1 << bitDepth ) - 1 );
+        }
+      }
+      cPicDec.extendPicBorder( TSimdTestAdaptiveLoopFilter::m_PADDING_W_ALF );
+
+      // luma filters of the classes, sets of the 9x9, 7x7 or 5x5 coefficients in the order of DecFilter_qc()
+      const Int aiNumCoeff[TComAdaptiveLoopFilter::m_NO_TEST_FILT] = { TComAdaptiveLoopFilter::m_SQR_FILT_LENGTH_9SYM,
+                                                                       TComAdaptiveLoopFilter::m_SQR_FILT_LENGTH_7SYM,
+                                                                       TComAdaptiveLoopFilter::m_SQR_FILT_LENGTH_5SYM };
+      cAlfParam.alf_flag         = 1;
+      cAlfParam.cu_control_flag  = 0;
+      cAlfParam.temproalPredFlag = true;
+      cAlfParam.realfiltNo       = iFiltNo;
+      for( Int varInd = 0 ; varInd < TComAdaptiveLoopFilter::m_NO_VAR_BINS ; varInd++ )
+      {
+        Int iSum = 0;
+        for( Int k = 0 ; k < aiNumCoeff[iFiltNo] - 1 ; k++ )
+        {
+          cAlfParam.alfCoeffLuma[varInd][k] = -32 + Int( xRand() % 65 );
+          iSum += 2 * cAlfParam.alfCoeffLuma[varInd][k];
+        }
+        cAlfParam.alfCoeffLuma[varInd][aiNumCoeff[iFiltNo] - 1] = iOne - iSum;
+      }
+      cAlfParam.chroma_idc       = 3;
+      cAlfParam.tap_chroma       = 5;
+      cAlfParam.num_coeff_chroma = TComAdaptiveLoopFilter::m_SQR_FILT_LENGTH_5SYM;
+      Int iSum = 0;
+      for( Int k = 0 ; k < cAlfParam.num_coeff_chroma - 1 ; k++ )
+      {
+        cAlfParam.coeff_chroma[k] = -32 + Int( xRand() % 65 );
+        iSum += 2 * cAlfParam.coeff_chroma[k];
+      }
+      cAlfParam.coeff_chroma[cAlfParam.num_coeff_chroma - 1] = iOne - iSum;
+
+#if JVET_D0033_ADAPTIVE_CLIPPING
+      g_ClipParam.isActive       = true;
+      g_ClipParam.isChromaActive = true;
+      g_ClipParam.Y().m = Int( xRand() % 64 ) << ( bitDepth - 8 );
+      g_ClipParam.Y().M = ( 255 - Int( xRand() % 64 ) ) << ( bitDepth - 8 );
+      g_ClipParam.U().m = Int( xRand() % 64 ) << ( bitDepth - 8 );
+      g_ClipParam.U().M = ( 255 - Int( xRand() % 64 ) ) << ( bitDepth - 8 );
+      g_ClipParam.V()   = g_ClipParam.U();
+#endif
+      for( Int iRun = 0 ; iRun < 2 ; iRun++ )
+      {
+        initSimdLevel( iRun ? eLevel : SIMD_NONE );
+        cAlf.xALFLuma_qc( NULL, &cAlfParam, &cPicDec, &cPicRest[iRun] );
+        cAlf.initVarForChroma( &cAlfParam, true );
+        cAlf.xALFChroma( &cAlfParam, &cPicDec, &cPicRest[iRun] );
+      }
+#if JVET_D0033_ADAPTIVE_CLIPPING
+      setOff( g_ClipParam );
+#endif
+
+      Bool bSame = true;
+      for( UInt ch = 0 ; ch < cPicDec.getNumberValidComponents() && bSame ; ch++ )
+      {
+        const ComponentID compID  = ComponentID( ch );
+        const Int         iStride = cPicRest[0].getStride( compID );
+        for( Int y = 0 ; y < cPicRest[0].getHeight( compID ) && bSame ; y++ )
+        {
+          bSame = !memcmp( cPicRest[0].getAddr( compID ) + y * iStride, cPicRest[1].getAddr( compID ) + y * iStride, cPicRest[0].getWidth( compID ) * sizeof( Pel ) );
+        }
+      }
+      cAlf.freeALFParam( &cAlfParam );
+      cAlf.destroy();
+      cPicDec.destroy();
+      for( Int iRun = 0 ; iRun < 2 ; iRun++ )
+      {
+        cPicRest[iRun].destroy();
+      }
+      if( !bSame )
+      {
+        printf( "%s ALF (filter %d, %d bit) differs from the C code\n" , getSimdLevelName( eLevel ) , iFiltNo , bitDepth );
+        return false;
+      }
+    }
+  }
+  return true;
+}
+#endif
+
+#if SIMD_AVX2_BIO
+/**
+ * \brief BIO predictions, gradients and optical flow average of 10 bit luma blocks of 4 to 128 columns in steps of 4
+ *
+ * The predictions and gradients of both lists are filtered from random references at random fractional positions, then
+ * averaged with random POC distances, with the references on both sides of the picture or on the same side, where the
+ * gradients are scaled. The bit depth and the limit of the refinement are frozen at the first call of the library, the
+ * test uses a single bit depth and the limit of the random access configurations.
+ */
+Bool TAppSimdTest::xTestBio( SimdLevel eLevel )
+{
+  const Int iBitDepth  = 10;
+  const Int iNumFracs  = 4 << VCEG_AZ07_MV_ADD_PRECISION_BIT_FOR_STORE;
+  const Int iMargin    = 8;
+  const Int iRefStride = MAX_CU_SIZE + 2 * iMargin + 1;
+  std::vector<Pel> ref[2];
+  std::vector<Pel> planes[2][6];
+  TSimdTestPrediction cPred;
+  TComYuv cDst[2];
+  BitDepths cBitDepths;
+  Bool bPassed = true;
+
+  cBitDepths.recon[CHANNEL_TYPE_LUMA]   = iBitDepth;
+  cBitDepths.recon[CHANNEL_TYPE_CHROMA] = iBitDepth;
+  cPred.initTempBuff( CHROMA_420
+#if COM16_C806_LMCHROMA
+                    , iBitDepth
+#endif
+#if VCEG_AZ08_INTER_KLT
+                    , false, MAX_CU_SIZE, MAX_CU_SIZE, MAX_CU_SIZE, MAX_CU_SIZE, MAX_CU_DEPTH
+#endif
+                    );
+  for( Int iList = 0 ; iList < 2 ; iList++ )
+  {
+    ref[iList].resize( ( MAX_CU_SIZE + 2 * iMargin ) * iRefStride );
+    cDst[iList].create( MAX_CU_SIZE, MAX_CU_SIZE, CHROMA_420 );
+  }
+
+  for( Int iHeight = 4 ; iHeight <= MAX_CU_SIZE && bPassed ; iHeight <<= 1 )
+  {
+    for( Int iWidth = 4 ; iWidth <= MAX_CU_SIZE && bPassed ; iWidth += 4 )
+    {
+      const Int iWidthG  = iWidth  + 4;
+      const Int iHeightG = iHeight + 4;
+      Int aiFrac[2][2];
+      for( Int iList = 0 ; iList < 2 ; iList++ )
+      {
+        xFillRandom( &ref[iList][0], Int( ref[iList].size() ), 0, ( 1 << iBitDepth ) - 1 );
+        for( Int iDir = 0 ; iDir < 2 ; iDir++ )
+        {
+          aiFrac[iList][iDir] = ( xRand() & 3 ) ? Int( xRand() % iNumFracs ) : 0;
+        }
+      }
+      const Int dT0 = ( xRand() & 1 ? 1 : -1 ) * Int( 1 + xRand() % 4 );
+      const Int dT1 = ( xRand() & 1 ? 1 : -1 ) * Int( 1 + xRand() % 4 );
+#if JVET_D0033_ADAPTIVE_CLIPPING
+      g_ClipParam.Y().m = Int( xRand() % 64 ) << ( iBitDepth - 8 );
+      g_ClipParam.Y().M = ( 255 - Int( xRand() % 64 ) ) << ( iBitDepth - 8 );
+#endif
+
+      for( Int iRun = 0 ; iRun < 2 ; iRun++ )
+      {
+        initSimdLevel( iRun ? eLevel : SIMD_NONE );
+        Pel* apcPlanes[6] = { cPred.m_pPred0, cPred.m_pPred1, cPred.m_pGradX0, cPred.m_pGradX1, cPred.m_pGradY0, cPred.m_pGradY1 };
+        for( Int iList = 0 ; iList < 2 ; iList++ )
+        {
+          // the block with its border of 2 samples, as xPredInterBlk() filters it
+          Pel* pRef = &ref[iList][iMargin * iRefStride + iMargin];
+          const Int xFrac = aiFrac[iList][0];
+          const Int yFrac = aiFrac[iList][1];
+          cPred.xGradFilterY( pRef, iRefStride, apcPlanes[4 + iList], iWidthG, iWidthG, iHeightG, yFrac, xFrac, iBitDepth );
+          cPred.xGradFilterX( pRef, iRefStride, apcPlanes[2 + iList], iWidthG, iWidthG, iHeightG, yFrac, xFrac, iBitDepth );
+          cPred.xPredInterFrac( pRef, apcPlanes[iList], iWidthG, iRefStride, xFrac, yFrac, iWidthG, iHeightG, true, CHROMA_420, iBitDepth );
+        }
+        for( Int iPlane = 0 ; iPlane < 6 ; iPlane++ )
+        {
+          planes[iRun][iPlane].assign( apcPlanes[iPlane], apcPlanes[iPlane] + iWidthG * iHeightG );
+        }
+        cPred.xBIOAverage( 0, iWidth, iHeight, &cDst[iRun], cBitDepths
+#if JVET_C0027_BIO
+                         , false
+#endif
+#if COM16_C1045_BIO_HARMO_IMPROV
+                         , dT0, dT1
+#endif
+                         );
+      }
+      for( Int iPlane = 0 ; iPlane < 6 && bPassed ; iPlane++ )
+      {
+        bPassed = planes[0][iPlane] == planes[1][iPlane];
+        if( !bPassed )
+        {
+          printf( "%s BIO %s %d (%dx%d, fractions %d,%d %d,%d) differs from the C code\n" , getSimdLevelName( eLevel ) ,
+                  iPlane < 2 ? "prediction" : iPlane < 4 ? "horizontal gradient" : "vertical gradient" , iPlane & 1 , iWidth , iHeight ,
+                  aiFrac[0][0] , aiFrac[0][1] , aiFrac[1][0] , aiFrac[1][1] );
+        }
+      }
+      const Int iDstStride = cDst[0].getStride( COMPONENT_Y );
+      for( Int y = 0 ; y < iHeight && bPassed ; y++ )
+      {
+        bPassed = !memcmp( cDst[0].getAddr( COMPONENT_Y ) + y * iDstStride, cDst[1].getAddr( COMPONENT_Y ) + y * iDstStride, iWidth * sizeof( Pel ) );
+        if( !bPassed )
+        {
+          printf( "%s BIO average (%dx%d, POC distances %d %d) differs from the C code\n" , getSimdLevelName( eLevel ) , iWidth , iHeight , dT0 , dT1 );
+        }
+      }
+    }
+  }
+#if JVET_D0033_ADAPTIVE_CLIPPING
+  setOff( g_ClipParam );
+#endif
+  for( Int iList = 0 ; iList < 2 ; iList++ )
+  {
+    cDst[iList].destroy();
+  }
+  return bPassed;
+}
+#endif
+
+#if SIMD_AVX2_OBMC
+/**
+ * \brief OBMC blending of the four boundaries of luma and chroma blocks of 4x4 to 64x64 luma samples, with and without the
+ * simplified OBMC of the small blocks
+ *
+ * The samples are in the 12 bit range. The whole buffers are compared, so that rows and columns the C code leaves
+ * unchanged are checked as well.
+ */
+Bool TAppSimdTest::xTestObmc( SimdLevel eLevel )
+{
+  const Int iMaxSize = 64;
+  TSimdTestPrediction cPred;
+  TComYuv cSrc;
+  TComYuv cDst[2];
+  Bool bPassed = true;
+
+  cSrc.create( iMaxSize, iMaxSize, CHROMA_420 );
+  for( Int iRun = 0 ; iRun < 2 ; iRun++ )
+  {
+    cDst[iRun].create( iMaxSize, iMaxSize, CHROMA_420 );
+  }
+
+  for( UInt ch = 0 ; ch < cSrc.getNumberValidComponents() && bPassed ; ch++ )
+  {
+    const ComponentID eComp  = ComponentID( ch );
+    const Int         iScale = cSrc.getComponentScaleX( eComp );
+    const Int         iNum   = cSrc.getStride( eComp ) * cSrc.getHeight( eComp );
+    for( Int iHeight = 4 ; iHeight <= iMaxSize && bPassed ; iHeight <<= 1 )
+    {
+      for( Int iWidth = 4 ; iWidth <= iMaxSize && bPassed ; iWidth <<= 1 )
+      {
+        for( Int iDir = 0 ; iDir < 4 && bPassed ; iDir++ )
+        {
+          for( Int iSimp = 0 ; iSimp < 2 && bPassed ; iSimp++ )
+          {
+            xFillRandom( cSrc.getAddr( eComp ), iNum, 0, 4095 );
+            xFillRandom( cDst[0].getAddr( eComp ), iNum, 0, 4095 );
+            memcpy( cDst[1].getAddr( eComp ), cDst[0].getAddr( eComp ), iNum * sizeof( Pel ) );
+            for( Int iRun = 0 ; iRun < 2 ; iRun++ )
+            {
+              initSimdLevel( iRun ? eLevel : SIMD_NONE );
+              cPred.xSubblockOBMC( eComp, NULL, 0, &cDst[iRun], &cSrc, iWidth >> iScale, iHeight >> iScale, iDir, iSimp != 0 );
+            }
+            bPassed = !memcmp( cDst[0].getAddr( eComp ), cDst[1].getAddr( eComp ), iNum * sizeof( Pel ) );
+            if( !bPassed )
+            {
+              printf( "%s OBMC (component %u, %dx%d, direction %d, simplified %d) differs from the C code\n" , getSimdLevelName( eLevel ) ,
+                      ch , iWidth >> iScale , iHeight >> iScale , iDir , iSimp );
+            }
+          }
+        }
+      }
+    }
+  }
+  cSrc.destroy();
+  for( Int iRun = 0 ; iRun < 2 ; iRun++ )
+  {
+    cDst[iRun].destroy();
+  }
+  return bPassed;
+}
+#endif
+
+#if AFFINE_BATCHED_MC
+/**
+ * \brief Interpolation of the rectangles of affine sub-blocks sharing an Mv, as filtered by TComPrediction::xPredAffineBlk()
+ *
+ * The rectangles are multiples of the 4x4 luma and 2x2 chroma sub-blocks, up to the CTU size. Each one is filtered as in
+ * the batched affine MC: horizontally or vertically only when the other phase is 0, otherwise horizontally into the
+ * intermediate buffer and then vertically, for uni- and bi-prediction, with random phases in 1/16 luma and 1/32 chroma
+ * samples. The intermediate samples of the two-stage case are compared as well.
+ */
+Bool TAppSimdTest::xTestAffineMc( SimdLevel eLevel )
+{
+  const Int iMaxSize   = MAX_CU_SIZE;
+  const Int iRefStride = iMaxSize + NTAPS_LUMA;
+  const Int iTmpStride = iMaxSize;
+  const Int iMargin    = ( NTAPS_LUMA / 2 - 1 ) * ( iRefStride + 1 );
+  std::vector<Pel> ref( ( iMaxSize + NTAPS_LUMA ) * iRefStride );
+  std::vector<Pel> tmp[2];
+  std::vector<Pel> dst[2];
+  TComInterpolationFilter cFilter;
+
+  for( Int iRun = 0 ; iRun < 2 ; iRun++ )
+  {
+    tmp[iRun].resize( ( iMaxSize + NTAPS_LUMA - 1 ) * iTmpStride );
+    dst[iRun].resize( iMaxSize * iMaxSize );
+  }
+
+  for( Int bitDepth = 8 ; bitDepth <= 12 ; bitDepth += 2 )
+  {
+    const Int iMaxVal = ( 1 << bitDepth ) - 1;
+#if JVET_D0033_ADAPTIVE_CLIPPING
+    for( Int i = 0 ; i < 6 ; i += 2 )
+    {
+      g_ClipParam[i]     = Int( xRand() % 16 );
+      g_ClipParam[i + 1] = iMaxVal - Int( xRand() % 16 );
+    }
+#endif
+    for( Int ch = 0 ; ch < 2 ; ch++ )
+    {
+      const ComponentID compID      = ch ? COMPONENT_Cb : COMPONENT_Y;
+      const Int         iScale      = ch ? 1 : 0;
+      const Int         iBlkSize    = AFFINE_MIN_BLOCK_SIZE >> iScale;
+      const Int         iNumFracs   = 16 << iScale;
+      const Int         vFilterSize = ch ? NTAPS_CHROMA : NTAPS_LUMA;
+      for( Int iHeight = iBlkSize ; iHeight <= ( iMaxSize >> iScale ) ; iHeight <<= 1 )
+      {
+        for( Int iWidth = iBlkSize ; iWidth <= ( iMaxSize >> iScale ) ; iWidth += iBlkSize )
+        {
+          for( Int iCase = 0 ; iCase < 6 ; iCase++ )
+          {
+            const Bool bi    = ( iCase & 1 ) != 0;
+            const Int  xFrac = iCase < 2 ? 0 : 1 + Int( xRand() % UInt( iNumFracs - 1 ) );
+            const Int  yFrac = iCase >= 2 && iCase < 4 ? 0 : 1 + Int( xRand() % UInt( iNumFracs - 1 ) );
+            xFillRandom( &ref[0] , Int( ref.size() ) , 0 , iMaxVal );
+            xFillRandom( &tmp[0][0] , Int( tmp[0].size() ) , -32768 , 32767 );
+            xFillRandom( &dst[0][0] , Int( dst[0].size() ) , -32768 , 32767 );
+            tmp[1] = tmp[0];
+            dst[1] = dst[0];
+            for( Int iRun = 0 ; iRun < 2 ; iRun++ )
+            {
+              initSimdLevel( iRun ? eLevel : SIMD_NONE );
+              Pel* pRef = &ref[iMargin];
+              if( yFrac == 0 )
+              {
+                cFilter.filterHor( compID , pRef , iRefStride , &dst[iRun][0] , iMaxSize , iWidth , iHeight , xFrac , !bi , CHROMA_420 , bitDepth );
+              }
+              else if( xFrac == 0 )
+              {
+                cFilter.filterVer( compID , pRef , iRefStride , &dst[iRun][0] , iMaxSize , iWidth , iHeight , yFrac , true , !bi , CHROMA_420 , bitDepth );
+              }
+              else
+              {
+                cFilter.filterHor( compID , pRef - ( ( vFilterSize >> 1 ) - 1 ) * iRefStride , iRefStride , &tmp[iRun][0] , iTmpStride , iWidth , iHeight + vFilterSize - 1 , xFrac , false , CHROMA_420 , bitDepth );
+                cFilter.filterVer( compID , &tmp[iRun][( ( vFilterSize >> 1 ) - 1 ) * iTmpStride] , iTmpStride , &dst[iRun][0] , iMaxSize , iWidth , iHeight , yFrac , false , !bi , CHROMA_420 , bitDepth );
+              }
+            }
+            if( tmp[0] != tmp[1] || dst[0] != dst[1] )
+            {
+              printf( "%s affine MC (%s, %dx%d, %s, %d bit, frac %d %d) differs from the C code\n" , getSimdLevelName( eLevel ) ,
+                      ch ? "chroma" : "luma" , iWidth , iHeight , bi ? "bi" : "uni" , bitDepth , xFrac , yFrac );
+#if JVET_D0033_ADAPTIVE_CLIPPING
+              setOff( g_ClipParam );
+#endif
+              return false;
+            }
+          }
+        }
+      }
+    }
+  }
+#if JVET_D0033_ADAPTIVE_CLIPPING
+  setOff( g_ClipParam );
+#endif
+  return true;
+}
+#endif
+
+//! \}
@@ -0,0 +1,102 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2015, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TAppSimdTest.h
+    \brief    SIMD kernel test application class (header)
+*/
+
+#ifndef __TAPPSIMDTEST__
+#define __TAPPSIMDTEST__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include "TLibCommon/CommonDef.h"
+
+//! \ingroup TAppSimdTest
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// checks that the kernels of each SIMD level the CPU supports are bit-exact with the C code, through the library functions that use them
+class TAppSimdTest
+{
+private:
+  UInt  m_uiSeed;                                                                   ///< state of the random number generator
+
+  UInt  xRand             ();
+  Void  xFillRandom       ( Pel* pDst, Int iNum, Int iMin, Int iMax );            ///< random samples in [iMin, iMax]
+  Bool  xRunTest          ( const Char* pcName, Bool ( TAppSimdTest::*pfTest )( SimdLevel ), SimdLevel eLevel );
+
+  // tests, each compares the results of eLevel with the ones of the C code and reports the first mismatch
+  Bool  xTestInterpolation( SimdLevel eLevel );
+  Bool  xTestDistortion   ( SimdLevel eLevel );
+#if VCEG_AZ08_KLT_COMMON
+  Bool  xTestKltSad       ( SimdLevel eLevel );
+#endif
+#if COM16_C806_EMT
+  Bool  xTestTransform    ( SimdLevel eLevel );
+#endif
+#if COM16_C1044_NSST && JVET_D0120_NSST_IMPROV
+  Bool  xTestNsst         ( SimdLevel eLevel );
+#endif
+#if RDOQ_BLOCK_QUANT
+  Bool  xTestRdoqQuant    ( SimdLevel eLevel );
+#endif
+#if SIMD_AVX2_ALF && COM16_C806_ALF_TEMPPRED_NUM
+  Bool  xTestAlf          ( SimdLevel eLevel );
+#endif
+#if SIMD_AVX2_BIO
+  Bool  xTestBio          ( SimdLevel eLevel );
+#endif
+#if SIMD_AVX2_OBMC
+  Bool  xTestObmc         ( SimdLevel eLevel );
+#endif
+#if AFFINE_BATCHED_MC
+  Bool  xTestAffineMc     ( SimdLevel eLevel );
+#endif
+
+public:
+  TAppSimdTest();
+  virtual ~TAppSimdTest() {}
+
+  Int   run               ();                                                       ///< test all the SIMD levels, returns the number of failed tests
+};
+
+//! \}
+
+#endif // __TAPPSIMDTEST__
+
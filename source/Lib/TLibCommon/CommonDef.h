@@ -148,6 +148,18 @@ static const Double IGNORE_THRESHOULD_OF_LARGEST =               1e-6;
 #if VCEG_AZ08_FORCE_USE_GIVENNUM_BASIS
 static const Int FORCE_BASIS_NUM =                                 32; /// Forced number of basis utilized (for speeding up).
 #endif
+#if KLT_FAST_CANDIDATE_SEARCH
+static const Int KLT_SUM_CELLS_PER_BLOCK =                          4; ///< largest number of cells a block side is split into for the lower bound of the SAD of a template or patch
+static const Int KLT_SUM_CELL_MIN_SIZE =                            4; ///< smallest cell size of the lower bound of the SAD of a template or patch
+static const Int KLT_SUM_BOUND_MIN_BLKSIZE =                        8; ///< smallest block size the lower bound of the SAD is checked for
+#endif
+#if KLT_PREALLOCATED_EIGEN_SOLVER
+static const Int KLT_EIGEN_SOLVER_MAX_DIM =   MAX_CANDI_NUM > 64 ? MAX_CANDI_NUM : 64; ///< largest dimension of the matrices decomposed when deriving a KLT: the covariance of 8x8 blocks or the Gram matrix of the candidates of larger blocks
+#endif
+#if KLT_ON_DEMAND_SUBPEL_PLANES
+static const Int KLT_SUBPEL_TILE_SIZE =                            64; ///< size of the tiles the quarter-sample planes of the inter KLT are allocated and interpolated by, on first access
+static const Int KLT_SUBPEL_AREA_SIZE = (1 << (USE_MORE_BLOCKSIZE_DEPTH_MAX + 1)) + 8; ///< largest area read from a quarter-sample plane around a candidate of the inter KLT: the patch of the largest block and its left and upper neighbours
+#endif
 #endif
 
 static const Int MAX_NUM_REF =                                     16; ///< max. number of entries in picture reference list
@@ -358,6 +370,10 @@ static const Int MAX_TU_SIZE =                                     32;
 #endif
 static const Int MAX_NUM_PART_IDXS_IN_CTU_WIDTH = MAX_CU_SIZE/MIN_PU_SIZE; ///< maximum number of partition indices across the width of a CTU (or height of a CTU)
 static const Int SCALING_LIST_REM_NUM =                             6;
+#if PRIMARY_TRANSFORM_CACHE
+static const Int PRIMARY_TRANSFORM_CACHE_SIZE =                   256; ///< number of TUs the primary transform cache of an encoder holds
+static const Int PRIMARY_TRANSFORM_CACHE_MAX_COEFF =             1024; ///< number of samples of the largest TU the primary transform cache holds
+#endif
 
 static const Int QUANT_SHIFT =                                     14; ///< Q(4) = 2^14
 static const Int IQUANT_SHIFT =                                     6;
@@ -389,6 +405,14 @@ static const Int FRUC_MERGE_TEMPLATE =                           0x02;
 static const Int FRUC_MERGE_TEMPLATE_SIZE =                        4 ;
 static const Int FRUC_MERGE_REFINE_MVWEIGHT =                      4 ;
 static const Int FRUC_MERGE_REFINE_MINBLKSIZE =                    4 ;
+#if FRUC_INTERP_WINDOW_CACHE
+static const Int FRUC_INTERP_WINDOW_NUM =                         64 ; ///< number of interpolated windows kept while the FRUC Mv of a PU is derived, the least recently used one is replaced
+static const Int FRUC_INTERP_WINDOW_MARGIN_HOR =                   2 ; ///< samples a window extends beyond the block it is interpolated for on the left and on the right, keeps the width a multiple of 4
+static const Int FRUC_INTERP_WINDOW_MARGIN_VER =                   1 ; ///< samples a window extends beyond the block it is interpolated for above and below
+#endif
+#if FRUC_FLAT_START_MV_LIST
+static const Int FRUC_MAX_START_MV_NUM = 5 + 4 * MAX_NUM_REF + 2 * MAX_NUM_PART_IDXS_IN_CTU_WIDTH * MAX_NUM_PART_IDXS_IN_CTU_WIDTH; ///< bound on the start Mv candidates of a sub-block: start and zero Mv, 2 collocated positions x 2 lists per reference, 2 ATMVP types per 4x4 block, uni-lateral, top and left
+#endif
 #endif
 #if VCEG_AZ07_CTX_RESIDUALCODING
 static const Int MAX_GR_ORDER_RESIDUAL =                          10 ;
@@ -410,6 +434,9 @@ static const Int AFFINE_MAX_NUM_V1 =                                2; ///< max
 static const Int AFFINE_MAX_NUM_V2 =                                2; ///< max number of motion candidates in left-bottom corner
 static const Int AFFINE_MAX_NUM_COMB =                             12; ///< max number of combined motion candidates
 static const Int AFFINE_MIN_BLOCK_SIZE =                            4; ///< Minimum affine MC block size
+#if AFFINE_BATCHED_MC
+static const Int AFFINE_MAX_NUM_SUB_BLOCKS = ( MAX_CU_SIZE / AFFINE_MIN_BLOCK_SIZE ) * ( MAX_CU_SIZE / AFFINE_MIN_BLOCK_SIZE ); ///< maximum number of affine MC sub-blocks of a CU
+#endif
 #endif
 
 #if JVET_C0024_QTBT
@@ -550,7 +577,11 @@ inline void setOff(ClipParam &prm) {
     prm.isChromaActive=false;
 }
 
+#if PARALLEL_FRAME_DECODING || PARALLEL_SUBSTREAM_ENCODING
+extern thread_local ClipParam g_ClipParam;  ///< per thread: the loop filter thread and the substream encoder threads clip with the bounds of the picture they process
+#else
 extern ClipParam g_ClipParam;
+#endif
 
 template <typename T> T ClipA(const T x, const ComponentID compID)
 {
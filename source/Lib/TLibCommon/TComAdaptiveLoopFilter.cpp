@@ -40,6 +40,10 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#if PARALLEL_ALF
+#include <atomic>
+#include <thread>
+#endif
 
 // ====================================================================================================================
 // Tables
@@ -724,6 +728,180 @@ const Int TComAdaptiveLoopFilter::m_aiSymmetricMag9x7[32] =
   2, 2, 2, 2, 1
 };
 
+#if SIMD_AVX2_ALF
+// symmetric taps (dy, dx) of the 9x9, 7x7 and 5x5 diamond filters, with dy > 0 or dy == 0 and dx > 0, in the order of subfilterFrame()
+// the centre tap follows them
+static const Int s_aiDiamondTaps9x9[20][2] =
+{
+  { 4, 0 },
+  { 3, 1 }, { 3, 0 }, { 3, -1 },
+  { 2, 2 }, { 2, 1 }, { 2, 0 }, { 2, -1 }, { 2, -2 },
+  { 1, 3 }, { 1, 2 }, { 1, 1 }, { 1, 0 }, { 1, -1 }, { 1, -2 }, { 1, -3 },
+  { 0, 4 }, { 0, 3 }, { 0, 2 }, { 0, 1 }
+};
+
+static const Int s_aiDiamondTaps7x7[12][2] =
+{
+  { 3, 0 },
+  { 2, 1 }, { 2, 0 }, { 2, -1 },
+  { 1, 2 }, { 1, 1 }, { 1, 0 }, { 1, -1 }, { 1, -2 },
+  { 0, 3 }, { 0, 2 }, { 0, 1 }
+};
+
+static const Int s_aiDiamondTaps5x5[6][2] =
+{
+  { 2, 0 },
+  { 1, 1 }, { 1, 0 }, { 1, -1 },
+  { 0, 2 }, { 0, 1 }
+};
+
+static const Int (*const s_paiDiamondTaps[TComAdaptiveLoopFilter::m_NO_TEST_FILT])[2] = { s_aiDiamondTaps9x9, s_aiDiamondTaps7x7, s_aiDiamondTaps5x5 };
+static const Int s_aiNumDiamondTaps[TComAdaptiveLoopFilter::m_NO_TEST_FILT] = { 20, 12, 6 };
+
+/** Packs the coefficients of a diamond filter in pairs of 16-bit values, in the order of the diamond taps followed by the centre
+ *  \param piTapPairs  ( number of taps + 2 ) / 2 coefficient pairs, the last one padded with 0 for an even number of taps
+ *  \param piCoeff     coefficients in the 9x9 layout of m_filterCoeffShort, the tap (dy, dx) using piCoeff[40 - 9*dy - dx]
+ *  \param transpose   geometric transformation of the class (0: none, 1: transposition, 2: horizontal flip, 3: rotation)
+ *  \returns false if a coefficient does not fit in 16 bits
+ */
+static Bool xPackDiamondTapPairs( Int* piTapPairs, const Int* piCoeff, Int filtNo, Int transpose )
+{
+  const Int iNumTaps = s_aiNumDiamondTaps[filtNo];
+  Short     asCoeff[2*TComAdaptiveLoopFilter::m_ALF_MAX_TAP_PAIRS] = { 0 };
+  Bool      bFits = true;
+  for( Int k = 0; k <= iNumTaps; k++ )
+  {
+    Int dy = 0, dx = 0;
+    if( k < iNumTaps )
+    {
+      const Int iTapY = s_paiDiamondTaps[filtNo][k][0];
+      const Int iTapX = s_paiDiamondTaps[filtNo][k][1];
+      dy = transpose == 1 ? iTapX : transpose == 3 ? -iTapX : iTapY;
+      dx = transpose == 1 || transpose == 3 ? iTapY : transpose == 2 ? -iTapX : iTapX;
+      if( dy < 0 || ( dy == 0 && dx < 0 ) )
+      {
+        dy = -dy;
+        dx = -dx;
+      }
+    }
+    const Int iCoeff = piCoeff[40 - 9*dy - dx];
+    bFits       = bFits && iCoeff >= -32768 && iCoeff <= 32767;
+    asCoeff[k]  = (Short)iCoeff;
+  }
+  for( Int k = 0; k < ( iNumTaps + 2 ) >> 1; k++ )
+  {
+    piTapPairs[k] = (Int)( (UShort)asCoeff[2*k] | ( (UInt)(UShort)asCoeff[2*k+1] << 16 ) );
+  }
+  return bFits;
+}
+#endif
+
+#if SIMD_AVX2_ALF && SIMD_AVX_TARGETS
+#define AVX_ALF_KERNELS                                   1
+#else
+#define AVX_ALF_KERNELS                                   0
+#endif
+#if AVX_ALF_KERNELS
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"   // _mm512_undefined_epi32() in the AVX-512 intrinsics
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#endif
+
+#if AVX_ALF_KERNELS
+/** Diamond filter of a block, 16 samples of one or two rows at a time, the two rows of a 2x2 class block sharing their coefficients
+ *  The sums of the two samples of each symmetric tap, and the centre sample, are interleaved in pairs and multiplied with the coefficient pairs.
+ *  \param iWidth         multiple of 8, the samples of a last group of 8 are filtered in 16 lanes of which 8 are stored
+ *  \param iHeight        even if ppVar is set
+ *  \param piTapOffsets   sample offsets of the symmetric taps
+ *  \param piTapPairs     coefficient pairs of the filter, or the base of the coefficient pairs of all the classes if ppVar is set
+ *  \param ppVar          class code rows of the block, starting at column iVarX, NULL for a single filter
+ *  \param piClassPairs   offset of the coefficient pairs of each class code in piTapPairs
+ */
+__attribute__((target("avx2")))
+static Void simdAlfDiamondFilterAVX2( const imgpel* pSrc, imgpel* pDst, Int iStride, Int iWidth, Int iHeight, const Int* piTapOffsets, Int iNumTaps,
+                                      const Int* piTapPairs, imgpel* const* ppVar, Int iVarX, const Int* piClassPairs, Int iMinVal, Int iMaxVal, Int iShift )
+{
+  const Int     iNumPairs = ( iNumTaps + 2 ) >> 1;
+  const __m256i vRound    = _mm256_set1_epi32( 1 << ( iShift - 1 ) );
+  const __m256i vMin      = _mm256_set1_epi16( (Short)iMinVal );
+  const __m256i vMax      = _mm256_set1_epi16( (Short)iMaxVal );
+  const Int     iRowStep  = ppVar ? 2 : 1;
+
+  for( Int y = 0; y < iHeight; y += iRowStep )
+  {
+    const Int iNumRows = std::min( iRowStep, iHeight - y );
+    for( Int x = 0; x < iWidth; x += 16 )
+    {
+      // the coefficient pairs of the low and high half of each 128-bit lane, as unpacklo/hi_epi16 interleave the samples
+      __m256i vPairsLo = _mm256_setzero_si256(), vPairsHi = _mm256_setzero_si256();
+      if( ppVar )
+      {
+        const imgpel* pVar      = ppVar[y] + iVarX + x;
+        const Int     iNumBlks  = std::min( 8, ( iWidth - x ) >> 1 );
+        Int           aiBlk[8];
+        for( Int b = 0; b < 8; b++ )
+        {
+          aiBlk[b] = piClassPairs[pVar[b < iNumBlks ? 2*b : 0]];
+        }
+        vPairsLo = _mm256_setr_epi32( aiBlk[0], aiBlk[0], aiBlk[1], aiBlk[1], aiBlk[4], aiBlk[4], aiBlk[5], aiBlk[5] );
+        vPairsHi = _mm256_setr_epi32( aiBlk[2], aiBlk[2], aiBlk[3], aiBlk[3], aiBlk[6], aiBlk[6], aiBlk[7], aiBlk[7] );
+      }
+      __m256i vSumLo[2] = { _mm256_setzero_si256(), _mm256_setzero_si256() };
+      __m256i vSumHi[2] = { _mm256_setzero_si256(), _mm256_setzero_si256() };
+      for( Int k = 0; k < iNumPairs; k++ )
+      {
+        __m256i vCoeffLo, vCoeffHi;
+        if( ppVar )
+        {
+          vCoeffLo = _mm256_i32gather_epi32( piTapPairs + k, vPairsLo, 4 );
+          vCoeffHi = _mm256_i32gather_epi32( piTapPairs + k, vPairsHi, 4 );
+        }
+        else
+        {
+          vCoeffLo = vCoeffHi = _mm256_set1_epi32( piTapPairs[k] );
+        }
+        for( Int r = 0; r < iNumRows; r++ )
+        {
+          const imgpel* p = pSrc + ( y + r ) * iStride + x;
+          __m256i vTerm[2];
+          for( Int t = 0; t < 2; t++ )
+          {
+            const Int iTap = 2*k + t;
+            if( iTap < iNumTaps )
+            {
+              vTerm[t] = _mm256_add_epi16( _mm256_loadu_si256( ( const __m256i* )( p + piTapOffsets[iTap] ) ),
+                                           _mm256_loadu_si256( ( const __m256i* )( p - piTapOffsets[iTap] ) ) );
+            }
+            else
+            {
+              vTerm[t] = iTap == iNumTaps ? _mm256_loadu_si256( ( const __m256i* )p ) : _mm256_setzero_si256();
+            }
+          }
+          vSumLo[r] = _mm256_add_epi32( vSumLo[r], _mm256_madd_epi16( _mm256_unpacklo_epi16( vTerm[0], vTerm[1] ), vCoeffLo ) );
+          vSumHi[r] = _mm256_add_epi32( vSumHi[r], _mm256_madd_epi16( _mm256_unpackhi_epi16( vTerm[0], vTerm[1] ), vCoeffHi ) );
+        }
+      }
+      for( Int r = 0; r < iNumRows; r++ )
+      {
+        const __m256i vLo = _mm256_srai_epi32( _mm256_add_epi32( vSumLo[r], vRound ), iShift );
+        const __m256i vHi = _mm256_srai_epi32( _mm256_add_epi32( vSumHi[r], vRound ), iShift );
+        const __m256i vRes = _mm256_min_epi16( _mm256_max_epi16( _mm256_packs_epi32( vLo, vHi ), vMin ), vMax );
+        imgpel* d = pDst + ( y + r ) * iStride + x;
+        if( iWidth - x >= 16 )
+        {
+          _mm256_storeu_si256( ( __m256i* )d, vRes );
+        }
+        else
+        {
+          _mm_storeu_si128( ( __m128i* )d, _mm256_castsi256_si128( vRes ) );
+        }
+      }
+    }
+  }
+}
+#endif
+
 
 // ====================================================================================================================
 // Constructor / destructor / create / destroy
@@ -754,6 +932,23 @@ TComAdaptiveLoopFilter::TComAdaptiveLoopFilter()
   m_filterCoeffShort = NULL;
   m_alfClipTable = NULL;
   m_alfClipOffset = 0;
+#if FIX_TICKET12 && PARALLEL_SEGMENT_ENCODING
+  m_bPendingAlfTempPredRefresh = false;
+  m_iPocLastCRA = 0;
+#endif
+#if SIMD_AVX2_ALF
+  m_iLumaTapFiltNo = -1;
+  m_bChromaTapPairs = false;
+  for( Int iCode = 0; iCode < m_ALF_NUM_CLASS_CODES; iCode++ )
+  {
+    Int transpose;
+    Int varIndMod = selectTransposeVarInd( iCode, &transpose );
+    m_aiClassTapPairs[iCode] = ( varIndMod * 4 + transpose ) * m_ALF_MAX_TAP_PAIRS;
+  }
+#endif
+#if PARALLEL_ALF
+  m_iNumThreads = 1;
+#endif
 }
 
 Void TComAdaptiveLoopFilter:: xError(const char *text, int code)
@@ -1018,6 +1213,13 @@ Void TComAdaptiveLoopFilter::destroy()
 #if JVET_C0038_GALF
   destroyMatrix_int(m_imgY_dig0);
   destroyMatrix_int(m_imgY_dig1);
+#endif
+#if PARALLEL_ALF
+  for( Int i = 0; i < (Int)m_aiThreadGradients.size(); i++ )
+  {
+    destroyMatrix_int(m_aiThreadGradients[i]);
+  }
+  m_aiThreadGradients.clear();
 #endif
   free_mem2Dpel(m_varImgMethods);
   destroyMatrix_short(m_filterCoeffShort);
@@ -1395,6 +1597,14 @@ Void TComAdaptiveLoopFilter::initVarForChroma  (ALFParam* pcAlfParam, Bool bUpda
       m_filterCoeffShort[0][i]=0;
     }
   }  
+#if SIMD_AVX2_ALF
+  Int aiCoeff[m_MAX_SQR_FILT_LENGTH];
+  for( i = 0; i < m_MAX_SQR_FILT_LENGTH; i++ )
+  {
+    aiCoeff[i] = m_filterCoeffShort[0][i];
+  }
+  m_bChromaTapPairs = xPackDiamondTapPairs( m_aiChromaTapPairs, aiCoeff, filtNo, 0 );
+#endif
 }
 #endif
 // --------------------------------------------------------------------------------------------------------------------
@@ -1676,6 +1886,9 @@ Void TComAdaptiveLoopFilter::DecFilter_qc(imgpel* imgY_rec,ALFParam* pcAlfParam,
     }
     m_filterCoeffShort[varInd][centerCoef] = (Short)coef[centerCoef];
   }
+#if SIMD_AVX2_ALF
+  xSetLumaTapPairs( m_filterCoeffPrevSelected, 0 );
+#endif
 #else
   for(Int varInd=0; varInd<m_NO_VAR_BINS; ++varInd)
   {
@@ -1925,7 +2138,14 @@ static imgpel Clip_post(int high, int val)
   return (imgpel)(((val > high)? high: val));
 }
 
+#if PARALLEL_ALF
+/** Classification of the 2x2 blocks of an area, window by window
+ *  \param iThread  index of the calling thread among those of xRunFilterJobs(), selecting its gradient buffers
+ */
+Void TComAdaptiveLoopFilter::calcVar(imgpel **imgY_var, imgpel *imgY_pad, int pad_size, int fl, int img_height, int img_width, int img_stride, int start_width , int start_height, Int iThread )
+#else
 Void TComAdaptiveLoopFilter::calcVar(imgpel **imgY_var, imgpel *imgY_pad, int pad_size, int fl, int img_height, int img_width, int img_stride, int start_width , int start_height )
+#endif
 {
   Int i, j;
 
@@ -1937,13 +2157,32 @@ Void TComAdaptiveLoopFilter::calcVar(imgpel **imgY_var, imgpel *imgY_pad, int pa
     {
       Int nHeight = min( i + m_ALF_WIN_VERSIZE, end_height ) - i;
       Int nWidth  = min( j + m_ALF_WIN_HORSIZE, end_width  ) - j;
+#if PARALLEL_ALF
+      xCalcVar( imgY_var, imgY_pad, pad_size, fl, nHeight, nWidth, img_stride, j, i, iThread );
+#else
       xCalcVar( imgY_var, imgY_pad, pad_size, fl, nHeight, nWidth, img_stride, j, i );
+#endif
     }
   }
 }
 #if JVET_C0038_GALF
+#if PARALLEL_ALF
+Void TComAdaptiveLoopFilter::xCalcVarPerPixel(imgpel **imgY_var, imgpel *imgY_pad, Int pad_size, Int fl, Int img_height, Int img_width, Int img_stride, Int start_width , Int start_height, Int iThread )
+#else
 Void TComAdaptiveLoopFilter::xCalcVarPerPixel(imgpel **imgY_var, imgpel *imgY_pad, Int pad_size, Int fl, Int img_height, Int img_width, Int img_stride, Int start_width , Int start_height )
+#endif
 {
+#if PARALLEL_ALF
+  Int** imgY_ver  = iThread ? m_aiThreadGradients[4*iThread-4] : m_imgY_ver;
+  Int** imgY_hor  = iThread ? m_aiThreadGradients[4*iThread-3] : m_imgY_hor;
+  Int** imgY_dig0 = iThread ? m_aiThreadGradients[4*iThread-2] : m_imgY_dig0;
+  Int** imgY_dig1 = iThread ? m_aiThreadGradients[4*iThread-1] : m_imgY_dig1;
+#else
+  Int** imgY_ver  = m_imgY_ver;
+  Int** imgY_hor  = m_imgY_hor;
+  Int** imgY_dig0 = m_imgY_dig0;
+  Int** imgY_dig1 = m_imgY_dig1;
+#endif
   Int th[16] = {0, 1, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3, 4};  
   fl              = 2;
   Int i, j;
@@ -1976,30 +2215,30 @@ Void TComAdaptiveLoopFilter::xCalcVarPerPixel(imgpel **imgY_var, imgpel *imgY_pa
     for(j = 2; j < imgWExtended; j+=2)  
     {
       pixY = j - 1 + start_width;
-      m_imgY_ver [i-2][j-2] = abs((p_imgY_pad   [pixY  ]<<1) - p_imgY_pad_down[pixY  ] - p_imgY_pad_up  [pixY  ])+   
+      imgY_ver [i-2][j-2] = abs((p_imgY_pad   [pixY  ]<<1) - p_imgY_pad_down[pixY  ] - p_imgY_pad_up  [pixY  ])+   
                                abs((p_imgY_pad   [pixY+1]<<1) - p_imgY_pad_down[pixY+1] - p_imgY_pad_up  [pixY+1])+   
                                abs((p_imgY_pad_up[pixY  ]<<1) - p_imgY_pad     [pixY  ] - p_imgY_pad_up2 [pixY  ])+   
                                abs((p_imgY_pad_up[pixY+1]<<1) - p_imgY_pad     [pixY+1] - p_imgY_pad_up2 [pixY+1]);   
 
-      m_imgY_hor [i-2][j-2] = abs((p_imgY_pad   [pixY  ]<<1) - p_imgY_pad     [pixY+1] - p_imgY_pad     [pixY-1])+        
+      imgY_hor [i-2][j-2] = abs((p_imgY_pad   [pixY  ]<<1) - p_imgY_pad     [pixY+1] - p_imgY_pad     [pixY-1])+        
                                abs((p_imgY_pad   [pixY+1]<<1) - p_imgY_pad     [pixY+2] - p_imgY_pad     [pixY  ])+        
                                abs((p_imgY_pad_up[pixY  ]<<1) - p_imgY_pad_up  [pixY+1] - p_imgY_pad_up  [pixY-1])+        
                                abs((p_imgY_pad_up[pixY+1]<<1) - p_imgY_pad_up  [pixY+2] - p_imgY_pad_up  [pixY  ]);        
-      m_imgY_dig0[i-2][j-2] = abs((p_imgY_pad   [pixY  ]<<1) - p_imgY_pad_down[pixY-1] - p_imgY_pad_up  [pixY+1])+
+      imgY_dig0[i-2][j-2] = abs((p_imgY_pad   [pixY  ]<<1) - p_imgY_pad_down[pixY-1] - p_imgY_pad_up  [pixY+1])+
                               abs((p_imgY_pad   [pixY+1]<<1) - p_imgY_pad_down[pixY  ] - p_imgY_pad_up  [pixY+2])+
                               abs((p_imgY_pad_up[pixY  ]<<1) - p_imgY_pad     [pixY-1] - p_imgY_pad_up2 [pixY+1])+
                               abs((p_imgY_pad_up[pixY+1]<<1) - p_imgY_pad     [pixY  ] - p_imgY_pad_up2 [pixY+2]);
 
-      m_imgY_dig1[i-2][j-2] = abs((p_imgY_pad   [pixY  ]<<1) - p_imgY_pad_up  [pixY-1] - p_imgY_pad_down[pixY+1])+
+      imgY_dig1[i-2][j-2] = abs((p_imgY_pad   [pixY  ]<<1) - p_imgY_pad_up  [pixY-1] - p_imgY_pad_down[pixY+1])+
                               abs((p_imgY_pad   [pixY+1]<<1) - p_imgY_pad_up  [pixY  ] - p_imgY_pad_down[pixY+2])+
                               abs((p_imgY_pad_up[pixY  ]<<1) - p_imgY_pad_up2 [pixY-1] - p_imgY_pad     [pixY+1])+
                               abs((p_imgY_pad_up[pixY+1]<<1) - p_imgY_pad_up2 [pixY  ] - p_imgY_pad     [pixY+2]);
       if (j > 4 )
       {
-        m_imgY_ver [i-2][j-6] = m_imgY_ver [i-2][j-6]+m_imgY_ver [i-2][j-4]+m_imgY_ver [i-2][j-2];
-        m_imgY_hor [i-2][j-6] = m_imgY_hor [i-2][j-6]+m_imgY_hor [i-2][j-4]+m_imgY_hor [i-2][j-2];
-        m_imgY_dig0[i-2][j-6] = m_imgY_dig0[i-2][j-6]+m_imgY_dig0[i-2][j-4]+m_imgY_dig0[i-2][j-2];
-        m_imgY_dig1[i-2][j-6] = m_imgY_dig1[i-2][j-6]+m_imgY_dig1[i-2][j-4]+m_imgY_dig1[i-2][j-2];
+        imgY_ver [i-2][j-6] = imgY_ver [i-2][j-6]+imgY_ver [i-2][j-4]+imgY_ver [i-2][j-2];
+        imgY_hor [i-2][j-6] = imgY_hor [i-2][j-6]+imgY_hor [i-2][j-4]+imgY_hor [i-2][j-2];
+        imgY_dig0[i-2][j-6] = imgY_dig0[i-2][j-6]+imgY_dig0[i-2][j-4]+imgY_dig0[i-2][j-2];
+        imgY_dig1[i-2][j-6] = imgY_dig1[i-2][j-6]+imgY_dig1[i-2][j-4]+imgY_dig1[i-2][j-2];
       }
     }
   }
@@ -2008,10 +2247,10 @@ Void TComAdaptiveLoopFilter::xCalcVarPerPixel(imgpel **imgY_var, imgpel *imgY_pa
   {
     for(j = 0; j < img_width; j += 2)  
     {
-      Int sum_V   = m_imgY_ver [i][j] +m_imgY_ver [i+2][j]+m_imgY_ver [i+4][j];
-      Int sum_H   = m_imgY_hor [i][j] +m_imgY_hor [i+2][j]+m_imgY_hor [i+4][j]; 
-      Int sum_D0  = m_imgY_dig0[i][j] +m_imgY_dig0[i+2][j]+m_imgY_dig0[i+4][j];
-      Int sum_D1  = m_imgY_dig1[i][j] +m_imgY_dig1[i+2][j]+m_imgY_dig1[i+4][j];
+      Int sum_V   = imgY_ver [i][j] +imgY_ver [i+2][j]+imgY_ver [i+4][j];
+      Int sum_H   = imgY_hor [i][j] +imgY_hor [i+2][j]+imgY_hor [i+4][j]; 
+      Int sum_D0  = imgY_dig0[i][j] +imgY_dig0[i+2][j]+imgY_dig0[i+4][j];
+      Int sum_D1  = imgY_dig1[i][j] +imgY_dig1[i+2][j]+imgY_dig1[i+4][j];
       iTempAct    = sum_V+sum_H;
       avg_var     = (imgpel) Clip_post(var_max, (iTempAct*24)>>(shift));     
       avg_var     = th[avg_var];
@@ -2090,11 +2329,19 @@ Int TComAdaptiveLoopFilter::selectTransposeVarInd(Int varInd, Int *transpose)
   return(varIndMod);
 }
 
+#if PARALLEL_ALF
+Void TComAdaptiveLoopFilter::xCalcVar(imgpel **imgY_var, imgpel *imgY_pad, int pad_size, int fl, int img_height, int img_width, int img_stride, int start_width , int start_height, Int iThread )
+{
+  xCalcVarPerPixel(imgY_var, imgY_pad, pad_size, fl, img_height, img_width, img_stride, start_width , start_height, iThread );
+  return;
+}
+#else
 Void TComAdaptiveLoopFilter::xCalcVar(imgpel **imgY_var, imgpel *imgY_pad, int pad_size, int fl, int img_height, int img_width, int img_stride, int start_width , int start_height )
 {
   xCalcVarPerPixel(imgY_var, imgY_pad, pad_size, fl, img_height, img_width, img_stride, start_width , start_height );
   return;
 }
+#endif
 #else
 Void TComAdaptiveLoopFilter::xCalcVar(imgpel **imgY_var, imgpel *imgY_pad, int pad_size, int fl, int img_height, int img_width, int img_stride, int start_width , int start_height )
 {
@@ -2172,12 +2419,157 @@ Void TComAdaptiveLoopFilter::xCalcVar(imgpel **imgY_var, imgpel *imgY_pad, int p
 }
 #endif
 
+#if PARALLEL_ALF
+/** Runs the jobs 0..iNumJobs-1 on up to m_iNumThreads threads, the calling thread included, each thread taking the next job until none is left
+ *  \param rcJob  called with the job and the index of the thread running it, 0 for the calling thread, which selects its classification buffers
+ */
+Void TComAdaptiveLoopFilter::xRunFilterJobs( Int iNumJobs, const std::function<Void( Int iJob, Int iThread )>& rcJob )
+{
+  const Int iNumThreads = std::min( m_iNumThreads, iNumJobs );
+  if( iNumThreads <= 1 )
+  {
+    for( Int iJob = 0; iJob < iNumJobs; iJob++ )
+    {
+      rcJob( iJob, 0 );
+    }
+    return;
+  }
+
+  Int iPadOffset = max(2, JVET_C0038_SHIFT_VAL_HALFW);
+  while( (Int)m_aiThreadGradients.size() < 4 * ( iNumThreads - 1 ) )
+  {
+    Int** ppiGradients;
+    initMatrix_int(&ppiGradients, m_ALF_WIN_VERSIZE+2*iPadOffset+3, m_ALF_WIN_HORSIZE+2*iPadOffset+3);
+    m_aiThreadGradients.push_back( ppiGradients );
+  }
+
+  std::atomic<Int> iNextJob( 0 );
+#if JVET_D0033_ADAPTIVE_CLIPPING && ( PARALLEL_FRAME_DECODING || PARALLEL_SUBSTREAM_ENCODING )
+  const ClipParam cClipParam = g_ClipParam;
+#endif
+  auto runJobs = [&]( Int iThread )
+  {
+#if JVET_D0033_ADAPTIVE_CLIPPING && ( PARALLEL_FRAME_DECODING || PARALLEL_SUBSTREAM_ENCODING )
+    // the clipping bounds are per thread
+    g_ClipParam = cClipParam;
+#endif
+    for( Int iJob = iNextJob++; iJob < iNumJobs; iJob = iNextJob++ )
+    {
+      rcJob( iJob, iThread );
+    }
+  };
+  std::vector<std::thread> threads;
+  for( Int i = 1; i < iNumThreads; i++ )
+  {
+    threads.push_back( std::thread( runJobs, i ) );
+  }
+  runJobs( 0 );
+  for( Int i = 0; i < (Int)threads.size(); i++ )
+  {
+    threads[i].join();
+  }
+}
+#endif
+
+#if SIMD_AVX2_ALF
+/** Sets the coefficient pairs of the SIMD luma filter from the coefficients of the classes
+ *  \param ppiCoeff  [class], coefficients in the 9x9 layout
+ *  \param filtNo    filter shape (0: 9x9, 1: 7x7, 2: 5x5 diamond)
+ *  \returns false if a coefficient does not fit in 16 bits, the C code filters luma then
+ */
+Bool TComAdaptiveLoopFilter::xSetLumaTapPairs( Int** ppiCoeff, Int filtNo )
+{
+  Bool bFits = true;
+  for( Int varInd = 0; varInd < m_NO_VAR_BINS; varInd++ )
+  {
+    for( Int transpose = 0; transpose < 4; transpose++ )
+    {
+      bFits = xPackDiamondTapPairs( m_aiLumaTapPairs[varInd*4 + transpose], ppiCoeff[varInd], filtNo, transpose ) && bFits;
+    }
+  }
+  m_iLumaTapFiltNo = bFits ? filtNo : -1;
+  return bFits;
+}
+
+/** Filters the left columns of a block with the SIMD kernel, with the coefficient pairs of xSetLumaTapPairs() or initVarForChroma()
+ *  \param imgY_var  class codes of the luma samples, unused for chroma
+ *  \returns the number of columns filtered, a multiple of 8, 0 if the SIMD kernel is not available
+ */
+Int TComAdaptiveLoopFilter::xFilterBlockSIMD( imgpel *imgY_rec_post, imgpel *imgY_rec, imgpel **imgY_var, Int startHeight, Int endHeight, Int startWidth, Int endWidth, Int Stride, ComponentID compid )
+{
+#if AVX_ALF_KERNELS
+  const Bool bChroma = compid != COMPONENT_Y;
+  const Int  filtNo  = bChroma ? 2 : m_iLumaTapFiltNo;
+  const Int  iWidth  = ( endWidth - startWidth ) & ~7;
+  if( !m_fpDiamondFilter || m_nIBDIMax >= ( 1 << 14 ) || iWidth == 0 )
+  {
+    return 0;
+  }
+  // the two rows of a class block are filtered together
+  if( bChroma ? !m_bChromaTapPairs : ( filtNo < 0 || ( ( startHeight | startWidth ) & 1 ) ) )
+  {
+    return 0;
+  }
+
+  Int aiTapOffsets[20];
+  for( Int k = 0; k < s_aiNumDiamondTaps[filtNo]; k++ )
+  {
+    aiTapOffsets[k] = s_paiDiamondTaps[filtNo][k][0] * Stride + s_paiDiamondTaps[filtNo][k][1];
+  }
+  Int iMinVal = 0;
+  Int iMaxVal = m_nIBDIMax;
+#if JVET_D0033_ADAPTIVE_CLIPPING
+  // the C code clips to the sample range, then to the adaptive clipping bounds
+  iMinVal = ClipA( (imgpel)iMinVal, compid );
+  iMaxVal = ClipA( (imgpel)iMaxVal, compid );
+#endif
+  const Int iOffset = startHeight * Stride + startWidth;
+  m_fpDiamondFilter( imgY_rec + iOffset, imgY_rec_post + iOffset, Stride, iWidth, endHeight - startHeight, aiTapOffsets, s_aiNumDiamondTaps[filtNo],
+                     bChroma ? m_aiChromaTapPairs : m_aiLumaTapPairs[0], bChroma ? NULL : imgY_var + startHeight, startWidth, m_aiClassTapPairs,
+                     iMinVal, iMaxVal, m_NUM_BITS - 1 );
+  return iWidth;
+#else
+  return 0;
+#endif
+}
+
+Void (*TComAdaptiveLoopFilter::m_fpDiamondFilter)( const imgpel* pSrc, imgpel* pDst, Int iStride, Int iWidth, Int iHeight, const Int* piTapOffsets, Int iNumTaps,
+                                                  const Int* piTapPairs, imgpel* const* ppVar, Int iVarX, const Int* piClassPairs, Int iMinVal, Int iMaxVal, Int iShift ) = NULL;
+
+/** Select the diamond filter kernel of a SIMD level, called once at start-up by initSimdLevel()
+ */
+Void TComAdaptiveLoopFilter::initSimdKernels( SimdLevel eLevel )
+{
+#if AVX_ALF_KERNELS
+  m_fpDiamondFilter = eLevel >= SIMD_AVX2 ? simdAlfDiamondFilterAVX2 : NULL;
+#endif
+}
+#endif
+
 #if JVET_C0038_GALF
 Void TComAdaptiveLoopFilter::filterFrame(imgpel *imgYRecPost, imgpel *imgYRec, ALFParam* pcAlfPara, int stride)
 #else
 Void TComAdaptiveLoopFilter::filterFrame(imgpel *imgYRecPost, imgpel *imgYRec, int filtNo, int stride)
 #endif
 {
+#if PARALLEL_ALF
+  // each job classifies and filters a row of windows
+  xRunFilterJobs( ( m_img_height + m_ALF_WIN_VERSIZE - 1 ) / m_ALF_WIN_VERSIZE, [&]( Int iJob, Int iThread )
+  {
+    const Int i       = iJob * m_ALF_WIN_VERSIZE;
+    const Int nHeight = min( i + m_ALF_WIN_VERSIZE, m_img_height ) - i;
+    for( Int j = 0; j < m_img_width; j += m_ALF_WIN_HORSIZE )
+    {
+      const Int nWidth = min( j + m_ALF_WIN_HORSIZE, m_img_width ) - j;
+      calcVar( m_imgY_var, imgYRec, m_FILTER_LENGTH/2, JVET_C0038_SHIFT_VAL_HALFW, nHeight, nWidth, stride , j , i, iThread );
+      subfilterFrame(imgYRecPost, imgYRec, pcAlfPara, i, i + nHeight, j, j + nWidth, stride
+               #if JVET_D0033_ADAPTIVE_CLIPPING
+                    , COMPONENT_Y
+               #endif
+                     );
+    }
+  } );
+#else
   Int i, j;
   for (i = 0; i < m_img_height; i+=m_ALF_WIN_VERSIZE)
   {
@@ -2202,6 +2594,7 @@ Void TComAdaptiveLoopFilter::filterFrame(imgpel *imgYRecPost, imgpel *imgYRec, i
 #endif
     }
   }
+#endif
 }
 #if JVET_C0038_GALF
 Void TComAdaptiveLoopFilter::subfilterFrame(imgpel *imgYRecPost, imgpel *imgYRec, ALFParam* pcAlfPara, Int startHeight, Int endHeight, Int startWidth, Int endWidth, Int stride,
@@ -2224,6 +2617,16 @@ Void TComAdaptiveLoopFilter::subfilterFrame(imgpel *imgYRecPost, imgpel *imgYRec
     assert(pcAlfPara->tap_chroma ==5);
   }
   Int filtNo = bChroma ? 2 : 0;
+#if SIMD_AVX2_ALF
+#if !JVET_D0033_ADAPTIVE_CLIPPING
+  const ComponentID compid = bChroma ? COMPONENT_Cb : COMPONENT_Y;
+#endif
+  startWidth += xFilterBlockSIMD( imgYRecPost, imgYRec, bChroma ? NULL : m_imgY_var, startHeight, endHeight, startWidth, endWidth, stride, compid );
+  if( startWidth == endWidth )
+  {
+    return;
+  }
+#endif
 #else
   Int varStepSizeWidth = m_ALF_VAR_SIZE_W;
   Int varStepSizeHeight = m_ALF_VAR_SIZE_H;
@@ -2708,6 +3111,19 @@ Void TComAdaptiveLoopFilter::subfilterFrame(imgpel *imgYRecPost, imgpel *imgYRec
 
 Void TComAdaptiveLoopFilter::xCUAdaptive_qc(TComPic* pcPic, ALFParam* pcAlfParam, imgpel *imgY_rec_post, imgpel *imgY_rec, Int Stride)
 {
+#if PARALLEL_ALF
+  // each job filters a row of CTUs
+  const UInt uiWidthInCtus = pcPic->getFrameWidthInCtus();
+  const UInt uiNumCtus     = pcPic->getNumberOfCtusInFrame();
+  xRunFilterJobs( ( uiNumCtus + uiWidthInCtus - 1 ) / uiWidthInCtus, [&]( Int iJob, Int iThread )
+  {
+    for( UInt uiCUAddr = iJob * uiWidthInCtus; uiCUAddr < std::min( ( iJob + 1 ) * uiWidthInCtus, uiNumCtus ); uiCUAddr++ )
+    {
+      TComDataCU* pcCU = pcPic->getCtu( uiCUAddr );
+      xSubCUAdaptive_qc(pcCU, pcAlfParam, imgY_rec_post, imgY_rec, 0, 0, pcCU->getSlice()->getSPS()->getCTUSize(), pcCU->getSlice()->getSPS()->getCTUSize(), Stride, iThread);
+    }
+  } );
+#else
   // for every CU, call CU-adaptive ALF process
   for( UInt uiCUAddr = 0; uiCUAddr < pcPic->getNumberOfCtusInFrame() ; uiCUAddr++ )
   {
@@ -2718,9 +3134,12 @@ Void TComAdaptiveLoopFilter::xCUAdaptive_qc(TComPic* pcPic, ALFParam* pcAlfParam
     xSubCUAdaptive_qc(pcCU, pcAlfParam, imgY_rec_post, imgY_rec, 0, 0, Stride);
 #endif
   }
+#endif
 }
 
-#if JVET_C0024_QTBT
+#if PARALLEL_ALF
+Void TComAdaptiveLoopFilter::xSubCUAdaptive_qc(TComDataCU* pcCU, ALFParam* pcAlfParam, imgpel *imgY_rec_post, imgpel *imgY_rec, UInt uiAbsPartIdx, UInt uiDepth, UInt uiWidth, UInt uiHeight, Int Stride, Int iThread)
+#elif JVET_C0024_QTBT
 Void TComAdaptiveLoopFilter::xSubCUAdaptive_qc(TComDataCU* pcCU, ALFParam* pcAlfParam, imgpel *imgY_rec_post, imgpel *imgY_rec, UInt uiAbsPartIdx, UInt uiDepth, UInt uiWidth, UInt uiHeight, Int Stride)
 #else
 Void TComAdaptiveLoopFilter::xSubCUAdaptive_qc(TComDataCU* pcCU, ALFParam* pcAlfParam, imgpel *imgY_rec_post, imgpel *imgY_rec, UInt uiAbsPartIdx, UInt uiDepth, Int Stride)
@@ -2766,7 +3185,9 @@ Void TComAdaptiveLoopFilter::xSubCUAdaptive_qc(TComDataCU* pcCU, ALFParam* pcAlf
       uiTPelY   = pcCU->getCUPelY() + g_auiRasterToPelY[ g_auiZscanToRaster[uiAbsPartIdx] ];
       
       if( ( uiLPelX < pcCU->getSlice()->getSPS()->getPicWidthInLumaSamples() ) && ( uiTPelY < pcCU->getSlice()->getSPS()->getPicHeightInLumaSamples() ) )
-#if JVET_C0024_QTBT
+#if PARALLEL_ALF
+        xSubCUAdaptive_qc(pcCU, pcAlfParam, imgY_rec_post, imgY_rec, uiAbsPartIdx, uiDepth+1, uiWidth>>1, uiHeight>>1, Stride, iThread);
+#elif JVET_C0024_QTBT
         xSubCUAdaptive_qc(pcCU, pcAlfParam, imgY_rec_post, imgY_rec, uiAbsPartIdx, uiDepth+1, uiWidth>>1, uiHeight>>1, Stride);
 #else
         xSubCUAdaptive_qc(pcCU, pcAlfParam, imgY_rec_post, imgY_rec, uiAbsPartIdx, uiDepth+1, Stride);
@@ -2802,8 +3223,12 @@ Void TComAdaptiveLoopFilter::xSubCUAdaptive_qc(TComDataCU* pcCU, ALFParam* pcAlf
 #else
     Int nHeight = min(uiBPelY+1,(unsigned int)(m_img_height)) - uiTPelY;
     Int nWidth  = min(uiRPelX+1,(unsigned int)(m_img_width)) - uiLPelX;
-#if JVET_C0038_GALF
+#if PARALLEL_ALF
+    calcVar( m_imgY_var, imgY_rec, m_FILTER_LENGTH/2, JVET_C0038_SHIFT_VAL_HALFW, nHeight, nWidth, Stride , uiLPelX , uiTPelY, iThread);
+#elif JVET_C0038_GALF
     calcVar( m_imgY_var, imgY_rec, m_FILTER_LENGTH/2, JVET_C0038_SHIFT_VAL_HALFW, nHeight, nWidth, Stride , uiLPelX , uiTPelY);
+#endif
+#if JVET_C0038_GALF
     subfilterFrame(imgY_rec_post, imgY_rec, pcAlfParam, uiTPelY, min(uiBPelY+1,(unsigned int)(m_img_height)), uiLPelX, min(uiRPelX+1,(unsigned int)(m_img_width)), Stride
                #if JVET_D0033_ADAPTIVE_CLIPPING
                     , COMPONENT_Y
@@ -2902,6 +3327,20 @@ Void TComAdaptiveLoopFilter::xFrameChroma(ALFParam* pcAlfParam, TComPicYuv* pcPi
     pDec  =  (imgpel*)pcPicDec->getAddr(COMPONENT_Cb);
     pRest =  (imgpel*)pcPicRest->getAddr(COMPONENT_Cb);
   }
+#if PARALLEL_ALF
+  // each job filters a band of rows
+  xRunFilterJobs( ( iHeight + m_ALF_WIN_VERSIZE - 1 ) / m_ALF_WIN_VERSIZE, [&]( Int iJob, Int )
+  {
+    const Int iStartHeight = iJob * m_ALF_WIN_VERSIZE;
+    subfilterFrame(pRest, pDec, pcAlfParam, iStartHeight, min( iStartHeight + m_ALF_WIN_VERSIZE, iHeight ), 0, iWidth, iDecStride,
+                 #if JVET_D0033_ADAPTIVE_CLIPPING
+                  (iColor==0)?COMPONENT_Cb:COMPONENT_Cr
+                 #else
+                   true
+                 #endif
+                   );
+  } );
+#else
   subfilterFrame(pRest, pDec, pcAlfParam, 0, iHeight, 0, iWidth, iDecStride,
                #if JVET_D0033_ADAPTIVE_CLIPPING
                 (iColor==0)?COMPONENT_Cb:COMPONENT_Cr
@@ -2909,6 +3348,7 @@ Void TComAdaptiveLoopFilter::xFrameChroma(ALFParam* pcAlfParam, TComPicYuv* pcPi
                  true
                #endif
                  );
+#endif
 }
 #else
 Void TComAdaptiveLoopFilter::xFrameChroma( TComPicYuv* pcPicDec, TComPicYuv* pcPicRest, Int *qh, Int iTap, Int iColor )
@@ -3332,8 +3772,13 @@ Void TComAdaptiveLoopFilter::setAlfCtrlFlags(ALFParam *pAlfParam, TComDataCU *pc
 #if FIX_TICKET12
 Bool TComAdaptiveLoopFilter::refreshAlfTempPred( NalUnitType naluType , Int poc )
 {
+#if PARALLEL_SEGMENT_ENCODING
+  Bool &pendingRefresh = m_bPendingAlfTempPredRefresh;
+  Int  &pocLastCRA     = m_iPocLastCRA;
+#else
   static bool pendingRefresh = false;
   static Int pocLastCRA = 0;
+#endif
   Bool refresh = false;
 
   if( pendingRefresh == true && pocLastCRA < poc )
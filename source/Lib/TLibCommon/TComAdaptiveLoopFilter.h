@@ -40,6 +40,10 @@
 
 #include "CommonDef.h"
 #include "TComPic.h"
+#if PARALLEL_ALF
+#include <functional>
+#include <vector>
+#endif
 
 #if ALF_HM3_REFACTOR
 #if JVET_C0038_GALF
@@ -161,6 +165,10 @@ public:
   static const Int m_SQR_FILT_LENGTH_9SYM  = ((9*9) / 4 + 1); 
   static const Int m_SQR_FILT_LENGTH_7SYM  = ((7*7) / 4 + 1); 
   static const Int m_SQR_FILT_LENGTH_5SYM  = ((5*5) / 4 + 1); 
+#if SIMD_AVX2_ALF
+  static const Int m_ALF_MAX_TAP_PAIRS     = 11;                                    ///< 16-bit coefficient pairs of the 9x9 diamond filter, 20 symmetric taps and the centre
+  static const Int m_ALF_NUM_CLASS_CODES   = 24 << NO_VALS_LAGR_SHIFT;              ///< class codes of xCalcVarPerPixel(), direction 0..23 above the activity
+#endif
 #else
   static const Int m_NO_VAR_BINS           = 16; 
   static const Int m_NO_FILTERS            = 16; 
@@ -252,9 +260,26 @@ protected:
   Short **  m_filterCoeffShort;
   imgpel *  m_alfClipTable;
   Int       m_alfClipOffset;
+#if FIX_TICKET12 && PARALLEL_SEGMENT_ENCODING
+  Bool      m_bPendingAlfTempPredRefresh;   ///< a random access point has been seen, the temporal prediction is reset at the next picture following it
+  Int       m_iPocLastCRA;                  ///< POC of the last random access point
+#endif
   Int **    m_filterCoeffTmp;
   Int **    m_filterCoeffSymTmp;
   UInt      m_uiNumCUsInFrame;
+#if SIMD_AVX2_ALF
+  Int       m_aiLumaTapPairs[m_NO_VAR_BINS*4][m_ALF_MAX_TAP_PAIRS];  ///< [class*4+transpose], luma coefficients packed in pairs in the order of the diamond taps (see xSetLumaTapPairs())
+  Int       m_aiChromaTapPairs[m_ALF_MAX_TAP_PAIRS];                  ///< chroma coefficients packed in pairs in the order of the 5x5 diamond taps
+  Int       m_aiClassTapPairs[m_ALF_NUM_CLASS_CODES];                 ///< [class code], offset of the luma coefficient pairs of the class and transpose in m_aiLumaTapPairs
+  Int       m_iLumaTapFiltNo;                                         ///< filter shape of m_aiLumaTapPairs, -1: the coefficients do not fit in 16 bits, the C code filters
+  Bool      m_bChromaTapPairs;                                        ///< m_aiChromaTapPairs is set
+  static Void (*m_fpDiamondFilter)( const imgpel* pSrc, imgpel* pDst, Int iStride, Int iWidth, Int iHeight, const Int* piTapOffsets, Int iNumTaps,
+                                    const Int* piTapPairs, imgpel* const* ppVar, Int iVarX, const Int* piClassPairs, Int iMinVal, Int iMaxVal, Int iShift ); ///< SIMD diamond filter selected by initSimdKernels(), NULL: the C code filters
+#endif
+#if PARALLEL_ALF
+  Int       m_iNumThreads;                                            ///< number of threads filtering a picture (1: single-threaded)
+  std::vector<Int**> m_aiThreadGradients;                             ///< gradient buffers of the classification, 4 per thread, those of the calling thread are m_imgY_ver/hor/dig0/dig1
+#endif
   /// ALF for luma component
   Void xALFLuma_qc( TComPic* pcPic, ALFParam* pcAlfParam, TComPicYuv* pcPicDec, TComPicYuv* pcPicRest);
   
@@ -277,15 +302,32 @@ protected:
   Void get_mem2Dpel(imgpel ***array2D, int rows, int columns);
   Void no_mem_exit(const char *where);
   Void xError(const char *text, int code);
+#if PARALLEL_ALF
+  Void calcVar(imgpel **imgY_var, imgpel *imgY_pad, int pad_size, int fl, int img_height, int img_width, int img_stride, int start_width = 0 , int start_height = 0, Int iThread = 0 );
+  Void xCalcVar(imgpel **imgY_var, imgpel *imgY_pad, int pad_size, int fl, int img_height, int img_width, int img_stride, int start_width , int start_height, Int iThread );
+  Void xCalcVarPerPixel(imgpel **imgY_var, imgpel *imgY_pad, Int pad_size, Int fl, Int img_height, Int img_width, Int img_stride, Int start_width , Int start_height, Int iThread);
+#else
   Void calcVar(imgpel **imgY_var, imgpel *imgY_pad, int pad_size, int fl, int img_height, int img_width, int img_stride, int start_width = 0 , int start_height = 0 );
   Void xCalcVar(imgpel **imgY_var, imgpel *imgY_pad, int pad_size, int fl, int img_height, int img_width, int img_stride, int start_width , int start_height );
 #if JVET_C0038_GALF
   Void xCalcVarPerPixel(imgpel **imgY_var, imgpel *imgY_pad, Int pad_size, Int fl, Int img_height, Int img_width, Int img_stride, Int start_width , Int start_height);
 #endif
+#endif
+#if PARALLEL_ALF
+  Void xRunFilterJobs( Int iNumJobs, const std::function<Void( Int iJob, Int iThread )>& rcJob );
+#endif
+#if SIMD_AVX2_ALF
+  Bool xSetLumaTapPairs( Int** ppiCoeff, Int filtNo );
+  Int  xFilterBlockSIMD( imgpel *imgY_rec_post, imgpel *imgY_rec, imgpel **imgY_var, Int startHeight, Int endHeight, Int startWidth, Int endWidth, Int Stride, ComponentID compid );
+#endif
 
   Void DecFilter_qc(imgpel* imgY_rec,ALFParam* pcAlfParam, int Stride);
 #if JVET_C0024_QTBT
+#if PARALLEL_ALF
+  Void xSubCUAdaptive_qc(TComDataCU* pcCU, ALFParam* pcAlfParam, imgpel *imgY_rec_post, imgpel *imgY_rec, UInt uiAbsPartIdx, UInt uiDepth, UInt uiWidth, UInt uiHeight, Int Stride, Int iThread);
+#else
   Void xSubCUAdaptive_qc(TComDataCU* pcCU, ALFParam* pcAlfParam, imgpel *imgY_rec_post, imgpel *imgY_rec, UInt uiAbsPartIdx, UInt uiDepth, UInt uiWidth, UInt uiHeight, Int Stride);
+#endif
 #else
   Void xSubCUAdaptive_qc(TComDataCU* pcCU, ALFParam* pcAlfParam, imgpel *imgY_rec_post, imgpel *imgY_rec, UInt uiAbsPartIdx, UInt uiDepth, Int Stride);
 #endif
@@ -328,6 +370,9 @@ protected:
 public:
   TComAdaptiveLoopFilter();
   virtual ~TComAdaptiveLoopFilter() {}
+#if SIMD_AVX2_ALF
+  static Void initSimdKernels( SimdLevel eLevel );
+#endif
   
   // initialize & destory temporary buffer
   Void create  ( Int iPicWidth, Int iPicHeight, ChromaFormat chromaFormatIDC, Int uiMaxCUWidth, UInt uiMaxCUHeight, UInt uiMaxCUDepth , Int nInputBitDepth , Int nInternalBitDepth );
@@ -357,6 +402,9 @@ public:
 #endif
   // interface function
   Void ALFProcess             ( TComPic* pcPic, ALFParam* pcAlfParam); ///< interface function for ALF process
+#if PARALLEL_ALF
+  Void setNumThreads          ( Int iNumThreads )  { m_iNumThreads = std::max( iNumThreads, 1 ); }
+#endif
 
 #if FIX_TICKET12
   Bool refreshAlfTempPred( NalUnitType nalu , Int poc );
@@ -429,30 +429,17 @@ TComStats::TComStats()
 #if VCEG_AZ07_INIT_PREVFRAME
 #if VCEG_AZ07_INIT_PREVFRAME_FIX
     m_uiLastIPOC = 0;
+#if PARALLEL_SEGMENT_ENCODING
+    m_bClearPrevFlag = false;
+#endif
 #else
     m_uiLastIPOC = -1;
 #endif
-    for(Int i = 0; i < 2; i++)
-    {
-      for(Int j=0; j< NUM_QP_PROB; j++)  
-      {
-        if( ( m_uiCtxProbIdx[i][j] = (UShort**)calloc(uiNLCUH, sizeof(UShort*))) == NULL )
-        {
-          printf("get_mem2Dpel: array2D");
-          exit(-1);
-        }
-        if( (( m_uiCtxProbIdx[i][j])[0] = (UShort* )calloc( uiNLCUH*uiNLCUW, sizeof( UShort ))) == NULL )
-        {
-          printf("get_mem2Dpel: array2D");
-          exit(-1);
-        }
-
-        for(Int k=1 ; k<uiNLCUH ; k++)
-        {
-          m_uiCtxProbIdx[i][j][k] =  m_uiCtxProbIdx[i][j][k-1] + uiNLCUW;
-        }
-      }
-    }
+#if PARALLEL_PICTURE_ENCODING
+    m_uiNLCUW = uiNLCUW;
+    m_uiNLCUH = uiNLCUH;
+#endif
+    xCreateCtxProbIdx( uiNLCUW, uiNLCUH );
 #endif
 #if VCEG_AZ07_BAC_ADAPT_WDOW || VCEG_AZ05_MULTI_PARAM_CABAC
   for (int iQP=0;  iQP< NUM_QP_PROB; iQP++)
@@ -469,9 +456,96 @@ TComStats::TComStats()
 #endif
 }
 
+#if PARALLEL_PICTURE_ENCODING
+TComStats::TComStats(const TComStats& rcStats)
+{
+#if VCEG_AZ07_INIT_PREVFRAME
+  m_uiNLCUW = rcStats.m_uiNLCUW;
+  m_uiNLCUH = rcStats.m_uiNLCUH;
+  xCreateCtxProbIdx( m_uiNLCUW, m_uiNLCUH );
+#endif
+  xCopyStats( rcStats );
+}
+
+TComStats& TComStats::operator= (const TComStats& rcStats)
+{
+  if (this != &rcStats)
+  {
+#if VCEG_AZ07_INIT_PREVFRAME
+    if (m_uiNLCUW != rcStats.m_uiNLCUW || m_uiNLCUH != rcStats.m_uiNLCUH)
+    {
+      xDestroyCtxProbIdx();
+      m_uiNLCUW = rcStats.m_uiNLCUW;
+      m_uiNLCUH = rcStats.m_uiNLCUH;
+      xCreateCtxProbIdx( m_uiNLCUW, m_uiNLCUH );
+    }
+#endif
+    xCopyStats( rcStats );
+  }
+  return *this;
+}
+
+/** Copy the statistics into this object, whose probability arrays have the dimensions of the source.
+ */
+Void TComStats::xCopyStats( const TComStats& rcStats )
+{
+  ::memcpy( aaQPUsed, rcStats.aaQPUsed, sizeof(aaQPUsed) );
+#if VCEG_AZ07_BAC_ADAPT_WDOW || VCEG_AZ05_MULTI_PARAM_CABAC
+  ::memcpy( m_uiCtxMAP,     rcStats.m_uiCtxMAP,     sizeof(m_uiCtxMAP) );
+  ::memcpy( m_uiNumCtx,     rcStats.m_uiNumCtx,     sizeof(m_uiNumCtx) );
+  ::memcpy( m_uiCtxCodeIdx, rcStats.m_uiCtxCodeIdx, sizeof(m_uiCtxCodeIdx) );
+#endif
+#if VCEG_AZ07_INIT_PREVFRAME
+  m_uiLastIPOC = rcStats.m_uiLastIPOC;
+#if VCEG_AZ07_INIT_PREVFRAME_FIX && PARALLEL_SEGMENT_ENCODING
+  m_bClearPrevFlag = rcStats.m_bClearPrevFlag;
+#endif
+  for(Int i = 0; i < 2; i++)
+  {
+    for(Int j=0; j< NUM_QP_PROB; j++)
+    {
+      ::memcpy( m_uiCtxProbIdx[i][j][0], rcStats.m_uiCtxProbIdx[i][j][0], m_uiNLCUH*m_uiNLCUW*sizeof( UShort ) );
+    }
+  }
+#endif
+}
+#endif
+
 TComStats::~TComStats()
 {
 #if VCEG_AZ07_INIT_PREVFRAME
+  xDestroyCtxProbIdx();
+#endif
+}
+
+#if VCEG_AZ07_INIT_PREVFRAME
+Void TComStats::xCreateCtxProbIdx( UInt uiNLCUW, UInt uiNLCUH )
+{
+  for(Int i = 0; i < 2; i++)
+  {
+    for(Int j=0; j< NUM_QP_PROB; j++)  
+    {
+      if( ( m_uiCtxProbIdx[i][j] = (UShort**)calloc(uiNLCUH, sizeof(UShort*))) == NULL )
+      {
+        printf("get_mem2Dpel: array2D");
+        exit(-1);
+      }
+      if( (( m_uiCtxProbIdx[i][j])[0] = (UShort* )calloc( uiNLCUH*uiNLCUW, sizeof( UShort ))) == NULL )
+      {
+        printf("get_mem2Dpel: array2D");
+        exit(-1);
+      }
+
+      for(Int k=1 ; k<uiNLCUH ; k++)
+      {
+        m_uiCtxProbIdx[i][j][k] =  m_uiCtxProbIdx[i][j][k-1] + uiNLCUW;
+      }
+    }
+  }
+}
+
+Void TComStats::xDestroyCtxProbIdx()
+{
   for(Int i=0; i<2; i++)
   {
     for(Int j=0; j< NUM_QP_PROB; j++)
@@ -486,7 +560,7 @@ TComStats::~TComStats()
       }
     }
   }
-#endif
 }
 #endif
+#endif
 //! \}
@@ -67,6 +67,11 @@ public:
   TComStats(UInt uiNLCUW, UInt uiNLCUH);
 #else
   TComStats();
+#endif
+#if PARALLEL_PICTURE_ENCODING
+  /// snapshot of the statistics, read by a picture compressed on another thread while the original is updated in coding order
+  TComStats(const TComStats& rcStats);
+  TComStats& operator= (const TComStats& rcStats);
 #endif
   virtual ~TComStats();
  
@@ -81,6 +86,22 @@ public:
 #if VCEG_AZ07_INIT_PREVFRAME
   UShort** m_uiCtxProbIdx[2][NUM_QP_PROB]; //[B/PSlice][QPindex][NUM_LCU][MAX_NUM_CTX_MOD]
   UInt     m_uiLastIPOC;
+#if VCEG_AZ07_INIT_PREVFRAME_FIX && PARALLEL_SEGMENT_ENCODING
+  Bool     m_bClearPrevFlag;  ///< the stored probabilities have been cleared since the last intra picture
+#endif
+#if PARALLEL_PICTURE_ENCODING
+  UInt     m_uiNLCUW;         ///< dimensions of the m_uiCtxProbIdx arrays
+  UInt     m_uiNLCUH;
+#endif
+#endif
+
+private:
+#if VCEG_AZ07_INIT_PREVFRAME
+  Void xCreateCtxProbIdx  ( UInt uiNLCUW, UInt uiNLCUH );
+  Void xDestroyCtxProbIdx ();
+#endif
+#if PARALLEL_PICTURE_ENCODING
+  Void xCopyStats         ( const TComStats& rcStats );
 #endif
 };
 #endif
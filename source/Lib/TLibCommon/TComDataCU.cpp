@@ -1748,7 +1748,7 @@ Void TComDataCU::copySubCU( TComDataCU* pcCU, UInt uiAbsPartIdx )
   }
 
 #if JVET_C0024_QTBT 
-  UInt uiCoffOffset = pcCU->getPic()->getCodedAreaInCTU();
+  UInt uiCoffOffset = pcCU->getPic()->getCodedAreaInCTU(pcCU->getCtuRsAddr());
 #else
   UInt uiMaxCuWidth=pcCU->getSlice()->getSPS()->getMaxCUWidth();
   UInt uiMaxCuHeight=pcCU->getSlice()->getSPS()->getMaxCUHeight();
@@ -2470,7 +2470,7 @@ Void TComDataCU::copyToPic( UChar uhDepth )
     }
 
     const UInt numCoeffY    = uiWidth * uiHeight;
-    const UInt offsetY      = m_pcPic->getCodedAreaInCTU();
+    const UInt offsetY      = m_pcPic->getCodedAreaInCTU(getCtuRsAddr());
     for (UInt comp=0; comp<numValidComp; comp++)
     {
       const ComponentID component = ComponentID(comp);
@@ -2522,7 +2522,7 @@ Void TComDataCU::copyToPic( UChar uhDepth )
     }
 
     const UInt numCoeffY    = uiWidth * uiHeight;
-    const UInt offsetY      = m_pcPic->getCodedAreaInCTU();
+    const UInt offsetY      = m_pcPic->getCodedAreaInCTU(getCtuRsAddr());
     for (UInt comp=1; comp<numValidComp; comp++)
     {
       const ComponentID component = ComponentID(comp);
@@ -2800,7 +2800,7 @@ TComDataCU* TComDataCU::getPUBelowLeft(UInt& uiBLPartUnitIdx,  UInt uiCurrPartUn
 #if JVET_C0024_QTBT
       UInt uiBlkX = g_auiRasterToPelX[ uiAbsPartIdxLB + uiPartUnitOffset*numPartInCtuWidth - 1 ] >>MIN_CU_LOG2;
       UInt uiBlkY = g_auiRasterToPelY[ uiAbsPartIdxLB + uiPartUnitOffset*numPartInCtuWidth - 1 ] >>MIN_CU_LOG2;
-      if (getPic()->getCodedBlkInCTU(uiBlkX, uiBlkY))
+      if (getPic()->getCodedBlkInCTU(getCtuRsAddr(), uiBlkX, uiBlkY))
 #else
       if ( uiCurrPartUnitIdx > g_auiRasterToZscan[ uiAbsPartIdxLB + uiPartUnitOffset * numPartInCtuWidth - 1 ] )
 #endif
@@ -2858,7 +2858,7 @@ TComDataCU* TComDataCU::getPUAboveRight(UInt&  uiARPartUnitIdx, UInt uiCurrPartU
 #if JVET_C0024_QTBT
       UInt uiBlkX = g_auiRasterToPelX[ uiAbsPartIdxRT - numPartInCtuWidth + uiPartUnitOffset ] >>MIN_CU_LOG2;
       UInt uiBlkY = g_auiRasterToPelY[ uiAbsPartIdxRT - numPartInCtuWidth + uiPartUnitOffset ] >>MIN_CU_LOG2;
-      if (getPic()->getCodedBlkInCTU(uiBlkX, uiBlkY) )
+      if (getPic()->getCodedBlkInCTU(getCtuRsAddr(), uiBlkX, uiBlkY) )
 #else
       if ( uiCurrPartUnitIdx > g_auiRasterToZscan[ uiAbsPartIdxRT - numPartInCtuWidth + uiPartUnitOffset ] )
 #endif
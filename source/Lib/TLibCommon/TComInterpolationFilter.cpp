@@ -43,12 +43,22 @@
 #include "TComRom.h"
 #include "TComInterpolationFilter.h"
 #include <assert.h>
+#include <string.h>
 
 #include "TComChromaFormat.h"
 
 #if COM16_C806_SIMD_OPT
 #include <emmintrin.h>  
 #endif
+#if SIMD_AVX2_INTERPOLATION && SIMD_AVX_TARGETS
+#define AVX_INTERPOLATION_KERNELS                         1
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"   // _mm512_undefined_epi32() in the AVX-512 intrinsics
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#else
+#define AVX_INTERPOLATION_KERNELS                         0
+#endif
 
 
 //! \ingroup TLibCommon
@@ -553,6 +563,291 @@ inline __m128i simdClip3( __m128i mmMin , __m128i mmMax , __m128i mmPix )
   mmPix = _mm_or_si128( _mm_and_si128( mmMask , mmPix ) , _mm_andnot_si128( mmMask , mmMax ) );
   return( mmPix );
 }
+
+/**
+ * \brief Filter a block with 8-10 bit samples and 2, 4 or 8 taps with SSE2, in columns of 8 or 4
+ *
+ * \returns false if the bit depth, the tap count or the width is not supported, in which case the caller filters the block itself
+ */
+template<Int N, Bool isLast>
+static Bool simdFilterSSE2( Int bitDepth , Pel const *src , Int srcStride , Int cStride , Pel *dst , Int dstStride , Int width , Int height , Pel const *c , Int offset , Int shift , Pel minVal , Pel maxVal )
+{
+  if( bitDepth > 10 )
+  {
+    return false;
+  }
+  const Bool bWidth8 = !( width & 0x07 ) && N != 4;
+  if( N == 6 || ( !bWidth8 && ( width & 0x03 ) ) )
+  {
+    return false;
+  }
+
+  __m128i mmOffset = _mm_set1_epi32( offset );
+  __m128i mmCoeff[8];
+  __m128i mmMin = _mm_set1_epi16( minVal );
+  __m128i mmMax = _mm_set1_epi16( maxVal );
+  for( Int n = 0 ; n < N ; n++ )
+    mmCoeff[n] = _mm_set1_epi16( c[n] );
+  for( Int row = 0 ; row < height ; row++ )
+  {
+    if( bWidth8 )
+    {
+      for( Int col = 0 ; col < width ; col += 8 )
+      {
+        __m128i mmFiltered = N == 8 ? simdInterpolateLuma8( src + col , cStride , mmCoeff , mmOffset , shift ) : simdInterpolateLuma2P8( src + col , cStride , mmCoeff , mmOffset , shift );
+        if( isLast )
+        {
+          mmFiltered = simdClip3( mmMin , mmMax , mmFiltered );
+        }
+        _mm_storeu_si128( ( __m128i * )( dst + col ) , mmFiltered );
+      }
+    }
+    else
+    {
+      for( Int col = 0 ; col < width ; col += 4 )
+      {
+        __m128i mmFiltered = N == 8 ? simdInterpolateLuma4( src + col , cStride , mmCoeff , mmOffset , shift )
+                           : N == 4 ? simdInterpolateChroma4( src + col , cStride , mmCoeff , mmOffset , shift ) : simdInterpolateLuma2P4( src + col , cStride , mmCoeff , mmOffset , shift );
+        if( isLast )
+        {
+          mmFiltered = simdClip3( mmMin , mmMax , mmFiltered );
+        }
+        _mm_storel_epi64( ( __m128i * )( dst + col ) , mmFiltered );
+      }
+    }
+    src += srcStride;
+    dst += dstStride;
+  }
+  return true;
+}
+#endif
+
+#if AVX_INTERPOLATION_KERNELS
+/**
+ * \brief Filter a block with 32-bit sums truncated to Pel, as the C code does
+ *
+ * Taps are applied in pairs with madd on interleaved sample rows, so any
+ * even tap count and any 16-bit coefficients are exact. Columns are done
+ * 16, 8 and 4 at a time and the remaining ones in C.
+ */
+template<Int N, Bool isLast>
+__attribute__((target("avx2")))
+static Void simdFilterAVX2( Pel const *src , Int srcStride , Int cStride , Pel *dst , Int dstStride , Int width , Int height , Pel const *c , Int offset , Int shift , Pel minVal , Pel maxVal )
+{
+  __m256i mmCoeff[N/2];
+  for( Int n = 0 ; n < N/2 ; n++ )
+  {
+    mmCoeff[n] = _mm256_set1_epi32( ( Int )( ( UInt )( UShort )c[2*n] | ( ( UInt )( UShort )c[2*n+1] << 16 ) ) );
+  }
+  const __m256i mmOffset = _mm256_set1_epi32( offset );
+  const __m256i mmMin    = _mm256_set1_epi16( minVal );
+  const __m256i mmMax    = _mm256_set1_epi16( maxVal );
+
+  for( Int row = 0 ; row < height ; row++ )
+  {
+    Int col = 0;
+    for( ; col + 16 <= width ; col += 16 )
+    {
+      __m256i sumLo = _mm256_setzero_si256();
+      __m256i sumHi = _mm256_setzero_si256();
+      for( Int n = 0 ; n < N/2 ; n++ )
+      {
+        __m256i mmPix0 = _mm256_loadu_si256( ( __m256i* )( src + col + 2 * n * cStride ) );
+        __m256i mmPix1 = _mm256_loadu_si256( ( __m256i* )( src + col + ( 2 * n + 1 ) * cStride ) );
+        sumLo = _mm256_add_epi32( sumLo , _mm256_madd_epi16( _mm256_unpacklo_epi16( mmPix0 , mmPix1 ) , mmCoeff[n] ) );
+        sumHi = _mm256_add_epi32( sumHi , _mm256_madd_epi16( _mm256_unpackhi_epi16( mmPix0 , mmPix1 ) , mmCoeff[n] ) );
+      }
+      sumLo = _mm256_srai_epi32( _mm256_slli_epi32( _mm256_srai_epi32( _mm256_add_epi32( sumLo , mmOffset ) , shift ) , 16 ) , 16 );
+      sumHi = _mm256_srai_epi32( _mm256_slli_epi32( _mm256_srai_epi32( _mm256_add_epi32( sumHi , mmOffset ) , shift ) , 16 ) , 16 );
+      __m256i mmFiltered = _mm256_packs_epi32( sumLo , sumHi );
+      if( isLast )
+      {
+        mmFiltered = _mm256_min_epi16( _mm256_max_epi16( mmFiltered , mmMin ) , mmMax );
+      }
+      _mm256_storeu_si256( ( __m256i* )( dst + col ) , mmFiltered );
+    }
+    for( ; col + 4 <= width ; col += ( col + 8 <= width ) ? 8 : 4 )
+    {
+      const Bool b8 = col + 8 <= width;
+      __m128i sumLo = _mm_setzero_si128();
+      __m128i sumHi = _mm_setzero_si128();
+      for( Int n = 0 ; n < N/2 ; n++ )
+      {
+        __m128i mmPix0 = b8 ? _mm_loadu_si128( ( __m128i* )( src + col + 2 * n * cStride ) ) : _mm_loadl_epi64( ( __m128i* )( src + col + 2 * n * cStride ) );
+        __m128i mmPix1 = b8 ? _mm_loadu_si128( ( __m128i* )( src + col + ( 2 * n + 1 ) * cStride ) ) : _mm_loadl_epi64( ( __m128i* )( src + col + ( 2 * n + 1 ) * cStride ) );
+        sumLo = _mm_add_epi32( sumLo , _mm_madd_epi16( _mm_unpacklo_epi16( mmPix0 , mmPix1 ) , _mm256_castsi256_si128( mmCoeff[n] ) ) );
+        sumHi = _mm_add_epi32( sumHi , _mm_madd_epi16( _mm_unpackhi_epi16( mmPix0 , mmPix1 ) , _mm256_castsi256_si128( mmCoeff[n] ) ) );
+      }
+      sumLo = _mm_srai_epi32( _mm_slli_epi32( _mm_srai_epi32( _mm_add_epi32( sumLo , _mm256_castsi256_si128( mmOffset ) ) , shift ) , 16 ) , 16 );
+      sumHi = _mm_srai_epi32( _mm_slli_epi32( _mm_srai_epi32( _mm_add_epi32( sumHi , _mm256_castsi256_si128( mmOffset ) ) , shift ) , 16 ) , 16 );
+      __m128i mmFiltered = _mm_packs_epi32( sumLo , sumHi );
+      if( isLast )
+      {
+        mmFiltered = _mm_min_epi16( _mm_max_epi16( mmFiltered , _mm256_castsi256_si128( mmMin ) ) , _mm256_castsi256_si128( mmMax ) );
+      }
+      if( b8 )
+      {
+        _mm_storeu_si128( ( __m128i* )( dst + col ) , mmFiltered );
+      }
+      else
+      {
+        _mm_storel_epi64( ( __m128i* )( dst + col ) , mmFiltered );
+      }
+    }
+    for( ; col < width ; col++ )
+    {
+      Int sum = 0;
+      for( Int n = 0 ; n < N ; n++ )
+      {
+        sum += src[col + n * cStride] * c[n];
+      }
+      Pel val = ( sum + offset ) >> shift;
+      if( isLast )
+      {
+        val = val < minVal ? minVal : ( val > maxVal ? maxVal : val );
+      }
+      dst[col] = val;
+    }
+    src += srcStride;
+    dst += dstStride;
+  }
+}
+
+/**
+ * \brief AVX-512 version of simdFilterAVX2() for 32 columns at a time, the remaining columns are left to simdFilterAVX2()
+ */
+template<Int N, Bool isLast>
+__attribute__((target("avx512f,avx512bw")))
+static Void simdFilterAVX512( Pel const *src , Int srcStride , Int cStride , Pel *dst , Int dstStride , Int width , Int height , Pel const *c , Int offset , Int shift , Pel minVal , Pel maxVal )
+{
+  const Int width32 = width & ~31;
+  if( width32 )
+  {
+    __m512i mmCoeff[N/2];
+    for( Int n = 0 ; n < N/2 ; n++ )
+    {
+      mmCoeff[n] = _mm512_set1_epi32( ( Int )( ( UInt )( UShort )c[2*n] | ( ( UInt )( UShort )c[2*n+1] << 16 ) ) );
+    }
+    const __m512i mmOffset = _mm512_set1_epi32( offset );
+    const __m512i mmMin    = _mm512_set1_epi16( minVal );
+    const __m512i mmMax    = _mm512_set1_epi16( maxVal );
+    const __m128i mmShift  = _mm_cvtsi32_si128( shift );
+
+    Pel const *srcRow = src;
+    Pel       *dstRow = dst;
+    for( Int row = 0 ; row < height ; row++ )
+    {
+      for( Int col = 0 ; col < width32 ; col += 32 )
+      {
+        __m512i sumLo = _mm512_setzero_si512();
+        __m512i sumHi = _mm512_setzero_si512();
+        for( Int n = 0 ; n < N/2 ; n++ )
+        {
+          __m512i mmPix0 = _mm512_loadu_si512( srcRow + col + 2 * n * cStride );
+          __m512i mmPix1 = _mm512_loadu_si512( srcRow + col + ( 2 * n + 1 ) * cStride );
+          sumLo = _mm512_add_epi32( sumLo , _mm512_madd_epi16( _mm512_unpacklo_epi16( mmPix0 , mmPix1 ) , mmCoeff[n] ) );
+          sumHi = _mm512_add_epi32( sumHi , _mm512_madd_epi16( _mm512_unpackhi_epi16( mmPix0 , mmPix1 ) , mmCoeff[n] ) );
+        }
+        sumLo = _mm512_srai_epi32( _mm512_slli_epi32( _mm512_sra_epi32( _mm512_add_epi32( sumLo , mmOffset ) , mmShift ) , 16 ) , 16 );
+        sumHi = _mm512_srai_epi32( _mm512_slli_epi32( _mm512_sra_epi32( _mm512_add_epi32( sumHi , mmOffset ) , mmShift ) , 16 ) , 16 );
+        __m512i mmFiltered = _mm512_packs_epi32( sumLo , sumHi );
+        if( isLast )
+        {
+          mmFiltered = _mm512_min_epi16( _mm512_max_epi16( mmFiltered , mmMin ) , mmMax );
+        }
+        _mm512_storeu_si512( dstRow + col , mmFiltered );
+      }
+      srcRow += srcStride;
+      dstRow += dstStride;
+    }
+  }
+  if( width32 < width )
+  {
+    simdFilterAVX2<N, isLast>( src + width32 , srcStride , cStride , dst + width32 , dstStride , width - width32 , height , c , offset , shift , minVal , maxVal );
+  }
+}
+
+/**
+ * \brief Filter a block with 8-12 bit samples with the AVX kernel of a SIMD level
+ *
+ * \returns false if the bit depth is out of range, in which case the caller filters the block itself
+ */
+template<Int N, Bool isLast, SimdLevel eLevel>
+static Bool simdFilterAVX( Int bitDepth , Pel const *src , Int srcStride , Int cStride , Pel *dst , Int dstStride , Int width , Int height , Pel const *c , Int offset , Int shift , Pel minVal , Pel maxVal )
+{
+  if( bitDepth > 12 )
+  {
+    return false;
+  }
+  if( eLevel >= SIMD_AVX512 )
+  {
+    simdFilterAVX512<N, isLast>( src , srcStride , cStride , dst , dstStride , width , height , c , offset , shift , minVal , maxVal );
+  }
+  else
+  {
+    simdFilterAVX2<N, isLast>( src , srcStride , cStride , dst , dstStride , width , height , c , offset , shift , minVal , maxVal );
+  }
+  return true;
+}
+#endif
+
+#if COM16_C806_SIMD_OPT
+#if SIMD_RUNTIME_DISPATCH
+TComInterpolationFilter::FilterKernel* TComInterpolationFilter::m_afpFilterKernel[4][2] = { { NULL } };
+#else
+TComInterpolationFilter::FilterKernel* TComInterpolationFilter::m_afpFilterKernel[4][2] =
+{
+  { simdFilterSSE2<2, false> , simdFilterSSE2<2, true> },
+  { simdFilterSSE2<4, false> , simdFilterSSE2<4, true> },
+  { NULL                     , NULL                    },
+  { simdFilterSSE2<8, false> , simdFilterSSE2<8, true> },
+};
+#endif
+#endif
+
+#if SIMD_RUNTIME_DISPATCH
+/**
+ * \brief Select the filter kernels of a SIMD level for all the tap counts, called once at start-up by initSimdLevel()
+ */
+Void TComInterpolationFilter::initSimdKernels( SimdLevel eLevel )
+{
+  static FilterKernel* const aafpSSE2[4][2] =
+  {
+    { simdFilterSSE2<2, false> , simdFilterSSE2<2, true> },
+    { simdFilterSSE2<4, false> , simdFilterSSE2<4, true> },
+    { NULL                     , NULL                    },
+    { simdFilterSSE2<8, false> , simdFilterSSE2<8, true> },
+  };
+#if AVX_INTERPOLATION_KERNELS
+  static FilterKernel* const aafpAVX2[4][2] =
+  {
+    { simdFilterAVX<2, false, SIMD_AVX2> , simdFilterAVX<2, true, SIMD_AVX2> },
+    { simdFilterAVX<4, false, SIMD_AVX2> , simdFilterAVX<4, true, SIMD_AVX2> },
+    { simdFilterAVX<6, false, SIMD_AVX2> , simdFilterAVX<6, true, SIMD_AVX2> },
+    { simdFilterAVX<8, false, SIMD_AVX2> , simdFilterAVX<8, true, SIMD_AVX2> },
+  };
+  static FilterKernel* const aafpAVX512[4][2] =
+  {
+    { simdFilterAVX<2, false, SIMD_AVX512> , simdFilterAVX<2, true, SIMD_AVX512> },
+    { simdFilterAVX<4, false, SIMD_AVX512> , simdFilterAVX<4, true, SIMD_AVX512> },
+    { simdFilterAVX<6, false, SIMD_AVX512> , simdFilterAVX<6, true, SIMD_AVX512> },
+    { simdFilterAVX<8, false, SIMD_AVX512> , simdFilterAVX<8, true, SIMD_AVX512> },
+  };
+  if( eLevel >= SIMD_AVX2 )
+  {
+    ::memcpy( m_afpFilterKernel , eLevel >= SIMD_AVX512 ? aafpAVX512 : aafpAVX2 , sizeof( m_afpFilterKernel ) );
+    return;
+  }
+#endif
+  if( eLevel >= SIMD_SSE2 )
+  {
+    ::memcpy( m_afpFilterKernel , aafpSSE2 , sizeof( m_afpFilterKernel ) );
+  }
+  else
+  {
+    ::memset( m_afpFilterKernel , 0 , sizeof( m_afpFilterKernel ) );
+  }
+}
 #endif
 
 // ====================================================================================================================
@@ -723,143 +1018,13 @@ Void TComInterpolationFilter::filter(Int bitDepth, Pel const *src, Int srcStride
   }
 
 #if COM16_C806_SIMD_OPT
-  if( bitDepth <= 10 )
-  {
-    if( N == 8 && !( width & 0x07 ) )
-    {
 #if !JVET_D0033_ADAPTIVE_CLIPPING
-      Short minVal = 0;
-#endif
-      __m128i mmOffset = _mm_set1_epi32( offset );
-      __m128i mmCoeff[8];
-      __m128i mmMin = _mm_set1_epi16( minVal );
-      __m128i mmMax = _mm_set1_epi16( maxVal );
-      for( Int n = 0 ; n < 8 ; n++ )
-        mmCoeff[n] = _mm_set1_epi16( c[n] );
-      for( row = 0 ; row < height ; row++ )
-      {
-        for( col = 0 ; col < width ; col += 8 )
-        {
-          __m128i mmFiltered = simdInterpolateLuma8( src + col , cStride , mmCoeff , mmOffset , shift );
-          if( isLast )
-          {
-            mmFiltered = simdClip3( mmMin , mmMax , mmFiltered );
-          }
-          _mm_storeu_si128( ( __m128i * )( dst + col ) , mmFiltered );
-        }
-        src += srcStride;
-        dst += dstStride;
-      }
-      return;
-    }
-    else if( N == 8 && !( width & 0x03 ) )
-    {
-#if !JVET_D0033_ADAPTIVE_CLIPPING
-      Short minVal = 0;
-#endif
-      __m128i mmOffset = _mm_set1_epi32( offset );
-      __m128i mmCoeff[8];
-      __m128i mmMin = _mm_set1_epi16( minVal );
-      __m128i mmMax = _mm_set1_epi16( maxVal );
-      for( Int n = 0 ; n < 8 ; n++ )
-        mmCoeff[n] = _mm_set1_epi16( c[n] );
-      for( row = 0 ; row < height ; row++ )
-      {
-        for( col = 0 ; col < width ; col += 4 )
-        {
-          __m128i mmFiltered = simdInterpolateLuma4( src + col , cStride , mmCoeff , mmOffset , shift );
-          if( isLast )
-          {
-            mmFiltered = simdClip3( mmMin , mmMax , mmFiltered );
-          }
-          _mm_storel_epi64( ( __m128i * )( dst + col ) , mmFiltered );
-        }
-        src += srcStride;
-        dst += dstStride;
-      }
-      return;
-    }
-    else if( N == 4 && !( width & 0x03 ) )
-    {
-#if !JVET_D0033_ADAPTIVE_CLIPPING
-      Short minVal = 0;
-#endif
-      __m128i mmOffset = _mm_set1_epi32( offset );
-      __m128i mmCoeff[8];
-      __m128i mmMin = _mm_set1_epi16( minVal );
-      __m128i mmMax = _mm_set1_epi16( maxVal );
-      for( Int n = 0 ; n < 4 ; n++ )
-        mmCoeff[n] = _mm_set1_epi16( c[n] );
-      for( row = 0 ; row < height ; row++ )
-      {
-        for( col = 0 ; col < width ; col += 4 )
-        {
-          __m128i mmFiltered = simdInterpolateChroma4( src + col , cStride , mmCoeff , mmOffset , shift );
-          if( isLast )
-          {
-            mmFiltered = simdClip3( mmMin , mmMax , mmFiltered );
-          }
-          _mm_storel_epi64( ( __m128i * )( dst + col ) , mmFiltered );
-        }
-        src += srcStride;
-        dst += dstStride;
-      }
-      return;
-    }
-    else if( N == 2 && !( width & 0x07 ) )
-    {
-#if !JVET_D0033_ADAPTIVE_CLIPPING
-      Short minVal = 0;
-#endif
-      __m128i mmOffset = _mm_set1_epi32( offset );
-      __m128i mmCoeff[2];
-      __m128i mmMin = _mm_set1_epi16( minVal );
-      __m128i mmMax = _mm_set1_epi16( maxVal );
-      for( Int n = 0 ; n < 2 ; n++ )
-        mmCoeff[n] = _mm_set1_epi16( c[n] );
-      for( row = 0 ; row < height ; row++ )
-      {
-        for( col = 0 ; col < width ; col += 8 )
-        {
-          __m128i mmFiltered = simdInterpolateLuma2P8( src + col , cStride , mmCoeff , mmOffset , shift );
-          if( isLast )
-          {
-            mmFiltered = simdClip3( mmMin , mmMax , mmFiltered );
-          }
-          _mm_storeu_si128( ( __m128i * )( dst + col ) , mmFiltered );
-        }
-        src += srcStride;
-        dst += dstStride;
-      }
-      return;
-    }
-    else if( N == 2 && !( width & 0x03 ) )
-    {
-#if !JVET_D0033_ADAPTIVE_CLIPPING
-      Short minVal = 0;
-#endif
-      __m128i mmOffset = _mm_set1_epi32( offset );
-      __m128i mmCoeff[8];
-      __m128i mmMin = _mm_set1_epi16( minVal );
-      __m128i mmMax = _mm_set1_epi16( maxVal );
-      for( Int n = 0 ; n < 2 ; n++ )
-        mmCoeff[n] = _mm_set1_epi16( c[n] );
-      for( row = 0 ; row < height ; row++ )
-      {
-        for( col = 0 ; col < width ; col += 4 )
-        {
-          __m128i mmFiltered = simdInterpolateLuma2P4( src + col , cStride , mmCoeff , mmOffset , shift );
-          if( isLast )
-          {
-            mmFiltered = simdClip3( mmMin , mmMax , mmFiltered );
-          }
-          _mm_storel_epi64( ( __m128i * )( dst + col ) , mmFiltered );
-        }
-        src += srcStride;
-        dst += dstStride;
-      }
-      return;
-    }
+  const Pel minVal = 0;
+#endif
+  FilterKernel* fpKernel = m_afpFilterKernel[N/2-1][isLast];
+  if( fpKernel && fpKernel( bitDepth , src , srcStride , cStride , dst , dstStride , width , height , c , offset , shift , minVal , maxVal ) )
+  {
+    return;
   }
 #endif
 
@@ -1084,143 +1249,13 @@ Void TComInterpolationFilter::filterAffine(Int bitDepth, Pel const *src, Int src
   }
 
 #if COM16_C806_SIMD_OPT
-  if( bitDepth <= 10 )
-  {
-    if( N == 8 && !( width & 0x07 ) )
-    {
-#if !JVET_D0033_ADAPTIVE_CLIPPING
-      Short minVal = 0;
-#endif
-      __m128i mmOffset = _mm_set1_epi32( offset );
-      __m128i mmCoeff[8];
-      __m128i mmMin = _mm_set1_epi16( minVal );
-      __m128i mmMax = _mm_set1_epi16( maxVal );
-      for( Int n = 0 ; n < 8 ; n++ )
-        mmCoeff[n] = _mm_set1_epi16( c[n] );
-      for( row = 0 ; row < height ; row++ )
-      {
-        for( col = 0 ; col < width ; col += 8 )
-        {
-          __m128i mmFiltered = simdInterpolateLuma8( src + col , cStride , mmCoeff , mmOffset , shift );
-          if( isLast )
-          {
-            mmFiltered = simdClip3( mmMin , mmMax , mmFiltered );
-          }
-          _mm_storeu_si128( ( __m128i * )( dst + col ) , mmFiltered );
-        }
-        src += srcStride;
-        dst += dstStride;
-      }
-      return;
-    }
-    else if( N == 8 && !( width & 0x03 ) )
-    {
 #if !JVET_D0033_ADAPTIVE_CLIPPING
-      Short minVal = 0;
-#endif
-      __m128i mmOffset = _mm_set1_epi32( offset );
-      __m128i mmCoeff[8];
-      __m128i mmMin = _mm_set1_epi16( minVal );
-      __m128i mmMax = _mm_set1_epi16( maxVal );
-      for( Int n = 0 ; n < 8 ; n++ )
-        mmCoeff[n] = _mm_set1_epi16( c[n] );
-      for( row = 0 ; row < height ; row++ )
-      {
-        for( col = 0 ; col < width ; col += 4 )
-        {
-          __m128i mmFiltered = simdInterpolateLuma4( src + col , cStride , mmCoeff , mmOffset , shift );
-          if( isLast )
-          {
-            mmFiltered = simdClip3( mmMin , mmMax , mmFiltered );
-          }
-          _mm_storel_epi64( ( __m128i * )( dst + col ) , mmFiltered );
-        }
-        src += srcStride;
-        dst += dstStride;
-      }
-      return;
-    }
-    else if( N == 4 && !( width & 0x03 ) )
-    {
-#if !JVET_D0033_ADAPTIVE_CLIPPING
-      Short minVal = 0;
-#endif
-      __m128i mmOffset = _mm_set1_epi32( offset );
-      __m128i mmCoeff[8];
-      __m128i mmMin = _mm_set1_epi16( minVal );
-      __m128i mmMax = _mm_set1_epi16( maxVal );
-      for( Int n = 0 ; n < 4 ; n++ )
-        mmCoeff[n] = _mm_set1_epi16( c[n] );
-      for( row = 0 ; row < height ; row++ )
-      {
-        for( col = 0 ; col < width ; col += 4 )
-        {
-          __m128i mmFiltered = simdInterpolateChroma4( src + col , cStride , mmCoeff , mmOffset , shift );
-          if( isLast )
-          {
-            mmFiltered = simdClip3( mmMin , mmMax , mmFiltered );
-          }
-          _mm_storel_epi64( ( __m128i * )( dst + col ) , mmFiltered );
-        }
-        src += srcStride;
-        dst += dstStride;
-      }
-      return;
-    }
-    else if( N == 2 && !( width & 0x07 ) )
-    {
-#if !JVET_D0033_ADAPTIVE_CLIPPING
-      Short minVal = 0;
-#endif
-      __m128i mmOffset = _mm_set1_epi32( offset );
-      __m128i mmCoeff[2];
-      __m128i mmMin = _mm_set1_epi16( minVal );
-      __m128i mmMax = _mm_set1_epi16( maxVal );
-      for( Int n = 0 ; n < 2 ; n++ )
-        mmCoeff[n] = _mm_set1_epi16( c[n] );
-      for( row = 0 ; row < height ; row++ )
-      {
-        for( col = 0 ; col < width ; col += 8 )
-        {
-          __m128i mmFiltered = simdInterpolateLuma2P8( src + col , cStride , mmCoeff , mmOffset , shift );
-          if( isLast )
-          {
-            mmFiltered = simdClip3( mmMin , mmMax , mmFiltered );
-          }
-          _mm_storeu_si128( ( __m128i * )( dst + col ) , mmFiltered );
-        }
-        src += srcStride;
-        dst += dstStride;
-      }
-      return;
-    }
-    else if( N == 2 && !( width & 0x03 ) )
-    {
-#if !JVET_D0033_ADAPTIVE_CLIPPING
-      Short minVal = 0;
-#endif
-      __m128i mmOffset = _mm_set1_epi32( offset );
-      __m128i mmCoeff[8];
-      __m128i mmMin = _mm_set1_epi16( minVal );
-      __m128i mmMax = _mm_set1_epi16( maxVal );
-      for( Int n = 0 ; n < 2 ; n++ )
-        mmCoeff[n] = _mm_set1_epi16( c[n] );
-      for( row = 0 ; row < height ; row++ )
-      {
-        for( col = 0 ; col < width ; col += 4 )
-        {
-          __m128i mmFiltered = simdInterpolateLuma2P4( src + col , cStride , mmCoeff , mmOffset , shift );
-          if( isLast )
-          {
-            mmFiltered = simdClip3( mmMin , mmMax , mmFiltered );
-          }
-          _mm_storel_epi64( ( __m128i * )( dst + col ) , mmFiltered );
-        }
-        src += srcStride;
-        dst += dstStride;
-      }
-      return;
-    }
+  const Pel minVal = 0;
+#endif
+  FilterKernel* fpKernel = m_afpFilterKernel[N/2-1][isLast];
+  if( fpKernel && fpKernel( bitDepth , src , srcStride , cStride , dst , dstStride , width , height , c , offset , shift , minVal , maxVal ) )
+  {
+    return;
   }
 #endif
 
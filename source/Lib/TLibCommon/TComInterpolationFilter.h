@@ -97,6 +97,11 @@ class TComInterpolationFilter
 #endif
 #endif
 
+#if COM16_C806_SIMD_OPT
+  typedef Bool FilterKernel( Int bitDepth, Pel const *src, Int srcStride, Int cStride, Pel *dst, Int dstStride, Int width, Int height, Pel const *c, Int offset, Int shift, Pel minVal, Pel maxVal );
+  static FilterKernel* m_afpFilterKernel[4][2]; ///< [N/2-1][isLast], SIMD kernel selected by initSimdKernels(), NULL: the C code filters
+#endif
+
 #if JVET_D0033_ADAPTIVE_CLIPPING
   static Void filterCopy(Int bitDepth, const Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast, ComponentID compID);
   template<Int N, Bool isVertical, Bool isFirst, Bool isLast>
@@ -145,6 +150,9 @@ class TComInterpolationFilter
 public:
   TComInterpolationFilter() {}
   ~TComInterpolationFilter() {}
+#if SIMD_RUNTIME_DISPATCH
+  static Void initSimdKernels( SimdLevel eLevel );
+#endif
 
   Void filterHor(const ComponentID compID, Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Int frac,               Bool isLast, const ChromaFormat fmt, const Int bitDepth 
 #if VCEG_AZ07_FRUC_MERGE
@@ -37,10 +37,21 @@
 
 #include "TComPic.h"
 #include "SEI.h"
+#if KLT_ON_DEMAND_SUBPEL_PLANES
+#include "TComInterpolationFilter.h"
+#endif
 
 //! \ingroup TLibCommon
 //! \{
 
+#if JVET_C0024_QTBT && PARALLEL_SUBSTREAM_ENCODING
+thread_local TComMv TComPic::m_cIntMv[1<<((MAX_CU_DEPTH-MIN_CU_LOG2)<<1)][MAX_CU_DEPTH-MIN_CU_LOG2+1][MAX_CU_DEPTH-MIN_CU_LOG2+1][2][5];
+thread_local Bool   TComPic::m_bSetIntMv[1<<((MAX_CU_DEPTH-MIN_CU_LOG2)<<1)][MAX_CU_DEPTH-MIN_CU_LOG2+1][MAX_CU_DEPTH-MIN_CU_LOG2+1][2][5];
+thread_local Bool   TComPic::m_bSkiped[1<<((MAX_CU_DEPTH-MIN_CU_LOG2)<<1)][MAX_CU_DEPTH-MIN_CU_LOG2+1][MAX_CU_DEPTH-MIN_CU_LOG2+1];
+thread_local Bool   TComPic::m_bInter[1<<((MAX_CU_DEPTH-MIN_CU_LOG2)<<1)][MAX_CU_DEPTH-MIN_CU_LOG2+1][MAX_CU_DEPTH-MIN_CU_LOG2+1];
+thread_local Bool   TComPic::m_bIntra[1<<((MAX_CU_DEPTH-MIN_CU_LOG2)<<1)][MAX_CU_DEPTH-MIN_CU_LOG2+1][MAX_CU_DEPTH-MIN_CU_LOG2+1];
+#endif
+
 // ====================================================================================================================
 // Constructor / destructor / create / destroy
 // ====================================================================================================================
@@ -55,6 +66,20 @@ TComPic::TComPic()
 , m_bNeededForOutput                      (false)
 , m_uiCurrSliceIdx                        (0)
 , m_bCheckLTMSB                           (false)
+#if PARALLEL_FRAME_DECODING
+, m_bLoopFilterPending                    (false)
+#endif
+#if JVET_C0024_QTBT
+, m_uiCodedBlkStride                      (0)
+, m_pbCodedBlkInCTU                       (NULL)
+, m_piCodedArea                           (NULL)
+#endif
+#if KLT_ON_DEMAND_SUBPEL_PLANES
+, m_iNumQuaTilesInWidth                   (0)
+, m_iNumQuaTilesInHeight                  (0)
+, m_ppQuaTile                             (NULL)
+, m_pbQuaTileReady                        (NULL)
+#endif
 {
   for(UInt i=0; i<NUM_PIC_YUV; i++)
   {
@@ -94,6 +119,13 @@ Void TComPic::create( const TComSPS &sps, const TComPPS &pps, const Bool bIsVirt
 #endif
 
   m_picSym.create( sps, pps, uiMaxDepth );
+#if JVET_C0024_QTBT
+  m_uiCodedBlkStride = uiMaxCuWidth >> MIN_CU_LOG2;
+  m_pbCodedBlkInCTU  = new Bool[m_picSym.getNumberOfCtusInFrame() * m_uiCodedBlkStride * m_uiCodedBlkStride];
+  m_piCodedArea      = new Int [m_picSym.getNumberOfCtusInFrame()];
+  ::memset(m_pbCodedBlkInCTU, 0, m_picSym.getNumberOfCtusInFrame() * m_uiCodedBlkStride * m_uiCodedBlkStride * sizeof(Bool));
+  ::memset(m_piCodedArea,     0, m_picSym.getNumberOfCtusInFrame() * sizeof(Int));
+#endif
   if (!bIsVirtual)
   {
     m_apcPicYuv[PIC_YUV_ORG    ]   = new TComPicYuv;  m_apcPicYuv[PIC_YUV_ORG     ]->create( iWidth, iHeight, chromaFormatIDC, uiMaxCuWidth, uiMaxCuHeight, uiMaxDepth, true );
@@ -106,6 +138,24 @@ Void TComPic::create( const TComSPS &sps, const TComPPS &pps, const Bool bIsVirt
   if (sps.getUseInterKLT())
   {
 #endif
+#if KLT_ON_DEMAND_SUBPEL_PLANES
+      // the fractional pictures are stored by tiles, allocated when they are first read, see getQuaRegion()
+      m_apcQuaPicYuv[0][0] = m_apcPicYuv[PIC_YUV_REC];
+      releaseQuaPicYuvRec();
+      delete [] m_ppQuaTile;
+      delete [] m_pbQuaTileReady;
+      const Int iTotalWidth  = m_apcPicYuv[PIC_YUV_REC]->getStride(COMPONENT_Y);
+      const Int iTotalHeight = m_apcPicYuv[PIC_YUV_REC]->getTotalHeight(COMPONENT_Y);
+      m_iNumQuaTilesInWidth  = (iTotalWidth  + KLT_SUBPEL_TILE_SIZE - 1) / KLT_SUBPEL_TILE_SIZE;
+      m_iNumQuaTilesInHeight = (iTotalHeight + KLT_SUBPEL_TILE_SIZE - 1) / KLT_SUBPEL_TILE_SIZE;
+      m_ppQuaTile      = new Pel*[m_iNumQuaTilesInWidth * m_iNumQuaTilesInHeight];
+      m_pbQuaTileReady = new std::atomic<Bool>[m_iNumQuaTilesInWidth * m_iNumQuaTilesInHeight];
+      for (Int i = 0; i < m_iNumQuaTilesInWidth * m_iNumQuaTilesInHeight; i++)
+      {
+        m_ppQuaTile[i] = NULL;
+        m_pbQuaTileReady[i].store(false, std::memory_order_relaxed);
+      }
+#else
       for (UInt uiRow = 0; uiRow < 4; uiRow++)
       {
           for (UInt uiCol = 0; uiCol < 4; uiCol++)
@@ -121,6 +171,7 @@ Void TComPic::create( const TComSPS &sps, const TComPPS &pps, const Bool bIsVirt
               }
           }
       }
+#endif
 #if VCEG_AZ08_USE_KLT
   }
 #endif
@@ -137,6 +188,12 @@ Void TComPic::create( const TComSPS &sps, const TComPPS &pps, const Bool bIsVirt
 Void TComPic::destroy()
 {
   m_picSym.destroy();
+#if JVET_C0024_QTBT
+  delete [] m_pbCodedBlkInCTU;
+  m_pbCodedBlkInCTU = NULL;
+  delete [] m_piCodedArea;
+  m_piCodedArea = NULL;
+#endif
 
   for(UInt i=0; i<NUM_PIC_YUV; i++)
   {
@@ -149,6 +206,15 @@ Void TComPic::destroy()
   }
 
 #if VCEG_AZ08_INTER_KLT
+#if KLT_ON_DEMAND_SUBPEL_PLANES
+  releaseQuaPicYuvRec();
+  delete [] m_ppQuaTile;
+  m_ppQuaTile = NULL;
+  delete [] m_pbQuaTileReady;
+  m_pbQuaTileReady = NULL;
+  m_iNumQuaTilesInWidth  = 0;
+  m_iNumQuaTilesInHeight = 0;
+#endif
   for (UInt uiRow = 0; uiRow < 4; uiRow++)
   {
       for (UInt uiCol = 0; uiCol < 4; uiCol++)
@@ -316,28 +382,30 @@ ClipParam TComPic::computeTchClipParam(Int &delta_disto_luma,Int &delta_disto_ch
 }
 #endif
 #if JVET_C0024_QTBT
-Void TComPic::setCodedBlkInCTU(Bool bCoded, UInt uiBlkX, UInt uiBlkY, UInt uiWidth, UInt uiHeight)
+Void TComPic::setCodedBlkInCTU(UInt ctuRsAddr, Bool bCoded, UInt uiBlkX, UInt uiBlkY, UInt uiWidth, UInt uiHeight)
 {
-  assert(sizeof(**m_bCodedBlkInCTU)==1);
+  assert(sizeof(*m_pbCodedBlkInCTU)==1);
+  assert(uiBlkX+uiWidth <= m_uiCodedBlkStride && uiBlkY+uiHeight <= m_uiCodedBlkStride);
+  Bool *pbCodedBlk = m_pbCodedBlkInCTU + ctuRsAddr*m_uiCodedBlkStride*m_uiCodedBlkStride;
   for (UInt i=uiBlkY; i<uiBlkY+uiHeight; i++)
   {
-    memset(&m_bCodedBlkInCTU[i][uiBlkX], bCoded, uiWidth);
+    memset(&pbCodedBlk[i*m_uiCodedBlkStride + uiBlkX], bCoded, uiWidth);
   }
 }
-Int TComPic::getCodedAreaInCTU()
+Int TComPic::getCodedAreaInCTU(UInt ctuRsAddr)
 {
-  return m_iCodedArea;
+  return m_piCodedArea[ctuRsAddr];
 }
 
-Void TComPic::setCodedAreaInCTU(Int iArea)
+Void TComPic::setCodedAreaInCTU(UInt ctuRsAddr, Int iArea)
 {
-  m_iCodedArea = iArea;
+  m_piCodedArea[ctuRsAddr] = iArea;
 }
 
-Void TComPic::addCodedAreaInCTU(Int iArea)
+Void TComPic::addCodedAreaInCTU(UInt ctuRsAddr, Int iArea)
 {
-  m_iCodedArea += iArea;
-  assert(m_iCodedArea>=0);
+  m_piCodedArea[ctuRsAddr] += iArea;
+  assert(m_piCodedArea[ctuRsAddr]>=0);
 }
 
 Void  TComPic::setSkiped(UInt uiZorder, UInt uiWidth, UInt uiHeight, Bool bSkiped)
@@ -418,4 +486,226 @@ Void  TComPic::clearAllIntMv()
   memset(m_bSetIntMv, 0, (1<<((MAX_CU_DEPTH-MIN_CU_LOG2)<<1))*(MAX_CU_DEPTH-MIN_CU_LOG2+1)*(MAX_CU_DEPTH-MIN_CU_LOG2+1)*2*5*sizeof(Bool));
 }
 #endif
+
+#if PARALLEL_FRAME_DECODING
+/** Marks the picture as handed to (bPending) or released by the loop filter thread.
+ *  Threads blocked in waitForLoopFilter() are woken up when the picture is released.
+ */
+Void TComPic::setLoopFilterPending( Bool bPending )
+{
+  std::lock_guard<std::mutex> lock(m_loopFilterMutex);
+  m_bLoopFilterPending = bPending;
+  if (!bPending)
+  {
+    m_loopFilterDone.notify_all();
+  }
+}
+
+Bool TComPic::getLoopFilterPending()
+{
+  std::lock_guard<std::mutex> lock(m_loopFilterMutex);
+  return m_bLoopFilterPending;
+}
+
+/** Blocks until the samples and motion of the picture are final, i.e. until the loop filter thread has released it.
+ */
+Void TComPic::waitForLoopFilter()
+{
+  std::unique_lock<std::mutex> lock(m_loopFilterMutex);
+  m_loopFilterDone.wait(lock, [this]{ return !m_bLoopFilterPending; });
+}
+#endif
+
+#if KLT_ON_DEMAND_SUBPEL_PLANES
+/** Returns a luma area of a quarter pixel picture, interpolating the tiles of the area that have not been accessed yet.
+ *  The samples are read in place when the area lies in one tile, and are copied to pcBuf otherwise. May be called concurrently.
+ * \param uiRow     vertical fractional position, in quarter samples
+ * \param uiCol     horizontal fractional position, in quarter samples
+ * \param iPosX     horizontal position of the area, relative to the top-left sample of the picture
+ * \param iPosY     vertical position of the area
+ * \param iWidth    width of the area
+ * \param iHeight   height of the area
+ * \param pcBuf     buffer of at least iWidth * iHeight samples, used when the area spans several tiles
+ * \param riStride  returns the stride of the area
+ * \returns the top-left sample of the area
+ */
+Pel* TComPic::getQuaRegion( UInt uiRow, UInt uiCol, Int iPosX, Int iPosY, Int iWidth, Int iHeight, Pel* pcBuf, Int& riStride )
+{
+  TComPicYuv* pcPicYuvRec = m_apcPicYuv[PIC_YUV_REC];
+  if (uiRow == 0 && uiCol == 0)
+  {
+    riStride = pcPicYuvRec->getStride(COMPONENT_Y);
+    return pcPicYuvRec->getAddr(COMPONENT_Y) + iPosY * riStride + iPosX;
+  }
+
+  // position in the tiles, tile 0 starts at the top-left corner of the margin
+  const Int iX0 = iPosX + pcPicYuvRec->getMarginX(COMPONENT_Y);
+  const Int iY0 = iPosY + pcPicYuvRec->getMarginY(COMPONENT_Y);
+  const Int iX1 = iX0 + iWidth;
+  const Int iY1 = iY0 + iHeight;
+  assert(iX0 >= 0 && iY0 >= 0 && iX1 <= m_iNumQuaTilesInWidth * KLT_SUBPEL_TILE_SIZE && iY1 <= m_iNumQuaTilesInHeight * KLT_SUBPEL_TILE_SIZE);
+  const Int iTileX0 = iX0 / KLT_SUBPEL_TILE_SIZE;
+  const Int iTileY0 = iY0 / KLT_SUBPEL_TILE_SIZE;
+  const Int iTileX1 = (iX1 - 1) / KLT_SUBPEL_TILE_SIZE;
+  const Int iTileY1 = (iY1 - 1) / KLT_SUBPEL_TILE_SIZE;
+  xPrepareQuaTiles(iTileX0, iTileY0, iTileX1, iTileY1);
+
+  if (iTileX0 == iTileX1 && iTileY0 == iTileY1)
+  {
+    riStride = KLT_SUBPEL_TILE_SIZE;
+    return xGetQuaTileAddr(uiRow, uiCol, iTileX0, iTileY0) + (iY0 - iTileY0 * KLT_SUBPEL_TILE_SIZE) * KLT_SUBPEL_TILE_SIZE + iX0 - iTileX0 * KLT_SUBPEL_TILE_SIZE;
+  }
+
+  for (Int iTileY = iTileY0; iTileY <= iTileY1; iTileY++)
+  {
+    const Int iTop    = std::max(iY0, iTileY * KLT_SUBPEL_TILE_SIZE);
+    const Int iBottom = std::min(iY1, (iTileY + 1) * KLT_SUBPEL_TILE_SIZE);
+    for (Int iTileX = iTileX0; iTileX <= iTileX1; iTileX++)
+    {
+      const Int iLeft  = std::max(iX0, iTileX * KLT_SUBPEL_TILE_SIZE);
+      const Int iRight = std::min(iX1, (iTileX + 1) * KLT_SUBPEL_TILE_SIZE);
+      const Pel* pSrc  = xGetQuaTileAddr(uiRow, uiCol, iTileX, iTileY) + (iTop - iTileY * KLT_SUBPEL_TILE_SIZE) * KLT_SUBPEL_TILE_SIZE + iLeft - iTileX * KLT_SUBPEL_TILE_SIZE;
+      Pel*       pDst  = pcBuf + (iTop - iY0) * iWidth + iLeft - iX0;
+      for (Int y = iTop; y < iBottom; y++)
+      {
+        ::memcpy(pDst, pSrc, sizeof(Pel) * (iRight - iLeft));
+        pSrc += KLT_SUBPEL_TILE_SIZE;
+        pDst += iWidth;
+      }
+    }
+  }
+  riStride = iWidth;
+  return pcBuf;
+}
+
+/** Marks all the tiles of the quarter pixel pictures as not interpolated, as the reconstruction has changed.
+ *  Shall not be called while the picture is searched.
+ */
+Void TComPic::invalidateQuaPicYuvRec()
+{
+  std::lock_guard<std::mutex> lock(m_quaPicYuvMutex);
+  m_apcQuaPicYuv[0][0] = m_apcPicYuv[PIC_YUV_REC];
+  for (Int i = 0; i < m_iNumQuaTilesInWidth * m_iNumQuaTilesInHeight; i++)
+  {
+    m_pbQuaTileReady[i].store(false, std::memory_order_relaxed);
+  }
+}
+
+/** Frees the tiles of the quarter pixel pictures, once the picture can no longer be searched. They are allocated again on the next access.
+ */
+Void TComPic::releaseQuaPicYuvRec()
+{
+  std::lock_guard<std::mutex> lock(m_quaPicYuvMutex);
+  for (Int i = 0; i < m_iNumQuaTilesInWidth * m_iNumQuaTilesInHeight; i++)
+  {
+    if (m_ppQuaTile[i])
+    {
+      xFree(m_ppQuaTile[i]);
+      m_ppQuaTile[i] = NULL;
+    }
+    m_pbQuaTileReady[i].store(false, std::memory_order_relaxed);
+  }
+}
+
+/** Interpolates the tiles of a range that have not been accessed yet, allocating those that have never been accessed.
+ */
+Void TComPic::xPrepareQuaTiles( Int iTileX0, Int iTileY0, Int iTileX1, Int iTileY1 )
+{
+  for (Int iTileY = iTileY0; iTileY <= iTileY1; iTileY++)
+  {
+    for (Int iTileX = iTileX0; iTileX <= iTileX1; iTileX++)
+    {
+      const Int iTile = iTileY * m_iNumQuaTilesInWidth + iTileX;
+      if (m_pbQuaTileReady[iTile].load(std::memory_order_acquire))
+      {
+        continue;
+      }
+      std::lock_guard<std::mutex> lock(m_quaPicYuvMutex);
+      if (!m_pbQuaTileReady[iTile].load(std::memory_order_relaxed))
+      {
+        if (m_ppQuaTile[iTile] == NULL)
+        {
+          m_ppQuaTile[iTile] = (Pel*)xMalloc(Pel, 15 * KLT_SUBPEL_TILE_SIZE * KLT_SUBPEL_TILE_SIZE);
+        }
+        xInterpolateQuaTile(iTileX, iTileY);
+        m_pbQuaTileReady[iTile].store(true, std::memory_order_release);
+      }
+    }
+  }
+}
+
+/** Interpolates one tile of the 15 fractional pictures from the border-extended reconstruction. The samples of a tile
+ *  outside the picture are those of the nearest position inside the picture, as extendPicBorder() would set them.
+ * \param iTileX  horizontal tile index, tile 0 starts at the left edge of the margin
+ * \param iTileY  vertical tile index
+ */
+Void TComPic::xInterpolateQuaTile( Int iTileX, Int iTileY )
+{
+  const ComponentID compID      = COMPONENT_Y;
+  TComPicYuv*       pcPicYuvRec = m_apcPicYuv[PIC_YUV_REC];
+  const Int         iWidth      = pcPicYuvRec->getWidth(compID);
+  const Int         iHeight     = pcPicYuvRec->getHeight(compID);
+  const Int         iStride     = pcPicYuvRec->getStride(compID);
+  const Int         iMarginX    = pcPicYuvRec->getMarginX(compID);
+  const Int         iMarginY    = pcPicYuvRec->getMarginY(compID);
+  const Int         bitDepth    = getSlice(0)->getSPS()->getBitDepth(CHANNEL_TYPE_LUMA);
+  const ChromaFormat chFmt      = getChromaFormat();
+
+  // tile area, and the part of it inside the picture that is interpolated
+  const Int iX0  = iTileX * KLT_SUBPEL_TILE_SIZE - iMarginX;
+  const Int iY0  = iTileY * KLT_SUBPEL_TILE_SIZE - iMarginY;
+  const Int iX1  = iX0 + KLT_SUBPEL_TILE_SIZE;
+  const Int iY1  = iY0 + KLT_SUBPEL_TILE_SIZE;
+  const Int iCX0 = Clip3(0, iWidth  - 1, iX0);
+  const Int iCY0 = Clip3(0, iHeight - 1, iY0);
+  const Int iCX1 = Clip3(0, iWidth  - 1, iX1 - 1) + 1;
+  const Int iCY1 = Clip3(0, iHeight - 1, iY1 - 1) + 1;
+  const Bool bInside = iCX0 == iX0 && iCY0 == iY0 && iCX1 == iX1 && iCY1 == iY1;
+
+  TComInterpolationFilter cFilter;
+  Pel  acTmp[(KLT_SUBPEL_TILE_SIZE + NTAPS_LUMA - 1) * KLT_SUBPEL_TILE_SIZE];
+  Pel  acBlk[KLT_SUBPEL_TILE_SIZE * KLT_SUBPEL_TILE_SIZE];
+  Pel* pSrc = pcPicYuvRec->getAddr(compID) + iCY0 * iStride + iCX0;
+
+  for (UInt uiRow = 0; uiRow < 4; uiRow++)
+  {
+    for (UInt uiCol = 0; uiCol < 4; uiCol++)
+    {
+      if (uiRow == 0 && uiCol == 0)
+      {
+        continue;
+      }
+      Pel* pTile = xGetQuaTileAddr(uiRow, uiCol, iTileX, iTileY);
+      Pel* pDst  = bInside ? pTile : acBlk;
+
+      if (uiRow == 0)
+      {
+        cFilter.filterHor(compID, pSrc, iStride, pDst, KLT_SUBPEL_TILE_SIZE, iCX1 - iCX0, iCY1 - iCY0, uiCol << VCEG_AZ07_MV_ADD_PRECISION_BIT_FOR_STORE, true, chFmt, bitDepth);
+      }
+      else if (uiCol == 0)
+      {
+        cFilter.filterVer(compID, pSrc, iStride, pDst, KLT_SUBPEL_TILE_SIZE, iCX1 - iCX0, iCY1 - iCY0, uiRow << VCEG_AZ07_MV_ADD_PRECISION_BIT_FOR_STORE, true, true, chFmt, bitDepth);
+      }
+      else
+      {
+        cFilter.filterHor(compID, pSrc - ((NTAPS_LUMA >> 1) - 1) * iStride, iStride, acTmp, KLT_SUBPEL_TILE_SIZE, iCX1 - iCX0, iCY1 - iCY0 + NTAPS_LUMA - 1, uiCol << VCEG_AZ07_MV_ADD_PRECISION_BIT_FOR_STORE, false, chFmt, bitDepth);
+        cFilter.filterVer(compID, acTmp + ((NTAPS_LUMA >> 1) - 1) * KLT_SUBPEL_TILE_SIZE, KLT_SUBPEL_TILE_SIZE, pDst, KLT_SUBPEL_TILE_SIZE, iCX1 - iCX0, iCY1 - iCY0, uiRow << VCEG_AZ07_MV_ADD_PRECISION_BIT_FOR_STORE, false, true, chFmt, bitDepth);
+      }
+
+      if (!bInside)
+      {
+        for (Int y = iY0; y < iY1; y++)
+        {
+          const Pel* pBlkRow  = acBlk + (Clip3(iCY0, iCY1 - 1, y) - iCY0) * KLT_SUBPEL_TILE_SIZE - iCX0;
+          Pel*       pTileRow = pTile + (y - iY0) * KLT_SUBPEL_TILE_SIZE - iX0;
+          for (Int x = iX0; x < iX1; x++)
+          {
+            pTileRow[x] = pBlkRow[Clip3(iCX0, iCX1 - 1, x)];
+          }
+        }
+      }
+    }
+  }
+}
+#endif
 //! \}
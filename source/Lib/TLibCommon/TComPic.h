@@ -43,6 +43,14 @@
 #include "TComPicSym.h"
 #include "TComPicYuv.h"
 #include "TComBitStream.h"
+#if PARALLEL_FRAME_DECODING
+#include <mutex>
+#include <condition_variable>
+#endif
+#if KLT_ON_DEMAND_SUBPEL_PLANES
+#include <mutex>
+#include <atomic>
+#endif
 
 //! \ingroup TLibCommon
 //! \{
@@ -76,22 +84,37 @@ private:
 
   Bool                  m_isTop;
   Bool                  m_isField;
+#if PARALLEL_FRAME_DECODING
+  Bool                    m_bLoopFilterPending;   ///< the picture is being loop-filtered on another thread, its samples and motion are not final yet
+  std::mutex              m_loopFilterMutex;
+  std::condition_variable m_loopFilterDone;
+#endif
 #if COM16_C806_VCEG_AZ10_SUB_PU_TMVP
   Int                   m_iBaseUnitWidth;       ///< Width of Base Unit (with maximum depth or minimum size, m_iCuWidth >> Max. Depth)
   Int                   m_iBaseUnitHeight;      ///< Height of Base Unit (with maximum depth or minimum size, m_iCuHeight >> Max. Depth)
   Int                   m_iNumCuInWidth;
 #endif
 #if JVET_C0024_QTBT
-  //for record codec block info.
-  Bool m_bCodedBlkInCTU[MAX_CU_SIZE>>MIN_CU_LOG2][MAX_CU_SIZE>>MIN_CU_LOG2];    //[CTUSize>>MIN_CU_Log2][CTUSize>>MIN_CU_Log2]; [h][w]
-  Int  m_iCodedArea;
+  //for record codec block info, kept per CTU so that CTUs can be coded concurrently.
+  UInt  m_uiCodedBlkStride;                       ///< CTUSize>>MIN_CU_LOG2
+  Bool* m_pbCodedBlkInCTU;                        ///< [ctuRsAddr][h][w], (CTUSize>>MIN_CU_LOG2)^2 flags per CTU
+  Int*  m_piCodedArea;                            ///< [ctuRsAddr]
 
   //for encoder speedup
+#if PARALLEL_SUBSTREAM_ENCODING
+  // only valid while one CTU is compressed (cleared by TEncCu::compressCtu), kept per thread so that CTUs can be compressed concurrently
+  static thread_local TComMv m_cIntMv[1<<((MAX_CU_DEPTH-MIN_CU_LOG2)<<1)][MAX_CU_DEPTH-MIN_CU_LOG2+1][MAX_CU_DEPTH-MIN_CU_LOG2+1][2][5]; //[zorder][w][h][refList][refIdx]
+  static thread_local Bool   m_bSetIntMv[1<<((MAX_CU_DEPTH-MIN_CU_LOG2)<<1)][MAX_CU_DEPTH-MIN_CU_LOG2+1][MAX_CU_DEPTH-MIN_CU_LOG2+1][2][5]; //[zorder][w][h][refList][refIdx]
+  static thread_local Bool   m_bSkiped[1<<((MAX_CU_DEPTH-MIN_CU_LOG2)<<1)][MAX_CU_DEPTH-MIN_CU_LOG2+1][MAX_CU_DEPTH-MIN_CU_LOG2+1]; //[zorder][w][h] , if skip mode, not try inter, intra
+  static thread_local Bool   m_bInter[1<<((MAX_CU_DEPTH-MIN_CU_LOG2)<<1)][MAX_CU_DEPTH-MIN_CU_LOG2+1][MAX_CU_DEPTH-MIN_CU_LOG2+1]; //[zorder][w][h] , if inter mode, not try intra
+  static thread_local Bool   m_bIntra[1<<((MAX_CU_DEPTH-MIN_CU_LOG2)<<1)][MAX_CU_DEPTH-MIN_CU_LOG2+1][MAX_CU_DEPTH-MIN_CU_LOG2+1]; // if intra mode, not try inter
+#else
   TComMv                m_cIntMv[1<<((MAX_CU_DEPTH-MIN_CU_LOG2)<<1)][MAX_CU_DEPTH-MIN_CU_LOG2+1][MAX_CU_DEPTH-MIN_CU_LOG2+1][2][5]; //[zorder][w][h][refList][refIdx]
   Bool                  m_bSetIntMv[1<<((MAX_CU_DEPTH-MIN_CU_LOG2)<<1)][MAX_CU_DEPTH-MIN_CU_LOG2+1][MAX_CU_DEPTH-MIN_CU_LOG2+1][2][5]; //[zorder][w][h][refList][refIdx]
   Bool                  m_bSkiped[1<<((MAX_CU_DEPTH-MIN_CU_LOG2)<<1)][MAX_CU_DEPTH-MIN_CU_LOG2+1][MAX_CU_DEPTH-MIN_CU_LOG2+1]; //[zorder][w][h] , if skip mode, not try inter, intra
   Bool                  m_bInter[1<<((MAX_CU_DEPTH-MIN_CU_LOG2)<<1)][MAX_CU_DEPTH-MIN_CU_LOG2+1][MAX_CU_DEPTH-MIN_CU_LOG2+1]; //[zorder][w][h] , if inter mode, not try intra
   Bool                  m_bIntra[1<<((MAX_CU_DEPTH-MIN_CU_LOG2)<<1)][MAX_CU_DEPTH-MIN_CU_LOG2+1][MAX_CU_DEPTH-MIN_CU_LOG2+1]; // if intra mode, not try inter
+#endif
 #endif
 
   std::vector<std::vector<TComDataCU*> > m_vSliceCUDataLink;
@@ -104,11 +127,11 @@ public:
 
 #if JVET_C0024_QTBT
   //to record coded block info.
-  Void          setCodedBlkInCTU(Bool bCoded, UInt uiBlkX, UInt uiBlkY, UInt uiWidth, UInt uiHeight);
-  Bool          getCodedBlkInCTU(UInt uiBlkX, UInt uiBlkY) {return m_bCodedBlkInCTU[uiBlkY][uiBlkX];}
-  Void          setCodedAreaInCTU(Int iArea);
-  Void          addCodedAreaInCTU(Int iArea);
-  Int           getCodedAreaInCTU();
+  Void          setCodedBlkInCTU(UInt ctuRsAddr, Bool bCoded, UInt uiBlkX, UInt uiBlkY, UInt uiWidth, UInt uiHeight);
+  Bool          getCodedBlkInCTU(UInt ctuRsAddr, UInt uiBlkX, UInt uiBlkY) {return m_pbCodedBlkInCTU[(ctuRsAddr*m_uiCodedBlkStride + uiBlkY)*m_uiCodedBlkStride + uiBlkX];}
+  Void          setCodedAreaInCTU(UInt ctuRsAddr, Int iArea);
+  Void          addCodedAreaInCTU(UInt ctuRsAddr, Int iArea);
+  Int           getCodedAreaInCTU(UInt ctuRsAddr);
 
   //for encoder speed-up
   Void          setSkiped(UInt uiZorder, UInt uiWidth, UInt uiHeight, Bool bSkip);
@@ -172,6 +195,11 @@ public:
 #endif
 
   UInt          getNumberOfCtusInFrame() const     { return m_picSym.getNumberOfCtusInFrame(); }
+#if PARALLEL_FRAME_DECODING
+  Void          setLoopFilterPending( Bool bPending );
+  Bool          getLoopFilterPending();
+  Void          waitForLoopFilter   ();
+#endif
   UInt          getNumPartInCtuWidth() const       { return m_picSym.getNumPartInCtuWidth();   }
   UInt          getNumPartInCtuHeight() const      { return m_picSym.getNumPartInCtuHeight();  }
   UInt          getNumPartitionsInCtu() const      { return m_picSym.getNumPartitionsInCtu();  }
@@ -228,6 +256,22 @@ public:
 #if VCEG_AZ08_INTER_KLT
   TComPicYuv*   m_apcQuaPicYuv[4][4];     //   quarter pixel reconstructed pictures (fractional pixels); 
   TComPicYuv*   getPicQuaYuvRec(UInt uiRow, UInt uiCol)     { return  m_apcQuaPicYuv[uiRow][uiCol]; }
+#if KLT_ON_DEMAND_SUBPEL_PLANES
+  Pel*          getQuaRegion          ( UInt uiRow, UInt uiCol, Int iPosX, Int iPosY, Int iWidth, Int iHeight, Pel* pcBuf, Int& riStride );
+  Void          invalidateQuaPicYuvRec();
+  Void          releaseQuaPicYuvRec   ();
+private:
+  Void          xPrepareQuaTiles      ( Int iTileX0, Int iTileY0, Int iTileX1, Int iTileY1 );
+  Void          xInterpolateQuaTile   ( Int iTileX, Int iTileY );
+  Pel*          xGetQuaTileAddr       ( UInt uiRow, UInt uiCol, Int iTileX, Int iTileY ) { return m_ppQuaTile[iTileY * m_iNumQuaTilesInWidth + iTileX] + ( uiRow * 4 + uiCol - 1 ) * KLT_SUBPEL_TILE_SIZE * KLT_SUBPEL_TILE_SIZE; }
+
+  Int                 m_iNumQuaTilesInWidth;
+  Int                 m_iNumQuaTilesInHeight;
+  Pel**               m_ppQuaTile;        ///< [tile], the samples of the tile in the 15 quarter pixel pictures, allocated when the tile is first interpolated
+  std::atomic<Bool>*  m_pbQuaTileReady;   ///< [tile], the tile is interpolated in all the quarter pixel pictures, tiles cover the pictures including their margins
+  std::mutex          m_quaPicYuvMutex;   ///< serialises the allocation, interpolation and release of the tiles
+public:
+#endif
 #endif
 #if JVET_D0033_ADAPTIVE_CLIPPING
   ClipParam m_aclip_prm;
@@ -40,6 +40,28 @@
 #include "TComPic.h"
 #include "TComTU.h"
 
+#if SIMD_AVX2_BIO && SIMD_AVX_TARGETS
+#define AVX_BIO_KERNELS                                   1
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"   // _mm512_undefined_epi32() in the AVX-512 intrinsics
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#else
+#define AVX_BIO_KERNELS                                   0
+#endif
+
+#if SIMD_AVX2_OBMC && SIMD_AVX_TARGETS
+#define AVX_OBMC_KERNELS                                  1
+#if !AVX_BIO_KERNELS
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"   // _mm512_undefined_epi32() in the AVX-512 intrinsics
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#endif
+#else
+#define AVX_OBMC_KERNELS                                  0
+#endif
+
 //! \ingroup TLibCommon
 //! \{
 
@@ -121,12 +143,31 @@ TComPrediction::TComPrediction()
 {
 #if VCEG_AZ05_BIO 
 #define BIO_TEMP_BUFFER_SIZE      (MAX_CU_SIZE+4)*(MAX_CU_SIZE+4) 
+#define BIO_SUM_BUFFER_SIZE       (5*(MAX_CU_SIZE+4)+5*5*MAX_CU_SIZE)
   m_pGradX0 = new Pel [BIO_TEMP_BUFFER_SIZE];
   m_pGradY0 = new Pel [BIO_TEMP_BUFFER_SIZE];
   m_pGradX1 = new Pel [BIO_TEMP_BUFFER_SIZE];
   m_pGradY1 = new Pel [BIO_TEMP_BUFFER_SIZE];
   m_pPred0  = new Pel [BIO_TEMP_BUFFER_SIZE];
   m_pPred1  = new Pel [BIO_TEMP_BUFFER_SIZE];
+  m_piDotProduct1 = new Int64 [BIO_TEMP_BUFFER_SIZE];
+  m_piDotProduct2 = new Int64 [BIO_TEMP_BUFFER_SIZE];
+  m_piDotProduct3 = new Int64 [BIO_TEMP_BUFFER_SIZE];
+  m_piDotProduct5 = new Int64 [BIO_TEMP_BUFFER_SIZE];
+  m_piDotProduct6 = new Int64 [BIO_TEMP_BUFFER_SIZE];
+  m_piS1temp      = new Int64 [BIO_TEMP_BUFFER_SIZE];
+  m_piS2temp      = new Int64 [BIO_TEMP_BUFFER_SIZE];
+  m_piS3temp      = new Int64 [BIO_TEMP_BUFFER_SIZE];
+  m_piS5temp      = new Int64 [BIO_TEMP_BUFFER_SIZE];
+  m_piS6temp      = new Int64 [BIO_TEMP_BUFFER_SIZE];
+  m_piS1          = new Int64 [BIO_TEMP_BUFFER_SIZE];
+  m_piS2          = new Int64 [BIO_TEMP_BUFFER_SIZE];
+  m_piS3          = new Int64 [BIO_TEMP_BUFFER_SIZE];
+  m_piS5          = new Int64 [BIO_TEMP_BUFFER_SIZE];
+  m_piS6          = new Int64 [BIO_TEMP_BUFFER_SIZE];
+#if SIMD_AVX2_BIO
+  m_pdBioSums     = new Double[BIO_SUM_BUFFER_SIZE];
+#endif
   iRefListIdx = -1;  
 #endif
 #if COM16_C1046_PDPC_INTRA
@@ -154,6 +195,10 @@ TComPrediction::TComPrediction()
 #if VCEG_AZ07_FRUC_MERGE
   m_cFRUCRDCost.init();
 #endif
+#if FRUC_INTERP_WINDOW_CACHE
+  m_iFrucWindowNum    = 0;
+  m_uiFrucWindowClock = 0;
+#endif
 
 #if VCEG_AZ08_INTER_KLT
   m_tempPicYuv = NULL;
@@ -174,6 +219,24 @@ Void TComPrediction::destroy()
   if( m_pGradY1 != NULL )     {delete [] m_pGradY1 ; m_pGradY1= NULL;}
   if( m_pPred0  != NULL )     {delete [] m_pPred0  ; m_pPred0 = NULL;}
   if( m_pPred1  != NULL )     {delete [] m_pPred1  ; m_pPred1 = NULL;}
+  if( m_piDotProduct1 != NULL ) {delete [] m_piDotProduct1; m_piDotProduct1 = NULL;}
+  if( m_piDotProduct2 != NULL ) {delete [] m_piDotProduct2; m_piDotProduct2 = NULL;}
+  if( m_piDotProduct3 != NULL ) {delete [] m_piDotProduct3; m_piDotProduct3 = NULL;}
+  if( m_piDotProduct5 != NULL ) {delete [] m_piDotProduct5; m_piDotProduct5 = NULL;}
+  if( m_piDotProduct6 != NULL ) {delete [] m_piDotProduct6; m_piDotProduct6 = NULL;}
+  if( m_piS1temp      != NULL ) {delete [] m_piS1temp     ; m_piS1temp = NULL;}
+  if( m_piS2temp      != NULL ) {delete [] m_piS2temp     ; m_piS2temp = NULL;}
+  if( m_piS3temp      != NULL ) {delete [] m_piS3temp     ; m_piS3temp = NULL;}
+  if( m_piS5temp      != NULL ) {delete [] m_piS5temp     ; m_piS5temp = NULL;}
+  if( m_piS6temp      != NULL ) {delete [] m_piS6temp     ; m_piS6temp = NULL;}
+  if( m_piS1          != NULL ) {delete [] m_piS1         ; m_piS1 = NULL;}
+  if( m_piS2          != NULL ) {delete [] m_piS2         ; m_piS2 = NULL;}
+  if( m_piS3          != NULL ) {delete [] m_piS3         ; m_piS3 = NULL;}
+  if( m_piS5          != NULL ) {delete [] m_piS5         ; m_piS5 = NULL;}
+  if( m_piS6          != NULL ) {delete [] m_piS6         ; m_piS6 = NULL;}
+#if SIMD_AVX2_BIO
+  if( m_pdBioSums     != NULL ) {delete [] m_pdBioSums    ; m_pdBioSums = NULL;}
+#endif
 #endif
 
 #if COM16_C1046_PDPC_INTRA
@@ -214,6 +277,10 @@ Void TComPrediction::destroy()
   }
 
   m_cYuvPredTemp.destroy();
+#if OBMC_RUN_PREDICTION
+  m_acYuvPredOBMC[0].destroy();
+  m_acYuvPredOBMC[1].destroy();
+#endif
 
   if( m_pLumaRecBuffer )
   {
@@ -234,6 +301,10 @@ Void TComPrediction::destroy()
 #if VCEG_AZ07_FRUC_MERGE
   m_cYuvPredFrucTemplate[0].destroy();
   m_cYuvPredFrucTemplate[1].destroy();
+#if FRUC_FLAT_START_MV_LIST
+  m_listMVFieldCand[0].destroy();
+  m_listMVFieldCand[1].destroy();
+#endif
 #if COM16_C806_VCEG_AZ10_SUB_PU_TMVP
 #if JVET_C0035_ATMVP_SIMPLIFICATION
   for (UInt ui=0;ui<NUM_MGR_TYPE;ui++)
@@ -323,6 +394,10 @@ Void TComPrediction::initTempBuff(ChromaFormat chromaFormatIDC
     }
 
     m_cYuvPredTemp.create( MAX_CU_SIZE, MAX_CU_SIZE, chromaFormatIDC );
+#if OBMC_RUN_PREDICTION
+    m_acYuvPredOBMC[0].create( MAX_CU_SIZE, MAX_CU_SIZE, chromaFormatIDC );
+    m_acYuvPredOBMC[1].create( MAX_CU_SIZE, MAX_CU_SIZE, chromaFormatIDC );
+#endif
 #if VCEG_AZ07_FRUC_MERGE
     m_cYuvPredFrucTemplate[0].create( MAX_CU_SIZE, MAX_CU_SIZE, chromaFormatIDC );
     m_cYuvPredFrucTemplate[1].create( MAX_CU_SIZE, MAX_CU_SIZE, chromaFormatIDC );
@@ -356,6 +431,13 @@ Void TComPrediction::initTempBuff(ChromaFormat chromaFormatIDC
   }
 #endif
 
+#if FRUC_FLAT_START_MV_LIST
+  if( !m_listMVFieldCand[0].isCreated() )
+  {
+    m_listMVFieldCand[0].create( FRUC_MAX_START_MV_NUM );
+    m_listMVFieldCand[1].create( FRUC_MAX_START_MV_NUM );
+  }
+#endif
 #if VCEG_AZ07_FRUC_MERGE && COM16_C806_VCEG_AZ10_SUB_PU_TMVP
   if( m_cMvFieldSP[0] == NULL )
   {
@@ -382,8 +464,13 @@ Void TComPrediction::initTempBuff(ChromaFormat chromaFormatIDC
   }
 #endif
 
-#if VCEG_AZ08_INTER_KLT
+#if VCEG_AZ08_INTER_KLT && !KLT_ON_DEMAND_SUBPEL_PLANES
+#if PARALLEL_FRAME_DECODING
+  // keep the buffer of a previous picture of the same size: interpolatePic() may still be using it on the loop filter thread
+  if( interKLT && ( m_tempPicYuv == NULL || m_tempPicYuv->getWidth( COMPONENT_Y ) != iPicWidth || m_tempPicYuv->getHeight( COMPONENT_Y ) != iPicHeight || m_tempPicYuv->getChromaFormat() != chromaFormatIDC ) )
+#else
   if( interKLT )
+#endif
   {
     if( m_tempPicYuv != NULL )
     {
@@ -2226,6 +2313,338 @@ Pel optical_flow_averaging( Int64 s1,Int64 s2,Int64 s3,Int64 s5,Int64 s6,
 }
 #endif
 
+#if AVX_BIO_KERNELS
+/** Fused BIO of a luma block, one row of the extended block at a time
+ *  The products of the row are summed over 5 columns into a ring of the last five rows, whose sum gives the 5x5 window sums of the
+ *  output row two rows above, from which the flow and the average of that row follow. The products, the sums and the numerators of
+ *  the flow stay below 2^48, so they are exact in double precision. The quotients of the flow are truncated from the rounded double quotient, which is exact
+ *  since the divisors stay below 2^40 and the quotients are clipped to +-limit, far below 2^13.
+ *  \param pSrc0, pSrc1      predictions of the extended block of ( iWidth + 4 ) x ( iHeight + 4 ) samples, with a stride of iWidth + 4
+ *  \param pGradX0, pGradY0  gradients of the list 0 prediction, same layout
+ *  \param pGradX1, pGradY1  gradients of the list 1 prediction, same layout
+ *  \param iWidth            multiple of 4, up to MAX_CU_SIZE
+ *  \param iScale0, iScale1  factors of the list 0 and list 1 gradients, applied with the 16-bit wrap-around of the C code
+ *  \param pdBuf             BIO_SUM_BUFFER_SIZE doubles
+ */
+__attribute__((target("avx2")))
+static Void simdBioAverageAVX2( const Pel* pSrc0, const Pel* pSrc1, const Pel* pGradX0, const Pel* pGradX1, const Pel* pGradY0, const Pel* pGradY1,
+                                Int iWidth, Int iHeight, Int iScale0, Int iScale1, Pel* pDst, Int iDstStride, Double* pdBuf,
+                                Int iShiftNum, Int iOffset, Int64 iLimit, Int64 iDenomMin1, Int64 iDenomMin2, Int64 iRegularizator1, Int64 iRegularizator2,
+                                Int iMinVal, Int iMaxVal )
+{
+  const Int     iWidthG     = iWidth  + 4;
+  const Int     iHeightG    = iHeight + 4;
+  const Int     iRowSize    = 5 * MAX_CU_SIZE;
+  Double*       pdProd      = pdBuf;                          // x*x, x*y, -x*t<<5, y*y<<1 and -y*t<<6 of a row
+  Double*       pdRows      = pdBuf + 5 * ( MAX_CU_SIZE + 4 );  // the same summed over 5 columns, for the last five rows
+
+  const __m128i vScale0     = _mm_set1_epi16( ( Short )iScale0 );
+  const __m128i vScale1     = _mm_set1_epi16( ( Short )iScale1 );
+  const __m256d dLimit      = _mm256_set1_pd( ( Double )iLimit );
+  const __m256d dLimitNeg   = _mm256_set1_pd( -( Double )iLimit );
+  const __m256d dDenomMin1  = _mm256_set1_pd( ( Double )iDenomMin1 );
+  const __m256d dDenomMin2  = _mm256_set1_pd( ( Double )iDenomMin2 );
+  const __m256d dReg1       = _mm256_set1_pd( ( Double )iRegularizator1 );
+  const __m256d dReg2       = _mm256_set1_pd( ( Double )iRegularizator2 );
+  const __m256d dMul3       = _mm256_set1_pd( -32.0 );
+  const __m256d dMul5       = _mm256_set1_pd( 2.0 );
+  const __m256d dMul6       = _mm256_set1_pd( -64.0 );
+  const __m128i vRound      = _mm_set1_epi32( 32 );
+  const __m128i vOffset     = _mm_set1_epi32( iOffset );
+  const __m128i vShiftNum   = _mm_cvtsi32_si128( iShiftNum );
+  const __m128i vMin        = _mm_set1_epi32( iMinVal );
+  const __m128i vMax        = _mm_set1_epi32( iMaxVal );
+
+  for( Int y = 0; y < iHeightG; y++ )
+  {
+    const Int iRowOff = y * iWidthG;
+    for( Int x = 0; x < iWidthG; x += 4 )
+    {
+      const Int     i   = iRowOff + x;
+      const __m128i vT  = _mm_sub_epi32( _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* )( pSrc0 + i ) ) ),
+                                         _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* )( pSrc1 + i ) ) ) );
+      const __m128i vGx = _mm_add_epi32( _mm_cvtepi16_epi32( _mm_mullo_epi16( _mm_loadl_epi64( ( const __m128i* )( pGradX0 + i ) ), vScale0 ) ),
+                                         _mm_cvtepi16_epi32( _mm_mullo_epi16( _mm_loadl_epi64( ( const __m128i* )( pGradX1 + i ) ), vScale1 ) ) );
+      const __m128i vGy = _mm_add_epi32( _mm_cvtepi16_epi32( _mm_mullo_epi16( _mm_loadl_epi64( ( const __m128i* )( pGradY0 + i ) ), vScale0 ) ),
+                                         _mm_cvtepi16_epi32( _mm_mullo_epi16( _mm_loadl_epi64( ( const __m128i* )( pGradY1 + i ) ), vScale1 ) ) );
+      const __m256d dT  = _mm256_cvtepi32_pd( vT );
+      const __m256d dGx = _mm256_cvtepi32_pd( vGx );
+      const __m256d dGy = _mm256_cvtepi32_pd( vGy );
+      _mm256_storeu_pd( pdProd + x,               _mm256_mul_pd( dGx, dGx ) );
+      _mm256_storeu_pd( pdProd + x +     iWidthG, _mm256_mul_pd( dGx, dGy ) );
+      _mm256_storeu_pd( pdProd + x + 2 * iWidthG, _mm256_mul_pd( _mm256_mul_pd( dGx, dT ), dMul3 ) );
+      _mm256_storeu_pd( pdProd + x + 3 * iWidthG, _mm256_mul_pd( _mm256_mul_pd( dGy, dGy ), dMul5 ) );
+      _mm256_storeu_pd( pdProd + x + 4 * iWidthG, _mm256_mul_pd( _mm256_mul_pd( dGy, dT ), dMul6 ) );
+    }
+
+    Double* pdRow = pdRows + ( y % 5 ) * iRowSize;
+    for( Int k = 0; k < 5; k++ )
+    {
+      const Double* pd    = pdProd + k * iWidthG;
+      Double*       pdSum = pdRow  + k * MAX_CU_SIZE;
+      for( Int x = 0; x < iWidth; x += 4 )
+      {
+        const __m256d d01 = _mm256_add_pd( _mm256_loadu_pd( pd + x     ), _mm256_loadu_pd( pd + x + 1 ) );
+        const __m256d d23 = _mm256_add_pd( _mm256_loadu_pd( pd + x + 2 ), _mm256_loadu_pd( pd + x + 3 ) );
+        _mm256_storeu_pd( pdSum + x, _mm256_add_pd( _mm256_add_pd( d01, d23 ), _mm256_loadu_pd( pd + x + 4 ) ) );
+      }
+    }
+    if( y < 4 )
+    {
+      continue;
+    }
+
+    // output row y - 4, centred on row y - 2 of the extended block
+    const Int iCentreOff = ( y - 2 ) * iWidthG + 2;
+    Pel*      pDstRow    = pDst + ( y - 4 ) * iDstStride;
+    for( Int x = 0; x < iWidth; x += 4 )
+    {
+      __m256d dS[5];
+      for( Int k = 0; k < 5; k++ )
+      {
+        const Double* pd = pdRows + k * MAX_CU_SIZE + x;
+        dS[k] = _mm256_add_pd( _mm256_add_pd( _mm256_add_pd( _mm256_loadu_pd( pd ), _mm256_loadu_pd( pd + iRowSize ) ),
+                                              _mm256_add_pd( _mm256_loadu_pd( pd + 2 * iRowSize ), _mm256_loadu_pd( pd + 3 * iRowSize ) ) ),
+                               _mm256_loadu_pd( pd + 4 * iRowSize ) );
+      }
+      const __m256d dS1 = _mm256_add_pd( dS[0], dReg1 );
+      const __m256d dS5 = _mm256_add_pd( dS[3], dReg2 );
+
+      __m256d dVx = _mm256_round_pd( _mm256_div_pd( dS[2], dS1 ), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC );
+      dVx = _mm256_and_pd( _mm256_min_pd( _mm256_max_pd( dVx, dLimitNeg ), dLimit ), _mm256_cmp_pd( dS1, dDenomMin1, _CMP_GT_OQ ) );
+      __m256d dVy = _mm256_round_pd( _mm256_div_pd( _mm256_sub_pd( dS[4], _mm256_mul_pd( dVx, dS[1] ) ), dS5 ), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC );
+      dVy = _mm256_and_pd( _mm256_min_pd( _mm256_max_pd( dVy, dLimitNeg ), dLimit ), _mm256_cmp_pd( dS5, dDenomMin2, _CMP_GT_OQ ) );
+
+      const Int     i    = iCentreOff + x;
+      const __m128i vDgx = _mm_sub_epi32( _mm_cvtepi16_epi32( _mm_mullo_epi16( _mm_loadl_epi64( ( const __m128i* )( pGradX0 + i ) ), vScale0 ) ),
+                                          _mm_cvtepi16_epi32( _mm_mullo_epi16( _mm_loadl_epi64( ( const __m128i* )( pGradX1 + i ) ), vScale1 ) ) );
+      const __m128i vDgy = _mm_sub_epi32( _mm_cvtepi16_epi32( _mm_mullo_epi16( _mm_loadl_epi64( ( const __m128i* )( pGradY0 + i ) ), vScale0 ) ),
+                                          _mm_cvtepi16_epi32( _mm_mullo_epi16( _mm_loadl_epi64( ( const __m128i* )( pGradY1 + i ) ), vScale1 ) ) );
+      __m128i vB = _mm_add_epi32( _mm_mullo_epi32( _mm256_cvttpd_epi32( dVx ), vDgx ), _mm_mullo_epi32( _mm256_cvttpd_epi32( dVy ), vDgy ) );
+      vB = _mm_sign_epi32( _mm_srai_epi32( _mm_add_epi32( _mm_abs_epi32( vB ), vRound ), 6 ), vB );
+
+      __m128i vVal = _mm_add_epi32( _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* )( pSrc0 + i ) ) ),
+                                    _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* )( pSrc1 + i ) ) ) );
+      vVal = _mm_sra_epi32( _mm_add_epi32( vVal, _mm_add_epi32( vB, vOffset ) ), vShiftNum );
+      vVal = _mm_srai_epi32( _mm_slli_epi32( vVal, 16 ), 16 );
+      vVal = _mm_min_epi32( _mm_max_epi32( vVal, vMin ), vMax );
+      _mm_storel_epi64( ( __m128i* )( pDstRow + x ), _mm_packs_epi32( vVal, vVal ) );
+    }
+  }
+}
+#endif
+
+#if VCEG_AZ05_BIO
+/** Bi-directional optical flow average of the luma predictions and gradients in m_pPred0/1 and m_pGradX0/X1/Y0/Y1
+ * \param uiPartIdx partition index of the prediction block in pcYuvDst
+ * \param bShortRefMV the references are close (low-delay B), with a lower limit of the refinement
+ * \param dT0 POC distance of the list 0 reference, the gradients are scaled by the distances if the references are on both sides
+ * \param dT1 POC distance of the list 1 reference
+ */
+Void TComPrediction::xBIOAverage( UInt uiPartIdx, Int iWidth, Int iHeight, TComYuv* pcYuvDst, const BitDepths &clipBitDepths
+#if JVET_C0027_BIO
+  , Bool bShortRefMV
+#endif
+#if COM16_C1045_BIO_HARMO_IMPROV
+  , Int dT0, Int dT1
+#endif
+)
+{
+  Int x=0, y=0;
+
+  Int iHeightG = iHeight + 4;
+  Int iWidthG  = iWidth  + 4;
+  Int iStrideTemp = 2+2*iWidthG;
+  Pel* pGradX0 = m_pGradX0; Pel* pGradX1 = m_pGradX1; 
+  Pel* pGradY0 = m_pGradY0; Pel* pGradY1 = m_pGradY1;    
+  Pel* pSrcY0 = m_pPred0; 
+  Pel* pSrcY1 = m_pPred1;
+  Int iSrc0Stride = iWidthG;
+  Int iSrc1Stride = iWidthG;   
+  Pel* pDstY = pcYuvDst->getAddr(COMPONENT_Y,uiPartIdx); 
+  Int iDstStride = pcYuvDst->getStride(COMPONENT_Y); 
+  Pel* pSrcY0Temp = pSrcY0; Pel* pSrcY1Temp = pSrcY1;
+
+  static const int  bitDepth =clipBitDepths.recon[toChannelType(COMPONENT_Y)];
+  static const int  shiftNum    = IF_INTERNAL_PREC + 1 - bitDepth;
+  static const int  offset      = ( 1 << ( shiftNum - 1 ) ) + 2 * IF_INTERNAL_OFFS;
+#if JVET_C0027_BIO
+  static const Int64 limit = (12<<(IF_INTERNAL_PREC -bShortRefMV - bitDepth)); 
+#else
+  static const Int64 limit = (12<<(IF_INTERNAL_PREC-1- bitDepth)); 
+#endif
+  static const Int64 regularizator_1 = 500* (1<< (bitDepth-8))* (1<< (bitDepth-8));
+  static const Int64 regularizator_2 =regularizator_1<<1;
+  static const Int64 denom_min_1 = 700* (1<< (bitDepth-8))* (1<< (bitDepth-8));
+  static const Int64 denom_min_2 = denom_min_1<<1;
+
+#if AVX_BIO_KERNELS
+  if( m_fpBioAverage && iWidth <= MAX_CU_SIZE && ( iWidth & 3 ) == 0 )
+  {
+#if COM16_C1045_BIO_HARMO_IMPROV
+    const Bool bScale  = dT0 * dT1 < 0;
+    const Int  iScale0 = bScale ? dT0 : 1;
+    const Int  iScale1 = bScale ? dT1 : 1;
+#else
+    const Int  iScale0 = 1;
+    const Int  iScale1 = 1;
+#endif
+#if JVET_D0033_ADAPTIVE_CLIPPING
+    const Int  iMinVal = ( Short )g_ClipParam.Y().m;
+    const Int  iMaxVal = ( Short )g_ClipParam.Y().M;
+#else
+    const Int  iMinVal = 0;
+    const Int  iMaxVal = ( 1 << bitDepth ) - 1;
+#endif
+    m_fpBioAverage( m_pPred0, m_pPred1, m_pGradX0, m_pGradX1, m_pGradY0, m_pGradY1, iWidth, iHeight, iScale0, iScale1, pDstY, iDstStride, m_pdBioSums,
+                    shiftNum, offset, limit, denom_min_1, denom_min_2, regularizator_1, regularizator_2, iMinVal, iMaxVal );
+  }
+  else
+  {
+#endif
+#if COM16_C1045_BIO_HARMO_IMPROV
+  if( dT0 * dT1 < 0 )
+  {
+    Pel * tmpGradX0 = m_pGradX0;
+    Pel * tmpGradX1 = m_pGradX1;
+    Pel * tmpGradY0 = m_pGradY0;
+    Pel * tmpGradY1 = m_pGradY1;
+    for( y = 0; y < iHeightG; y++ )    
+    {
+      for( x =0; x < iWidthG ; x++ )
+      {
+        tmpGradX0[x] *= dT0;
+        tmpGradX1[x] *= dT1;
+        tmpGradY0[x] *= dT0;
+        tmpGradY1[x] *= dT1;
+      }
+      tmpGradX0 += iWidthG;
+      tmpGradX1 += iWidthG;
+      tmpGradY0 += iWidthG;
+      tmpGradY1 += iWidthG;
+    }
+  }
+#endif
+
+  Int64* m_piDotProductTemp1 = m_piDotProduct1;Int64* m_piDotProductTemp2 = m_piDotProduct2;Int64* m_piDotProductTemp3 = m_piDotProduct3;Int64* m_piDotProductTemp5 = m_piDotProduct5;Int64* m_piDotProductTemp6 = m_piDotProduct6;
+  Int64* m_pS1loc=m_piS1temp;Int64* m_pS2loc=m_piS2temp;Int64* m_pS3loc=m_piS3temp;Int64* m_pS5loc=m_piS5temp;Int64* m_pS6loc=m_piS6temp;
+  Int64* m_pS1loc_1=m_piS1temp;Int64* m_pS2loc_1=m_piS2temp;Int64* m_pS3loc_1=m_piS3temp;Int64* m_pS5loc_1=m_piS5temp;Int64* m_pS6loc_1=m_piS6temp;
+  Int64* m_pS1loc_2=m_piS1temp;Int64* m_pS2loc_2=m_piS2temp;Int64* m_pS3loc_2=m_piS3temp;Int64* m_pS5loc_2=m_piS5temp;Int64* m_pS6loc_2=m_piS6temp;
+  Int64* m_pS1loc_3=m_piS1temp;Int64* m_pS2loc_3=m_piS2temp;Int64* m_pS3loc_3=m_piS3temp;Int64* m_pS5loc_3=m_piS5temp;Int64* m_pS6loc_3=m_piS6temp;
+
+  Int64* m_pS1loc1=m_piS1temp;Int64* m_pS2loc1=m_piS2temp;Int64* m_pS3loc1=m_piS3temp;Int64* m_pS5loc1=m_piS5temp;Int64* m_pS6loc1=m_piS6temp;
+  Int64* m_pS1loc2=m_piS1temp;Int64* m_pS2loc2=m_piS2temp;Int64* m_pS3loc2=m_piS3temp;Int64* m_pS5loc2=m_piS5temp;Int64* m_pS6loc2=m_piS6temp;
+  Int64* m_piSS1loc=m_piS1;Int64* m_piSS2loc=m_piS2;Int64* m_piSS3loc=m_piS3;Int64* m_piSS5loc=m_piS5;Int64* m_piSS6loc=m_piS6;
+  Int64* m_piSS1loc_1=m_piS1;Int64* m_piSS2loc_1=m_piS2;Int64* m_piSS3loc_1=m_piS3;Int64* m_piSS5loc_1=m_piS5;Int64* m_piSS6loc_1=m_piS6;
+
+  Int64 temp=0, tempX=0, tempY=0;
+  for (y = 0; y < iHeightG; y ++)    
+  {
+    for (x =0; x < iWidthG ; x ++)
+    {
+      temp =(Int64) (pSrcY0Temp[x ] - pSrcY1Temp[x ]);
+      tempX =(Int64) (pGradX0[x] +  pGradX1[x]);
+      tempY =(Int64) (pGradY0[x] +  pGradY1[x]);
+      m_piDotProductTemp1[x] =  tempX*tempX;
+      m_piDotProductTemp2[x] =  tempX*tempY;
+      m_piDotProductTemp3[x] = -tempX*temp<<5;
+      m_piDotProductTemp5[x] =  tempY*tempY<<1;
+      m_piDotProductTemp6[x] = -tempY*temp<<6;
+    }
+    pSrcY0Temp+=iSrc0Stride;
+    pSrcY1Temp+=iSrc1Stride;
+    pGradX0+=iWidthG;
+    pGradX1+=iWidthG;
+    pGradY0+=iWidthG;
+    pGradY1+=iWidthG;
+    m_piDotProductTemp1+=iWidthG;
+    m_piDotProductTemp2+=iWidthG;
+    m_piDotProductTemp3+=iWidthG;
+    m_piDotProductTemp5+=iWidthG;
+    m_piDotProductTemp6+=iWidthG;
+  }
+
+  m_piDotProductTemp1 = m_piDotProduct1+2;m_piDotProductTemp2 = m_piDotProduct2+2;m_piDotProductTemp3 = m_piDotProduct3+2;m_piDotProductTemp5 = m_piDotProduct5+2;m_piDotProductTemp6 = m_piDotProduct6+2;
+  m_pS1loc=m_piS1temp+2;m_pS2loc=m_piS2temp+2;m_pS3loc=m_piS3temp+2;m_pS5loc=m_piS5temp+2;m_pS6loc=m_piS6temp+2;      
+
+  for (y = 0;y < iHeightG ; y ++)
+  {  
+    x=0;
+    m_pS1loc[x] =  m_piDotProductTemp1[-2] + m_piDotProductTemp1[-1] + m_piDotProductTemp1[0] + m_piDotProductTemp1[1] +  m_piDotProductTemp1[2] ;
+    m_pS2loc[x] =  m_piDotProductTemp2[-2] + m_piDotProductTemp2[-1] + m_piDotProductTemp2[0] + m_piDotProductTemp2[1] +  m_piDotProductTemp2[2] ;
+    m_pS3loc[x] =  m_piDotProductTemp3[-2] + m_piDotProductTemp3[-1] + m_piDotProductTemp3[0] + m_piDotProductTemp3[1] +  m_piDotProductTemp3[2] ;
+    m_pS5loc[x] =  m_piDotProductTemp5[-2] + m_piDotProductTemp5[-1] + m_piDotProductTemp5[0] + m_piDotProductTemp5[1] +  m_piDotProductTemp5[2] ;
+    m_pS6loc[x] =  m_piDotProductTemp6[-2] + m_piDotProductTemp6[-1] + m_piDotProductTemp6[0] + m_piDotProductTemp6[1] +  m_piDotProductTemp6[2] ;
+
+    for ( x=1;    x < iWidth  ; x++)
+    {
+      m_pS1loc[x] =  -m_piDotProductTemp1[x-3]  +  m_piDotProductTemp1[x+2] + m_pS1loc[x-1];
+      m_pS2loc[x] =  -m_piDotProductTemp2[x-3]  +  m_piDotProductTemp2[x+2] + m_pS2loc[x-1];  
+      m_pS3loc[x] =  -m_piDotProductTemp3[x-3]  +  m_piDotProductTemp3[x+2] + m_pS3loc[x-1];
+      m_pS5loc[x] =  -m_piDotProductTemp5[x-3]  +  m_piDotProductTemp5[x+2] + m_pS5loc[x-1];  
+      m_pS6loc[x] =  -m_piDotProductTemp6[x-3]  +  m_piDotProductTemp6[x+2] + m_pS6loc[x-1];
+    }
+    m_piDotProductTemp1+=iWidthG;m_piDotProductTemp2+=iWidthG;m_piDotProductTemp3+=iWidthG;m_piDotProductTemp5+=iWidthG;m_piDotProductTemp6+=iWidthG;
+    m_pS1loc+=iWidthG;m_pS2loc+=iWidthG;m_pS3loc+=iWidthG;m_pS5loc+=iWidthG;m_pS6loc+=iWidthG;
+  }
+  m_pS1loc=m_piS1temp+iStrideTemp;m_pS2loc=m_piS2temp+iStrideTemp;m_pS3loc=m_piS3temp+iStrideTemp;m_pS5loc=m_piS5temp+iStrideTemp;m_pS6loc=m_piS6temp+iStrideTemp;
+  m_pS1loc_1=m_pS1loc- iWidthG;m_pS2loc_1=m_pS2loc- iWidthG;m_pS3loc_1=m_pS3loc- iWidthG;m_pS5loc_1=m_pS5loc- iWidthG;m_pS6loc_1=m_pS6loc- iWidthG;
+  m_pS1loc_2=m_pS1loc_1- iWidthG;m_pS2loc_2=m_pS2loc_1- iWidthG;m_pS3loc_2=m_pS3loc_1- iWidthG;m_pS5loc_2=m_pS5loc_1- iWidthG;m_pS6loc_2=m_pS6loc_1- iWidthG;
+  m_pS1loc1=m_pS1loc+ iWidthG;m_pS2loc1=m_pS2loc+ iWidthG;m_pS3loc1=m_pS3loc+ iWidthG;m_pS5loc1=m_pS5loc+ iWidthG;m_pS6loc1=m_pS6loc+ iWidthG;
+  m_pS1loc2=m_pS1loc1+ iWidthG;m_pS2loc2=m_pS2loc1+ iWidthG;m_pS3loc2=m_pS3loc1+ iWidthG;m_pS5loc2=m_pS5loc1+ iWidthG;m_pS6loc2=m_pS6loc1+ iWidthG;
+  m_piSS1loc=m_piS1+iStrideTemp;m_piSS2loc=m_piS2+iStrideTemp;m_piSS3loc=m_piS3+iStrideTemp;m_piSS5loc=m_piS5+iStrideTemp;m_piSS6loc=m_piS6+iStrideTemp;
+  pGradX0 = m_pGradX0+iStrideTemp ;  pGradX1 = m_pGradX1+iStrideTemp ;
+  pGradY0 = m_pGradY0+iStrideTemp  ; pGradY1 = m_pGradY1+iStrideTemp ;
+  pSrcY0Temp = pSrcY0 +iStrideTemp;
+  pSrcY1Temp = pSrcY1 +iStrideTemp;
+
+  y = 0;
+  for (x = 0; x < iWidth ; x ++)
+  { 
+    m_piSS1loc[x]=m_pS1loc_2[x]+m_pS1loc_1[x]+m_pS1loc[x]+m_pS1loc1[x]+m_pS1loc2[x]+regularizator_1;
+    m_piSS2loc[x]=m_pS2loc_2[x]+m_pS2loc_1[x]+m_pS2loc[x]+m_pS2loc1[x]+m_pS2loc2[x];
+    m_piSS3loc[x]=m_pS3loc_2[x]+m_pS3loc_1[x]+m_pS3loc[x]+m_pS3loc1[x]+m_pS3loc2[x];
+    m_piSS5loc[x]=m_pS5loc_2[x]+m_pS5loc_1[x]+m_pS5loc[x]+m_pS5loc1[x]+m_pS5loc2[x]+regularizator_2;
+    m_piSS6loc[x]=m_pS6loc_2[x]+m_pS6loc_1[x]+m_pS6loc[x]+m_pS6loc1[x]+m_pS6loc2[x];
+    pDstY[x]=optical_flow_averaging(
+      m_piSS1loc[x],m_piSS2loc[x],m_piSS3loc[x],m_piSS5loc[x],m_piSS6loc[x],
+      pGradX0[x] , pGradX1[x],pGradY0[x] , pGradY1[x],pSrcY0Temp[x ], pSrcY1Temp[x ]
+    ,  shiftNum ,  offset , limit, denom_min_1, denom_min_2,bitDepth);
+  }
+  m_pS1loc2+=iWidthG;m_pS2loc2+=iWidthG;m_pS3loc2+=iWidthG;m_pS5loc2+=iWidthG;m_pS6loc2+=iWidthG;
+  pDstY += iDstStride;pSrcY0Temp+=iSrc0Stride;pSrcY1Temp+=iSrc1Stride;pGradX0+=iWidthG;pGradX1+=iWidthG;pGradY0+=iWidthG;pGradY1+=iWidthG;
+  m_piSS1loc_1=m_piSS1loc;m_piSS2loc_1=m_piSS2loc;m_piSS3loc_1=m_piSS3loc;m_piSS5loc_1=m_piSS5loc;m_piSS6loc_1=m_piSS6loc;
+  m_pS1loc+=iWidthG;m_pS2loc+=iWidthG;m_pS3loc+=iWidthG;m_pS5loc+=iWidthG;m_pS6loc+=iWidthG;
+  m_pS1loc_3=m_pS1loc_2;m_pS2loc_3=m_pS2loc_2;m_pS3loc_3=m_pS3loc_2;m_pS5loc_3=m_pS5loc_2;m_pS6loc_3=m_pS6loc_2;
+  m_piSS1loc+=iWidthG;  m_piSS2loc+=iWidthG;  m_piSS3loc+=iWidthG;  m_piSS5loc+=iWidthG;  m_piSS6loc+=iWidthG;
+  for (y = 1;  y < iHeight ;   y ++)
+  {
+    for (x = 0; x < iWidth ; x ++)
+    { 
+      m_piSS1loc[x]=m_piSS1loc_1[x]-m_pS1loc_3[x]+m_pS1loc2[x];
+      m_piSS2loc[x]=m_piSS2loc_1[x]-m_pS2loc_3[x]+m_pS2loc2[x];
+      m_piSS3loc[x]=m_piSS3loc_1[x]-m_pS3loc_3[x]+m_pS3loc2[x];
+      m_piSS5loc[x]=m_piSS5loc_1[x]-m_pS5loc_3[x]+m_pS5loc2[x];
+      m_piSS6loc[x]=m_piSS6loc_1[x]-m_pS6loc_3[x]+m_pS6loc2[x];
+
+      pDstY[x]=optical_flow_averaging(m_piSS1loc[x],m_piSS2loc[x],m_piSS3loc[x],m_piSS5loc[x],m_piSS6loc[x],
+        pGradX0[x] , pGradX1[x],pGradY0[x] , pGradY1[x],pSrcY0Temp[x ], pSrcY1Temp[x ]
+      ,  shiftNum,  offset, limit, denom_min_1, denom_min_2 ,bitDepth);
+    }
+
+    m_piSS1loc_1=m_piSS1loc;m_piSS2loc_1=m_piSS2loc;m_piSS3loc_1=m_piSS3loc;m_piSS5loc_1=m_piSS5loc;m_piSS6loc_1=m_piSS6loc;
+    m_piSS1loc+=iWidthG;m_piSS2loc+=iWidthG;m_piSS3loc+=iWidthG;m_piSS5loc+=iWidthG;m_piSS6loc+=iWidthG;
+    m_pS1loc2+=iWidthG;m_pS2loc2+=iWidthG;m_pS3loc2+=iWidthG;m_pS5loc2+=iWidthG;m_pS6loc2+=iWidthG;
+    m_pS1loc_3+=iWidthG;m_pS2loc_3+=iWidthG;m_pS3loc_3+=iWidthG;m_pS5loc_3+=iWidthG;m_pS6loc_3+=iWidthG;
+    pDstY += iDstStride;pSrcY0Temp+=iSrc0Stride;pSrcY1Temp+=iSrc1Stride;
+    pGradX0+=iWidthG;pGradX1+=iWidthG;pGradY0+=iWidthG;pGradY1+=iWidthG;
+  }
+#if AVX_BIO_KERNELS
+  }
+#endif
+}
+#endif
+
 Void TComPrediction::xWeightedAverage( TComYuv* pcYuvSrc0, TComYuv* pcYuvSrc1, Int iRefIdx0, Int iRefIdx1, UInt uiPartIdx, Int iWidth, Int iHeight, TComYuv* pcYuvDst, const BitDepths &clipBitDepths 
 #if VCEG_AZ05_BIO                  
   ,bool bBIOapplied
@@ -2240,193 +2659,25 @@ Void TComPrediction::xWeightedAverage( TComYuv* pcYuvSrc0, TComYuv* pcYuvSrc1, I
 #if VCEG_AZ05_BIO 
     if (bBIOapplied)
     {
-      static Int64 m_piDotProduct1[BIO_TEMP_BUFFER_SIZE];
-      static Int64 m_piDotProduct2[BIO_TEMP_BUFFER_SIZE];
-      static Int64 m_piDotProduct3[BIO_TEMP_BUFFER_SIZE];
-      static Int64 m_piDotProduct5[BIO_TEMP_BUFFER_SIZE];
-      static Int64 m_piDotProduct6[BIO_TEMP_BUFFER_SIZE];
-      static Int64 m_piS1temp[BIO_TEMP_BUFFER_SIZE];
-      static Int64 m_piS2temp[BIO_TEMP_BUFFER_SIZE];
-      static Int64 m_piS3temp[BIO_TEMP_BUFFER_SIZE];
-      static Int64 m_piS5temp[BIO_TEMP_BUFFER_SIZE];
-      static Int64 m_piS6temp[BIO_TEMP_BUFFER_SIZE];
-      static Int64 m_piS1[BIO_TEMP_BUFFER_SIZE];
-      static Int64 m_piS2[BIO_TEMP_BUFFER_SIZE];
-      static Int64 m_piS3[BIO_TEMP_BUFFER_SIZE];
-      static Int64 m_piS5[BIO_TEMP_BUFFER_SIZE];
-      static Int64 m_piS6[BIO_TEMP_BUFFER_SIZE];
-      Int x=0, y=0;
-
-      Int iHeightG = iHeight + 4;
-      Int iWidthG  = iWidth  + 4;
-      Int iStrideTemp = 2+2*iWidthG;
-      Pel* pGradX0 = m_pGradX0; Pel* pGradX1 = m_pGradX1; 
-      Pel* pGradY0 = m_pGradY0; Pel* pGradY1 = m_pGradY1;    
-      Pel* pSrcY0 = m_pPred0; 
-      Pel* pSrcY1 = m_pPred1;
-      Int iSrc0Stride = iWidthG;
-      Int iSrc1Stride = iWidthG;   
-      Pel* pDstY = pcYuvDst->getAddr(COMPONENT_Y,uiPartIdx); 
-      Int iDstStride = pcYuvDst->getStride(COMPONENT_Y); 
-      Pel* pSrcY0Temp = pSrcY0; Pel* pSrcY1Temp = pSrcY1;
-
+#if JVET_C0027_BIO
+      static const bool bShortRefMV =  (pCu->getSlice()->getCheckLDC()
+#if COM16_C1045_BIO_HARMO_IMPROV
+        && pCu->isBIOLDB(uiPartIdx)
+#endif
+        );
+#endif
 #if COM16_C1045_BIO_HARMO_IMPROV
       Int dT0 = pCu->getSlice()->getRefPOC( REF_PIC_LIST_0 , iRefIdx0 ) - pCu->getSlice()->getPOC();
       Int dT1 = pCu->getSlice()->getPOC() - pCu->getSlice()->getRefPOC( REF_PIC_LIST_1 , iRefIdx1 );
-      if( dT0 * dT1 < 0 )
-      {
-        Pel * tmpGradX0 = m_pGradX0;
-        Pel * tmpGradX1 = m_pGradX1;
-        Pel * tmpGradY0 = m_pGradY0;
-        Pel * tmpGradY1 = m_pGradY1;
-        for( y = 0; y < iHeightG; y++ )    
-        {
-          for( x =0; x < iWidthG ; x++ )
-          {
-            tmpGradX0[x] *= dT0;
-            tmpGradX1[x] *= dT1;
-            tmpGradY0[x] *= dT0;
-            tmpGradY1[x] *= dT1;
-          }
-          tmpGradX0 += iWidthG;
-          tmpGradX1 += iWidthG;
-          tmpGradY0 += iWidthG;
-          tmpGradY1 += iWidthG;
-        }
-      }
 #endif
-
-      static const int  bitDepth =clipBitDepths.recon[toChannelType(COMPONENT_Y)];
-      static const int  shiftNum    = IF_INTERNAL_PREC + 1 - bitDepth;
-      static const int  offset      = ( 1 << ( shiftNum - 1 ) ) + 2 * IF_INTERNAL_OFFS;
+      xBIOAverage( uiPartIdx, iWidth, iHeight, pcYuvDst, clipBitDepths
 #if JVET_C0027_BIO
-      static const bool bShortRefMV =  (pCu->getSlice()->getCheckLDC()
+        , bShortRefMV
+#endif
 #if COM16_C1045_BIO_HARMO_IMPROV
-        && pCu->isBIOLDB(uiPartIdx)
+        , dT0, dT1
 #endif
         );
-      static const Int64 limit = (12<<(IF_INTERNAL_PREC -bShortRefMV - bitDepth)); 
-#else
-      static const Int64 limit = (12<<(IF_INTERNAL_PREC-1- bitDepth)); 
-#endif
-      static const Int64 regularizator_1 = 500* (1<< (bitDepth-8))* (1<< (bitDepth-8));
-      static const Int64 regularizator_2 =regularizator_1<<1;
-      static const Int64 denom_min_1 = 700* (1<< (bitDepth-8))* (1<< (bitDepth-8));
-      static const Int64 denom_min_2 = denom_min_1<<1;
-
-      Int64* m_piDotProductTemp1 = m_piDotProduct1;Int64* m_piDotProductTemp2 = m_piDotProduct2;Int64* m_piDotProductTemp3 = m_piDotProduct3;Int64* m_piDotProductTemp5 = m_piDotProduct5;Int64* m_piDotProductTemp6 = m_piDotProduct6;
-      Int64* m_pS1loc=m_piS1temp;Int64* m_pS2loc=m_piS2temp;Int64* m_pS3loc=m_piS3temp;Int64* m_pS5loc=m_piS5temp;Int64* m_pS6loc=m_piS6temp;
-      Int64* m_pS1loc_1=m_piS1temp;Int64* m_pS2loc_1=m_piS2temp;Int64* m_pS3loc_1=m_piS3temp;Int64* m_pS5loc_1=m_piS5temp;Int64* m_pS6loc_1=m_piS6temp;
-      Int64* m_pS1loc_2=m_piS1temp;Int64* m_pS2loc_2=m_piS2temp;Int64* m_pS3loc_2=m_piS3temp;Int64* m_pS5loc_2=m_piS5temp;Int64* m_pS6loc_2=m_piS6temp;
-      Int64* m_pS1loc_3=m_piS1temp;Int64* m_pS2loc_3=m_piS2temp;Int64* m_pS3loc_3=m_piS3temp;Int64* m_pS5loc_3=m_piS5temp;Int64* m_pS6loc_3=m_piS6temp;
-
-      Int64* m_pS1loc1=m_piS1temp;Int64* m_pS2loc1=m_piS2temp;Int64* m_pS3loc1=m_piS3temp;Int64* m_pS5loc1=m_piS5temp;Int64* m_pS6loc1=m_piS6temp;
-      Int64* m_pS1loc2=m_piS1temp;Int64* m_pS2loc2=m_piS2temp;Int64* m_pS3loc2=m_piS3temp;Int64* m_pS5loc2=m_piS5temp;Int64* m_pS6loc2=m_piS6temp;
-      Int64* m_piSS1loc=m_piS1;Int64* m_piSS2loc=m_piS2;Int64* m_piSS3loc=m_piS3;Int64* m_piSS5loc=m_piS5;Int64* m_piSS6loc=m_piS6;
-      Int64* m_piSS1loc_1=m_piS1;Int64* m_piSS2loc_1=m_piS2;Int64* m_piSS3loc_1=m_piS3;Int64* m_piSS5loc_1=m_piS5;Int64* m_piSS6loc_1=m_piS6;
-
-      Int64 temp=0, tempX=0, tempY=0;
-      for (y = 0; y < iHeightG; y ++)    
-      {
-        for (x =0; x < iWidthG ; x ++)
-        {
-          temp =(Int64) (pSrcY0Temp[x ] - pSrcY1Temp[x ]);
-          tempX =(Int64) (pGradX0[x] +  pGradX1[x]);
-          tempY =(Int64) (pGradY0[x] +  pGradY1[x]);
-          m_piDotProductTemp1[x] =  tempX*tempX;
-          m_piDotProductTemp2[x] =  tempX*tempY;
-          m_piDotProductTemp3[x] = -tempX*temp<<5;
-          m_piDotProductTemp5[x] =  tempY*tempY<<1;
-          m_piDotProductTemp6[x] = -tempY*temp<<6;
-        }
-        pSrcY0Temp+=iSrc0Stride;
-        pSrcY1Temp+=iSrc1Stride;
-        pGradX0+=iWidthG;
-        pGradX1+=iWidthG;
-        pGradY0+=iWidthG;
-        pGradY1+=iWidthG;
-        m_piDotProductTemp1+=iWidthG;
-        m_piDotProductTemp2+=iWidthG;
-        m_piDotProductTemp3+=iWidthG;
-        m_piDotProductTemp5+=iWidthG;
-        m_piDotProductTemp6+=iWidthG;
-      }
-
-      m_piDotProductTemp1 = m_piDotProduct1+2;m_piDotProductTemp2 = m_piDotProduct2+2;m_piDotProductTemp3 = m_piDotProduct3+2;m_piDotProductTemp5 = m_piDotProduct5+2;m_piDotProductTemp6 = m_piDotProduct6+2;
-      m_pS1loc=m_piS1temp+2;m_pS2loc=m_piS2temp+2;m_pS3loc=m_piS3temp+2;m_pS5loc=m_piS5temp+2;m_pS6loc=m_piS6temp+2;      
-
-      for (y = 0;y < iHeightG ; y ++)
-      {  
-        x=0;
-        m_pS1loc[x] =  m_piDotProductTemp1[-2] + m_piDotProductTemp1[-1] + m_piDotProductTemp1[0] + m_piDotProductTemp1[1] +  m_piDotProductTemp1[2] ;
-        m_pS2loc[x] =  m_piDotProductTemp2[-2] + m_piDotProductTemp2[-1] + m_piDotProductTemp2[0] + m_piDotProductTemp2[1] +  m_piDotProductTemp2[2] ;
-        m_pS3loc[x] =  m_piDotProductTemp3[-2] + m_piDotProductTemp3[-1] + m_piDotProductTemp3[0] + m_piDotProductTemp3[1] +  m_piDotProductTemp3[2] ;
-        m_pS5loc[x] =  m_piDotProductTemp5[-2] + m_piDotProductTemp5[-1] + m_piDotProductTemp5[0] + m_piDotProductTemp5[1] +  m_piDotProductTemp5[2] ;
-        m_pS6loc[x] =  m_piDotProductTemp6[-2] + m_piDotProductTemp6[-1] + m_piDotProductTemp6[0] + m_piDotProductTemp6[1] +  m_piDotProductTemp6[2] ;
-
-        for ( x=1;    x < iWidth  ; x++)
-        {
-          m_pS1loc[x] =  -m_piDotProductTemp1[x-3]  +  m_piDotProductTemp1[x+2] + m_pS1loc[x-1];
-          m_pS2loc[x] =  -m_piDotProductTemp2[x-3]  +  m_piDotProductTemp2[x+2] + m_pS2loc[x-1];  
-          m_pS3loc[x] =  -m_piDotProductTemp3[x-3]  +  m_piDotProductTemp3[x+2] + m_pS3loc[x-1];
-          m_pS5loc[x] =  -m_piDotProductTemp5[x-3]  +  m_piDotProductTemp5[x+2] + m_pS5loc[x-1];  
-          m_pS6loc[x] =  -m_piDotProductTemp6[x-3]  +  m_piDotProductTemp6[x+2] + m_pS6loc[x-1];
-        }
-        m_piDotProductTemp1+=iWidthG;m_piDotProductTemp2+=iWidthG;m_piDotProductTemp3+=iWidthG;m_piDotProductTemp5+=iWidthG;m_piDotProductTemp6+=iWidthG;
-        m_pS1loc+=iWidthG;m_pS2loc+=iWidthG;m_pS3loc+=iWidthG;m_pS5loc+=iWidthG;m_pS6loc+=iWidthG;
-      }
-      m_pS1loc=m_piS1temp+iStrideTemp;m_pS2loc=m_piS2temp+iStrideTemp;m_pS3loc=m_piS3temp+iStrideTemp;m_pS5loc=m_piS5temp+iStrideTemp;m_pS6loc=m_piS6temp+iStrideTemp;
-      m_pS1loc_1=m_pS1loc- iWidthG;m_pS2loc_1=m_pS2loc- iWidthG;m_pS3loc_1=m_pS3loc- iWidthG;m_pS5loc_1=m_pS5loc- iWidthG;m_pS6loc_1=m_pS6loc- iWidthG;
-      m_pS1loc_2=m_pS1loc_1- iWidthG;m_pS2loc_2=m_pS2loc_1- iWidthG;m_pS3loc_2=m_pS3loc_1- iWidthG;m_pS5loc_2=m_pS5loc_1- iWidthG;m_pS6loc_2=m_pS6loc_1- iWidthG;
-      m_pS1loc1=m_pS1loc+ iWidthG;m_pS2loc1=m_pS2loc+ iWidthG;m_pS3loc1=m_pS3loc+ iWidthG;m_pS5loc1=m_pS5loc+ iWidthG;m_pS6loc1=m_pS6loc+ iWidthG;
-      m_pS1loc2=m_pS1loc1+ iWidthG;m_pS2loc2=m_pS2loc1+ iWidthG;m_pS3loc2=m_pS3loc1+ iWidthG;m_pS5loc2=m_pS5loc1+ iWidthG;m_pS6loc2=m_pS6loc1+ iWidthG;
-      m_piSS1loc=m_piS1+iStrideTemp;m_piSS2loc=m_piS2+iStrideTemp;m_piSS3loc=m_piS3+iStrideTemp;m_piSS5loc=m_piS5+iStrideTemp;m_piSS6loc=m_piS6+iStrideTemp;
-      pGradX0 = m_pGradX0+iStrideTemp ;  pGradX1 = m_pGradX1+iStrideTemp ;
-      pGradY0 = m_pGradY0+iStrideTemp  ; pGradY1 = m_pGradY1+iStrideTemp ;
-      pSrcY0Temp = pSrcY0 +iStrideTemp;
-      pSrcY1Temp = pSrcY1 +iStrideTemp;
-
-      y = 0;
-      for (x = 0; x < iWidth ; x ++)
-      { 
-        m_piSS1loc[x]=m_pS1loc_2[x]+m_pS1loc_1[x]+m_pS1loc[x]+m_pS1loc1[x]+m_pS1loc2[x]+regularizator_1;
-        m_piSS2loc[x]=m_pS2loc_2[x]+m_pS2loc_1[x]+m_pS2loc[x]+m_pS2loc1[x]+m_pS2loc2[x];
-        m_piSS3loc[x]=m_pS3loc_2[x]+m_pS3loc_1[x]+m_pS3loc[x]+m_pS3loc1[x]+m_pS3loc2[x];
-        m_piSS5loc[x]=m_pS5loc_2[x]+m_pS5loc_1[x]+m_pS5loc[x]+m_pS5loc1[x]+m_pS5loc2[x]+regularizator_2;
-        m_piSS6loc[x]=m_pS6loc_2[x]+m_pS6loc_1[x]+m_pS6loc[x]+m_pS6loc1[x]+m_pS6loc2[x];
-        pDstY[x]=optical_flow_averaging(
-          m_piSS1loc[x],m_piSS2loc[x],m_piSS3loc[x],m_piSS5loc[x],m_piSS6loc[x],
-          pGradX0[x] , pGradX1[x],pGradY0[x] , pGradY1[x],pSrcY0Temp[x ], pSrcY1Temp[x ]
-        ,  shiftNum ,  offset , limit, denom_min_1, denom_min_2,bitDepth);
-      }
-      m_pS1loc2+=iWidthG;m_pS2loc2+=iWidthG;m_pS3loc2+=iWidthG;m_pS5loc2+=iWidthG;m_pS6loc2+=iWidthG;
-      pDstY += iDstStride;pSrcY0Temp+=iSrc0Stride;pSrcY1Temp+=iSrc1Stride;pGradX0+=iWidthG;pGradX1+=iWidthG;pGradY0+=iWidthG;pGradY1+=iWidthG;
-      m_piSS1loc_1=m_piSS1loc;m_piSS2loc_1=m_piSS2loc;m_piSS3loc_1=m_piSS3loc;m_piSS5loc_1=m_piSS5loc;m_piSS6loc_1=m_piSS6loc;
-      m_pS1loc+=iWidthG;m_pS2loc+=iWidthG;m_pS3loc+=iWidthG;m_pS5loc+=iWidthG;m_pS6loc+=iWidthG;
-      m_pS1loc_3=m_pS1loc_2;m_pS2loc_3=m_pS2loc_2;m_pS3loc_3=m_pS3loc_2;m_pS5loc_3=m_pS5loc_2;m_pS6loc_3=m_pS6loc_2;
-      m_piSS1loc+=iWidthG;  m_piSS2loc+=iWidthG;  m_piSS3loc+=iWidthG;  m_piSS5loc+=iWidthG;  m_piSS6loc+=iWidthG;
-      for (y = 1;  y < iHeight ;   y ++)
-      {
-        for (x = 0; x < iWidth ; x ++)
-        { 
-          m_piSS1loc[x]=m_piSS1loc_1[x]-m_pS1loc_3[x]+m_pS1loc2[x];
-          m_piSS2loc[x]=m_piSS2loc_1[x]-m_pS2loc_3[x]+m_pS2loc2[x];
-          m_piSS3loc[x]=m_piSS3loc_1[x]-m_pS3loc_3[x]+m_pS3loc2[x];
-          m_piSS5loc[x]=m_piSS5loc_1[x]-m_pS5loc_3[x]+m_pS5loc2[x];
-          m_piSS6loc[x]=m_piSS6loc_1[x]-m_pS6loc_3[x]+m_pS6loc2[x];
-
-          pDstY[x]=optical_flow_averaging(m_piSS1loc[x],m_piSS2loc[x],m_piSS3loc[x],m_piSS5loc[x],m_piSS6loc[x],
-            pGradX0[x] , pGradX1[x],pGradY0[x] , pGradY1[x],pSrcY0Temp[x ], pSrcY1Temp[x ]
-          ,  shiftNum,  offset, limit, denom_min_1, denom_min_2 ,bitDepth);
-        }
-
-        m_piSS1loc_1=m_piSS1loc;m_piSS2loc_1=m_piSS2loc;m_piSS3loc_1=m_piSS3loc;m_piSS5loc_1=m_piSS5loc;m_piSS6loc_1=m_piSS6loc;
-        m_piSS1loc+=iWidthG;m_piSS2loc+=iWidthG;m_piSS3loc+=iWidthG;m_piSS5loc+=iWidthG;m_piSS6loc+=iWidthG;
-        m_pS1loc2+=iWidthG;m_pS2loc2+=iWidthG;m_pS3loc2+=iWidthG;m_pS5loc2+=iWidthG;m_pS6loc2+=iWidthG;
-        m_pS1loc_3+=iWidthG;m_pS2loc_3+=iWidthG;m_pS3loc_3+=iWidthG;m_pS5loc_3+=iWidthG;m_pS6loc_3+=iWidthG;
-        pDstY += iDstStride;pSrcY0Temp+=iSrc0Stride;pSrcY1Temp+=iSrc1Stride;
-        pGradX0+=iWidthG;pGradX1+=iWidthG;pGradY0+=iWidthG;pGradY1+=iWidthG;
-      }
     } //bBIOapplied
     pcYuvDst->addAvg( pcYuvSrc0, pcYuvSrc1, uiPartIdx, iWidth, iHeight, clipBitDepths, bBIOapplied);    
 #else
@@ -2556,6 +2807,104 @@ const Short m_lumaInterpolationFilter[4][BIO_FILTER_LENGTH] =
 };
 #endif
 
+#if AVX_BIO_KERNELS
+/** Rounds 32-bit sums of a six-tap BIO filter as gradFilter*() and fracFilter*() do, ( s + o ) >> k for s >= 0 and -( ( -s + o ) >> k )
+ *  otherwise, and truncates them to 16 bits
+ */
+__attribute__((target("avx2")))
+static inline __m256i simdBioRoundAVX2( __m256i vSum, __m256i vOffset, __m128i vShift )
+{
+  const __m256i vZero = _mm256_setzero_si256();
+  const __m256i vPos  = _mm256_sra_epi32( _mm256_add_epi32( vSum, vOffset ), vShift );
+  const __m256i vNeg  = _mm256_sub_epi32( vZero, _mm256_sra_epi32( _mm256_sub_epi32( vOffset, vSum ), vShift ) );
+  const __m256i vRes  = _mm256_blendv_epi8( vPos, vNeg, _mm256_cmpgt_epi32( vZero, vSum ) );
+  return _mm256_srai_epi32( _mm256_slli_epi32( vRes, 16 ), 16 );
+}
+
+__attribute__((target("avx2")))
+static inline __m128i simdBioRoundAVX2( __m128i vSum, __m128i vOffset, __m128i vShift )
+{
+  const __m128i vZero = _mm_setzero_si128();
+  const __m128i vPos  = _mm_sra_epi32( _mm_add_epi32( vSum, vOffset ), vShift );
+  const __m128i vNeg  = _mm_sub_epi32( vZero, _mm_sra_epi32( _mm_sub_epi32( vOffset, vSum ), vShift ) );
+  const __m128i vRes  = _mm_blendv_epi8( vPos, vNeg, _mm_cmpgt_epi32( vZero, vSum ) );
+  return _mm_srai_epi32( _mm_slli_epi32( vRes, 16 ), 16 );
+}
+
+/** Six-tap BIO gradient or interpolation filter of a block, bit-exact with gradFilter*() and fracFilter*()
+ *  Taps are applied in pairs with madd on interleaved sample rows. Columns are done 16, 8 and 4 at a time and the remaining ones in C.
+ *  \param piSrc       first tap of the first sample
+ *  \param iTapStride  1 for a horizontal filter, iSrcStride for a vertical one
+ *  \param psCoeff     BIO_FILTER_LENGTH coefficients
+ */
+__attribute__((target("avx2")))
+static Void simdBioFilterAVX2( const Pel* piSrc, Int iSrcStride, Int iTapStride, Pel* piDst, Int iDstStride, Int iWidth, Int iHeight, const Short* psCoeff, Int iOffset, Int iShift )
+{
+  __m256i vCoeff[BIO_FILTER_LENGTH/2];
+  for( Int n = 0; n < BIO_FILTER_LENGTH/2; n++ )
+  {
+    vCoeff[n] = _mm256_set1_epi32( ( Int )( ( UInt )( UShort )psCoeff[2*n] | ( ( UInt )( UShort )psCoeff[2*n+1] << 16 ) ) );
+  }
+  const __m256i vOffset = _mm256_set1_epi32( iOffset );
+  const __m128i vShift  = _mm_cvtsi32_si128( iShift );
+
+  for( Int y = 0; y < iHeight; y++ )
+  {
+    Int x = 0;
+    for( ; x + 16 <= iWidth; x += 16 )
+    {
+      __m256i vSumLo = _mm256_setzero_si256();
+      __m256i vSumHi = _mm256_setzero_si256();
+      for( Int n = 0; n < BIO_FILTER_LENGTH/2; n++ )
+      {
+        const __m256i vPix0 = _mm256_loadu_si256( ( const __m256i* )( piSrc + x + 2 * n * iTapStride ) );
+        const __m256i vPix1 = _mm256_loadu_si256( ( const __m256i* )( piSrc + x + ( 2 * n + 1 ) * iTapStride ) );
+        vSumLo = _mm256_add_epi32( vSumLo, _mm256_madd_epi16( _mm256_unpacklo_epi16( vPix0, vPix1 ), vCoeff[n] ) );
+        vSumHi = _mm256_add_epi32( vSumHi, _mm256_madd_epi16( _mm256_unpackhi_epi16( vPix0, vPix1 ), vCoeff[n] ) );
+      }
+      _mm256_storeu_si256( ( __m256i* )( piDst + x ), _mm256_packs_epi32( simdBioRoundAVX2( vSumLo, vOffset, vShift ), simdBioRoundAVX2( vSumHi, vOffset, vShift ) ) );
+    }
+    for( ; x + 4 <= iWidth; x += ( x + 8 <= iWidth ) ? 8 : 4 )
+    {
+      const Bool b8     = x + 8 <= iWidth;
+      __m128i    vSumLo = _mm_setzero_si128();
+      __m128i    vSumHi = _mm_setzero_si128();
+      for( Int n = 0; n < BIO_FILTER_LENGTH/2; n++ )
+      {
+        const Pel*    p0    = piSrc + x + 2 * n * iTapStride;
+        const Pel*    p1    = p0 + iTapStride;
+        const __m128i vPix0 = b8 ? _mm_loadu_si128( ( const __m128i* )p0 ) : _mm_loadl_epi64( ( const __m128i* )p0 );
+        const __m128i vPix1 = b8 ? _mm_loadu_si128( ( const __m128i* )p1 ) : _mm_loadl_epi64( ( const __m128i* )p1 );
+        vSumLo = _mm_add_epi32( vSumLo, _mm_madd_epi16( _mm_unpacklo_epi16( vPix0, vPix1 ), _mm256_castsi256_si128( vCoeff[n] ) ) );
+        vSumHi = _mm_add_epi32( vSumHi, _mm_madd_epi16( _mm_unpackhi_epi16( vPix0, vPix1 ), _mm256_castsi256_si128( vCoeff[n] ) ) );
+      }
+      const __m128i vRes = _mm_packs_epi32( simdBioRoundAVX2( vSumLo, _mm256_castsi256_si128( vOffset ), vShift ),
+                                            simdBioRoundAVX2( vSumHi, _mm256_castsi256_si128( vOffset ), vShift ) );
+      if( b8 )
+      {
+        _mm_storeu_si128( ( __m128i* )( piDst + x ), vRes );
+      }
+      else
+      {
+        _mm_storel_epi64( ( __m128i* )( piDst + x ), vRes );
+      }
+    }
+    for( ; x < iWidth; x++ )
+    {
+      Int iSum = 0;
+      for( Int n = 0; n < BIO_FILTER_LENGTH; n++ )
+      {
+        iSum += psCoeff[n] * piSrc[x + n * iTapStride];
+      }
+      iSum = ( iSum >= 0 ) ? ( ( iSum + iOffset ) >> iShift ) : -( ( -iSum + iOffset ) >> iShift );
+      piDst[x] = ( Pel )iSum;
+    }
+    piSrc += iSrcStride;
+    piDst += iDstStride;
+  }
+}
+#endif
+
 __inline Void TComPrediction::gradFilter2DVer (Pel* piSrc, Int iSrcStride,  Int iWidth, Int iHeight, Int iDstStride,  
   Pel*& rpiDst, Int iMV, const Int iShift)
 {
@@ -2569,6 +2918,13 @@ __inline Void TComPrediction::gradFilter2DVer (Pel* piSrc, Int iSrcStride,  Int
   Pel*  piSrcTmp5  = piSrcTmp4+iSrcStride;
 
   static const Int iOffSet = iShift>0?(1<<(iShift-1)):0;
+#if AVX_BIO_KERNELS
+  if( m_fpBioFilter )
+  {
+    m_fpBioFilter( piSrc - BIO_FILTER_HALF_LENGTH_MINUS_1*iSrcStride, iSrcStride, iSrcStride, rpiDst, iDstStride, iWidth, iHeight, m_lumaGradientFilter[iMV], iOffSet, iShift );
+    return;
+  }
+#endif
   for ( Int y = iHeight; y != 0; y-- )
   {
 
@@ -2606,6 +2962,13 @@ __inline Void TComPrediction::gradFilter1DVer (Pel* piSrc, Int iSrcStride, Int i
   Pel*  piSrcTmp5  = piSrcTmp4+iSrcStride;
   Int iSum = 0;    
   static const Int iOffSet = 1<<(iShift-1);  
+#if AVX_BIO_KERNELS
+  if( m_fpBioFilter )
+  {
+    m_fpBioFilter( piSrc - BIO_FILTER_HALF_LENGTH_MINUS_1*iSrcStride, iSrcStride, iSrcStride, rpiDst, iDstStride, iWidth, iHeight, m_lumaGradientFilter[iMV], iOffSet, iShift );
+    return;
+  }
+#endif
   for ( Int y = iHeight; y != 0; y-- )
   {
     for ( Int x = 0; x < iWidth; x++ )
@@ -2637,6 +3000,13 @@ __inline Void TComPrediction::gradFilter1DHor(Pel* piSrc, Int iSrcStride, Int iW
   Int   iSum =0;
   Pel*  piSrcTmp;       
   static const Int iOffSet = 1<<(iShift-1);  
+#if AVX_BIO_KERNELS
+  if( m_fpBioFilter )
+  {
+    m_fpBioFilter( piSrc - BIO_FILTER_HALF_LENGTH_MINUS_1, iSrcStride, 1, rpiDst, iDstStride, iWidth, iHeight, m_lumaGradientFilter[iMV], iOffSet, iShift );
+    return;
+  }
+#endif
   for ( Int y = iHeight; y != 0; y-- )
   {
     piSrcTmp = &piSrc[ -BIO_FILTER_HALF_LENGTH_MINUS_1 ];
@@ -2666,6 +3036,13 @@ __inline Void TComPrediction::gradFilter2DHor( Pel* piSrc, Int iSrcStride,  Int
   Pel*  piSrcTmp;
 
   static const Int iOffSet = iShift>0?(1<<(iShift-1)):0;
+#if AVX_BIO_KERNELS
+  if( m_fpBioFilter )
+  {
+    m_fpBioFilter( piSrc - BIO_FILTER_HALF_LENGTH_MINUS_1, iSrcStride, 1, rpiDst, iDstStride, iWidth, iHeight, m_lumaGradientFilter[iMV], iOffSet, iShift );
+    return;
+  }
+#endif
 
   for ( Int y = iHeight; y != 0; y-- )
   {
@@ -2702,6 +3079,13 @@ __inline Void TComPrediction::fracFilter2DVer (Pel* piSrc, Int iSrcStride,  Int
   Pel*  piSrcTmp5  = piSrcTmp4+iSrcStride;
 
   static const Int iOffSet = (iShift>0)?((1<<(iShift-1))-(8192<<iShift)):(-8192);
+#if AVX_BIO_KERNELS
+  if( m_fpBioFilter )
+  {
+    m_fpBioFilter( piSrc - BIO_FILTER_HALF_LENGTH_MINUS_1*iSrcStride, iSrcStride, iSrcStride, rpiDst, iDstStride, iWidth, iHeight, m_lumaInterpolationFilter[iMV], iOffSet, iShift );
+    return;
+  }
+#endif
 
   for ( Int y = iHeight; y != 0; y-- )
   {
@@ -2735,6 +3119,13 @@ __inline Void TComPrediction::fracFilter2DHor( Pel* piSrc, Int iSrcStride,  Int
   Pel*  piSrcTmp;
 
   static const Int iOffSet = iShift>0?(1<<(iShift-1)):0;
+#if AVX_BIO_KERNELS
+  if( m_fpBioFilter )
+  {
+    m_fpBioFilter( piSrc - BIO_FILTER_HALF_LENGTH_MINUS_1, iSrcStride, 1, rpiDst, iDstStride, iWidth, iHeight, m_lumaInterpolationFilter[iMV], iOffSet, iShift );
+    return;
+  }
+#endif
   for ( Int y = iHeight; y != 0; y-- )
   {
     piSrcTmp = &piSrc[ -BIO_FILTER_HALF_LENGTH_MINUS_1 ];
@@ -3195,7 +3586,11 @@ Void TComPrediction::subBlockOBMC( TComDataCU*  pcCU, UInt uiAbsPartIdx, TComYuv
 #endif
   Bool bTwoPUs  = ( bVerticalPU || bHorizonalPU );
 #endif
+#if OBMC_RUN_PREDICTION
+  Int  iCurPredDir = 0;
+#else
   Int  iNeigPredDir = 0, iCurPredDir = 0;
+#endif
 #if JVET_C0024_QTBT && COM16_C1016_AFFINE
   Bool isCurAffine;
 #endif
@@ -3252,7 +3647,11 @@ Void TComPrediction::subBlockOBMC( TComDataCU*  pcCU, UInt uiAbsPartIdx, TComYuv
 
   Bool bCurrMotStored = false, bDiffMot[4]= { false, false, false, false };
 #endif
+#if OBMC_RUN_PREDICTION
+  TComMvField cCurMvField[2];
+#else
   TComMvField cCurMvField[2], cNeigMvField[2];
+#endif
 
   Int maxDir = bNormal2Nx2N ? 2 : 4;
   for( Int iSubX = 0; iSubX < uiWidthInBlock; iSubX += uiStep )
@@ -3271,6 +3670,9 @@ Void TComPrediction::subBlockOBMC( TComDataCU*  pcCU, UInt uiAbsPartIdx, TComYuv
 
       for( Int iDir = 0; iDir < maxDir; iDir++ ) //iDir: 0 - above, 1 - left, 2 - below, 3 - right
       {
+#if OBMC_RUN_PREDICTION
+        m_acOBMCNeigMotion[iDir][iSubX + iSubY*uiWidthInBlock].bValid = false;
+#endif
         if( ( iDir == 3 && bCURBoundary ) || ( iDir == 2 && bCUBBoundary ) )
         {
           continue;
@@ -3347,6 +3749,12 @@ Void TComPrediction::subBlockOBMC( TComDataCU*  pcCU, UInt uiAbsPartIdx, TComYuv
 #if JVET_B0038_AFFINE_HARMONIZATION
         bSubBlockOBMCSimp |= ( bOBMCSimp || pcCU->getAffineFlag( uiSubPartIdx ) );
 #endif
+#if OBMC_RUN_PREDICTION
+        OBMCNeigMotion& rcNeig = m_acOBMCNeigMotion[iDir][iSubX + iSubY*uiWidthInBlock];
+        rcNeig.bValid     = pcCU->getNeigMotion( uiSubPartIdx, rcNeig.acMvField, rcNeig.iPredDir, iDir, cCurMvField, iCurPredDir, uiZeroIdx, bCurrMotStored );
+        rcNeig.bPredicted = false;
+        rcNeig.bSimp      = bSubBlockOBMCSimp;
+#else
 #if JVET_C0024_QTBT
         if( pcCU->getNeigMotion( uiSubPartIdx, cNeigMvField, iNeigPredDir, iDir, cCurMvField, iCurPredDir, uiZeroIdx, bCurrMotStored ) )
 #else
@@ -3434,11 +3842,196 @@ Void TComPrediction::subBlockOBMC( TComDataCU*  pcCU, UInt uiAbsPartIdx, TComYuv
           }
 #endif
         }
+#endif
       }
     }
   }
+#if OBMC_RUN_PREDICTION
+
+  // predict each run of adjacent boundaries of a row (above, below) or column (left, right) sharing a neighbouring motion at once,
+  // and blend in the order of the boundaries; each direction has its own buffer as the boundaries of a sub-block are blended one after another
+  TComYuv* apcYuvNeigPred[4] = { pcYuvTmpPred1, pcYuvTmpPred2, &m_acYuvPredOBMC[0], &m_acYuvPredOBMC[1] };
+  for( Int iSubX = 0; iSubX < uiWidthInBlock; iSubX += uiStep )
+  {
+    for( Int iSubY = 0; iSubY < uiHeightInBlock; iSubY += uiStep )
+    {
+      if( bNormal2Nx2N && iSubX && iSubY )
+      {
+        continue;
+      }
+      uiSubPartIdx = g_auiRasterToZscan[uiAbsPartIdxLCURaster + iSubX + iSubY*uiMaxWidthInBlock] - uiZeroIdx;
+
+      for( Int iDir = 0; iDir < maxDir; iDir++ )
+      {
+        const OBMCNeigMotion& rcNeig = m_acOBMCNeigMotion[iDir][iSubX + iSubY*uiWidthInBlock];
+        if( !rcNeig.bValid )
+        {
+          continue;
+        }
+
+        if( !rcNeig.bPredicted )
+        {
+          const Bool bRow = ( iDir & 1 ) == 0;
+          Int iRunLength  = uiStep;
+          for( Int iNext = ( bRow ? iSubX : iSubY ) + uiStep; iNext < ( bRow ? uiWidthInBlock : uiHeightInBlock ); iNext += uiStep )
+          {
+            OBMCNeigMotion& rcNext = m_acOBMCNeigMotion[iDir][bRow ? iNext + iSubY*uiWidthInBlock : iSubX + iNext*uiWidthInBlock];
+            if( !rcNext.bValid || rcNext.iPredDir != rcNeig.iPredDir || !( rcNext.acMvField[0] == rcNeig.acMvField[0] ) || !( rcNext.acMvField[1] == rcNeig.acMvField[1] ) )
+            {
+              break;
+            }
+            rcNext.bPredicted = true;
+            iRunLength       += uiStep;
+          }
+
+          //store temporary motion information
+#if COM16_C1016_AFFINE
+          isCurAffine = pcCU->getAffineFlag( uiSubPartIdx );
+          pcCU->setAffineFlag( uiSubPartIdx, false );
+#endif
+          iCurPredDir = pcCU->getInterDir( uiSubPartIdx );
+          for( UInt uiRefList = 0; uiRefList < NUM_REF_PIC_LIST_01; uiRefList++ )
+          {
+            TComCUMvField* pcCUMvField = pcCU->getCUMvField( RefPicList( uiRefList ) );
+            cCurMvField[uiRefList].setMvField( pcCUMvField->getMv( uiSubPartIdx ), pcCUMvField->getRefIdx( uiSubPartIdx ) );
+            pcCUMvField->setMv    ( rcNeig.acMvField[uiRefList].getMv(),     uiSubPartIdx );
+            pcCUMvField->setRefIdx( rcNeig.acMvField[uiRefList].getRefIdx(), uiSubPartIdx );
+          }
+          pcCU->setInterDir( uiSubPartIdx, rcNeig.iPredDir );
+
+          xSubBlockMotionCompensation( pcCU, apcYuvNeigPred[iDir], uiSubPartIdx, bRow ? iRunLength*uiMinCUW : uiOBMCBlkSize, bRow ? uiOBMCBlkSize : iRunLength*uiMinCUW );
+
+          //recover motion information
+#if COM16_C1016_AFFINE
+          pcCU->setAffineFlag( uiSubPartIdx, isCurAffine );
+#endif
+          for( UInt uiRefList = 0; uiRefList < NUM_REF_PIC_LIST_01; uiRefList++ )
+          {
+            pcCU->getCUMvField( RefPicList( uiRefList ) )->setMv    ( cCurMvField[uiRefList].getMv(),     uiSubPartIdx );
+            pcCU->getCUMvField( RefPicList( uiRefList ) )->setRefIdx( cCurMvField[uiRefList].getRefIdx(), uiSubPartIdx );
+          }
+          pcCU->setInterDir( uiSubPartIdx, iCurPredDir );
+        }
+
+        if( bOBMC4ME )
+        {
+          xSubtractOBMC( pcCU, uiSubPartIdx, pcYuvPred, apcYuvNeigPred[iDir], uiOBMCBlkSize, uiOBMCBlkSize, iDir, rcNeig.bSimp );
+        }
+        else
+        {
+          xSubblockOBMC( COMPONENT_Y, pcCU, uiSubPartIdx, pcYuvPred, apcYuvNeigPred[iDir], uiOBMCBlkSize, uiOBMCBlkSize, iDir, rcNeig.bSimp );
+          xSubblockOBMC( COMPONENT_Cb, pcCU, uiSubPartIdx, pcYuvPred, apcYuvNeigPred[iDir], uiChromaOBMCWidth, uiChromaOBMCHeight, iDir, rcNeig.bSimp );
+          xSubblockOBMC( COMPONENT_Cr, pcCU, uiSubPartIdx, pcYuvPred, apcYuvNeigPred[iDir], uiChromaOBMCWidth, uiChromaOBMCHeight, iDir, rcNeig.bSimp );
+        }
+      }
+    }
+  }
+#endif
 }
 
+#if AVX_OBMC_KERNELS
+/** Blends up to four 16-bit samples as dst + ( ( src - dst + ( 1 << ( k - 1 ) ) ) >> k ), which is ( dst * ( 2^k - 1 ) + src + 2^(k-1) ) >> k
+ *  of xSubblockOBMC, with a shift k per lane
+ */
+__attribute__((target("avx2")))
+static inline __m128i simdOBMCBlendAVX2( __m128i vDst, __m128i vSrc, __m128i vShift )
+{
+  const __m128i vRound = _mm_srli_epi32( _mm_sllv_epi32( _mm_set1_epi32( 1 ), vShift ), 1 );
+  vDst = _mm_cvtepi16_epi32( vDst );
+  vSrc = _mm_cvtepi16_epi32( vSrc );
+  vDst = _mm_add_epi32( vDst, _mm_srav_epi32( _mm_add_epi32( _mm_sub_epi32( vSrc, vDst ), vRound ), vShift ) );
+  return _mm_packs_epi32( vDst, vDst );
+}
+
+/** AVX2 kernel of xSubblockOBMC: blends the iNumLines rows (above, below) or columns (left, right) of a sub-block next to the boundary
+ *  iDir with the prediction made with the neighbouring motion, with the weights 1/4, 1/8, 1/16 and 1/32 from the boundary inwards
+ *  \param pDst      current prediction, blended in place
+ *  \param pSrc      prediction with the neighbouring motion
+ *  \param iDir      boundary: 0 above, 1 left, 2 below, 3 right
+ *  \param iNumLines number of rows or columns blended, 1 to 4
+ */
+__attribute__((target("avx2")))
+static Void simdSubblockOBMCAVX2( Pel* pDst, Int iDstStride, const Pel* pSrc, Int iSrcStride, Int iWidth, Int iHeight, Int iDir, Int iNumLines )
+{
+  if( ( iDir & 1 ) == 0 )
+  {
+    for( Int k = 0; k < iNumLines; k++ )
+    {
+      const Int     iRow   = iDir == 0 ? k : iHeight - 1 - k;
+      Pel*          pD     = pDst + iRow * iDstStride;
+      const Pel*    pS     = pSrc + iRow * iSrcStride;
+      const __m128i vShift = _mm_set1_epi32( k + 2 );
+      Int x = 0;
+      for( ; x + 4 <= iWidth; x += 4 )
+      {
+        _mm_storel_epi64( ( __m128i* )( pD + x ), simdOBMCBlendAVX2( _mm_loadl_epi64( ( const __m128i* )( pD + x ) ), _mm_loadl_epi64( ( const __m128i* )( pS + x ) ), vShift ) );
+      }
+      for( ; x + 2 <= iWidth; x += 2 )
+      {
+        _mm_storeu_si32( pD + x, simdOBMCBlendAVX2( _mm_loadu_si32( pD + x ), _mm_loadu_si32( pS + x ), vShift ) );
+      }
+      if( x < iWidth )
+      {
+        pD[x] = pD[x] + ( ( pS[x] - pD[x] + ( 1 << ( k + 1 ) ) ) >> ( k + 2 ) );
+      }
+    }
+    return;
+  }
+
+  // lane j of a row is the column iX0 + j, j columns (left) or iNumLines - 1 - j columns (right) away from the boundary
+  const Int iX0 = iDir == 1 ? 0 : iWidth - iNumLines;
+  if( iNumLines == 1 )
+  {
+    for( Int y = 0; y < iHeight; y++ )
+    {
+      Pel& rD = pDst[y * iDstStride + iX0];
+      rD = rD + ( ( pSrc[y * iSrcStride + iX0] - rD + 2 ) >> 2 );
+    }
+    return;
+  }
+  const __m128i vShift = iDir == 1 ? _mm_setr_epi32( 2, 3, 4, 5 ) : iNumLines == 4 ? _mm_setr_epi32( 5, 4, 3, 2 ) : _mm_setr_epi32( 3, 2, 0, 0 );
+  for( Int y = 0; y < iHeight; y++ )
+  {
+    Pel*       pD = pDst + y * iDstStride + iX0;
+    const Pel* pS = pSrc + y * iSrcStride + iX0;
+    if( iNumLines == 4 )
+    {
+      _mm_storel_epi64( ( __m128i* )pD, simdOBMCBlendAVX2( _mm_loadl_epi64( ( const __m128i* )pD ), _mm_loadl_epi64( ( const __m128i* )pS ), vShift ) );
+    }
+    else
+    {
+      _mm_storeu_si32( pD, simdOBMCBlendAVX2( _mm_loadu_si32( pD ), _mm_loadu_si32( pS ), vShift ) );
+    }
+  }
+}
+#endif
+
+#if SIMD_AVX2_BIO
+Void (*TComPrediction::m_fpBioFilter)( const Pel* piSrc, Int iSrcStride, Int iTapStride, Pel* piDst, Int iDstStride, Int iWidth, Int iHeight, const Short* psCoeff, Int iOffset, Int iShift ) = NULL;
+Void (*TComPrediction::m_fpBioAverage)( const Pel* pSrc0, const Pel* pSrc1, const Pel* pGradX0, const Pel* pGradX1, const Pel* pGradY0, const Pel* pGradY1,
+                                        Int iWidth, Int iHeight, Int iScale0, Int iScale1, Pel* pDst, Int iDstStride, Double* pdBuf,
+                                        Int iShiftNum, Int iOffset, Int64 iLimit, Int64 iDenomMin1, Int64 iDenomMin2, Int64 iRegularizator1, Int64 iRegularizator2,
+                                        Int iMinVal, Int iMaxVal ) = NULL;
+#endif
+#if SIMD_AVX2_OBMC
+Void (*TComPrediction::m_fpSubblockOBMC)( Pel* pDst, Int iDstStride, const Pel* pSrc, Int iSrcStride, Int iWidth, Int iHeight, Int iDir, Int iNumLines ) = NULL;
+#endif
+
+#if SIMD_AVX2_BIO || SIMD_AVX2_OBMC
+/** Select the BIO and OBMC kernels of a SIMD level, called once at start-up by initSimdLevel()
+ */
+Void TComPrediction::initSimdKernels( SimdLevel eLevel )
+{
+#if AVX_BIO_KERNELS
+  m_fpBioFilter     = eLevel >= SIMD_AVX2 ? simdBioFilterAVX2  : NULL;
+  m_fpBioAverage    = eLevel >= SIMD_AVX2 ? simdBioAverageAVX2 : NULL;
+#endif
+#if AVX_OBMC_KERNELS
+  m_fpSubblockOBMC  = eLevel >= SIMD_AVX2 ? simdSubblockOBMCAVX2 : NULL;
+#endif
+}
+#endif
+
 // Function for (weighted) averaging predictors of current block and predictors generated by applying neighboring motions to current block.
 Void TComPrediction::xSubblockOBMC( const ComponentID eComp, TComDataCU* pcCU, Int uiAbsPartIdx, TComYuv* pcYuvPredDst, TComYuv* pcYuvPredSrc, Int iWidth, Int iHeight, Int iDir, Bool bOBMCSimp )
 {
@@ -3454,6 +4047,15 @@ Void TComPrediction::xSubblockOBMC( const ComponentID eComp, TComDataCU* pcCU, I
   Pel *pDst   = pcYuvPredDst->getAddr( eComp, uiAbsPartIdx );
   Pel *pSrc   = pcYuvPredSrc->getAddr( eComp, uiAbsPartIdx );
 
+#if AVX_OBMC_KERNELS
+  if( m_fpSubblockOBMC )
+  {
+    const Int iNumLines = eComp == COMPONENT_Y ? ( bOBMCSimp ? 2 : 4 ) : ( bOBMCSimp ? 1 : 2 );
+    m_fpSubblockOBMC( pDst, iDstStride, pSrc, iSrcStride, iWidth, iHeight, iDir, iNumLines );
+    return;
+  }
+#endif
+
   Int iDstPtrOffset = iDstStride, iScrPtrOffset = iSrcStride, ioffsetDst = 1, ioffsetSrc = 1;
 
   if( iDir ) //0: above; 1:left; 2: below; 3:right
@@ -3694,6 +4296,111 @@ Void TComPrediction::xSubBlockMotionCompensation ( TComDataCU* pcCU, TComYuv* pc
 
 #if VCEG_AZ07_FRUC_MERGE
 
+#if FRUC_FLAT_START_MV_LIST
+TComFrucMvFieldSet::TComFrucMvFieldSet()
+: m_pcMvField   ( NULL )
+, m_iSize       ( 0 )
+, m_iCapacity   ( 0 )
+, m_piSlotIdx   ( NULL )
+, m_puiSlotStamp( NULL )
+, m_uiSlotMask  ( 0 )
+, m_uiStamp     ( 0 )
+{
+}
+
+/**
+ * \brief allocate the set
+ *
+ * \param iCapacity       Max number of Mv fields
+ */
+Void TComFrucMvFieldSet::create( Int iCapacity )
+{
+  destroy();
+  UInt uiNumSlots = 1;
+  while( uiNumSlots < 2 * ( UInt )iCapacity )
+  {
+    uiNumSlots <<= 1;
+  }
+  m_iCapacity    = iCapacity;
+  m_pcMvField    = new TComMvField[iCapacity];
+  m_piSlotIdx    = new Int [uiNumSlots];
+  m_puiSlotStamp = new UInt[uiNumSlots];
+  m_uiSlotMask   = uiNumSlots - 1;
+  ::memset( m_puiSlotStamp , 0 , sizeof( UInt ) * uiNumSlots );
+  m_uiStamp      = 1;
+  m_iSize        = 0;
+}
+
+Void TComFrucMvFieldSet::destroy()
+{
+  delete [] m_pcMvField;
+  delete [] m_piSlotIdx;
+  delete [] m_puiSlotStamp;
+  m_pcMvField    = NULL;
+  m_piSlotIdx    = NULL;
+  m_puiSlotStamp = NULL;
+  m_iCapacity    = 0;
+  m_iSize        = 0;
+}
+
+/**
+ * \brief empty the set, the hash slots are freed by moving to the next stamp
+ */
+Void TComFrucMvFieldSet::clear()
+{
+  m_iSize = 0;
+  if( ++m_uiStamp == 0 )
+  {
+    ::memset( m_puiSlotStamp , 0 , sizeof( UInt ) * ( m_uiSlotMask + 1 ) );
+    m_uiStamp = 1;
+  }
+}
+
+/**
+ * \brief get the hash slot holding a Mv field, or the free slot where it would be inserted
+ *
+ * \param rMvField        Mv info
+ */
+UInt TComFrucMvFieldSet::xGetSlot( const TComMvField & rMvField ) const
+{
+  UInt uiKey = ( ( UInt )( UShort )rMvField.getHor() ) | ( ( UInt )( UShort )rMvField.getVer() << 16 );
+  uiKey = ( uiKey ^ ( ( UInt )rMvField.getRefIdx() * 0x9E3779B9u ) ) * 0x85EBCA6Bu;
+  UInt uiSlot = ( uiKey ^ ( uiKey >> 15 ) ) & m_uiSlotMask;
+  while( m_puiSlotStamp[uiSlot] == m_uiStamp && !( m_pcMvField[m_piSlotIdx[uiSlot]] == rMvField ) )
+  {
+    uiSlot = ( uiSlot + 1 ) & m_uiSlotMask;
+  }
+  return( uiSlot );
+}
+
+/**
+ * \brief append a Mv field unless it is already in the set
+ *
+ * \param rMvField        Mv info
+ */
+Void TComFrucMvFieldSet::insert( const TComMvField & rMvField )
+{
+  const UInt uiSlot = xGetSlot( rMvField );
+  if( m_puiSlotStamp[uiSlot] != m_uiStamp )
+  {
+    assert( m_iSize < m_iCapacity );
+    m_puiSlotStamp[uiSlot] = m_uiStamp;
+    m_piSlotIdx[uiSlot]    = m_iSize;
+    m_pcMvField[m_iSize++] = rMvField;
+  }
+}
+
+/**
+ * \brief whether a Mv field is in the set
+ *
+ * \param rMvField        Mv info
+ */
+Bool TComFrucMvFieldSet::contains( const TComMvField & rMvField ) const
+{
+  return( m_puiSlotStamp[xGetSlot( rMvField )] == m_uiStamp );
+}
+#endif
+
 static const Int FRUC_MERGE_MV_SEARCHPATTERN_CROSS    = 0;
 static const Int FRUC_MERGE_MV_SEARCHPATTERN_SQUARE   = 1;
 static const Int FRUC_MERGE_MV_SEARCHPATTERN_DIAMOND  = 2;
@@ -3728,6 +4435,12 @@ UInt TComPrediction::xFrucGetTempMatchCost( TComDataCU * pcCU , UInt uiAbsPartId
   {
     TComMv mvTop( 0 , - ( FRUC_MERGE_TEMPLATE_SIZE << nMVUnit ) );
     mvTop += rCurMvField.getMv();
+#if FRUC_INTERP_WINDOW_CACHE
+    Int nRefStride;
+    Pel * pRef = xFrucGetPredBlk( pcCU , uiAbsPartIdx , pRefPicYuv , mvTop , nWidth , FRUC_MERGE_TEMPLATE_SIZE , pYuvPredRefTop , FRUC_MERGE_TEMPLATE , nRefStride );
+    m_cFRUCRDCost.setDistParam( cDistParam , pcCU->getSlice()->getSPS()->getBitDepth(CHANNEL_TYPE_LUMA) , pYuvPredCurTop->getAddr( COMPONENT_Y , 0 ) , pYuvPredCurTop->getStride( COMPONENT_Y ) ,
+      pRef , nRefStride , nWidth , FRUC_MERGE_TEMPLATE_SIZE , false );
+#else
     xPredInterBlk( COMPONENT_Y , pcCU , pRefPicYuv , uiAbsPartIdx , &mvTop , nWidth , FRUC_MERGE_TEMPLATE_SIZE , pYuvPredRefTop , false , pcCU->getSlice()->getSPS()->getBitDepth( CHANNEL_TYPE_LUMA ) , 
 #if VCEG_AZ05_BIO
       false,
@@ -3735,6 +4448,7 @@ UInt TComPrediction::xFrucGetTempMatchCost( TComDataCU * pcCU , UInt uiAbsPartId
       FRUC_MERGE_TEMPLATE );
     m_cFRUCRDCost.setDistParam( cDistParam , pcCU->getSlice()->getSPS()->getBitDepth(CHANNEL_TYPE_LUMA) , pYuvPredCurTop->getAddr( COMPONENT_Y , 0 ) , pYuvPredCurTop->getStride( COMPONENT_Y ) ,
       pYuvPredRefTop->getAddr( COMPONENT_Y , 0 ) , pYuvPredRefTop->getStride( COMPONENT_Y ) , nWidth , FRUC_MERGE_TEMPLATE_SIZE , false );
+#endif
 #if VCEG_AZ06_IC
     cDistParam.bMRFlag = pcCU->getICFlag( uiAbsPartIdx );
 #endif
@@ -3745,6 +4459,12 @@ UInt TComPrediction::xFrucGetTempMatchCost( TComDataCU * pcCU , UInt uiAbsPartId
   {
     TComMv mvLeft( - ( FRUC_MERGE_TEMPLATE_SIZE << nMVUnit ) , 0 );
     mvLeft += rCurMvField.getMv();
+#if FRUC_INTERP_WINDOW_CACHE
+    Int nRefStride;
+    Pel * pRef = xFrucGetPredBlk( pcCU , uiAbsPartIdx , pRefPicYuv , mvLeft , FRUC_MERGE_TEMPLATE_SIZE , nHeight , pYuvPredRefLeft , FRUC_MERGE_TEMPLATE , nRefStride );
+    m_cFRUCRDCost.setDistParam( cDistParam , pcCU->getSlice()->getSPS()->getBitDepth(CHANNEL_TYPE_LUMA) , pYuvPredCurLeft->getAddr( COMPONENT_Y , 0 ) , pYuvPredCurLeft->getStride( COMPONENT_Y ) ,
+      pRef , nRefStride , FRUC_MERGE_TEMPLATE_SIZE , nHeight , false );
+#else
     xPredInterBlk( COMPONENT_Y , pcCU , pRefPicYuv , uiAbsPartIdx , &mvLeft , FRUC_MERGE_TEMPLATE_SIZE , nHeight , pYuvPredRefLeft , false , pcCU->getSlice()->getSPS()->getBitDepth( CHANNEL_TYPE_LUMA ) , 
 #if VCEG_AZ05_BIO
       false,
@@ -3752,6 +4472,7 @@ UInt TComPrediction::xFrucGetTempMatchCost( TComDataCU * pcCU , UInt uiAbsPartId
       FRUC_MERGE_TEMPLATE );
     m_cFRUCRDCost.setDistParam( cDistParam , pcCU->getSlice()->getSPS()->getBitDepth(CHANNEL_TYPE_LUMA) , pYuvPredCurLeft->getAddr( COMPONENT_Y , 0 ) , pYuvPredCurLeft->getStride( COMPONENT_Y ) ,
       pYuvPredRefLeft->getAddr( COMPONENT_Y , 0 ) , pYuvPredRefLeft->getStride( COMPONENT_Y ) , FRUC_MERGE_TEMPLATE_SIZE , nHeight , false );
+#endif
 #if VCEG_AZ06_IC
     cDistParam.bMRFlag = pcCU->getICFlag( uiAbsPartIdx );
 #endif
@@ -3786,6 +4507,15 @@ UInt TComPrediction::xFrucGetBilaMatchCost( TComDataCU * pcCU , UInt uiAbsPartId
     TComYuv * pYuvPredB = &m_acYuvPred[1];
     TComMv mvOffset( 0 , 0 );
     TComMv mvAp = rCurMvField.getMv() + mvOffset;
+#if FRUC_INTERP_WINDOW_CACHE
+    TComMv mvBp = rPairMVField.getMv() + mvOffset;
+    Int nStrideA , nStrideB;
+    Pel * pPredA = xFrucGetPredBlk( pcCU , uiAbsPartIdx , pRefPicYuvA , mvAp , nWidth , nHeight , pYuvPredA , FRUC_MERGE_BILATERALMV , nStrideA );
+    Pel * pPredB = xFrucGetPredBlk( pcCU , uiAbsPartIdx , pRefPicYuvB , mvBp , nWidth , nHeight , pYuvPredB , FRUC_MERGE_BILATERALMV , nStrideB );
+    DistParam cDistParam;
+    cDistParam.bApplyWeight = false;
+    m_cFRUCRDCost.setDistParam( cDistParam , pcCU->getSlice()->getSPS()->getBitDepth( CHANNEL_TYPE_LUMA ) , pPredA , nStrideA , pPredB , nStrideB , nWidth , nHeight , false );
+#else
     xPredInterBlk( COMPONENT_Y , pcCU , pRefPicYuvA , uiAbsPartIdx , &mvAp , nWidth , nHeight , pYuvPredA , false , pcCU->getSlice()->getSPS()->getBitDepth( CHANNEL_TYPE_LUMA ) 
 #if VCEG_AZ05_BIO                  
       ,false
@@ -3801,6 +4531,7 @@ UInt TComPrediction::xFrucGetBilaMatchCost( TComDataCU * pcCU , UInt uiAbsPartId
     cDistParam.bApplyWeight = false;
     m_cFRUCRDCost.setDistParam( cDistParam , pcCU->getSlice()->getSPS()->getBitDepth( CHANNEL_TYPE_LUMA ) , pYuvPredA->getAddr( COMPONENT_Y , 0 ) , pYuvPredA->getStride( COMPONENT_Y ) ,
       pYuvPredB->getAddr( COMPONENT_Y , 0 ) , pYuvPredB->getStride( COMPONENT_Y ) , nWidth , nHeight , false );
+#endif
 #if VCEG_AZ06_IC
     cDistParam.bMRFlag = pcCU->getICFlag( uiAbsPartIdx );
 #endif
@@ -3810,6 +4541,132 @@ UInt TComPrediction::xFrucGetBilaMatchCost( TComDataCU * pcCU , UInt uiAbsPartId
   return( uiCost );
 }
 
+#if FRUC_INTERP_WINDOW_CACHE
+/**
+ * \brief forget the interpolated windows, the reference pictures may have changed
+ */
+Void TComPrediction::xFrucResetInterpWindows()
+{
+  m_iFrucWindowNum = 0;
+  m_uiFrucWindowClock = 0;
+}
+
+/**
+ * \brief get the luma prediction of a block for the FRUC matching costs, from the window interpolated at the same
+ *        fractional phase of the reference picture if it covers the block, or from a new window otherwise
+ *
+ * \param pcCU            Pointer to current CU
+ * \param uiAbsPartIdx    Address of block within CU
+ * \param pcRefPic        Reference picture
+ * \param cMv             Mv of the block
+ * \param nWidth          Width of the block
+ * \param nHeight         Height of the block
+ * \param pcYuvPred       Buffer the block is predicted into when no window can be placed around it
+ * \param nFRUCMode       FRUC mode the prediction is made for
+ * \param rnStride        Returns the stride of the prediction
+ */
+Pel* TComPrediction::xFrucGetPredBlk( TComDataCU * pcCU , UInt uiAbsPartIdx , TComPicYuv * pcRefPic , TComMv cMv , Int nWidth , Int nHeight , TComYuv * pcYuvPred , Int nFRUCMode , Int & rnStride )
+{
+  const Int nBitDepth = pcCU->getSlice()->getSPS()->getBitDepth( CHANNEL_TYPE_LUMA );
+  pcCU->clipMv( cMv );
+
+  // position of the block in the reference picture, as addressed by xPredInterBlk
+  const Int nShift   = 2 + VCEG_AZ07_MV_ADD_PRECISION_BIT_FOR_STORE;
+  const Int nStride  = pcRefPic->getStride( COMPONENT_Y );
+  const Int nMarginX = pcRefPic->getMarginX( COMPONENT_Y );
+  const Int nMarginY = pcRefPic->getMarginY( COMPONENT_Y );
+  const Int nBlkOffset = ( Int )( pcRefPic->getAddr( COMPONENT_Y , pcCU->getCtuRsAddr() , pcCU->getZorderIdxInCtu() + uiAbsPartIdx ) - pcRefPic->getAddr( COMPONENT_Y ) );
+  const Int nFracX = cMv.getHor() & ( ( 1 << nShift ) - 1 );
+  const Int nFracY = cMv.getVer() & ( ( 1 << nShift ) - 1 );
+  const Int nPosX  = nBlkOffset % nStride + ( cMv.getHor() >> nShift );
+  const Int nPosY  = nBlkOffset / nStride + ( cMv.getVer() >> nShift );
+
+  for( Int n = 0 ; n < m_iFrucWindowNum ; n++ )
+  {
+    FrucInterpWindow & rWin = m_acFrucWindow[n];
+    if( rWin.pcRefPic == pcRefPic && rWin.iFracX == nFracX && rWin.iFracY == nFracY
+      && nPosX >= rWin.iPosX && nPosX + nWidth <= rWin.iPosX + rWin.iWidth && nPosY >= rWin.iPosY && nPosY + nHeight <= rWin.iPosY + rWin.iHeight )
+    {
+      rWin.uiLastUse = ++m_uiFrucWindowClock;
+      rnStride = rWin.iWidth;
+      return( &rWin.cSamples[( nPosY - rWin.iPosY ) * rWin.iWidth + nPosX - rWin.iPosX] );
+    }
+  }
+
+  // new window, kept far enough from the edges of the padded picture for the filter taps
+  const Int nWinX0 = std::max( nPosX - FRUC_INTERP_WINDOW_MARGIN_HOR , NTAPS_LUMA - nMarginX );
+  const Int nWinY0 = std::max( nPosY - FRUC_INTERP_WINDOW_MARGIN_VER , NTAPS_LUMA - nMarginY );
+  const Int nWinX1 = std::min( nPosX + nWidth  + FRUC_INTERP_WINDOW_MARGIN_HOR , pcRefPic->getWidth( COMPONENT_Y )  + nMarginX - NTAPS_LUMA );
+  const Int nWinY1 = std::min( nPosY + nHeight + FRUC_INTERP_WINDOW_MARGIN_VER , pcRefPic->getHeight( COMPONENT_Y ) + nMarginY - NTAPS_LUMA );
+  if( nWinX0 > nPosX || nWinY0 > nPosY || nWinX1 < nPosX + nWidth || nWinY1 < nPosY + nHeight )
+  {
+    xPredInterBlk( COMPONENT_Y , pcCU , pcRefPic , uiAbsPartIdx , &cMv , nWidth , nHeight , pcYuvPred , false , nBitDepth , 
+#if VCEG_AZ05_BIO
+      false,
+#endif
+      nFRUCMode );
+    rnStride = pcYuvPred->getStride( COMPONENT_Y );
+    return( pcYuvPred->getAddr( COMPONENT_Y , 0 ) );
+  }
+
+  Int nSlot = m_iFrucWindowNum;
+  if( nSlot == FRUC_INTERP_WINDOW_NUM )
+  {
+    nSlot = 0;
+    for( Int n = 1 ; n < FRUC_INTERP_WINDOW_NUM ; n++ )
+    {
+      if( m_acFrucWindow[n].uiLastUse < m_acFrucWindow[nSlot].uiLastUse )
+      {
+        nSlot = n;
+      }
+    }
+  }
+  else
+  {
+    m_iFrucWindowNum++;
+  }
+  FrucInterpWindow & rWin = m_acFrucWindow[nSlot];
+  rWin.pcRefPic  = pcRefPic;
+  rWin.iFracX    = nFracX;
+  rWin.iFracY    = nFracY;
+  rWin.iPosX     = nWinX0;
+  rWin.iPosY     = nWinY0;
+  rWin.iWidth    = nWinX1 - nWinX0;
+  rWin.iHeight   = nWinY1 - nWinY0;
+  rWin.uiLastUse = ++m_uiFrucWindowClock;
+  if( rWin.cSamples.size() < ( size_t )( rWin.iWidth * rWin.iHeight ) )
+  {
+    rWin.cSamples.resize( rWin.iWidth * rWin.iHeight );
+  }
+
+  // same filtering as xPredInterBlk for a uni-predicted luma block
+  const ChromaFormat chFmt = pcCU->getPic()->getChromaFormat();
+  const Int nFilterIdx = pcCU->getSlice()->getSPS()->getFRUCRefineFilter();
+  Pel * pSrc = pcRefPic->getAddr( COMPONENT_Y ) + nWinY0 * nStride + nWinX0;
+  Pel * pDst = &rWin.cSamples[0];
+  if( nFracY == 0 )
+  {
+    m_if.filterHor( COMPONENT_Y , pSrc , nStride , pDst , rWin.iWidth , rWin.iWidth , rWin.iHeight , nFracX , true , chFmt , nBitDepth , nFilterIdx );
+  }
+  else if( nFracX == 0 )
+  {
+    m_if.filterVer( COMPONENT_Y , pSrc , nStride , pDst , rWin.iWidth , rWin.iWidth , rWin.iHeight , nFracY , true , true , chFmt , nBitDepth , nFilterIdx );
+  }
+  else
+  {
+    const Int nTmpStride = m_filteredBlockTmp[0].getStride( COMPONENT_Y );
+    Pel * pTmp = m_filteredBlockTmp[0].getAddr( COMPONENT_Y );
+    const Int nFilterSize = nFilterIdx == 1 ? NTAPS_LUMA_FRUC : NTAPS_LUMA;
+    assert( rWin.iWidth <= nTmpStride && rWin.iHeight + nFilterSize - 1 <= ( Int )m_filteredBlockTmp[0].getHeight( COMPONENT_Y ) );
+    m_if.filterHor( COMPONENT_Y , pSrc - ( ( nFilterSize >> 1 ) - 1 ) * nStride , nStride , pTmp , nTmpStride , rWin.iWidth , rWin.iHeight + nFilterSize - 1 , nFracX , false , chFmt , nBitDepth , nFilterIdx );
+    m_if.filterVer( COMPONENT_Y , pTmp + ( ( nFilterSize >> 1 ) - 1 ) * nTmpStride , nTmpStride , pDst , rWin.iWidth , rWin.iWidth , rWin.iHeight , nFracY , false , true , chFmt , nBitDepth , nFilterIdx );
+  }
+
+  rnStride = rWin.iWidth;
+  return( &rWin.cSamples[( nPosY - nWinY0 ) * rWin.iWidth + nPosX - nWinX0] );
+}
+#endif
+
 /**
  * \brief refine Mv for a block with bilateral matching or template matching and return the min cost so far
  *
@@ -4243,6 +5100,12 @@ Bool TComPrediction::xFrucRefineSubBlkMv( TComDataCU * pCU , UInt uiDepth , UInt
  * \param rMvField        Mv info
  * \param rList           Temp list of Mv
  */
+#if FRUC_FLAT_START_MV_LIST
+Bool TComPrediction::xFrucIsInList( const TComMvField & rMvField , const TComFrucMvFieldSet & rList )
+{
+  return( rList.contains( rMvField ) );
+}
+#else
 Bool TComPrediction::xFrucIsInList( const TComMvField & rMvField , std::list<TComMvField> & rList )
 {
   std::list<TComMvField>::iterator pos = rList.begin();
@@ -4254,6 +5117,7 @@ Bool TComPrediction::xFrucIsInList( const TComMvField & rMvField , std::list<TCo
   }
   return( false );
 }
+#endif
 
 /**
  * \brief Insert a Mv to the list to be checked
@@ -4261,12 +5125,20 @@ Bool TComPrediction::xFrucIsInList( const TComMvField & rMvField , std::list<TCo
  * \param rMvField        Mv info
  * \param rList           Temp list of Mv
  */
+#if FRUC_FLAT_START_MV_LIST
+Void TComPrediction::xFrucInsertMv2StartList( const TComMvField & rMvField , TComFrucMvFieldSet & rList )
+{
+  // do not use zoom in FRUC for now
+  rList.insert( rMvField );
+}
+#else
 Void TComPrediction::xFrucInsertMv2StartList( const TComMvField & rMvField , std::list<TComMvField> & rList )
 {
   // do not use zoom in FRUC for now
   if( xFrucIsInList( rMvField , rList ) == false )
     rList.push_back( rMvField );
 }
+#endif
 
 
 /**
@@ -4367,7 +5239,11 @@ Void TComPrediction::xFrucCollectSubBlkStartMv( TComDataCU * pCU , UInt uiAbsPar
 #endif
   )
 {
+#if FRUC_FLAT_START_MV_LIST
+  TComFrucMvFieldSet & rStartMvList = m_listMVFieldCand[eRefPicList];
+#else
   std::list<TComMvField> & rStartMvList = m_listMVFieldCand[eRefPicList];
+#endif
   rStartMvList.clear();
 
   // start Mv
@@ -4499,7 +5375,11 @@ UInt TComPrediction::xFrucFindBestMvFromList( TComMvField * pBestMvField , RefPi
   for( Int nRefPicList = nRefPicListStart ; nRefPicList <= nRefPicListEnd ; nRefPicList++ )
   {
     RefPicList eCurRefPicList = ( RefPicList )nRefPicList;
+#if FRUC_FLAT_START_MV_LIST
+    for( const TComMvField * pos = m_listMVFieldCand[eCurRefPicList].begin() ; pos != m_listMVFieldCand[eCurRefPicList].end() ; pos++ )
+#else
     for( std::list<TComMvField>::iterator pos = m_listMVFieldCand[eCurRefPicList].begin() ; pos != m_listMVFieldCand[eCurRefPicList].end() ; pos++ )
+#endif
     {
       TComMvField mvPair;
 
@@ -4557,6 +5437,9 @@ UInt TComPrediction::xFrucFindBestMvFromList( TComMvField * pBestMvField , RefPi
 Bool TComPrediction::deriveFRUCMV( TComDataCU * pCU , UInt uiDepth , UInt uiAbsPartIdx , UInt uiPUIdx , Int nTargetRefIdx , RefPicList eTargetRefList )
 {
   Bool bAvailable = false;
+#if FRUC_INTERP_WINDOW_CACHE
+  xFrucResetInterpWindows();
+#endif
 
   if( pCU->getMergeFlag( uiAbsPartIdx ) )
   {
@@ -5617,6 +6500,106 @@ Void TComPrediction::xPredAffineBlk(const ComponentID compID, TComDataCU *cu, TC
   shift += 2;
 #endif
 
+#if AFFINE_BATCHED_MC
+  // get the clipped Mv of all the sub-blocks
+  const Int iNumBlkX = cxWidth  / blockWidth;
+  const Int iNumBlkY = cxHeight / blockHeight;
+  for ( Int by = 0, i = 0; by < iNumBlkY; by++ )
+  {
+    for ( Int bx = 0; bx < iNumBlkX; bx++, i++ )
+    {
+      iMvScaleTmpHor = ( iMvScaleHor + iDMvHorX * iHalfBW + iDMvVerX * iHalfBH ) >> shift;
+      iMvScaleTmpVer = ( iMvScaleVer + iDMvHorY * iHalfBW + iDMvVerY * iHalfBH ) >> shift;
+      m_aiAffineSubBlkMvHor[i] = min( iHorMax, max( iHorMin, iMvScaleTmpHor ) );
+      m_aiAffineSubBlkMvVer[i] = min( iVerMax, max( iVerMin, iMvScaleTmpVer ) );
+      m_abAffineSubBlkDone [i] = false;
+
+      iMvScaleHor += (iDMvHorX*blockWidth);
+      iMvScaleVer += (iDMvHorY*blockWidth);
+    }
+    iMvYHor += (iDMvVerX*blockHeight);
+    iMvYVer += (iDMvVerY*blockHeight);
+
+    iMvScaleHor = iMvYHor;
+    iMvScaleVer = iMvYVer;
+  }
+
+  // get prediction rectangle by rectangle: the sub-blocks of a rectangle share an Mv, so one filter call predicts them all
+  for ( Int by = 0; by < iNumBlkY; by++ )
+  {
+    Int iNumX = 1;
+    for ( Int bx = 0; bx < iNumBlkX; bx += iNumX )
+    {
+      const Int i = by * iNumBlkX + bx;
+      iNumX = 1;
+      if ( m_abAffineSubBlkDone[i] )
+      {
+        continue;
+      }
+      iMvScaleTmpHor = m_aiAffineSubBlkMvHor[i];
+      iMvScaleTmpVer = m_aiAffineSubBlkMvVer[i];
+      while ( bx + iNumX < iNumBlkX && !m_abAffineSubBlkDone[i + iNumX] && m_aiAffineSubBlkMvHor[i + iNumX] == iMvScaleTmpHor && m_aiAffineSubBlkMvVer[i + iNumX] == iMvScaleTmpVer )
+      {
+        iNumX++;
+      }
+      Int iNumY = 1;
+      for ( Bool bSameMv = true; bSameMv && by + iNumY < iNumBlkY; )
+      {
+        const Int iBelow = i + iNumY * iNumBlkX;
+        for ( Int n = 0; n < iNumX && bSameMv; n++ )
+        {
+          bSameMv = !m_abAffineSubBlkDone[iBelow + n] && m_aiAffineSubBlkMvHor[iBelow + n] == iMvScaleTmpHor && m_aiAffineSubBlkMvVer[iBelow + n] == iMvScaleTmpVer;
+        }
+        if ( bSameMv )
+        {
+          memset( m_abAffineSubBlkDone + iBelow, true, iNumX * sizeof( Bool ) );
+          iNumY++;
+        }
+      }
+
+      Int xFrac, yFrac, xInt, yInt;
+      if (!iScaleX)
+      {
+        xInt  = iMvScaleTmpHor >> 4;
+        xFrac = iMvScaleTmpHor & 15;
+      }
+      else
+      {
+        xInt  = iMvScaleTmpHor >> 5;
+        xFrac = iMvScaleTmpHor & 31;
+      }
+      if (!iScaleY)
+      {
+        yInt  = iMvScaleTmpVer >> 4;
+        yFrac = iMvScaleTmpVer & 15;
+      }
+      else
+      {
+        yInt  = iMvScaleTmpVer >> 5;
+        yFrac = iMvScaleTmpVer & 31;
+      }
+
+      const Int iRectWidth  = iNumX * blockWidth;
+      const Int iRectHeight = iNumY * blockHeight;
+      Pel *ref  = refOrg + ( by * blockHeight + yInt ) * refStride + bx * blockWidth + xInt;
+      Pel *dstR = dst    +   by * blockHeight          * dstStride + bx * blockWidth;
+
+      if ( yFrac == 0 )
+      {
+        m_if.filterHor(compID, ref, refStride, dstR, dstStride, iRectWidth, iRectHeight, xFrac, !bi, chFmt, bitDepth);
+      }
+      else if ( xFrac == 0 )
+      {
+        m_if.filterVer(compID, ref, refStride, dstR, dstStride, iRectWidth, iRectHeight, yFrac, true, !bi, chFmt, bitDepth);
+      }
+      else
+      {
+        m_if.filterHor(compID, ref - ((vFilterSize>>1) -1)*refStride, refStride, tmp, tmpStride, iRectWidth, iRectHeight+vFilterSize-1, xFrac, false,      chFmt, bitDepth);
+        m_if.filterVer(compID, tmp + ((vFilterSize>>1) -1)*tmpStride, tmpStride, dstR, dstStride, iRectWidth, iRectHeight,               yFrac, false, !bi, chFmt, bitDepth);
+      }
+    }
+  }
+#else
   // get prediction block by block
   for ( Int h = 0; h < cxHeight; h += blockHeight )
   {
@@ -5712,6 +6695,7 @@ Void TComPrediction::xPredAffineBlk(const ComponentID compID, TComDataCU *cu, TC
     iMvScaleHor = iMvYHor;
     iMvScaleVer = iMvYVer;
   }
+#endif
 }
 
 Void TComPrediction::getMvPredAffineAMVP( TComDataCU* pcCU, UInt uiPartIdx, UInt uiPartAddr, RefPicList eRefPicList, TComMv acMvPred[3] )
@@ -5810,6 +6794,12 @@ void TComPrediction::xReferenceFilter(Int iBlkSize, Int iOrigWeight, Int iFilter
 #if VCEG_AZ08_INTER_KLT
 Void TComPrediction::interpolatePic(TComPic* pcPic)
 {
+#if KLT_ON_DEMAND_SUBPEL_PLANES
+    // the fractional pictures are interpolated tile by tile when the picture is searched
+    pcPic->getPicYuvRec()->setBorderExtension(false);
+    pcPic->getPicYuvRec()->extendPicBorder();
+    pcPic->invalidateQuaPicYuvRec();
+#else
     //only perform over luma
     TComPicYuv *refPic = pcPic->getPicYuvRec();
 
@@ -5882,6 +6872,7 @@ Void TComPrediction::interpolatePic(TComPic* pcPic)
             refPicArray[yFrac][xFrac]->extendPicBorder();
         }
     }
+#endif
 }
 #endif
 //! \}
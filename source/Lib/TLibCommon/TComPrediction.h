@@ -46,6 +46,12 @@
 #if VCEG_AZ07_FRUC_MERGE
 #include "TComRdCost.h"
 #include <list>
+#if FRUC_FLAT_START_MV_LIST
+#include "TComMotionInfo.h"
+#endif
+#if FRUC_INTERP_WINDOW_CACHE
+#include <vector>
+#endif
 #endif
 #if COM16_C1046_PDPC_INTRA
 #include "TComRom.h"
@@ -68,6 +74,40 @@ class TComMvField;
 // Class definition
 // ====================================================================================================================
 
+#if FRUC_FLAT_START_MV_LIST
+/// Mv fields in insertion order without duplicates, with storage allocated once
+class TComFrucMvFieldSet
+{
+public:
+  TComFrucMvFieldSet();
+  ~TComFrucMvFieldSet() { destroy(); }
+
+  Void  create   ( Int iCapacity );
+  Void  destroy  ();
+  Bool  isCreated() const { return m_pcMvField != NULL; }
+
+  Void  clear    ();
+  Void  insert   ( const TComMvField & rMvField );
+  Bool  contains ( const TComMvField & rMvField ) const;
+
+  Int                 size () const { return m_iSize; }
+  const TComMvField * begin() const { return m_pcMvField; }
+  const TComMvField * end  () const { return m_pcMvField + m_iSize; }
+
+private:
+  UInt  xGetSlot ( const TComMvField & rMvField ) const;
+
+  TComMvField * m_pcMvField;
+  Int           m_iSize;
+  Int           m_iCapacity;
+  // open addressing hash table of indices into m_pcMvField, a slot is used if its stamp is the current one
+  Int         * m_piSlotIdx;
+  UInt        * m_puiSlotStamp;
+  UInt          m_uiSlotMask;
+  UInt          m_uiStamp;
+};
+#endif
+
 /// prediction class
 typedef enum PRED_BUF_E
 {
@@ -104,6 +144,31 @@ protected:
   Pel*   m_pGradY1;
   Pel*   m_pPred0 ;
   Pel*   m_pPred1 ;
+  Int64* m_piDotProduct1;
+  Int64* m_piDotProduct2;
+  Int64* m_piDotProduct3;
+  Int64* m_piDotProduct5;
+  Int64* m_piDotProduct6;
+  Int64* m_piS1temp;
+  Int64* m_piS2temp;
+  Int64* m_piS3temp;
+  Int64* m_piS5temp;
+  Int64* m_piS6temp;
+  Int64* m_piS1;
+  Int64* m_piS2;
+  Int64* m_piS3;
+  Int64* m_piS5;
+  Int64* m_piS6;
+#if SIMD_AVX2_BIO
+  Double* m_pdBioSums;    ///< products of a row and the five last rows of window sums of the fused AVX2 BIO kernel
+  static Void (*m_fpBioFilter)( const Pel* piSrc, Int iSrcStride, Int iTapStride, Pel* piDst, Int iDstStride, Int iWidth, Int iHeight, const Short* psCoeff, Int iOffset, Int iShift );
+                          ///< six-tap BIO filter kernel selected by initSimdKernels(), NULL: the C code filters
+  static Void (*m_fpBioAverage)( const Pel* pSrc0, const Pel* pSrc1, const Pel* pGradX0, const Pel* pGradX1, const Pel* pGradY0, const Pel* pGradY1,
+                                 Int iWidth, Int iHeight, Int iScale0, Int iScale1, Pel* pDst, Int iDstStride, Double* pdBuf,
+                                 Int iShiftNum, Int iOffset, Int64 iLimit, Int64 iDenomMin1, Int64 iDenomMin2, Int64 iRegularizator1, Int64 iRegularizator2,
+                                 Int iMinVal, Int iMaxVal );
+                          ///< fused BIO kernel selected by initSimdKernels(), NULL: the C code computes the flow
+#endif
   Int    iRefListIdx;
 #endif
 
@@ -140,6 +205,26 @@ protected:
   TComPicYuv* m_tempPicYuv;
 #endif
 
+#if OBMC_RUN_PREDICTION
+  /// neighbouring motion of one boundary of an OBMC sub-block, gathered before any prediction of the CU is made
+  struct OBMCNeigMotion
+  {
+    Bool        bValid;         ///< the neighbouring motion differs from the motion of the sub-block
+    Bool        bPredicted;     ///< the prediction was made with the run of a previous sub-block
+    Bool        bSimp;
+    Int         iPredDir;
+    TComMvField acMvField[NUM_REF_PIC_LIST_01];
+  };
+  OBMCNeigMotion m_acOBMCNeigMotion[4][MAX_NUM_PART_IDXS_IN_CTU_WIDTH*MAX_NUM_PART_IDXS_IN_CTU_WIDTH]; ///< per direction (above, left, below, right) and sub-block of the CU in raster order
+  TComYuv        m_acYuvPredOBMC[2];                                                                   ///< predictions with the below and right neighbouring motions
+#endif
+
+#if AFFINE_BATCHED_MC
+  Int    m_aiAffineSubBlkMvHor[AFFINE_MAX_NUM_SUB_BLOCKS];  ///< clipped Mv of the affine MC sub-blocks in raster order
+  Int    m_aiAffineSubBlkMvVer[AFFINE_MAX_NUM_SUB_BLOCKS];
+  Bool   m_abAffineSubBlkDone [AFFINE_MAX_NUM_SUB_BLOCKS];  ///< the sub-block was predicted with a rectangle of a previous one
+#endif
+
     Void xPredIntraAng            ( Int bitDepth, const Pel* pSrc, Int srcStride, Pel* pDst, Int dstStride, UInt width, UInt height,
 #if JVET_D0033_ADAPTIVE_CLIPPING
                                     ComponentID compID,
@@ -158,9 +243,31 @@ protected:
 
 #if VCEG_AZ07_FRUC_MERGE
   TComRdCost              m_cFRUCRDCost;
+#if FRUC_FLAT_START_MV_LIST
+  TComFrucMvFieldSet      m_listMVFieldCand[2];
+#else
   std::list <TComMvField> m_listMVFieldCand[2];
+#endif
   TComYuv                 m_cYuvPredFrucTemplate[2];      // 0: top, 1: left
   Bool                    m_bFrucTemplateAvailabe[2];
+#if FRUC_INTERP_WINDOW_CACHE
+  /// luma samples of a reference picture interpolated at one fractional phase over a window
+  struct FrucInterpWindow
+  {
+    const TComPicYuv* pcRefPic;
+    Int               iFracX;
+    Int               iFracY;
+    Int               iPosX;      ///< integer position of the top-left sample in the reference picture
+    Int               iPosY;
+    Int               iWidth;     ///< also the stride of the samples
+    Int               iHeight;
+    UInt              uiLastUse;
+    std::vector<Pel>  cSamples;
+  };
+  FrucInterpWindow        m_acFrucWindow[FRUC_INTERP_WINDOW_NUM];
+  Int                     m_iFrucWindowNum;               ///< windows filled since the last reset
+  UInt                    m_uiFrucWindowClock;
+#endif
 #if COM16_C806_VCEG_AZ10_SUB_PU_TMVP
   UChar                   m_eMergeCandTypeNieghors[MRG_MAX_NUM_CANDS];
 #if JVET_C0035_ATMVP_SIMPLIFICATION
@@ -221,6 +328,16 @@ protected:
     , TComDataCU * pCu
 #endif
     );
+#if VCEG_AZ05_BIO
+  Void xBIOAverage              ( UInt uiPartIdx, Int iWidth, Int iHeight, TComYuv* pcYuvDst, const BitDepths &clipBitDepths
+#if JVET_C0027_BIO
+    , Bool bShortRefMV
+#endif
+#if COM16_C1045_BIO_HARMO_IMPROV
+    , Int dT0, Int dT1
+#endif
+    );
+#endif
 
   Void xGetLLSPrediction ( const Pel* pSrc0, Int iSrcStride, Pel* pDst0, Int iDstStride, UInt uiWidth, UInt uiHeight, UInt uiExt0, const ChromaFormat chFmt  DEBUG_STRING_FN_DECLARE(sDebug) );
 #if COM16_C1046_PDPC_INTRA
@@ -271,8 +388,18 @@ protected:
   UInt xFrucGetBilaMatchCost( TComDataCU * pcCU , UInt uiAbsPartIdx , Int nWidth , Int nHeight , RefPicList eCurRefPicList , const TComMvField & rCurMvField , TComMvField & rPairMVField , UInt uiMVCost );
   UInt xFrucGetTempMatchCost( TComDataCU * pcCU , UInt uiAbsPartIdx , Int nWidth , Int nHeight , RefPicList eCurRefPicList , const TComMvField & rCurMvField , UInt uiMVCost );
 
+#if FRUC_INTERP_WINDOW_CACHE
+  Void xFrucResetInterpWindows();
+  Pel* xFrucGetPredBlk( TComDataCU * pcCU , UInt uiAbsPartIdx , TComPicYuv * pcRefPic , TComMv cMv , Int nWidth , Int nHeight , TComYuv * pcYuvPred , Int nFRUCMode , Int & rnStride );
+#endif
+
+#if FRUC_FLAT_START_MV_LIST
+  Void xFrucInsertMv2StartList( const TComMvField & rMvField , TComFrucMvFieldSet & rList );
+  Bool xFrucIsInList( const TComMvField & rMvField , const TComFrucMvFieldSet & rList );
+#else
   Void xFrucInsertMv2StartList( const TComMvField & rMvField , std::list<TComMvField> & rList );
   Bool xFrucIsInList( const TComMvField & rMvField , std::list<TComMvField> & rList );
+#endif
 
   Bool xFrucGetCurBlkTemplate( TComDataCU * pCU , UInt uiAbsPartIdx , Int nCurBlkWidth , Int nCurBlkHeight );
   Bool xFrucIsTopTempAvailable( TComDataCU * pCU , UInt uiAbsPartIdx );
@@ -282,9 +409,16 @@ protected:
 #if VCEG_AZ06_IC
   Void xGetLLSICPrediction( TComDataCU* pcCU, TComMv *pMv, TComPicYuv *pRefPic, Int &a, Int &b, const ComponentID eComp, Int nBitDepth );
 #endif
+#if SIMD_AVX2_OBMC
+  static Void (*m_fpSubblockOBMC)( Pel* pDst, Int iDstStride, const Pel* pSrc, Int iSrcStride, Int iWidth, Int iHeight, Int iDir, Int iNumLines );
+                          ///< OBMC blending kernel selected by initSimdKernels(), NULL: the C code blends
+#endif
 public:
   TComPrediction();
   virtual ~TComPrediction();
+#if SIMD_AVX2_BIO || SIMD_AVX2_OBMC
+  static Void initSimdKernels( SimdLevel eLevel );
+#endif
 #if COM16_C806_OBMC
   Void subBlockOBMC ( TComDataCU*  pcCU, UInt uiAbsPartIdx, TComYuv *pcYuvPred, TComYuv *pcYuvTmpPred1, TComYuv *pcYuvTmpPred2, Bool bOBMC4ME = false );
 #endif
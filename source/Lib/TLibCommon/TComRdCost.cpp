@@ -45,6 +45,12 @@
 #include <emmintrin.h>  
 #include <xmmintrin.h>
 #endif
+#if SIMD_RUNTIME_DISPATCH && SIMD_AVX_TARGETS
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"   // _mm512_undefined_epi32() in the AVX-512 intrinsics
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#endif
 
 //! \ingroup TLibCommon
 //! \{
@@ -224,9 +230,44 @@ Void TComRdCost::setLambda( Double dLambda, const BitDepths &bitDepths )
 #endif
 }
 
+FpDistFunc TComRdCost::m_afpDistortFunc[DF_TOTAL_FUNCTIONS];
+
+Distortion (*TComRdCost::m_fpCalcHADs8x8)( Pel *piOrg, Pel *piCurr, Int iStrideOrg, Int iStrideCur, Int iStep
+#if COM16_C806_SIMD_OPT
+  , Int bitDepth
+#endif
+  );
 
-// Initalize Function Pointer by [eDFunc]
 Void TComRdCost::init()
+{
+#if !SIMD_RUNTIME_DISPATCH
+  initSimdKernels( SIMD_SSE2 );
+#endif
+  m_costMode                   = COST_STANDARD_LOSSY;
+
+#if RExt__HIGH_BIT_DEPTH_SUPPORT
+  m_dCost                      = 0;
+#else
+  m_uiCost                     = 0;
+#endif
+  m_iCostScale                 = 0;
+}
+
+/** Select the distortion functions of a SIMD level, called once at start-up by initSimdLevel() before any thread is started
+ */
+Void TComRdCost::initSimdKernels( SimdLevel eLevel )
+{
+  switch( eLevel )
+  {
+    case SIMD_NONE: xInitDistortFunc<SIMD_NONE>(); break;
+    case SIMD_SSE2: xInitDistortFunc<SIMD_SSE2>(); break;
+    default:        xInitDistortFunc<SIMD_AVX2>(); break;   // no distortion kernel uses AVX-512
+  }
+}
+
+// Initalize Function Pointer by [eDFunc]
+template<SimdLevel eLevel>
+Void TComRdCost::xInitDistortFunc()
 {
   m_afpDistortFunc[DF_DEFAULT] = NULL;                  // for DF_DEFAULT
 
@@ -238,46 +279,39 @@ Void TComRdCost::init()
   m_afpDistortFunc[DF_SSE64  ] = TComRdCost::xGetSSE64;
   m_afpDistortFunc[DF_SSE16N ] = TComRdCost::xGetSSE16N;
 
-  m_afpDistortFunc[DF_SAD    ] = TComRdCost::xGetSAD;
-  m_afpDistortFunc[DF_SAD4   ] = TComRdCost::xGetSAD4;
-  m_afpDistortFunc[DF_SAD8   ] = TComRdCost::xGetSAD8;
-  m_afpDistortFunc[DF_SAD16  ] = TComRdCost::xGetSAD16;
-  m_afpDistortFunc[DF_SAD32  ] = TComRdCost::xGetSAD32;
-  m_afpDistortFunc[DF_SAD64  ] = TComRdCost::xGetSAD64;
-  m_afpDistortFunc[DF_SAD16N ] = TComRdCost::xGetSAD16N;
-
-  m_afpDistortFunc[DF_SADS   ] = TComRdCost::xGetSAD;
-  m_afpDistortFunc[DF_SADS4  ] = TComRdCost::xGetSAD4;
-  m_afpDistortFunc[DF_SADS8  ] = TComRdCost::xGetSAD8;
-  m_afpDistortFunc[DF_SADS16 ] = TComRdCost::xGetSAD16;
-  m_afpDistortFunc[DF_SADS32 ] = TComRdCost::xGetSAD32;
-  m_afpDistortFunc[DF_SADS64 ] = TComRdCost::xGetSAD64;
-  m_afpDistortFunc[DF_SADS16N] = TComRdCost::xGetSAD16N;
-
-  m_afpDistortFunc[DF_SAD12  ] = TComRdCost::xGetSAD12;
-  m_afpDistortFunc[DF_SAD24  ] = TComRdCost::xGetSAD24;
-  m_afpDistortFunc[DF_SAD48  ] = TComRdCost::xGetSAD48;
-
-  m_afpDistortFunc[DF_SADS12 ] = TComRdCost::xGetSAD12;
-  m_afpDistortFunc[DF_SADS24 ] = TComRdCost::xGetSAD24;
-  m_afpDistortFunc[DF_SADS48 ] = TComRdCost::xGetSAD48;
-
-  m_afpDistortFunc[DF_HADS   ] = TComRdCost::xGetHADs;
-  m_afpDistortFunc[DF_HADS4  ] = TComRdCost::xGetHADs;
-  m_afpDistortFunc[DF_HADS8  ] = TComRdCost::xGetHADs;
-  m_afpDistortFunc[DF_HADS16 ] = TComRdCost::xGetHADs;
-  m_afpDistortFunc[DF_HADS32 ] = TComRdCost::xGetHADs;
-  m_afpDistortFunc[DF_HADS64 ] = TComRdCost::xGetHADs;
-  m_afpDistortFunc[DF_HADS16N] = TComRdCost::xGetHADs;
-
-  m_costMode                   = COST_STANDARD_LOSSY;
-
-#if RExt__HIGH_BIT_DEPTH_SUPPORT
-  m_dCost                      = 0;
-#else
-  m_uiCost                     = 0;
-#endif
-  m_iCostScale                 = 0;
+  m_afpDistortFunc[DF_SAD    ] = TComRdCost::xGetSAD<eLevel>;
+  m_afpDistortFunc[DF_SAD4   ] = TComRdCost::xGetSAD4<eLevel>;
+  m_afpDistortFunc[DF_SAD8   ] = TComRdCost::xGetSAD8<eLevel>;
+  m_afpDistortFunc[DF_SAD16  ] = TComRdCost::xGetSAD16<eLevel>;
+  m_afpDistortFunc[DF_SAD32  ] = TComRdCost::xGetSAD32<eLevel>;
+  m_afpDistortFunc[DF_SAD64  ] = TComRdCost::xGetSAD64<eLevel>;
+  m_afpDistortFunc[DF_SAD16N ] = TComRdCost::xGetSAD16N<eLevel>;
+
+  m_afpDistortFunc[DF_SADS   ] = TComRdCost::xGetSAD<eLevel>;
+  m_afpDistortFunc[DF_SADS4  ] = TComRdCost::xGetSAD4<eLevel>;
+  m_afpDistortFunc[DF_SADS8  ] = TComRdCost::xGetSAD8<eLevel>;
+  m_afpDistortFunc[DF_SADS16 ] = TComRdCost::xGetSAD16<eLevel>;
+  m_afpDistortFunc[DF_SADS32 ] = TComRdCost::xGetSAD32<eLevel>;
+  m_afpDistortFunc[DF_SADS64 ] = TComRdCost::xGetSAD64<eLevel>;
+  m_afpDistortFunc[DF_SADS16N] = TComRdCost::xGetSAD16N<eLevel>;
+
+  m_afpDistortFunc[DF_SAD12  ] = TComRdCost::xGetSAD12<eLevel>;
+  m_afpDistortFunc[DF_SAD24  ] = TComRdCost::xGetSAD24<eLevel>;
+  m_afpDistortFunc[DF_SAD48  ] = TComRdCost::xGetSAD48<eLevel>;
+
+  m_afpDistortFunc[DF_SADS12 ] = TComRdCost::xGetSAD12<eLevel>;
+  m_afpDistortFunc[DF_SADS24 ] = TComRdCost::xGetSAD24<eLevel>;
+  m_afpDistortFunc[DF_SADS48 ] = TComRdCost::xGetSAD48<eLevel>;
+
+  m_afpDistortFunc[DF_HADS   ] = TComRdCost::xGetHADs<eLevel>;
+  m_afpDistortFunc[DF_HADS4  ] = TComRdCost::xGetHADs<eLevel>;
+  m_afpDistortFunc[DF_HADS8  ] = TComRdCost::xGetHADs<eLevel>;
+  m_afpDistortFunc[DF_HADS16 ] = TComRdCost::xGetHADs<eLevel>;
+  m_afpDistortFunc[DF_HADS32 ] = TComRdCost::xGetHADs<eLevel>;
+  m_afpDistortFunc[DF_HADS64 ] = TComRdCost::xGetHADs<eLevel>;
+  m_afpDistortFunc[DF_HADS16N] = TComRdCost::xGetHADs<eLevel>;
+
+  m_fpCalcHADs8x8              = TComRdCost::xCalcHADs8x8<eLevel>;
 }
 
 // Static member function
@@ -459,7 +493,7 @@ Distortion TComRdCost::calcHAD( Int bitDepth, Pel* pi0, Int iStride0, Pel* pi1,
     {
       for ( x=0; x<iWidth; x+= 8 )
       {
-        uiSum += xCalcHADs8x8( &pi0[x], &pi1[x], iStride0, iStride1, 1 
+        uiSum += m_fpCalcHADs8x8( &pi0[x], &pi1[x], iStride0, iStride1, 1 
 #if COM16_C806_SIMD_OPT
           , bitDepth
 #endif
@@ -546,10 +580,41 @@ inline Int simdSADLine4n16b( const Pel * piOrg , const Pel * piCur , Int nWidth
   return( _mm_cvtsi128_si32( sum ) );
 }
 
+#if SIMD_RUNTIME_DISPATCH && SIMD_AVX_TARGETS
+__attribute__((target("avx2")))
+static Int simdSADLine16n16bAVX2( const Pel * piOrg , const Pel * piCur , Int nWidth )
+{
+  // internal bit-depth must be 12-bit or lower
+  assert( !( nWidth & 0x0f ) );
+  __m256i org , cur , abs , sum;
+  sum = _mm256_setzero_si256();
+  for( Int n = 0 ; n < nWidth ; n += 16 )
+  {
+    org = _mm256_loadu_si256( ( __m256i* )( piOrg + n ) );
+    cur = _mm256_loadu_si256( ( __m256i* )( piCur + n ) );
+    abs = _mm256_subs_epi16( _mm256_max_epi16( org , cur )  , _mm256_min_epi16( org , cur ) );
+    sum = _mm256_adds_epu16( abs , sum );
+  }
+  __m256i zero = _mm256_setzero_si256();
+  sum = _mm256_add_epi32( _mm256_unpacklo_epi16( sum , zero ) , _mm256_unpackhi_epi16( sum , zero ) );
+  __m128i sum128 = _mm_add_epi32( _mm256_castsi256_si128( sum ) , _mm256_extracti128_si256( sum , 1 ) );
+  sum128 = _mm_add_epi32( sum128 , _mm_shuffle_epi32( sum128 , _MM_SHUFFLE( 2 , 3 , 0 , 1 ) ) );
+  sum128 = _mm_add_epi32( sum128 , _mm_shuffle_epi32( sum128 , _MM_SHUFFLE( 1 , 0 , 3 , 2 ) ) );
+  return( _mm_cvtsi128_si32( sum128 ) );
+}
+#endif
+
+template<SimdLevel eLevel>
 inline Int simdSADLine8n16b( const Pel * piOrg , const Pel * piCur , Int nWidth )
 {
   // internal bit-depth must be 12-bit or lower
   assert( !( nWidth & 0x07 ) );
+#if SIMD_RUNTIME_DISPATCH && SIMD_AVX_TARGETS
+  if( !( nWidth & 0x0f ) && eLevel >= SIMD_AVX2 )
+  {
+    return( simdSADLine16n16bAVX2( piOrg , piCur , nWidth ) );
+  }
+#endif
   __m128i org , cur , abs , sum;
   sum = _mm_setzero_si128();
   for( Int n = 0 ; n < nWidth ; n += 8 )
@@ -675,12 +740,268 @@ UInt simdHADs8x8( Pel * piOrg, Pel * piCur, Int iStrideOrg, Int iStrideCur )
 }
 #endif
 
+#if SIMD_AVX2_HADAMARD && SIMD_AVX_TARGETS
+/**
+ * \brief Butterfly between the lanes of a register that are iDist apart: the lower lane gets the sum, the upper one the difference
+ */
+template<Int iDist>
+__attribute__((target("avx2")))
+static inline __m256i simdHADLaneButterflyAVX2( __m256i m )
+{
+  __m256i swapped , sign;
+  if( iDist == 4 )
+  {
+    swapped = _mm256_permute4x64_epi64( m , _MM_SHUFFLE( 1 , 0 , 3 , 2 ) );
+    sign    = _mm256_setr_epi32( 1 , 1 , 1 , 1 , -1 , -1 , -1 , -1 );
+  }
+  else if( iDist == 2 )
+  {
+    swapped = _mm256_shuffle_epi32( m , _MM_SHUFFLE( 1 , 0 , 3 , 2 ) );
+    sign    = _mm256_setr_epi32( 1 , 1 , -1 , -1 , 1 , 1 , -1 , -1 );
+  }
+  else
+  {
+    swapped = _mm256_shuffle_epi32( m , _MM_SHUFFLE( 2 , 3 , 0 , 1 ) );
+    sign    = _mm256_setr_epi32( 1 , -1 , 1 , -1 , 1 , -1 , 1 , -1 );
+  }
+  return( _mm256_add_epi32( swapped , _mm256_sign_epi32( m , sign ) ) );
+}
+
+/**
+ * \brief Sum of the absolute Hadamard coefficients of a W x H tile of ( org - iOffset - cur ), without normalisation
+ *
+ * The 2-D Hadamard transform of the tile is the 1-D transform of length W*H over the row and column index bits,
+ * so it is done with butterflies between the registers and then between the lanes, whatever the tile shape.
+ * The coefficients come out in a different order than in the C code, which does not change the sum.
+ * 8-wide rows fill one register, 16-wide rows two and 4-wide rows share a register with the row H/2 below.
+ */
+template<Int W, Int H>
+__attribute__((target("avx2")))
+static Int simdHADsAVX2( const Pel *piOrg , const Pel *piCur , Int iStrideOrg , Int iStrideCur , Int iOffset )
+{
+  const Int iNumRegs = W * H / 8;
+  __m256i m[W * H / 8];
+  const __m256i mmOffset = _mm256_set1_epi32( iOffset );
+
+  if( W == 4 )
+  {
+    for( Int r = 0 ; r < H / 2 ; r++ )
+    {
+      __m128i diff0 = _mm_sub_epi16( _mm_loadl_epi64( ( const __m128i* )( piOrg + r * iStrideOrg ) ) , _mm_loadl_epi64( ( const __m128i* )( piCur + r * iStrideCur ) ) );
+      __m128i diff1 = _mm_sub_epi16( _mm_loadl_epi64( ( const __m128i* )( piOrg + ( r + H / 2 ) * iStrideOrg ) ) , _mm_loadl_epi64( ( const __m128i* )( piCur + ( r + H / 2 ) * iStrideCur ) ) );
+      m[r] = _mm256_sub_epi32( _mm256_cvtepi16_epi32( _mm_unpacklo_epi64( diff0 , diff1 ) ) , mmOffset );
+    }
+  }
+  else
+  {
+    for( Int r = 0 ; r < H ; r++ )
+    {
+      for( Int c = 0 ; c < W ; c += 8 )
+      {
+        __m128i diff = _mm_sub_epi16( _mm_loadu_si128( ( const __m128i* )( piOrg + r * iStrideOrg + c ) ) , _mm_loadu_si128( ( const __m128i* )( piCur + r * iStrideCur + c ) ) );
+        m[r * ( W / 8 ) + c / 8] = _mm256_sub_epi32( _mm256_cvtepi16_epi32( diff ) , mmOffset );
+      }
+    }
+  }
+
+  for( Int d = 1 ; d < iNumRegs ; d <<= 1 )
+  {
+    for( Int i = 0 ; i < iNumRegs ; i++ )
+    {
+      if( !( i & d ) )
+      {
+        __m256i a = m[i];
+        m[i]     = _mm256_add_epi32( a , m[i + d] );
+        m[i + d] = _mm256_sub_epi32( a , m[i + d] );
+      }
+    }
+  }
+
+  __m256i mmSum = _mm256_setzero_si256();
+  for( Int i = 0 ; i < iNumRegs ; i++ )
+  {
+    __m256i coeff = simdHADLaneButterflyAVX2<1>( simdHADLaneButterflyAVX2<2>( simdHADLaneButterflyAVX2<4>( m[i] ) ) );
+    mmSum = _mm256_add_epi32( mmSum , _mm256_abs_epi32( coeff ) );
+  }
+  __m128i sum128 = _mm_add_epi32( _mm256_castsi256_si128( mmSum ) , _mm256_extracti128_si256( mmSum , 1 ) );
+  sum128 = _mm_add_epi32( sum128 , _mm_shuffle_epi32( sum128 , _MM_SHUFFLE( 2 , 3 , 0 , 1 ) ) );
+  sum128 = _mm_add_epi32( sum128 , _mm_shuffle_epi32( sum128 , _MM_SHUFFLE( 1 , 0 , 3 , 2 ) ) );
+  return( _mm_cvtsi128_si32( sum128 ) );
+}
+#endif
+
+#if ( SIMD_AVX2_HADAMARD || SIMD_AVX2_MR_SAD ) && SIMD_AVX_TARGETS
+/**
+ * \brief Sum of ( org - cur ) over a block whose width is a multiple of 4
+ */
+__attribute__((target("avx2")))
+static Int simdSumDiffAVX2( const Pel *piOrg , const Pel *piCur , Int iStrideOrg , Int iStrideCur , Int iRows , Int iCols )
+{
+  const __m256i mmOne = _mm256_set1_epi16( 1 );
+  __m256i mmSum = _mm256_setzero_si256();
+  __m128i mmSum4 = _mm_setzero_si128();
+  for( Int y = 0 ; y < iRows ; y++ , piOrg += iStrideOrg , piCur += iStrideCur )
+  {
+    Int x = 0;
+    for( ; x + 16 <= iCols ; x += 16 )
+    {
+      __m256i diff = _mm256_sub_epi16( _mm256_loadu_si256( ( const __m256i* )( piOrg + x ) ) , _mm256_loadu_si256( ( const __m256i* )( piCur + x ) ) );
+      mmSum = _mm256_add_epi32( mmSum , _mm256_madd_epi16( diff , mmOne ) );
+    }
+    for( ; x < iCols ; x += 4 )
+    {
+      __m128i diff = _mm_sub_epi16( _mm_loadl_epi64( ( const __m128i* )( piOrg + x ) ) , _mm_loadl_epi64( ( const __m128i* )( piCur + x ) ) );
+      mmSum4 = _mm_add_epi32( mmSum4 , _mm_madd_epi16( diff , _mm256_castsi256_si128( mmOne ) ) );
+    }
+  }
+  __m128i sum128 = _mm_add_epi32( _mm256_castsi256_si128( mmSum ) , _mm256_extracti128_si256( mmSum , 1 ) );
+  sum128 = _mm_add_epi32( sum128 , mmSum4 );
+  sum128 = _mm_add_epi32( sum128 , _mm_shuffle_epi32( sum128 , _MM_SHUFFLE( 2 , 3 , 0 , 1 ) ) );
+  sum128 = _mm_add_epi32( sum128 , _mm_shuffle_epi32( sum128 , _MM_SHUFFLE( 1 , 0 , 3 , 2 ) ) );
+  return( _mm_cvtsi128_si32( sum128 ) );
+}
+#endif
+
+#if SIMD_AVX2_HADAMARD && SIMD_AVX_TARGETS
+/**
+ * \brief Hadamard cost of a block, split into tiles and normalised exactly as TComRdCost::xGetHADs() does
+ *
+ * \returns false for blocks that need 2x2 tiles, which are left to the C code
+ */
+static Bool simdGetHADs( const Pel *piOrg , const Pel *piCur , Int iStrideOrg , Int iStrideCur , Int iRows , Int iCols , Int iOffset , Distortion &ruiSum )
+{
+  if( ( iRows | iCols ) & 0x03 )
+  {
+    return false;
+  }
+  Distortion uiSum = 0;
+#if JVET_C0024_QTBT
+  if( iCols > iRows && iRows >= 8 )
+  {
+    for( Int y = 0 ; y < iRows ; y += 8 , piOrg += iStrideOrg * 8 , piCur += iStrideCur * 8 )
+    {
+      for( Int x = 0 ; x < iCols ; x += 16 )
+      {
+        Int sad = simdHADsAVX2<16, 8>( piOrg + x , piCur + x , iStrideOrg , iStrideCur , iOffset );
+        uiSum += (Int)( sad / sqrt( 16.0 * 8 ) * 2 );
+      }
+    }
+  }
+  else if( iCols < iRows && iCols >= 8 )
+  {
+    for( Int y = 0 ; y < iRows ; y += 16 , piOrg += iStrideOrg * 16 , piCur += iStrideCur * 16 )
+    {
+      for( Int x = 0 ; x < iCols ; x += 8 )
+      {
+        Int sad = simdHADsAVX2<8, 16>( piOrg + x , piCur + x , iStrideOrg , iStrideCur , iOffset );
+        uiSum += (Int)( sad / sqrt( 16.0 * 8 ) * 2 );
+      }
+    }
+  }
+  else if( iCols > iRows && iRows == 4 )
+  {
+    for( Int x = 0 ; x < iCols ; x += 8 )
+    {
+      Int sad = simdHADsAVX2<8, 4>( piOrg + x , piCur + x , iStrideOrg , iStrideCur , iOffset );
+      uiSum += (Int)( sad / sqrt( 4.0 * 8 ) * 2 );
+    }
+  }
+  else if( iCols < iRows && iCols == 4 )
+  {
+    for( Int y = 0 ; y < iRows ; y += 8 , piOrg += iStrideOrg * 8 , piCur += iStrideCur * 8 )
+    {
+      Int sad = simdHADsAVX2<4, 8>( piOrg , piCur , iStrideOrg , iStrideCur , iOffset );
+      uiSum += (Int)( sad / sqrt( 4.0 * 8 ) * 2 );
+    }
+  }
+  else
+#endif
+  if( ( iRows % 8 == 0 ) && ( iCols % 8 == 0 ) )
+  {
+    for( Int y = 0 ; y < iRows ; y += 8 , piOrg += iStrideOrg * 8 , piCur += iStrideCur * 8 )
+    {
+      for( Int x = 0 ; x < iCols ; x += 8 )
+      {
+        uiSum += ( simdHADsAVX2<8, 8>( piOrg + x , piCur + x , iStrideOrg , iStrideCur , iOffset ) + 2 ) >> 2;
+      }
+    }
+  }
+  else
+  {
+    for( Int y = 0 ; y < iRows ; y += 4 , piOrg += iStrideOrg * 4 , piCur += iStrideCur * 4 )
+    {
+      for( Int x = 0 ; x < iCols ; x += 4 )
+      {
+        uiSum += ( simdHADsAVX2<4, 4>( piOrg + x , piCur + x , iStrideOrg , iStrideCur , iOffset ) + 1 ) >> 1;
+      }
+    }
+  }
+  ruiSum = uiSum;
+  return true;
+}
+#endif
+
+#if SIMD_AVX2_MR_SAD && SIMD_AVX_TARGETS
+/**
+ * \brief Mean-removed SAD of the rows of a block that are 1 << iSubShift apart, computed as TComRdCost::xGetMRSAD*() do
+ *
+ * The mean difference is found with one vectorised pass and the SAD of ( org - cur - mean ) with a second one
+ * over the same rows, which are still in the L1 cache. Sums are kept in 32 bits as in the C code.
+ * \param iCols block width, a multiple of 4
+ */
+__attribute__((target("avx2")))
+static UInt simdGetMRSADAVX2( const DistParam *pcDtParam , Int iCols , Int iSubShift )
+{
+  const Pel *piOrg      = pcDtParam->pOrg;
+  const Pel *piCur      = pcDtParam->pCur;
+  const Int  iRowCnt    = pcDtParam->iRows >> iSubShift;
+  const Int  iStrideOrg = pcDtParam->iStrideOrg << iSubShift;
+  const Int  iStrideCur = pcDtParam->iStrideCur << iSubShift;
+
+  if( iRowCnt == 0 )
+  {
+    return 0;
+  }
+  const Int iDeltaC = simdSumDiffAVX2( piOrg , piCur , iStrideOrg , iStrideCur , iRowCnt , iCols ) / iRowCnt / iCols;
+
+  const __m256i mmDelta = _mm256_set1_epi16( ( Short )iDeltaC );
+  const __m256i mmOne   = _mm256_set1_epi16( 1 );
+  const __m128i mmOneLo = _mm_setr_epi16( 1 , 1 , 1 , 1 , 0 , 0 , 0 , 0 ); // only the 4 loaded samples of a 4-wide chunk
+  __m256i mmSum  = _mm256_setzero_si256();
+  __m128i mmSum4 = _mm_setzero_si128();
+  for( Int y = 0 ; y < iRowCnt ; y++ , piOrg += iStrideOrg , piCur += iStrideCur )
+  {
+    Int x = 0;
+    for( ; x + 16 <= iCols ; x += 16 )
+    {
+      __m256i diff = _mm256_sub_epi16( _mm256_loadu_si256( ( const __m256i* )( piOrg + x ) ) , _mm256_loadu_si256( ( const __m256i* )( piCur + x ) ) );
+      mmSum = _mm256_add_epi32( mmSum , _mm256_madd_epi16( _mm256_abs_epi16( _mm256_sub_epi16( diff , mmDelta ) ) , mmOne ) );
+    }
+    for( ; x < iCols ; x += 4 )
+    {
+      __m128i diff = _mm_sub_epi16( _mm_loadl_epi64( ( const __m128i* )( piOrg + x ) ) , _mm_loadl_epi64( ( const __m128i* )( piCur + x ) ) );
+      diff = _mm_abs_epi16( _mm_sub_epi16( diff , _mm256_castsi256_si128( mmDelta ) ) );
+      mmSum4 = _mm_add_epi32( mmSum4 , _mm_madd_epi16( diff , mmOneLo ) );
+    }
+  }
+  __m128i sum128 = _mm_add_epi32( _mm256_castsi256_si128( mmSum ) , _mm256_extracti128_si256( mmSum , 1 ) );
+  sum128 = _mm_add_epi32( sum128 , mmSum4 );
+  sum128 = _mm_add_epi32( sum128 , _mm_shuffle_epi32( sum128 , _MM_SHUFFLE( 2 , 3 , 0 , 1 ) ) );
+  sum128 = _mm_add_epi32( sum128 , _mm_shuffle_epi32( sum128 , _MM_SHUFFLE( 1 , 0 , 3 , 2 ) ) );
+  UInt uiSum = ( UInt )_mm_cvtsi128_si32( sum128 );
+
+  uiSum <<= iSubShift;
+  return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT( pcDtParam->bitDepth - 8 ) );
+}
+#endif
+
+template<SimdLevel eLevel>
 Distortion TComRdCost::xGetSAD( DistParam* pcDtParam )
 {
 #if VCEG_AZ06_IC
   if( pcDtParam->bMRFlag )
   {
-    return xGetMRSAD( pcDtParam );
+    return xGetMRSAD<eLevel>( pcDtParam );
   }
 #endif
   if ( pcDtParam->bApplyWeight )
@@ -698,13 +1019,13 @@ Distortion TComRdCost::xGetSAD( DistParam* pcDtParam )
   Distortion uiSum = 0;
 
 #if COM16_C806_SIMD_OPT
-  if( pcDtParam->bitDepth <= 10 )
+  if( pcDtParam->bitDepth <= 10 && eLevel >= SIMD_SSE2 )
   {
     if( ( iCols & 0x07 ) == 0 )
     {
       for( ; iRows != 0; iRows-- )
       {
-        uiSum += simdSADLine8n16b( piOrg , piCur , iCols );
+        uiSum += simdSADLine8n16b<eLevel>( piOrg , piCur , iCols );
         piOrg += iStrideOrg;
         piCur += iStrideCur;
       }
@@ -738,12 +1059,13 @@ Distortion TComRdCost::xGetSAD( DistParam* pcDtParam )
   return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
 }
 
+template<SimdLevel eLevel>
 Distortion TComRdCost::xGetSAD4( DistParam* pcDtParam )
 {
 #if VCEG_AZ06_IC
   if( pcDtParam->bMRFlag )
   {
-    return xGetMRSAD4( pcDtParam );
+    return xGetMRSAD4<eLevel>( pcDtParam );
   }
 #endif
   if ( pcDtParam->bApplyWeight )
@@ -762,7 +1084,7 @@ Distortion TComRdCost::xGetSAD4( DistParam* pcDtParam )
   Distortion uiSum = 0;
 
 #if COM16_C806_SIMD_OPT
-  if( pcDtParam->bitDepth <= 10 )
+  if( pcDtParam->bitDepth <= 10 && eLevel >= SIMD_SSE2 )
   {
     for( ; iRows != 0; iRows-=iSubStep )
     {
@@ -792,12 +1114,13 @@ Distortion TComRdCost::xGetSAD4( DistParam* pcDtParam )
   return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
 }
 
+template<SimdLevel eLevel>
 Distortion TComRdCost::xGetSAD8( DistParam* pcDtParam )
 {
 #if VCEG_AZ06_IC
   if( pcDtParam->bMRFlag )
   {
-    return xGetMRSAD8( pcDtParam );
+    return xGetMRSAD8<eLevel>( pcDtParam );
   }
 #endif
   if ( pcDtParam->bApplyWeight )
@@ -816,11 +1139,11 @@ Distortion TComRdCost::xGetSAD8( DistParam* pcDtParam )
   Distortion uiSum = 0;
 
 #if COM16_C806_SIMD_OPT
-  if( pcDtParam->bitDepth <= 10 )
+  if( pcDtParam->bitDepth <= 10 && eLevel >= SIMD_SSE2 )
   {
     for( ; iRows != 0; iRows-=iSubStep )
     {
-      uiSum += simdSADLine8n16b( piOrg , piCur , 8 );
+      uiSum += simdSADLine8n16b<eLevel>( piOrg , piCur , 8 );
       piOrg += iStrideOrg;
       piCur += iStrideCur;
     }
@@ -850,12 +1173,13 @@ Distortion TComRdCost::xGetSAD8( DistParam* pcDtParam )
   return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
 }
 
+template<SimdLevel eLevel>
 Distortion TComRdCost::xGetSAD16( DistParam* pcDtParam )
 {
 #if VCEG_AZ06_IC
   if( pcDtParam->bMRFlag )
   {
-    return xGetMRSAD16( pcDtParam );
+    return xGetMRSAD16<eLevel>( pcDtParam );
   }
 #endif
   if ( pcDtParam->bApplyWeight )
@@ -874,11 +1198,11 @@ Distortion TComRdCost::xGetSAD16( DistParam* pcDtParam )
   Distortion uiSum = 0;
 
 #if COM16_C806_SIMD_OPT
-  if( pcDtParam->bitDepth <= 10 )
+  if( pcDtParam->bitDepth <= 10 && eLevel >= SIMD_SSE2 )
   {
     for( ; iRows != 0; iRows-=iSubStep )
     {
-      uiSum += simdSADLine8n16b( piOrg , piCur , 16 );
+      uiSum += simdSADLine8n16b<eLevel>( piOrg , piCur , 16 );
       piOrg += iStrideOrg;
       piCur += iStrideCur;
     }
@@ -916,12 +1240,13 @@ Distortion TComRdCost::xGetSAD16( DistParam* pcDtParam )
   return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
 }
 
+template<SimdLevel eLevel>
 Distortion TComRdCost::xGetSAD12( DistParam* pcDtParam )
 {
 #if VCEG_AZ06_IC
   if( pcDtParam->bMRFlag )
   {
-    return xGetMRSAD12( pcDtParam );
+    return xGetMRSAD12<eLevel>( pcDtParam );
   }
 #endif
   if ( pcDtParam->bApplyWeight )
@@ -962,12 +1287,13 @@ Distortion TComRdCost::xGetSAD12( DistParam* pcDtParam )
   return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
 }
 
+template<SimdLevel eLevel>
 Distortion TComRdCost::xGetSAD16N( DistParam* pcDtParam )
 {
 #if VCEG_AZ06_IC
   if( pcDtParam->bMRFlag )
   {
-    return xGetMRSAD16N( pcDtParam );
+    return xGetMRSAD16N<eLevel>( pcDtParam );
   }
 #endif
   const Pel* piOrg   = pcDtParam->pOrg;
@@ -982,11 +1308,11 @@ Distortion TComRdCost::xGetSAD16N( DistParam* pcDtParam )
   Distortion uiSum = 0;
 
 #if COM16_C806_SIMD_OPT
-  if( pcDtParam->bitDepth <= 10 )
+  if( pcDtParam->bitDepth <= 10 && eLevel >= SIMD_SSE2 )
   {
     for( ; iRows != 0; iRows-=iSubStep )
     {
-      uiSum += simdSADLine8n16b( piOrg , piCur , iCols );
+      uiSum += simdSADLine8n16b<eLevel>( piOrg , piCur , iCols );
       piOrg += iStrideOrg;
       piCur += iStrideCur;
     }
@@ -1026,12 +1352,13 @@ Distortion TComRdCost::xGetSAD16N( DistParam* pcDtParam )
   return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
 }
 
+template<SimdLevel eLevel>
 Distortion TComRdCost::xGetSAD32( DistParam* pcDtParam )
 {
 #if VCEG_AZ06_IC
   if( pcDtParam->bMRFlag )
   {
-    return xGetMRSAD32( pcDtParam );
+    return xGetMRSAD32<eLevel>( pcDtParam );
   }
 #endif
   if ( pcDtParam->bApplyWeight )
@@ -1050,11 +1377,11 @@ Distortion TComRdCost::xGetSAD32( DistParam* pcDtParam )
   Distortion uiSum = 0;
 
 #if COM16_C806_SIMD_OPT
-  if( pcDtParam->bitDepth <= 10 )
+  if( pcDtParam->bitDepth <= 10 && eLevel >= SIMD_SSE2 )
   {
     for( ; iRows != 0; iRows-=iSubStep )
     {
-      uiSum += simdSADLine8n16b( piOrg , piCur , 32 );
+      uiSum += simdSADLine8n16b<eLevel>( piOrg , piCur , 32 );
       piOrg += iStrideOrg;
       piCur += iStrideCur;
     }
@@ -1108,12 +1435,13 @@ Distortion TComRdCost::xGetSAD32( DistParam* pcDtParam )
   return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
 }
 
+template<SimdLevel eLevel>
 Distortion TComRdCost::xGetSAD24( DistParam* pcDtParam )
 {
 #if VCEG_AZ06_IC
   if( pcDtParam->bMRFlag )
   {
-    return xGetMRSAD24( pcDtParam );
+    return xGetMRSAD24<eLevel>( pcDtParam );
   }
 #endif
   if ( pcDtParam->bApplyWeight )
@@ -1132,11 +1460,11 @@ Distortion TComRdCost::xGetSAD24( DistParam* pcDtParam )
   Distortion uiSum = 0;
 
 #if COM16_C806_SIMD_OPT
-  if( pcDtParam->bitDepth <= 10 )
+  if( pcDtParam->bitDepth <= 10 && eLevel >= SIMD_SSE2 )
   {
     for( ; iRows != 0; iRows-=iSubStep )
     {
-      uiSum += simdSADLine8n16b( piOrg , piCur , 24 );
+      uiSum += simdSADLine8n16b<eLevel>( piOrg , piCur , 24 );
       piOrg += iStrideOrg;
       piCur += iStrideCur;
     }
@@ -1182,12 +1510,13 @@ Distortion TComRdCost::xGetSAD24( DistParam* pcDtParam )
   return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
 }
 
+template<SimdLevel eLevel>
 Distortion TComRdCost::xGetSAD64( DistParam* pcDtParam )
 {
 #if VCEG_AZ06_IC
   if( pcDtParam->bMRFlag )
   {
-    return xGetMRSAD64( pcDtParam );
+    return xGetMRSAD64<eLevel>( pcDtParam );
   }
 #endif
   if ( pcDtParam->bApplyWeight )
@@ -1206,11 +1535,11 @@ Distortion TComRdCost::xGetSAD64( DistParam* pcDtParam )
   Distortion uiSum = 0;
 
 #if COM16_C806_SIMD_OPT
-  if( pcDtParam->bitDepth <= 10 )
+  if( pcDtParam->bitDepth <= 10 && eLevel >= SIMD_SSE2 )
   {
     for( ; iRows != 0; iRows-=iSubStep )
     {
-      uiSum += simdSADLine8n16b( piOrg , piCur , 64 );
+      uiSum += simdSADLine8n16b<eLevel>( piOrg , piCur , 64 );
       piOrg += iStrideOrg;
       piCur += iStrideCur;
     }
@@ -1296,12 +1625,13 @@ Distortion TComRdCost::xGetSAD64( DistParam* pcDtParam )
   return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
 }
 
+template<SimdLevel eLevel>
 Distortion TComRdCost::xGetSAD48( DistParam* pcDtParam )
 {
 #if VCEG_AZ06_IC
   if( pcDtParam->bMRFlag )
   {
-    return xGetMRSAD48( pcDtParam );
+    return xGetMRSAD48<eLevel>( pcDtParam );
   }
 #endif
   if ( pcDtParam->bApplyWeight )
@@ -1320,11 +1650,11 @@ Distortion TComRdCost::xGetSAD48( DistParam* pcDtParam )
   Distortion uiSum = 0;
 
 #if COM16_C806_SIMD_OPT
-  if( pcDtParam->bitDepth <= 10 )
+  if( pcDtParam->bitDepth <= 10 && eLevel >= SIMD_SSE2 )
   {
     for( ; iRows != 0; iRows-=iSubStep )
     {
-      uiSum += simdSADLine8n16b( piOrg , piCur , 48 );
+      uiSum += simdSADLine8n16b<eLevel>( piOrg , piCur , 48 );
       piOrg += iStrideOrg;
       piCur += iStrideCur;
     }
@@ -1395,8 +1725,15 @@ Distortion TComRdCost::xGetSAD48( DistParam* pcDtParam )
 }
 
 #if VCEG_AZ06_IC
+template<SimdLevel eLevel>
 UInt TComRdCost::xGetMRSAD( DistParam* pcDtParam )
 {
+#if SIMD_AVX2_MR_SAD && SIMD_AVX_TARGETS
+  if( pcDtParam->bitDepth <= 12 && eLevel >= SIMD_AVX2 && ( pcDtParam->iCols & 0x03 ) == 0 )
+  {
+    return simdGetMRSADAVX2( pcDtParam, pcDtParam->iCols, 0 );
+  }
+#endif
   Pel* piOrg   = pcDtParam->pOrg;
   Pel* piCur   = pcDtParam->pCur;
   Int  iRows   = pcDtParam->iRows;
@@ -1438,8 +1775,15 @@ UInt TComRdCost::xGetMRSAD( DistParam* pcDtParam )
   return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT( pcDtParam->bitDepth - 8 ) );
 }
 
+template<SimdLevel eLevel>
 UInt TComRdCost::xGetMRSAD4( DistParam* pcDtParam )
 {
+#if SIMD_AVX2_MR_SAD && SIMD_AVX_TARGETS
+  if( pcDtParam->bitDepth <= 12 && eLevel >= SIMD_AVX2 )
+  {
+    return simdGetMRSADAVX2( pcDtParam, 4, pcDtParam->iSubShift );
+  }
+#endif
   Pel* piOrg   = pcDtParam->pOrg;
   Pel* piCur   = pcDtParam->pCur;
   Int  iRows   = pcDtParam->iRows;
@@ -1490,8 +1834,15 @@ UInt TComRdCost::xGetMRSAD4( DistParam* pcDtParam )
   return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT( pcDtParam->bitDepth - 8 ) );
 }
 
+template<SimdLevel eLevel>
 UInt TComRdCost::xGetMRSAD8( DistParam* pcDtParam )
 {
+#if SIMD_AVX2_MR_SAD && SIMD_AVX_TARGETS
+  if( pcDtParam->bitDepth <= 12 && eLevel >= SIMD_AVX2 )
+  {
+    return simdGetMRSADAVX2( pcDtParam, 8, pcDtParam->iSubShift );
+  }
+#endif
   Pel* piOrg      = pcDtParam->pOrg;
   Pel* piCur      = pcDtParam->pCur;
   Int  iRows      = pcDtParam->iRows;
@@ -1554,8 +1905,15 @@ UInt TComRdCost::xGetMRSAD8( DistParam* pcDtParam )
   return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT( pcDtParam->bitDepth - 8 ) );
 }
 
+template<SimdLevel eLevel>
 UInt TComRdCost::xGetMRSAD16( DistParam* pcDtParam )
 {
+#if SIMD_AVX2_MR_SAD && SIMD_AVX_TARGETS
+  if( pcDtParam->bitDepth <= 12 && eLevel >= SIMD_AVX2 )
+  {
+    return simdGetMRSADAVX2( pcDtParam, 16, pcDtParam->iSubShift );
+  }
+#endif
   Pel* piOrg   = pcDtParam->pOrg;
   Pel* piCur   = pcDtParam->pCur;
   Int  iRows   = pcDtParam->iRows;
@@ -1642,8 +2000,15 @@ UInt TComRdCost::xGetMRSAD16( DistParam* pcDtParam )
   return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT( pcDtParam->bitDepth - 8 ) );
 }
 
+template<SimdLevel eLevel>
 UInt TComRdCost::xGetMRSAD12( DistParam* pcDtParam )
 {
+#if SIMD_AVX2_MR_SAD && SIMD_AVX_TARGETS
+  if( pcDtParam->bitDepth <= 12 && eLevel >= SIMD_AVX2 )
+  {
+    return simdGetMRSADAVX2( pcDtParam, 12, pcDtParam->iSubShift );
+  }
+#endif
   Pel* piOrg   = pcDtParam->pOrg;
   Pel* piCur   = pcDtParam->pCur;
   Int  iRows   = pcDtParam->iRows;
@@ -1718,8 +2083,15 @@ UInt TComRdCost::xGetMRSAD12( DistParam* pcDtParam )
   return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT( pcDtParam->bitDepth - 8 ) );
 }
 
+template<SimdLevel eLevel>
 UInt TComRdCost::xGetMRSAD16N( DistParam* pcDtParam )
 {
+#if SIMD_AVX2_MR_SAD && SIMD_AVX_TARGETS
+  if( pcDtParam->bitDepth <= 12 && eLevel >= SIMD_AVX2 )
+  {
+    return simdGetMRSADAVX2( pcDtParam, ( ( pcDtParam->iCols + 15 ) >> 4 ) << 4, pcDtParam->iSubShift );
+  }
+#endif
   Pel* piOrg   = pcDtParam->pOrg;
   Pel* piCur   = pcDtParam->pCur;
   Int  iRows   = pcDtParam->iRows;
@@ -1810,8 +2182,15 @@ UInt TComRdCost::xGetMRSAD16N( DistParam* pcDtParam )
   return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT( pcDtParam->bitDepth - 8 ) );
 }
 
+template<SimdLevel eLevel>
 UInt TComRdCost::xGetMRSAD32( DistParam* pcDtParam )
 {
+#if SIMD_AVX2_MR_SAD && SIMD_AVX_TARGETS
+  if( pcDtParam->bitDepth <= 12 && eLevel >= SIMD_AVX2 )
+  {
+    return simdGetMRSADAVX2( pcDtParam, 32, pcDtParam->iSubShift );
+  }
+#endif
   Pel* piOrg   = pcDtParam->pOrg;
   Pel* piCur   = pcDtParam->pCur;
   Int  iRows   = pcDtParam->iRows;
@@ -1946,8 +2325,15 @@ UInt TComRdCost::xGetMRSAD32( DistParam* pcDtParam )
   return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT( pcDtParam->bitDepth - 8 ) );
 }
 
+template<SimdLevel eLevel>
 UInt TComRdCost::xGetMRSAD24( DistParam* pcDtParam )
 {
+#if SIMD_AVX2_MR_SAD && SIMD_AVX_TARGETS
+  if( pcDtParam->bitDepth <= 12 && eLevel >= SIMD_AVX2 )
+  {
+    return simdGetMRSADAVX2( pcDtParam, 24, pcDtParam->iSubShift );
+  }
+#endif
   Pel* piOrg   = pcDtParam->pOrg;
   Pel* piCur   = pcDtParam->pCur;
   Int  iRows   = pcDtParam->iRows;
@@ -2058,8 +2444,15 @@ UInt TComRdCost::xGetMRSAD24( DistParam* pcDtParam )
   return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT( pcDtParam->bitDepth - 8 ) );
 }
 
+template<SimdLevel eLevel>
 UInt TComRdCost::xGetMRSAD64( DistParam* pcDtParam )
 {
+#if SIMD_AVX2_MR_SAD && SIMD_AVX_TARGETS
+  if( pcDtParam->bitDepth <= 12 && eLevel >= SIMD_AVX2 )
+  {
+    return simdGetMRSADAVX2( pcDtParam, 64, pcDtParam->iSubShift );
+  }
+#endif
   Pel* piOrg   = pcDtParam->pOrg;
   Pel* piCur   = pcDtParam->pCur;
   Int  iRows   = pcDtParam->iRows;
@@ -2290,8 +2683,15 @@ UInt TComRdCost::xGetMRSAD64( DistParam* pcDtParam )
   return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT( pcDtParam->bitDepth - 8 ) );
 }
 
+template<SimdLevel eLevel>
 UInt TComRdCost::xGetMRSAD48( DistParam* pcDtParam )
 {
+#if SIMD_AVX2_MR_SAD && SIMD_AVX_TARGETS
+  if( pcDtParam->bitDepth <= 12 && eLevel >= SIMD_AVX2 )
+  {
+    return simdGetMRSADAVX2( pcDtParam, 48, pcDtParam->iSubShift );
+  }
+#endif
   Pel* piOrg   = pcDtParam->pOrg;
   Pel* piCur   = pcDtParam->pCur;
   Int  iRows   = pcDtParam->iRows;
@@ -2947,6 +3347,7 @@ Distortion TComRdCost::xCalcHADs4x4( Pel *piOrg, Pel *piCur, Int iStrideOrg, Int
   return satd;
 }
 
+template<SimdLevel eLevel>
 Distortion TComRdCost::xCalcHADs8x8( Pel *piOrg, Pel *piCur, Int iStrideOrg, Int iStrideCur, Int iStep 
 #if COM16_C806_SIMD_OPT
   , Int bitDepth
@@ -2954,7 +3355,7 @@ Distortion TComRdCost::xCalcHADs8x8( Pel *piOrg, Pel *piCur, Int iStrideOrg, Int
   )
 {
 #if COM16_C806_SIMD_OPT
-  if( bitDepth <= 10 )
+  if( bitDepth <= 10 && eLevel >= SIMD_SSE2 )
   {
     return( simdHADs8x8( piOrg , piCur , iStrideOrg , iStrideCur ) );
   }
@@ -3492,12 +3893,13 @@ Distortion TComRdCost::xCalcHADs8x4( Pel *piOrg, Pel *piCur, Int iStrideOrg, Int
 
 #endif
 
+template<SimdLevel eLevel>
 Distortion TComRdCost::xGetHADs( DistParam* pcDtParam )
 {
 #if VCEG_AZ06_IC
   if( pcDtParam->bMRFlag )
   {
-    return xGetMRHADs( pcDtParam );
+    return xGetMRHADs<eLevel>( pcDtParam );
   }
 #endif
   if ( pcDtParam->bApplyWeight )
@@ -3517,6 +3919,14 @@ Distortion TComRdCost::xGetHADs( DistParam* pcDtParam )
 
   Distortion uiSum = 0;
 
+#if SIMD_AVX2_HADAMARD && SIMD_AVX_TARGETS
+  if( iStep == 1 && pcDtParam->bitDepth <= 12 && eLevel >= SIMD_AVX2
+    && simdGetHADs( piOrg, piCur, iStrideOrg, iStrideCur, iRows, iCols, 0, uiSum ) )
+  {
+    return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
+  }
+#endif
+
 #if JVET_C0024_QTBT
   if ( iCols > iRows && iRows>=8) 
   {
@@ -3576,7 +3986,7 @@ Distortion TComRdCost::xGetHADs( DistParam* pcDtParam )
     {
       for ( x=0; x<iCols; x+= 8 )
       {
-        uiSum += xCalcHADs8x8( &piOrg[x], &piCur[x*iStep], iStrideOrg, iStrideCur, iStep 
+        uiSum += xCalcHADs8x8<eLevel>( &piOrg[x], &piCur[x*iStep], iStrideOrg, iStrideCur, iStep 
 #if COM16_C806_SIMD_OPT
           , pcDtParam->bitDepth
 #endif
@@ -3624,6 +4034,7 @@ Distortion TComRdCost::xGetHADs( DistParam* pcDtParam )
 }
 
 #if VCEG_AZ06_IC
+template<SimdLevel eLevel>
 UInt TComRdCost::xGetMRHADs( DistParam* pcDtParam )
 {
   Pel* piOrg   = pcDtParam->pOrg;
@@ -3640,6 +4051,17 @@ UInt TComRdCost::xGetMRHADs( DistParam* pcDtParam )
   Int  iOrigAvg = 0, iCurAvg = 0;
   Int  iDeltaC;
 
+#if SIMD_AVX2_HADAMARD && SIMD_AVX_TARGETS
+  if( iStep == 1 && pcDtParam->bitDepth <= 12 && eLevel >= SIMD_AVX2 && ( ( iRows | iCols ) & 0x03 ) == 0 )
+  {
+    // the mean offset is applied inside the kernels, so the original block is not modified
+    iDeltaC = simdSumDiffAVX2( piOrg, piCur, iStrideOrg, iStrideCur, iRows, iCols ) / iRows / iCols;
+    Distortion uiSIMDSum = 0;
+    simdGetHADs( piOrg, piCur, iStrideOrg, iStrideCur, iRows, iCols, iDeltaC, uiSIMDSum );
+    return ( (UInt)uiSIMDSum >> DISTORTION_PRECISION_ADJUSTMENT( pcDtParam->bitDepth - 8 ) );
+  }
+#endif
+
   for ( y=0; y<iRows; y++ )
   {
     for ( x=0; x<iCols; x++ )
@@ -3726,7 +4148,7 @@ UInt TComRdCost::xGetMRHADs( DistParam* pcDtParam )
     {
       for ( x=0; x<iCols; x+= 8 )
       {
-        uiSum += xCalcHADs8x8( &piOrg[x], &piCur[x*iStep], iStrideOrg, iStrideCur, iStep 
+        uiSum += xCalcHADs8x8<eLevel>( &piOrg[x], &piCur[x*iStep], iStrideOrg, iStrideCur, iStep 
 #if COM16_C806_SIMD_OPT
           , pcDtParam->bitDepth
 #endif
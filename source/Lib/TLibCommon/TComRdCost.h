@@ -112,7 +112,7 @@ class TComRdCost
 private:
   // for distortion
 
-  FpDistFunc              m_afpDistortFunc[DF_TOTAL_FUNCTIONS]; // [eDFunc]
+  static FpDistFunc       m_afpDistortFunc[DF_TOTAL_FUNCTIONS]; // [eDFunc], functions of the SIMD level selected by initSimdKernels()
   CostMode                m_costMode;
   Double                  m_distortionWeight[MAX_NUM_COMPONENT]; // only chroma values are used.
   Double                  m_dLambda;
@@ -155,6 +155,7 @@ public:
 
   // Distortion Functions
   Void    init();
+  static Void initSimdKernels( SimdLevel eLevel );
 
   Void    setDistParam( UInt uiBlkWidth, UInt uiBlkHeight, DFunc eDFunc, DistParam& rcDistParam );
   Void    setDistParam( TComPattern* pcPatternKey, Pel* piRefY, Int iRefStride,            DistParam& rcDistParam );
@@ -240,6 +241,8 @@ public:
 
 private:
 
+  template<SimdLevel eLevel> static Void       xInitDistortFunc  ();
+
   static Distortion xGetSSE           ( DistParam* pcDtParam );
   static Distortion xGetSSE4          ( DistParam* pcDtParam );
   static Distortion xGetSSE8          ( DistParam* pcDtParam );
@@ -248,26 +251,31 @@ private:
   static Distortion xGetSSE64         ( DistParam* pcDtParam );
   static Distortion xGetSSE16N        ( DistParam* pcDtParam );
 
-  static Distortion xGetSAD           ( DistParam* pcDtParam );
-  static Distortion xGetSAD4          ( DistParam* pcDtParam );
-  static Distortion xGetSAD8          ( DistParam* pcDtParam );
-  static Distortion xGetSAD16         ( DistParam* pcDtParam );
-  static Distortion xGetSAD32         ( DistParam* pcDtParam );
-  static Distortion xGetSAD64         ( DistParam* pcDtParam );
-  static Distortion xGetSAD16N        ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetSAD           ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetSAD4          ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetSAD8          ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetSAD16         ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetSAD32         ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetSAD64         ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetSAD16N        ( DistParam* pcDtParam );
 
-  static Distortion xGetSAD12         ( DistParam* pcDtParam );
-  static Distortion xGetSAD24         ( DistParam* pcDtParam );
-  static Distortion xGetSAD48         ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetSAD12         ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetSAD24         ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetSAD48         ( DistParam* pcDtParam );
 
-  static Distortion xGetHADs          ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetHADs          ( DistParam* pcDtParam );
   static Distortion xCalcHADs2x2      ( Pel *piOrg, Pel *piCurr, Int iStrideOrg, Int iStrideCur, Int iStep );
   static Distortion xCalcHADs4x4      ( Pel *piOrg, Pel *piCurr, Int iStrideOrg, Int iStrideCur, Int iStep );
-  static Distortion xCalcHADs8x8      ( Pel *piOrg, Pel *piCurr, Int iStrideOrg, Int iStrideCur, Int iStep 
+  template<SimdLevel eLevel> static Distortion xCalcHADs8x8      ( Pel *piOrg, Pel *piCurr, Int iStrideOrg, Int iStrideCur, Int iStep 
 #if COM16_C806_SIMD_OPT
     , Int bitDepth
 #endif
     );
+  static Distortion (*m_fpCalcHADs8x8)( Pel *piOrg, Pel *piCurr, Int iStrideOrg, Int iStrideCur, Int iStep
+#if COM16_C806_SIMD_OPT
+    , Int bitDepth
+#endif
+    );                                ///< xCalcHADs8x8() of the selected SIMD level, for calcHAD()
 #if JVET_C0024_QTBT
   static Distortion xCalcHADs16x8     ( Pel *piOrg, Pel *piCur, Int iStrideOrg, Int iStrideCur);
   static Distortion xCalcHADs8x16     ( Pel *piOrg, Pel *piCur, Int iStrideOrg, Int iStrideCur);
@@ -276,17 +284,17 @@ private:
 #endif
 
 #if VCEG_AZ06_IC
-  static Distortion xGetMRSAD         ( DistParam* pcDtParam );
-  static Distortion xGetMRSAD4        ( DistParam* pcDtParam );
-  static Distortion xGetMRSAD8        ( DistParam* pcDtParam );
-  static Distortion xGetMRSAD16       ( DistParam* pcDtParam );
-  static Distortion xGetMRSAD32       ( DistParam* pcDtParam );
-  static Distortion xGetMRSAD64       ( DistParam* pcDtParam );
-  static Distortion xGetMRSAD16N      ( DistParam* pcDtParam );
-  static Distortion xGetMRSAD12       ( DistParam* pcDtParam );
-  static Distortion xGetMRSAD24       ( DistParam* pcDtParam );
-  static Distortion xGetMRSAD48       ( DistParam* pcDtParam );
-  static Distortion xGetMRHADs        ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetMRSAD         ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetMRSAD4        ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetMRSAD8        ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetMRSAD16       ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetMRSAD32       ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetMRSAD64       ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetMRSAD16N      ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetMRSAD12       ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetMRSAD24       ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetMRSAD48       ( DistParam* pcDtParam );
+  template<SimdLevel eLevel> static Distortion xGetMRHADs        ( DistParam* pcDtParam );
 #endif
 
 public:
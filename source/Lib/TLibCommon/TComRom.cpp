@@ -46,13 +46,26 @@
 #include <assert.h>
 #include "TComDataCU.h"
 #include "Debug.h"
+#if SIMD_RUNTIME_DISPATCH
+#include "TComRdCost.h"
+#include "TComTrQuant.h"
+#include "TComInterpolationFilter.h"
+#include "TComPrediction.h"
+#include "TComAdaptiveLoopFilter.h"
+#endif
+#if PARALLEL_SEGMENT_ENCODING
+#include <mutex>
+#endif
+#if SIMD_RUNTIME_DISPATCH && defined(_MSC_VER)
+#include <intrin.h>
+#endif
 // ====================================================================================================================
 // Initialize / destroy functions
 // ====================================================================================================================
 
 //! \ingroup TLibCommon
 //! \{
-#if JVET_C0024_AMAX_BT
+#if JVET_C0024_AMAX_BT && !PARALLEL_SEGMENT_ENCODING
 UInt g_uiBlkSize[ 10 ];
 UInt g_uiNumBlk[ 10 ];
 #if JVET_C0024_AMAX_BT_FIX
@@ -62,11 +75,14 @@ Bool g_bInitAMaxBT = false;
 #endif
 
 #if VCEG_AZ08_KLT_COMMON
-short **g_ppsEigenVector[USE_MORE_BLOCKSIZE_DEPTH_MAX];
 #define MAX_KLTAREA (1<<(((USE_MORE_BLOCKSIZE_DEPTH_MAX)<<1) + 2))
 #if VCEG_AZ08_INTER_KLT
+#if PARALLEL_SUBSTREAM_ENCODING
+thread_local Bool g_bEnableCheck = true;
+#else
 Bool g_bEnableCheck = true;
 #endif
+#endif
 Void reOrderCoeff(TCoeff *pcCoef, const UInt *scan, UInt uiWidth, UInt uiHeight)
 {
     TCoeff coeff[MAX_KLTAREA];
@@ -99,6 +115,85 @@ Int getZorder(Int iLCUX, Int iLCUY, Int NumInRow)
 }
 #endif
 
+#if SIMD_RUNTIME_DISPATCH
+/** Widest SIMD level supported by both the CPU and the operating system
+ */
+SimdLevel detectSimdLevel()
+{
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+  __builtin_cpu_init();
+  if( __builtin_cpu_supports( "avx512f" ) && __builtin_cpu_supports( "avx512bw" ) )
+  {
+    return SIMD_AVX512;
+  }
+  if( __builtin_cpu_supports( "avx2" ) )
+  {
+    return SIMD_AVX2;
+  }
+  return __builtin_cpu_supports( "sse2" ) ? SIMD_SSE2 : SIMD_NONE;
+#elif defined(_MSC_VER) && ( defined(_M_X64) || defined(_M_IX86) )
+  Int regs[4];
+  __cpuid( regs, 0 );
+  const Int maxLeaf = regs[0];
+  __cpuid( regs, 1 );
+  const Bool sse2    = ( regs[3] & ( 1 << 26 ) ) != 0;
+  const Bool osAvx   = ( regs[2] & ( 1 << 27 ) ) != 0 && ( regs[2] & ( 1 << 28 ) ) != 0 && ( _xgetbv( 0 ) & 0x06 ) == 0x06;
+  const Bool osAvx512 = osAvx && ( _xgetbv( 0 ) & 0xe0 ) == 0xe0;
+  Bool avx2 = false, avx512 = false;
+  if( maxLeaf >= 7 )
+  {
+    __cpuidex( regs, 7, 0 );
+    avx2   = osAvx && ( regs[1] & ( 1 << 5 ) ) != 0;
+    avx512 = osAvx512 && ( regs[1] & ( 1 << 16 ) ) != 0 && ( regs[1] & ( 1 << 30 ) ) != 0;
+  }
+  return avx512 ? SIMD_AVX512 : avx2 ? SIMD_AVX2 : sse2 ? SIMD_SSE2 : SIMD_NONE;
+#else
+  return SIMD_NONE;
+#endif
+}
+
+static SimdLevel xGetSimdLevel( SimdLevel eMaxLevel )
+{
+#if SIMD_AVX_TARGETS
+  const SimdLevel eCpuLevel = detectSimdLevel();
+#else
+  const SimdLevel eCpuLevel = std::min( detectSimdLevel(), SIMD_SSE2 );
+#endif
+  return ( eMaxLevel == SIMD_AUTO || eMaxLevel > eCpuLevel ) ? eCpuLevel : eMaxLevel;
+}
+
+SimdLevel g_eSimdLevel = SIMD_NONE;
+
+/** Select the kernels of the widest SIMD level supported by the CPU, capped by eMaxLevel unless it is SIMD_AUTO.
+ *  The kernels are chosen once here, through the function tables of each module, and are never tested per call.
+ */
+Void initSimdLevel( SimdLevel eMaxLevel )
+{
+  g_eSimdLevel = xGetSimdLevel( eMaxLevel );
+  TComRdCost::initSimdKernels( g_eSimdLevel );
+  TComTrQuant::initSimdKernels( g_eSimdLevel );
+  TComInterpolationFilter::initSimdKernels( g_eSimdLevel );
+#if SIMD_AVX2_BIO || SIMD_AVX2_OBMC
+  TComPrediction::initSimdKernels( g_eSimdLevel );
+#endif
+#if SIMD_AVX2_ALF
+  TComAdaptiveLoopFilter::initSimdKernels( g_eSimdLevel );
+#endif
+}
+
+const Char* getSimdLevelName( SimdLevel eLevel )
+{
+  switch( eLevel )
+  {
+    case SIMD_NONE:   return "C";
+    case SIMD_SSE2:   return "SSE2";
+    case SIMD_AVX2:   return "AVX2";
+    case SIMD_AVX512: return "AVX-512";
+    default:          return "auto";
+  }
+}
+#endif
+
 const Char* nalUnitTypeToString(NalUnitType type)
 {
   switch (type)
@@ -224,9 +319,22 @@ public:
   }
 };
 
+#if PARALLEL_SEGMENT_ENCODING
+// the tables are shared by all encoder instances of a process: build them on first use, free them on last release
+static std::mutex s_romMutex;
+static Int        s_romRefCount = 0;
+#endif
+
 // initialize ROM variables
 Void initROM()
 {
+#if PARALLEL_SEGMENT_ENCODING
+  std::lock_guard<std::mutex> lock( s_romMutex );
+  if( s_romRefCount++ > 0 )
+  {
+    return;
+  }
+#endif
   Int i, c;
 
   // g_aucConvertToBit[ x ]: log2(x/4), if x=4 -> 0, x=8 -> 1, x=16 -> 2, ...
@@ -469,6 +577,13 @@ Void initROM()
 
 Void destroyROM()
 {
+#if PARALLEL_SEGMENT_ENCODING
+  std::lock_guard<std::mutex> lock( s_romMutex );
+  if( --s_romRefCount > 0 )
+  {
+    return;
+  }
+#endif
   for(UInt groupTypeIndex = 0; groupTypeIndex < SCAN_NUMBER_OF_GROUP_TYPES; groupTypeIndex++)
   {
     for (UInt scanOrderIndex = 0; scanOrderIndex < SCAN_NUMBER_OF_TYPES; scanOrderIndex++)
@@ -3385,7 +3500,11 @@ const UInt g_scalingListSizeX  [SCALING_LIST_SIZE_NUM] = { 4, 8, 16,  32
 #endif
 
 #if JVET_D0033_ADAPTIVE_CLIPPING
+#if PARALLEL_FRAME_DECODING || PARALLEL_SUBSTREAM_ENCODING
+thread_local ClipParam g_ClipParam;
+#else
 ClipParam g_ClipParam;
+#endif
 Int ClipParam::nbBitsY;
 Int ClipParam::nbBitsUV;
 Int ClipParam::ibdLuma;
@@ -42,16 +42,17 @@
 
 #include<stdio.h>
 #include<iostream>
-#if VCEG_AZ08_KLT_COMMON
-extern short **g_ppsEigenVector[USE_MORE_BLOCKSIZE_DEPTH_MAX];
-#endif
 //! \ingroup TLibCommon
 //! \{
 
 #if VCEG_AZ08_KLT_COMMON
 #if VCEG_AZ08_INTER_KLT
+#if PARALLEL_SUBSTREAM_ENCODING
+extern thread_local Bool g_bEnableCheck;  ///< per thread: set by the CU encoder of the thread for its own KLT search
+#else
 extern Bool g_bEnableCheck;
 #endif
+#endif
 Void         reOrderCoeff(TCoeff *pcCoef, const UInt *scan, UInt uiWidth, UInt uiHeight);
 Void         recoverOrderCoeff(TCoeff *pcCoef, const UInt *scan, UInt uiWidth, UInt uiHeight);
 #endif
@@ -69,7 +70,7 @@ Void         destroyROM();
 // ====================================================================================================================
 // Data structure related table & variable
 // ====================================================================================================================
-#if JVET_C0024_AMAX_BT
+#if JVET_C0024_AMAX_BT && !PARALLEL_SEGMENT_ENCODING
 extern UInt g_uiBlkSize[ 10 ];
 extern UInt g_uiNumBlk[ 10 ];
 #if JVET_C0024_AMAX_BT_FIX
@@ -258,6 +259,20 @@ extern UInt64 g_nSymbolCounter;
 
 const Char* nalUnitTypeToString(NalUnitType type);
 
+#if SIMD_RUNTIME_DISPATCH
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) ) && !RExt__HIGH_BIT_DEPTH_SUPPORT
+#define SIMD_AVX_TARGETS                                  1 ///< the compiler can build AVX2/AVX-512 kernels with target attributes, without changing the instruction set of the rest of the code
+#else
+#define SIMD_AVX_TARGETS                                  0
+#endif
+
+extern SimdLevel g_eSimdLevel;                        ///< SIMD level of the kernels selected by initSimdLevel(), the C code until it is called
+
+SimdLevel   detectSimdLevel   ();
+Void        initSimdLevel     ( SimdLevel eMaxLevel );
+const Char* getSimdLevelName  ( SimdLevel eLevel );
+#endif
+
 extern const Char *MatrixType[SCALING_LIST_SIZE_NUM][SCALING_LIST_NUM];
 extern const Char *MatrixType_DC[SCALING_LIST_SIZE_NUM][SCALING_LIST_NUM];
 
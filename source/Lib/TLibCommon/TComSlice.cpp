@@ -50,6 +50,10 @@ Bool TComSlice::m_bScaleFactorValid = false;
 Int TComSlice::m_iScaleFactor[256][256];
 #endif
 
+#if JVET_C0024_QTBT && (PARALLEL_SUBSTREAM_DECODING || PARALLEL_SUBSTREAM_ENCODING)
+thread_local ChannelType TComSlice::s_eThreadTextType = CHANNEL_TYPE_LUMA;
+#endif
+
 TComSlice::TComSlice()
 : m_iPPSId                        ( -1 )
 , m_PicOutputFlag                 ( true )
@@ -121,6 +125,9 @@ TComSlice::TComSlice()
 #endif
 #if JVET_C0024_QTBT
 , m_eType                         (CHANNEL_TYPE_LUMA)
+#if PARALLEL_SUBSTREAM_DECODING || PARALLEL_SUBSTREAM_ENCODING
+, m_bThreadTextType               (false)
+#endif
 #endif
 {
   for(UInt i=0; i<NUM_REF_PIC_LIST_01; i++)
@@ -383,6 +390,9 @@ Void TComSlice::setRefPicList( TComList<TComPic*>& rcListPic, Bool checkNumPocTo
     if(m_pRPS->getUsed(i))
     {
       pcRefPic = xGetRefPic(rcListPic, getPOC()+m_pRPS->getDeltaPOC(i));
+#if PARALLEL_FRAME_DECODING
+      pcRefPic->waitForLoopFilter();   // the reference may still be loop-filtered on another thread
+#endif
       pcRefPic->setIsLongTerm(0);
       pcRefPic->getPicYuvRec()->extendPicBorder();
       RefPicSetStCurr0[NumPicStCurr0] = pcRefPic;
@@ -396,6 +406,9 @@ Void TComSlice::setRefPicList( TComList<TComPic*>& rcListPic, Bool checkNumPocTo
     if(m_pRPS->getUsed(i))
     {
       pcRefPic = xGetRefPic(rcListPic, getPOC()+m_pRPS->getDeltaPOC(i));
+#if PARALLEL_FRAME_DECODING
+      pcRefPic->waitForLoopFilter();
+#endif
       pcRefPic->setIsLongTerm(0);
       pcRefPic->getPicYuvRec()->extendPicBorder();
       RefPicSetStCurr1[NumPicStCurr1] = pcRefPic;
@@ -409,6 +422,9 @@ Void TComSlice::setRefPicList( TComList<TComPic*>& rcListPic, Bool checkNumPocTo
     if(m_pRPS->getUsed(i))
     {
       pcRefPic = xGetLongTermRefPic(rcListPic, m_pRPS->getPOC(i), m_pRPS->getCheckLTMSBPresent(i));
+#if PARALLEL_FRAME_DECODING
+      pcRefPic->waitForLoopFilter();
+#endif
       pcRefPic->setIsLongTerm(1);
       pcRefPic->getPicYuvRec()->extendPicBorder();
       RefPicSetLtCurr[NumPicLtCurr] = pcRefPic;
@@ -2432,11 +2448,16 @@ Void TComSlice::initStatsGlobal()
     Int iQP = -1,  k;
 #if VCEG_AZ07_INIT_PREVFRAME_FIX
     Bool bIRAP = getRapPicFlag();
+#if !PARALLEL_SEGMENT_ENCODING
     static Bool bClearPrevFlag = false;
+#endif
 #endif
     Int uiSliceType = getSliceType();
     Int uiSliceQP   = getSliceQp  ();
     TComStats* pcStats = getStatsHandle();
+#if VCEG_AZ07_INIT_PREVFRAME_FIX && PARALLEL_SEGMENT_ENCODING
+    Bool &bClearPrevFlag = pcStats->m_bClearPrevFlag;
+#endif
 
     for (k = 0; k < NUM_QP_PROB; k++)
     {
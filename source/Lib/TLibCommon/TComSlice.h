@@ -1634,6 +1634,10 @@ private:
 #endif
 #if JVET_C0024_QTBT
   ChannelType                m_eType;             ///< The channelType current CTB is coding
+#if PARALLEL_SUBSTREAM_DECODING || PARALLEL_SUBSTREAM_ENCODING
+  Bool                       m_bThreadTextType;   ///< if true, the CTUs of the slice are coded on several threads and each thread keeps its own channelType
+  static thread_local ChannelType s_eThreadTextType;
+#endif
 #endif
 
 public:
@@ -1895,9 +1899,15 @@ public:
 #endif
 
 #if JVET_C0024_QTBT
+#if PARALLEL_SUBSTREAM_DECODING || PARALLEL_SUBSTREAM_ENCODING
+  ChannelType   getTextType() const {return m_bThreadTextType ? s_eThreadTextType : m_eType;}
+  Void          setTextType(ChannelType eCType) { if (m_bThreadTextType) { s_eThreadTextType = eCType; } else { m_eType = eCType; } }
+  Void          setThreadTextType(Bool b)       { m_bThreadTextType = b; }
+#else
   ChannelType   getTextType() const {return m_eType;}
   Void          setTextType(ChannelType eCType) { m_eType = eCType;}
 #endif
+#endif
 protected:
   TComPic*                    xGetRefPic        (TComList<TComPic*>& rcListPic, Int poc);
   TComPic*                    xGetLongTermRefPic(TComList<TComPic*>& rcListPic, Int poc, Bool pocHasMsb);
@@ -66,7 +66,7 @@ TComTU::TComTU(TComDataCU *pcCU, const UInt absPartIdxCU, const UInt cuDepth, co
 #endif
 
 #if JVET_C0024_QTBT
-  const UInt baseOffset444= absPartIdxCU==0 ? 0: pcCU->getPic()->getCodedAreaInCTU()-pcCU->getWidth( absPartIdxCU)*pcCU->getHeight(absPartIdxCU);
+  const UInt baseOffset444= absPartIdxCU==0 ? 0: pcCU->getPic()->getCodedAreaInCTU(pcCU->getCtuRsAddr())-pcCU->getWidth( absPartIdxCU)*pcCU->getHeight(absPartIdxCU);
 #else
   const UInt baseOffset444=pcCU->getPic()->getMinCUWidth()*pcCU->getPic()->getMinCUHeight()*absPartIdxCU;
 #endif
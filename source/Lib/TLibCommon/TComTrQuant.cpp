@@ -48,6 +48,9 @@
 #if VCEG_AZ08_KLT_COMMON
 #include <algorithm>
 #endif
+#if PRIMARY_TRANSFORM_CACHE
+#include <atomic>
+#endif
 
 #if VCEG_AZ08_USE_SSE_SPEEDUP
 #include <intrin.h>
@@ -72,6 +75,45 @@ UInt GetSAD16x16_SSE_U16(I16 **pSrc, I16 *pRef, Int iRefStride, Int iYOffset, In
 UInt GetSAD32x32_SSE_U16(I16 **pSrc, I16 *pRef, Int iRefStride, Int iYOffset, Int iXOffset, UInt uiBestSAD);
 #endif
 
+#if SIMD_AVX2_TRANSFORM && SIMD_AVX_TARGETS && COM16_C806_EMT && JVET_D0077_TRANSFORM_OPT && JVET_C0024_QTBT
+#define AVX_TRANSFORM_KERNELS                             1
+#else
+#define AVX_TRANSFORM_KERNELS                             0
+#endif
+#if SIMD_AVX2_NSST && SIMD_AVX_TARGETS && COM16_C1044_NSST && JVET_D0120_NSST_IMPROV
+#define AVX_NSST_KERNELS                                  1
+#else
+#define AVX_NSST_KERNELS                                  0
+#endif
+#if SIMD_AVX2_RDOQ && SIMD_AVX_TARGETS
+#define AVX_RDOQ_KERNELS                                  1
+#else
+#define AVX_RDOQ_KERNELS                                  0
+#endif
+#if SIMD_AVX2_KLT_SAD && SIMD_AVX_TARGETS && VCEG_AZ08_KLT_COMMON && VCEG_AZ08_USE_SAD_DISTANCE
+#define AVX_KLT_SAD_KERNELS                               1
+#else
+#define AVX_KLT_SAD_KERNELS                               0
+#endif
+#if SIMD_SSE2_KLT_SAD && VCEG_AZ08_KLT_COMMON && VCEG_AZ08_USE_SAD_DISTANCE && !VCEG_AZ08_USE_SSE_SPEEDUP
+#define SSE2_KLT_SAD_KERNELS                              1
+#else
+#define SSE2_KLT_SAD_KERNELS                              0
+#endif
+#if SIMD_AVX2_KLT_DERIVE && SIMD_AVX_TARGETS && VCEG_AZ08_KLT_COMMON && !VCEG_AZ08_USE_SSE_SPEEDUP
+#define AVX_KLT_DERIVE_KERNELS                            1
+#else
+#define AVX_KLT_DERIVE_KERNELS                            0
+#endif
+#if AVX_TRANSFORM_KERNELS || AVX_NSST_KERNELS || AVX_RDOQ_KERNELS || AVX_KLT_SAD_KERNELS || AVX_KLT_DERIVE_KERNELS
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"   // _mm512_undefined_epi32() in the AVX-512 intrinsics
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#elif SSE2_KLT_SAD_KERNELS
+#include <emmintrin.h>
+#endif
+
 #if VCEG_AZ08_KLT_COMMON //only support 4x4-32x32 now
 UInt g_uiDepth2MaxCandiNum[5] = { MAX_CANDI_NUM, MAX_CANDI_NUM, MAX_CANDI_NUM, MAX_CANDI_NUM, MAX_CANDI_NUM };
 UInt g_uiDepth2MinCandiNum[5] = { 8, 8, 8, 8, 8 };
@@ -123,8 +165,19 @@ typedef VectorXf vectorType; //VectorXd
 typedef MatrixXd matrixTypeDefined; //MatrixXd
 typedef VectorXd vectorType; //VectorXd
 #endif
-void xKLTr(Int bitDepth, TCoeff *block, TCoeff *coeff, UInt uiTrSize);
-void xIKLTr(Int bitDepth, TCoeff *coeff, TCoeff *block, UInt uiTrSize);
+#if KLT_PREALLOCATED_EIGEN_SOLVER
+/// matrix and eigen decomposition of one dimension, allocated when the dimension is first decomposed. They keep the
+/// dynamic matrix type of the per-call solver: matrices of fixed capacity take other code paths in Eigen, whose
+/// rounding differs in the last bits.
+struct KLTEigenSolver
+{
+  KLTEigenSolver(UInt uiDim) : cMatrix(uiDim, uiDim), cSolver(uiDim) {}
+  matrixTypeDefined                         cMatrix;
+  SelfAdjointEigenSolver<matrixTypeDefined> cSolver;
+};
+#endif
+void xKLTr(Int bitDepth, TCoeff *block, TCoeff *coeff, UInt uiTrSize, Short **pTMat);
+void xIKLTr(Int bitDepth, TCoeff *coeff, TCoeff *block, UInt uiTrSize, Short **pTMat);
 #endif
 
 typedef struct
@@ -136,11 +189,402 @@ typedef struct
   Double d64SigCost_0;
 } coeffGroupRDStats;
 
+#if AVX_TRANSFORM_KERNELS
+/**
+ * \brief Forward 1-D transform of N points as a matrix product, bit-exact with the fastForward*() functions
+ *
+ * Line i of src is multiplied by the rows j < cutoff of the transform matrix iT and the results are stored
+ * transposed, dst[j*line+i]. Skipped lines and rows are zeroed as in the C code. The C butterflies only
+ * regroup the same integer products, and 32-bit wrap-around sums do not depend on the order, so the results
+ * are identical.
+ */
+template<Int N>
+__attribute__((target("avx2")))
+static Void simdForwardTransformAVX2( const TMatrixCoeff *iT, const TCoeff *src, TCoeff *dst, Int shift, Int line, Int iSkipLine, Int cutoff )
+{
+  const Int reducedLine = line - iSkipLine;
+
+  if( N == 4 )
+  {
+    const __m128i vRnd = _mm_set1_epi32( 1 << ( shift - 1 ) );
+    __m128i vT[4];
+    for( Int j = 0; j < 4; j++ )
+    {
+      vT[j] = _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* )( iT + j * 4 ) ) );
+    }
+    for( Int i = 0; i < reducedLine; i++, src += 4 )
+    {
+      const __m128i vSrc = _mm_loadu_si128( ( const __m128i* )src );
+      __m128i vSum = _mm_hadd_epi32( _mm_hadd_epi32( _mm_mullo_epi32( vSrc, vT[0] ), _mm_mullo_epi32( vSrc, vT[1] ) ),
+                                     _mm_hadd_epi32( _mm_mullo_epi32( vSrc, vT[2] ), _mm_mullo_epi32( vSrc, vT[3] ) ) );
+      TCoeff aiSum[4];
+      _mm_storeu_si128( ( __m128i* )aiSum, _mm_srai_epi32( _mm_add_epi32( vSum, vRnd ), shift ) );
+      for( Int j = 0; j < cutoff; j++ )
+      {
+        dst[j * line + i] = aiSum[j];
+      }
+    }
+  }
+  else
+  {
+    const __m256i vRnd = _mm256_set1_epi32( 1 << ( shift - 1 ) );
+    for( Int i = 0; i < reducedLine; i++, src += N )
+    {
+      for( Int j = 0; j < cutoff; j += 8 )
+      {
+        __m256i vProd[8];
+        for( Int jj = 0; jj < 8; jj++ )
+        {
+          const TMatrixCoeff *pT = iT + ( j + jj ) * N;
+          __m256i vAcc = _mm256_setzero_si256();
+          for( Int k = 0; k < N; k += 8 )
+          {
+            const __m256i vCoef = _mm256_cvtepi16_epi32( _mm_loadu_si128( ( const __m128i* )( pT + k ) ) );
+            vAcc = _mm256_add_epi32( vAcc, _mm256_mullo_epi32( _mm256_loadu_si256( ( const __m256i* )( src + k ) ), vCoef ) );
+          }
+          vProd[jj] = vAcc;
+        }
+        // horizontal sums of the 8 accumulators, in the order j .. j+7
+        const __m256i vSum0123 = _mm256_hadd_epi32( _mm256_hadd_epi32( vProd[0], vProd[1] ), _mm256_hadd_epi32( vProd[2], vProd[3] ) );
+        const __m256i vSum4567 = _mm256_hadd_epi32( _mm256_hadd_epi32( vProd[4], vProd[5] ), _mm256_hadd_epi32( vProd[6], vProd[7] ) );
+        __m256i vSum = _mm256_add_epi32( _mm256_permute2x128_si256( vSum0123, vSum4567, 0x20 ), _mm256_permute2x128_si256( vSum0123, vSum4567, 0x31 ) );
+
+        TCoeff aiSum[8];
+        _mm256_storeu_si256( ( __m256i* )aiSum, _mm256_srai_epi32( _mm256_add_epi32( vSum, vRnd ), shift ) );
+        const Int iNum = std::min( 8, cutoff - j );
+        for( Int jj = 0; jj < iNum; jj++ )
+        {
+          dst[( j + jj ) * line + i] = aiSum[jj];
+        }
+      }
+    }
+  }
+
+  if( iSkipLine )
+  {
+    for( Int j = 0; j < cutoff; j++ )
+    {
+      memset( dst + j * line + reducedLine, 0, sizeof( TCoeff ) * iSkipLine );
+    }
+  }
+  if( cutoff < N )
+  {
+    memset( dst + line * cutoff, 0, sizeof( TCoeff ) * line * ( N - cutoff ) );
+  }
+}
+
+/**
+ * \brief Inverse 1-D transform of N points as a matrix product, bit-exact with the fastInverse*() functions
+ *
+ * Only the first cutoff coefficients of each line are used, and zero coefficients are skipped.
+ */
+template<Int N>
+__attribute__((target("avx2")))
+static Void simdInverseTransformAVX2( const TMatrixCoeff *iT, const TCoeff *src, TCoeff *dst, Int shift, Int line, Int iSkipLine, Int cutoff, const TCoeff outputMinimum, const TCoeff outputMaximum )
+{
+  const Int reducedLine = line - iSkipLine;
+
+  if( N == 4 )
+  {
+    const __m128i vRnd = _mm_set1_epi32( 1 << ( shift - 1 ) );
+    const __m128i vMin = _mm_set1_epi32( outputMinimum );
+    const __m128i vMax = _mm_set1_epi32( outputMaximum );
+    for( Int i = 0; i < reducedLine; i++, src++, dst += 4 )
+    {
+      __m128i vAcc = _mm_setzero_si128();
+      for( Int k = 0; k < cutoff; k++ )
+      {
+        const __m128i vCoef = _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* )( iT + k * 4 ) ) );
+        vAcc = _mm_add_epi32( vAcc, _mm_mullo_epi32( _mm_set1_epi32( src[k * line] ), vCoef ) );
+      }
+      vAcc = _mm_srai_epi32( _mm_add_epi32( vAcc, vRnd ), shift );
+      _mm_storeu_si128( ( __m128i* )dst, _mm_min_epi32( _mm_max_epi32( vAcc, vMin ), vMax ) );
+    }
+  }
+  else
+  {
+    const __m256i vRnd = _mm256_set1_epi32( 1 << ( shift - 1 ) );
+    const __m256i vMin = _mm256_set1_epi32( outputMinimum );
+    const __m256i vMax = _mm256_set1_epi32( outputMaximum );
+    for( Int i = 0; i < reducedLine; i++, src++, dst += N )
+    {
+      __m256i vAcc[N / 8];
+      for( Int j = 0; j < N / 8; j++ )
+      {
+        vAcc[j] = _mm256_setzero_si256();
+      }
+      for( Int k = 0; k < cutoff; k++ )
+      {
+        const TCoeff c = src[k * line];
+        if( c == 0 )
+        {
+          continue;
+        }
+        const __m256i vC = _mm256_set1_epi32( c );
+        const TMatrixCoeff *pT = iT + k * N;
+        for( Int j = 0; j < N / 8; j++ )
+        {
+          const __m256i vCoef = _mm256_cvtepi16_epi32( _mm_loadu_si128( ( const __m128i* )( pT + j * 8 ) ) );
+          vAcc[j] = _mm256_add_epi32( vAcc[j], _mm256_mullo_epi32( vC, vCoef ) );
+        }
+      }
+      for( Int j = 0; j < N / 8; j++ )
+      {
+        const __m256i vRes = _mm256_srai_epi32( _mm256_add_epi32( vAcc[j], vRnd ), shift );
+        _mm256_storeu_si256( ( __m256i* )( dst + j * 8 ), _mm256_min_epi32( _mm256_max_epi32( vRes, vMin ), vMax ) );
+      }
+    }
+  }
+
+  if( iSkipLine )
+  {
+    memset( dst, 0, sizeof( TCoeff ) * N * iSkipLine );
+  }
+}
+
+/**
+ * \brief EMT matrix of an N-point transform for the AVX2 kernels, the DCT2 of 4 to 32 points and the 4-point DST7
+ * use the HEVC matrices unless use is set, as the fastForward*() and fastInverse*() functions do
+ */
+template<Int N, Int iType>
+static const TMatrixCoeff* simdTransformMatrix( Int use )
+{
+  if( !use && iType == DCT2 && N <= 32 )
+  {
+    return N == 4 ? g_aiT4[0][0] : N == 8 ? g_aiT8[0][0] : N == 16 ? g_aiT16[0][0] : g_aiT32[0][0];
+  }
+  if( !use && iType == DST7 && N == 4 )
+  {
+    return g_as_DST_MAT_4[0][0];
+  }
+  return N == 4 ? g_aiTr4[iType][0] : N == 8 ? g_aiTr8[iType][0] : N == 16 ? g_aiTr16[iType][0] : N == 32 ? g_aiTr32[iType][0] : N == 64 ? g_aiTr64[iType][0] : g_aiTr128[iType][0];
+}
+
+/**
+ * \brief fastForward*() function of an N-point transform with simdForwardTransformAVX2(), the output rows the C code
+ * does not zero out are computed: all of them for the DCT2 of 4 to 32 points and the 4-point transforms but the DCT5
+ */
+template<Int N, Int iType>
+static void simdFastForwardAVX2( TCoeff *src, TCoeff *dst, Int shift, Int line, Int iSkipLine, Int iSkipLine2, Int use )
+{
+  const Bool bAllRows = ( iType == DCT2 && N <= 32 ) || ( iType != DCT5 && N == 4 );
+  simdForwardTransformAVX2<N>( simdTransformMatrix<N, iType>( use ), src, dst, shift, line, iSkipLine, bAllRows ? N : N - iSkipLine2 );
+}
+
+/**
+ * \brief fastInverse*() function of an N-point transform with simdInverseTransformAVX2(), the DCT2 of 64 and 128 points
+ * skip the input rows by steps of 32 as the C code does
+ */
+template<Int N, Int iType>
+static void simdFastInverseAVX2( TCoeff *src, TCoeff *dst, Int shift, Int line, Int iSkipLine, Int iSkipLine2, Int use, const TCoeff outputMinimum, const TCoeff outputMaximum )
+{
+  const Bool bAllRows = ( iType == DCT2 && N <= 32 ) || ( iType != DCT5 && N == 4 );
+  const Int  cutoff   = bAllRows ? N : iType == DCT2 ? std::max( 32, N - ( iSkipLine2 >> 5 << 5 ) ) : N - iSkipLine2;
+  simdInverseTransformAVX2<N>( simdTransformMatrix<N, iType>( use ), src, dst, shift, line, iSkipLine, cutoff, outputMinimum, outputMaximum );
+}
+#endif
+
+#if AVX_NSST_KERNELS
+/**
+ * \brief HyGT rounds of the NSST on N = 16 (4x4) or N = 64 (8x8) coefficients, bit-exact with FwdNsst*() and InvNsst*()
+ *
+ * The coefficients are kept in N/8 registers, coefficient j in lane j%8 of register j/8. A rotation step
+ * along dimension d pairs j with j + (1 << d): for d >= 3 the pairs are the same lanes of two registers,
+ * for d < 3 two registers are permuted so that one holds the first and the other the second elements of
+ * 8 pairs. Either way the 8 pairs of a vector use 8 consecutive parameters of the step.
+ */
+template<Int N, Bool bInverse>
+__attribute__((target("avx2")))
+static Void simdNsstHyGTAVX2( Int* src, const Int* par, Int rnd, Int shl )
+{
+  const Int iNumDims  = N == 16 ? 4 : 6;
+  const Int iNumRegs  = N / 8;
+  const Int iNumPairs = N / 2;
+  const Int iNumSteps = rnd * iNumDims;
+
+  // lane orders that put the first elements of the pairs of dimension d in the low half and their partners in the high half
+  const __m256i vPermFwd[3] = { _mm256_setr_epi32( 0, 2, 4, 6, 1, 3, 5, 7 ), _mm256_setr_epi32( 0, 1, 4, 5, 2, 3, 6, 7 ), _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 ) };
+  const __m256i vPermInv[3] = { _mm256_setr_epi32( 0, 4, 1, 5, 2, 6, 3, 7 ), _mm256_setr_epi32( 0, 1, 4, 5, 2, 3, 6, 7 ), _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 ) };
+
+  __m256i vReg[iNumRegs];
+  for( Int r = 0; r < iNumRegs; r++ )
+  {
+    vReg[r] = _mm256_slli_epi32( _mm256_loadu_si256( ( const __m256i* )( src + 8 * r ) ), shl );
+  }
+
+  for( Int t = 0; t < iNumSteps; t++ )
+  {
+    const Int  r     = bInverse ? rnd - 1 - t / iNumDims : t / iNumDims;
+    const Int  d     = bInverse ? iNumDims - 1 - t % iNumDims : t % iNumDims;
+    const Bool bLast = t == iNumSteps - 1;
+    const Int  iShift = bLast ? 10 + shl : 10;
+    const __m256i vRnd = _mm256_set1_epi32( bLast ? 1 << ( shl + 9 ) : 512 );
+    const Int* p = par + ( r * iNumDims + d ) * iNumPairs;
+
+    for( Int k = 0; k < iNumRegs / 2; k++ )
+    {
+      Int ra, rb;
+      __m256i a, b;
+      if( d >= 3 )
+      {
+        const Int sr = 1 << ( d - 3 );
+        ra = ( ( k >> ( d - 3 ) ) << ( d - 2 ) ) | ( k & ( sr - 1 ) );
+        rb = ra + sr;
+        a  = vReg[ra];
+        b  = vReg[rb];
+      }
+      else
+      {
+        ra = 2 * k;
+        rb = 2 * k + 1;
+        const __m256i x = _mm256_permutevar8x32_epi32( vReg[ra], vPermFwd[d] );
+        const __m256i y = _mm256_permutevar8x32_epi32( vReg[rb], vPermFwd[d] );
+        a = _mm256_permute2x128_si256( x, y, 0x20 );
+        b = _mm256_permute2x128_si256( x, y, 0x31 );
+      }
+
+      const __m256i vIdx = _mm256_loadu_si256( ( const __m256i* )( p + 8 * k ) );
+      const __m256i vCos = _mm256_i32gather_epi32( &g_tabSinCos[0].c, vIdx, sizeof( tabSinCos ) );
+      const __m256i vSin = _mm256_i32gather_epi32( &g_tabSinCos[0].s, vIdx, sizeof( tabSinCos ) );
+      const __m256i ca = _mm256_mullo_epi32( vCos, a );
+      const __m256i cb = _mm256_mullo_epi32( vCos, b );
+      const __m256i sa = _mm256_mullo_epi32( vSin, a );
+      const __m256i sb = _mm256_mullo_epi32( vSin, b );
+      __m256i a2 = bInverse ? _mm256_add_epi32( ca, sb ) : _mm256_sub_epi32( ca, sb );
+      __m256i b2 = bInverse ? _mm256_sub_epi32( cb, sa ) : _mm256_add_epi32( cb, sa );
+      a2 = _mm256_srai_epi32( _mm256_add_epi32( a2, vRnd ), iShift );
+      b2 = _mm256_srai_epi32( _mm256_add_epi32( b2, vRnd ), iShift );
+
+      if( d >= 3 )
+      {
+        vReg[ra] = a2;
+        vReg[rb] = b2;
+      }
+      else
+      {
+        vReg[ra] = _mm256_permutevar8x32_epi32( _mm256_permute2x128_si256( a2, b2, 0x20 ), vPermInv[d] );
+        vReg[rb] = _mm256_permutevar8x32_epi32( _mm256_permute2x128_si256( a2, b2, 0x31 ), vPermInv[d] );
+      }
+    }
+  }
+
+  for( Int r = 0; r < iNumRegs; r++ )
+  {
+    _mm256_storeu_si256( ( __m256i* )( src + 8 * r ), vReg[r] );
+  }
+}
+
+static Void (*s_afpNsstHyGT[2][2])( Int* src, const Int* par, Int rnd, Int shl ) = { { NULL } }; ///< [8x8][inverse], selected by TComTrQuant::initSimdKernels(), NULL: the C code
+#endif
+
+#if RDOQ_BLOCK_QUANT
+#if AVX_RDOQ_KERNELS
+__attribute__((target("avx2")))
+static Bool simdQuantBlockRDOQAVX2( const TCoeff* plSrcCoeff, UInt uiNumCoeff, const Int* piQCoef, Int iQCoef, const Double* pdErrScale, Double dErrScale,
+                                    Int iQBits, TCoeff iMaxLevel, TCoeff* piArlDstCoeff, Int iQBitsC, Int iAddC,
+                                    Intermediate_Int* plLevelDouble, UInt* puiMaxAbsLevel, Double* pdUncodedCost )
+{
+  const __m256i vLimit  = _mm256_set1_epi64x( std::numeric_limits<Intermediate_Int>::max() - ( Intermediate_Int( 1 ) << ( iQBits - 1 ) ) );
+  const __m256i vHalf   = _mm256_set1_epi32( 1 << ( iQBits - 1 ) );
+  const __m256i vMax    = _mm256_set1_epi32( iMaxLevel );
+  const __m256i vAddC   = _mm256_set1_epi32( iAddC );
+  const __m128i vShift  = _mm_cvtsi32_si128( iQBits );
+  const __m128i vShiftC = _mm_cvtsi32_si128( iQBitsC );
+  __m256i vAny = _mm256_setzero_si256();
+
+  for( UInt n = 0; n < uiNumCoeff; n += 8 )
+  {
+    const __m256i vAbs = _mm256_abs_epi32( _mm256_loadu_si256( ( const __m256i* )( plSrcCoeff + n ) ) );
+    const __m256i vQ   = piQCoef ? _mm256_loadu_si256( ( const __m256i* )( piQCoef + n ) ) : _mm256_set1_epi32( iQCoef );
+
+    // 64-bit products of the even and the odd lanes, clipped as the C code does before going back to 32 bits
+    __m256i vEven = _mm256_mul_epu32( vAbs, vQ );
+    __m256i vOdd  = _mm256_mul_epu32( _mm256_srli_epi64( vAbs, 32 ), _mm256_srli_epi64( vQ, 32 ) );
+    vEven = _mm256_blendv_epi8( vEven, vLimit, _mm256_cmpgt_epi64( vEven, vLimit ) );
+    vOdd  = _mm256_blendv_epi8( vOdd,  vLimit, _mm256_cmpgt_epi64( vOdd,  vLimit ) );
+    const __m256i vLevelDouble = _mm256_blend_epi32( vEven, _mm256_slli_epi64( vOdd, 32 ), 0xAA );
+    const __m256i vMaxAbsLevel = _mm256_min_epi32( vMax, _mm256_sra_epi32( _mm256_add_epi32( vLevelDouble, vHalf ), vShift ) );
+
+    _mm256_storeu_si256( ( __m256i* )( plLevelDouble  + n ), vLevelDouble );
+    _mm256_storeu_si256( ( __m256i* )( puiMaxAbsLevel + n ), vMaxAbsLevel );
+    if( piArlDstCoeff )
+    {
+      _mm256_storeu_si256( ( __m256i* )( piArlDstCoeff + n ), _mm256_sra_epi32( _mm256_add_epi32( vLevelDouble, vAddC ), vShiftC ) );
+    }
+    vAny = _mm256_or_si256( vAny, vMaxAbsLevel );
+
+    const __m256d vErr0   = _mm256_cvtepi32_pd( _mm256_castsi256_si128( vLevelDouble ) );
+    const __m256d vErr1   = _mm256_cvtepi32_pd( _mm256_extracti128_si256( vLevelDouble, 1 ) );
+    const __m256d vScale0 = pdErrScale ? _mm256_loadu_pd( pdErrScale + n     ) : _mm256_set1_pd( dErrScale );
+    const __m256d vScale1 = pdErrScale ? _mm256_loadu_pd( pdErrScale + n + 4 ) : _mm256_set1_pd( dErrScale );
+    _mm256_storeu_pd( pdUncodedCost + n,     _mm256_mul_pd( _mm256_mul_pd( vErr0, vErr0 ), vScale0 ) );
+    _mm256_storeu_pd( pdUncodedCost + n + 4, _mm256_mul_pd( _mm256_mul_pd( vErr1, vErr1 ), vScale1 ) );
+  }
+
+  return !_mm256_testz_si256( vAny, vAny );
+}
+
+static Bool (*s_fpQuantBlockRDOQ)( const TCoeff* plSrcCoeff, UInt uiNumCoeff, const Int* piQCoef, Int iQCoef, const Double* pdErrScale, Double dErrScale,
+                                   Int iQBits, TCoeff iMaxLevel, TCoeff* piArlDstCoeff, Int iQBitsC, Int iAddC,
+                                   Intermediate_Int* plLevelDouble, UInt* puiMaxAbsLevel, Double* pdUncodedCost ) = NULL; ///< selected by TComTrQuant::initSimdKernels(), NULL: the C code
+#endif
+
+/** Quantisation pass of RDOQ over the whole TU, in raster order
+ * \param plSrcCoeff transform coefficients
+ * \param uiNumCoeff number of coefficients of the TU
+ * \param piQCoef quantisation coefficients of the scaling list, NULL if the TU does not use scaling lists
+ * \param iQCoef quantisation coefficient without scaling list
+ * \param pdErrScale error scales of the scaling list, NULL if the TU does not use scaling lists
+ * \param dErrScale error scale without scaling list
+ * \param iQBits right shift of the quantiser
+ * \param iMaxLevel largest level the entropy coder can code
+ * \param piArlDstCoeff levels for adaptive QP selection, NULL if not needed
+ * \param iQBitsC right shift of the levels for adaptive QP selection
+ * \param iAddC rounding offset of the levels for adaptive QP selection
+ * \param plLevelDouble unscaled quantised levels
+ * \param puiMaxAbsLevel rounded quantised levels, the largest levels RDOQ tries
+ * \param pdUncodedCost distortion of each coefficient when quantised to zero
+ * \returns true if any rounded level is not zero
+ */
+Bool quantBlockRDOQ( const TCoeff* plSrcCoeff, UInt uiNumCoeff, const Int* piQCoef, Int iQCoef, const Double* pdErrScale, Double dErrScale,
+                     Int iQBits, TCoeff iMaxLevel, TCoeff* piArlDstCoeff, Int iQBitsC, Int iAddC,
+                     Intermediate_Int* plLevelDouble, UInt* puiMaxAbsLevel, Double* pdUncodedCost )
+{
+#if AVX_RDOQ_KERNELS
+  if( s_fpQuantBlockRDOQ && ( uiNumCoeff & 7 ) == 0 )
+  {
+    return s_fpQuantBlockRDOQ( plSrcCoeff, uiNumCoeff, piQCoef, iQCoef, pdErrScale, dErrScale, iQBits, iMaxLevel, piArlDstCoeff, iQBitsC, iAddC, plLevelDouble, puiMaxAbsLevel, pdUncodedCost );
+  }
+#endif
+  UInt uiAny = 0;
+  for( UInt n = 0; n < uiNumCoeff; n++ )
+  {
+    const Int    quantisationCoefficient = piQCoef    ? piQCoef   [n] : iQCoef;
+    const Double errorScale              = pdErrScale ? pdErrScale[n] : dErrScale;
+    const Int64  tmpLevel                = Int64(abs(plSrcCoeff[ n ])) * quantisationCoefficient;
+    const Intermediate_Int lLevelDouble  = (Intermediate_Int)min<Int64>(tmpLevel, std::numeric_limits<Intermediate_Int>::max() - (Intermediate_Int(1) << (iQBits - 1)));
+
+    if( piArlDstCoeff )
+    {
+      piArlDstCoeff[ n ] = (TCoeff)(( lLevelDouble + iAddC) >> iQBitsC );
+    }
+    const UInt uiMaxAbsLevel = std::min<UInt>(UInt(iMaxLevel), UInt((lLevelDouble + (Intermediate_Int(1) << (iQBits - 1))) >> iQBits));
+    const Double dErr        = Double( lLevelDouble );
+
+    plLevelDouble [ n ] = lLevelDouble;
+    puiMaxAbsLevel[ n ] = uiMaxAbsLevel;
+    pdUncodedCost [ n ] = dErr * dErr * errorScale;
+    uiAny              |= uiMaxAbsLevel;
+  }
+  return uiAny != 0;
+}
+#endif
+
 #if COM16_C806_EMT
 #if JVET_C0024_QTBT
-FwdTrans *fastFwdTrans[16][7] = 
+static FwdTrans* const fastFwdTransC[16][7] = 
 #else
-FwdTrans *fastFwdTrans[16][5] = 
+static FwdTrans* const fastFwdTransC[16][5] = 
 #endif
 {
 #if JVET_C0024_QTBT
@@ -159,7 +603,7 @@ FwdTrans *fastFwdTrans[16][5] =
 };
 
 #if JVET_C0024_QTBT
-InvTrans *fastInvTrans[16][7] = 
+static InvTrans* const fastInvTransC[16][7] = 
 {
   {fastInverseDCT2_B2, fastInverseDCT2_B4, fastInverseDCT2_B8, fastInverseDCT2_B16, fastInverseDCT2_B32, fastInverseDCT2_B64, fastInverseDCT2_B128},
   {NULL,               fastInverseDCT5_B4, fastInverseDCT5_B8, fastInverseDCT5_B16, fastInverseDCT5_B32, fastInverseDCT5_B64, fastInverseDCT5_B128},
@@ -168,7 +612,7 @@ InvTrans *fastInvTrans[16][7] =
   {NULL,               fastInverseDST7_B4, fastInverseDST7_B8, fastInverseDST7_B16, fastInverseDST7_B32, fastInverseDST7_B64, fastInverseDST7_B128},
 };
 #else
-InvTrans *fastInvTrans[16][5] = 
+static InvTrans* const fastInvTransC[16][5] = 
 {
   {fastInverseDCT2_B4, fastInverseDCT2_B8, fastInverseDCT2_B16, fastInverseDCT2_B32, fastInverseDCT2_B64},
   {fastInverseDCT5_B4, fastInverseDCT5_B8, fastInverseDCT5_B16, fastInverseDCT5_B32, NULL               },
@@ -177,6 +621,34 @@ InvTrans *fastInvTrans[16][5] =
   {fastInverseDST7_B4, fastInverseDST7_B8, fastInverseDST7_B16, fastInverseDST7_B32, NULL               },
 };
 #endif
+
+#if AVX_TRANSFORM_KERNELS
+static FwdTrans* const fastFwdTransAVX2[16][7] = 
+{
+  {fastForwardDCT2_B2,  simdFastForwardAVX2<  4, DCT2>, simdFastForwardAVX2<  8, DCT2>, simdFastForwardAVX2< 16, DCT2>, simdFastForwardAVX2< 32, DCT2>, simdFastForwardAVX2< 64, DCT2>, simdFastForwardAVX2<128, DCT2>},
+  {NULL,                simdFastForwardAVX2<  4, DCT5>, simdFastForwardAVX2<  8, DCT5>, simdFastForwardAVX2< 16, DCT5>, simdFastForwardAVX2< 32, DCT5>, simdFastForwardAVX2< 64, DCT5>, simdFastForwardAVX2<128, DCT5>},
+  {NULL,                simdFastForwardAVX2<  4, DCT8>, simdFastForwardAVX2<  8, DCT8>, simdFastForwardAVX2< 16, DCT8>, simdFastForwardAVX2< 32, DCT8>, simdFastForwardAVX2< 64, DCT8>, simdFastForwardAVX2<128, DCT8>},
+  {NULL,                simdFastForwardAVX2<  4, DST1>, simdFastForwardAVX2<  8, DST1>, simdFastForwardAVX2< 16, DST1>, simdFastForwardAVX2< 32, DST1>, simdFastForwardAVX2< 64, DST1>, simdFastForwardAVX2<128, DST1>},
+  {NULL,                simdFastForwardAVX2<  4, DST7>, simdFastForwardAVX2<  8, DST7>, simdFastForwardAVX2< 16, DST7>, simdFastForwardAVX2< 32, DST7>, simdFastForwardAVX2< 64, DST7>, simdFastForwardAVX2<128, DST7>},
+};
+
+static InvTrans* const fastInvTransAVX2[16][7] = 
+{
+  {fastInverseDCT2_B2,  simdFastInverseAVX2<  4, DCT2>, simdFastInverseAVX2<  8, DCT2>, simdFastInverseAVX2< 16, DCT2>, simdFastInverseAVX2< 32, DCT2>, simdFastInverseAVX2< 64, DCT2>, simdFastInverseAVX2<128, DCT2>},
+  {NULL,                simdFastInverseAVX2<  4, DCT5>, simdFastInverseAVX2<  8, DCT5>, simdFastInverseAVX2< 16, DCT5>, simdFastInverseAVX2< 32, DCT5>, simdFastInverseAVX2< 64, DCT5>, simdFastInverseAVX2<128, DCT5>},
+  {NULL,                simdFastInverseAVX2<  4, DCT8>, simdFastInverseAVX2<  8, DCT8>, simdFastInverseAVX2< 16, DCT8>, simdFastInverseAVX2< 32, DCT8>, simdFastInverseAVX2< 64, DCT8>, simdFastInverseAVX2<128, DCT8>},
+  {NULL,                simdFastInverseAVX2<  4, DST1>, simdFastInverseAVX2<  8, DST1>, simdFastInverseAVX2< 16, DST1>, simdFastInverseAVX2< 32, DST1>, simdFastInverseAVX2< 64, DST1>, simdFastInverseAVX2<128, DST1>},
+  {NULL,                simdFastInverseAVX2<  4, DST7>, simdFastInverseAVX2<  8, DST7>, simdFastInverseAVX2< 16, DST7>, simdFastInverseAVX2< 32, DST7>, simdFastInverseAVX2< 64, DST7>, simdFastInverseAVX2<128, DST7>},
+};
+#endif
+
+#if JVET_C0024_QTBT
+static FwdTrans* const (*fastFwdTrans)[7] = fastFwdTransC;  ///< transforms of the SIMD level selected by TComTrQuant::initSimdKernels()
+static InvTrans* const (*fastInvTrans)[7] = fastInvTransC;
+#else
+static FwdTrans* const (*fastFwdTrans)[5] = fastFwdTransC;
+static InvTrans* const (*fastInvTrans)[5] = fastInvTransC;
+#endif
 #endif
 
 //! \ingroup TLibCommon
@@ -252,9 +724,24 @@ TComTrQuant::TComTrQuant()
 {
   // allocate temporary buffers
   m_plTempCoeff  = new TCoeff[ MAX_CU_SIZE*MAX_CU_SIZE ];
+#if RDOQ_BLOCK_QUANT
+  m_plRdoqLevelDouble  = new Intermediate_Int[ MAX_TU_SIZE*MAX_TU_SIZE ];
+  m_puiRdoqMaxAbsLevel = new UInt  [ MAX_TU_SIZE*MAX_TU_SIZE ];
+  m_pdRdoqUncodedCost  = new Double[ MAX_TU_SIZE*MAX_TU_SIZE ];
+  m_pdRdoqCostCoeff    = new Double[ MAX_TU_SIZE*MAX_TU_SIZE ];
+  m_pdRdoqCostSig      = new Double[ MAX_TU_SIZE*MAX_TU_SIZE ];
+  m_pdRdoqCostCoeff0   = new Double[ MAX_TU_SIZE*MAX_TU_SIZE ];
+  m_piRdoqRateIncUp    = new Int   [ MAX_TU_SIZE*MAX_TU_SIZE ];
+  m_piRdoqRateIncDown  = new Int   [ MAX_TU_SIZE*MAX_TU_SIZE ];
+  m_piRdoqSigRateDelta = new Int   [ MAX_TU_SIZE*MAX_TU_SIZE ];
+  m_piRdoqDeltaU       = new TCoeff[ MAX_TU_SIZE*MAX_TU_SIZE ];
+#endif
 
   // allocate bit estimation class  (for RDOQ)
   m_pcEstBitsSbac = new estBitsSbacStruct;
+#if PRIMARY_TRANSFORM_CACHE
+  m_pcPrimaryTransformCache = NULL;
+#endif
   initScalingList();
 #if VCEG_AZ08_KLT_COMMON
   memset( m_pData , 0 , sizeof( m_pData ) );
@@ -263,6 +750,15 @@ TComTrQuant::TComTrQuant()
   m_pppdTmpEigenVector = NULL;
   m_pppdEigenVector = NULL;
   m_pppsEigenVector = NULL;
+#if KLT_PREALLOCATED_EIGEN_SOLVER
+  memset( m_apcKLTEigenSolver, 0, sizeof( m_apcKLTEigenSolver ) );
+#endif
+#endif
+#if KLT_FAST_CANDIDATE_SEARCH && VCEG_AZ08_USE_SAD_DISTANCE
+  m_piSumTable = NULL;
+  m_iNumSumSegments = 0;
+  m_iSumTableStride = 0;
+  m_iSumTableSize = 0;
 #endif
 }
 
@@ -274,12 +770,30 @@ TComTrQuant::~TComTrQuant()
     delete [] m_plTempCoeff;
     m_plTempCoeff = NULL;
   }
+#if RDOQ_BLOCK_QUANT
+  delete [] m_plRdoqLevelDouble;
+  delete [] m_puiRdoqMaxAbsLevel;
+  delete [] m_pdRdoqUncodedCost;
+  delete [] m_pdRdoqCostCoeff;
+  delete [] m_pdRdoqCostSig;
+  delete [] m_pdRdoqCostCoeff0;
+  delete [] m_piRdoqRateIncUp;
+  delete [] m_piRdoqRateIncDown;
+  delete [] m_piRdoqSigRateDelta;
+  delete [] m_piRdoqDeltaU;
+#endif
 
   // delete bit estimation class
   if ( m_pcEstBitsSbac )
   {
     delete m_pcEstBitsSbac;
   }
+#if PRIMARY_TRANSFORM_CACHE
+  delete [] m_pcPrimaryTransformCache;
+#endif
+#if KLT_FAST_CANDIDATE_SEARCH && VCEG_AZ08_USE_SAD_DISTANCE
+  delete [] m_piSumTable;
+#endif
   destroyScalingList();
 #if VCEG_AZ08_USE_KLT
   if (m_useKLT)
@@ -372,6 +886,13 @@ TComTrQuant::~TComTrQuant()
           }
           delete[]m_pCovMatrix; m_pCovMatrix = NULL;
       }
+#if KLT_PREALLOCATED_EIGEN_SOLVER
+      for (UInt uiDim = 0; uiDim <= KLT_EIGEN_SOLVER_MAX_DIM; uiDim++)
+      {
+          delete m_apcKLTEigenSolver[uiDim];
+          m_apcKLTEigenSolver[uiDim] = NULL;
+      }
+#endif
 #if VCEG_AZ08_FAST_DERIVE_KLT
       if (m_pppdTmpEigenVector != NULL)
       {
@@ -6683,14 +7204,14 @@ void xTrMxN_EMT(Int bitDepth, TCoeff *block, TCoeff *coeff, Int iWidth, Int iHei
 
 Void xTrMxN(Int bitDepth, TCoeff *block, TCoeff *coeff, Int iWidth, Int iHeight, Bool useDST, const Int maxLog2TrDynamicRange
 #if VCEG_AZ08_KLT_COMMON
-    , Bool useKLT
+    , Bool useKLT, Short **kltBasis
 #endif
     )
 {
 #if VCEG_AZ08_KLT_COMMON
     if (useKLT == true)
     {
-      xKLTr(bitDepth, block, coeff, iWidth);
+      xKLTr(bitDepth, block, coeff, iWidth, kltBasis);
       return;
     }
 #endif
@@ -6975,13 +7496,13 @@ void xITrMxN_EMT(Int bitDepth, TCoeff *coeff, TCoeff *block, Int iWidth, Int iHe
 #if JVET_C0024_ITSKIP
 Void xITrMxN(Int bitDepth, TCoeff *coeff, TCoeff *block, Int iWidth, Int iHeight, UInt uiSkipWidth, UInt uiSkipHeight, Bool useDST, const Int maxLog2TrDynamicRange
 #if VCEG_AZ08_KLT_COMMON
-    , Bool useKLT
+    , Bool useKLT, Short **kltBasis
 #endif
 )
 #else
 Void xITrMxN(Int bitDepth, TCoeff *coeff, TCoeff *block, Int iWidth, Int iHeight, Bool useDST, const Int maxLog2TrDynamicRange
 #if VCEG_AZ08_KLT_COMMON
-    , Bool useKLT
+    , Bool useKLT, Short **kltBasis
 #endif
 )
 #endif
@@ -6990,7 +7511,7 @@ Void xITrMxN(Int bitDepth, TCoeff *coeff, TCoeff *block, Int iWidth, Int iHeight
     if (useKLT == true)
     {
       assert(iWidth == iHeight);
-      xIKLTr(bitDepth, coeff, block, iHeight);
+      xIKLTr(bitDepth, coeff, block, iHeight, kltBasis);
       return;
     }
 #endif
@@ -7747,6 +8268,16 @@ Void TComTrQuant::init(   UInt  uiMaxTrSize,
   m_uiMaxTrSize  = uiMaxTrSize;
 
   m_bEnc         = bEnc;
+#if PRIMARY_TRANSFORM_CACHE
+  if( m_bEnc && m_pcPrimaryTransformCache == NULL )
+  {
+    m_pcPrimaryTransformCache = new PrimaryTransformCacheEntry[PRIMARY_TRANSFORM_CACHE_SIZE];
+    for( Int i = 0; i < PRIMARY_TRANSFORM_CACHE_SIZE; i++ )
+    {
+      m_pcPrimaryTransformCache[i].bValid = false;
+    }
+  }
+#endif
   m_useRDOQ      = bUseRDOQ;
   m_useRDOQTS    = bUseRDOQTS;
 #if T0196_SELECTIVE_RDOQ
@@ -8035,6 +8566,14 @@ Void TComTrQuant::FwdNsst4x4( Int* src, UInt uiMode, UChar index )
 
   assert( index<4 );
 
+#if AVX_NSST_KERNELS
+  if( s_afpNsstHyGT[0][0] )
+  {
+    s_afpNsstHyGT[0][0]( src, par, rnd, shl );
+    return;
+  }
+#endif
+
   for (Int k = 0; k < 16; k++) src[k] <<= shl;
 
   for (Int r = 0, q = (4 * rnd - 1); r < rnd; r++) 
@@ -8080,6 +8619,14 @@ Void TComTrQuant::InvNsst4x4( Int* src, UInt uiMode, UChar index )
 
   assert( index<4 );
 
+#if AVX_NSST_KERNELS
+  if( s_afpNsstHyGT[0][1] )
+  {
+    s_afpNsstHyGT[0][1]( src, par, rnd, shl );
+    return;
+  }
+#endif
+
   for (Int k = 0; k < 16; k++) src[k] <<= shl;
 
   for (Int r = rnd, q = (4 * rnd - 1); --r >= 0;) 
@@ -8124,6 +8671,14 @@ Void TComTrQuant::FwdNsst8x8( Int* src, UInt uiMode, UChar index )
 
   assert( index<4 );
 
+#if AVX_NSST_KERNELS
+  if( s_afpNsstHyGT[1][0] )
+  {
+    s_afpNsstHyGT[1][0]( src, par, rnd, shl );
+    return;
+  }
+#endif
+
   for (Int k = 0; k < 64; k++) src[k] <<= shl;
 
   for (Int r = 0, q = (6 * rnd - 1); r < rnd; r++) 
@@ -8169,6 +8724,14 @@ Void TComTrQuant::InvNsst8x8( Int* src, UInt uiMode, UChar index )
   
   assert( index<4 );
 
+#if AVX_NSST_KERNELS
+  if( s_afpNsstHyGT[1][1] )
+  {
+    s_afpNsstHyGT[1][1]( src, par, rnd, shl );
+    return;
+  }
+#endif
+
   for (Int k = 0; k < 64; k++) src[k] <<= shl;
 
   for (Int r = rnd, q = (6 * rnd - 1); --r >= 0;) 
@@ -8368,6 +8931,33 @@ Void TComTrQuant::transformNxN(       TComTU        & rTu,
       else
       {
         const Int channelBitDepth=pcCU->getSlice()->getSPS()->getBitDepth(toChannelType(compID));
+#if PRIMARY_TRANSFORM_CACHE
+        // the KLT basis depends on the neighbourhood of the TU, not only on the residual
+#if VCEG_AZ08_KLT_COMMON
+        const Bool bUseCache = m_pcPrimaryTransformCache && uiWidth * uiHeight <= PRIMARY_TRANSFORM_CACHE_MAX_COEFF && !( useKLT && compID == COMPONENT_Y );
+#else
+        const Bool bUseCache = m_pcPrimaryTransformCache && uiWidth * uiHeight <= PRIMARY_TRANSFORM_CACHE_MAX_COEFF;
+#endif
+        PrimaryTransformKey cKey;
+        if( bUseCache )
+        {
+          memset( &cKey, 0, sizeof( cKey ) );
+          cKey.uiCtuRsAddr             = pcCU->getCtuRsAddr();
+          cKey.uiAbsPartIdx            = pcCU->getZorderIdxInCtu() + uiAbsPartIdx;
+          cKey.uiCompID                = compID;
+          cKey.uiWidth                 = uiWidth;
+          cKey.uiHeight                = uiHeight;
+          cKey.uiBitDepth              = channelBitDepth;
+          cKey.uiMaxLog2TrDynamicRange = pcCU->getSlice()->getSPS()->getMaxLog2TrDynamicRange(toChannelType(compID));
+          cKey.uiUseDST                = rTu.useDST(compID);
+#if COM16_C806_EMT
+          cKey.uiEmtMode               = getEmtMode ( rTu, compID );
+          cKey.uiEmtTrIdx              = getEmtTrIdx( rTu, compID );
+#endif
+        }
+        if( !bUseCache || !xLoadPrimaryTransform( cKey, pcResidual, uiStride, m_plTempCoeff ) )
+        {
+#endif
         xT( channelBitDepth, rTu.useDST(compID), pcResidual, uiStride, m_plTempCoeff, uiWidth, uiHeight, pcCU->getSlice()->getSPS()->getMaxLog2TrDynamicRange(toChannelType(compID)) 
 #if COM16_C806_EMT
           , getEmtMode ( rTu, compID )
@@ -8377,6 +8967,13 @@ Void TComTrQuant::transformNxN(       TComTU        & rTu,
           , useKLT && (compID == 0)
 #endif
           );
+#if PRIMARY_TRANSFORM_CACHE
+          if( bUseCache )
+          {
+            xStorePrimaryTransform( cKey, pcResidual, uiStride, m_plTempCoeff );
+          }
+        }
+#endif
       }
 
 #if DEBUG_TRANSFORM_AND_QUANTISE
@@ -8391,7 +8988,7 @@ Void TComTrQuant::transformNxN(       TComTU        & rTu,
   if (pcCU->getROTIdx(uiAbsPartIdx) )
 #endif
   {           
-            static Int ROT_MATRIX[16];
+            Int ROT_MATRIX[16];
       Int iSubGroupXMax = Clip3 (1,16,(Int)( (uiWidth>>2)));
       Int iSubGroupYMax = Clip3 (1,16,(Int)( (uiHeight>>2)));
 
@@ -8446,13 +9043,13 @@ Void TComTrQuant::transformNxN(       TComTU        & rTu,
 #endif
       {           
 #if JVET_D0120_NSST_IMPROV
-        static Int NSST_MATRIX[64];
+        Int NSST_MATRIX[64];
         const  Int iLog2SbSize   = (uiWidth > 4 && uiHeight > 4) ? 3 : 2;
         const  Int iSbSize       = (uiWidth > 4 && uiHeight > 4) ? 8 : 4;
         const  Int iSubGroupXMax = Clip3(1, 8, (Int)uiWidth ) >> iLog2SbSize;
         const  Int iSubGroupYMax = Clip3(1, 8, (Int)uiHeight) >> iLog2SbSize;
 #else
-        static Int NSST_MATRIX[16];
+        Int NSST_MATRIX[16];
         Int iSubGroupXMax = Clip3 (1,16,(Int)( (uiWidth>>2)));
         Int iSubGroupYMax = Clip3 (1,16,(Int)( (uiHeight>>2)));
 #endif
@@ -8779,7 +9376,7 @@ Void TComTrQuant::invTransformNxN(      TComTU        &rTu,
 #if !JVET_C0024_QTBT
     Char ucROTIdx = pcCU->getROTIdx(uiAbsPartIdx) ;
 #endif
-       static Int ROT_MATRIX[16];
+       Int ROT_MATRIX[16];
       Int iSubGroupXMax = Clip3 (1,16,(Int)( (uiWidth>>2)));
       Int iSubGroupYMax = Clip3 (1,16,(Int)( (uiHeight>>2)));
       Int iOffSetX = 0;
@@ -8832,13 +9429,13 @@ Void TComTrQuant::invTransformNxN(      TComTU        &rTu,
       Char ucNsstIdx = pcCU->getROTIdx(uiAbsPartIdx) ;
 #endif
 #if JVET_D0120_NSST_IMPROV
-      static Int NSST_MATRIX[64];
+      Int NSST_MATRIX[64];
       const  Int iLog2SbSize   = (uiWidth > 4 && uiHeight > 4) ? 3 : 2;
       const  Int iSbSize       = (uiWidth > 4 && uiHeight > 4) ? 8 : 4;
       const  Int iSubGroupXMax = Clip3(1, 8, (Int)uiWidth ) >> iLog2SbSize;
       const  Int iSubGroupYMax = Clip3(1, 8, (Int)uiHeight) >> iLog2SbSize;
 #else
-      static Int NSST_MATRIX[16];
+      Int NSST_MATRIX[16];
       Int iSubGroupXMax = Clip3 (1,16,(Int)( (uiWidth>>2)));
       Int iSubGroupYMax = Clip3 (1,16,(Int)( (uiHeight>>2)));
 #endif
@@ -9585,7 +10182,7 @@ Void TComTrQuant::xT( const Int channelBitDepth, Bool useDST, Pel* piBlkResi, UI
 #endif
 
 #if VCEG_AZ08_KLT_COMMON
-  xTrMxN( channelBitDepth, block, coeff, iWidth, iHeight, useDST, maxLog2TrDynamicRange, useKLT);
+  xTrMxN( channelBitDepth, block, coeff, iWidth, iHeight, useDST, maxLog2TrDynamicRange, useKLT, useKLT ? m_pppsEigenVector[(Int)g_aucConvertToBit[iWidth]] : NULL);
 #else
   xTrMxN( channelBitDepth, block, coeff, iWidth, iHeight, useDST, maxLog2TrDynamicRange );
 #endif
@@ -9654,13 +10251,13 @@ Void TComTrQuant::xIT( const Int channelBitDepth, Bool useDST, TCoeff* plCoef, P
 #if JVET_C0024_ITSKIP
   xITrMxN( channelBitDepth, coeff, block, iWidth, iHeight, uiSkipWidth, uiSkipHeight, useDST, maxLog2TrDynamicRange
 #if VCEG_AZ08_KLT_COMMON
-  , useKLT
+  , useKLT, useKLT ? m_pppsEigenVector[(Int)g_aucConvertToBit[iWidth]] : NULL
 #endif
  );
 #else
   xITrMxN( channelBitDepth, coeff, block, iWidth, iHeight, useDST, maxLog2TrDynamicRange
 #if VCEG_AZ08_KLT_COMMON
-  , useKLT
+  , useKLT, useKLT ? m_pppsEigenVector[(Int)g_aucConvertToBit[iWidth]] : NULL
 #endif
   );
 #endif
@@ -9674,6 +10271,82 @@ Void TComTrQuant::xIT( const Int channelBitDepth, Bool useDST, TCoeff* plCoef, P
   }
 }
 
+#if PRIMARY_TRANSFORM_CACHE
+static std::atomic<UInt64> s_primaryTransformCacheLookups( 0 );
+static std::atomic<UInt64> s_primaryTransformCacheHits( 0 );
+
+/** Get the number of look-ups and hits of the primary transform caches of all the encoders so far
+ * \param ruiLookups number of primary transforms looked up
+ * \param ruiHits number of primary transforms found
+ */
+Void TComTrQuant::getPrimaryTransformCacheStats( UInt64 &ruiLookups, UInt64 &ruiHits )
+{
+  ruiLookups = s_primaryTransformCacheLookups;
+  ruiHits    = s_primaryTransformCacheHits;
+}
+
+TComTrQuant::PrimaryTransformCacheEntry& TComTrQuant::xGetPrimaryTransformCacheEntry( const PrimaryTransformKey &rcKey )
+{
+  UInt uiHash = rcKey.uiCtuRsAddr;
+  uiHash = uiHash * 1021 + rcKey.uiAbsPartIdx;
+  uiHash = uiHash * 31   + rcKey.uiCompID;
+  uiHash = uiHash * 131  + rcKey.uiWidth;
+  uiHash = uiHash * 131  + rcKey.uiHeight;
+  uiHash = uiHash * 67   + rcKey.uiEmtMode;
+  uiHash = uiHash * 7    + rcKey.uiEmtTrIdx;
+  return m_pcPrimaryTransformCache[( uiHash * 2654435761u ) % PRIMARY_TRANSFORM_CACHE_SIZE];
+}
+
+/** Look up the primary transform of a residual block in the cache
+ * \param rcKey transform parameters and position of the TU
+ * \param piBlkResi residual block
+ * \param uiStride stride of the residual block
+ * \param psCoeff transform coefficients, set if the block is found
+ * \returns true if the block is found
+ */
+Bool TComTrQuant::xLoadPrimaryTransform( const PrimaryTransformKey &rcKey, const Pel* piBlkResi, UInt uiStride, TCoeff* psCoeff )
+{
+  s_primaryTransformCacheLookups.fetch_add( 1, std::memory_order_relaxed );
+
+  const PrimaryTransformCacheEntry &rcEntry = xGetPrimaryTransformCacheEntry( rcKey );
+  if( !rcEntry.bValid || memcmp( &rcEntry.cKey, &rcKey, sizeof( PrimaryTransformKey ) ) )
+  {
+    return false;
+  }
+  const Pel* piCached = rcEntry.aResidual;
+  for( UInt y = 0; y < rcKey.uiHeight; y++, piBlkResi += uiStride, piCached += rcKey.uiWidth )
+  {
+    if( memcmp( piCached, piBlkResi, sizeof( Pel ) * rcKey.uiWidth ) )
+    {
+      return false;
+    }
+  }
+  memcpy( psCoeff, rcEntry.aCoeff, sizeof( TCoeff ) * rcKey.uiWidth * rcKey.uiHeight );
+
+  s_primaryTransformCacheHits.fetch_add( 1, std::memory_order_relaxed );
+  return true;
+}
+
+/** Store the primary transform of a residual block in the cache, replacing the block of the same hash
+ * \param rcKey transform parameters and position of the TU
+ * \param piBlkResi residual block
+ * \param uiStride stride of the residual block
+ * \param psCoeff transform coefficients
+ */
+Void TComTrQuant::xStorePrimaryTransform( const PrimaryTransformKey &rcKey, const Pel* piBlkResi, UInt uiStride, const TCoeff* psCoeff )
+{
+  PrimaryTransformCacheEntry &rcEntry = xGetPrimaryTransformCacheEntry( rcKey );
+  rcEntry.bValid = true;
+  rcEntry.cKey   = rcKey;
+  Pel* piCached  = rcEntry.aResidual;
+  for( UInt y = 0; y < rcKey.uiHeight; y++, piBlkResi += uiStride, piCached += rcKey.uiWidth )
+  {
+    memcpy( piCached, piBlkResi, sizeof( Pel ) * rcKey.uiWidth );
+  }
+  memcpy( rcEntry.aCoeff, psCoeff, sizeof( TCoeff ) * rcKey.uiWidth * rcKey.uiHeight );
+}
+#endif
+
 /** Wrapper function between HM interface and core 4x4 transform skipping
  *  \param piBlkResi input data (residual)
  *  \param uiStride stride of input residual data
@@ -9904,7 +10577,11 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
   memset(piArlDstCoeff, 0, sizeof(TCoeff) *  uiMaxNumCoeff);
 #endif
 
-#if JVET_C0024_QTBT //to prevent stack overflow
+#if RDOQ_BLOCK_QUANT
+  Double* pdCostCoeff  = m_pdRdoqCostCoeff;
+  Double* pdCostSig    = m_pdRdoqCostSig;
+  Double* pdCostCoeff0 = m_pdRdoqCostCoeff0;
+#elif JVET_C0024_QTBT //to prevent stack overflow
   Double* pdCostCoeff = new Double [uiMaxNumCoeff];
   Double* pdCostSig = new Double [uiMaxNumCoeff];
   Double* pdCostCoeff0 = new Double [uiMaxNumCoeff];
@@ -9913,9 +10590,16 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
   Double pdCostSig   [ MAX_TU_SIZE * MAX_TU_SIZE ];
   Double pdCostCoeff0[ MAX_TU_SIZE * MAX_TU_SIZE ];
 #endif
+#if !RDOQ_BLOCK_QUANT
   memset( pdCostCoeff, 0, sizeof(Double) *  uiMaxNumCoeff );
   memset( pdCostSig,   0, sizeof(Double) *  uiMaxNumCoeff );
-#if JVET_C0024_QTBT
+#endif
+#if RDOQ_BLOCK_QUANT
+  Int*    rateIncUp    = m_piRdoqRateIncUp;
+  Int*    rateIncDown  = m_piRdoqRateIncDown;
+  Int*    sigRateDelta = m_piRdoqSigRateDelta;
+  TCoeff* deltaU       = m_piRdoqDeltaU;
+#elif JVET_C0024_QTBT
   Int* rateIncUp   = new Int [uiMaxNumCoeff];
   Int* rateIncDown = new Int [uiMaxNumCoeff];
   Int* sigRateDelta= new Int [uiMaxNumCoeff];
@@ -9926,10 +10610,12 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
   Int sigRateDelta[ MAX_TU_SIZE * MAX_TU_SIZE ];
   TCoeff deltaU   [ MAX_TU_SIZE * MAX_TU_SIZE ];
 #endif
+#if !RDOQ_BLOCK_QUANT
   memset( rateIncUp,    0, sizeof(Int   ) *  uiMaxNumCoeff );
   memset( rateIncDown,  0, sizeof(Int   ) *  uiMaxNumCoeff );
   memset( sigRateDelta, 0, sizeof(Int   ) *  uiMaxNumCoeff );
   memset( deltaU,       0, sizeof(TCoeff) *  uiMaxNumCoeff );
+#endif
 
   const Int iQBits = QUANT_SHIFT + cQP.per + iTransformShift;                   // Right shift of non-RDOQ quantizer;  level = (coeff*uiQ + offset)>>q_bits
 #if JVET_C0024_QTBT
@@ -9995,10 +10681,35 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
   memset( pdCostCoeffGroupSig,   0, sizeof(Double) * MLS_GRP_NUM );
   memset( uiSigCoeffGroupFlag,   0, sizeof(UInt) * MLS_GRP_NUM );
 
-  UInt uiCGNum = uiWidth * uiHeight >> MLS_CG_SIZE;
-  Int iScanPos;
-  coeffGroupRDStats rdStats;
-
+#if RDOQ_BLOCK_QUANT
+  const Intermediate_Int* plLevelDouble  = m_plRdoqLevelDouble;
+  const UInt*             puiMaxAbsLevel = m_puiRdoqMaxAbsLevel;
+  const Double*           pdUncodedCost  = m_pdRdoqUncodedCost;
+#if ADAPTIVE_QP_SELECTION
+  const Bool bAnyLevel = quantBlockRDOQ( plSrcCoeff, uiMaxNumCoeff, enableScalingLists ? piQCoef : NULL, defaultQuantisationCoefficient, enableScalingLists ? pdErrScale : NULL, defaultErrorScale,
+                                        iQBits, entropyCodingMaximum, m_bUseAdaptQpSelect ? piArlDstCoeff : NULL, iQBitsC, iAddC, m_plRdoqLevelDouble, m_puiRdoqMaxAbsLevel, m_pdRdoqUncodedCost );
+#else
+  const Bool bAnyLevel = quantBlockRDOQ( plSrcCoeff, uiMaxNumCoeff, enableScalingLists ? piQCoef : NULL, defaultQuantisationCoefficient, enableScalingLists ? pdErrScale : NULL, defaultErrorScale,
+                                        iQBits, entropyCodingMaximum, NULL, 0, 0, m_plRdoqLevelDouble, m_puiRdoqMaxAbsLevel, m_pdRdoqUncodedCost );
+#endif
+  if( !bAnyLevel )
+  {
+    // all the levels are zero, no last position to code
+    memset( piDstCoeff, 0, sizeof(TCoeff) * uiMaxNumCoeff );
+    return;
+  }
+  memset( pdCostCoeff,  0, sizeof(Double) *  uiMaxNumCoeff );
+  memset( pdCostSig,    0, sizeof(Double) *  uiMaxNumCoeff );
+  memset( rateIncUp,    0, sizeof(Int   ) *  uiMaxNumCoeff );
+  memset( rateIncDown,  0, sizeof(Int   ) *  uiMaxNumCoeff );
+  memset( sigRateDelta, 0, sizeof(Int   ) *  uiMaxNumCoeff );
+  memset( deltaU,       0, sizeof(TCoeff) *  uiMaxNumCoeff );
+#endif
+
+  UInt uiCGNum = uiWidth * uiHeight >> MLS_CG_SIZE;
+  Int iScanPos;
+  coeffGroupRDStats rdStats;
+
 #if VCEG_AZ07_CTX_RESIDUALCODING
   const UInt significanceMapContextOffset = 0; 
 #else
@@ -10028,6 +10739,13 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
       UInt    uiBlkPos          = codingParameters.scan[iScanPos];
       // set coeff
 
+#if RDOQ_BLOCK_QUANT
+      const Double errorScale              = (enableScalingLists) ? pdErrScale[uiBlkPos] : defaultErrorScale;
+      const Intermediate_Int lLevelDouble  = plLevelDouble [ uiBlkPos ];
+      const UInt uiMaxAbsLevel             = puiMaxAbsLevel[ uiBlkPos ];
+
+      pdCostCoeff0[ iScanPos ]  = pdUncodedCost[ uiBlkPos ];
+#else
       const Int    quantisationCoefficient = (enableScalingLists) ? piQCoef   [uiBlkPos] : defaultQuantisationCoefficient;
       const Double errorScale              = (enableScalingLists) ? pdErrScale[uiBlkPos] : defaultErrorScale;
 
@@ -10049,6 +10767,7 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
 
       const Double dErr         = Double( lLevelDouble );
       pdCostCoeff0[ iScanPos ]  = dErr * dErr * errorScale;
+#endif
       d64BlockUncodedCost      += pdCostCoeff0[ iScanPos ];
       piDstCoeff[ uiBlkPos ]    = uiMaxAbsLevel;
 
@@ -10270,7 +10989,7 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
   //===== estimate last position =====
   if ( iLastScanPos < 0 )
   {
-#if JVET_C0024_QTBT
+#if JVET_C0024_QTBT && !RDOQ_BLOCK_QUANT
     delete [] pdCostCoeff;
     delete [] pdCostSig;
     delete [] pdCostCoeff0;
@@ -10355,7 +11074,7 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
     } // end if (uiSigCoeffGroupFlag[ uiCGBlkPos ])
   } // end for
 
-#if JVET_C0024_QTBT
+#if JVET_C0024_QTBT && !RDOQ_BLOCK_QUANT
   delete [] pdCostCoeff;
   delete [] pdCostSig;
   delete [] pdCostCoeff0;
@@ -10651,7 +11370,7 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
           }
         }
       }
-#if JVET_C0024_QTBT
+#if JVET_C0024_QTBT && !RDOQ_BLOCK_QUANT
       delete [] rateIncUp;
       delete [] rateIncDown;
       delete [] sigRateDelta;
@@ -10783,7 +11502,7 @@ Void TComTrQuant::xRateDistOptQuant                 (       TComTU       &rTu,
       }
     }
   }
-#if JVET_C0024_QTBT
+#if JVET_C0024_QTBT && !RDOQ_BLOCK_QUANT
   delete [] rateIncUp;
   delete [] rateIncDown;
   delete [] sigRateDelta;
@@ -12761,6 +13480,11 @@ TempLibFast::TempLibFast()
     m_pYInteger = NULL;
     m_pDiffInteger = NULL;
     m_pIdInteger = NULL;
+#if KLT_FAST_CANDIDATE_SEARCH
+    m_pHeap = NULL;
+    m_pSorted = NULL;
+    m_iHeapSize = 0;
+#endif
 }
 
 TempLibFast::~TempLibFast()
@@ -12810,6 +13534,12 @@ TempLibFast::~TempLibFast()
         delete[]m_pId;
         m_pId = NULL;
     }
+#if KLT_FAST_CANDIDATE_SEARCH
+    delete[]m_pHeap;
+    m_pHeap = NULL;
+    delete[]m_pSorted;
+    m_pSorted = NULL;
+#endif
 }
 
 Void TempLibFast::init(UInt iSize)
@@ -12826,6 +13556,10 @@ Void TempLibFast::init(UInt iSize)
       m_pYInteger = new Int[iSize];
       m_pDiffInteger = new DistType[iSize];
       m_pIdInteger = new Short[iSize];
+#if KLT_FAST_CANDIDATE_SEARCH
+      m_pHeap = new Candidate[iSize];
+      m_pSorted = new Candidate[iSize];
+#endif
     }
 }
 
@@ -12843,7 +13577,82 @@ Void TempLibFast::initDiff(UInt uiPatchSize, Int bitDepth, Int iCandiNumber)
     {
         m_pDiff[i] = maxValue;
     }
+#if KLT_FAST_CANDIDATE_SEARCH
+    initHeap(maxValue, iCandiNumber);
+#endif
+}
+
+#if KLT_FAST_CANDIDATE_SEARCH
+Void TempLibFast::initHeap(DistType maxValue, Int iCandiNumber)
+{
+    m_iHeapSize = iCandiNumber;
+    for (Int i = 0; i < iCandiNumber; i++)
+    {
+        m_pHeap[i].diff = maxValue;
+        m_pHeap[i].x = 0;
+        m_pHeap[i].y = 0;
+        m_pHeap[i].id = 0;
+    }
+}
+
+/** Put a candidate into the k-best list in place of the worst one, as insertNode() does for the sorted list:
+ *  a candidate with the same distance as one already in the list is ignored
+ *  \param diff distance of the candidate, smaller than getWorstDiff()
+ */
+Void TempLibFast::insertCandidate(DistType diff, Int iXOffset, Int iYOffset, Short setId)
+{
+    for (Int i = 0; i < m_iHeapSize; i++)
+    {
+        if (m_pHeap[i].diff == diff)
+        {
+            return;
+        }
+    }
+
+    //sift the new candidate down from the root
+    Int iParent = 0;
+    Int iChild = 1;
+    while (iChild < m_iHeapSize)
+    {
+        if (iChild + 1 < m_iHeapSize && m_pHeap[iChild + 1].diff > m_pHeap[iChild].diff)
+        {
+            iChild++;
+        }
+        if (m_pHeap[iChild].diff <= diff)
+        {
+            break;
+        }
+        m_pHeap[iParent] = m_pHeap[iChild];
+        iParent = iChild;
+        iChild = (iParent << 1) + 1;
+    }
+    m_pHeap[iParent].diff = diff;
+    m_pHeap[iParent].x = iXOffset;
+    m_pHeap[iParent].y = iYOffset;
+    m_pHeap[iParent].id = setId;
+}
+
+static Bool lessCandidateDiff(const TempLibFast::Candidate &a, const TempLibFast::Candidate &b)
+{
+    return a.diff < b.diff;
+}
+
+/** Write the k-best list in increasing order of distance to getDiff(), getX(), getY() and getId(),
+ *  the heap is kept so that more candidates can be inserted afterwards
+ */
+Void TempLibFast::sortCandidates()
+{
+    memcpy(m_pSorted, m_pHeap, sizeof(Candidate)*m_iHeapSize);
+    std::sort(m_pSorted, m_pSorted + m_iHeapSize, lessCandidateDiff);
+    for (Int i = 0; i < m_iHeapSize; i++)
+    {
+        m_pDiff[i] = m_pSorted[i].diff;
+        m_pX[i] = m_pSorted[i].x;
+        m_pY[i] = m_pSorted[i].y;
+        m_pId[i] = m_pSorted[i].id;
+    }
 }
+#endif
 
 
 Void insertNode(DistType diff, Int iXOffset, Int iYOffset, DistType *pDiff, Int *pX, Int *pY, Short *pId, UInt uiLibSizeMinusOne, Int setId)
@@ -12898,20 +13707,114 @@ Void insertNode(DistType diff, Int iXOffset, Int iYOffset, DistType *pDiff, Int
     }
 }
 
+#if KLT_FAST_CANDIDATE_SEARCH && VCEG_AZ08_USE_SAD_DISTANCE
+/** Split the target template (or patch) into rectangles: the template rows and columns, then cells across the block,
+ *  and sum the target samples of each
+ *  \param bTemplateOnly true if the distance covers only the template, false if it covers the whole patch
+ */
+Void TComTrQuant::xInitSumSegments(Pel **tarPatch, UInt uiBlkSize, UInt uiTempSize, Bool bTemplateOnly)
+{
+    const Int iTempSize = uiTempSize;
+    const Int iCellSize = max<Int>(KLT_SUM_CELL_MIN_SIZE, uiBlkSize / KLT_SUM_CELLS_PER_BLOCK);
+    Int aiStart[KLT_SUM_CELLS_PER_BLOCK + 1];
+    Int aiSize[KLT_SUM_CELLS_PER_BLOCK + 1];
+    Int iNumSplits = 1;
+    aiStart[0] = 0;
+    aiSize[0] = iTempSize;
+    for (Int iPos = 0; iPos < uiBlkSize; iPos += iCellSize, iNumSplits++)
+    {
+        aiStart[iNumSplits] = iTempSize + iPos;
+        aiSize[iNumSplits] = iCellSize;
+    }
+
+    m_iNumSumSegments = 0;
+    for (Int iRow = 0; iRow < iNumSplits; iRow++)
+    {
+        for (Int iCol = 0; iCol < iNumSplits; iCol++)
+        {
+            if (bTemplateOnly && iRow > 0 && iCol > 0)
+            {
+                continue;
+            }
+            SumSegment &rSegment = m_aSumSegments[m_iNumSumSegments++];
+            rSegment.iX = aiStart[iCol];
+            rSegment.iY = aiStart[iRow];
+            rSegment.iWidth = aiSize[iCol];
+            rSegment.iHeight = aiSize[iRow];
+            rSegment.iTargetSum = 0;
+            for (Int iY = rSegment.iY; iY < rSegment.iY + rSegment.iHeight; iY++)
+            {
+                for (Int iX = rSegment.iX; iX < rSegment.iX + rSegment.iWidth; iX++)
+                {
+                    rSegment.iTargetSum += tarPatch[iY][iX];
+                }
+            }
+        }
+    }
+}
+
+/** Compute the prefix sums of the samples of a search window: entry (y+1, x+1) holds the sum of the samples above and left of (x, y), inclusive
+ *  \param piWindow top-left sample of the window, that is the top-left sample of the patch of the top-left candidate
+ */
+Void TComTrQuant::xBuildSumTable(const Pel *piWindow, Int iStride, Int iWidth, Int iHeight)
+{
+    m_iSumTableStride = iWidth + 1;
+    const Int iSize = m_iSumTableStride * (iHeight + 1);
+    if (iSize > m_iSumTableSize)
+    {
+        delete[] m_piSumTable;
+        m_piSumTable = new Int[iSize];
+        m_iSumTableSize = iSize;
+    }
+    memset(m_piSumTable, 0, sizeof(Int)*m_iSumTableStride);
+    Int *piAbove = m_piSumTable;
+    Int *piCurr = m_piSumTable + m_iSumTableStride;
+    for (Int iY = 0; iY < iHeight; iY++)
+    {
+        Int iRowSum = 0;
+        piCurr[0] = 0;
+        for (Int iX = 0; iX < iWidth; iX++)
+        {
+            iRowSum += piWindow[iX];
+            piCurr[iX + 1] = piAbove[iX + 1] + iRowSum;
+        }
+        piWindow += iStride;
+        piAbove = piCurr;
+        piCurr += m_iSumTableStride;
+    }
+}
+
+/** Lower bound of the SAD of the candidate whose patch starts at (iX, iY) of the search window:
+ *  the SAD over a rectangle is at least the absolute difference of the sample sums over it
+ */
+DistType TComTrQuant::xGetSumLowerBound(Int iX, Int iY) const
+{
+    DistType iBound = 0;
+    for (Int k = 0; k < m_iNumSumSegments; k++)
+    {
+        const SumSegment &rSegment = m_aSumSegments[k];
+        const Int *piTop = m_piSumTable + (iY + rSegment.iY)*m_iSumTableStride + iX + rSegment.iX;
+        const Int *piBottom = piTop + rSegment.iHeight*m_iSumTableStride;
+        const Int iSum = piBottom[rSegment.iWidth] - piBottom[0] - piTop[rSegment.iWidth] + piTop[0];
+        iBound += abs(iSum - rSegment.iTargetSum);
+    }
+    return iBound;
+}
+#endif
+
 /** NxN forward KL-transform (1D) using brute force matrix multiplication
 *  \param block pointer to input data (residual)
 *  \param coeff pointer to output data (transform coefficients)
 *  \param uiTrSize transform size (uiTrSize x uiTrSize)
+*  \param pTMat KLT basis derived for this transform size
 */
-void xKLTr(Int bitDepth, TCoeff *block, TCoeff *coeff, UInt uiTrSize)  //void xKLTr(Int bitDepth, Pel *block, Short *coeff, UInt uiTrSize)  
+void xKLTr(Int bitDepth, TCoeff *block, TCoeff *coeff, UInt uiTrSize, Short **pTMat)  //void xKLTr(Int bitDepth, Pel *block, Short *coeff, UInt uiTrSize)  
 {
     Int i, k, iSum;
     Int uiDim = uiTrSize*uiTrSize;
     UInt uiLog2TrSize = g_aucConvertToBit[uiTrSize] + 2;
     Int shift = bitDepth + 2 * uiLog2TrSize + KLTBASIS_SHIFTBIT - 15;
     Int add = 1 << (shift - 1);
-    UInt uiTarDepth = g_aucConvertToBit[uiTrSize];
-    Short **pTMat = g_ppsEigenVector[uiTarDepth];
     for (i = 0; i< uiDim; i++)
     {
         iSum = 0;
@@ -12928,8 +13831,9 @@ void xKLTr(Int bitDepth, TCoeff *block, TCoeff *coeff, UInt uiTrSize)  //void xK
 *  \param coeff pointer to input data (transform coefficients)
 *  \param block pointer to output data (residual)
 *  \param uiTrSize transform size (uiTrSize x uiTrSize)
+*  \param pTMat KLT basis derived for this transform size
 */
-void xIKLTr(Int bitDepth, TCoeff *coeff, TCoeff *block, UInt uiTrSize)  //void xIKLTr(Short *coeff, Pel *block, UInt uiTrSize) 
+void xIKLTr(Int bitDepth, TCoeff *coeff, TCoeff *block, UInt uiTrSize, Short **pTMat)  //void xIKLTr(Short *coeff, Pel *block, UInt uiTrSize) 
 {
     Int i, k, iSum;
     UInt uiDim = uiTrSize*uiTrSize;
@@ -12938,8 +13842,6 @@ void xIKLTr(Int bitDepth, TCoeff *coeff, TCoeff *block, UInt uiTrSize)  //void x
     //const Int channelBitDepth = rTu.getCU()->getSlice()->getSPS()->getBitDepth(toChannelType(component));
     Int shift = 7 + KLTBASIS_SHIFTBIT - (bitDepth - 8);
     Int add = 1 << (shift - 1);
-    UInt uiTarDepth = g_aucConvertToBit[uiTrSize];
-    Short **pTMat = g_ppsEigenVector[uiTarDepth];
     for (i = 0; i < uiDim; i++)
     {
         iSum = 0;
@@ -12951,6 +13853,113 @@ void xIKLTr(Int bitDepth, TCoeff *coeff, TCoeff *block, UInt uiTrSize)  //void x
     }
 }
 
+#if AVX_KLT_DERIVE_KERNELS
+/** covariance matrix of the KLT training samples, bit-exact with the C code of TComTrQuant::calcCovMatrix()
+ *
+ *  Row r of the lower triangle is accumulated in 32-bit lanes for 8 columns at a time, two samples per
+ *  _mm256_madd_epi16(). The integer sums do not depend on the order of the samples, and the final conversion
+ *  and division are done in single precision as in the C code.
+ *  \param uiDim dimension of the samples, a multiple of 8
+ */
+__attribute__((target("avx2")))
+static Void simdKltCovMatrixAVX2( TrainDataType **pData, UInt uiSampleNum, covMatrixType *pCovMatrix, UInt uiDim )
+{
+  const __m256  vSampleNum = _mm256_set1_ps( ( covMatrixType ) uiSampleNum );
+  const __m256i vZero      = _mm256_setzero_si256();
+  for( UInt uiRow = 0; uiRow < uiDim; uiRow++ )
+  {
+    // the columns up to the next multiple of 8 are computed, those above the diagonal are overwritten by the caller
+    for( UInt uiCol = 0; uiCol <= uiRow; uiCol += 8 )
+    {
+      __m256i vSum = vZero;
+      UInt i = 0;
+      for( ; i + 1 < uiSampleNum; i += 2 )
+      {
+        const TrainDataType *pSample0 = pData[i];
+        const TrainDataType *pSample1 = pData[i + 1];
+        const __m256i vFactor = _mm256_set1_epi32( ( UShort ) pSample0[uiRow] | ( ( Int ) pSample1[uiRow] << 16 ) );
+        const __m256i vLo     = _mm256_cvtepu16_epi32( _mm_loadu_si128( ( const __m128i* )( pSample0 + uiCol ) ) );
+        const __m256i vHi     = _mm256_slli_epi32( _mm256_cvtepu16_epi32( _mm_loadu_si128( ( const __m128i* )( pSample1 + uiCol ) ) ), 16 );
+        vSum = _mm256_add_epi32( vSum, _mm256_madd_epi16( _mm256_or_si256( vLo, vHi ), vFactor ) );
+      }
+      if( i < uiSampleNum )
+      {
+        const TrainDataType *pSample0 = pData[i];
+        const __m256i vFactor = _mm256_set1_epi32( ( UShort ) pSample0[uiRow] );
+        const __m256i vLo     = _mm256_cvtepu16_epi32( _mm_loadu_si128( ( const __m128i* )( pSample0 + uiCol ) ) );
+        vSum = _mm256_add_epi32( vSum, _mm256_madd_epi16( vLo, vFactor ) );
+      }
+      _mm256_storeu_ps( pCovMatrix + uiRow*uiDim + uiCol, _mm256_div_ps( _mm256_cvtepi32_ps( vSum ), vSampleNum ) );
+    }
+  }
+}
+
+/** inner product of two KLT training samples, bit-exact with the C code of TComTrQuant::calcCovMatrixXXt()
+ *  \param iLen number of samples, a multiple of 16
+ */
+__attribute__((target("avx2")))
+static Int simdKltInnerProductAVX2( const TrainDataType *pA, const TrainDataType *pB, Int iLen )
+{
+  __m256i vSum0 = _mm256_setzero_si256();
+  __m256i vSum1 = _mm256_setzero_si256();
+  Int i = 0;
+  for( ; i + 32 <= iLen; i += 32 )
+  {
+    vSum0 = _mm256_add_epi32( vSum0, _mm256_madd_epi16( _mm256_loadu_si256( ( const __m256i* )( pA + i      ) ), _mm256_loadu_si256( ( const __m256i* )( pB + i      ) ) ) );
+    vSum1 = _mm256_add_epi32( vSum1, _mm256_madd_epi16( _mm256_loadu_si256( ( const __m256i* )( pA + i + 16 ) ), _mm256_loadu_si256( ( const __m256i* )( pB + i + 16 ) ) ) );
+  }
+  if( i < iLen )
+  {
+    vSum0 = _mm256_add_epi32( vSum0, _mm256_madd_epi16( _mm256_loadu_si256( ( const __m256i* )( pA + i ) ), _mm256_loadu_si256( ( const __m256i* )( pB + i ) ) ) );
+  }
+  vSum0 = _mm256_add_epi32( vSum0, vSum1 );
+  __m128i vSum = _mm_add_epi32( _mm256_castsi256_si128( vSum0 ), _mm256_extracti128_si256( vSum0, 1 ) );
+  vSum = _mm_add_epi32( vSum, _mm_shuffle_epi32( vSum, 0x4e ) );
+  vSum = _mm_add_epi32( vSum, _mm_shuffle_epi32( vSum, 0xb1 ) );
+  return _mm_cvtsi128_si32( vSum );
+}
+
+/** projection of the training samples on an eigenvector of their Gram matrix, bit-exact with the C code of
+ *  TComTrQuant::derive1DimKLT_Fast()
+ *
+ *  The C code sums the single precision products of every column in double precision, sample after sample.
+ *  The same sums are kept for 16 columns at a time, so the order of the additions is unchanged.
+ *  \param uiDim dimension of the samples, a multiple of 16
+ */
+__attribute__((target("avx2")))
+static Void simdKltProjectBasisAVX2( const EigenType *pEigenVector, TrainDataType **pData, UInt uiSampleNum, UInt uiDim, Double dNorm, EigenType *pBasis )
+{
+  const __m256d vNorm = _mm256_set1_pd( dNorm );
+  for( UInt uiCol = 0; uiCol < uiDim; uiCol += 16 )
+  {
+    __m256d vSum0 = _mm256_setzero_pd();
+    __m256d vSum1 = _mm256_setzero_pd();
+    __m256d vSum2 = _mm256_setzero_pd();
+    __m256d vSum3 = _mm256_setzero_pd();
+    for( UInt k = 0; k < uiSampleNum; k++ )
+    {
+      const __m256  vFactor  = _mm256_set1_ps( pEigenVector[k] );
+      const __m256i vSamples = _mm256_loadu_si256( ( const __m256i* )( pData[k] + uiCol ) );
+      const __m256  vProd0   = _mm256_mul_ps( vFactor, _mm256_cvtepi32_ps( _mm256_cvtepi16_epi32( _mm256_castsi256_si128( vSamples ) ) ) );
+      const __m256  vProd1   = _mm256_mul_ps( vFactor, _mm256_cvtepi32_ps( _mm256_cvtepi16_epi32( _mm256_extracti128_si256( vSamples, 1 ) ) ) );
+      vSum0 = _mm256_add_pd( vSum0, _mm256_cvtps_pd( _mm256_castps256_ps128( vProd0 ) ) );
+      vSum1 = _mm256_add_pd( vSum1, _mm256_cvtps_pd( _mm256_extractf128_ps( vProd0, 1 ) ) );
+      vSum2 = _mm256_add_pd( vSum2, _mm256_cvtps_pd( _mm256_castps256_ps128( vProd1 ) ) );
+      vSum3 = _mm256_add_pd( vSum3, _mm256_cvtps_pd( _mm256_extractf128_ps( vProd1, 1 ) ) );
+    }
+    _mm_storeu_ps( pBasis + uiCol,      _mm256_cvtpd_ps( _mm256_div_pd( vSum0, vNorm ) ) );
+    _mm_storeu_ps( pBasis + uiCol + 4,  _mm256_cvtpd_ps( _mm256_div_pd( vSum1, vNorm ) ) );
+    _mm_storeu_ps( pBasis + uiCol + 8,  _mm256_cvtpd_ps( _mm256_div_pd( vSum2, vNorm ) ) );
+    _mm_storeu_ps( pBasis + uiCol + 12, _mm256_cvtpd_ps( _mm256_div_pd( vSum3, vNorm ) ) );
+  }
+}
+
+// kernels selected by TComTrQuant::initSimdKernels(), NULL: the C code
+static Void (*s_fpKltCovMatrix)( TrainDataType **pData, UInt uiSampleNum, covMatrixType *pCovMatrix, UInt uiDim ) = NULL;
+static Int  (*s_fpKltInnerProduct)( const TrainDataType *pA, const TrainDataType *pB, Int iLen ) = NULL;
+static Void (*s_fpKltProjectBasis)( const EigenType *pEigenVector, TrainDataType **pData, UInt uiSampleNum, UInt uiDim, Double dNorm, EigenType *pBasis ) = NULL;
+#endif
+
 Bool TComTrQuant::deriveKLT(UInt uiBlkSize, UInt uiUseCandiNumber)
 {
     Bool bSucceedFlag = true;
@@ -13018,6 +14027,49 @@ void OrderData(int *IdRecord, _Ty *pData, UInt uiSize)
     }
 }
 
+#if KLT_PREALLOCATED_EIGEN_SOLVER
+/** eigen decomposition of a symmetric matrix of the KLT derivation, in the solver kept for its dimension
+ *  \param pCovMatrix symmetric uiDim x uiDim matrix, uiDim <= KLT_EIGEN_SOLVER_MAX_DIM
+ *  \param pdEigenVector receives the eigenvectors as rows, ordered by decreasing magnitude of the eigenvalues left in m_pEigenValues
+ */
+Void TComTrQuant::xDeriveEigenVectors(const covMatrixType *pCovMatrix, UInt uiDim, EigenType **pdEigenVector)
+{
+    assert(uiDim <= KLT_EIGEN_SOLVER_MAX_DIM);
+    if (m_apcKLTEigenSolver[uiDim] == NULL)
+    {
+        m_apcKLTEigenSolver[uiDim] = new KLTEigenSolver(uiDim);
+    }
+    KLTEigenSolver *pcSolver = m_apcKLTEigenSolver[uiDim];
+    matrixTypeDefined &cMatrix = pcSolver->cMatrix;
+    // the solver only reads the lower triangle, which is filled column by column from the rows of the symmetric input
+    for (UInt uiCol = 0; uiCol < uiDim; uiCol++)
+    {
+        const covMatrixType *pCovRow = pCovMatrix + uiCol*uiDim;
+        for (UInt uiRow = uiCol; uiRow < uiDim; uiRow++)
+        {
+            cMatrix(uiRow, uiCol) = pCovRow[uiRow];
+        }
+    }
+    SelfAdjointEigenSolver<matrixTypeDefined> &es = pcSolver->cSolver;
+    es.compute(cMatrix);
+    for (UInt uiRow = 0; uiRow < uiDim; uiRow++)
+    {
+        m_pEigenValues[uiRow] = es.eigenvalues()[uiRow];
+    }
+    OrderData(m_pIDTmp, m_pEigenValues, uiDim);
+    const matrixTypeDefined &cEigenVectors = es.eigenvectors();
+    for (UInt uiRow = 0; uiRow < uiDim; uiRow++)
+    {
+        const UInt uiMapedCol = m_pIDTmp[uiRow];
+        EigenType *pEigenVectorRow = pdEigenVector[uiRow];
+        for (UInt uiCol = 0; uiCol < uiDim; uiCol++)
+        {
+            pEigenVectorRow[uiCol] = (EigenType)cEigenVectors(uiCol, uiMapedCol);
+        }
+    }
+}
+#endif
+
 Bool TComTrQuant::derive1DimKLT(UInt uiBlkSize, UInt uiUseCandiNumber)
 {
     Bool bSucceed = true;
@@ -13028,8 +14080,10 @@ Bool TComTrQuant::derive1DimKLT(UInt uiBlkSize, UInt uiUseCandiNumber)
     calcCovMatrix(m_pData, uiUseCandiNumber, covMatrix, uiDim);
     EigenType **pdEigenVector = m_pppdEigenVector[uiTarDepth];
     Short **psEigenVector = m_pppsEigenVector[uiTarDepth];
-    g_ppsEigenVector[uiTarDepth] = psEigenVector;
 
+#if KLT_PREALLOCATED_EIGEN_SOLVER
+    xDeriveEigenVectors(covMatrix, uiDim, pdEigenVector);
+#else
     matrixTypeDefined Cov(uiDim, uiDim);
     UInt i = 0;
     for (UInt uiRow = 0; uiRow < uiDim; uiRow++)
@@ -13054,6 +14108,7 @@ Bool TComTrQuant::derive1DimKLT(UInt uiBlkSize, UInt uiUseCandiNumber)
             pdEigenVector[uiRow][uiCol] = (EigenType)v(uiCol);
         }
     }
+#endif
     Int scale = uiBlkSize*(1 << KLTBASIS_SHIFTBIT);
 #if VCEG_AZ08_USE_SSE_SCLAE
     scaleMatrix(pdEigenVector, psEigenVector, scale, uiDim, uiDim);
@@ -13082,8 +14137,10 @@ Bool TComTrQuant::derive1DimKLT_Fast(UInt uiBlkSize, UInt uiUseCandiNumber)
     EigenType **pdEigenVector = m_pppdTmpEigenVector;
     EigenType **pdEigenVectorTarget = m_pppdEigenVector[uiTarDepth];
     Short **psEigenVector = m_pppsEigenVector[uiTarDepth];
-    g_ppsEigenVector[uiTarDepth] = psEigenVector;
 
+#if KLT_PREALLOCATED_EIGEN_SOLVER
+    xDeriveEigenVectors(covMatrix, uiSampleNum, pdEigenVector);
+#else
     //depend on eigen libarary 
     matrixTypeDefined Cov(uiSampleNum, uiSampleNum);
     UInt i = 0;
@@ -13111,6 +14168,7 @@ Bool TComTrQuant::derive1DimKLT_Fast(UInt uiBlkSize, UInt uiUseCandiNumber)
             pEigenVectorRow[uiCol] = (EigenType)v(uiCol);
         }
     }
+#endif
 
     UInt uiCalcEigNum = uiSampleNum;
 #if VCEG_AZ08_FORCE_USE_GIVENNUM_BASIS
@@ -13133,6 +14191,13 @@ Bool TComTrQuant::derive1DimKLT_Fast(UInt uiBlkSize, UInt uiUseCandiNumber)
         EigenType *pdEigenVectorRow = pdEigenVector[uiRow];
         EigenType *pThisBasisRow = pdEigenVectorTarget[uiRow];
         Double dValueNorm = sqrt(m_pEigenValues[uiRow]);
+#if AVX_KLT_DERIVE_KERNELS
+        if (s_fpKltProjectBasis && (uiDim & 15) == 0)
+        {
+            s_fpKltProjectBasis(pdEigenVectorRow, m_pData, uiSampleNum, uiDim, dValueNorm, pThisBasisRow);
+            continue;
+        }
+#endif
         for (UInt uiCol = 0; uiCol < uiDim; uiCol++)
         {
 #if VCEG_AZ08_USE_FLOATXSHORT_SSE
@@ -13177,6 +14242,9 @@ Void TComTrQuant::calcCovMatrixXXt(TrainDataType **pData, UInt uiSampleNum, covM
     //Get the covariance matrix
     Int covValue; //should be int; if float, the accuracy will be low.
     TrainDataType *pDataCol;
+#if AVX_KLT_DERIVE_KERNELS
+    const Bool bUseAVX2 = s_fpKltInnerProduct && (uiDim & 15) == 0;
+#endif
     for (UInt uiRow = 0; uiRow < uiSampleNum; uiRow++)
     {
         TrainDataType *pDataRow = pData[uiRow];
@@ -13188,6 +14256,13 @@ Void TComTrQuant::calcCovMatrixXXt(TrainDataType **pData, UInt uiSampleNum, covM
 #if VCEG_AZ08_USE_SHORTXSHORT_SSE
             covValue = InnerProduct_SSE_SHORT(pDataRow, pDataCol, uiDim);
 #else
+#if AVX_KLT_DERIVE_KERNELS
+            if (bUseAVX2)
+            {
+                pCovMatrix[offset + uiCol] = (covMatrixType)s_fpKltInnerProduct(pDataRow, pDataCol, uiDim);
+                continue;
+            }
+#endif
             covValue = 0;
             for (Int i = 0; i < uiDim; i++)
             {
@@ -13216,6 +14291,13 @@ Void TComTrQuant::calcCovMatrix(TrainDataType **pData, UInt uiSampleNum, covMatr
 #if !(VCEG_AZ08_USE_TRANSPOSE_CANDDIATEARRAY && VCEG_AZ08_USE_SHORTXSHORT_SSE)
     UInt i;
     TrainDataType *pSample;
+#endif
+#if AVX_KLT_DERIVE_KERNELS
+    if (s_fpKltCovMatrix && (uiDim & 7) == 0)
+    {
+        s_fpKltCovMatrix(pData, uiSampleNum, pCovMatrix, uiDim);
+    }
+    else
 #endif
     for (UInt uiRow = 0; uiRow < uiDim; uiRow++)
     {
@@ -13389,12 +14471,18 @@ Void TComTrQuant::candidateSearch(TComDataCU *pcCU, UInt uiPartAddr, UInt uiBlkS
             setId++;
             setRefPicUsed(setId, ref); //to facilitate the access of each candidate point 
             setRefPicBuf(setId, refPic);
+#if KLT_ON_DEMAND_SUBPEL_PLANES
+            m_aucRefQuaPos[setId] = 0;
+#endif
             setStride(refPicRec->getStride(compID));
             searchCandidateFromOnePicInteger(pcCU, uiPartAddr, refPicRec, cMv, tarPatch, uiPatchSize, uiTempSize, setId);
         }
     }
 
     Short setIdFraStart = setId + 1;
+#if KLT_FAST_CANDIDATE_SEARCH
+    m_tempLibFast.sortCandidates();
+#endif
     RecordPosition(uiTargetCandiNum);
     searchCandidateFraBasedOnInteger(pcCU, tarPatch, uiPatchSize, uiTempSize, uiPartAddr, setIdFraStart);
 }
@@ -13405,13 +14493,17 @@ Void TComTrQuant::searchCandidateFromOnePicInteger(TComDataCU *pcCU, UInt uiPart
     UInt uiBlkSize = uiPatchSize - uiTempSize;
     UInt uiTarDepth = g_aucConvertToBit[uiBlkSize];
     UInt uiTargetCandiNum = g_uiDepth2MaxCandiNum[uiTarDepth];
+#if !KLT_FAST_CANDIDATE_SEARCH
     UInt  uiLibSizeMinusOne = uiTargetCandiNum - 1;
+#endif
     m_uiPartLibSize = uiTargetCandiNum;
 
+#if !KLT_FAST_CANDIDATE_SEARCH
     Int *pX = m_tempLibFast.getX();
     Int *pY = m_tempLibFast.getY();
     DistType *pDiff = m_tempLibFast.getDiff();
     Short *pId = m_tempLibFast.getId();
+#endif
 
     Int  refStride = refPic->getStride(compID);
     Pel  *ref = refPic->getAddr(compID, pcCU->getCtuRsAddr(), pcCU->getZorderIdxInCtu() + uiPartAddr);
@@ -13429,7 +14521,18 @@ Void TComTrQuant::searchCandidateFromOnePicInteger(TComDataCU *pcCU, UInt uiPart
 
     //search
     Pel *refMove = ref + mvYMin*refStride + mvXMin;
+#if KLT_FAST_CANDIDATE_SEARCH
+#if VCEG_AZ08_USE_SAD_DISTANCE
+    const Bool bUseSumBound = uiBlkSize >= KLT_SUM_BOUND_MIN_BLKSIZE && mvXMax >= mvXMin && mvYMax >= mvYMin;
+    if (bUseSumBound)
+    {
+        xInitSumSegments(tarPatch, uiBlkSize, uiTempSize, false);
+        xBuildSumTable(refMove - uiTempSize*refStride - uiTempSize, refStride, mvXMax - mvXMin + uiPatchSize, mvYMax - mvYMin + uiPatchSize);
+    }
+#endif
+#else
     DistType *pDiffEnd = &pDiff[uiLibSizeMinusOne];
+#endif
 
     DistType diff;
     for (Int iYOffset = mvYMin; iYOffset <= mvYMax; iYOffset++)
@@ -13437,6 +14540,22 @@ Void TComTrQuant::searchCandidateFromOnePicInteger(TComDataCU *pcCU, UInt uiPart
         Pel *refCurr = refMove;
         for (Int iXOffset = mvXMin; iXOffset <= mvXMax; iXOffset++)
         {
+#if KLT_FAST_CANDIDATE_SEARCH
+            const DistType worstDiff = m_tempLibFast.getWorstDiff();
+#if VCEG_AZ08_USE_SAD_DISTANCE
+            if (bUseSumBound && xGetSumLowerBound(iXOffset - mvXMin, iYOffset - mvYMin) >= worstDiff)
+            {
+                refCurr++;
+                continue;
+            }
+#endif
+            diff = calcPatchDiff(refCurr, refStride, tarPatch, uiPatchSize, uiTempSize, worstDiff);
+            refCurr++;
+            if (diff > 0 && diff < worstDiff)//when residual is zero, may not contribute to the distribution.
+            {
+                m_tempLibFast.insertCandidate(diff, iXOffset, iYOffset, setId);
+            }
+#else
             //The position of the leftup pixel within this block: refCurr = ref + iYOffset*refStride + iXOffset;
             diff = calcPatchDiff(refCurr, refStride, tarPatch, uiPatchSize, uiTempSize, *pDiffEnd);
             refCurr++;
@@ -13444,6 +14563,7 @@ Void TComTrQuant::searchCandidateFromOnePicInteger(TComDataCU *pcCU, UInt uiPart
             {
                 insertNode(diff, iXOffset, iYOffset, pDiff, pX, pY, pId, uiLibSizeMinusOne, setId);
             }
+#endif
         }
         refMove += refStride;
     }
@@ -13453,12 +14573,16 @@ Void TComTrQuant::searchCandidateFromOnePicInteger(TComDataCU *pcCU, UInt uiPart
 Void TComTrQuant::searchCandidateFraBasedOnInteger(TComDataCU *pcCU, Pel **tarPatch, UInt uiPatchSize, UInt uiTempSize, UInt uiPartAddr, Short setIdFraStart)
 {
     const ComponentID compID = COMPONENT_Y;
+#if !KLT_FAST_CANDIDATE_SEARCH
     UInt uiBlkSize = uiPatchSize - uiTempSize;
     UInt uiTarDepth = g_aucConvertToBit[uiBlkSize];
     UInt uiTargetCandiNum = g_uiDepth2MaxCandiNum[uiTarDepth];
     UInt  uiLibSizeMinusOne = uiTargetCandiNum - 1;
+#endif
     Int  refStride = getStride();
+#if !KLT_ON_DEMAND_SUBPEL_PLANES
     Pel *ref;
+#endif
     UInt setId;
     Int iCandiPosNum = m_uiPartLibSize;
 
@@ -13467,17 +14591,34 @@ Void TComTrQuant::searchCandidateFraBasedOnInteger(TComDataCU *pcCU, Pel **tarPa
     Int *pYInteger = m_tempLibFast.getYInteger();
     Short *pIdInteger = m_tempLibFast.getIdInteger();
 
+#if !KLT_FAST_CANDIDATE_SEARCH
     Int *pX = m_tempLibFast.getX();
     Int *pY = m_tempLibFast.getY();
     DistType *pDiff = m_tempLibFast.getDiff();
     Short *pId = m_tempLibFast.getId();
+#endif
 
     DistType diff;
     Pel *refCurr, *refCenter;
+#if KLT_FAST_CANDIDATE_SEARCH
+    static const Int aiNeighbourX[4] = { 0, -1, 0, -1 }; //center, left, up, left-up
+    static const Int aiNeighbourY[4] = { 0, 0, -1, -1 };
+#else
     DistType *pDiffEnd = &pDiff[uiLibSizeMinusOne];
+#endif
     Int iOffsetY, iOffsetX;
     TComPic* refPic;
     UInt uiIdxAddr = pcCU->getZorderIdxInCtu() + uiPartAddr;
+#if KLT_ON_DEMAND_SUBPEL_PLANES
+    // position of the block, the fractional pictures have the layout of the reconstruction
+    TComPicYuv *pcPicYuvRec = pcCU->getPic()->getPicYuvRec();
+    const Int iBlkOffset = Int(pcPicYuvRec->getAddr(compID, pcCU->getCtuRsAddr(), uiIdxAddr) - pcPicYuvRec->getAddr(compID));
+    const Int iBlkPosX = iBlkOffset % refStride;
+    const Int iBlkPosY = iBlkOffset / refStride;
+    m_iKltBlkPosX = iBlkPosX;
+    m_iKltBlkPosY = iBlkPosY;
+    assert(uiPatchSize + 1 <= KLT_SUBPEL_AREA_SIZE);
+#endif
     Short setIdFra = setIdFraStart - 1;
     for (k = 0; k < iCandiPosNum; k++)
     {
@@ -13493,12 +14634,36 @@ Void TComTrQuant::searchCandidateFraBasedOnInteger(TComDataCU *pcCU, Pel **tarPa
             {
                 if (uiRow != 0 || uiCol != 0)
                 {
+#if KLT_ON_DEMAND_SUBPEL_PLANES
+                    // the area of the patches at the candidate and at its left, upper and left-upper neighbours
+                    Int iAreaStride;
+                    Pel *pArea = refPic->getQuaRegion(uiRow, uiCol, iBlkPosX + iOffsetX - 1 - Int(uiTempSize), iBlkPosY + iOffsetY - 1 - Int(uiTempSize), uiPatchSize + 1, uiPatchSize + 1, m_acQuaArea, iAreaStride);
+                    refStride = iAreaStride;
+
+                    setIdFra++;
+                    setRefPicBuf(setIdFra, refPic);
+                    m_aucRefQuaPos[setIdFra] = UChar(uiRow * 4 + uiCol);
+                    refCenter = pArea + (1 + uiTempSize) * refStride + 1 + uiTempSize;
+#else
                     TComPicYuv *refPicRec = refPic->getPicQuaYuvRec(uiRow, uiCol);
                     ref = refPicRec->getAddr(compID, pcCU->getCtuRsAddr(), uiIdxAddr);
 
                     setIdFra++;
                     setRefPicUsed(setIdFra, ref);
                     refCenter = ref + iOffsetY*refStride + iOffsetX;
+#endif
+#if KLT_FAST_CANDIDATE_SEARCH
+                    for (Int n = 0; n < 4; n++)
+                    {
+                        const DistType worstDiff = m_tempLibFast.getWorstDiff();
+                        refCurr = refCenter + aiNeighbourY[n]*refStride + aiNeighbourX[n];
+                        diff = calcPatchDiff(refCurr, refStride, tarPatch, uiPatchSize, uiTempSize, worstDiff);
+                        if (diff > 0 && diff < worstDiff)
+                        {
+                            m_tempLibFast.insertCandidate(diff, iOffsetX + aiNeighbourX[n], iOffsetY + aiNeighbourY[n], setIdFra);
+                        }
+                    }
+#else
                     //center
                     refCurr = refCenter;
                     diff = calcPatchDiff(refCurr, refStride, tarPatch, uiPatchSize, uiTempSize, *pDiffEnd);
@@ -13527,10 +14692,14 @@ Void TComTrQuant::searchCandidateFraBasedOnInteger(TComDataCU *pcCU, Pel **tarPa
                     {
                         insertNode(diff, iOffsetX - 1, iOffsetY - 1, pDiff, pX, pY, pId, uiLibSizeMinusOne, setIdFra);
                     }
+#endif
                 }
             }
         }
     }
+#if KLT_FAST_CANDIDATE_SEARCH
+    m_tempLibFast.sortCandidates();
+#endif
 }
 
 Void TComTrQuant::xSetSearchRange(TComDataCU* pcCU, TComMv& cMvPred, Int iSrchRng, TComMv& rcMvSrchRngLT, TComMv& rcMvSrchRngRB)
@@ -13629,7 +14798,9 @@ Bool TComTrQuant::prepareKLTSamplesInter(UInt uiBlkSize, UInt uiTempSize)
     {
         return false;
     }
+#if !KLT_ON_DEMAND_SUBPEL_PLANES
     Int picStride = getStride();
+#endif
     Pel predBlk[MAX_1DTRANS_LEN];
     Int i = 0;
 
@@ -13647,7 +14818,9 @@ Bool TComTrQuant::prepareKLTSamplesInter(UInt uiBlkSize, UInt uiTempSize)
     Int *pY = m_tempLibFast.getY();
     Short *pId = m_tempLibFast.getId();
     Short setId;
+#if !KLT_ON_DEMAND_SUBPEL_PLANES
     Pel *ref;
+#endif
     Int iOffsetY, iOffsetX;
     Pel *refTarget;
 
@@ -13659,8 +14832,14 @@ Bool TComTrQuant::prepareKLTSamplesInter(UInt uiBlkSize, UInt uiTempSize)
         pData = m_pData[k];
         iOffsetY = pY[k];
         iOffsetX = pX[k];
+#if KLT_ON_DEMAND_SUBPEL_PLANES
+        Int iRefStride;
+        refTarget = getRefPicBuf(setId)->getQuaRegion(m_aucRefQuaPos[setId] >> 2, m_aucRefQuaPos[setId] & 3, m_iKltBlkPosX + iOffsetX, m_iKltBlkPosY + iOffsetY, uiWidth, uiHeight, m_acQuaArea, iRefStride);
+#else
+        const Int iRefStride = picStride;
         ref = getRefPicUsed(setId);
         refTarget = ref + iOffsetY*picStride + iOffsetX;
+#endif
         i = 0;
         for (UInt uiY = 0; uiY < uiHeight; uiY++)
         {
@@ -13668,7 +14847,7 @@ Bool TComTrQuant::prepareKLTSamplesInter(UInt uiBlkSize, UInt uiTempSize)
             {
                 *pData++ = refTarget[uiX] - predBlk[i++];
             }
-            refTarget += picStride;
+            refTarget += iRefStride;
         }
     }
 
@@ -13704,6 +14883,9 @@ Void TempLibFast::initTemplateDiff(UInt uiPatchSize, UInt uiBlkSize, Int bitDept
     {
         m_pDiff[i] = maxValue;
     }
+#if KLT_FAST_CANDIDATE_SEARCH
+    initHeap(maxValue, iCandiNumber);
+#endif
 }
 
 Void TComTrQuant::getTargetTemplate(TComDataCU *pcCU, UInt uiAbsPartIdx, UInt uiBlkSize, UInt uiTempSize)
@@ -13767,13 +14949,18 @@ Void  TComTrQuant::searchCandidateFromOnePicIntra(TComDataCU *pcCU, UInt uiPartA
     if (TMPRED0_TMPREDKLT1_ORI2 == 0)
     {
         uiTargetCandiNum = min((UInt)TMPRED_CANDI_NUM, uiTargetCandiNum);
+#if KLT_FAST_CANDIDATE_SEARCH
+        m_tempLibFast.initHeap(m_tempLibFast.getDiffMax(), uiTargetCandiNum);
+#endif
     }
+#if !KLT_FAST_CANDIDATE_SEARCH
     UInt  uiLibSizeMinusOne = uiTargetCandiNum - 1;
 
     Int *pX = m_tempLibFast.getX();
     Int *pY = m_tempLibFast.getY();
     DistType *pDiff = m_tempLibFast.getDiff();
     Short *pId = m_tempLibFast.getId();
+#endif
     Int     refStride = refPic->getStride(compID);
     Int zOrder = pcCU->getZorderIdxInCtu() + uiPartAddr;
     Pel *ref = refPic->getAddr(compID, pcCU->getCtuRsAddr(), zOrder);
@@ -13799,8 +14986,17 @@ Void  TComTrQuant::searchCandidateFromOnePicIntra(TComDataCU *pcCU, UInt uiPartA
 
     Int iYOffset, iXOffset;
     DistType diff;
+#if !KLT_FAST_CANDIDATE_SEARCH
     DistType *pDiffEnd = &pDiff[uiLibSizeMinusOne];
+#endif
     Pel *refCurr;
+#if KLT_FAST_CANDIDATE_SEARCH && VCEG_AZ08_USE_SAD_DISTANCE
+    const Bool bUseSumBound = uiBlkSize >= KLT_SUM_BOUND_MIN_BLKSIZE;
+    if (bUseSumBound)
+    {
+        xInitSumSegments(tarPatch, uiBlkSize, uiTempSize, true);
+    }
+#endif
 
 #define REGION_NUM 3
     Int mvYMins[REGION_NUM];
@@ -13862,6 +15058,12 @@ Void  TComTrQuant::searchCandidateFromOnePicIntra(TComDataCU *pcCU, UInt uiPartA
         {
             continue;
         }
+#if KLT_FAST_CANDIDATE_SEARCH && VCEG_AZ08_USE_SAD_DISTANCE
+        if (bUseSumBound)
+        {
+            xBuildSumTable(ref + (mvYMin - iTemplateSize)*refStride + mvXMin - iTemplateSize, refStride, mvXMax - mvXMin + uiPatchSize, mvYMax - mvYMin + uiPatchSize);
+        }
+#endif
         for (iYOffset = mvYMax; iYOffset >= mvYMin; iYOffset--)
         {
             for (iXOffset = mvXMax; iXOffset >= mvXMin; iXOffset--)
@@ -13875,11 +15077,26 @@ Void  TComTrQuant::searchCandidateFromOnePicIntra(TComDataCU *pcCU, UInt uiPartA
                     //Ignore the blocks that have not been coded.
                     continue;
                 }
+#if KLT_FAST_CANDIDATE_SEARCH
+                const DistType worstDiff = m_tempLibFast.getWorstDiff();
+#if VCEG_AZ08_USE_SAD_DISTANCE
+                if (bUseSumBound && xGetSumLowerBound(iXOffset - mvXMin, iYOffset - mvYMin) >= worstDiff)
+                {
+                    continue;
+                }
+#endif
+                diff = calcTemplateDiff(refCurr, refStride, tarPatch, uiPatchSize, uiTempSize, worstDiff);
+                if (diff < worstDiff)
+                {
+                    m_tempLibFast.insertCandidate(diff, iXOffset, iYOffset, setId);
+                }
+#else
                 diff = calcTemplateDiff(refCurr, refStride, tarPatch, uiPatchSize, uiTempSize, *pDiffEnd);
                 if (diff < (*pDiffEnd))
                 {
                     insertNode(diff, iXOffset, iYOffset, pDiff, pX, pY, pId, uiLibSizeMinusOne, setId);
                 }
+#endif
             }
         }
     }
@@ -13899,19 +15116,43 @@ Void  TComTrQuant::searchCandidateFromOnePicIntra(TComDataCU *pcCU, UInt uiPartA
         {
             continue;
         }
+#if KLT_FAST_CANDIDATE_SEARCH && VCEG_AZ08_USE_SAD_DISTANCE
+        if (bUseSumBound && mvYMax >= mvYMin)
+        {
+            xBuildSumTable(ref + (mvYMin - iTemplateSize)*refStride + mvXMin - iTemplateSize, refStride, mvXMax - mvXMin + uiPatchSize, mvYMax - mvYMin + uiPatchSize);
+        }
+#endif
         for (iYOffset = mvYMax; iYOffset >= mvYMin; iYOffset--)
         {
             for (iXOffset = mvXMax; iXOffset >= mvXMin; iXOffset--)
             {
                 refCurr = ref + iYOffset*refStride + iXOffset;
+#if KLT_FAST_CANDIDATE_SEARCH
+                const DistType worstDiff = m_tempLibFast.getWorstDiff();
+#if VCEG_AZ08_USE_SAD_DISTANCE
+                if (bUseSumBound && xGetSumLowerBound(iXOffset - mvXMin, iYOffset - mvYMin) >= worstDiff)
+                {
+                    continue;
+                }
+#endif
+                diff = calcTemplateDiff(refCurr, refStride, tarPatch, uiPatchSize, uiTempSize, worstDiff);
+                if (diff < worstDiff)
+                {
+                    m_tempLibFast.insertCandidate(diff, iXOffset, iYOffset, setId);
+                }
+#else
                 diff = calcTemplateDiff(refCurr, refStride, tarPatch, uiPatchSize, uiTempSize, *pDiffEnd);
                 if (diff < (*pDiffEnd))
                 {
                     insertNode(diff, iXOffset, iYOffset, pDiff, pX, pY, pId, uiLibSizeMinusOne, setId);
                 }
+#endif
             }
         }
     }
+#if KLT_FAST_CANDIDATE_SEARCH
+    m_tempLibFast.sortCandidates();
+#endif
 }
 
 Bool TComTrQuant::generateTMPrediction(Pel *piPred, UInt uiStride, UInt uiBlkSize, UInt uiTempSize, Int &foundCandiNum)
@@ -14084,6 +15325,132 @@ Bool TComTrQuant::prepareKLTSamplesIntra(Pel *piPred, UInt uiStride, UInt uiBlkS
     return true;
 }
 
+#if AVX_KLT_SAD_KERNELS
+/** SAD between a reference patch and the target patch of the KLT candidate search, template and block or template only
+ *  \param piRef top-left sample of the reference patch, that is of its template
+ *  \param iBlkSize block size, 4, 8, 16 or 32
+ *  \param iTempSize template size, 1 to 4
+ *  \returns the SAD if it does not exceed iMax, else a partial sum larger than iMax
+ */
+__attribute__((target("avx2")))
+static DistType simdKltPatchSadAVX2( const Pel* piRef, Int iRefStride, Pel** tarPatch, Int iBlkSize, Int iTempSize, Bool bTemplateOnly, DistType iMax )
+{
+  // the first four samples of a row are loaded together, those beyond the template belong to the block
+  static const Short s_aiTemplateMask[5][8] = { {  0,  0,  0,  0 }, { -1,  0,  0,  0 }, { -1, -1,  0,  0 }, { -1, -1, -1,  0 }, { -1, -1, -1, -1 } };
+  const __m128i vTemplateMask = _mm_loadu_si128( ( const __m128i* )s_aiTemplateMask[iTempSize] );
+  const __m128i vOnes128      = _mm_set1_epi16( 1 );
+  const __m256i vOnes256      = _mm256_set1_epi16( 1 );
+  const Int     iPatchSize    = iBlkSize + iTempSize;
+  __m128i vSum128 = _mm_setzero_si128();
+  __m256i vSum256 = _mm256_setzero_si256();
+
+  for( Int iY = 0; iY < iPatchSize; iY++, piRef += iRefStride )
+  {
+    const Pel* piTar = tarPatch[iY];
+    const __m128i vTemplate = _mm_abs_epi16( _mm_sub_epi16( _mm_loadl_epi64( ( const __m128i* )piRef ), _mm_loadl_epi64( ( const __m128i* )piTar ) ) );
+    vSum128 = _mm_add_epi32( vSum128, _mm_madd_epi16( _mm_and_si128( vTemplate, vTemplateMask ), vOnes128 ) );
+
+    if( iY < iTempSize || !bTemplateOnly )
+    {
+      const Pel* piRefBlk = piRef + iTempSize;
+      const Pel* piTarBlk = piTar + iTempSize;
+      switch( iBlkSize )
+      {
+      case 4:
+        vSum128 = _mm_add_epi32( vSum128, _mm_madd_epi16( _mm_abs_epi16( _mm_sub_epi16( _mm_loadl_epi64( ( const __m128i* )piRefBlk ), _mm_loadl_epi64( ( const __m128i* )piTarBlk ) ) ), vOnes128 ) );
+        break;
+      case 8:
+        vSum128 = _mm_add_epi32( vSum128, _mm_madd_epi16( _mm_abs_epi16( _mm_sub_epi16( _mm_loadu_si128( ( const __m128i* )piRefBlk ), _mm_loadu_si128( ( const __m128i* )piTarBlk ) ) ), vOnes128 ) );
+        break;
+      default:
+        for( Int iX = 0; iX < iBlkSize; iX += 16 )
+        {
+          const __m256i vAbs = _mm256_abs_epi16( _mm256_sub_epi16( _mm256_loadu_si256( ( const __m256i* )( piRefBlk + iX ) ), _mm256_loadu_si256( ( const __m256i* )( piTarBlk + iX ) ) ) );
+          vSum256 = _mm256_add_epi32( vSum256, _mm256_madd_epi16( vAbs, vOnes256 ) );
+        }
+        break;
+      }
+    }
+
+    __m128i vTotal = _mm_add_epi32( vSum128, _mm_add_epi32( _mm256_castsi256_si128( vSum256 ), _mm256_extracti128_si256( vSum256, 1 ) ) );
+    vTotal = _mm_add_epi32( vTotal, _mm_shuffle_epi32( vTotal, 0x4e ) );
+    vTotal = _mm_add_epi32( vTotal, _mm_shuffle_epi32( vTotal, 0xb1 ) );
+    const DistType iDiffSum = _mm_cvtsi128_si32( vTotal );
+    if( iDiffSum > iMax || iY == iPatchSize - 1 )
+    {
+      return iDiffSum;
+    }
+  }
+  return 0;
+}
+
+#endif
+
+#if SSE2_KLT_SAD_KERNELS
+/** SSE2 version of simdKltPatchSadAVX2(), for CPUs without AVX2
+ */
+static DistType simdKltPatchSadSSE2( const Pel* piRef, Int iRefStride, Pel** tarPatch, Int iBlkSize, Int iTempSize, Bool bTemplateOnly, DistType iMax )
+{
+  static const Short s_aiTemplateMask[5][8] = { {  0,  0,  0,  0 }, { -1,  0,  0,  0 }, { -1, -1,  0,  0 }, { -1, -1, -1,  0 }, { -1, -1, -1, -1 } };
+  const __m128i vTemplateMask = _mm_loadu_si128( ( const __m128i* )s_aiTemplateMask[iTempSize] );
+  const __m128i vOnes         = _mm_set1_epi16( 1 );
+  const Int     iPatchSize    = iBlkSize + iTempSize;
+  __m128i vSum = _mm_setzero_si128();
+
+  for( Int iY = 0; iY < iPatchSize; iY++, piRef += iRefStride )
+  {
+    const Pel* piTar = tarPatch[iY];
+    __m128i vRef = _mm_loadl_epi64( ( const __m128i* )piRef );
+    __m128i vTar = _mm_loadl_epi64( ( const __m128i* )piTar );
+    // SSE2 has no abs_epi16, max( a - b, b - a ) is the same for the sample differences
+    __m128i vAbs = _mm_max_epi16( _mm_sub_epi16( vRef, vTar ), _mm_sub_epi16( vTar, vRef ) );
+    vSum = _mm_add_epi32( vSum, _mm_madd_epi16( _mm_and_si128( vAbs, vTemplateMask ), vOnes ) );
+
+    if( iY < iTempSize || !bTemplateOnly )
+    {
+      const Pel* piRefBlk = piRef + iTempSize;
+      const Pel* piTarBlk = piTar + iTempSize;
+      if( iBlkSize == 4 )
+      {
+        vRef = _mm_loadl_epi64( ( const __m128i* )piRefBlk );
+        vTar = _mm_loadl_epi64( ( const __m128i* )piTarBlk );
+        vAbs = _mm_max_epi16( _mm_sub_epi16( vRef, vTar ), _mm_sub_epi16( vTar, vRef ) );
+        vSum = _mm_add_epi32( vSum, _mm_madd_epi16( vAbs, vOnes ) );
+      }
+      else
+      {
+        for( Int iX = 0; iX < iBlkSize; iX += 8 )
+        {
+          vRef = _mm_loadu_si128( ( const __m128i* )( piRefBlk + iX ) );
+          vTar = _mm_loadu_si128( ( const __m128i* )( piTarBlk + iX ) );
+          vAbs = _mm_max_epi16( _mm_sub_epi16( vRef, vTar ), _mm_sub_epi16( vTar, vRef ) );
+          vSum = _mm_add_epi32( vSum, _mm_madd_epi16( vAbs, vOnes ) );
+        }
+      }
+    }
+
+    __m128i vTotal = _mm_add_epi32( vSum, _mm_shuffle_epi32( vSum, 0x4e ) );
+    vTotal = _mm_add_epi32( vTotal, _mm_shuffle_epi32( vTotal, 0xb1 ) );
+    const DistType iDiffSum = _mm_cvtsi128_si32( vTotal );
+    if( iDiffSum > iMax || iY == iPatchSize - 1 )
+    {
+      return iDiffSum;
+    }
+  }
+  return 0;
+}
+
+#endif
+
+#if AVX_KLT_SAD_KERNELS || SSE2_KLT_SAD_KERNELS
+static DistType (*s_fpKltPatchSad)( const Pel* piRef, Int iRefStride, Pel** tarPatch, Int iBlkSize, Int iTempSize, Bool bTemplateOnly, DistType iMax ) = NULL; ///< selected by TComTrQuant::initSimdKernels(), NULL: the C code computes the SAD
+
+static inline Bool useKltPatchSad( UInt uiBlkSize, UInt uiTempSize )
+{
+  return s_fpKltPatchSad && uiTempSize >= 1 && uiTempSize <= 4 && ( uiBlkSize == 4 || uiBlkSize == 8 || uiBlkSize == 16 || uiBlkSize == 32 );
+}
+#endif
+
 #if VCEG_AZ08_USE_SSE_TMP_SAD
 DistType TComTrQuant::calcTemplateDiff(Pel *ref, UInt uiStride, Pel **tarPatch, UInt uiPatchSize, UInt uiTempSize, DistType iMax)
 {
@@ -14091,8 +15458,6 @@ DistType TComTrQuant::calcTemplateDiff(Pel *ref, UInt uiStride, Pel **tarPatch,
     Int iDiffSum = 0;
     Pel *refPatchRow = ref - uiTempSize*uiStride - uiTempSize;
     Pel *tarPatchRow;
-    static int id = 0;
-    id++;
     for (iY = 0; iY < uiTempSize; iY++)
     {
         tarPatchRow = tarPatch[iY];
@@ -14153,6 +15518,12 @@ DistType TComTrQuant::calcTemplateDiff(Pel *ref, UInt uiStride, Pel **tarPatch,
 #else
 DistType TComTrQuant::calcTemplateDiff(Pel *ref, UInt uiStride, Pel **tarPatch, UInt uiPatchSize, UInt uiTempSize, DistType iMax)
 {
+#if AVX_KLT_SAD_KERNELS || SSE2_KLT_SAD_KERNELS
+    if (useKltPatchSad(uiPatchSize - uiTempSize, uiTempSize))
+    {
+        return s_fpKltPatchSad(ref - uiTempSize*uiStride - uiTempSize, uiStride, tarPatch, uiPatchSize - uiTempSize, uiTempSize, true, iMax);
+    }
+#endif
     Int iY, iX;
 #if VCEG_AZ08_USE_SSD_DISTANCE
     Int iDiff;
@@ -14262,6 +15633,12 @@ DistType TComTrQuant::calcPatchDiff(Pel *ref, UInt uiStride, Pel **tarPatch, UIn
     }
     return blkDiffSum;
 #else
+#if AVX_KLT_SAD_KERNELS || SSE2_KLT_SAD_KERNELS
+    if (useKltPatchSad(uiPatchSize - uiTempSize, uiTempSize))
+    {
+        return s_fpKltPatchSad(ref - uiTempSize*uiStride - uiTempSize, uiStride, tarPatch, uiPatchSize - uiTempSize, uiTempSize, false, iMax);
+    }
+#endif
     Int iY, iX;
 #if VCEG_AZ08_USE_SSD_DISTANCE
     Int iDiff;
@@ -14651,4 +16028,40 @@ int AbsSumOfVectorLesseqthan8(short *pa, short *pb, int m)
     return sum;
 }
 #endif
+
+/** Select the transform, NSST, RDOQ and KLT kernels of a SIMD level, called once at start-up by initSimdLevel()
+ */
+Void TComTrQuant::initSimdKernels( SimdLevel eLevel )
+{
+#if AVX_TRANSFORM_KERNELS
+  fastFwdTrans = eLevel >= SIMD_AVX2 ? fastFwdTransAVX2 : fastFwdTransC;
+  fastInvTrans = eLevel >= SIMD_AVX2 ? fastInvTransAVX2 : fastInvTransC;
+#endif
+#if AVX_NSST_KERNELS
+  s_afpNsstHyGT[0][0] = eLevel >= SIMD_AVX2 ? simdNsstHyGTAVX2<16, false> : NULL;
+  s_afpNsstHyGT[0][1] = eLevel >= SIMD_AVX2 ? simdNsstHyGTAVX2<16, true > : NULL;
+  s_afpNsstHyGT[1][0] = eLevel >= SIMD_AVX2 ? simdNsstHyGTAVX2<64, false> : NULL;
+  s_afpNsstHyGT[1][1] = eLevel >= SIMD_AVX2 ? simdNsstHyGTAVX2<64, true > : NULL;
+#endif
+#if AVX_RDOQ_KERNELS
+  s_fpQuantBlockRDOQ  = eLevel >= SIMD_AVX2 ? simdQuantBlockRDOQAVX2 : NULL;
+#endif
+#if AVX_KLT_DERIVE_KERNELS
+  s_fpKltCovMatrix    = eLevel >= SIMD_AVX2 ? simdKltCovMatrixAVX2 : NULL;
+  s_fpKltInnerProduct = eLevel >= SIMD_AVX2 ? simdKltInnerProductAVX2 : NULL;
+  s_fpKltProjectBasis = eLevel >= SIMD_AVX2 ? simdKltProjectBasisAVX2 : NULL;
+#endif
+#if AVX_KLT_SAD_KERNELS
+  if( eLevel >= SIMD_AVX2 )
+  {
+    s_fpKltPatchSad = simdKltPatchSadAVX2;
+    return;
+  }
+#endif
+#if SSE2_KLT_SAD_KERNELS
+  s_fpKltPatchSad = eLevel >= SIMD_SSE2 ? simdKltPatchSadSSE2 : NULL;
+#elif AVX_KLT_SAD_KERNELS
+  s_fpKltPatchSad = NULL;
+#endif
+}
 //! \}
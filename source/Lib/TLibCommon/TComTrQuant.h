@@ -64,6 +64,9 @@ extern UInt g_uiDepth2IntraTempSize[5];
 extern UInt g_uiDepth2MaxCandiNum[5];
 extern UInt g_uiDepth2MinCandiNum[5];
 #endif
+#if KLT_PREALLOCATED_EIGEN_SOLVER
+struct KLTEigenSolver;
+#endif
 // ====================================================================================================================
 // Type definition
 // ====================================================================================================================
@@ -279,6 +282,21 @@ void fastInverseDST1_B128(TCoeff *coeff,TCoeff *block,Int shift, Int line, Int z
 typedef void FwdTrans (TCoeff *, TCoeff *, Int, Int, Int, Int);
 typedef void InvTrans (TCoeff *, TCoeff *, Int, Int, Int, Int, const TCoeff, const TCoeff);
 #endif//JVET_D0077_TRANSFORM_OPT
+
+// 2D EMT transforms with the 1D transforms above, or their SIMD kernels
+void xTrMxN_EMT (Int bitDepth, TCoeff *block, TCoeff *coeff, Int iWidth, Int iHeight, Bool useDST, const Int maxLog2TrDynamicRange, UChar ucMode, UChar ucTrIdx);
+#if JVET_C0024_ITSKIP
+void xITrMxN_EMT(Int bitDepth, TCoeff *coeff, TCoeff *block, Int iWidth, Int iHeight, UInt uiSkipWidth, UInt uiSkipHeight, Bool useDST, const Int maxLog2TrDynamicRange, UChar ucMode, UChar ucTrIdx);
+#else
+void xITrMxN_EMT(Int bitDepth, TCoeff *coeff, TCoeff *block, Int iWidth, Int iHeight, Bool useDST, const Int maxLog2TrDynamicRange, UChar ucMode, UChar ucTrIdx);
+#endif
+#endif
+
+#if RDOQ_BLOCK_QUANT
+// quantisation pass of RDOQ over the whole TU, or its SIMD kernel
+Bool quantBlockRDOQ( const TCoeff* plSrcCoeff, UInt uiNumCoeff, const Int* piQCoef, Int iQCoef, const Double* pdErrScale, Double dErrScale,
+                     Int iQBits, TCoeff iMaxLevel, TCoeff* piArlDstCoeff, Int iQBitsC, Int iAddC,
+                     Intermediate_Int* plLevelDouble, UInt* puiMaxAbsLevel, Double* pdUncodedCost );
 #endif
 
 typedef struct
@@ -368,6 +386,26 @@ public:
 #endif
     Int m_diffMax;
     Int getDiffMax() { return m_diffMax; }
+#if KLT_FAST_CANDIDATE_SEARCH
+    /// largest distance of the k-best list, a candidate has to be closer to enter it
+    DistType getWorstDiff() { return m_pHeap[0].diff; }
+    Void insertCandidate(DistType diff, Int iXOffset, Int iYOffset, Short setId);
+    Void sortCandidates();
+    Void initHeap(DistType maxValue, Int iCandiNumber);
+
+    struct Candidate
+    {
+      DistType diff;
+      Int      x;
+      Int      y;
+      Short    id;
+    };
+
+private:
+    Candidate *m_pHeap;     ///< k-best list as a max-heap on the distance
+    Candidate *m_pSorted;   ///< scratch buffer of sortCandidates()
+    Int        m_iHeapSize;
+#endif
 };
 
 typedef Short TrainDataType; 
@@ -380,6 +418,7 @@ class TComTrQuant
 public:
   TComTrQuant();
   ~TComTrQuant();
+  static Void initSimdKernels( SimdLevel eLevel );
 
   // initialize class
   Void init                 ( UInt  uiMaxTrSize,
@@ -402,6 +441,9 @@ public:
   UChar getEmtTrIdx ( TComTU &rTu, const ComponentID compID );
   UChar getEmtMode  ( TComTU &rTu, const ComponentID compID );
 #endif
+#if PRIMARY_TRANSFORM_CACHE
+  static Void getPrimaryTransformCacheStats( UInt64 &ruiLookups, UInt64 &ruiHits );
+#endif
 #if VCEG_AZ08_USE_KLT
   UInt getUseKLT() { return m_useKLT;}
   UInt getUseIntraKLT() { return m_useKLT & 1; }
@@ -463,11 +505,17 @@ Void InvNsst8x8( Int* src, UInt uiMode, UChar index );
 #if RDOQ_CHROMA_LAMBDA
   Void setLambdas(const Double lambdas[MAX_NUM_COMPONENT]) { for (UInt component = 0; component < MAX_NUM_COMPONENT; component++) m_lambdas[component] = lambdas[component]; }
   Void selectLambda(const ComponentID compIdx) { m_dLambda = m_lambdas[compIdx]; }
+#if PARALLEL_SUBSTREAM_ENCODING
+  const Double* getLambdas() const { return m_lambdas; }
+#endif
 #if COM16_C806_CR_FROM_CB_LAMBDA_ADJUSTMENT
   Void setLambda( Double dLambda) { m_dLambda = dLambda; }
 #endif
 #else
   Void setLambda(Double dLambda) { m_dLambda = dLambda;}
+#if PARALLEL_SUBSTREAM_ENCODING
+  Double getLambda() const { return m_dLambda; }
+#endif
 #endif
 
 #if COM16_C806_CR_FROM_CB_LAMBDA_ADJUSTMENT
@@ -583,6 +631,9 @@ Void InvNsst8x8( Int* src, UInt uiMode, UChar index );
   Bool derive1DimKLT_Fast(UInt uiBlkSize, UInt uiUseCandiNumber);
   Bool derive1DimKLT(UInt uiBlkSize, UInt uiUseCandiNumber);
   Bool derive2DimKLT(UInt uiBlkSize, DistType *pDiff);
+#if KLT_PREALLOCATED_EIGEN_SOLVER
+  Void xDeriveEigenVectors(const covMatrixType *pCovMatrix, UInt uiDim, EigenType **pdEigenVector);
+#endif
   Pel  **getTargetPatch(UInt uiDepth) { return m_pppTarPatch[uiDepth]; }
   Pel* getRefPicUsed(UInt uiId) { return m_refPicUsed[uiId]; }
   Void setRefPicUsed(UInt uiId, Pel *ref) { m_refPicUsed[uiId] = ref; }
@@ -610,6 +661,11 @@ Void InvNsst8x8( Int* src, UInt uiMode, UChar index );
   DistType calcPatchDiff(Pel *ref, UInt uiStride, Pel **tarPatch, UInt uiPatchSize, UInt uiTempSize, DistType iMax);
   Void xSetSearchRange(TComDataCU* pcCU, TComMv& cMvPred, Int iSrchRng, TComMv& rcMvSrchRngLT, TComMv& rcMvSrchRngRB);
 #endif
+#if KLT_FAST_CANDIDATE_SEARCH && VCEG_AZ08_USE_SAD_DISTANCE
+  Void xInitSumSegments(Pel **tarPatch, UInt uiBlkSize, UInt uiTempSize, Bool bTemplateOnly);
+  Void xBuildSumTable(const Pel *piWindow, Int iStride, Int iWidth, Int iHeight);
+  DistType xGetSumLowerBound(Int iX, Int iY) const;
+#endif
 
 protected:
 #if ADAPTIVE_QP_SELECTION
@@ -618,6 +674,18 @@ protected:
   Double  m_sliceSumC[LEVEL_RANGE+1] ;
 #endif
   TCoeff* m_plTempCoeff;
+#if RDOQ_BLOCK_QUANT
+  Intermediate_Int* m_plRdoqLevelDouble;    ///< RDOQ: unscaled quantised levels of the TU, raster order
+  UInt*             m_puiRdoqMaxAbsLevel;   ///< RDOQ: rounded quantised levels of the TU, raster order
+  Double*           m_pdRdoqUncodedCost;    ///< RDOQ: distortion of each coefficient quantised to zero, raster order
+  Double*           m_pdRdoqCostCoeff;      ///< RDOQ: scan order cost buffers, see xRateDistOptQuant()
+  Double*           m_pdRdoqCostSig;
+  Double*           m_pdRdoqCostCoeff0;
+  Int*              m_piRdoqRateIncUp;      ///< RDOQ: raster order rate buffers for sign data hiding
+  Int*              m_piRdoqRateIncDown;
+  Int*              m_piRdoqSigRateDelta;
+  TCoeff*           m_piRdoqDeltaU;
+#endif
 
 //  QpParam  m_cQP; - removed - placed on the stack.
 #if RDOQ_CHROMA_LAMBDA
@@ -629,6 +697,30 @@ protected:
   Bool     m_bEnc;
   Bool     m_useRDOQ;
   Bool     m_useRDOQTS;
+#if PRIMARY_TRANSFORM_CACHE
+  /// transform parameters and position of a TU whose primary transform is cached
+  struct PrimaryTransformKey
+  {
+    UInt uiCtuRsAddr;
+    UInt uiAbsPartIdx;
+    UInt uiCompID;
+    UInt uiWidth;
+    UInt uiHeight;
+    UInt uiBitDepth;
+    UInt uiMaxLog2TrDynamicRange;
+    UInt uiUseDST;
+    UInt uiEmtMode;
+    UInt uiEmtTrIdx;
+  };
+  struct PrimaryTransformCacheEntry
+  {
+    Bool                bValid;
+    PrimaryTransformKey cKey;
+    Pel                 aResidual[PRIMARY_TRANSFORM_CACHE_MAX_COEFF];
+    TCoeff              aCoeff   [PRIMARY_TRANSFORM_CACHE_MAX_COEFF];
+  };
+  PrimaryTransformCacheEntry* m_pcPrimaryTransformCache; ///< encoder only: primary transform results of recent TUs, indexed by a hash of their key
+#endif
 #if VCEG_AZ08_USE_KLT
   UInt     m_useKLT;
 #endif
@@ -660,11 +752,33 @@ protected:
   Pel *m_refPicUsed[MAX_NUM_REF_IDS];
   TComPic *m_refPicBuf[MAX_NUM_REF_IDS];
   UInt m_uiPicStride;
+#if KLT_ON_DEMAND_SUBPEL_PLANES
+  UChar m_aucRefQuaPos[MAX_NUM_REF_IDS];                       ///< fractional position ( 4 * row + col ) of the quarter pixel picture of each reference id, 0 for the reconstruction
+  Int   m_iKltBlkPosX;                                         ///< position of the block searched by the inter KLT, in the reference pictures
+  Int   m_iKltBlkPosY;
+  Pel   m_acQuaArea[KLT_SUBPEL_AREA_SIZE * KLT_SUBPEL_AREA_SIZE]; ///< copy of an area of a quarter pixel picture spanning several tiles
+#endif
   TrainDataType *m_pData[MAX_CANDI_NUM];
 #if VCEG_AZ08_USE_TRANSPOSE_CANDDIATEARRAY
   TrainDataType *m_pDataT[MAX_1DTRANS_LEN];
 #endif
   UInt m_uiVaildCandiNum;
+#if KLT_FAST_CANDIDATE_SEARCH && VCEG_AZ08_USE_SAD_DISTANCE
+  /// rectangle of a template or patch whose sample sum bounds the SAD of the candidates from below
+  struct SumSegment
+  {
+    Int iX;
+    Int iY;
+    Int iWidth;
+    Int iHeight;
+    Int iTargetSum;
+  };
+  SumSegment m_aSumSegments[(KLT_SUM_CELLS_PER_BLOCK + 1)*(KLT_SUM_CELLS_PER_BLOCK + 1)];
+  Int  m_iNumSumSegments;
+  Int *m_piSumTable;        ///< prefix sums of the samples of the current search window, one row and column larger than the window
+  Int  m_iSumTableStride;
+  Int  m_iSumTableSize;
+#endif
   Double m_pEigenValues[MAX_1DTRANS_LEN];
   Int m_pIDTmp[MAX_1DTRANS_LEN];
   EigenType ***m_pppdEigenVector;
@@ -674,6 +788,9 @@ protected:
 #if VCEG_AZ08_FAST_DERIVE_KLT
   EigenType **m_pppdTmpEigenVector;
 #endif
+#if KLT_PREALLOCATED_EIGEN_SOLVER
+  KLTEigenSolver *m_apcKLTEigenSolver[KLT_EIGEN_SOLVER_MAX_DIM + 1];  ///< matrix and eigen decomposition of the KLT derivation, per dimension
+#endif
 #endif
 
 private:
@@ -691,6 +808,12 @@ private:
   // skipping Transform
   Void xTransformSkip ( Pel* piBlkResi, UInt uiStride, TCoeff* psCoeff, TComTU &rTu, const ComponentID component );
 
+#if PRIMARY_TRANSFORM_CACHE
+  PrimaryTransformCacheEntry& xGetPrimaryTransformCacheEntry( const PrimaryTransformKey &rcKey );
+  Bool xLoadPrimaryTransform  ( const PrimaryTransformKey &rcKey, const Pel* piBlkResi, UInt uiStride, TCoeff* psCoeff );
+  Void xStorePrimaryTransform ( const PrimaryTransformKey &rcKey, const Pel* piBlkResi, UInt uiStride, const TCoeff* psCoeff );
+#endif
+
   Void signBitHidingHDQ( TCoeff* pQCoef, TCoeff* pCoef, TCoeff* deltaU, const TUEntropyCodingParameters &codingParameters, const Int maxLog2TrDynamicRange );
 
   // quantization
@@ -371,7 +371,99 @@
 
 #define O0043_BEST_EFFORT_DECODING                        0 ///< 0 (default) = disable code related to best effort decoding, 1 = enable code relating to best effort decoding [ decode-side only ].
 
+#define PARALLEL_SUBSTREAM_DECODING                       1 ///< decoder only: decode the substreams (tiles, wavefront rows) of a slice on several threads (see SubstreamThreads decoder option)
+#define PARALLEL_FRAME_DECODING                           1 ///< decoder only: loop-filter a picture on a separate thread while the next picture is decoded (see FramePipelining decoder option)
+#define PARALLEL_SUBSTREAM_ENCODING                       1 ///< encoder only: compress the substreams (wavefront rows, tiles) of a slice on several threads (see SubstreamThreads encoder option)
+#define PARALLEL_SEGMENT_ENCODING                         1 ///< encoder only: encode the intra-period segments of a sequence on several threads and stitch them into one bitstream, as JVET-B0036 does with separate processes (see SegmentThreads encoder option)
+#define PARALLEL_PICTURE_ENCODING                         1 ///< encoder only: compress the pictures of a GOP on several threads as soon as their reference pictures are final, entropy coding them in coding order (see PictureThreads encoder option)
+#if PARALLEL_SEGMENT_ENCODING && !PARALLEL_SUBSTREAM_ENCODING
+#error PARALLEL_SEGMENT_ENCODING shall be off if PARALLEL_SUBSTREAM_ENCODING is off
+#endif
+#if PARALLEL_PICTURE_ENCODING && !PARALLEL_SEGMENT_ENCODING
+#error PARALLEL_PICTURE_ENCODING shall be off if PARALLEL_SEGMENT_ENCODING is off
+#endif
+
+#define SIMD_RUNTIME_DISPATCH                             1 ///< select the SIMD kernels once at start-up from the instruction sets the CPU supports, optionally capped by the SIMD option, instead of at compile time only
+#define SIMD_AVX2_INTERPOLATION                           1 ///< AVX2/AVX-512 kernels for the interpolation filters of all tap lengths, bit-exact with the C code for 8-12 bit samples
+#define SIMD_AVX2_HADAMARD                                1 ///< AVX2 Hadamard (SATD) kernels for all the tile shapes QTBT blocks are split into, also used for the mean-removed SATD of LIC
+#define SIMD_AVX2_MR_SAD                                  1 ///< AVX2 kernels for the mean-removed SAD of LIC, for all block widths that are a multiple of 4
+#define SIMD_AVX2_TRANSFORM                               1 ///< AVX2 kernels for the DCT2/DCT5/DCT8/DST1/DST7 transforms of 4 to 128 points, bit-exact with the C code
+#define SIMD_AVX2_NSST                                    1 ///< AVX2 kernels for the HyGT rounds of the 4x4 and 8x8 NSST, bit-exact with the C code
+#define SIMD_AVX2_RDOQ                                    1 ///< AVX2 kernel for the block quantisation pass of RDOQ (see RDOQ_BLOCK_QUANT), bit-exact with the C code
+#define SIMD_AVX2_KLT_SAD                                 1 ///< AVX2 kernels for the template and patch SAD of the KLT candidate search, for 4x4 to 32x32 blocks with templates of up to 4 samples
+#define SIMD_SSE2_KLT_SAD                                 1 ///< SSE2 kernel for the template and patch SAD of the KLT candidate search, used when AVX2 is not available
+#define SIMD_AVX2_KLT_DERIVE                              1 ///< AVX2 kernels for the covariance matrices and the basis projection of the KLT derivation, bit-exact with the C code
+#define SIMD_AVX2_ALF                                     1 ///< AVX2 kernel for the 5x5/7x7/9x9 diamond filters of the GALF luma and chroma filtering, bit-exact with the C code for up to 14-bit samples
+#define SIMD_AVX2_BIO                                     1 ///< AVX2 kernels for the six-tap BIO gradient and interpolation filters, and a fused BIO kernel that computes the sample products, the 5x5 window sums, the flow and the average of a block row by row, bit-exact with the C code
+#define SIMD_AVX2_OBMC                                    1 ///< AVX2 kernel for the OBMC blending of the rows and columns along a sub-block boundary, bit-exact with the C code
+#if SIMD_RUNTIME_DISPATCH && !COM16_C806_SIMD_OPT
+#error SIMD_RUNTIME_DISPATCH shall be off if COM16_C806_SIMD_OPT is off
+#endif
+#if ( SIMD_AVX2_INTERPOLATION || SIMD_AVX2_HADAMARD || SIMD_AVX2_MR_SAD || SIMD_AVX2_TRANSFORM || SIMD_AVX2_NSST || SIMD_AVX2_RDOQ || SIMD_AVX2_KLT_SAD || SIMD_AVX2_KLT_DERIVE || SIMD_AVX2_ALF || SIMD_AVX2_BIO || SIMD_AVX2_OBMC ) && !SIMD_RUNTIME_DISPATCH
+#error The SIMD_AVX2_* kernels shall be off if SIMD_RUNTIME_DISPATCH is off
+#endif
+#if SIMD_SSE2_KLT_SAD && !SIMD_RUNTIME_DISPATCH
+#error SIMD_SSE2_KLT_SAD shall be off if SIMD_RUNTIME_DISPATCH is off
+#endif
+
 #define RDOQ_CHROMA_LAMBDA                                1 ///< F386: weighting of chroma for RDOQ
+#define RDOQ_BLOCK_QUANT                                  1 ///< RDOQ quantises the whole TU in one pass before the level decisions, into buffers allocated once, and stops early when all levels are zero
+#if RDOQ_BLOCK_QUANT && JVET_C0024_QTBT && !JVET_C0024_QTBT_FIX_QUANT_TICKET25
+#error RDOQ_BLOCK_QUANT shall be off if JVET_C0024_QTBT_FIX_QUANT_TICKET25 is off
+#endif
+#if SIMD_AVX2_RDOQ && !RDOQ_BLOCK_QUANT
+#error SIMD_AVX2_RDOQ shall be off if RDOQ_BLOCK_QUANT is off
+#endif
+#if SIMD_AVX2_BIO && !VCEG_AZ05_BIO
+#error SIMD_AVX2_BIO shall be off if VCEG_AZ05_BIO is off
+#endif
+#if SIMD_AVX2_OBMC && !COM16_C806_OBMC
+#error SIMD_AVX2_OBMC shall be off if COM16_C806_OBMC is off
+#endif
+#define PRIMARY_TRANSFORM_CACHE                           1 ///< encoder only: reuse the primary transform coefficients of a TU when the same residual is transformed again with the same transform, as in the NSST, PDPC and EMT CU flag passes of the intra search
+#define KLT_FAST_CANDIDATE_SEARCH                         1 ///< the KLT candidate search skips the positions whose template distance, bounded below from sample sums of the search window, cannot enter the k-best list, and keeps that list in a bounded max-heap
+#if KLT_FAST_CANDIDATE_SEARCH && !VCEG_AZ08_KLT_COMMON
+#error KLT_FAST_CANDIDATE_SEARCH shall be off if VCEG_AZ08_KLT_COMMON is off
+#endif
+#define KLT_PREALLOCATED_EIGEN_SOLVER                     1 ///< the eigen decomposition of the KLT derivation reuses a matrix and solver allocated once per dimension, instead of allocating them on every call
+#if KLT_PREALLOCATED_EIGEN_SOLVER && !( VCEG_AZ08_KLT_COMMON && VCEG_AZ08_FAST_DERIVE_KLT )
+#error KLT_PREALLOCATED_EIGEN_SOLVER shall be off if VCEG_AZ08_FAST_DERIVE_KLT is off
+#endif
+#define KLT_ON_DEMAND_SUBPEL_PLANES                       1 ///< the quarter-sample luma planes of a reference picture searched by the inter KLT are stored by tiles, allocated and interpolated when first accessed and released when the picture is no longer referenced, instead of being interpolated in full for every picture
+#if KLT_ON_DEMAND_SUBPEL_PLANES && !VCEG_AZ08_INTER_KLT
+#error KLT_ON_DEMAND_SUBPEL_PLANES shall be off if VCEG_AZ08_INTER_KLT is off
+#endif
+#define PARALLEL_ALF                                      1 ///< the GALF luma filtering, classification included, and the chroma filtering run on rows of filter windows or CTUs spread over several threads (see ALFThreads decoder and encoder option)
+#if PARALLEL_ALF && !( ALF_HM3_REFACTOR && JVET_C0038_GALF && JVET_C0024_QTBT )
+#error PARALLEL_ALF shall be off if JVET_C0038_GALF or JVET_C0024_QTBT is off
+#endif
+#if SIMD_AVX2_ALF && !( ALF_HM3_REFACTOR && JVET_C0038_GALF )
+#error SIMD_AVX2_ALF shall be off if JVET_C0038_GALF is off
+#endif
+#define ALF_INCREMENTAL_STATS                             1 ///< encoder only: the GALF luma statistics are accumulated once per picture in integer form and only updated with the samples whose CU on/off flag changed, the 7x7 and 5x5 statistics are sliced from the 9x9 ones
+#if ALF_INCREMENTAL_STATS && !( ALF_HM3_REFACTOR && JVET_C0038_GALF )
+#error ALF_INCREMENTAL_STATS shall be off if JVET_C0038_GALF is off
+#endif
+#define FRUC_INTERP_WINDOW_CACHE                          1 ///< the FRUC template and bilateral matching costs read the interpolated luma samples from windows kept per reference picture and fractional phase while the Mv of a PU is derived, each window is interpolated once
+#if FRUC_INTERP_WINDOW_CACHE && !VCEG_AZ07_FRUC_MERGE
+#error FRUC_INTERP_WINDOW_CACHE shall be off if VCEG_AZ07_FRUC_MERGE is off
+#endif
+#define FRUC_FLAT_START_MV_LIST                           1 ///< the FRUC start Mv candidates are kept in insertion order in an array allocated once, duplicates are found through a hash table
+#if FRUC_FLAT_START_MV_LIST && !VCEG_AZ07_FRUC_MERGE
+#error FRUC_FLAT_START_MV_LIST shall be off if VCEG_AZ07_FRUC_MERGE is off
+#endif
+#define OBMC_RUN_PREDICTION                               1 ///< the OBMC predictions with a neighbouring motion are made once for each run of adjacent sub-block boundaries of a row or column that share it, instead of once per sub-block
+#if OBMC_RUN_PREDICTION && !( COM16_C806_OBMC && JVET_C0024_QTBT )
+#error OBMC_RUN_PREDICTION shall be off if COM16_C806_OBMC or JVET_C0024_QTBT is off
+#endif
+#define AFFINE_BATCHED_MC                                 1 ///< the affine MC derives the Mv of all sub-blocks first and filters each rectangle of adjacent sub-blocks sharing an Mv, hence an integer and fractional position, with one interpolation call
+#if AFFINE_BATCHED_MC && !( COM16_C1016_AFFINE && JVET_C0025_AFFINE_FILTER_SIMPLIFICATION )
+#error AFFINE_BATCHED_MC shall be off if COM16_C1016_AFFINE or JVET_C0025_AFFINE_FILTER_SIMPLIFICATION is off
+#endif
+#define AFFINE_FAST_GRADIENT_ME                           1 ///< encoder only: the affine motion estimation computes the Sobel gradients of the prediction in integers in one pass, accumulates one half of the symmetric normal equations, and stops when an iteration comes back to control point Mvs it has evaluated
+#if AFFINE_FAST_GRADIENT_ME && !COM16_C1016_AFFINE
+#error AFFINE_FAST_GRADIENT_ME shall be off if COM16_C1016_AFFINE is off
+#endif
 
 // This can be enabled by the makefile
 #ifndef RExt__HIGH_BIT_DEPTH_SUPPORT
@@ -892,6 +984,16 @@ enum CostMode
   COST_MIXED_LOSSLESS_LOSSY_CODING = 3
 };
 
+/// widest instruction set the SIMD kernels may use, each level includes the previous ones
+enum SimdLevel
+{
+  SIMD_NONE   = 0,  ///< C code only
+  SIMD_SSE2   = 1,
+  SIMD_AVX2   = 2,
+  SIMD_AVX512 = 3,  ///< AVX-512F and AVX-512BW
+  SIMD_AUTO   = -1  ///< widest level supported by the CPU
+};
+
 enum SPSExtensionFlagIndex
 {
   SPS_EXT__REXT           = 0,
@@ -303,8 +303,8 @@ Void TDecCu::decodeCtu( TComDataCU* pCtu, Bool& isLastCtuOfSliceSegment )
   // start from the top level CU
 #if JVET_C0024_QTBT
   UInt uiCTUSize = pCtu->getSlice()->getSPS()->getCTUSize();
-  pCtu->getPic()->setCodedAreaInCTU(0);
-  pCtu->getPic()->setCodedBlkInCTU(false, 0, 0, uiCTUSize>>MIN_CU_LOG2, uiCTUSize>>MIN_CU_LOG2);  //only used for affine merge code or not
+  pCtu->getPic()->setCodedAreaInCTU(pCtu->getCtuRsAddr(), 0);
+  pCtu->getPic()->setCodedBlkInCTU(pCtu->getCtuRsAddr(), false, 0, 0, uiCTUSize>>MIN_CU_LOG2, uiCTUSize>>MIN_CU_LOG2);  //only used for affine merge code or not
 
   xDecodeCU( pCtu, 0, 0, uiCTUSize, uiCTUSize, isLastCtuOfSliceSegment);
 #else
@@ -314,7 +314,7 @@ Void TDecCu::decodeCtu( TComDataCU* pCtu, Bool& isLastCtuOfSliceSegment )
   if (pCtu->getSlice()->isIntra())
   {
     pCtu->getSlice()->setTextType(CHANNEL_TYPE_CHROMA);
-    pCtu->getPic()->setCodedAreaInCTU(0);
+    pCtu->getPic()->setCodedAreaInCTU(pCtu->getCtuRsAddr(), 0);
 #if JVET_C0024_DELTA_QP_FIX
     if ( pCtu->getSlice()->getPPS()->getUseDQP() )
     {
@@ -343,15 +343,15 @@ Void TDecCu::decompressCtu( TComDataCU* pCtu )
 #if JVET_C0024_QTBT
   pCtu->getSlice()->setTextType(CHANNEL_TYPE_LUMA);
   UInt uiCTUSize = pCtu->getSlice()->getSPS()->getCTUSize();
-  pCtu->getPic()->setCodedBlkInCTU(false, 0, 0, uiCTUSize>>MIN_CU_LOG2, uiCTUSize>>MIN_CU_LOG2);
-  pCtu->getPic()->setCodedAreaInCTU(0);
+  pCtu->getPic()->setCodedBlkInCTU(pCtu->getCtuRsAddr(), false, 0, 0, uiCTUSize>>MIN_CU_LOG2, uiCTUSize>>MIN_CU_LOG2);
+  pCtu->getPic()->setCodedAreaInCTU(pCtu->getCtuRsAddr(), 0);
   xDecompressCU( pCtu, 0,  0, uiCTUSize, uiCTUSize ); 
 
   if (pCtu->getSlice()->isIntra())
   {
     pCtu->getSlice()->setTextType(CHANNEL_TYPE_CHROMA);
-    pCtu->getPic()->setCodedBlkInCTU(false, 0, 0, uiCTUSize>>MIN_CU_LOG2, uiCTUSize>>MIN_CU_LOG2);
-    pCtu->getPic()->setCodedAreaInCTU(0);
+    pCtu->getPic()->setCodedBlkInCTU(pCtu->getCtuRsAddr(), false, 0, 0, uiCTUSize>>MIN_CU_LOG2, uiCTUSize>>MIN_CU_LOG2);
+    pCtu->getPic()->setCodedAreaInCTU(pCtu->getCtuRsAddr(), 0);
     xDecompressCU( pCtu, 0,  0, uiCTUSize, uiCTUSize );
   }
 #else
@@ -512,7 +512,7 @@ Void TDecCu::xDecodeCU( TComDataCU*const pcCU, const UInt uiAbsPartIdx, const UI
       {
         pcCU->setOutsideCUPart( uiIdx, uiDepth+1 );
 #if JVET_C0024_QTBT
-        pcCU->getPic()->addCodedAreaInCTU(uiWidth*uiHeight>>2);
+        pcCU->getPic()->addCodedAreaInCTU(pcCU->getCtuRsAddr(), uiWidth*uiHeight>>2);
 #endif
       }
 
@@ -667,9 +667,9 @@ Void TDecCu::xDecodeCU( TComDataCU*const pcCU, const UInt uiAbsPartIdx, const UI
   pcCU->setSizeSubParts( uiWidth, uiHeight, uiAbsPartIdx, uiDepth );
   UInt uiBlkX = g_auiRasterToPelX[ g_auiZscanToRaster[uiAbsPartIdx] ] >> MIN_CU_LOG2;
   UInt uiBlkY = g_auiRasterToPelY[ g_auiZscanToRaster[uiAbsPartIdx] ] >> MIN_CU_LOG2;
-  pcCU->getPic()->setCodedBlkInCTU(true, uiBlkX, uiBlkY, uiWidth>> MIN_CU_LOG2, uiHeight>> MIN_CU_LOG2);
+  pcCU->getPic()->setCodedBlkInCTU(pcCU->getCtuRsAddr(), true, uiBlkX, uiBlkY, uiWidth>> MIN_CU_LOG2, uiHeight>> MIN_CU_LOG2);
 
-  pcCU->getPic()->addCodedAreaInCTU(uiWidth*uiHeight);
+  pcCU->getPic()->addCodedAreaInCTU(pcCU->getCtuRsAddr(), uiWidth*uiHeight);
 
   UInt uiWidthIdx = g_aucConvertToBit[uiWidth];
   UInt uiHeightIdx = g_aucConvertToBit[uiHeight];
@@ -1045,7 +1045,7 @@ Void TDecCu::xDecompressCU( TComDataCU* pCtu, UInt uiAbsPartIdx,  UInt uiDepth )
 #if JVET_C0024_QTBT
       else
       {
-        pCtu->getPic()->addCodedAreaInCTU(uiWidth*uiHeight>>2);
+        pCtu->getPic()->addCodedAreaInCTU(pCtu->getCtuRsAddr(), uiWidth*uiHeight>>2);
       }
 #endif
 
@@ -1149,8 +1149,8 @@ Void TDecCu::xDecompressCU( TComDataCU* pCtu, UInt uiAbsPartIdx,  UInt uiDepth )
 
   UInt uiBlkX = g_auiRasterToPelX[ g_auiZscanToRaster[uiAbsPartIdx] ] >> MIN_CU_LOG2;
   UInt uiBlkY = g_auiRasterToPelY[ g_auiZscanToRaster[uiAbsPartIdx] ] >> MIN_CU_LOG2;
-  pCtu->getPic()->setCodedBlkInCTU(true, uiBlkX, uiBlkY, uiWidth>> MIN_CU_LOG2, uiHeight>> MIN_CU_LOG2);
-  pCtu->getPic()->addCodedAreaInCTU(uiWidth*uiHeight);
+  pCtu->getPic()->setCodedBlkInCTU(pCtu->getCtuRsAddr(), true, uiBlkX, uiBlkY, uiWidth>> MIN_CU_LOG2, uiHeight>> MIN_CU_LOG2);
+  pCtu->getPic()->addCodedAreaInCTU(pCtu->getCtuRsAddr(), uiWidth*uiHeight);
 
 #else
   if ( m_ppcCU[uiDepth]->isLosslessCoded(0) && (m_ppcCU[uiDepth]->getIPCMFlag(0) == false))
@@ -56,6 +56,12 @@ TDecGop::TDecGop()
  : m_numberOfChecksumErrorsDetected(0)
 {
   m_dDecTime = 0;
+#if PARALLEL_FRAME_DECODING
+  m_dFilterDecTime = 0;
+#if ALF_HM3_REFACTOR
+  m_pcFilterAdaptiveLoopFilter = NULL;
+#endif
+#endif
 }
 
 TDecGop::~TDecGop()
@@ -71,6 +77,9 @@ Void TDecGop::create()
 
 Void TDecGop::destroy()
 {
+#if PARALLEL_FRAME_DECODING
+  finishFilterPicture();
+#endif
 #if COM16_C806_ALF_TEMPPRED_NUM
   for( Int i = 0; i < COM16_C806_ALF_TEMPPRED_NUM; i++ )
   {
@@ -210,6 +219,91 @@ Void TDecGop::decompressSlice(TComInputBitstream* pcBitstream, TComPic* pcPic
 }
 
 Void TDecGop::filterPicture(TComPic* pcPic)
+{
+  xFilterPicture(pcPic, pcPic->getSlice(pcPic->getCurrSliceIdx())->isReferenced()
+#if ALF_HM3_REFACTOR
+    , m_pcAdaptiveLoopFilter, m_cAlfParam
+#endif
+    , m_dDecTime);
+
+  pcPic->setOutputMark(pcPic->getSlice(0)->getPicOutputFlag() ? true : false);
+  pcPic->setReconMark(true);
+}
+
+#if PARALLEL_FRAME_DECODING
+/** Filters pcPic on a separate thread, so that the next picture can be decoded in the meantime.
+ *  Pictures are filtered one at a time and in decoding order, as the temporal ALF parameter prediction requires.
+ *  The picture stays pending until the thread has finished: a picture referencing it blocks in TComSlice::setRefPicList().
+ *  There is no per-row progress, so only the loop filtering of one picture overlaps with the decoding of the next one.
+ */
+Void TDecGop::startFilterPicture(TComPic* pcPic)
+{
+  finishFilterPicture();
+
+#if ALF_HM3_REFACTOR
+  // hand a copy of the parsed ALF parameters over to the thread, the next picture allocates its own ones in decompressSlice()
+  if( pcPic->getSlice(0)->getSPS()->getUseALF() )
+  {
+    m_pcAdaptiveLoopFilter->allocALFParam( &m_cFilterAlfParam );
+    m_pcAdaptiveLoopFilter->copyALFParam( &m_cFilterAlfParam, &m_cAlfParam );
+    m_cFilterAlfParam.alf_max_depth    = m_cAlfParam.alf_max_depth;
+    m_cFilterAlfParam.maxScanVal       = m_cAlfParam.maxScanVal;
+#if COM16_C806_ALF_TEMPPRED_NUM
+    m_cFilterAlfParam.temproalPredFlag = m_cAlfParam.temproalPredFlag;
+    m_cFilterAlfParam.prevIdx          = m_cAlfParam.prevIdx;
+#endif
+    m_pcAdaptiveLoopFilter->freeALFParam( &m_cAlfParam );
+  }
+#endif
+  m_dFilterDecTime  = m_dDecTime;
+  m_dDecTime        = 0;
+
+  pcPic->setOutputMark(pcPic->getSlice(0)->getPicOutputFlag() ? true : false);
+  pcPic->setReconMark(true);
+  pcPic->setLoopFilterPending(true);
+  m_cFilterThread = std::thread(&TDecGop::xFilterPictureThread, this, pcPic, pcPic->getSlice(pcPic->getCurrSliceIdx())->isReferenced());
+}
+
+/** Waits until the picture passed to startFilterPicture() is filtered.
+ */
+Void TDecGop::finishFilterPicture()
+{
+  if (m_cFilterThread.joinable())
+  {
+    m_cFilterThread.join();
+  }
+}
+
+Void TDecGop::xFilterPictureThread(TComPic* pcPic, Bool bReferenced)
+{
+#if JVET_D0033_ADAPTIVE_CLIPPING
+  g_ClipParam = pcPic->m_aclip_prm;
+#endif
+  xFilterPicture(pcPic, bReferenced
+#if ALF_HM3_REFACTOR
+    , m_pcFilterAdaptiveLoopFilter, m_cFilterAlfParam
+#endif
+    , m_dFilterDecTime);
+#if ALF_HM3_REFACTOR
+  if( pcPic->getSlice(0)->getSPS()->getUseALF() )
+  {
+    // the filtered samples are in the former ALF buffer, whose margin was only extended for the ALF: extend it again when referenced.
+    // The serial path clears the flag when the ALF is created again for the next picture, the loop filter thread uses its own ALF.
+    pcPic->getPicYuvRec()->setBorderExtension( false );
+  }
+#endif
+  pcPic->setLoopFilterPending(false);
+}
+#endif
+
+/** Deblocking, SAO and ALF of a decoded picture, followed by the motion compression and the picture status line.
+ *  \param bReferenced whether the picture was marked as used for reference when its decoding finished (printed as upper-case slice type)
+ */
+Void TDecGop::xFilterPicture(TComPic* pcPic, Bool bReferenced
+#if ALF_HM3_REFACTOR
+                            , TComAdaptiveLoopFilter* pcAdaptiveLoopFilter, ALFParam &alfParam
+#endif
+                            , Double &decTime)
 {
   TComSlice*  pcSlice = pcPic->getSlice(pcPic->getCurrSliceIdx());
 
@@ -232,33 +326,34 @@ Void TDecGop::filterPicture(TComPic* pcPic)
   // adaptive loop filter
   if( pcSlice->getSPS()->getUseALF() )
   {
+    pcAdaptiveLoopFilter->setNumCUsInFrame(pcPic);
 #if COM16_C806_ALF_TEMPPRED_NUM
 #if FIX_TICKET12
-    if( m_pcAdaptiveLoopFilter->refreshAlfTempPred( pcSlice->getNalUnitType() , pcSlice->getPOC() ) )
+    if( pcAdaptiveLoopFilter->refreshAlfTempPred( pcSlice->getNalUnitType() , pcSlice->getPOC() ) )
     {
       m_iStoredAlfParaNum = 0;
-      assert( m_cAlfParam.temproalPredFlag == false );
+      assert( alfParam.temproalPredFlag == false );
     }
 #endif
-    if( m_cAlfParam.temproalPredFlag )
+    if( alfParam.temproalPredFlag )
     {
-      m_pcAdaptiveLoopFilter->copyALFParam( &m_cAlfParam, &m_acStoredAlfPara[m_cAlfParam.prevIdx] );
+      pcAdaptiveLoopFilter->copyALFParam( &alfParam, &m_acStoredAlfPara[alfParam.prevIdx] );
     }
 #endif
-    m_pcAdaptiveLoopFilter->ALFProcess(pcPic, &m_cAlfParam);
+    pcAdaptiveLoopFilter->ALFProcess(pcPic, &alfParam);
 #if COM16_C806_ALF_TEMPPRED_NUM
-    if( m_cAlfParam.alf_flag && !m_cAlfParam.temproalPredFlag && m_cAlfParam.filtNo >= 0 )
+    if( alfParam.alf_flag && !alfParam.temproalPredFlag && alfParam.filtNo >= 0 )
     {
       Int iIdx = m_iStoredAlfParaNum % COM16_C806_ALF_TEMPPRED_NUM;
       m_iStoredAlfParaNum++;
       m_acStoredAlfPara[iIdx].temproalPredFlag = false;
-      m_pcAdaptiveLoopFilter->copyALFParam( &m_acStoredAlfPara[iIdx], &m_cAlfParam );
+      pcAdaptiveLoopFilter->copyALFParam( &m_acStoredAlfPara[iIdx], &alfParam );
 #if JVET_C0038_GALF
-      m_pcAdaptiveLoopFilter->resetALFPredParam(&m_acStoredAlfPara[iIdx], (pcSlice->getSliceType()== I_SLICE? true: false));
+      pcAdaptiveLoopFilter->resetALFPredParam(&m_acStoredAlfPara[iIdx], (pcSlice->getSliceType()== I_SLICE? true: false));
 #endif
     }
 #endif
-    m_pcAdaptiveLoopFilter->freeALFParam(&m_cAlfParam);
+    pcAdaptiveLoopFilter->freeALFParam(&alfParam);
   }
 #endif
 
@@ -271,7 +366,7 @@ Void TDecGop::filterPicture(TComPic* pcPic)
   pcPic->compressMotion();
 #endif
   Char c = (pcSlice->isIntra() ? 'I' : pcSlice->isInterP() ? 'P' : 'B');
-  if (!pcSlice->isReferenced())
+  if (!bReferenced)
   {
     c += 32;
   }
@@ -282,9 +377,9 @@ Void TDecGop::filterPicture(TComPic* pcPic)
                                                   c,
                                                   pcSlice->getSliceQp() );
 
-  m_dDecTime += (Double)(clock()-iBeforeTime) / CLOCKS_PER_SEC;
-  printf ("[DT %6.3f] ", m_dDecTime );
-  m_dDecTime  = 0;
+  decTime += (Double)(clock()-iBeforeTime) / CLOCKS_PER_SEC;
+  printf ("[DT %6.3f] ", decTime );
+  decTime  = 0;
 
   for (Int iRefList = 0; iRefList < 2; iRefList++)
   {
@@ -308,8 +403,6 @@ Void TDecGop::filterPicture(TComPic* pcPic)
 
   printf("\n");
 
-  pcPic->setOutputMark(pcPic->getSlice(0)->getPicOutputFlag() ? true : false);
-  pcPic->setReconMark(true);
 #if VCEG_AZ08_INTER_KLT
 #if VCEG_AZ08_USE_KLT
   if (pcSlice->getSPS()->getUseInterKLT())
@@ -57,6 +57,9 @@
 #include "TDecSlice.h"
 #include "TDecBinCoder.h"
 #include "TDecBinCoderCABAC.h"
+#if PARALLEL_FRAME_DECODING
+#include <thread>
+#endif
 
 //! \ingroup TLibDecoder
 //! \{
@@ -92,6 +95,14 @@ private:
   static Int           m_iStoredAlfParaNum;
   ALFParam             m_acStoredAlfPara[COM16_C806_ALF_TEMPPRED_NUM];
 #endif
+#if PARALLEL_FRAME_DECODING
+  std::thread           m_cFilterThread;              ///< loop filter thread of the picture passed to startFilterPicture()
+#if ALF_HM3_REFACTOR
+  TComAdaptiveLoopFilter*       m_pcFilterAdaptiveLoopFilter; ///< ALF run on m_cFilterThread, separate from the one setting up the parameters of the picture being decoded
+  ALFParam              m_cFilterAlfParam;            ///< ALF parameters of the picture being filtered on m_cFilterThread
+#endif
+  Double                m_dFilterDecTime;             ///< decoding time of the picture being filtered on m_cFilterThread
+#endif
 
 public:
   TDecGop();
@@ -116,10 +127,26 @@ public:
 #endif
     );
   Void  filterPicture  (TComPic* pcPic );
+#if PARALLEL_FRAME_DECODING
+  Void  startFilterPicture ( TComPic* pcPic );
+  Void  finishFilterPicture();
+#if ALF_HM3_REFACTOR
+  Void  setFilterAdaptiveLoopFilter( TComAdaptiveLoopFilter* pcAdaptiveLoopFilter ) { m_pcFilterAdaptiveLoopFilter = pcAdaptiveLoopFilter; }
+#endif
+#endif
 
   Void setDecodedPictureHashSEIEnabled(Int enabled) { m_decodedPictureHashSEIEnabled = enabled; }
   UInt getNumberOfChecksumErrorsDetected() const { return m_numberOfChecksumErrorsDetected; }
 
+private:
+  Void  xFilterPicture ( TComPic* pcPic, Bool bReferenced
+#if ALF_HM3_REFACTOR
+                       , TComAdaptiveLoopFilter* pcAdaptiveLoopFilter, ALFParam &alfParam
+#endif
+                       , Double &decTime );
+#if PARALLEL_FRAME_DECODING
+  Void  xFilterPictureThread( TComPic* pcPic, Bool bReferenced );
+#endif
 };
 
 //! \}
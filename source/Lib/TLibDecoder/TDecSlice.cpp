@@ -36,6 +36,10 @@
 */
 
 #include "TDecSlice.h"
+#if PARALLEL_SUBSTREAM_DECODING
+#include <thread>
+#include <algorithm>
+#endif
 
 //! \ingroup TLibDecoder
 //! \{
@@ -45,6 +49,15 @@
 //////////////////////////////////////////////////////////////////////
 
 TDecSlice::TDecSlice()
+#if PARALLEL_SUBSTREAM_DECODING
+: m_numSubstreamThreads(1)
+, m_nextSubstreamIdx(0)
+, m_substreamOffset(0)
+, m_ctuDependencyRange(1)
+, m_crossTileDependencyRange(0)
+, m_substreamDecodersSpsId(-1)
+, m_warningMessageSerialSubstreams(false)
+#endif
 {
 }
 
@@ -58,6 +71,19 @@ Void TDecSlice::create()
 
 Void TDecSlice::destroy()
 {
+#if PARALLEL_SUBSTREAM_DECODING
+  destroySubstreamDecoders();
+  for (UInt i = 0; i < m_substreamDecoders.size(); i++)
+  {
+    delete m_substreamDecoders[i];
+  }
+  m_substreamDecoders.clear();
+  for (UInt i = 0; i < m_substreamSyncContextStates.size(); i++)
+  {
+    delete m_substreamSyncContextStates[i];
+  }
+  m_substreamSyncContextStates.clear();
+#endif
 }
 
 Void TDecSlice::init(TDecEntropy* pcEntropyDecoder, TDecCu* pcCuDecoder)
@@ -78,14 +104,9 @@ Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic* pcP
   const Int  startCtuRsAddr          = pcPic->getPicSym()->getCtuTsToRsAddrMap(startCtuTsAddr);
   const UInt numCtusInFrame          = pcPic->getNumberOfCtusInFrame();
 
-  const UInt frameWidthInCtus        = pcPic->getPicSym()->getFrameWidthInCtus();
   const Bool depSliceSegmentsEnabled = pcSlice->getPPS()->getDependentSliceSegmentsEnabledFlag();
   const Bool wavefrontsEnabled       = pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag();
 
-  m_pcEntropyDecoder->setEntropyDecoder ( pcSbacDecoder  );
-  m_pcEntropyDecoder->setBitstream      ( ppcSubstreams[0] );
-  m_pcEntropyDecoder->resetEntropy      (pcSlice);
-
   // decoder doesn't need prediction & residual frame buffer
   pcPic->setPicYuvPred( 0 );
   pcPic->setPicYuvResi( 0 );
@@ -104,6 +125,23 @@ Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic* pcP
 #if VCEG_AZ08_KLT_COMMON
   pcPic->getPicYuvRec()->fillPicRecBoundary(pcSlice->getSPS()->getBitDepths());
 #endif
+
+#if PARALLEL_SUBSTREAM_DECODING
+  if (xUseSubstreamThreads(pcPic, pcSlice))
+  {
+    xDecompressSubstreams( ppcSubstreams, pcPic
+#if ALF_HM3_REFACTOR
+      , alfParam
+#endif
+      );
+    return;
+  }
+#endif
+
+  m_pcEntropyDecoder->setEntropyDecoder ( pcSbacDecoder  );
+  m_pcEntropyDecoder->setBitstream      ( ppcSubstreams[0] );
+  m_pcEntropyDecoder->resetEntropy      (pcSlice);
+
   // The first CTU of the slice is the first coded substream, but the global substream number, as calculated by getSubstreamForCtuAddr may be higher.
   // This calculates the common offset for all substreams in this slice.
   const UInt subStreamOffset=pcPic->getSubstreamForCtuAddr(startCtuRsAddr, true, pcSlice);
@@ -131,168 +169,485 @@ Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic* pcP
   for( UInt ctuTsAddr = startCtuTsAddr; !isLastCtuOfSliceSegment && ctuTsAddr < numCtusInFrame; ctuTsAddr++)
   {
     const UInt ctuRsAddr = pcPic->getPicSym()->getCtuTsToRsAddrMap(ctuTsAddr);
-    const TComTile &currentTile = *(pcPic->getPicSym()->getTComTile(pcPic->getPicSym()->getTileIdxMap(ctuRsAddr)));
-    const UInt firstCtuRsAddrOfTile = currentTile.getFirstCtuRsAddr();
-    const UInt tileXPosInCtus = firstCtuRsAddrOfTile % frameWidthInCtus;
-    const UInt tileYPosInCtus = firstCtuRsAddrOfTile / frameWidthInCtus;
-    const UInt ctuXPosInCtus  = ctuRsAddr % frameWidthInCtus;
-    const UInt ctuYPosInCtus  = ctuRsAddr / frameWidthInCtus;
     const UInt uiSubStrm=pcPic->getSubstreamForCtuAddr(ctuRsAddr, true, pcSlice)-subStreamOffset;
-    TComDataCU* pCtu = pcPic->getCtu( ctuRsAddr );
-    pCtu->initCtu( pcPic, ctuRsAddr );
 
     m_pcEntropyDecoder->setBitstream( ppcSubstreams[uiSubStrm] );
 
+    xDecodeCtu( pcPic, ctuTsAddr, startCtuTsAddr, m_pcEntropyDecoder, pcSbacDecoder, m_pcCuDecoder,
+                &m_entropyCodingSyncContextState, &m_entropyCodingSyncContextState,
+#if ALF_HM3_REFACTOR
+                alfParam,
+#endif
+                isLastCtuOfSliceSegment );
+  }
+
+  assert(isLastCtuOfSliceSegment == true);
+
+
+  if( depSliceSegmentsEnabled )
+  {
+    m_lastSliceSegmentEndContextState.loadContexts( pcSbacDecoder );//ctx end of dep.slice
+  }
+
+}
+
+/** Parse and reconstruct one CTU of the current slice segment.
+ * \param resetCtuTsAddr address of the CTU at which the entropy decoder has been reset before the call
+ * \param pcSyncContextStateIn  contexts stored at the second CTU of the wavefront row above
+ * \param pcSyncContextStateOut storage for the contexts at the second CTU of the current wavefront row
+ */
+Void TDecSlice::xDecodeCtu( TComPic* pcPic, UInt ctuTsAddr, UInt resetCtuTsAddr, TDecEntropy* pcEntropyDecoder, TDecSbac* pcSbacDecoder, TDecCu* pcCuDecoder,
+                            TDecSbac* pcSyncContextStateIn, TDecSbac* pcSyncContextStateOut,
+#if ALF_HM3_REFACTOR
+                            ALFParam & alfParam,
+#endif
+                            Bool &isLastCtuOfSliceSegment )
+{
+  TComSlice* pcSlice                 = pcPic->getSlice(pcPic->getCurrSliceIdx());
+  const UInt frameWidthInCtus        = pcPic->getPicSym()->getFrameWidthInCtus();
+  const Bool wavefrontsEnabled       = pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag();
+
+  const UInt ctuRsAddr = pcPic->getPicSym()->getCtuTsToRsAddrMap(ctuTsAddr);
+  const TComTile &currentTile = *(pcPic->getPicSym()->getTComTile(pcPic->getPicSym()->getTileIdxMap(ctuRsAddr)));
+  const UInt firstCtuRsAddrOfTile = currentTile.getFirstCtuRsAddr();
+  const UInt tileXPosInCtus = firstCtuRsAddrOfTile % frameWidthInCtus;
+  const UInt tileYPosInCtus = firstCtuRsAddrOfTile / frameWidthInCtus;
+  const UInt ctuXPosInCtus  = ctuRsAddr % frameWidthInCtus;
+  const UInt ctuYPosInCtus  = ctuRsAddr / frameWidthInCtus;
+  TComDataCU* pCtu = pcPic->getCtu( ctuRsAddr );
+  pCtu->initCtu( pcPic, ctuRsAddr );
+
 #if VCEG_AZ07_INIT_PREVFRAME
-    if( pcSlice->getSliceType() != I_SLICE && ctuTsAddr == 0 )
-    {
-      pcSbacDecoder->loadContextsFromPrev( pcSlice->getStatsHandle(), pcSlice->getSliceType(), pcSlice->getCtxMapQPIdx(), true, pcSlice->getCtxMapQPIdxforStore(), (pcSlice->getPOC() > pcSlice->getStatsHandle()->m_uiLastIPOC)  ); 
-    }
+  if( pcSlice->getSliceType() != I_SLICE && ctuTsAddr == 0 )
+  {
+    pcSbacDecoder->loadContextsFromPrev( pcSlice->getStatsHandle(), pcSlice->getSliceType(), pcSlice->getCtxMapQPIdx(), true, pcSlice->getCtxMapQPIdxforStore(), (pcSlice->getPOC() > pcSlice->getStatsHandle()->m_uiLastIPOC)  ); 
+  }
 #endif
 
 #if ALF_HM3_REFACTOR
-    if ( pcSlice->getSPS()->getUseALF() && ctuRsAddr == 0 )
-    {
-      m_pcEntropyDecoder->decodeAlfParam(&alfParam, pcSlice->getSPS()->getMaxTotalCUDepth()
+  if ( pcSlice->getSPS()->getUseALF() && ctuRsAddr == 0 )
+  {
+    pcEntropyDecoder->decodeAlfParam(&alfParam, pcSlice->getSPS()->getMaxTotalCUDepth()
 #if FIX_TICKET12
-        , pcSlice
+      , pcSlice
 #endif
-        );
-    }
+      );
+  }
 #endif
 
-    // set up CABAC contexts' state for this CTU
-    if (ctuRsAddr == firstCtuRsAddrOfTile)
+  // set up CABAC contexts' state for this CTU
+  if (ctuRsAddr == firstCtuRsAddrOfTile)
+  {
+    if (ctuTsAddr != resetCtuTsAddr) // if it is the first CTU, then the entropy coder has already been reset
     {
-      if (ctuTsAddr != startCtuTsAddr) // if it is the first CTU, then the entropy coder has already been reset
-      {
-        m_pcEntropyDecoder->resetEntropy(pcSlice);
-      }
+      pcEntropyDecoder->resetEntropy(pcSlice);
     }
-    else if (ctuXPosInCtus == tileXPosInCtus && wavefrontsEnabled)
+  }
+  else if (ctuXPosInCtus == tileXPosInCtus && wavefrontsEnabled)
+  {
+    // Synchronize cabac probabilities with upper-right CTU if it's available and at the start of a line.
+    if (ctuTsAddr != resetCtuTsAddr) // if it is the first CTU, then the entropy coder has already been reset
     {
-      // Synchronize cabac probabilities with upper-right CTU if it's available and at the start of a line.
-      if (ctuTsAddr != startCtuTsAddr) // if it is the first CTU, then the entropy coder has already been reset
-      {
-        m_pcEntropyDecoder->resetEntropy(pcSlice);
-      }
-      TComDataCU *pCtuUp = pCtu->getCtuAbove();
-      if ( pCtuUp && ((ctuRsAddr%frameWidthInCtus+1) < frameWidthInCtus)  )
+      pcEntropyDecoder->resetEntropy(pcSlice);
+    }
+    TComDataCU *pCtuUp = pCtu->getCtuAbove();
+    if ( pCtuUp && ((ctuRsAddr%frameWidthInCtus+1) < frameWidthInCtus)  )
+    {
+      TComDataCU *pCtuTR = pcPic->getCtu( ctuRsAddr - frameWidthInCtus + 1 );
+      if ( pCtu->CUIsFromSameSliceAndTile(pCtuTR) )
       {
-        TComDataCU *pCtuTR = pcPic->getCtu( ctuRsAddr - frameWidthInCtus + 1 );
-        if ( pCtu->CUIsFromSameSliceAndTile(pCtuTR) )
-        {
-          // Top-right is available, so use it.
-          pcSbacDecoder->loadContexts( &m_entropyCodingSyncContextState );
-        }
+        // Top-right is available, so use it.
+        pcSbacDecoder->loadContexts( pcSyncContextStateIn );
       }
     }
+  }
 
 
 
 #if ENC_DEC_TRACE
-    g_bJustDoIt = g_bEncDecTraceEnable;
+  g_bJustDoIt = g_bEncDecTraceEnable;
 #endif
 
-    if ( pcSlice->getSPS()->getUseSAO() )
+  if ( pcSlice->getSPS()->getUseSAO() )
+  {
+    SAOBlkParam& saoblkParam = (pcPic->getPicSym()->getSAOBlkParam())[ctuRsAddr];
+    Bool bIsSAOSliceEnabled = false;
+    Bool sliceEnabled[MAX_NUM_COMPONENT];
+    for(Int comp=0; comp < MAX_NUM_COMPONENT; comp++)
     {
-      SAOBlkParam& saoblkParam = (pcPic->getPicSym()->getSAOBlkParam())[ctuRsAddr];
-      Bool bIsSAOSliceEnabled = false;
-      Bool sliceEnabled[MAX_NUM_COMPONENT];
-      for(Int comp=0; comp < MAX_NUM_COMPONENT; comp++)
+      ComponentID compId=ComponentID(comp);
+      sliceEnabled[compId] = pcSlice->getSaoEnabledFlag(toChannelType(compId)) && (comp < pcPic->getNumberValidComponents());
+      if (sliceEnabled[compId])
       {
-        ComponentID compId=ComponentID(comp);
-        sliceEnabled[compId] = pcSlice->getSaoEnabledFlag(toChannelType(compId)) && (comp < pcPic->getNumberValidComponents());
-        if (sliceEnabled[compId])
-        {
-          bIsSAOSliceEnabled=true;
-        }
-        saoblkParam[compId].modeIdc = SAO_MODE_OFF;
+        bIsSAOSliceEnabled=true;
       }
-      if (bIsSAOSliceEnabled)
+      saoblkParam[compId].modeIdc = SAO_MODE_OFF;
+    }
+    if (bIsSAOSliceEnabled)
+    {
+      Bool leftMergeAvail = false;
+      Bool aboveMergeAvail= false;
+
+      //merge left condition
+      Int rx = (ctuRsAddr % frameWidthInCtus);
+      if(rx > 0)
       {
-        Bool leftMergeAvail = false;
-        Bool aboveMergeAvail= false;
-
-        //merge left condition
-        Int rx = (ctuRsAddr % frameWidthInCtus);
-        if(rx > 0)
-        {
-          leftMergeAvail = pcPic->getSAOMergeAvailability(ctuRsAddr, ctuRsAddr-1);
-        }
-        //merge up condition
-        Int ry = (ctuRsAddr / frameWidthInCtus);
-        if(ry > 0)
-        {
-          aboveMergeAvail = pcPic->getSAOMergeAvailability(ctuRsAddr, ctuRsAddr-frameWidthInCtus);
-        }
-
-        pcSbacDecoder->parseSAOBlkParam( saoblkParam, sliceEnabled, leftMergeAvail, aboveMergeAvail, pcSlice->getSPS()->getBitDepths());
+        leftMergeAvail = pcPic->getSAOMergeAvailability(ctuRsAddr, ctuRsAddr-1);
       }
+      //merge up condition
+      Int ry = (ctuRsAddr / frameWidthInCtus);
+      if(ry > 0)
+      {
+        aboveMergeAvail = pcPic->getSAOMergeAvailability(ctuRsAddr, ctuRsAddr-frameWidthInCtus);
+      }
+
+      pcSbacDecoder->parseSAOBlkParam( saoblkParam, sliceEnabled, leftMergeAvail, aboveMergeAvail, pcSlice->getSPS()->getBitDepths());
     }
+  }
 
-    m_pcCuDecoder->decodeCtu     ( pCtu, isLastCtuOfSliceSegment );
-    m_pcCuDecoder->decompressCtu ( pCtu );
+  pcCuDecoder->decodeCtu     ( pCtu, isLastCtuOfSliceSegment );
+  pcCuDecoder->decompressCtu ( pCtu );
 
 #if ENC_DEC_TRACE
-    g_bJustDoIt = g_bEncDecTraceDisable;
+  g_bJustDoIt = g_bEncDecTraceDisable;
 #endif
 
-    //Store probabilities of second CTU in line into buffer
-    if ( ctuXPosInCtus == tileXPosInCtus+1 && wavefrontsEnabled)
+  //Store probabilities of second CTU in line into buffer
+  if ( ctuXPosInCtus == tileXPosInCtus+1 && wavefrontsEnabled)
+  {
+    pcSyncContextStateOut->loadContexts( pcSbacDecoder );
+  }
+
+  if (isLastCtuOfSliceSegment)
+  {
+#if DECODER_CHECK_SUBSTREAM_AND_SLICE_TRAILING_BYTES
+    pcSbacDecoder->parseRemainingBytes(false);
+#endif
+    if(!pcSlice->getDependentSliceSegmentFlag())
     {
-      m_entropyCodingSyncContextState.loadContexts( pcSbacDecoder );
+      pcSlice->setSliceCurEndCtuTsAddr( ctuTsAddr+1 );
     }
+    pcSlice->setSliceSegmentCurEndCtuTsAddr( ctuTsAddr+1 );
+  }
+  else if (  ctuXPosInCtus + 1 == tileXPosInCtus + currentTile.getTileWidthInCtus() &&
+           ( ctuYPosInCtus + 1 == tileYPosInCtus + currentTile.getTileHeightInCtus() || wavefrontsEnabled)
+          )
+  {
+    // The sub-stream/stream should be terminated after this CTU.
+    // (end of slice-segment, end of tile, end of wavefront-CTU-row)
+    UInt binVal;
+    pcSbacDecoder->parseTerminatingBit( binVal );
+    assert( binVal );
+#if DECODER_CHECK_SUBSTREAM_AND_SLICE_TRAILING_BYTES
+    pcSbacDecoder->parseRemainingBytes(true);
+#endif
+  }
+#if VCEG_AZ07_INIT_PREVFRAME
+  if( pcSlice->getSliceType() != I_SLICE )
+  {
+    UInt uiTargetCUAddr = pcPic->getFrameWidthInCtus()/2 + pcPic->getNumberOfCtusInFrame()/2;
+    if( uiTargetCUAddr >= pcPic->getNumberOfCtusInFrame() )
+    {
+      uiTargetCUAddr = pcPic->getNumberOfCtusInFrame() - 1;
+    }
+    if( ctuTsAddr == uiTargetCUAddr)
+    {        
+      pcSbacDecoder->loadContextsFromPrev( pcSlice->getStatsHandle(), pcSlice->getSliceType(), pcSlice->getCtxMapQPIdxforStore(), false ); 
+    }
+  }
+#endif
+}
 
-    if (isLastCtuOfSliceSegment)
+#if PARALLEL_SUBSTREAM_DECODING
+Void TDecSubstreamDecoder::create( const TComSPS &sps )
+{
+#if COM16_C806_LMCHROMA
+  m_cPrediction.initTempBuff(sps.getChromaFormatIdc(), sps.getBitDepth(CHANNEL_TYPE_LUMA)
+#else
+  m_cPrediction.initTempBuff(sps.getChromaFormatIdc()
+#endif
+#if VCEG_AZ08_INTER_KLT
+#if JVET_C0024_QTBT
+    , sps.getUseInterKLT() , sps.getPicWidthInLumaSamples() , sps.getPicHeightInLumaSamples() , sps.getCTUSize() , sps.getCTUSize() , sps.getMaxTotalCUDepth()
+#else
+    , sps.getUseInterKLT() , sps.getPicWidthInLumaSamples() , sps.getPicHeightInLumaSamples() , sps.getMaxCUWidth() , sps.getMaxCUHeight() , sps.getMaxTotalCUDepth()
+#endif
+#endif
+    );
+#if JVET_C0024_QTBT
+  m_cCuDecoder.create ( sps.getMaxTotalCUDepth(), sps.getCTUSize(), sps.getCTUSize(), sps.getChromaFormatIdc() );
+#else
+  m_cCuDecoder.create ( sps.getMaxTotalCUDepth(), sps.getMaxCUWidth(), sps.getMaxCUHeight(), sps.getChromaFormatIdc() );
+#endif
+  m_cCuDecoder.init   ( &m_cEntropyDecoder, &m_cTrQuant, &m_cPrediction );
+#if JVET_C0024_QTBT
+  m_cTrQuant.init     ( sps.getCTUSize()
+#else
+  m_cTrQuant.init     ( sps.getMaxTrSize()
+#endif
+#if VCEG_AZ08_USE_KLT
+    , sps.getUseKLT()
+#endif
+    );
+  m_cEntropyDecoder.init( &m_cPrediction );
+  m_cSbacDecoder.init( &m_cBinCABAC );
+}
+
+Void TDecSubstreamDecoder::destroy()
+{
+  m_cCuDecoder.destroy();
+}
+
+/** Create the private decoding state of the substream decoding threads for the active SPS.
+ *  The state is kept from one picture to the next and only created again when the SPS or the number of threads changes.
+ * \param sps        active SPS
+ * \param spsChanged true when the content of the SPS has changed since it was last activated
+ */
+Void TDecSlice::createSubstreamDecoders( const TComSPS &sps, Bool spsChanged )
+{
+  const UInt numDecoders = m_numSubstreamThreads > 1 ? UInt(m_numSubstreamThreads) : 0;
+  if (!spsChanged && m_substreamDecodersSpsId == sps.getSPSId() && m_substreamDecoders.size() == numDecoders)
+  {
+    return;
+  }
+
+  destroySubstreamDecoders();
+  while (m_substreamDecoders.size() < numDecoders)
+  {
+    m_substreamDecoders.push_back(new TDecSubstreamDecoder);
+  }
+  for (UInt i = 0; i < m_substreamDecoders.size(); i++)
+  {
+    m_substreamDecoders[i]->create(sps);
+  }
+  m_substreamDecodersSpsId = sps.getSPSId();
+
+  m_ctuDependencyRange       = 1;
+  m_crossTileDependencyRange = 0;
+#if VCEG_AZ08_INTRA_KLT
+#if VCEG_AZ08_USE_KLT
+  if (sps.getUseIntraKLT())
+#endif
+  {
+    // the intra template matching search of the KLT reaches SEARCHRANGEINTRA samples beyond the current CTU,
+    // without regard to tile boundaries
+    m_crossTileDependencyRange = (SEARCHRANGEINTRA + sps.getCTUSize() - 1) / sps.getCTUSize();
+    m_ctuDependencyRange      += m_crossTileDependencyRange;
+  }
+#endif
+}
+
+Void TDecSlice::destroySubstreamDecoders()
+{
+  if (m_substreamDecodersSpsId < 0)
+  {
+    return;
+  }
+  for (UInt i = 0; i < m_substreamDecoders.size(); i++)
+  {
+    m_substreamDecoders[i]->destroy();
+  }
+  m_substreamDecodersSpsId = -1;
+}
+
+Bool TDecSlice::xUseSubstreamThreads( TComPic* pcPic, TComSlice* pcSlice )
+{
+  // a slice has several substreams if it spans several tiles or wavefront rows
+  if( m_substreamDecoders.size() <= 1 || pcSlice->getNumberOfSubstreamSizes() == 0 )
+  {
+    return false;
+  }
+  // a dependent slice segment continues with the context states left by the previous slice segment in decoding order,
+  // which the substream threads do not hand over: such streams are decoded serially
+  if( pcSlice->getPPS()->getDependentSliceSegmentsEnabledFlag() )
+  {
+    if( !m_warningMessageSerialSubstreams )
     {
-#if DECODER_CHECK_SUBSTREAM_AND_SLICE_TRAILING_BYTES
-      pcSbacDecoder->parseRemainingBytes(false);
+      printf("Warning: dependent slice segments are enabled, the substreams are decoded on one thread\n");
+      m_warningMessageSerialSubstreams = true;
+    }
+    return false;
+  }
+  return true;
+}
+
+/** Decode the substreams (tiles or wavefront rows) of the current slice segment on several threads.
+ * Each thread repeatedly picks up the next substream and decodes it with its own entropy decoder and CU decoder. Before a CTU is decoded,
+ * the thread waits until the previously decoded CTUs referenced by it (the upper-right CTU for the wavefront context synchronisation and
+ * the intra prediction, and any CTU in reach of the intra template search) have been reconstructed.
+ * CTUs of different tiles only wait for each other when the intra template search is enabled.
+ */
+Void TDecSlice::xDecompressSubstreams( TComInputBitstream** ppcSubstreams, TComPic* pcPic
+#if ALF_HM3_REFACTOR
+  , ALFParam & alfParam
+#endif
+  )
+{
+  TComSlice* pcSlice         = pcPic->getSlice(pcPic->getCurrSliceIdx());
+  const UInt startCtuTsAddr  = pcSlice->getSliceSegmentCurStartCtuTsAddr();
+  const UInt numCtusInFrame  = pcPic->getNumberOfCtusInFrame();
+  const UInt numSubstreams   = pcSlice->getNumberOfSubstreamSizes()+1;
+
+  m_substreamOffset = pcPic->getSubstreamForCtuAddr(startCtuTsAddr, false, pcSlice);
+  m_substreamStartCtuTsAddr.clear();
+  for (UInt ctuTsAddr = startCtuTsAddr; ctuTsAddr < numCtusInFrame && m_substreamStartCtuTsAddr.size() < numSubstreams; ctuTsAddr++)
+  {
+    if (pcPic->getSubstreamForCtuAddr(ctuTsAddr, false, pcSlice) - m_substreamOffset == m_substreamStartCtuTsAddr.size())
+    {
+      m_substreamStartCtuTsAddr.push_back(ctuTsAddr);
+    }
+  }
+  assert(m_substreamStartCtuTsAddr.size() == numSubstreams);
+  m_substreamDecodedCtuTsAddr = m_substreamStartCtuTsAddr;
+
+  while (m_substreamSyncContextStates.size() < numSubstreams)
+  {
+    m_substreamSyncContextStates.push_back(new TDecSbac);
+  }
+  m_nextSubstreamIdx = 0;
+#if JVET_C0024_QTBT
+  // each thread follows the luma/chroma coding tree of its own CTU
+  m_sliceStartTextType = pcSlice->getTextType();
+  m_sliceEndTextType   = m_sliceStartTextType;
+  pcSlice->setThreadTextType(true);
+#endif
+
+  const UInt numThreads = std::min<UInt>(UInt(m_substreamDecoders.size()), numSubstreams);
+  std::vector<std::thread> threads;
+  for (UInt i = 0; i < numThreads; i++)
+  {
+    TDecSubstreamDecoder *pcDecoder = m_substreamDecoders[i];
+#if VCEG_AZ07_BAC_ADAPT_WDOW || VCEG_AZ07_INIT_PREVFRAME
+    pcDecoder->getEntropyDecoder()->setStatsHandle( pcSlice->getStatsHandle() );
+#endif
+    threads.push_back(std::thread(&TDecSlice::xDecompressSubstreamsThread, this, pcDecoder, ppcSubstreams, pcPic
+#if ALF_HM3_REFACTOR
+                                  , &alfParam
+#endif
+                                  ));
+  }
+  for (UInt i = 0; i < numThreads; i++)
+  {
+    threads[i].join();
+  }
+#if JVET_C0024_QTBT
+  pcSlice->setThreadTextType(false);
+  pcSlice->setTextType(m_sliceEndTextType);
+#endif
+
+  assert(pcSlice->getSliceSegmentCurEndCtuTsAddr() > startCtuTsAddr);
+}
+
+Void TDecSlice::xDecompressSubstreamsThread( TDecSubstreamDecoder* pcDecoder, TComInputBitstream** ppcSubstreams, TComPic* pcPic
+#if ALF_HM3_REFACTOR
+  , ALFParam* pcAlfParam
+#endif
+  )
+{
+  TComSlice* pcSlice                 = pcPic->getSlice(pcPic->getCurrSliceIdx());
+  const UInt numCtusInFrame          = pcPic->getNumberOfCtusInFrame();
+  TDecEntropy *pcEntropyDecoder      = pcDecoder->getEntropyDecoder();
+  TDecSbac    *pcSbacDecoder         = pcDecoder->getSbacDecoder();
+#if JVET_C0024_QTBT
+  pcSlice->setTextType(m_sliceStartTextType);
 #endif
-      if(!pcSlice->getDependentSliceSegmentFlag())
+#if JVET_D0033_ADAPTIVE_CLIPPING && PARALLEL_FRAME_DECODING
+  g_ClipParam = pcPic->m_aclip_prm;
+#endif
+
+  while (true)
+  {
+    UInt substreamIdx;
+    {
+      std::lock_guard<std::mutex> lock(m_substreamMutex);
+      if (m_nextSubstreamIdx >= m_substreamStartCtuTsAddr.size())
       {
-        pcSlice->setSliceCurEndCtuTsAddr( ctuTsAddr+1 );
+        return;
       }
-      pcSlice->setSliceSegmentCurEndCtuTsAddr( ctuTsAddr+1 );
+      substreamIdx = m_nextSubstreamIdx++;
     }
-    else if (  ctuXPosInCtus + 1 == tileXPosInCtus + currentTile.getTileWidthInCtus() &&
-             ( ctuYPosInCtus + 1 == tileYPosInCtus + currentTile.getTileHeightInCtus() || wavefrontsEnabled)
-            )
+    const UInt substreamStartCtuTsAddr = m_substreamStartCtuTsAddr[substreamIdx];
+
+    pcEntropyDecoder->setEntropyDecoder ( pcSbacDecoder );
+    pcEntropyDecoder->setBitstream      ( ppcSubstreams[substreamIdx] );
+    pcEntropyDecoder->resetEntropy      ( pcSlice );
+
+    Bool isLastCtuOfSliceSegment = false;
+    for (UInt ctuTsAddr = substreamStartCtuTsAddr; !isLastCtuOfSliceSegment && ctuTsAddr < numCtusInFrame; )
     {
-      // The sub-stream/stream should be terminated after this CTU.
-      // (end of slice-segment, end of tile, end of wavefront-CTU-row)
-      UInt binVal;
-      pcSbacDecoder->parseTerminatingBit( binVal );
-      assert( binVal );
-#if DECODER_CHECK_SUBSTREAM_AND_SLICE_TRAILING_BYTES
-      pcSbacDecoder->parseRemainingBytes(true);
+      xWaitForReferenceCtus( pcPic, pcSlice, ctuTsAddr );
+
+      xDecodeCtu( pcPic, ctuTsAddr, substreamStartCtuTsAddr, pcEntropyDecoder, pcSbacDecoder, pcDecoder->getCuDecoder(),
+                  substreamIdx > 0 ? m_substreamSyncContextStates[substreamIdx-1] : NULL, m_substreamSyncContextStates[substreamIdx],
+#if ALF_HM3_REFACTOR
+                  *pcAlfParam,
 #endif
-    }
-#if VCEG_AZ07_INIT_PREVFRAME
-    if( pcSlice->getSliceType() != I_SLICE )
-    {
-      UInt uiTargetCUAddr = pcPic->getFrameWidthInCtus()/2 + pcPic->getNumberOfCtusInFrame()/2;
-      if( uiTargetCUAddr >= pcPic->getNumberOfCtusInFrame() )
+                  isLastCtuOfSliceSegment );
+      ctuTsAddr++;
+
       {
-        uiTargetCUAddr = pcPic->getNumberOfCtusInFrame() - 1;
+        std::lock_guard<std::mutex> lock(m_substreamMutex);
+        m_substreamDecodedCtuTsAddr[substreamIdx] = ctuTsAddr;
       }
-      if( ctuTsAddr == uiTargetCUAddr)
-      {        
-        pcSbacDecoder->loadContextsFromPrev( pcSlice->getStatsHandle(), pcSlice->getSliceType(), pcSlice->getCtxMapQPIdxforStore(), false ); 
+      m_substreamProgress.notify_all();
+
+      if (ctuTsAddr < numCtusInFrame && pcPic->getSubstreamForCtuAddr(ctuTsAddr, false, pcSlice) - m_substreamOffset != substreamIdx)
+      {
+        break;
       }
     }
+
+#if JVET_C0024_QTBT
+    if (isLastCtuOfSliceSegment)
+    {
+      m_sliceEndTextType = pcSlice->getTextType();
+    }
 #endif
   }
+}
 
-  assert(isLastCtuOfSliceSegment == true);
-
-
-  if( depSliceSegmentsEnabled )
+/** Wait until the CTUs of the current slice preceding the given CTU in decoding order that may be referenced by its parsing or reconstruction are decoded.
+ */
+Void TDecSlice::xWaitForReferenceCtus( TComPic* pcPic, TComSlice* pcSlice, UInt ctuTsAddr )
+{
+  const TComPicSym &picSym     = *(pcPic->getPicSym());
+  const Int  frameWidthInCtus  = picSym.getFrameWidthInCtus();
+  const UInt ctuRsAddr         = picSym.getCtuTsToRsAddrMap(ctuTsAddr);
+  const Int  ctuXPosInCtus     = ctuRsAddr % frameWidthInCtus;
+  const Int  ctuYPosInCtus     = ctuRsAddr / frameWidthInCtus;
+  const Int  frameHeightInCtus = picSym.getFrameHeightInCtus();
+  const UInt startCtuTsAddr    = pcSlice->getSliceSegmentCurStartCtuTsAddr();
+  const UInt tileIdx           = picSym.getTileIdxMap(ctuRsAddr);
+  const Int  range             = std::max(m_ctuDependencyRange, m_crossTileDependencyRange);
+
+  std::unique_lock<std::mutex> lock(m_substreamMutex);
+  // within a tile the CTUs below are decoded later; the CTUs of another tile decoded earlier may also lie below, and read samples
+  // of the current CTU that must not be reconstructed before
+  for (Int y = std::max(0, ctuYPosInCtus - range); y <= std::min(frameHeightInCtus - 1, ctuYPosInCtus + m_crossTileDependencyRange); y++)
   {
-    m_lastSliceSegmentEndContextState.loadContexts( pcSbacDecoder );//ctx end of dep.slice
+    for (Int x = std::max(0, ctuXPosInCtus - range); x <= std::min(frameWidthInCtus - 1, ctuXPosInCtus + range); x++)
+    {
+      const UInt refCtuRsAddr = y * frameWidthInCtus + x;
+      const UInt refCtuTsAddr = picSym.getCtuRsToTsAddrMap(refCtuRsAddr);
+      if (refCtuTsAddr >= ctuTsAddr || refCtuTsAddr < startCtuTsAddr)
+      {
+        // decoded after the current CTU, or part of an earlier slice segment that is already complete
+        continue;
+      }
+      const Int refRange = picSym.getTileIdxMap(refCtuRsAddr) == tileIdx ? m_ctuDependencyRange : m_crossTileDependencyRange;
+      if (abs(x - ctuXPosInCtus) > refRange || abs(y - ctuYPosInCtus) > refRange)
+      {
+        continue;
+      }
+      const UInt substreamIdx = pcPic->getSubstreamForCtuAddr(refCtuRsAddr, true, pcSlice) - m_substreamOffset;
+      while (m_substreamDecodedCtuTsAddr[substreamIdx] <= refCtuTsAddr)
+      {
+        m_substreamProgress.wait(lock);
+      }
+    }
   }
-
 }
+#endif
 
 #if VCEG_AZ08_INTER_KLT
 Void TDecSlice::InterpolatePic(TComPic* pcPic)
@@ -49,6 +49,13 @@
 #include "TDecCu.h"
 #include "TDecSbac.h"
 #include "TDecBinCoderCABAC.h"
+#if PARALLEL_SUBSTREAM_DECODING
+#include "TLibCommon/TComPrediction.h"
+#include "TLibCommon/TComTrQuant.h"
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#endif
 
 //! \ingroup TLibDecoder
 //! \{
@@ -57,6 +64,29 @@
 // Class definition
 // ====================================================================================================================
 
+#if PARALLEL_SUBSTREAM_DECODING
+/// private entropy decoding and reconstruction state of one substream decoding thread
+class TDecSubstreamDecoder
+{
+private:
+  TDecBinCABAC    m_cBinCABAC;
+  TDecSbac        m_cSbacDecoder;
+  TDecEntropy     m_cEntropyDecoder;
+  TDecCu          m_cCuDecoder;
+  TComTrQuant     m_cTrQuant;
+  TComPrediction  m_cPrediction;
+
+public:
+  Void  create            ( const TComSPS &sps );
+  Void  destroy           ();
+
+  TDecEntropy*    getEntropyDecoder ()  { return &m_cEntropyDecoder; }
+  TDecSbac*       getSbacDecoder    ()  { return &m_cSbacDecoder;    }
+  TDecCu*         getCuDecoder      ()  { return &m_cCuDecoder;      }
+  TComTrQuant*    getTrQuant        ()  { return &m_cTrQuant;        }
+};
+#endif
+
 /// slice decoder class
 class TDecSlice
 {
@@ -67,6 +97,25 @@ private:
 
   TDecSbac        m_lastSliceSegmentEndContextState;    ///< context storage for state at the end of the previous slice-segment (used for dependent slices only).
   TDecSbac        m_entropyCodingSyncContextState;      ///< context storate for state of contexts at the wavefront/WPP/entropy-coding-sync second CTU of tile-row
+#if PARALLEL_SUBSTREAM_DECODING
+  Int                                 m_numSubstreamThreads;              ///< number of threads used to decode the substreams of a slice (1: serial decoding)
+  std::vector<TDecSubstreamDecoder*>  m_substreamDecoders;                ///< private decoding state of each substream decoding thread
+  std::vector<TDecSbac*>              m_substreamSyncContextStates;       ///< per-substream storage of the contexts at the second CTU of a wavefront row
+  std::vector<UInt>                   m_substreamStartCtuTsAddr;          ///< first CTU (tile-scan address) of each substream of the current slice
+  std::vector<UInt>                   m_substreamDecodedCtuTsAddr;        ///< first CTU (tile-scan address) of each substream that has not been decoded yet
+  UInt                                m_nextSubstreamIdx;                 ///< next substream to be picked up by a decoding thread
+  UInt                                m_substreamOffset;                  ///< global substream index of the first substream of the current slice
+  Int                                 m_ctuDependencyRange;               ///< distance in CTUs up to which the reconstruction of a CTU depends on previously decoded CTUs of the same tile
+  Int                                 m_crossTileDependencyRange;         ///< distance in CTUs up to which the reconstruction of a CTU reads samples of other tiles (0: tiles are independent)
+  Int                                 m_substreamDecodersSpsId;           ///< id of the SPS the substream decoders are created for (-1: not created)
+  Bool                                m_warningMessageSerialSubstreams;   ///< the fallback to serial decoding for dependent slice segments has been reported
+#if JVET_C0024_QTBT
+  ChannelType                         m_sliceStartTextType;               ///< channel type of the slice when its substreams are handed to the threads
+  ChannelType                         m_sliceEndTextType;                 ///< channel type left by the last CTU of the slice segment
+#endif
+  std::mutex                          m_substreamMutex;
+  std::condition_variable             m_substreamProgress;
+#endif
 
 public:
   TDecSlice();
@@ -84,6 +133,35 @@ public:
 #if VCEG_AZ08_INTER_KLT
   Void InterpolatePic    ( TComPic* pcPic );
 #endif
+#if PARALLEL_SUBSTREAM_DECODING
+  Void  setNumSubstreamThreads    ( Int numThreads )  { m_numSubstreamThreads = numThreads; }
+  Void  createSubstreamDecoders   ( const TComSPS &sps, Bool spsChanged );
+  Void  destroySubstreamDecoders  ();
+  UInt  getNumSubstreamDecoders   () const            { return UInt(m_substreamDecoders.size()); }
+  TComTrQuant* getSubstreamTrQuant( UInt idx )        { return m_substreamDecoders[idx]->getTrQuant(); }
+#endif
+
+private:
+  Void  xDecodeCtu        ( TComPic* pcPic, UInt ctuTsAddr, UInt resetCtuTsAddr, TDecEntropy* pcEntropyDecoder, TDecSbac* pcSbacDecoder, TDecCu* pcCuDecoder,
+                            TDecSbac* pcSyncContextStateIn, TDecSbac* pcSyncContextStateOut,
+#if ALF_HM3_REFACTOR
+                            ALFParam & alfParam,
+#endif
+                            Bool &isLastCtuOfSliceSegment );
+#if PARALLEL_SUBSTREAM_DECODING
+  Bool  xUseSubstreamThreads      ( TComPic* pcPic, TComSlice* pcSlice );
+  Void  xDecompressSubstreams     ( TComInputBitstream** ppcSubstreams, TComPic* pcPic
+#if ALF_HM3_REFACTOR
+                                  , ALFParam & alfParam
+#endif
+                                  );
+  Void  xDecompressSubstreamsThread( TDecSubstreamDecoder* pcDecoder, TComInputBitstream** ppcSubstreams, TComPic* pcPic
+#if ALF_HM3_REFACTOR
+                                  , ALFParam* pcAlfParam
+#endif
+                                  );
+  Void  xWaitForReferenceCtus     ( TComPic* pcPic, TComSlice* pcSlice, UInt ctuTsAddr );
+#endif
 };
 
 //! \}
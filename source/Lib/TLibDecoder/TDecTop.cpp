@@ -79,6 +79,10 @@ TDecTop::TDecTop()
   , m_pDecodedSEIOutputStream(NULL)
   , m_warningMessageSkipPicture(false)
   , m_prefixSEINALUs()
+#if PARALLEL_FRAME_DECODING
+  , m_bFramePipelining(false)
+  , m_pcFilteredPic(NULL)
+#endif
 {
 #if ENC_DEC_TRACE
   if (g_hTrace == NULL)
@@ -131,12 +135,18 @@ Void TDecTop::init()
     &m_cAdaptiveLoopFilter, 
 #endif
     &m_cSAO);
+#if PARALLEL_FRAME_DECODING && ALF_HM3_REFACTOR
+  m_cGopDecoder.setFilterAdaptiveLoopFilter( &m_cFilterAdaptiveLoopFilter );
+#endif
   m_cSliceDecoder.init( &m_cEntropyDecoder, &m_cCuDecoder );
   m_cEntropyDecoder.init(&m_cPrediction);
 }
 
 Void TDecTop::deletePicBuffer ( )
 {
+#if PARALLEL_FRAME_DECODING
+  finishLoopFilters();
+#endif
   TComList<TComPic*>::iterator  iterPic   = m_cListPic.begin();
   Int iSize = Int( m_cListPic.size() );
 
@@ -152,6 +162,9 @@ Void TDecTop::deletePicBuffer ( )
 #if ALF_HM3_REFACTOR
   // destroy ALF temporary buffers
   m_cAdaptiveLoopFilter.destroy();
+#if PARALLEL_FRAME_DECODING
+  m_cFilterAdaptiveLoopFilter.destroy();
+#endif
 #endif
 
   m_cSAO.destroy();
@@ -205,6 +218,9 @@ Void TDecTop::xGetNewPicBuffer ( const TComSPS &sps, const TComPPS &pps, TComPic
     rpcPic = new TComPic();
     m_cListPic.pushBack( rpcPic );
   }
+#if PARALLEL_FRAME_DECODING
+  rpcPic->waitForLoopFilter();
+#endif
   rpcPic->destroy();
   rpcPic->create ( sps, pps, true);
 }
@@ -221,6 +237,16 @@ Void TDecTop::executeLoopFilters(Int& poc, TComList<TComPic*>*& rpcListPic)
 
   // Execute Deblock + Cleanup
 
+#if PARALLEL_FRAME_DECODING
+  if (m_bFramePipelining)
+  {
+    // the loop filter thread uses the loop filter objects until the next call: wait for the previous picture first
+    finishLoopFilters();
+    m_cGopDecoder.startFilterPicture(pcPic);
+    m_pcFilteredPic = pcPic;
+  }
+  else
+#endif
   m_cGopDecoder.filterPicture(pcPic);
 
   TComSlice::sortPicList( m_cListPic ); // sorting for application output
@@ -232,6 +258,16 @@ Void TDecTop::executeLoopFilters(Int& poc, TComList<TComPic*>*& rpcListPic)
   return;
 }
 
+#if PARALLEL_FRAME_DECODING
+/** Waits until the picture handed to the loop filter thread by executeLoopFilters() is filtered.
+ */
+Void TDecTop::finishLoopFilters()
+{
+  m_cGopDecoder.finishFilterPicture();
+  m_pcFilteredPic = NULL;
+}
+#endif
+
 Void TDecTop::checkNoOutputPriorPics (TComList<TComPic*>* pcListPic)
 {
   if (!pcListPic || !m_isNoOutputPriorPics)
@@ -275,6 +311,9 @@ Void TDecTop::xCreateLostPicture(Int iLostPoc)
     if(abs(rpcPic->getPicSym()->getSlice(0)->getPOC() -iLostPoc)==closestPoc&&rpcPic->getPicSym()->getSlice(0)->getPOC()!=m_apcSlicePilot->getPOC())
     {
       printf("copying picture %d to %d (%d)\n",rpcPic->getPicSym()->getSlice(0)->getPOC() ,iLostPoc,m_apcSlicePilot->getPOC());
+#if PARALLEL_FRAME_DECODING
+      rpcPic->waitForLoopFilter();
+#endif
       rpcPic->getPicYuvRec()->copyToPic(cFillPic->getPicYuvRec());
       break;
     }
@@ -306,6 +345,25 @@ Void TDecTop::xActivateParameterSets()
     const TComSPS *sps = m_parameterSetManager.getSPS(pps->getSPSId());             // this is a temporary SPS object. Do not store this value
     assert (sps != 0);
 
+#if PARALLEL_FRAME_DECODING
+    // the loop filter objects may still be in use by the loop filter thread: keep them when they are set up for the same parameter sets
+    Bool reuseLoopFilters = false;
+    if (m_pcFilteredPic)
+    {
+      const TComSlice *pcFilteredSlice = m_pcFilteredPic->getSlice(0);
+      reuseLoopFilters = pcFilteredSlice->getSPS()->getSPSId() == sps->getSPSId() && !m_parameterSetManager.getSPSChangedFlag(sps->getSPSId())
+                      && pcFilteredSlice->getPPS()->getPPSId() == pps->getPPSId() && !m_parameterSetManager.getPPSChangedFlag(pps->getPPSId());
+      if (!reuseLoopFilters)
+      {
+        finishLoopFilters();
+      }
+    }
+#endif
+
+#if PARALLEL_SUBSTREAM_DECODING
+    // the substream decoders are kept as long as the active SPS does not change
+    const Bool spsChanged = m_parameterSetManager.getSPSChangedFlag(sps->getSPSId());
+#endif
     m_parameterSetManager.clearSPSChangedFlag(sps->getSPSId());
     m_parameterSetManager.clearPPSChangedFlag(pps->getPPSId());
 
@@ -333,6 +391,16 @@ Void TDecTop::xActivateParameterSets()
     //  Get a new picture buffer. This will also set up m_pcPic, and therefore give us a SPS and PPS pointer that we can use.
     xGetNewPicBuffer (*(sps), *(pps), m_pcPic, m_apcSlicePilot->getTLayer());
     m_apcSlicePilot->applyReferencePictureSet(m_cListPic, m_apcSlicePilot->getRPS());
+#if KLT_ON_DEMAND_SUBPEL_PLANES
+    // the pictures that are no longer referenced are not searched by the inter KLT anymore
+    for (TComList<TComPic*>::iterator iterPic = m_cListPic.begin(); iterPic != m_cListPic.end(); iterPic++)
+    {
+      if (!(*iterPic)->getSlice(0)->isReferenced())
+      {
+        (*iterPic)->releaseQuaPicYuvRec();
+      }
+    }
+#endif
 
     // make the slice-pilot a real slice, and set up the slice-pilot for the next slice
     assert(m_pcPic->getNumAllocatedSlice() == (m_uiSliceIdx + 1));
@@ -356,14 +424,33 @@ Void TDecTop::xActivateParameterSets()
       m_cAdaptiveLoopFilter.create( sps->getPicWidthInLumaSamples(), sps->getPicHeightInLumaSamples(), sps->getChromaFormatIdc() , sps->getMaxCUWidth(), sps->getMaxCUHeight(), sps->getMaxTotalCUDepth() ,
 #endif
         sps->getBitDepth( CHANNEL_TYPE_LUMA ) , sps->getBitDepth( CHANNEL_TYPE_LUMA ) );
+#if PARALLEL_FRAME_DECODING
+      // the loop filter thread filters with its own ALF, which may only be set up again once that thread has finished
+      if( m_bFramePipelining && !reuseLoopFilters )
+      {
+#if JVET_C0024_QTBT
+        m_cFilterAdaptiveLoopFilter.create( sps->getPicWidthInLumaSamples(), sps->getPicHeightInLumaSamples(), sps->getChromaFormatIdc() , sps->getCTUSize(), sps->getCTUSize(), sps->getMaxTotalCUDepth() ,
+#else
+        m_cFilterAdaptiveLoopFilter.create( sps->getPicWidthInLumaSamples(), sps->getPicHeightInLumaSamples(), sps->getChromaFormatIdc() , sps->getMaxCUWidth(), sps->getMaxCUHeight(), sps->getMaxTotalCUDepth() ,
+#endif
+          sps->getBitDepth( CHANNEL_TYPE_LUMA ) , sps->getBitDepth( CHANNEL_TYPE_LUMA ) );
+      }
+#endif
     }
 #endif
+#if PARALLEL_FRAME_DECODING
+    if( !reuseLoopFilters )
+    {
+#endif
 #if JVET_C0024_QTBT
     m_cSAO.create( sps->getPicWidthInLumaSamples(), sps->getPicHeightInLumaSamples(), sps->getChromaFormatIdc(), sps->getCTUSize(), sps->getCTUSize(), sps->getMaxTotalCUDepth(), pps->getPpsRangeExtension().getLog2SaoOffsetScale(CHANNEL_TYPE_LUMA), pps->getPpsRangeExtension().getLog2SaoOffsetScale(CHANNEL_TYPE_CHROMA) );
 #else
     m_cSAO.create( sps->getPicWidthInLumaSamples(), sps->getPicHeightInLumaSamples(), sps->getChromaFormatIdc(), sps->getMaxCUWidth(), sps->getMaxCUHeight(), sps->getMaxTotalCUDepth(), pps->getPpsRangeExtension().getLog2SaoOffsetScale(CHANNEL_TYPE_LUMA), pps->getPpsRangeExtension().getLog2SaoOffsetScale(CHANNEL_TYPE_CHROMA) );
 #endif
     m_cLoopFilter.create( sps->getMaxTotalCUDepth() );
+#if PARALLEL_FRAME_DECODING
+    }
+#endif
 #if COM16_C806_LMCHROMA
     m_cPrediction.initTempBuff(sps->getChromaFormatIdc(), sps->getBitDepth(CHANNEL_TYPE_LUMA)
 #if VCEG_AZ08_INTER_KLT
@@ -431,6 +518,9 @@ Void TDecTop::xActivateParameterSets()
 #endif
 
     m_cSliceDecoder.create();
+#if PARALLEL_SUBSTREAM_DECODING
+    m_cSliceDecoder.createSubstreamDecoders(*sps, spsChanged);
+#endif
   }
   else
   {
@@ -751,6 +841,36 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
   }
 
   m_pcPic->setCurrSliceIdx(m_uiSliceIdx);
+  xSetScalingList(m_cTrQuant, pcSlice);
+#if PARALLEL_SUBSTREAM_DECODING
+  for (UInt i = 0; i < m_cSliceDecoder.getNumSubstreamDecoders(); i++)
+  {
+    xSetScalingList(*m_cSliceDecoder.getSubstreamTrQuant(i), pcSlice);
+  }
+#endif
+
+#if VCEG_AZ07_FRUC_MERGE
+  if( pcSlice->getSPS()->getUseFRUCMgrMode() && !pcSlice->isIntra() )
+  {
+    m_pcPic->initFRUCMVP();
+  }
+#endif
+
+  //  Decode a picture
+#if VCEG_AZ07_BAC_ADAPT_WDOW || VCEG_AZ07_INIT_PREVFRAME
+  m_cGopDecoder.decompressSlice(&(nalu.getBitstream()), m_pcPic, m_apcStats);
+#else
+  m_cGopDecoder.decompressSlice(&(nalu.getBitstream()), m_pcPic);
+#endif
+
+  m_bFirstSliceInPicture = false;
+  m_uiSliceIdx++;
+
+  return false;
+}
+
+Void TDecTop::xSetScalingList(TComTrQuant &trQuant, TComSlice* pcSlice)
+{
   if(pcSlice->getSPS()->getScalingListFlag())
   {
     TComScalingList scalingList;
@@ -766,8 +886,8 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
     {
       scalingList.setDefaultScalingList();
     }
-    m_cTrQuant.setScalingListDec(scalingList);
-    m_cTrQuant.setUseScalingList(true);
+    trQuant.setScalingListDec(scalingList);
+    trQuant.setUseScalingList(true);
   }
   else
   {
@@ -776,28 +896,9 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
         pcSlice->getSPS()->getMaxLog2TrDynamicRange(CHANNEL_TYPE_LUMA),
         pcSlice->getSPS()->getMaxLog2TrDynamicRange(CHANNEL_TYPE_CHROMA)
     };
-    m_cTrQuant.setFlatScalingList(maxLog2TrDynamicRange, pcSlice->getSPS()->getBitDepths());
-    m_cTrQuant.setUseScalingList(false);
-  }
-
-#if VCEG_AZ07_FRUC_MERGE
-  if( pcSlice->getSPS()->getUseFRUCMgrMode() && !pcSlice->isIntra() )
-  {
-    m_pcPic->initFRUCMVP();
+    trQuant.setFlatScalingList(maxLog2TrDynamicRange, pcSlice->getSPS()->getBitDepths());
+    trQuant.setUseScalingList(false);
   }
-#endif
-
-  //  Decode a picture
-#if VCEG_AZ07_BAC_ADAPT_WDOW || VCEG_AZ07_INIT_PREVFRAME
-  m_cGopDecoder.decompressSlice(&(nalu.getBitstream()), m_pcPic, m_apcStats);
-#else
-  m_cGopDecoder.decompressSlice(&(nalu.getBitstream()), m_pcPic);
-#endif
-
-  m_bFirstSliceInPicture = false;
-  m_uiSliceIdx++;
-
-  return false;
 }
 
 Void TDecTop::xDecodeVPS(const std::vector<UChar> &naluData)
@@ -117,6 +117,13 @@ private:
 #if ALF_HM3_REFACTOR
   TComAdaptiveLoopFilter  m_cAdaptiveLoopFilter;
 #endif
+#if PARALLEL_FRAME_DECODING
+#if ALF_HM3_REFACTOR
+  TComAdaptiveLoopFilter  m_cFilterAdaptiveLoopFilter;  ///< ALF run by the loop filter thread, m_cAdaptiveLoopFilter sets up the ALF parameters of the picture being decoded
+#endif
+  Bool                    m_bFramePipelining;       ///< loop-filter each picture on a separate thread while the next picture is decoded
+  TComPic*                m_pcFilteredPic;          ///< picture handed to the loop filter thread and not waited for yet (NULL: none)
+#endif
 
 public:
   TDecTop();
@@ -137,6 +144,9 @@ public:
 
   
   Void  executeLoopFilters(Int& poc, TComList<TComPic*>*& rpcListPic);
+#if PARALLEL_FRAME_DECODING
+  Void  finishLoopFilters ();
+#endif
   Void  checkNoOutputPriorPics (TComList<TComPic*>* rpcListPic);
 
   Bool  getNoOutputPriorPicsFlag () { return m_isNoOutputPriorPics; }
@@ -146,6 +156,19 @@ public:
   Void  setFirstSliceInSequence (bool val) { m_bFirstSliceInSequence = val; }
 #if O0043_BEST_EFFORT_DECODING
   Void  setForceDecodeBitDepth(UInt bitDepth) { m_forceDecodeBitDepth = bitDepth; }
+#endif
+#if PARALLEL_SUBSTREAM_DECODING
+  Void  setNumSubstreamThreads(Int numThreads) { m_cSliceDecoder.setNumSubstreamThreads(numThreads); }
+#endif
+#if PARALLEL_ALF
+#if PARALLEL_FRAME_DECODING
+  Void  setNumAlfThreads(Int numThreads)   { m_cAdaptiveLoopFilter.setNumThreads(numThreads); m_cFilterAdaptiveLoopFilter.setNumThreads(numThreads); }
+#else
+  Void  setNumAlfThreads(Int numThreads)   { m_cAdaptiveLoopFilter.setNumThreads(numThreads); }
+#endif
+#endif
+#if PARALLEL_FRAME_DECODING
+  Void  setFramePipelining (Bool b)        { m_bFramePipelining = b; }
 #endif
   Void  setDecodedSEIMessageOutputStream(std::ostream *pOpStream) { m_pDecodedSEIOutputStream = pOpStream; }
   UInt  getNumberOfChecksumErrorsDetected() const { return m_cGopDecoder.getNumberOfChecksumErrorsDetected(); }
@@ -162,6 +185,7 @@ protected:
 #else
   Bool      xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisplay);
 #endif
+  Void      xSetScalingList(TComTrQuant &trQuant, TComSlice* pcSlice);
   Void      xDecodeVPS(const std::vector<UChar> &naluData);
   Void      xDecodeSPS(const std::vector<UChar> &naluData);
   Void      xDecodePPS(const std::vector<UChar> &naluData);
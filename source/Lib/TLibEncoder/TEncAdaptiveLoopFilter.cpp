@@ -147,7 +147,39 @@ TEncAdaptiveLoopFilter::TEncAdaptiveLoopFilter()
   m_pcTempAlfParam = NULL;
   m_pcPicYuvBest = NULL;
   m_pcPicYuvTmp = NULL;
+#if JVET_C0038_GALF && PARALLEL_SEGMENT_ENCODING
+  m_yFiltTemp = NULL;
+  m_yFiltTemp9x9 = NULL;
+  m_EVarPredTemp = NULL;
+  m_pixAccVarPredTemp = NULL;
+  m_filterCoeffQuantVarPredTemp = NULL;
+  ::memset( m_usePrevFiltBest, 0, sizeof(m_usePrevFiltBest) );
+  m_yMergeTemp = NULL;
+  m_EMergeTemp = NULL;
+#endif
+}
+
+#if JVET_C0038_GALF && PARALLEL_SEGMENT_ENCODING
+TEncAdaptiveLoopFilter::~TEncAdaptiveLoopFilter()
+{
+  if( m_yFiltTemp != NULL )
+  {
+    destroyMatrix_double( m_yFiltTemp );
+    destroyMatrix_double( m_yFiltTemp9x9 );
+  }
+  if( m_EVarPredTemp != NULL )
+  {
+    destroyMatrix3D_double( m_EVarPredTemp, m_NO_VAR_BINS );
+    free( m_pixAccVarPredTemp );
+    destroyMatrix_int( m_filterCoeffQuantVarPredTemp );
+  }
+  if( m_EMergeTemp != NULL )
+  {
+    destroyMatrix_double( m_EMergeTemp );
+    delete [] m_yMergeTemp;
+  }
 }
+#endif
 
 // ====================================================================================================================
 // Public member functions
@@ -199,6 +231,9 @@ Void TEncAdaptiveLoopFilter::startALFEnc( TComPic* pcPic, TEncEntropy* pcEntropy
 #if JVET_C0038_GALF 
   get_mem2Dpel(&m_maskBestpImg, m_im_height, m_im_width);
 #endif
+#if ALF_INCREMENTAL_STATS
+  get_mem2Dpel(&m_maskStatsImg, m_im_height, m_im_width);
+#endif
 
   initMatrix_double(&m_E_temp, m_MAX_SQR_FILT_LENGTH, m_MAX_SQR_FILT_LENGTH);//
   m_y_temp = (double *) calloc(m_MAX_SQR_FILT_LENGTH, sizeof(double));//
@@ -246,6 +281,9 @@ Void TEncAdaptiveLoopFilter::endALFEnc()
 #if JVET_C0038_GALF
   free_mem2Dpel(m_maskBestpImg);
 #endif 
+#if ALF_INCREMENTAL_STATS
+  free_mem2Dpel(m_maskStatsImg);
+#endif
   destroyMatrix3D_double(m_E_merged, m_NO_VAR_BINS);
   destroyMatrix_double(m_y_merged);
   destroyMatrix_double(m_E_temp);
@@ -2139,6 +2177,9 @@ Void   TEncAdaptiveLoopFilter::xEncALFLuma_qc ( TComPicYuv* pcPicOrg, TComPicYuv
 
 #if JVET_C0038_GALF
   setInitialMask(pcPicOrg, pcPicDec,pcAlfParam);
+#if ALF_INCREMENTAL_STATS
+  xResetBlockMatrixStats();
+#endif
 #else
   setInitialMask(pcPicOrg, pcPicDec);
 #endif
@@ -3058,8 +3099,125 @@ Int TEncAdaptiveLoopFilter::xFilterPixel(imgpel *ImgDec, Int* varIndBeforeMappin
 }
 #endif
 
+#if ALF_INCREMENTAL_STATS
+/** Empties the statistics of xUpdateBlockMatrixStats(), to be called when the classification of the picture is set
+ */
+Void TEncAdaptiveLoopFilter::xResetBlockMatrixStats()
+{
+  ::memset( m_aiStatsE, 0, sizeof( m_aiStatsE ) );
+  ::memset( m_aiStatsY, 0, sizeof( m_aiStatsY ) );
+  ::memset( m_aiStatsPixAcc, 0, sizeof( m_aiStatsPixAcc ) );
+  for( Int i = 0; i < m_im_height; i++ )
+  {
+    ::memset( m_maskStatsImg[i], 0, sizeof( imgpel ) * m_im_width );
+  }
+}
+
+/** Brings the 9x9 statistics in line with the ALF on/off mask, adding the samples switched on and removing those switched off since the last update
+ *  The products are summed in integers, so the result does not depend on the order of the updates and matches the sums of a full scan.
+ */
+Void TEncAdaptiveLoopFilter::xUpdateBlockMatrixStats(imgpel* ImgOrg, imgpel* ImgDec, Int Stride)
+{
+  const Int fl = m_ALF_MAX_NUM_TAP/2;
+  const Int flV = TComAdaptiveLoopFilter::ALFFlHToFlV(fl);
+  const Int sqrFiltLength = TComAdaptiveLoopFilter::ALFTapHToNumCoeff(m_ALF_MAX_NUM_TAP);
+  assert( sqrFiltLength == m_ALF_STATS_NUM_COEFF );
+
+  // all the samples count when no CU has its filter on
+  Bool bAllValid = true;
+  for (Int i = 0; i < m_im_height && bAllValid; i++)
+  {
+    for (Int j = 0; j < m_im_width; j++)
+    {
+      if (m_maskImg[i][j] == 1)
+      {
+        bAllValid = false;
+        break;
+      }
+    }
+  }
+
+  for (Int i = 0; i < m_im_height; i++)
+  {
+    for (Int j = 0; j < m_im_width; j++)
+    {
+      const imgpel bValid = ( bAllValid || m_maskImg[i][j] != 0 ) ? 1 : 0;
+      if (bValid == m_maskStatsImg[i][j])
+      {
+        continue;
+      }
+      m_maskStatsImg[i][j] = bValid;
+
+      Int ELocal[m_MAX_SQR_FILT_LENGTH];
+      memset(ELocal, 0, sqrFiltLength*sizeof(Int));
+      Int transpose = 0;
+      Int varIndMod = selectTransposeVarInd(m_varImg[i][j], &transpose);
+      Int yLocal = ImgOrg[i*Stride + j] - ImgDec[i*Stride + j];
+      calcMatrixE(ELocal, ImgDec, m_patternTab[0], i, j, flV, fl, transpose, Stride);
+
+      const Int iSign = bValid ? 1 : -1;
+      Int64* pE = m_aiStatsE[varIndMod];
+      Int64* pY = m_aiStatsY[varIndMod];
+      for (Int k = 0; k < sqrFiltLength; k++, pE += m_ALF_STATS_NUM_COEFF)
+      {
+        const Int e = iSign * ELocal[k];
+        for (Int l = k; l < sqrFiltLength; l++)
+        {
+          pE[l] += e * ELocal[l];
+        }
+        pY[k] += e * yLocal;
+      }
+      m_aiStatsPixAcc[varIndMod] += iSign * yLocal * yLocal;
+    }
+  }
+}
+#endif
+
 Void   TEncAdaptiveLoopFilter::xstoreInBlockMatrix(imgpel* ImgOrg, imgpel* ImgDec, Int tap, Int Stride)
 {
+#if ALF_INCREMENTAL_STATS
+  if(bUpdateMatrix)
+  {
+    xUpdateBlockMatrixStats(ImgOrg, ImgDec, Stride);
+
+    // the coefficients of the smaller diamonds are a subset of those of the 9x9 one
+    const Int filtNo = tap == 9 ? 0 : ( tap == 7 ? 1 : 2 );
+    const Int sqrFiltLength = TComAdaptiveLoopFilter::ALFTapHToNumCoeff(tap);
+    Int aiCoeffIn9x9[m_ALF_STATS_NUM_COEFF];
+    for (Int i = 0, k = 0; i < m_MAX_SQR_FILT_LENGTH; i++)
+    {
+      if (m_patternMapTab[0][i] > 0)
+      {
+        if (m_patternMapTab[filtNo][i] > 0)
+        {
+          aiCoeffIn9x9[m_patternMapTab[filtNo][i]-1] = k;
+        }
+        k++;
+      }
+    }
+
+    memset( m_pixAcc, 0,sizeof(double)*m_NO_VAR_BINS);
+    for (Int varInd=0; varInd<m_max_NO_VAR_BINS; varInd++)
+    {
+      Double** E  = m_EGlobalSym[filtNo][varInd];
+      Double*  yy = m_yGlobalSym[filtNo][varInd];
+      memset(yy, 0, sizeof(double)*m_MAX_SQR_FILT_LENGTH);
+      for (Int k=0; k<sqrFiltLength; k++)
+      {
+        memset(E[k], 0, sizeof(double)*m_MAX_SQR_FILT_LENGTH);
+        const Int k0 = aiCoeffIn9x9[k];
+        for (Int l=0; l<sqrFiltLength; l++)
+        {
+          const Int l0 = aiCoeffIn9x9[l];
+          E[k][l] = (Double)m_aiStatsE[varInd][std::min(k0, l0)*m_ALF_STATS_NUM_COEFF + std::max(k0, l0)];
+        }
+        yy[k] = (Double)m_aiStatsY[varInd][k0];
+      }
+      m_pixAcc[varInd] = (Double)m_aiStatsPixAcc[varInd];
+    }
+    return;
+  }
+#endif
 #if JVET_C0038_GALF
   if(bUpdateMatrix)
   {
@@ -3204,12 +3362,21 @@ Void   TEncAdaptiveLoopFilter::xstoreInBlockMatrix(imgpel* ImgOrg, imgpel* ImgDe
 Void   TEncAdaptiveLoopFilter::xFilteringFrameLuma_qc(imgpel* ImgOrg, imgpel* imgY_pad, imgpel* ImgFilt, ALFParam* ALFp, Int tap, Int Stride, const TComSlice * pSlice)
 {
 #if JVET_C0038_GALF
+#if PARALLEL_SEGMENT_ENCODING
+  Double **&y_temp = m_yFiltTemp, **&y_temp9x9 = m_yFiltTemp9x9;
+  Int first = ( y_temp != NULL );
+#else
   static Double **y_temp, **y_temp9x9;  
   static Int first = 0;
+#endif
 #endif
 
   int  filtNo,filters_per_fr;
+#if PARALLEL_SEGMENT_ENCODING
+  double **ySym, ***ESym;
+#else
   static double **ySym, ***ESym;
+#endif
   int lambda_val = (Int) m_dLambdaLuma;
   lambda_val = lambda_val * (1<<(2*m_nBitIncrement));
   if (tap==9)
@@ -3299,9 +3466,11 @@ Void TEncAdaptiveLoopFilter::xfilterFrame_en(imgpel* ImgDec, imgpel* ImgRest,int
   int var_step_size_h = m_ALF_VAR_SIZE_H;
 #endif
 
+#if !( JVET_C0038_GALF && ( PARALLEL_ALF || SIMD_AVX2_ALF ) )
   int i,j,y,x;
-  int fl;
   int pixelInt;
+#endif
+  int fl;
   int offset = (1<<(m_NUM_BITS - 2));
 #if !JVET_C0038_GALF
   int sqrFiltLength;
@@ -3309,6 +3478,44 @@ Void TEncAdaptiveLoopFilter::xfilterFrame_en(imgpel* ImgDec, imgpel* ImgRest,int
 #endif
   fl=m_FILTER_LENGTH/2;
   
+#if JVET_C0038_GALF && ( PARALLEL_ALF || SIMD_AVX2_ALF )
+#if SIMD_AVX2_ALF
+  xSetLumaTapPairs( m_filterCoeffPrevSelected, filtNo );
+#endif
+  // filters a row of windows, the left columns with the SIMD kernel if available
+  auto filterRows = [&]( Int iJob )
+  {
+    const Int iStartHeight = iJob * m_ALF_WIN_VERSIZE;
+    const Int iEndHeight   = std::min( iStartHeight + m_ALF_WIN_VERSIZE, m_im_height );
+    Int       iStartWidth  = 0;
+#if SIMD_AVX2_ALF
+    iStartWidth = xFilterBlockSIMD( ImgRest, ImgDec, m_varImg, iStartHeight, iEndHeight, 0, m_im_width, Stride, COMPONENT_Y );
+#endif
+    for( Int y = iStartHeight; y < iEndHeight; y++ )
+    {
+      for( Int x = iStartWidth; x < m_im_width; x++ )
+      {
+        Int varInd   = m_varImg[y][x];
+        Int pixelInt = xFilterPixel(imgY_rec, &varInd,  NULL, NULL, y + fl, x + fl, fl, Stride, filtNo);
+        pixelInt     = (pixelInt + offset) >> (m_NUM_BITS - 1);
+#if JVET_D0033_ADAPTIVE_CLIPPING
+        ImgRest[y*Stride + x] = ClipA(pixelInt, COMPONENT_Y); // always luma here
+#else
+        ImgRest[y*Stride + x] = Clip3(0, m_nIBDIMax, pixelInt);
+#endif
+      }
+    }
+  };
+  const Int iNumWindowRows = ( m_im_height + m_ALF_WIN_VERSIZE - 1 ) / m_ALF_WIN_VERSIZE;
+#if PARALLEL_ALF
+  xRunFilterJobs( iNumWindowRows, [&]( Int iJob, Int ) { filterRows( iJob ); } );
+#else
+  for( Int iJob = 0; iJob < iNumWindowRows; iJob++ )
+  {
+    filterRows( iJob );
+  }
+#endif
+#else
   for (y=0, i = fl; i < m_im_height+fl; i++, y++)
   {
     for (x=0, j = fl; j < m_im_width+fl; j++, x++)
@@ -3400,6 +3607,7 @@ Void TEncAdaptiveLoopFilter::xfilterFrame_en(imgpel* ImgDec, imgpel* ImgRest,int
 #endif
     }
   }
+#endif
 }
 #if JVET_C0038_GALF
 Void TEncAdaptiveLoopFilter::xfindBestFilterPredictor(Double ***E_temp, Double**y_temp, Double *pixAcc_temp, Int filtNo, const TComSlice * pSlice
@@ -3529,9 +3737,15 @@ Void TEncAdaptiveLoopFilter::xfindBestFilterVarPred(Double **ySym, Double ***ESy
  
   Double  error, lambda, lagrangian, lagrangianMin; 
     
+#if PARALLEL_SEGMENT_ENCODING
+  Double ***&E_temp = m_EVarPredTemp, *&pixAcc_temp = m_pixAccVarPredTemp;
+  Int **&FilterCoeffQuantTemp = m_filterCoeffQuantVarPredTemp;
+  Int first = ( E_temp != NULL );
+#else
   static Int first = 0;
   static Double ***E_temp, *pixAcc_temp;
   static Int **FilterCoeffQuantTemp;
+#endif
  
   lambda = lambda_val;
   sqrFiltLength=m_MAX_SQR_FILT_LENGTH;
@@ -3567,7 +3781,11 @@ Void TEncAdaptiveLoopFilter::xfindBestFilterVarPred(Double **ySym, Double ***ESy
 
   Bool forceCoeff0, codedVarBins[m_NO_VAR_BINS];
   Char iFixedFilters = m_tempALFp->iAvailableFilters;
+#if PARALLEL_SEGMENT_ENCODING
+  Char *usePrevFiltBest = m_usePrevFiltBest;
+#else
   static Char usePrevFiltBest[m_NO_VAR_BINS];
+#endif
   Double errorForce0CoeffTab[m_NO_VAR_BINS][2];
 
   xfindBestFilterPredictor(E_temp, y_temp, pixAcc_temp, filtNo, pSlice, ImgOrg, ImgDec, Stride, &forceCoeff0,
@@ -4577,8 +4795,13 @@ Void TEncAdaptiveLoopFilter::xMergeFiltersGreedy(Double **yGlobalSeq, Double ***
 {
   Int first, ind, ind1, ind2, noRemaining, i, j, exist, indexList[m_NO_VAR_BINS], indexListTemp[m_NO_VAR_BINS], available[m_NO_VAR_BINS], bestToMerge[2];
   Double error, error1, error2, errorMin;
+#if PARALLEL_SEGMENT_ENCODING
+  Double *&y_temp = m_yMergeTemp, **&E_temp = m_EMergeTemp, pixAcc_temp;
+  Int init = ( E_temp != NULL );
+#else
   static Double *y_temp, **E_temp, pixAcc_temp;
   static Int init = 0;
+#endif
   if (init == 0)
   {
     initMatrix_double(&E_temp, m_MAX_SQR_FILT_LENGTH, m_MAX_SQR_FILT_LENGTH);
@@ -5058,7 +5281,11 @@ Double TEncAdaptiveLoopFilter::findFilterCoeff(Double ***EGlobalSeq, Double **yG
 Double TEncAdaptiveLoopFilter::findFilterCoeff(double ***EGlobalSeq, double **yGlobalSeq, double *pixAccGlobalSeq, int **filterCoeffSeq, int **filterCoeffQuantSeq, int intervalBest[m_NO_VAR_BINS][2], int varIndTab[m_NO_VAR_BINS], int sqrFiltLength, int filters_per_fr, int *weights, int bit_depth, double errorTabForce0Coeff[m_NO_VAR_BINS][2])
 #endif
 {
+#if PARALLEL_SEGMENT_ENCODING
+  double pixAcc_temp;
+#else
   static double pixAcc_temp;
+#endif
   double error;
   int k, filtNo;
   
@@ -89,6 +89,13 @@ private:
   Bool bTapDecision;
   Bool bUpdateMatrix; //for filter tap decision
   imgpel **m_maskBestpImg;
+#endif
+#if ALF_INCREMENTAL_STATS
+  static const Int m_ALF_STATS_NUM_COEFF = 21;                                              ///< coefficients of the 9x9 diamond
+  Int64    m_aiStatsE[m_NO_VAR_BINS][m_ALF_STATS_NUM_COEFF*m_ALF_STATS_NUM_COEFF];          ///< [class][k*21+l], l>=k, auto-correlation of the 9x9 shape over the samples set in m_maskStatsImg
+  Int64    m_aiStatsY[m_NO_VAR_BINS][m_ALF_STATS_NUM_COEFF];                                ///< [class], cross-correlation of the 9x9 shape with the coding error
+  Int64    m_aiStatsPixAcc[m_NO_VAR_BINS];                                                  ///< [class], energy of the coding error
+  imgpel **m_maskStatsImg;                                                                  ///< samples counted in the statistics
 #endif
   double ***m_yGlobalSym;
   double ****m_EGlobalSym;
@@ -116,6 +123,17 @@ private:
   Int **m_imgY_preFilter;
   Double m_filterCoeffPrev[m_NO_VAR_BINS*JVET_C0038_NO_PREV_FILTERS][21];
   Double m_filterCoeffDefault[21];
+#endif
+#if JVET_C0038_GALF && PARALLEL_SEGMENT_ENCODING
+  // scratch buffers of the filter search, allocated at first use and kept until destruction
+  Double  **m_yFiltTemp;                       ///< xFilteringFrameLuma_qc: correlation vectors of the current filter shape
+  Double  **m_yFiltTemp9x9;                    ///< xFilteringFrameLuma_qc: correlation vectors of the 9x9 shape, kept across pictures
+  Double ***m_EVarPredTemp;                    ///< xfindBestFilterVarPred: auto-correlation matrices
+  Double   *m_pixAccVarPredTemp;               ///< xfindBestFilterVarPred: pixel energy per class
+  Int     **m_filterCoeffQuantVarPredTemp;     ///< xfindBestFilterVarPred: quantized coefficients
+  Char      m_usePrevFiltBest[m_NO_VAR_BINS];  ///< xfindBestFilterVarPred: fixed filter selected per class
+  Double   *m_yMergeTemp;                      ///< xMergeFiltersGreedy: merged correlation vector
+  Double  **m_EMergeTemp;                      ///< xMergeFiltersGreedy: merged auto-correlation matrix
 #endif
   static Int  m_aiTapPos9x9_In9x9Sym[21];
   static Int  m_aiTapPos7x7_In9x9Sym[14];
@@ -176,7 +194,11 @@ protected:
   Void xEncALFChroma          ( UInt64 uiLumaRate, TComPicYuv* pcPicOrg, TComPicYuv* pcPicDec, TComPicYuv* pcPicRest, UInt64& ruiDist, UInt64& ruiBits , const TComSlice * pSlice );
 public:
   TEncAdaptiveLoopFilter          ();
+#if JVET_C0038_GALF && PARALLEL_SEGMENT_ENCODING
+  virtual ~TEncAdaptiveLoopFilter ();
+#else
   virtual ~TEncAdaptiveLoopFilter () {}
+#endif
   
   /// allocate temporal memory
   Void startALFEnc(TComPic* pcPic, TEncEntropy* pcEntropyCoder);
@@ -212,6 +234,10 @@ public:
                                          UInt64& ruiMinDist, Double& rdMinCost, const TComSlice * pSlice);
   Void xFirstFilteringFrameLuma         (imgpel* ImgOrg, imgpel* ImgDec, imgpel* ImgRest, ALFParam* ALFp, Int tap,  Int Stride, const TComSlice * pSlice);
   Void xstoreInBlockMatrix(imgpel* ImgOrg, imgpel* ImgDec, Int tap, Int Stride);
+#if ALF_INCREMENTAL_STATS
+  Void xResetBlockMatrixStats();
+  Void xUpdateBlockMatrixStats(imgpel* ImgOrg, imgpel* ImgDec, Int Stride);
+#endif
 #if JVET_C0038_GALF  
   Void xPreFilterFr(Int** imgY_preFilter, imgpel* imgY_rec, imgpel * imgY_org, imgpel* imgY_append, Int usePrevFilt[], Int Stride, Int filtNo);
   Void calcMatrixE(Int *ELocal, imgpel *ImgDec, Int *p_pattern, Int i, Int j, Int flV, Int fl, Int transpose, Int Stride);
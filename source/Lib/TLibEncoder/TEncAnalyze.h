@@ -82,6 +82,21 @@ public:
     m_uiNumPic++;
   }
 
+#if PARALLEL_SEGMENT_ENCODING
+  /// accumulate the results of another analyzer (statistics of an intra-period segment encoded separately)
+  Void  add( const TEncAnalyze& rcAnalyze )
+  {
+    m_dAddBits  += rcAnalyze.m_dAddBits;
+    for(UInt i=0; i<MAX_NUM_COMPONENT; i++)
+    {
+      m_dPSNRSum[i] += rcAnalyze.m_dPSNRSum[i];
+      m_MSEyuvframe[i] += rcAnalyze.m_MSEyuvframe[i];
+    }
+
+    m_uiNumPic += rcAnalyze.m_uiNumPic;
+  }
+#endif
+
   Double  getPsnr(ComponentID compID) const { return  m_dPSNRSum[compID];  }
   Double  getBits()                   const { return  m_dAddBits;   }
   Void    setBits(Double numBits)     { m_dAddBits=numBits; }
@@ -75,6 +75,9 @@ Void  xTraceSliceHeader ()
 TEncCavlc::TEncCavlc()
 {
   m_pcBitIf           = NULL;
+#if PARALLEL_SEGMENT_ENCODING
+  m_iPOCLsbOffset     = 0;
+#endif
 }
 
 TEncCavlc::~TEncCavlc()
@@ -858,7 +861,11 @@ Void TEncCavlc::codeSliceHeader         ( TComSlice* pcSlice )
 
     if( !pcSlice->getIdrPicFlag() )
     {
+#if PARALLEL_SEGMENT_ENCODING
+      Int picOrderCntLSB = (pcSlice->getPOC()-pcSlice->getLastIDR()+m_iPOCLsbOffset+(1<<pcSlice->getSPS()->getBitsForPOC())) & ((1<<pcSlice->getSPS()->getBitsForPOC())-1);
+#else
       Int picOrderCntLSB = (pcSlice->getPOC()-pcSlice->getLastIDR()+(1<<pcSlice->getSPS()->getBitsForPOC())) & ((1<<pcSlice->getSPS()->getBitsForPOC())-1);
+#endif
       WRITE_CODE( picOrderCntLSB, pcSlice->getSPS()->getBitsForPOC(), "slice_pic_order_cnt_lsb");
       const TComReferencePictureSet* rps = pcSlice->getRPS();
 
@@ -1171,58 +1178,6 @@ Void TEncCavlc::codeSliceHeader         ( TComSlice* pcSlice )
       WRITE_FLAG(pcSlice->getLFCrossSliceBoundaryFlag()?1:0, "slice_loop_filter_across_slices_enabled_flag");
     }
   }
-#if JVET_D0033_ADAPTIVE_CLIPPING
-  if (sliceSegmentRsAddress==0&&pcSlice->getPPS()->m_clip_enabled) { // only for first header and when ON
-      WRITE_FLAG(pcSlice->getPic()->m_aclip_prm.isActive?1:0, "TchClipAdaptive_flag");
-
-      if (pcSlice->getPic()->m_aclip_prm.isActive)
-      {
-          const ClipParam &prm=pcSlice->getPic()->m_aclip_prm;
-
-
-              Int code,scode;
-
-          scode=(prm.Y().m);
-          code=(scode>>ClipParam::cquantiz);
-              assert(code<(1<<(ClipParam::nbBitsY-ClipParam::cquantiz)));
-              WRITE_CODE(code, ClipParam::nbBitsY-ClipParam::cquantiz, "TchClipAdaptive_Y_MIN");
-
-
-          scode=(prm.Y().M);
-          code=(scode>>ClipParam::cquantiz);
-              assert(code<(1<<(ClipParam::nbBitsY-ClipParam::cquantiz)));
-              WRITE_CODE(code, ClipParam::nbBitsY-ClipParam::cquantiz, "TchClipAdaptive_Y_MAX");
-              WRITE_FLAG(prm.isChromaActive?1:0, "TchClipAdaptive_flag_chroma");
-              if (prm.isChromaActive)
-              {
-              scode=prm.U().m;
-              code=(scode>>ClipParam::cquantiz);
-                  assert(code<(1<<(ClipParam::nbBitsUV-ClipParam::cquantiz)));
-              WRITE_CODE(code, ClipParam::nbBitsUV-ClipParam::cquantiz, "TchClipAdaptive_C0_MIN");
-
-              scode=prm.U().M;
-              code=(scode>>ClipParam::cquantiz);
-                  assert(code<(1<<(ClipParam::nbBitsUV-ClipParam::cquantiz)));
-              WRITE_CODE(code, ClipParam::nbBitsUV-ClipParam::cquantiz, "TchClipAdaptive_C0_MAX");
-
-              scode=prm.V().m;
-              code=(scode>>ClipParam::cquantiz);
-                  assert(code<(1<<(ClipParam::nbBitsUV-ClipParam::cquantiz)));
-              WRITE_CODE(code, ClipParam::nbBitsUV-ClipParam::cquantiz, "TchClipAdaptive_C1_MIN");
-
-              scode=prm.V().M;
-              code=(scode>>ClipParam::cquantiz);
-                  assert(code<(1<<(ClipParam::nbBitsUV-ClipParam::cquantiz)));
-                  WRITE_CODE(code, ClipParam::nbBitsUV-ClipParam::cquantiz, "TchClipAdaptive_C1_MAX");
-              }
-   
-      }
-  }
-#endif
-  if(pcSlice->getPPS()->getSliceHeaderExtensionPresentFlag())
-  {
-    WRITE_UVLC(0,"slice_segment_header_extension_length");
-  }
 }
 
 Void TEncCavlc::codePTL( const TComPTL* pcPTL, Bool profilePresentFlag, Int maxNumSubLayersMinus1)
@@ -1309,7 +1264,69 @@ Void TEncCavlc::codeProfileTier( const ProfileTierLevel* ptl, const Bool /*bIsSu
 }
 
 /**
- * Write tiles and wavefront substreams sizes for the slice header (entry points).
+ * Write the slice header syntax that follows the entry points.
+ *
+ * \param pcSlice TComSlice structure of the current slice segment.
+ */
+Void TEncCavlc::xCodeSliceHeaderTail( TComSlice* pcSlice )
+{
+#if JVET_D0033_ADAPTIVE_CLIPPING
+  const Int sliceSegmentRsAddress = pcSlice->getPic()->getPicSym()->getCtuTsToRsAddrMap(pcSlice->getSliceSegmentCurStartCtuTsAddr());
+  if (sliceSegmentRsAddress==0&&pcSlice->getPPS()->m_clip_enabled) { // only for first header and when ON
+      WRITE_FLAG(pcSlice->getPic()->m_aclip_prm.isActive?1:0, "TchClipAdaptive_flag");
+
+      if (pcSlice->getPic()->m_aclip_prm.isActive)
+      {
+          const ClipParam &prm=pcSlice->getPic()->m_aclip_prm;
+
+
+              Int code,scode;
+
+          scode=(prm.Y().m);
+          code=(scode>>ClipParam::cquantiz);
+              assert(code<(1<<(ClipParam::nbBitsY-ClipParam::cquantiz)));
+              WRITE_CODE(code, ClipParam::nbBitsY-ClipParam::cquantiz, "TchClipAdaptive_Y_MIN");
+
+
+          scode=(prm.Y().M);
+          code=(scode>>ClipParam::cquantiz);
+              assert(code<(1<<(ClipParam::nbBitsY-ClipParam::cquantiz)));
+              WRITE_CODE(code, ClipParam::nbBitsY-ClipParam::cquantiz, "TchClipAdaptive_Y_MAX");
+              WRITE_FLAG(prm.isChromaActive?1:0, "TchClipAdaptive_flag_chroma");
+              if (prm.isChromaActive)
+              {
+              scode=prm.U().m;
+              code=(scode>>ClipParam::cquantiz);
+                  assert(code<(1<<(ClipParam::nbBitsUV-ClipParam::cquantiz)));
+              WRITE_CODE(code, ClipParam::nbBitsUV-ClipParam::cquantiz, "TchClipAdaptive_C0_MIN");
+
+              scode=prm.U().M;
+              code=(scode>>ClipParam::cquantiz);
+                  assert(code<(1<<(ClipParam::nbBitsUV-ClipParam::cquantiz)));
+              WRITE_CODE(code, ClipParam::nbBitsUV-ClipParam::cquantiz, "TchClipAdaptive_C0_MAX");
+
+              scode=prm.V().m;
+              code=(scode>>ClipParam::cquantiz);
+                  assert(code<(1<<(ClipParam::nbBitsUV-ClipParam::cquantiz)));
+              WRITE_CODE(code, ClipParam::nbBitsUV-ClipParam::cquantiz, "TchClipAdaptive_C1_MIN");
+
+              scode=prm.V().M;
+              code=(scode>>ClipParam::cquantiz);
+                  assert(code<(1<<(ClipParam::nbBitsUV-ClipParam::cquantiz)));
+                  WRITE_CODE(code, ClipParam::nbBitsUV-ClipParam::cquantiz, "TchClipAdaptive_C1_MAX");
+              }
+   
+      }
+  }
+#endif
+  if(pcSlice->getPPS()->getSliceHeaderExtensionPresentFlag())
+  {
+    WRITE_UVLC(0,"slice_segment_header_extension_length");
+  }
+}
+
+/**
+ * Write tiles and wavefront substreams sizes for the slice header (entry points), followed by the rest of the slice header.
  *
  * \param pSlice TComSlice structure that contains the substream size information.
  */
@@ -1317,6 +1334,7 @@ Void  TEncCavlc::codeTilesWPPEntryPoint( TComSlice* pSlice )
 {
   if (!pSlice->getPPS()->getTilesEnabledFlag() && !pSlice->getPPS()->getEntropyCodingSyncEnabledFlag())
   {
+    xCodeSliceHeaderTail( pSlice );
     return;
   }
   UInt maxOffset = 0;
@@ -1347,6 +1365,7 @@ Void  TEncCavlc::codeTilesWPPEntryPoint( TComSlice* pSlice )
       WRITE_CODE(pSlice->getSubstreamSize(idx)-1, offsetLenMinus1+1, "entry_point_offset_minus1");
     }
   }
+  xCodeSliceHeaderTail( pSlice );
 }
 
 Void TEncCavlc::codeTerminatingBit      ( UInt /*uilsLast*/ )
@@ -65,6 +65,9 @@ protected:
   Bool          m_bAlfCtrl;
   UInt          m_uiMaxAlfCtrlDepth;
 #endif
+#if PARALLEL_SEGMENT_ENCODING
+  Int           m_iPOCLsbOffset;   ///< added to slice_pic_order_cnt_lsb, so that the slices of a separately encoded segment can be concatenated with the preceding ones
+#endif
 
 public:
   TEncCavlc();
@@ -80,6 +83,9 @@ public:
   SliceType determineCabacInitIdx  (const TComSlice* /*pSlice*/) { assert(0); return I_SLICE; };
 
   Void  setBitstream          ( TComBitIf* p )  { m_pcBitIf = p;  }
+#if PARALLEL_SEGMENT_ENCODING
+  Void  setPOCLsbOffset       ( Int i )         { m_iPOCLsbOffset = i; }
+#endif
   Void  resetBits             ()                { m_pcBitIf->resetBits(); }
   UInt  getNumberOfWrittenBits()                { return  m_pcBitIf->getNumberOfWrittenBits();  }
   Void  codeVPS                 ( const TComVPS* pcVPS );
@@ -188,6 +194,7 @@ public:
     );
 
   Void xCodePredWeightTable          ( TComSlice* pcSlice );
+  Void xCodeSliceHeaderTail          ( TComSlice* pcSlice );
 
   Void codeScalingList  ( const TComScalingList &scalingList );
   Void xCodeScalingList ( const TComScalingList* scalingList, UInt sizeId, UInt listId);
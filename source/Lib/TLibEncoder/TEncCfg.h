@@ -297,6 +297,18 @@ protected:
   std::vector<Int> m_tileRowHeight;
 
   Int       m_iWaveFrontSynchro;
+#if PARALLEL_SUBSTREAM_ENCODING
+  Int       m_numSubstreamThreads;                       ///< number of threads compressing the substreams (wavefront rows, tiles) of a slice
+#endif
+#if PARALLEL_ALF
+  Int       m_numAlfThreads;                             ///< number of threads running the adaptive loop filter
+#endif
+#if PARALLEL_SEGMENT_ENCODING
+  Int       m_segmentIdx;                                ///< index of the intra-period segment encoded by this instance (-1: whole sequence)
+#endif
+#if PARALLEL_PICTURE_ENCODING
+  Int       m_numPictureThreads;                         ///< number of threads compressing the pictures of a GOP
+#endif
 
   Int       m_decodedPictureHashSEIEnabled;              ///< Checksum(3)/CRC(2)/MD5(1)/disable(0) acting on decoded picture hash SEI message
   Int       m_bufferingPeriodSEIEnabled;
@@ -503,6 +515,18 @@ public:
   TEncCfg()
   : m_tileColumnWidth()
   , m_tileRowHeight()
+#if PARALLEL_SUBSTREAM_ENCODING
+  , m_numSubstreamThreads(1)
+#endif
+#if PARALLEL_ALF
+  , m_numAlfThreads(1)
+#endif
+#if PARALLEL_SEGMENT_ENCODING
+  , m_segmentIdx(-1)
+#endif
+#if PARALLEL_PICTURE_ENCODING
+  , m_numPictureThreads(1)
+#endif
   {
     m_PCMBitDepth[CHANNEL_TYPE_LUMA]=8;
     m_PCMBitDepth[CHANNEL_TYPE_CHROMA]=8;
@@ -616,6 +640,7 @@ public:
   Void      setFastSearch                   ( Int   i )      { m_iFastSearch = i; }
   Void      setSearchRange                  ( Int   i )      { m_iSearchRange = i; }
   Void      setBipredSearchRange            ( Int   i )      { m_bipredSearchRange = i; }
+  Int       getBipredSearchRange            () const         { return m_bipredSearchRange; }
   Void      setClipForBiPredMeEnabled       ( Bool  b )      { m_bClipForBiPredMeEnabled = b; }
   Void      setFastMEAssumingSmootherMVEnabled ( Bool b )    { m_bFastMEAssumingSmootherMVEnabled = b; }
 
@@ -843,6 +868,22 @@ public:
   Void  xCheckGSParameters();
   Void  setWaveFrontSynchro(Int iWaveFrontSynchro)                   { m_iWaveFrontSynchro = iWaveFrontSynchro; }
   Int   getWaveFrontsynchro()                                        { return m_iWaveFrontSynchro; }
+#if PARALLEL_SUBSTREAM_ENCODING
+  Void  setNumSubstreamThreads(Int i)                                { m_numSubstreamThreads = i; }
+  Int   getNumSubstreamThreads()                                     { return m_numSubstreamThreads; }
+#endif
+#if PARALLEL_ALF
+  Void  setNumAlfThreads(Int i)                                      { m_numAlfThreads = i; }
+  Int   getNumAlfThreads()                                           { return m_numAlfThreads; }
+#endif
+#if PARALLEL_PICTURE_ENCODING
+  Void  setNumPictureThreads(Int i)                                  { m_numPictureThreads = i; }
+  Int   getNumPictureThreads()                                       { return m_numPictureThreads; }
+#endif
+#if PARALLEL_SEGMENT_ENCODING
+  Void  setSegmentIdx(Int i)                                         { m_segmentIdx = i; }
+  Int   getSegmentIdx() const                                        { return m_segmentIdx; }
+#endif
   Void  setDecodedPictureHashSEIEnabled(Int b)                       { m_decodedPictureHashSEIEnabled = b; }
   Int   getDecodedPictureHashSEIEnabled()                            { return m_decodedPictureHashSEIEnabled; }
   Void  setBufferingPeriodSEIEnabled(Int b)                          { m_bufferingPeriodSEIEnabled = b; }
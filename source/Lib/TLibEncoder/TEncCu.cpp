@@ -43,14 +43,24 @@
 
 #include <cmath>
 #include <algorithm>
+#if PARALLEL_SUBSTREAM_ENCODING
+#include <mutex>
+#endif
 using namespace std;
 
 
 //! \ingroup TLibEncoder
 //! \{
 #if VCEG_AZ08_INTER_KLT
+#if PARALLEL_SUBSTREAM_ENCODING
+extern thread_local Bool g_bEnableCheck;
+#else
 extern Bool g_bEnableCheck;
 #endif
+#endif
+#if JVET_C0024_AMAX_BT && PARALLEL_SUBSTREAM_ENCODING && !PARALLEL_SEGMENT_ENCODING
+static std::mutex g_blkStatsMutex;  ///< guards g_uiBlkSize and g_uiNumBlk, which are updated by the CU encoders of all substream threads
+#endif
 // ====================================================================================================================
 // Constructor / destructor / create / destroy
 // ====================================================================================================================
@@ -68,6 +78,9 @@ Void TEncCu::create(UChar uhTotalDepth, UInt uiMaxWidth, UInt uiMaxHeight, Chrom
 #endif
 
   m_uhTotalDepth   = uhTotalDepth + 1;
+#if JVET_C0024_AMAX_BT && PARALLEL_SEGMENT_ENCODING
+  clearBlkStats();
+#endif
 #if JVET_C0024_QTBT
   UInt uiNumPartitions = 1<<( ( m_uhTotalDepth - 1 )<<1 );
   assert(uiNumPartitions == 1<<(g_aucConvertToBit[uiMaxWidth] + g_aucConvertToBit[uiMaxHeight]));
@@ -779,6 +792,34 @@ Void TEncCu::init( TEncTop* pcEncTop )
   m_pcRateCtrl         = pcEncTop->getRateCtrl();
 }
 
+#if PARALLEL_SUBSTREAM_ENCODING
+#if JVET_C0024_QTBT
+Void TEncCu::init( TEncCfg* pcEncCfg, TEncSearch* pcPredSearch, TComTrQuant* pcTrQuant, TComRdCost* pcRdCost, TEncEntropy* pcEntropyCoder,
+                   TEncSbac**** ppppcRDSbacCoder, TEncSbac* pcRDGoOnSbacCoder, TEncRateCtrl* pcRateCtrl )
+#else
+Void TEncCu::init( TEncCfg* pcEncCfg, TEncSearch* pcPredSearch, TComTrQuant* pcTrQuant, TComRdCost* pcRdCost, TEncEntropy* pcEntropyCoder,
+                   TEncSbac*** pppcRDSbacCoder, TEncSbac* pcRDGoOnSbacCoder, TEncRateCtrl* pcRateCtrl )
+#endif
+{
+  m_pcEncCfg           = pcEncCfg;
+  m_pcPredSearch       = pcPredSearch;
+  m_pcTrQuant          = pcTrQuant;
+  m_pcRdCost           = pcRdCost;
+
+  m_pcEntropyCoder     = pcEntropyCoder;
+  m_pcBinCABAC         = NULL;
+
+#if JVET_C0024_QTBT
+  m_ppppcRDSbacCoder   = ppppcRDSbacCoder;
+#else
+  m_pppcRDSbacCoder    = pppcRDSbacCoder;
+#endif
+  m_pcRDGoOnSbacCoder  = pcRDGoOnSbacCoder;
+
+  m_pcRateCtrl         = pcRateCtrl;
+}
+#endif
+
 // ====================================================================================================================
 // Public member functions
 // ====================================================================================================================
@@ -801,7 +842,7 @@ Void TEncCu::compressCtu( TComDataCU* pCtu )
 
   // initialize CU data
 #if JVET_C0024_QTBT
-  pCtu->getPic()->setCodedAreaInCTU(0);
+  pCtu->getPic()->setCodedAreaInCTU(pCtu->getCtuRsAddr(), 0);
   UInt uiCTUSize = pCtu->getSlice()->getSPS()->getCTUSize();
   UInt uiWidthIdx = g_aucConvertToBit[uiCTUSize];
   UInt uiHeightIdx = g_aucConvertToBit[uiCTUSize];
@@ -864,7 +905,7 @@ Void TEncCu::compressCtu( TComDataCU* pCtu )
     {
       pCtu->getSlice()->setTextType(CHANNEL_TYPE_CHROMA);
       // initialize CU data
-      pCtu->getPic()->setCodedAreaInCTU(0);
+      pCtu->getPic()->setCodedAreaInCTU(pCtu->getCtuRsAddr(), 0);
       m_pppcBestCU[uiWidthIdx][uiHeightIdx]->initCtu( pCtu->getPic(), pCtu->getCtuRsAddr() );
       m_pppcTempCU[uiWidthIdx][uiHeightIdx]->initCtu( pCtu->getPic(), pCtu->getCtuRsAddr() );
 #if JVET_C0024_DELTA_QP_FIX
@@ -920,8 +961,8 @@ Void TEncCu::encodeCtu ( TComDataCU* pCtu )
   // Encode CU data
 #if JVET_C0024_QTBT
   UInt uiCTUSize = pCtu->getSlice()->getSPS()->getCTUSize();
-  pCtu->getPic()->setCodedAreaInCTU(0);
-  pCtu->getPic()->setCodedBlkInCTU(false, 0, 0, uiCTUSize>>MIN_CU_LOG2, uiCTUSize>>MIN_CU_LOG2); //only used for affine merge code or not
+  pCtu->getPic()->setCodedAreaInCTU(pCtu->getCtuRsAddr(), 0);
+  pCtu->getPic()->setCodedBlkInCTU(pCtu->getCtuRsAddr(), false, 0, 0, uiCTUSize>>MIN_CU_LOG2, uiCTUSize>>MIN_CU_LOG2); //only used for affine merge code or not
 
   xEncodeCU( pCtu, 0, 0, uiCTUSize, uiCTUSize );  
 #else
@@ -933,7 +974,7 @@ Void TEncCu::encodeCtu ( TComDataCU* pCtu )
   {
     pCtu->getSlice()->setTextType(CHANNEL_TYPE_CHROMA);
     // Encode CU data
-    pCtu->getPic()->setCodedAreaInCTU(0);
+    pCtu->getPic()->setCodedAreaInCTU(pCtu->getCtuRsAddr(), 0);
 #if JVET_C0024_DELTA_QP_FIX
     if (pCtu->getSlice()->getPPS()->getUseDQP())
     {
@@ -1074,7 +1115,7 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, const
 
   UInt uiPelXInCTU = rpcBestCU->getCUPelX() - rpcBestCU->getPic()->getCtu(rpcBestCU->getCtuRsAddr())->getCUPelX();
   UInt uiPelYInCTU = rpcBestCU->getCUPelY() - rpcBestCU->getPic()->getCtu(rpcBestCU->getCtuRsAddr())->getCUPelY();
-  rpcBestCU->getPic()->setCodedBlkInCTU(false, uiPelXInCTU>> MIN_CU_LOG2, uiPelYInCTU>> MIN_CU_LOG2, uiWidth>> MIN_CU_LOG2, uiHeight>> MIN_CU_LOG2 );  
+  rpcBestCU->getPic()->setCodedBlkInCTU(rpcBestCU->getCtuRsAddr(), false, uiPelXInCTU>> MIN_CU_LOG2, uiPelYInCTU>> MIN_CU_LOG2, uiWidth>> MIN_CU_LOG2, uiHeight>> MIN_CU_LOG2 );  
 #else
   m_ppcOrigYuv[uiDepth]->copyFromPicYuv( pcPic->getPicYuvOrg(), rpcBestCU->getCtuRsAddr(), rpcBestCU->getZorderIdxInCtu() );
 #endif
@@ -2517,8 +2558,8 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, const
       xCheckBestMode( rpcBestCU, rpcTempCU, uiDepth, uiWidth, uiHeight);
       rpcTempCU->initEstData( uiDepth, iQP, bIsLosslessMode, uiWidth, uiHeight, uiBTSplitMode );
 
-      rpcBestCU->getPic()->setCodedBlkInCTU(false, uiPelXInCTU>> MIN_CU_LOG2, uiPelYInCTU>> MIN_CU_LOG2, uiWidth>> MIN_CU_LOG2, uiHeight>> MIN_CU_LOG2 );  
-      rpcBestCU->getPic()->addCodedAreaInCTU(-(Int)uiWidth*uiHeight);
+      rpcBestCU->getPic()->setCodedBlkInCTU(rpcBestCU->getCtuRsAddr(), false, uiPelXInCTU>> MIN_CU_LOG2, uiPelYInCTU>> MIN_CU_LOG2, uiWidth>> MIN_CU_LOG2, uiHeight>> MIN_CU_LOG2 );  
+      rpcBestCU->getPic()->addCodedAreaInCTU(rpcBestCU->getCtuRsAddr(), -(Int)uiWidth*uiHeight);
     }
 #if JVET_D0077_SAVE_LOAD_ENC_INFO
     if( dCostTempBest > dHorSplitCost )
@@ -2685,8 +2726,8 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, const
       xCheckBestMode( rpcBestCU, rpcTempCU, uiDepth, uiWidth, uiHeight);
       rpcTempCU->initEstData( uiDepth, iQP, bIsLosslessMode, uiWidth, uiHeight, uiBTSplitMode );
 
-      rpcBestCU->getPic()->setCodedBlkInCTU(false, uiPelXInCTU>> MIN_CU_LOG2, uiPelYInCTU>> MIN_CU_LOG2, uiWidth>> MIN_CU_LOG2, uiHeight>> MIN_CU_LOG2 );  
-      rpcBestCU->getPic()->addCodedAreaInCTU(-(Int)uiWidth*uiHeight);
+      rpcBestCU->getPic()->setCodedBlkInCTU(rpcBestCU->getCtuRsAddr(), false, uiPelXInCTU>> MIN_CU_LOG2, uiPelYInCTU>> MIN_CU_LOG2, uiWidth>> MIN_CU_LOG2, uiHeight>> MIN_CU_LOG2 );  
+      rpcBestCU->getPic()->addCodedAreaInCTU(rpcBestCU->getCtuRsAddr(), -(Int)uiWidth*uiHeight);
     }
 #if JVET_D0077_SAVE_LOAD_ENC_INFO
     if( dCostTempBest > dVerSplitCost )
@@ -2837,7 +2878,7 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, const
             pcSubBestPartCU->copyToPic( uhNextDepth, uiWidth>>1, uiHeight>>1 );
             rpcTempCU->copyPartFrom( pcSubBestPartCU, uiPartUnitIdx, uhNextDepth, uiWidth>>1, uiHeight>>1 );
 
-            rpcBestCU->getPic()->addCodedAreaInCTU(uiWidth*uiHeight>>2);
+            rpcBestCU->getPic()->addCodedAreaInCTU(rpcBestCU->getCtuRsAddr(), uiWidth*uiHeight>>2);
 #else
           pcSubBestPartCU->copyToPic( uhNextDepth );
           rpcTempCU->copyPartFrom( pcSubBestPartCU, uiPartUnitIdx, uhNextDepth );
@@ -2973,8 +3014,8 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, const
 
 #if JVET_C0024_QTBT
         xCheckBestMode( rpcBestCU, rpcTempCU, uiDepth, uiWidth, uiHeight DEBUG_STRING_PASS_INTO(sDebug) DEBUG_STRING_PASS_INTO(sTempDebug) DEBUG_STRING_PASS_INTO(false) ); // RD compare current larger prediction
-        rpcBestCU->getPic()->setCodedBlkInCTU(false, uiPelXInCTU>>MIN_CU_LOG2, uiPelYInCTU>>MIN_CU_LOG2, uiWidth>>MIN_CU_LOG2, uiHeight>>MIN_CU_LOG2 );  
-        rpcBestCU->getPic()->addCodedAreaInCTU(-(Int)uiWidth*uiHeight);
+        rpcBestCU->getPic()->setCodedBlkInCTU(rpcBestCU->getCtuRsAddr(), false, uiPelXInCTU>>MIN_CU_LOG2, uiPelYInCTU>>MIN_CU_LOG2, uiWidth>>MIN_CU_LOG2, uiHeight>>MIN_CU_LOG2 );  
+        rpcBestCU->getPic()->addCodedAreaInCTU(rpcBestCU->getCtuRsAddr(), -(Int)uiWidth*uiHeight);
 #else
       xCheckBestMode( rpcBestCU, rpcTempCU, uiDepth DEBUG_STRING_PASS_INTO(sDebug) DEBUG_STRING_PASS_INTO(sTempDebug) DEBUG_STRING_PASS_INTO(false) ); // RD compare current larger prediction
 #endif
@@ -2986,8 +3027,8 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, const
 
 #if JVET_C0024_QTBT
   rpcBestCU->copyToPic(uiDepth, uiWidth, uiHeight);                                                     // Copy Best data to Picture for next partition prediction.
-  rpcBestCU->getPic()->setCodedBlkInCTU(true, uiPelXInCTU>>MIN_CU_LOG2, uiPelYInCTU>>MIN_CU_LOG2, uiWidth>>MIN_CU_LOG2, uiHeight>>MIN_CU_LOG2 );  
-  rpcBestCU->getPic()->addCodedAreaInCTU(uiWidth*uiHeight);
+  rpcBestCU->getPic()->setCodedBlkInCTU(rpcBestCU->getCtuRsAddr(), true, uiPelXInCTU>>MIN_CU_LOG2, uiPelYInCTU>>MIN_CU_LOG2, uiWidth>>MIN_CU_LOG2, uiHeight>>MIN_CU_LOG2 );  
+  rpcBestCU->getPic()->addCodedAreaInCTU(rpcBestCU->getCtuRsAddr(), uiWidth*uiHeight);
   xCopyYuv2Pic( rpcBestCU->getPic(), rpcBestCU->getCtuRsAddr(), rpcBestCU->getZorderIdxInCtu(), uiDepth, uiDepth, uiWidth, uiHeight );   // Copy Yuv data to picture Yuv
 #else
   rpcBestCU->copyToPic(uiDepth);                                                     // Copy Best data to Picture for next partition prediction.
@@ -3217,7 +3258,7 @@ Void TEncCu::xEncodeCU( TComDataCU* pcCU, UInt uiAbsPartIdx, UInt uiDepth )
 #if JVET_C0024_QTBT
       else
       {
-        pcCU->getPic()->addCodedAreaInCTU(uiWidth*uiHeight>>2);
+        pcCU->getPic()->addCodedAreaInCTU(pcCU->getCtuRsAddr(), uiWidth*uiHeight>>2);
       }
 #endif
     }
@@ -3319,18 +3360,26 @@ Void TEncCu::xEncodeCU( TComDataCU* pcCU, UInt uiAbsPartIdx, UInt uiDepth )
     }
   }
 
-  pcCU->getPic()->addCodedAreaInCTU(uiWidth*uiHeight);
+  pcCU->getPic()->addCodedAreaInCTU(pcCU->getCtuRsAddr(), uiWidth*uiHeight);
   UInt uiBlkX = g_auiRasterToPelX[ g_auiZscanToRaster[uiAbsPartIdx] ] >> MIN_CU_LOG2;
   UInt uiBlkY = g_auiRasterToPelY[ g_auiZscanToRaster[uiAbsPartIdx] ] >> MIN_CU_LOG2;
-  pcCU->getPic()->setCodedBlkInCTU(true, uiBlkX, uiBlkY, uiWidth>> MIN_CU_LOG2, uiHeight>> MIN_CU_LOG2);
+  pcCU->getPic()->setCodedBlkInCTU(pcCU->getCtuRsAddr(), true, uiBlkX, uiBlkY, uiWidth>> MIN_CU_LOG2, uiHeight>> MIN_CU_LOG2);
 
 #endif
 
 #if JVET_C0024_AMAX_BT
   if (!pcCU->getSlice()->isIntra())
   {
+#if PARALLEL_SEGMENT_ENCODING
+    m_uiBlkSize[pcCU->getSlice()->getDepth()] += uiWidth*uiHeight;
+    m_uiNumBlk[pcCU->getSlice()->getDepth()]++;
+#else
+#if PARALLEL_SUBSTREAM_ENCODING
+    std::lock_guard<std::mutex> lock(g_blkStatsMutex);
+#endif
     g_uiBlkSize[pcCU->getSlice()->getDepth()] += uiWidth*uiHeight;
     g_uiNumBlk[pcCU->getSlice()->getDepth()]++;
+#endif
   }
 #endif
 #if JVET_C0024_DELTA_QP_FIX
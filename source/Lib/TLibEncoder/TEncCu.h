@@ -153,6 +153,10 @@ private:
 #endif
   TEncSbac*               m_pcRDGoOnSbacCoder;
   TEncRateCtrl*           m_pcRateCtrl;
+#if JVET_C0024_AMAX_BT && PARALLEL_SEGMENT_ENCODING
+  UInt                    m_uiBlkSize[10];     ///< area of the inter-slice CUs coded by this encoder, per temporal layer
+  UInt                    m_uiNumBlk[10];      ///< number of inter-slice CUs coded by this encoder, per temporal layer
+#endif
 
 #if COM16_C806_VCEG_AZ10_SUB_PU_TMVP
   //ATMVP 
@@ -168,6 +172,16 @@ private:
 public:
   /// copy parameters from encoder class
   Void  init                ( TEncTop* pcEncTop );
+#if PARALLEL_SUBSTREAM_ENCODING
+  /// use the given search, transform and entropy coding state instead of the one of the encoder class (substream encoding threads)
+#if JVET_C0024_QTBT
+  Void  init                ( TEncCfg* pcEncCfg, TEncSearch* pcPredSearch, TComTrQuant* pcTrQuant, TComRdCost* pcRdCost, TEncEntropy* pcEntropyCoder,
+                              TEncSbac**** ppppcRDSbacCoder, TEncSbac* pcRDGoOnSbacCoder, TEncRateCtrl* pcRateCtrl );
+#else
+  Void  init                ( TEncCfg* pcEncCfg, TEncSearch* pcPredSearch, TComTrQuant* pcTrQuant, TComRdCost* pcRdCost, TEncEntropy* pcEntropyCoder,
+                              TEncSbac*** pppcRDSbacCoder, TEncSbac* pcRDGoOnSbacCoder, TEncRateCtrl* pcRateCtrl );
+#endif
+#endif
 
   /// create internal buffers
   Void  create              ( UChar uhTotalDepth, UInt iMaxWidth, UInt iMaxHeight, ChromaFormat chromaFormat );
@@ -184,6 +198,15 @@ public:
   Int   updateCtuDataISlice ( TComDataCU* pCtu, Int width, Int height );
 
   Void setFastDeltaQp       ( Bool b)                 { m_bFastDeltaQP = b;         }
+#if JVET_C0024_AMAX_BT && PARALLEL_SEGMENT_ENCODING
+  UInt  getBlkSize          ( Int iLayer ) const      { return m_uiBlkSize[iLayer]; }
+  UInt  getNumBlk           ( Int iLayer ) const      { return m_uiNumBlk[iLayer];  }
+  Void  clearBlkStats       ( Int iLayer )            { m_uiBlkSize[iLayer] = 0; m_uiNumBlk[iLayer] = 0; }
+  Void  clearBlkStats       ()                        { ::memset( m_uiBlkSize, 0, sizeof(m_uiBlkSize) ); ::memset( m_uiNumBlk, 0, sizeof(m_uiNumBlk) ); }
+#if PARALLEL_PICTURE_ENCODING
+  Void  addBlkStats         ( Int iLayer, UInt uiBlkSize, UInt uiNumBlk ) { m_uiBlkSize[iLayer] += uiBlkSize; m_uiNumBlk[iLayer] += uiNumBlk; }
+#endif
+#endif
 
 protected:
   Void  finishCU            ( TComDataCU*  pcCU, UInt uiAbsPartIdx );
@@ -185,6 +185,15 @@ TEncGOP::TEncGOP()
   m_bufferingPeriodSEIPresentInAU = false;
   m_associatedIRAPType = NAL_UNIT_CODED_SLICE_IDR_N_LP;
   m_associatedIRAPPOC  = 0;
+#if PARALLEL_SEGMENT_ENCODING
+#if ALF_HM3_REFACTOR && COM16_C806_ALF_TEMPPRED_NUM
+  m_iStoredAlfParaNum  = 0;
+#endif
+#if JVET_C0024_AMAX_BT && JVET_C0024_AMAX_BT_FIX
+  m_uiPrevISlicePOC    = 0;
+  m_bInitAMaxBT        = false;
+#endif
+#endif
   return;
 }
 
@@ -192,7 +201,7 @@ TEncGOP::~TEncGOP()
 {
 }
 
-#if COM16_C806_ALF_TEMPPRED_NUM
+#if COM16_C806_ALF_TEMPPRED_NUM && !PARALLEL_SEGMENT_ENCODING
 Int TEncGOP::m_iStoredAlfParaNum = 0;
 #endif
 
@@ -206,6 +215,14 @@ Void  TEncGOP::create()
 
 Void  TEncGOP::destroy()
 {
+#if PARALLEL_PICTURE_ENCODING
+  for (UInt i = 0; i < m_pictureEncoders.size(); i++)
+  {
+    m_pictureEncoders[i]->destroy();
+    delete m_pictureEncoders[i];
+  }
+  m_pictureEncoders.clear();
+#endif
 #if COM16_C806_ALF_TEMPPRED_NUM
   if( m_pcCfg->getUseALF() )
   {
@@ -1122,6 +1139,25 @@ static UInt calculateCollocatedFromL1Flag(TEncCfg *pCfg, const Int GOPid, const
 }
 #endif
 
+#if PARALLEL_PICTURE_ENCODING
+/** Returns whether the picture is used for reference by the slice. Long-term reference pictures, identified by
+ *  their POC LSBs only, are not distinguished: the picture is then assumed to be used.
+ */
+static Bool isUsedByCurrPic( TComSlice* pcSlice, TComPic* pcPic )
+{
+  const TComReferencePictureSet* pcRPS = pcSlice->getRPS();
+  const Int iNumShortTerm = pcRPS->getNumberOfNegativePictures() + pcRPS->getNumberOfPositivePictures();
+  for (Int i = 0; i < pcRPS->getNumberOfPictures(); i++)
+  {
+    if (pcRPS->getUsed(i) && (i >= iNumShortTerm || pcSlice->getPOC() + pcRPS->getDeltaPOC(i) == pcPic->getPOC()))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+#endif
 // ====================================================================================================================
 // Public member functions
 // ====================================================================================================================
@@ -1153,7 +1189,6 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
   SEIMessages nestedSeiMessages;
   SEIMessages duInfoSeiMessages;
   SEIMessages trailingSeiMessages;
-  std::deque<DUData> duData;
   SEIDecodingUnitInfo decodingUnitInfoSEI;
 
   EfficientFieldIRAPMapping effFieldIRAPMap;
@@ -1168,6 +1203,50 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     m_pcCfg->setEncodedFlag(iGOPid, false);
   }
 
+  // prepared pictures whose access unit is not written yet, in coding order
+  std::list<GOPPicture> pendingPictures;
+  UInt uiMaxPendingPictures = 1;
+#if PARALLEL_PICTURE_ENCODING
+  const Bool bParallelPictures = m_pcCfg->getNumPictureThreads() > 1;
+  UInt uiNumDispatchedPictures = 0;
+  if (bParallelPictures)
+  {
+    xCreatePictureEncoders( isField );
+    uiMaxPendingPictures = UInt(m_pictureEncoders.size());
+  }
+  // the pictures of a GOP are compressed in parallel with the coding statistics at its start, whatever the number of threads:
+  // the statistics the access units are entropy coded with are only final once the previous pictures in coding order are written
+#if VCEG_AZ07_BAC_ADAPT_WDOW || VCEG_AZ07_INIT_PREVFRAME
+  TComStats* pcGOPStats = bParallelPictures ? new TComStats( *m_apcStats ) : NULL;
+#endif
+#if JVET_C0024_AMAX_BT
+  // block statistics per temporal layer of the previous GOP, from which the maximum BT size of the inter pictures is selected
+  UInt auiGOPBlkSize[10] = { 0 };
+  UInt auiGOPNumBlk[10]  = { 0 };
+  if (bParallelPictures)
+  {
+    for (Int iLayer = 0; iLayer < 10; iLayer++)
+    {
+      m_pcSliceEncoder->getBlkStats( iLayer, auiGOPBlkSize[iLayer], auiGOPNumBlk[iLayer] );
+    }
+    m_pcSliceEncoder->clearBlkStats();
+  }
+#endif
+#endif
+  auto finishOldestPicture = [&]()
+  {
+    xFinishPicture( pendingPictures.front(), rcListPic, isField, isTff, snr_conversion, printFrameMSE,
+                    leadingSeiMessages, nestedSeiMessages, duInfoSeiMessages, trailingSeiMessages, pcBitstreamRedirect
+#if ALF_HM3_REFACTOR
+                  , cAlfParam, bInitAlfParam
+#endif
+#if VCEG_AZ07_BAC_ADAPT_WDOW || VCEG_AZ07_INIT_PREVFRAME
+                  , m_apcStats
+#endif
+                  );
+    pendingPictures.pop_front();
+  };
+
   for ( Int iGOPid=0; iGOPid < m_iGopSize; iGOPid++ )
   {
     if (m_pcCfg->getEfficientFieldIRAPEnabled())
@@ -1175,6 +1254,11 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       iGOPid=effFieldIRAPMap.adjustGOPid(iGOPid);
     }
 
+    while (pendingPictures.size() >= uiMaxPendingPictures)
+    {
+      finishOldestPicture();
+    }
+
     //-- For time output for each slice
     clock_t iBeforeTime = clock();
 
@@ -1219,13 +1303,25 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     AccessUnit& accessUnit = accessUnitsInGOP.back();
     xGetBuffer( rcListPic, rcListPicYuvRecOut, iNumPicRcvd, iTimeOffset, pcPic, pcPicYuvRecOut, pocCurr, isField );
 
+    TEncSlice* pcSliceEncoder = m_pcSliceEncoder;
+#if PARALLEL_PICTURE_ENCODING
+    TEncTop* pcPictureEncoder = NULL;
+    if (bParallelPictures)
+    {
+      // the previous picture of this encoder has been written, as at most uiMaxPendingPictures pictures are pending
+      pcPictureEncoder = m_pictureEncoders[uiNumDispatchedPictures % m_pictureEncoders.size()];
+      pcPictureEncoder->getGOPEncoder()->m_iGopSize = m_iGopSize;
+      pcSliceEncoder = pcPictureEncoder->getSliceEncoder();
+    }
+#endif
+
     //  Slice data initialization
     pcPic->clearSliceBuffer();
     pcPic->allocateNewSlice();
-    m_pcSliceEncoder->setSliceIdx(0);
+    pcSliceEncoder->setSliceIdx(0);
     pcPic->setCurrSliceIdx(0);
 
-    m_pcSliceEncoder->initEncSlice ( pcPic, iPOCLast, pocCurr, iGOPid, pcSlice, isField );
+    pcSliceEncoder->initEncSlice ( pcPic, iPOCLast, pocCurr, iGOPid, pcSlice, isField );
 
     //Set Frame/Field coding
     pcSlice->getPic()->setField(isField);
@@ -1280,15 +1376,6 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       pcSlice->setAssociatedIRAPPOC(m_associatedIRAPPOC);
     }
     // Do decoding refresh marking if any
-#if FIX_TICKET12 
-    if( pcSlice->getSPS()->getUseALF() )
-    {
-      if( m_pcAdaptiveLoopFilter->refreshAlfTempPred( pcSlice->getNalUnitType() , pcSlice->getPOC() ) )
-      {
-        m_iStoredAlfParaNum = 0;
-      }
-    }
-#endif
     pcSlice->decodingRefreshMarking(m_pocCRA, m_bRefreshPending, rcListPic, m_pcCfg->getEfficientFieldIRAPEnabled());
     m_pcEncTop->selectReferencePictureSet(pcSlice, pocCurr, iGOPid);
     if (!m_pcCfg->getEfficientFieldIRAPEnabled())
@@ -1386,6 +1473,27 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     pcSlice->setNumRefIdx(REF_PIC_LIST_0,min(m_pcCfg->getGOPEntry(iGOPid).m_numRefPicsActive,pcSlice->getRPS()->getNumberOfPictures()));
     pcSlice->setNumRefIdx(REF_PIC_LIST_1,min(m_pcCfg->getGOPEntry(iGOPid).m_numRefPicsActive,pcSlice->getRPS()->getNumberOfPictures()));
 
+#if PARALLEL_PICTURE_ENCODING
+    if (bParallelPictures)
+    {
+      // the reference pictures have to be final: write the access units up to the last pending reference picture
+      UInt uiNumToFinish = 0;
+      UInt uiPendingIdx  = 0;
+      for (std::list<GOPPicture>::iterator it = pendingPictures.begin(); it != pendingPictures.end(); it++)
+      {
+        uiPendingIdx++;
+        if (isUsedByCurrPic( pcSlice, it->pcPic ))
+        {
+          uiNumToFinish = uiPendingIdx;
+        }
+      }
+      while (uiNumToFinish-- > 0)
+      {
+        finishOldestPicture();
+      }
+    }
+#endif
+
     //  Set reference list
     pcSlice->setRefPicList ( rcListPic );
 
@@ -1395,6 +1503,21 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       Int refLayer=pcSlice->getDepth();
       if( refLayer>9) refLayer=9; // Max layer is 10  
 #if JVET_C0024_AMAX_BT_FIX
+#if PARALLEL_SEGMENT_ENCODING
+      if( m_bInitAMaxBT && pcSlice->getPOC() > m_uiPrevISlicePOC )
+      {
+#if PARALLEL_PICTURE_ENCODING
+        if (bParallelPictures)
+        {
+          ::memset( auiGOPBlkSize, 0, sizeof(auiGOPBlkSize) );
+          ::memset( auiGOPNumBlk, 0, sizeof(auiGOPNumBlk) );
+        }
+        else
+#endif
+        m_pcSliceEncoder->clearBlkStats();
+        m_bInitAMaxBT = false;
+      }
+#else
       if( g_bInitAMaxBT && pcSlice->getPOC() > g_uiPrevISlicePOC )
       {
         ::memset( g_uiBlkSize, 0, sizeof(g_uiBlkSize) );
@@ -1402,9 +1525,29 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
         g_bInitAMaxBT = false;
       }
 #endif
+#endif
+#if PARALLEL_SEGMENT_ENCODING
+      UInt uiBlkSize = 0, uiNumBlk = 0;
+      if (refLayer >= 0)
+      {
+#if PARALLEL_PICTURE_ENCODING
+        if (bParallelPictures)
+        {
+          uiBlkSize = auiGOPBlkSize[refLayer];
+          uiNumBlk  = auiGOPNumBlk[refLayer];
+        }
+        else
+#endif
+        m_pcSliceEncoder->getBlkStats( refLayer, uiBlkSize, uiNumBlk );
+      }
+      if (refLayer >= 0 && uiNumBlk != 0) 
+      {
+        Double dBlkSize = sqrt((Double)uiBlkSize/uiNumBlk);
+#else
       if (refLayer >= 0 && g_uiNumBlk[refLayer] != 0) 
       {
         Double dBlkSize = sqrt((Double)g_uiBlkSize[refLayer]/g_uiNumBlk[refLayer]);
+#endif
         if (dBlkSize < AMAXBT_TH32)
         {
           pcSlice->setMaxBTSize(32>MAX_BT_SIZE_INTER ? MAX_BT_SIZE_INTER: 32);
@@ -1421,22 +1564,50 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
         printf("\n previous layer=%d, avg blk size = %3.2f, current max BT set to %d\n", refLayer, dBlkSize, pcSlice->getMaxBTSize());
 #endif
 
+#if PARALLEL_SEGMENT_ENCODING
+#if PARALLEL_PICTURE_ENCODING
+        // the statistics of the pictures written meanwhile belong to the snapshot of the next GOP
+        if (!bParallelPictures)
+#endif
+        m_pcSliceEncoder->clearBlkStats( refLayer );
+#else
         g_uiBlkSize[refLayer] = 0;
         g_uiNumBlk[refLayer] = 0;
+#endif
       }
     }
 #if JVET_C0024_AMAX_BT_FIX
     else
     {
 #if JVET_C0024_AMAX_BT_FIX_TICKET23
+#if PARALLEL_SEGMENT_ENCODING
+      if( m_bInitAMaxBT  )
+      {
+#if PARALLEL_PICTURE_ENCODING
+        if (bParallelPictures)
+        {
+          ::memset( auiGOPBlkSize, 0, sizeof(auiGOPBlkSize) );
+          ::memset( auiGOPNumBlk, 0, sizeof(auiGOPNumBlk) );
+        }
+        else
+#endif
+        m_pcSliceEncoder->clearBlkStats();
+      }
+#else
       if( g_bInitAMaxBT  )
       {
         ::memset( g_uiBlkSize, 0, sizeof(g_uiBlkSize) );
         ::memset( g_uiNumBlk, 0, sizeof(g_uiNumBlk) );
       }
 #endif
+#endif
+#if PARALLEL_SEGMENT_ENCODING
+      m_uiPrevISlicePOC = pcSlice->getPOC();
+      m_bInitAMaxBT = true;
+#else
       g_uiPrevISlicePOC = pcSlice->getPOC();
       g_bInitAMaxBT = true;
+#endif
     }
 #endif
 #endif
@@ -1548,7 +1719,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     //  Slice compression
     if (m_pcCfg->getUseASR())
     {
-      m_pcSliceEncoder->setSearchRange(pcSlice);
+      pcSliceEncoder->setSearchRange(pcSlice);
     }
 
     Bool bGPBcheck=false;
@@ -1580,10 +1751,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
 
 
     Double lambda            = 0.0;
-    Int actualHeadBits       = 0;
-    Int actualTotalBits      = 0;
     Int estimatedBits        = 0;
-    Int tmpBitsBeforeWriting = 0;
     if ( m_pcCfg->getUseRateCtrl() ) // TODO: does this work with multiple slices and slice-segments?
     {
       Int frameLevel = m_pcRateCtrl->getRCSeq()->getGOPID2Level( iGOPid );
@@ -1607,7 +1775,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       }
       else if ( frameLevel == 0 )   // intra case, but use the model
       {
-        m_pcSliceEncoder->calCostSliceI(pcPic); // TODO: This only analyses the first slice segment - what about the others?
+        pcSliceEncoder->calCostSliceI(pcPic); // TODO: This only analyses the first slice segment - what about the others?
 
         if ( m_pcCfg->getIntraPeriod() != 1 )   // do not refine allocated bits for all intra case
         {
@@ -1635,442 +1803,577 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       sliceQP = Clip3( -pcSlice->getSPS()->getQpBDOffset(CHANNEL_TYPE_LUMA), MAX_QP, sliceQP );
       m_pcRateCtrl->getRCPic()->setPicEstQP( sliceQP );
 
-      m_pcSliceEncoder->resetQP( pcPic, sliceQP, lambda );
+      pcSliceEncoder->resetQP( pcPic, sliceQP, lambda );
     }
 
-    UInt uiNumSliceSegments = 1;
+    pendingPictures.push_back(GOPPicture());
+    GOPPicture& rcPicture = pendingPictures.back();
+    rcPicture.iGOPid         = iGOPid;
+    rcPicture.iIRAPGOPid     = m_pcCfg->getEfficientFieldIRAPEnabled()?effFieldIRAPMap.GetIRAPGOPid():0;
+    rcPicture.pcPic          = pcPic;
+    rcPicture.pcPicYuvRecOut = pcPicYuvRecOut;
+    rcPicture.pcAccessUnit   = &accessUnit;
+    rcPicture.iBeforeTime    = iBeforeTime;
+    rcPicture.pcSliceEncoder = pcSliceEncoder;
+#if VCEG_AZ07_BAC_ADAPT_WDOW || VCEG_AZ07_INIT_PREVFRAME
+    rcPicture.pcStats        = m_apcStats;
+#endif
+    rcPicture.dLambda        = lambda;
+    rcPicture.iEstimatedBits = estimatedBits;
+    rcPicture.bReferenced    = pcSlice->isReferenced();
+#if PARALLEL_PICTURE_ENCODING
+    if (bParallelPictures)
+    {
+      rcPicture.pcEncoder = pcPictureEncoder;
+#if VCEG_AZ07_BAC_ADAPT_WDOW || VCEG_AZ07_INIT_PREVFRAME
+      rcPicture.pcStats   = new TComStats( *pcGOPStats );
+#endif
+      rcPicture.cThread   = std::thread( &TEncGOP::xCompressPicture, this, std::ref( rcPicture ) );
+      uiNumDispatchedPictures++;
+    }
+    else
+#endif
+    {
+      xCompressPicture( rcPicture );
+    }
 
-    // Allocate some coders, now the number of tiles are known.
-    const Int numSubstreamsColumns = (pcSlice->getPPS()->getNumTileColumnsMinus1() + 1);
-    const Int numSubstreamRows     = pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag() ? pcPic->getFrameHeightInCtus() : (pcSlice->getPPS()->getNumTileRowsMinus1() + 1);
-    const Int numSubstreams        = numSubstreamRows * numSubstreamsColumns;
-    std::vector<TComOutputBitstream> substreamsOut(numSubstreams);
+    if (m_pcCfg->getEfficientFieldIRAPEnabled())
+    {
+      iGOPid=effFieldIRAPMap.restoreGOPid(iGOPid);
+    }
+  } // iGOPid-loop
 
-#if VCEG_AZ07_FRUC_MERGE
-    if( pcSlice->getSPS()->getUseFRUCMgrMode() && !pcSlice->isIntra() )
+  while (!pendingPictures.empty())
+  {
+    finishOldestPicture();
+  }
+#if PARALLEL_PICTURE_ENCODING && ( VCEG_AZ07_BAC_ADAPT_WDOW || VCEG_AZ07_INIT_PREVFRAME )
+  delete pcGOPStats;
+#endif
+#if KLT_ON_DEMAND_SUBPEL_PLANES
+  // the pictures that are no longer referenced are not searched by the inter KLT anymore
+  for (TComList<TComPic*>::iterator iterPic = rcListPic.begin(); iterPic != rcListPic.end(); iterPic++)
+  {
+    if (!(*iterPic)->getSlice(0)->isReferenced())
     {
-      pcPic->initFRUCMVP();
+      (*iterPic)->releaseQuaPicYuvRec();
     }
+  }
+#endif
+
+  delete pcBitstreamRedirect;
+#if ALF_HM3_REFACTOR
+  if( pcSlice->getSPS()->getUseALF() )
+  {
+    m_pcAdaptiveLoopFilter->freeALFParam(&cAlfParam);
+  }
+#endif
+  assert ( (m_iNumPicCoded == iNumPicRcvd) );
+}
+
+/** Compresses (trial encodes) the slice segments of a prepared picture, on the calling thread or on a picture encoding thread.
+ */
+Void TEncGOP::xCompressPicture( GOPPicture& rcPicture )
+{
+  TComPic*   pcPic          = rcPicture.pcPic;
+  TEncSlice* pcSliceEncoder = rcPicture.pcSliceEncoder;
+  TComSlice* pcSlice        = pcPic->getSlice(0);
+  UInt uiNumSliceSegments   = 1;
+
+#if VCEG_AZ07_FRUC_MERGE
+  if( pcSlice->getSPS()->getUseFRUCMgrMode() && !pcSlice->isIntra() )
+  {
+    pcPic->initFRUCMVP();
+  }
 #endif
 
 #if JVET_D0033_ADAPTIVE_CLIPPING
-        // set adaptive clipping bounds for current slice
-        if (m_pcCfg->getTchClipParam().isActive ) {
-
-            Int tbd;
-            if (pcSlice->getSliceType() == I_SLICE) tbd=-1;
-            else                                    tbd=pcSlice->getDepth();
-            Int delta_disto_luma,delta_disto_chroma;
-            ClipParam prm=pcPic->computeTchClipParam(delta_disto_luma,delta_disto_chroma);
-
-            prm=codingChoice(prm,delta_disto_luma,delta_disto_chroma,pcPic->getSlice(0)->getLambdas()[0],pcPic->getSlice(0)->getLambdas()[1],tbd);
-            if (prm.isActive) {
-                pcPic->m_aclip_prm     = prm;
-            } else {
-                setOff(pcPic->m_aclip_prm);
-            }
-        } else {
-            setOff(pcPic->m_aclip_prm); // OFF with defaults val
-        }
-        g_ClipParam =pcPic->m_aclip_prm; // set the global for access from clipBD
+      // set adaptive clipping bounds for current slice
+      if (m_pcCfg->getTchClipParam().isActive ) {
+
+          Int tbd;
+          if (pcSlice->getSliceType() == I_SLICE) tbd=-1;
+          else                                    tbd=pcSlice->getDepth();
+          Int delta_disto_luma,delta_disto_chroma;
+          ClipParam prm=pcPic->computeTchClipParam(delta_disto_luma,delta_disto_chroma);
+
+          prm=codingChoice(prm,delta_disto_luma,delta_disto_chroma,pcPic->getSlice(0)->getLambdas()[0],pcPic->getSlice(0)->getLambdas()[1],tbd);
+          if (prm.isActive) {
+              pcPic->m_aclip_prm     = prm;
+          } else {
+              setOff(pcPic->m_aclip_prm);
+          }
+      } else {
+          setOff(pcPic->m_aclip_prm); // OFF with defaults val
+      }
+      g_ClipParam =pcPic->m_aclip_prm; // set the global for access from clipBD
 
 #endif
-    // now compress (trial encode) the various slice segments (slices, and dependent slices)
-    {
-      const UInt numberOfCtusInFrame=pcPic->getPicSym()->getNumberOfCtusInFrame();
-      pcSlice->setSliceCurStartCtuTsAddr( 0 );
-      pcSlice->setSliceSegmentCurStartCtuTsAddr( 0 );
+  // now compress (trial encode) the various slice segments (slices, and dependent slices)
+  {
+    const UInt numberOfCtusInFrame=pcPic->getPicSym()->getNumberOfCtusInFrame();
+    pcSlice->setSliceCurStartCtuTsAddr( 0 );
+    pcSlice->setSliceSegmentCurStartCtuTsAddr( 0 );
 
-      for(UInt nextCtuTsAddr = 0; nextCtuTsAddr < numberOfCtusInFrame; )
-      {
-        m_pcSliceEncoder->precompressSlice( pcPic );
+    for(UInt nextCtuTsAddr = 0; nextCtuTsAddr < numberOfCtusInFrame; )
+    {
+      pcSliceEncoder->precompressSlice( pcPic );
 #if VCEG_AZ07_BAC_ADAPT_WDOW || VCEG_AZ07_INIT_PREVFRAME
-        pcSlice->setStatsHandle( m_apcStats );
-        pcSlice->initStatsGlobal( );              
+      pcSlice->setStatsHandle( rcPicture.pcStats );
+      pcSlice->initStatsGlobal( );              
 #endif  
 
-        m_pcSliceEncoder->compressSlice   ( pcPic, false, false );
-
-        const UInt curSliceSegmentEnd = pcSlice->getSliceSegmentCurEndCtuTsAddr();
-        if (curSliceSegmentEnd < numberOfCtusInFrame)
+      pcSliceEncoder->compressSlice   ( pcPic, false, false );
+
+      const UInt curSliceSegmentEnd = pcSlice->getSliceSegmentCurEndCtuTsAddr();
+      if (curSliceSegmentEnd < numberOfCtusInFrame)
+      {
+        const Bool bNextSegmentIsDependentSlice=curSliceSegmentEnd<pcSlice->getSliceCurEndCtuTsAddr();
+        const UInt sliceBits=pcSlice->getSliceBits();
+        pcPic->allocateNewSlice();
+        // prepare for next slice
+        pcPic->setCurrSliceIdx                    ( uiNumSliceSegments );
+        pcSliceEncoder->setSliceIdx               ( uiNumSliceSegments   );
+        pcSlice = pcPic->getSlice                 ( uiNumSliceSegments   );
+        assert(pcSlice->getPPS()!=0);
+        pcSlice->copySliceInfo                    ( pcPic->getSlice(uiNumSliceSegments-1)  );
+        pcSlice->setSliceIdx                      ( uiNumSliceSegments   );
+        if (bNextSegmentIsDependentSlice)
         {
-          const Bool bNextSegmentIsDependentSlice=curSliceSegmentEnd<pcSlice->getSliceCurEndCtuTsAddr();
-          const UInt sliceBits=pcSlice->getSliceBits();
-          pcPic->allocateNewSlice();
-          // prepare for next slice
-          pcPic->setCurrSliceIdx                    ( uiNumSliceSegments );
-          m_pcSliceEncoder->setSliceIdx             ( uiNumSliceSegments   );
-          pcSlice = pcPic->getSlice                 ( uiNumSliceSegments   );
-          assert(pcSlice->getPPS()!=0);
-          pcSlice->copySliceInfo                    ( pcPic->getSlice(uiNumSliceSegments-1)  );
-          pcSlice->setSliceIdx                      ( uiNumSliceSegments   );
-          if (bNextSegmentIsDependentSlice)
-          {
-            pcSlice->setSliceBits(sliceBits);
-          }
-          else
-          {
-            pcSlice->setSliceCurStartCtuTsAddr      ( curSliceSegmentEnd );
-            pcSlice->setSliceBits(0);
-          }
-          pcSlice->setDependentSliceSegmentFlag(bNextSegmentIsDependentSlice);
-          pcSlice->setSliceSegmentCurStartCtuTsAddr ( curSliceSegmentEnd );
-          // TODO: optimise cabac_init during compress slice to improve multi-slice operation
-          // pcSlice->setEncCABACTableIdx(m_pcSliceEncoder->getEncCABACTableIdx());
-          uiNumSliceSegments ++;
+          pcSlice->setSliceBits(sliceBits);
         }
-        nextCtuTsAddr = curSliceSegmentEnd;
+        else
+        {
+          pcSlice->setSliceCurStartCtuTsAddr      ( curSliceSegmentEnd );
+          pcSlice->setSliceBits(0);
+        }
+        pcSlice->setDependentSliceSegmentFlag(bNextSegmentIsDependentSlice);
+        pcSlice->setSliceSegmentCurStartCtuTsAddr ( curSliceSegmentEnd );
+        // TODO: optimise cabac_init during compress slice to improve multi-slice operation
+        // pcSlice->setEncCABACTableIdx(m_pcSliceEncoder->getEncCABACTableIdx());
+        uiNumSliceSegments ++;
       }
+      nextCtuTsAddr = curSliceSegmentEnd;
     }
+  }
+  rcPicture.uiNumSliceSegments = uiNumSliceSegments;
+}
 
-    duData.clear();
-    pcSlice = pcPic->getSlice(0);
+/** Filters the compressed picture, writes its access unit and updates the statistics, in coding order.
+ */
+Void TEncGOP::xFinishPicture( GOPPicture& rcPicture, TComList<TComPic*>& rcListPic, Bool isField, Bool isTff, const InputColourSpaceConversion snr_conversion, const Bool printFrameMSE,
+                              SEIMessages& leadingSeiMessages, SEIMessages& nestedSeiMessages, SEIMessages& duInfoSeiMessages, SEIMessages& trailingSeiMessages, TComOutputBitstream* pcBitstreamRedirect
+#if ALF_HM3_REFACTOR
+                            , ALFParam& cAlfParam, Bool& bInitAlfParam
+#endif
+#if VCEG_AZ07_BAC_ADAPT_WDOW || VCEG_AZ07_INIT_PREVFRAME
+                            , TComStats* m_apcStats
+#endif
+                            )
+{
+  TComPic*     pcPic              = rcPicture.pcPic;
+  TComPicYuv*  pcPicYuvRecOut     = rcPicture.pcPicYuvRecOut;
+  AccessUnit&  accessUnit         = *rcPicture.pcAccessUnit;
+  const Int    iGOPid             = rcPicture.iGOPid;
+  const UInt   uiNumSliceSegments = rcPicture.uiNumSliceSegments;
+  TComSlice*   pcSlice            = pcPic->getSlice(0);
+  std::deque<DUData> duData;
+  Int actualHeadBits       = 0;
+  Int actualTotalBits      = 0;
+  Int tmpBitsBeforeWriting = 0;
 
-    // SAO parameter estimation using non-deblocked pixels for CTU bottom and right boundary areas
-    if( pcSlice->getSPS()->getUseSAO() && m_pcCfg->getSaoCtuBoundary() )
-    {
-      m_pcSAO->getPreDBFStatistics(pcPic);
-    }
+#if PARALLEL_PICTURE_ENCODING
+  if (rcPicture.pcEncoder != NULL)
+  {
+    rcPicture.cThread.join();
+#if JVET_D0033_ADAPTIVE_CLIPPING
+    g_ClipParam = pcPic->m_aclip_prm;
+#endif
+#if VCEG_AZ07_BAC_ADAPT_WDOW || VCEG_AZ07_INIT_PREVFRAME
+    // the entropy coding inherits the statistics of the previous pictures in coding order
+    pcSlice->setStatsHandle( m_apcStats );
+    pcSlice->initStatsGlobal( );
+    delete rcPicture.pcStats;
+    rcPicture.pcStats = NULL;
+#endif
+#if JVET_C0024_AMAX_BT
+    m_pcSliceEncoder->addBlkStats( rcPicture.pcSliceEncoder );
+#endif
+  }
+#endif
+  const Bool bReferenced = pcSlice->isReferenced();
+  pcSlice->setReferenced( rcPicture.bReferenced );
 
-    //-- Loop filter
-    Bool bLFCrossTileBoundary = pcSlice->getPPS()->getLoopFilterAcrossTilesEnabledFlag();
-    m_pcLoopFilter->setCfg(bLFCrossTileBoundary);
-    if ( m_pcCfg->getDeblockingFilterMetric() )
+#if FIX_TICKET12 
+  if( pcSlice->getSPS()->getUseALF() )
+  {
+    if( m_pcAdaptiveLoopFilter->refreshAlfTempPred( pcSlice->getNalUnitType() , pcSlice->getPOC() ) )
     {
-      applyDeblockingFilterMetric(pcPic, uiNumSliceSegments);
+      m_iStoredAlfParaNum = 0;
     }
-    m_pcLoopFilter->loopFilterPic( pcPic );
+  }
+#endif
 
-    /////////////////////////////////////////////////////////////////////////////////////////////////// File writing
-    // Set entropy coder
-    m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder );
+  // Allocate some coders, now the number of tiles are known.
+  const Int numSubstreamsColumns = (pcSlice->getPPS()->getNumTileColumnsMinus1() + 1);
+  const Int numSubstreamRows     = pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag() ? pcPic->getFrameHeightInCtus() : (pcSlice->getPPS()->getNumTileRowsMinus1() + 1);
+  const Int numSubstreams        = numSubstreamRows * numSubstreamsColumns;
+  std::vector<TComOutputBitstream> substreamsOut(numSubstreams);
+
+  // SAO parameter estimation using non-deblocked pixels for CTU bottom and right boundary areas
+  if( pcSlice->getSPS()->getUseSAO() && m_pcCfg->getSaoCtuBoundary() )
+  {
+    m_pcSAO->getPreDBFStatistics(pcPic);
+  }
+
+  //-- Loop filter
+  Bool bLFCrossTileBoundary = pcSlice->getPPS()->getLoopFilterAcrossTilesEnabledFlag();
+  m_pcLoopFilter->setCfg(bLFCrossTileBoundary);
+  if ( m_pcCfg->getDeblockingFilterMetric() )
+  {
+    applyDeblockingFilterMetric(pcPic, uiNumSliceSegments);
+  }
+  m_pcLoopFilter->loopFilterPic( pcPic );
+
+  /////////////////////////////////////////////////////////////////////////////////////////////////// File writing
+  // Set entropy coder
+  m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder );
 
 #if JVET_D0135_PARAMS
-    //if ( m_bSeqFirst || (m_pcCfg->getWriteParamSetsIDRFlag() && pcSlice->getIdrPicFlag()) )
-    if ( m_bSeqFirst || (m_pcCfg->getReWriteParamSetsFlag() && ( pcPic->getSlice(0)->getSliceType() == I_SLICE )))
+  //if ( m_bSeqFirst || (m_pcCfg->getWriteParamSetsIDRFlag() && pcSlice->getIdrPicFlag()) )
+  if ( m_bSeqFirst || (m_pcCfg->getReWriteParamSetsFlag() && ( pcPic->getSlice(0)->getSliceType() == I_SLICE )))
 #else
-      if ( m_bSeqFirst )
+    if ( m_bSeqFirst )
 #endif
-    {
-      // write various parameter sets
-      actualTotalBits += xWriteParameterSets(accessUnit, pcSlice);
+  {
+    // write various parameter sets
+    actualTotalBits += xWriteParameterSets(accessUnit, pcSlice);
 
-      // create prefix SEI messages at the beginning of the sequence
-      assert(leadingSeiMessages.empty());
-      xCreateIRAPLeadingSEIMessages(leadingSeiMessages, pcSlice->getSPS(), pcSlice->getPPS());
+    // create prefix SEI messages at the beginning of the sequence
+    assert(leadingSeiMessages.empty());
+    xCreateIRAPLeadingSEIMessages(leadingSeiMessages, pcSlice->getSPS(), pcSlice->getPPS());
 
-      m_bSeqFirst = false;
-    }
+    m_bSeqFirst = false;
+  }
 
-    // reset presence of BP SEI indication
-    m_bufferingPeriodSEIPresentInAU = false;
-    // create prefix SEI associated with a picture
-    xCreatePerPictureSEIMessages(iGOPid, leadingSeiMessages, nestedSeiMessages, pcSlice);
+  // reset presence of BP SEI indication
+  m_bufferingPeriodSEIPresentInAU = false;
+  // create prefix SEI associated with a picture
+  xCreatePerPictureSEIMessages(iGOPid, leadingSeiMessages, nestedSeiMessages, pcSlice);
 
-    /* use the main bitstream buffer for storing the marshalled picture */
-    m_pcEntropyCoder->setBitstream(NULL);
+  /* use the main bitstream buffer for storing the marshalled picture */
+  m_pcEntropyCoder->setBitstream(NULL);
 
-    pcSlice = pcPic->getSlice(0);
+  pcSlice = pcPic->getSlice(0);
 
-    if (pcSlice->getSPS()->getUseSAO())
-    {
-      Bool sliceEnabled[MAX_NUM_COMPONENT];
-      TComBitCounter tempBitCounter;
-      tempBitCounter.resetBits();
-      m_pcEncTop->getRDGoOnSbacCoder()->setBitstream(&tempBitCounter);
+  if (pcSlice->getSPS()->getUseSAO())
+  {
+    Bool sliceEnabled[MAX_NUM_COMPONENT];
+    TComBitCounter tempBitCounter;
+    tempBitCounter.resetBits();
+    m_pcEncTop->getRDGoOnSbacCoder()->setBitstream(&tempBitCounter);
 #if VCEG_AZ07_BAC_ADAPT_WDOW
-      m_pcSAO->setEntropyCoder(m_pcEntropyCoder);
+    m_pcSAO->setEntropyCoder(m_pcEntropyCoder);
 #endif
-      m_pcSAO->initRDOCabacCoder(m_pcEncTop->getRDGoOnSbacCoder(), pcSlice);
-      m_pcSAO->SAOProcess(pcPic, sliceEnabled, pcPic->getSlice(0)->getLambdas(), m_pcCfg->getTestSAODisableAtPictureLevel(), m_pcCfg->getSaoEncodingRate(), m_pcCfg->getSaoEncodingRateChroma(), m_pcCfg->getSaoCtuBoundary());
-      m_pcSAO->PCMLFDisableProcess(pcPic);
-      m_pcEncTop->getRDGoOnSbacCoder()->setBitstream(NULL);
+    m_pcSAO->initRDOCabacCoder(m_pcEncTop->getRDGoOnSbacCoder(), pcSlice);
+    m_pcSAO->SAOProcess(pcPic, sliceEnabled, pcPic->getSlice(0)->getLambdas(), m_pcCfg->getTestSAODisableAtPictureLevel(), m_pcCfg->getSaoEncodingRate(), m_pcCfg->getSaoEncodingRateChroma(), m_pcCfg->getSaoCtuBoundary());
+    m_pcSAO->PCMLFDisableProcess(pcPic);
+    m_pcEncTop->getRDGoOnSbacCoder()->setBitstream(NULL);
 
-      //assign SAO slice header
-      for(Int s=0; s< uiNumSliceSegments; s++)
-      {
-        pcPic->getSlice(s)->setSaoEnabledFlag(CHANNEL_TYPE_LUMA, sliceEnabled[COMPONENT_Y]);
-        assert(sliceEnabled[COMPONENT_Cb] == sliceEnabled[COMPONENT_Cr]);
-        pcPic->getSlice(s)->setSaoEnabledFlag(CHANNEL_TYPE_CHROMA, sliceEnabled[COMPONENT_Cb]);
-      }
+    //assign SAO slice header
+    for(Int s=0; s< uiNumSliceSegments; s++)
+    {
+      pcPic->getSlice(s)->setSaoEnabledFlag(CHANNEL_TYPE_LUMA, sliceEnabled[COMPONENT_Y]);
+      assert(sliceEnabled[COMPONENT_Cb] == sliceEnabled[COMPONENT_Cr]);
+      pcPic->getSlice(s)->setSaoEnabledFlag(CHANNEL_TYPE_CHROMA, sliceEnabled[COMPONENT_Cb]);
     }
+  }
 
 #if ALF_HM3_REFACTOR
-    if( pcSlice->getSPS()->getUseALF() )
+  if( pcSlice->getSPS()->getUseALF() )
+  {
+    m_pcAdaptiveLoopFilter->setNumCUsInFrame(pcPic);
+    TComBitCounter tempBitCounter;
+    tempBitCounter.resetBits();
+    m_pcEncTop->getRDGoOnSbacCoder()->setBitstream(&tempBitCounter);
+    m_pcEntropyCoder->setEntropyCoder ( m_pcEncTop->getRDGoOnSbacCoder() );
+    m_pcAdaptiveLoopFilter->startALFEnc(pcPic, m_pcEntropyCoder );
+    UInt64 uiDist, uiBits;
+    if( !bInitAlfParam )
     {
       m_pcAdaptiveLoopFilter->setNumCUsInFrame(pcPic);
-      TComBitCounter tempBitCounter;
-      tempBitCounter.resetBits();
-      m_pcEncTop->getRDGoOnSbacCoder()->setBitstream(&tempBitCounter);
-      m_pcEntropyCoder->setEntropyCoder ( m_pcEncTop->getRDGoOnSbacCoder() );
-      m_pcAdaptiveLoopFilter->startALFEnc(pcPic, m_pcEntropyCoder );
-      UInt64 uiDist, uiBits;
-      if( !bInitAlfParam )
-      {
-        m_pcAdaptiveLoopFilter->setNumCUsInFrame(pcPic);
-        m_pcAdaptiveLoopFilter->allocALFParam(&cAlfParam);
-        bInitAlfParam = true;
-      }
-      m_pcAdaptiveLoopFilter->resetALFParam( &cAlfParam );
-      m_pcAdaptiveLoopFilter->ALFProcess( &cAlfParam, pcPic->getSlice(0)->getLambdas()[0], pcPic->getSlice(0)->getLambdas()[1], uiDist, uiBits, cAlfParam.alf_max_depth
+      m_pcAdaptiveLoopFilter->allocALFParam(&cAlfParam);
+      bInitAlfParam = true;
+    }
+    m_pcAdaptiveLoopFilter->resetALFParam( &cAlfParam );
+    m_pcAdaptiveLoopFilter->ALFProcess( &cAlfParam, pcPic->getSlice(0)->getLambdas()[0], pcPic->getSlice(0)->getLambdas()[1], uiDist, uiBits, cAlfParam.alf_max_depth
 #if COM16_C806_ALF_TEMPPRED_NUM
 #if FIX_TICKET12
-        , (pcSlice->getSliceType()== I_SLICE ? NULL: m_acStoredAlfPara), m_iStoredAlfParaNum
+      , (pcSlice->getSliceType()== I_SLICE ? NULL: m_acStoredAlfPara), m_iStoredAlfParaNum
 #else
-        , m_acStoredAlfPara, m_iStoredAlfParaNum
+      , m_acStoredAlfPara, m_iStoredAlfParaNum
 #endif
 #endif
-        );
+      );
 #if COM16_C806_ALF_TEMPPRED_NUM
-      if( cAlfParam.alf_flag && !cAlfParam.temproalPredFlag && cAlfParam.filtNo >= 0 )
-      {
-        Int iIdx = m_iStoredAlfParaNum % COM16_C806_ALF_TEMPPRED_NUM;
-        m_iStoredAlfParaNum++;
-        m_acStoredAlfPara[iIdx].temproalPredFlag = false;
-        m_pcAdaptiveLoopFilter->copyALFParam( &m_acStoredAlfPara[iIdx], &cAlfParam );
+    if( cAlfParam.alf_flag && !cAlfParam.temproalPredFlag && cAlfParam.filtNo >= 0 )
+    {
+      Int iIdx = m_iStoredAlfParaNum % COM16_C806_ALF_TEMPPRED_NUM;
+      m_iStoredAlfParaNum++;
+      m_acStoredAlfPara[iIdx].temproalPredFlag = false;
+      m_pcAdaptiveLoopFilter->copyALFParam( &m_acStoredAlfPara[iIdx], &cAlfParam );
 #if JVET_C0038_GALF
-        m_pcAdaptiveLoopFilter->resetALFPredParam(&m_acStoredAlfPara[iIdx], (pcSlice->getSliceType()== I_SLICE? true: false));
+      m_pcAdaptiveLoopFilter->resetALFPredParam(&m_acStoredAlfPara[iIdx], (pcSlice->getSliceType()== I_SLICE? true: false));
 #endif
-      }
-#endif     
-      m_pcAdaptiveLoopFilter->endALFEnc();
     }
+#endif     
+    m_pcAdaptiveLoopFilter->endALFEnc();
+  }
 #endif
 
-    // pcSlice is currently slice 0.
-    std::size_t binCountsInNalUnits   = 0; // For implementation of cabac_zero_word stuffing (section 7.4.3.10)
-    std::size_t numBytesInVclNalUnits = 0; // For implementation of cabac_zero_word stuffing (section 7.4.3.10)
+  // pcSlice is currently slice 0.
+  std::size_t binCountsInNalUnits   = 0; // For implementation of cabac_zero_word stuffing (section 7.4.3.10)
+  std::size_t numBytesInVclNalUnits = 0; // For implementation of cabac_zero_word stuffing (section 7.4.3.10)
 
-    for( UInt sliceSegmentStartCtuTsAddr = 0, sliceIdxCount=0; sliceSegmentStartCtuTsAddr < pcPic->getPicSym()->getNumberOfCtusInFrame(); sliceIdxCount++, sliceSegmentStartCtuTsAddr=pcSlice->getSliceSegmentCurEndCtuTsAddr() )
+  for( UInt sliceSegmentStartCtuTsAddr = 0, sliceIdxCount=0; sliceSegmentStartCtuTsAddr < pcPic->getPicSym()->getNumberOfCtusInFrame(); sliceIdxCount++, sliceSegmentStartCtuTsAddr=pcSlice->getSliceSegmentCurEndCtuTsAddr() )
+  {
+    pcSlice = pcPic->getSlice(sliceIdxCount);
+    if(sliceIdxCount > 0 && pcSlice->getSliceType()!= I_SLICE)
     {
-      pcSlice = pcPic->getSlice(sliceIdxCount);
-      if(sliceIdxCount > 0 && pcSlice->getSliceType()!= I_SLICE)
-      {
-        pcSlice->checkColRefIdx(sliceIdxCount, pcPic);
-      }
-      pcPic->setCurrSliceIdx(sliceIdxCount);
-      m_pcSliceEncoder->setSliceIdx(sliceIdxCount);
+      pcSlice->checkColRefIdx(sliceIdxCount, pcPic);
+    }
+    pcPic->setCurrSliceIdx(sliceIdxCount);
+    m_pcSliceEncoder->setSliceIdx(sliceIdxCount);
 
-      pcSlice->setRPS(pcPic->getSlice(0)->getRPS());
-      pcSlice->setRPSidx(pcPic->getSlice(0)->getRPSidx());
+    pcSlice->setRPS(pcPic->getSlice(0)->getRPS());
+    pcSlice->setRPSidx(pcPic->getSlice(0)->getRPSidx());
 
-      for ( UInt ui = 0 ; ui < numSubstreams; ui++ )
-      {
-        substreamsOut[ui].clear();
-      }
+    for ( UInt ui = 0 ; ui < numSubstreams; ui++ )
+    {
+      substreamsOut[ui].clear();
+    }
 
-      m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder );
-      m_pcEntropyCoder->resetEntropy      ( pcSlice );
-      /* start slice NALunit */
-      OutputNALUnit nalu( pcSlice->getNalUnitType(), pcSlice->getTLayer() );
-      m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
+    m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder );
+    m_pcEntropyCoder->resetEntropy      ( pcSlice );
+    /* start slice NALunit */
+    OutputNALUnit nalu( pcSlice->getNalUnitType(), pcSlice->getTLayer() );
+    m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
 
-      pcSlice->setNoRaslOutputFlag(false);
-      if (pcSlice->isIRAP())
+    pcSlice->setNoRaslOutputFlag(false);
+    if (pcSlice->isIRAP())
+    {
+      if (pcSlice->getNalUnitType() >= NAL_UNIT_CODED_SLICE_BLA_W_LP && pcSlice->getNalUnitType() <= NAL_UNIT_CODED_SLICE_IDR_N_LP)
       {
-        if (pcSlice->getNalUnitType() >= NAL_UNIT_CODED_SLICE_BLA_W_LP && pcSlice->getNalUnitType() <= NAL_UNIT_CODED_SLICE_IDR_N_LP)
-        {
-          pcSlice->setNoRaslOutputFlag(true);
-        }
-        //the inference for NoOutputPriorPicsFlag
-        // KJS: This cannot happen at the encoder
-        if (!m_bFirst && pcSlice->isIRAP() && pcSlice->getNoRaslOutputFlag())
+        pcSlice->setNoRaslOutputFlag(true);
+      }
+      //the inference for NoOutputPriorPicsFlag
+      // KJS: This cannot happen at the encoder
+      if (!m_bFirst && pcSlice->isIRAP() && pcSlice->getNoRaslOutputFlag())
+      {
+        if (pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_CRA)
         {
-          if (pcSlice->getNalUnitType() == NAL_UNIT_CODED_SLICE_CRA)
-          {
-            pcSlice->setNoOutputPriorPicsFlag(true);
-          }
+          pcSlice->setNoOutputPriorPicsFlag(true);
         }
       }
+    }
 
-      pcSlice->setEncCABACTableIdx(m_pcSliceEncoder->getEncCABACTableIdx());
+    pcSlice->setEncCABACTableIdx(m_pcSliceEncoder->getEncCABACTableIdx());
 
-      tmpBitsBeforeWriting = m_pcEntropyCoder->getNumberOfWrittenBits();
-      m_pcEntropyCoder->encodeSliceHeader(pcSlice);
+    tmpBitsBeforeWriting = m_pcEntropyCoder->getNumberOfWrittenBits();
+    m_pcEntropyCoder->encodeSliceHeader(pcSlice);
 #if VCEG_AZ07_BAC_ADAPT_WDOW || VCEG_AZ07_INIT_PREVFRAME
 #if VCEG_AZ07_BAC_ADAPT_WDOW 
-      m_pcEntropyCoder->setStatsHandle( m_apcStats );       
-      m_pcEntropyCoder->encodeCtxUpdateInfo( pcSlice, m_apcStats );
+    // the decoder parses the context update info after the entry points and the rest of the slice header, which are only written once the slice has been coded
+    TComOutputBitstream ctxUpdateInfoBitstream;
+    m_pcEntropyCoder->setBitstream( &ctxUpdateInfoBitstream );
+    m_pcEntropyCoder->setStatsHandle( m_apcStats );       
+    m_pcEntropyCoder->encodeCtxUpdateInfo( pcSlice, m_apcStats );
+    m_pcEntropyCoder->setBitstream( &nalu.m_Bitstream );
+    actualHeadBits += ctxUpdateInfoBitstream.getNumberOfWrittenBits();
 #endif
-      Int iQPIdx = xUpdateTStates (pcSlice->getSliceType(), pcSlice->getSliceQp(), m_apcStats);
-      pcSlice->setQPIdx(iQPIdx);
+    Int iQPIdx = xUpdateTStates (pcSlice->getSliceType(), pcSlice->getSliceQp(), m_apcStats);
+    pcSlice->setQPIdx(iQPIdx);
 #endif
 
-      actualHeadBits += ( m_pcEntropyCoder->getNumberOfWrittenBits() - tmpBitsBeforeWriting );
+    actualHeadBits += ( m_pcEntropyCoder->getNumberOfWrittenBits() - tmpBitsBeforeWriting );
 
-      pcSlice->setFinalized(true);
+    pcSlice->setFinalized(true);
 
-      pcSlice->clearSubstreamSizes(  );
+    pcSlice->clearSubstreamSizes(  );
 
-      {
-        UInt numBinsCoded = 0;
-        m_pcSliceEncoder->encodeSlice(pcPic, &(substreamsOut[0]), numBinsCoded
+    {
+      UInt numBinsCoded = 0;
+      m_pcSliceEncoder->encodeSlice(pcPic, &(substreamsOut[0]), numBinsCoded
 #if ALF_HM3_REFACTOR
-          , cAlfParam
+        , cAlfParam
 #endif
-          );
-        binCountsInNalUnits+=numBinsCoded;
-      }
+        );
+      binCountsInNalUnits+=numBinsCoded;
+    }
 
-      {
-        // Construct the final bitstream by concatenating substreams.
-        // The final bitstream is either nalu.m_Bitstream or pcBitstreamRedirect;
-        // Complete the slice header info.
-        m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder );
-        m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
-        m_pcEntropyCoder->encodeTilesWPPEntryPoint( pcSlice );
+    {
+      // Construct the final bitstream by concatenating substreams.
+      // The final bitstream is either nalu.m_Bitstream or pcBitstreamRedirect;
+      // Complete the slice header info.
+      m_pcEntropyCoder->setEntropyCoder   ( m_pcCavlcCoder );
+      m_pcEntropyCoder->setBitstream(&nalu.m_Bitstream);
+      tmpBitsBeforeWriting = m_pcEntropyCoder->getNumberOfWrittenBits();
+      m_pcEntropyCoder->encodeTilesWPPEntryPoint( pcSlice );
+      actualHeadBits += ( m_pcEntropyCoder->getNumberOfWrittenBits() - tmpBitsBeforeWriting );
+#if VCEG_AZ07_BAC_ADAPT_WDOW
+      nalu.m_Bitstream.addSubstream( &ctxUpdateInfoBitstream );
+#endif
 
-        // Append substreams...
-        TComOutputBitstream *pcOut = pcBitstreamRedirect;
-        const Int numZeroSubstreamsAtStartOfSlice  = pcPic->getSubstreamForCtuAddr(pcSlice->getSliceSegmentCurStartCtuTsAddr(), false, pcSlice);
-        const Int numSubstreamsToCode  = pcSlice->getNumberOfSubstreamSizes()+1;
-        for ( UInt ui = 0 ; ui < numSubstreamsToCode; ui++ )
-        {
-          pcOut->addSubstream(&(substreamsOut[ui+numZeroSubstreamsAtStartOfSlice]));
-        }
+      // Append substreams...
+      TComOutputBitstream *pcOut = pcBitstreamRedirect;
+      const Int numZeroSubstreamsAtStartOfSlice  = pcPic->getSubstreamForCtuAddr(pcSlice->getSliceSegmentCurStartCtuTsAddr(), false, pcSlice);
+      const Int numSubstreamsToCode  = pcSlice->getNumberOfSubstreamSizes()+1;
+      for ( UInt ui = 0 ; ui < numSubstreamsToCode; ui++ )
+      {
+        pcOut->addSubstream(&(substreamsOut[ui+numZeroSubstreamsAtStartOfSlice]));
       }
+    }
 
-      // If current NALU is the first NALU of slice (containing slice header) and more NALUs exist (due to multiple dependent slices) then buffer it.
-      // If current NALU is the last NALU of slice and a NALU was buffered, then (a) Write current NALU (b) Update an write buffered NALU at approproate location in NALU list.
-      Bool bNALUAlignedWrittenToList    = false; // used to ensure current NALU is not written more than once to the NALU list.
-      xAttachSliceDataToNalUnit(nalu, pcBitstreamRedirect);
-      accessUnit.push_back(new NALUnitEBSP(nalu));
-      actualTotalBits += UInt(accessUnit.back()->m_nalUnitData.str().size()) * 8;
-      numBytesInVclNalUnits += (std::size_t)(accessUnit.back()->m_nalUnitData.str().size());
-      bNALUAlignedWrittenToList = true;
+    // If current NALU is the first NALU of slice (containing slice header) and more NALUs exist (due to multiple dependent slices) then buffer it.
+    // If current NALU is the last NALU of slice and a NALU was buffered, then (a) Write current NALU (b) Update an write buffered NALU at approproate location in NALU list.
+    Bool bNALUAlignedWrittenToList    = false; // used to ensure current NALU is not written more than once to the NALU list.
+    xAttachSliceDataToNalUnit(nalu, pcBitstreamRedirect);
+    accessUnit.push_back(new NALUnitEBSP(nalu));
+    actualTotalBits += UInt(accessUnit.back()->m_nalUnitData.str().size()) * 8;
+    numBytesInVclNalUnits += (std::size_t)(accessUnit.back()->m_nalUnitData.str().size());
+    bNALUAlignedWrittenToList = true;
 
-      if (!bNALUAlignedWrittenToList)
-      {
-        nalu.m_Bitstream.writeAlignZero();
-        accessUnit.push_back(new NALUnitEBSP(nalu));
-      }
+    if (!bNALUAlignedWrittenToList)
+    {
+      nalu.m_Bitstream.writeAlignZero();
+      accessUnit.push_back(new NALUnitEBSP(nalu));
+    }
 
-      if( ( m_pcCfg->getPictureTimingSEIEnabled() || m_pcCfg->getDecodingUnitInfoSEIEnabled() ) &&
-          ( pcSlice->getSPS()->getVuiParametersPresentFlag() ) &&
-          ( ( pcSlice->getSPS()->getVuiParameters()->getHrdParameters()->getNalHrdParametersPresentFlag() )
-         || ( pcSlice->getSPS()->getVuiParameters()->getHrdParameters()->getVclHrdParametersPresentFlag() ) ) &&
-          ( pcSlice->getSPS()->getVuiParameters()->getHrdParameters()->getSubPicCpbParamsPresentFlag() ) )
+    if( ( m_pcCfg->getPictureTimingSEIEnabled() || m_pcCfg->getDecodingUnitInfoSEIEnabled() ) &&
+        ( pcSlice->getSPS()->getVuiParametersPresentFlag() ) &&
+        ( ( pcSlice->getSPS()->getVuiParameters()->getHrdParameters()->getNalHrdParametersPresentFlag() )
+       || ( pcSlice->getSPS()->getVuiParameters()->getHrdParameters()->getVclHrdParametersPresentFlag() ) ) &&
+        ( pcSlice->getSPS()->getVuiParameters()->getHrdParameters()->getSubPicCpbParamsPresentFlag() ) )
+    {
+        UInt numNalus = 0;
+      UInt numRBSPBytes = 0;
+      for (AccessUnit::const_iterator it = accessUnit.begin(); it != accessUnit.end(); it++)
       {
-          UInt numNalus = 0;
-        UInt numRBSPBytes = 0;
-        for (AccessUnit::const_iterator it = accessUnit.begin(); it != accessUnit.end(); it++)
-        {
-          numRBSPBytes += UInt((*it)->m_nalUnitData.str().size());
-          numNalus ++;
-        }
-        duData.push_back(DUData());
-        duData.back().accumBitsDU = ( numRBSPBytes << 3 );
-        duData.back().accumNalsDU = numNalus;
+        numRBSPBytes += UInt((*it)->m_nalUnitData.str().size());
+        numNalus ++;
       }
-    } // end iteration over slices
+      duData.push_back(DUData());
+      duData.back().accumBitsDU = ( numRBSPBytes << 3 );
+      duData.back().accumNalsDU = numNalus;
+    }
+  } // end iteration over slices
 
-    // cabac_zero_words processing
-    cabac_zero_word_padding(pcSlice, pcPic, binCountsInNalUnits, numBytesInVclNalUnits, accessUnit.back()->m_nalUnitData, m_pcCfg->getCabacZeroWordPaddingEnabled());
+  // cabac_zero_words processing
+  cabac_zero_word_padding(pcSlice, pcPic, binCountsInNalUnits, numBytesInVclNalUnits, accessUnit.back()->m_nalUnitData, m_pcCfg->getCabacZeroWordPaddingEnabled());
 #if COM16_C806_HEVC_MOTION_CONSTRAINT_REMOVAL
-    if ( !pcSlice->getSPS()->getAtmvpEnableFlag())
-    {
-      pcPic->compressMotion();
-    }
-#else  
+  if ( !pcSlice->getSPS()->getAtmvpEnableFlag())
+  {
     pcPic->compressMotion();
+  }
+#else  
+  pcPic->compressMotion();
 #endif
-    //-- For time output for each slice
-    Double dEncTime = (Double)(clock()-iBeforeTime) / CLOCKS_PER_SEC;
+  //-- For time output for each slice
+  Double dEncTime = (Double)(clock()-rcPicture.iBeforeTime) / CLOCKS_PER_SEC;
 
-    std::string digestStr;
-    if (m_pcCfg->getDecodedPictureHashSEIEnabled())
-    {
-      SEIDecodedPictureHash *decodedPictureHashSei = new SEIDecodedPictureHash();
-      m_seiEncoder.initDecodedPictureHashSEI(decodedPictureHashSei, pcPic, digestStr, pcSlice->getSPS()->getBitDepths());
-      trailingSeiMessages.push_back(decodedPictureHashSei);
-    }
-    xWriteTrailingSEIMessages(trailingSeiMessages, accessUnit, pcSlice->getTLayer(), pcSlice->getSPS());
+  std::string digestStr;
+  if (m_pcCfg->getDecodedPictureHashSEIEnabled())
+  {
+    SEIDecodedPictureHash *decodedPictureHashSei = new SEIDecodedPictureHash();
+    m_seiEncoder.initDecodedPictureHashSEI(decodedPictureHashSei, pcPic, digestStr, pcSlice->getSPS()->getBitDepths());
+    trailingSeiMessages.push_back(decodedPictureHashSei);
+  }
+  xWriteTrailingSEIMessages(trailingSeiMessages, accessUnit, pcSlice->getTLayer(), pcSlice->getSPS());
 
-    m_pcCfg->setEncodedFlag(iGOPid, true);
+  m_pcCfg->setEncodedFlag(iGOPid, true);
 
-    xCalculateAddPSNRs( isField, isTff, iGOPid, pcPic, accessUnit, rcListPic, dEncTime, snr_conversion, printFrameMSE );
+  xCalculateAddPSNRs( isField, isTff, iGOPid, pcPic, accessUnit, rcListPic, dEncTime, snr_conversion, printFrameMSE );
 
-    if (!digestStr.empty())
+#if PARALLEL_SEGMENT_ENCODING
+  if (!digestStr.empty() && m_pcCfg->getSegmentIdx() < 0)
+#else
+  if (!digestStr.empty())
+#endif
+  {
+    if(m_pcCfg->getDecodedPictureHashSEIEnabled() == 1)
     {
-      if(m_pcCfg->getDecodedPictureHashSEIEnabled() == 1)
-      {
-        printf(" [MD5:%s]", digestStr.c_str());
-      }
-      else if(m_pcCfg->getDecodedPictureHashSEIEnabled() == 2)
-      {
-        printf(" [CRC:%s]", digestStr.c_str());
-      }
-      else if(m_pcCfg->getDecodedPictureHashSEIEnabled() == 3)
-      {
-        printf(" [Checksum:%s]", digestStr.c_str());
-      }
+      printf(" [MD5:%s]", digestStr.c_str());
     }
+    else if(m_pcCfg->getDecodedPictureHashSEIEnabled() == 2)
+    {
+      printf(" [CRC:%s]", digestStr.c_str());
+    }
+    else if(m_pcCfg->getDecodedPictureHashSEIEnabled() == 3)
+    {
+      printf(" [Checksum:%s]", digestStr.c_str());
+    }
+  }
 
-    if ( m_pcCfg->getUseRateCtrl() )
+  if ( m_pcCfg->getUseRateCtrl() )
+  {
+    Double avgQP     = m_pcRateCtrl->getRCPic()->calAverageQP();
+    Double avgLambda = m_pcRateCtrl->getRCPic()->calAverageLambda();
+    if ( avgLambda < 0.0 )
     {
-      Double avgQP     = m_pcRateCtrl->getRCPic()->calAverageQP();
-      Double avgLambda = m_pcRateCtrl->getRCPic()->calAverageLambda();
-      if ( avgLambda < 0.0 )
-      {
-        avgLambda = lambda;
-      }
+      avgLambda = rcPicture.dLambda;
+    }
 
-      m_pcRateCtrl->getRCPic()->updateAfterPicture( actualHeadBits, actualTotalBits, avgQP, avgLambda, pcSlice->getSliceType());
-      m_pcRateCtrl->getRCPic()->addToPictureLsit( m_pcRateCtrl->getPicList() );
+    m_pcRateCtrl->getRCPic()->updateAfterPicture( actualHeadBits, actualTotalBits, avgQP, avgLambda, pcSlice->getSliceType());
+    m_pcRateCtrl->getRCPic()->addToPictureLsit( m_pcRateCtrl->getPicList() );
 
-      m_pcRateCtrl->getRCSeq()->updateAfterPic( actualTotalBits );
-      if ( pcSlice->getSliceType() != I_SLICE )
-      {
-        m_pcRateCtrl->getRCGOP()->updateAfterPicture( actualTotalBits );
-      }
-      else    // for intra picture, the estimated bits are used to update the current status in the GOP
-      {
-        m_pcRateCtrl->getRCGOP()->updateAfterPicture( estimatedBits );
-      }
+    m_pcRateCtrl->getRCSeq()->updateAfterPic( actualTotalBits );
+    if ( pcSlice->getSliceType() != I_SLICE )
+    {
+      m_pcRateCtrl->getRCGOP()->updateAfterPicture( actualTotalBits );
     }
-
-    xCreatePictureTimingSEI(m_pcCfg->getEfficientFieldIRAPEnabled()?effFieldIRAPMap.GetIRAPGOPid():0, leadingSeiMessages, nestedSeiMessages, duInfoSeiMessages, pcSlice, isField, duData);
-    if (m_pcCfg->getScalableNestingSEIEnabled())
+    else    // for intra picture, the estimated bits are used to update the current status in the GOP
     {
-      xCreateScalableNestingSEI (leadingSeiMessages, nestedSeiMessages);
+      m_pcRateCtrl->getRCGOP()->updateAfterPicture( rcPicture.iEstimatedBits );
     }
-    xWriteLeadingSEIMessages(leadingSeiMessages, duInfoSeiMessages, accessUnit, pcSlice->getTLayer(), pcSlice->getSPS(), duData);
-    xWriteDuSEIMessages(duInfoSeiMessages, accessUnit, pcSlice->getTLayer(), pcSlice->getSPS(), duData);
+  }
 
-    pcPic->getPicYuvRec()->copyToPic(pcPicYuvRecOut);
+  xCreatePictureTimingSEI(rcPicture.iIRAPGOPid, leadingSeiMessages, nestedSeiMessages, duInfoSeiMessages, pcSlice, isField, duData);
+  if (m_pcCfg->getScalableNestingSEIEnabled())
+  {
+    xCreateScalableNestingSEI (leadingSeiMessages, nestedSeiMessages);
+  }
+  xWriteLeadingSEIMessages(leadingSeiMessages, duInfoSeiMessages, accessUnit, pcSlice->getTLayer(), pcSlice->getSPS(), duData);
+  xWriteDuSEIMessages(duInfoSeiMessages, accessUnit, pcSlice->getTLayer(), pcSlice->getSPS(), duData);
 
-    pcPic->setReconMark   ( true );
+  pcPic->getPicYuvRec()->copyToPic(pcPicYuvRecOut);
+
+  pcPic->setReconMark   ( true );
 #if VCEG_AZ08_INTER_KLT
 #if VCEG_AZ08_USE_KLT
-    if (pcSlice->getSPS()->getUseInterKLT())
-    {
+  if (pcSlice->getSPS()->getUseInterKLT())
+  {
 #endif
-        m_pcSliceEncoder->InterpolatePic(pcPic);
+      m_pcSliceEncoder->InterpolatePic(pcPic);
 #if VCEG_AZ08_USE_KLT
-    }
+  }
 #endif
 #endif
-    m_bFirst = false;
-    m_iNumPicCoded++;
-    m_totalCoded ++;
-    /* logging: insert a newline at end of picture period */
+  m_bFirst = false;
+  m_iNumPicCoded++;
+  m_totalCoded ++;
+  /* logging: insert a newline at end of picture period */
+#if PARALLEL_SEGMENT_ENCODING
+  if (m_pcCfg->getSegmentIdx() < 0)
+  {
     printf("\n");
     fflush(stdout);
-
-    if (m_pcCfg->getEfficientFieldIRAPEnabled())
-    {
-      iGOPid=effFieldIRAPMap.restoreGOPid(iGOPid);
-    }
-  } // iGOPid-loop
-
-  delete pcBitstreamRedirect;
-#if ALF_HM3_REFACTOR
-  if( pcSlice->getSPS()->getUseALF() )
-  {
-    m_pcAdaptiveLoopFilter->freeALFParam(&cAlfParam);
   }
+#else
+  printf("\n");
+  fflush(stdout);
 #endif
-  assert ( (m_iNumPicCoded == iNumPicRcvd) );
+
+  pcPic->getSlice(0)->setReferenced( bReferenced );
 }
 
 #if JVET_D0134_PSNR
@@ -2176,6 +2479,23 @@ Void TEncGOP::printOutSummary(UInt uiNumAllPicCoded, Bool isField, const Bool pr
 
   printf("\nRVM: %.3lf\n" , xCalculateRVM());
 }
+
+#if PARALLEL_SEGMENT_ENCODING
+/** Append the statistics of the encoder of the next intra-period segment.
+ * \param rcSegment GOP encoder of the segment
+ * \returns number of pictures of the segment that are part of the sequence
+ */
+UInt TEncGOP::addSegmentStatistics( const TEncGOP& rcSegment )
+{
+  m_gcAnalyzeAll.add( rcSegment.m_gcAnalyzeAll );
+  m_gcAnalyzeI.add  ( rcSegment.m_gcAnalyzeI   );
+  m_gcAnalyzeP.add  ( rcSegment.m_gcAnalyzeP   );
+  m_gcAnalyzeB.add  ( rcSegment.m_gcAnalyzeB   );
+  m_vRVM_RP.insert( m_vRVM_RP.end(), rcSegment.m_vRVM_RP.begin(), rcSegment.m_vRVM_RP.end() );
+  return rcSegment.m_gcAnalyzeAll.getNumPic();
+}
+
+#endif
 #if !JVET_C0038_GALF
 Void TEncGOP::preLoopFilterPicAll( TComPic* pcPic, UInt64& ruiDist )
 {
@@ -2277,6 +2597,24 @@ Void TEncGOP::xGetBuffer( TComList<TComPic*>&      rcListPic,
   return;
 }
 
+#if PARALLEL_PICTURE_ENCODING
+/** Creates the encoders of the picture encoding threads, configured like this encoder. Only their slice, CU and search
+ *  encoders are used, on the pictures of this encoder.
+ */
+Void TEncGOP::xCreatePictureEncoders( Bool isField )
+{
+  while (m_pictureEncoders.size() < UInt(m_pcCfg->getNumPictureThreads()))
+  {
+    TEncTop* pcEncTop = new TEncTop;
+    static_cast<TEncCfg&>(*pcEncTop) = *m_pcCfg;
+    pcEncTop->setNumPictureThreads( 1 );
+    pcEncTop->create();
+    pcEncTop->init( isField );
+    m_pictureEncoders.push_back( pcEncTop );
+  }
+}
+#endif
+
 UInt64 TEncGOP::xFindDistortionFrame (TComPicYuv* pcPic0, TComPicYuv* pcPic1, const BitDepths &bitDepths)
 {
   UInt64  uiTotalDiff = 0;
@@ -2449,6 +2787,35 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const Acces
   }
 
   UInt uibits = numRBSPBytes * 8;
+#if PARALLEL_SEGMENT_ENCODING
+  TComSlice*  pcSlice = pcPic->getSlice(0);
+  // the first picture of a later segment repeats the last picture of the previous segment: it is dropped from the stream and not counted
+  if (m_pcCfg->getSegmentIdx() <= 0 || pcSlice->getPOC() != 0)
+  {
+    m_vRVM_RP.push_back( uibits );
+
+    //===== add PSNR =====
+    m_gcAnalyzeAll.addResult (dPSNR, (Double)uibits, MSEyuvframe);
+    if (pcSlice->isIntra())
+    {
+      m_gcAnalyzeI.addResult (dPSNR, (Double)uibits, MSEyuvframe);
+    }
+    if (pcSlice->isInterP())
+    {
+      m_gcAnalyzeP.addResult (dPSNR, (Double)uibits, MSEyuvframe);
+    }
+    if (pcSlice->isInterB())
+    {
+      m_gcAnalyzeB.addResult (dPSNR, (Double)uibits, MSEyuvframe);
+    }
+  }
+  if (m_pcCfg->getSegmentIdx() >= 0)
+  {
+    // segments are encoded concurrently, the application reports their results
+    cscd.destroy();
+    return;
+  }
+#else
   m_vRVM_RP.push_back( uibits );
 
   //===== add PSNR =====
@@ -2466,6 +2833,7 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const Acces
   {
     m_gcAnalyzeB.addResult (dPSNR, (Double)uibits, MSEyuvframe);
   }
+#endif
 
   Char c = (pcSlice->isIntra() ? 'I' : pcSlice->isInterP() ? 'P' : 'B');
   if (!pcSlice->isReferenced())
@@ -61,6 +61,9 @@
 #if ALF_HM3_REFACTOR
 #include "TEncAdaptiveLoopFilter.h"
 #endif
+#if PARALLEL_PICTURE_ENCODING
+#include <thread>
+#endif
 
 //! \ingroup TLibEncoder
 //! \{
@@ -84,6 +87,50 @@ class TEncGOP
     Int accumNalsDU;
   };
 
+  /// picture of the GOP between its preparation (slice set-up, reference lists) and the writing of its access unit
+  class GOPPicture
+  {
+  public:
+    GOPPicture()
+    : iGOPid(0)
+    , iIRAPGOPid(0)
+    , pcPic(NULL)
+    , pcPicYuvRecOut(NULL)
+    , pcAccessUnit(NULL)
+    , iBeforeTime(0)
+    , pcSliceEncoder(NULL)
+#if VCEG_AZ07_BAC_ADAPT_WDOW || VCEG_AZ07_INIT_PREVFRAME
+    , pcStats(NULL)
+#endif
+    , uiNumSliceSegments(1)
+    , dLambda(0.0)
+    , iEstimatedBits(0)
+    , bReferenced(true)
+#if PARALLEL_PICTURE_ENCODING
+    , pcEncoder(NULL)
+#endif
+    {};
+
+    Int          iGOPid;
+    Int          iIRAPGOPid;
+    TComPic*     pcPic;
+    TComPicYuv*  pcPicYuvRecOut;
+    AccessUnit*  pcAccessUnit;
+    clock_t      iBeforeTime;
+    TEncSlice*   pcSliceEncoder;       ///< slice encoder compressing the picture
+#if VCEG_AZ07_BAC_ADAPT_WDOW || VCEG_AZ07_INIT_PREVFRAME
+    TComStats*   pcStats;              ///< context statistics the picture is compressed with
+#endif
+    UInt         uiNumSliceSegments;
+    Double       dLambda;              ///< rate control
+    Int          iEstimatedBits;       ///< rate control
+    Bool         bReferenced;          ///< marking of the picture when it was prepared, later pictures may have been prepared since
+#if PARALLEL_PICTURE_ENCODING
+    TEncTop*     pcEncoder;            ///< encoder of the picture encoding thread, NULL if the picture is compressed by this encoder
+    std::thread  cThread;
+#endif
+  };
+
 private:
 
   TEncAnalyze             m_gcAnalyzeAll;
@@ -140,10 +187,21 @@ private:
   // Adaptive Loop filter
   TEncAdaptiveLoopFilter* m_pcAdaptiveLoopFilter;
 #if COM16_C806_ALF_TEMPPRED_NUM
+#if PARALLEL_SEGMENT_ENCODING
+  Int                  m_iStoredAlfParaNum;
+#else
   static Int           m_iStoredAlfParaNum;
+#endif
   ALFParam             m_acStoredAlfPara[COM16_C806_ALF_TEMPPRED_NUM];
 #endif
 #endif
+#if JVET_C0024_AMAX_BT && JVET_C0024_AMAX_BT_FIX && PARALLEL_SEGMENT_ENCODING
+  UInt                    m_uiPrevISlicePOC;   ///< POC of the last intra slice, for the adaptive maximum BT size
+  Bool                    m_bInitAMaxBT;       ///< block size statistics are to be cleared at the first inter slice after an intra slice
+#endif
+#if PARALLEL_PICTURE_ENCODING
+  std::vector<TEncTop*>   m_pictureEncoders;   ///< encoders of the picture encoding threads (PictureThreads), created at the first GOP
+#endif
 
 public:
   TEncGOP();
@@ -171,6 +229,9 @@ public:
 #else
   Void  printOutSummary      ( UInt uiNumAllPicCoded, Bool isField, const Bool printMSEBasedSNR, const Bool printSequenceMSE, const BitDepths &bitDepths );
 #endif
+#if PARALLEL_SEGMENT_ENCODING
+  UInt  addSegmentStatistics ( const TEncGOP& rcSegment );
+#endif
 #if !JVET_C0038_GALF
   Void  preLoopFilterPicAll  ( TComPic* pcPic, UInt64& ruiDist );
 #endif
@@ -188,6 +249,19 @@ protected:
 
   Void  xInitGOP          ( Int iPOCLast, Int iNumPicRcvd, Bool isField );
   Void  xGetBuffer        ( TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut, Int iNumPicRcvd, Int iTimeOffset, TComPic*& rpcPic, TComPicYuv*& rpcPicYuvRecOut, Int pocCurr, Bool isField );
+  Void  xCompressPicture  ( GOPPicture& rcPicture );
+  Void  xFinishPicture    ( GOPPicture& rcPicture, TComList<TComPic*>& rcListPic, Bool isField, Bool isTff, const InputColourSpaceConversion snr_conversion, const Bool printFrameMSE,
+                            SEIMessages& leadingSeiMessages, SEIMessages& nestedSeiMessages, SEIMessages& duInfoSeiMessages, SEIMessages& trailingSeiMessages, TComOutputBitstream* pcBitstreamRedirect
+#if ALF_HM3_REFACTOR
+                          , ALFParam& cAlfParam, Bool& bInitAlfParam
+#endif
+#if VCEG_AZ07_BAC_ADAPT_WDOW || VCEG_AZ07_INIT_PREVFRAME
+                          , TComStats* m_apcStats
+#endif
+                          );
+#if PARALLEL_PICTURE_ENCODING
+  Void  xCreatePictureEncoders ( Bool isField );
+#endif
 
   Void  xCalculateAddPSNRs         ( const Bool isField, const Bool isFieldTopFieldFirst, const Int iGOPid, TComPic* pcPic, const AccessUnit&accessUnit, TComList<TComPic*> &rcListPic, Double dEncTime, const InputColourSpaceConversion snr_conversion, const Bool printFrameMSE );
   Void  xCalculateAddPSNR          ( TComPic* pcPic, TComPicYuv* pcPicD, const AccessUnit&, Double dEncTime, const InputColourSpaceConversion snr_conversion, const Bool printFrameMSE );
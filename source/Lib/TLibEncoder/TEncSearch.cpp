@@ -48,10 +48,6 @@
 //! \ingroup TLibEncoder
 //! \{
 
-#if VCEG_AZ08_KLT_COMMON
-extern short **g_ppsEigenVector[USE_MORE_BLOCKSIZE_DEPTH_MAX];
-#endif
-
 #if JVET_D0033_ADAPTIVE_CLIPPING_ENC_METHOD
 namespace {
 
@@ -71,8 +67,8 @@ Int average(const std::vector<Pel> &r,Int i0,Int j0,Int uiHeight,Int uiWidth) {
 
 void smoothResidual(const Bound prm,const std::vector<Pel> &org,std::vector<Pel> &res,UInt uiHeight,UInt uiWidth) {
     // find boundaries of the res
-    static std::vector<char> bmM;
-    static std::vector<Pel> r;
+    static thread_local std::vector<char> bmM;
+    static thread_local std::vector<Pel> r;
     r=res;
     bmM.resize(uiHeight*uiWidth); // avoir realloc
 
@@ -114,7 +110,7 @@ void smoothResidual(const ComponentID compID,const Pel *piOrg,Pel *piResi,UInt u
     default: assert(false);
     }
 
-    static std::vector<Pel> org; // avoid realloc
+    static thread_local std::vector<Pel> org; // avoid realloc
     org.resize(uiHeight*uiWidth);
 
     Bool activate=false;
@@ -126,7 +122,7 @@ void smoothResidual(const ComponentID compID,const Pel *piOrg,Pel *piResi,UInt u
 
 
     if (activate) {
-        static std::vector<Pel> r; // avoid realloc
+        static thread_local std::vector<Pel> r; // avoid realloc
         r.resize(uiHeight*uiWidth);
         for(Int i=0,k=0;i<uiHeight;++i)
             for(Int j=0;j<uiWidth;++j,++k) {
@@ -2788,14 +2784,13 @@ if (rTu.getRect(COMPONENT_Y).width==4) //RSAF is not applied to 4x4 TUs.
   UInt    uiInitTrDepth     = pcCU->getPartitionSize(0) == SIZE_2Nx2N ? 0 : 1;
   UChar   ucSavedEmtTrIdx   = 0;
   Bool    bCheckInitTrDepth = false;
-  static UInt uiInitAbsPartIdx;
   if ( uiTrDepth==uiInitTrDepth )
   {
-    uiInitAbsPartIdx = uiAbsPartIdx;
+    m_uiInitAbsPartIdxRSAF = uiAbsPartIdx;
   }
   if ( !bCheckFirst && uiTrDepth==uiInitTrDepth )
   {
-    ucSavedEmtTrIdx   = m_puhQTTempEmtTuIdx[uiAbsPartIdx-uiInitAbsPartIdx];
+    ucSavedEmtTrIdx   = m_puhQTTempEmtTuIdx[uiAbsPartIdx-m_uiInitAbsPartIdxRSAF];
     bCheckInitTrDepth = true;
   }
 #endif
@@ -3523,14 +3518,13 @@ TEncSearch::xRecurIntraCodingLumaQT(TComYuv*    pcOrgYuv,
 #endif
   UChar   ucSavedEmtTrIdx   = 0;
   Bool    bCheckInitTrDepth = false;
-  static UInt uiInitAbsPartIdx;
   if ( uiTrDepth==uiInitTrDepth )
   {
-    uiInitAbsPartIdx = uiAbsPartIdx;
+    m_uiInitAbsPartIdx = uiAbsPartIdx;
   }
   if ( !bCheckFirst && uiTrDepth==uiInitTrDepth )
   {
-    ucSavedEmtTrIdx   = m_puhQTTempEmtTuIdx[uiAbsPartIdx-uiInitAbsPartIdx];
+    ucSavedEmtTrIdx   = m_puhQTTempEmtTuIdx[uiAbsPartIdx-m_uiInitAbsPartIdx];
     bCheckInitTrDepth = true;
   }
 #endif
@@ -5023,24 +5017,12 @@ TEncSearch::estIntraPredLumaQT(TComDataCU* pcCU,
   Bool NSSTFlag = (pcCU->getROTIdx(0) == 0);
   Bool NSSTSaveFlag = (pcCU->getROTIdx(0) == 0) && (pcCU->getPDPCIdx(0) == 0) && (pcCU->getEmtCuFlag(0) == 0);
 #endif
-  static UInt   uiSavedRdModeListNSST[35], uiSavedNumRdModesNSST, uiSavedHadModeListNSST[35];
-  static Double dSavedModeCostNSST[35], dSavedHadListNSST[FAST_UDI_MAX_RDMODE_NUM];
 #if JVET_C0024_PBINTRA_FAST
   UInt uiHadModeList[67];
 #endif
 #endif
 
 #if COM16_C806_EMT
-#if JVET_C0024_QTBT
-  static Double dBestModeCostStore; // RD cost of the best mode for each PU using DCT2
-  static Double dModeCostStore[35]; // RD cost of each mode for each PU using DCT2
-  static UInt   uiSavedRdModeList[35], uiSavedNumRdModes;
-#else
-  static Double dBestModeCostStore[4]; // RD cost of the best mode for each PU using DCT2
-  static Double dModeCostStore[4][35]; // RD cost of each mode for each PU using DCT2
-  static UInt   uiSavedRdModeList[4][35], uiSavedNumRdModes[4];
-#endif
-
   // Marking EMT usage for faster EMT
   // 0: EMT not applicable for current CU (pcCU->getWidth(0) <= EMT_INTRA_MAX_CU)
   // 1: EMT can be applied for current CU, and DCT2 is being checked
@@ -5263,12 +5245,12 @@ TEncSearch::estIntraPredLumaQT(TComDataCU* pcCU,
       }
 #if JVET_D0127_REDUNDANCY_REMOVAL
       if (NSSTSaveFlag){
-          uiSavedNumRdModesNSST = numModesForFullRD;
-          ::memcpy(uiSavedRdModeListNSST, uiRdModeList, (numModesForFullRD + 2)*sizeof(UInt));
-          ::memcpy(dSavedModeCostNSST, CandCostList, (numModesForFullRD + 2)*sizeof(Double));
+          m_uiSavedNumRdModesNSST = numModesForFullRD;
+          ::memcpy(m_uiSavedRdModeListNSST, uiRdModeList, (numModesForFullRD + 2)*sizeof(UInt));
+          ::memcpy(m_dSavedModeCostNSST, CandCostList, (numModesForFullRD + 2)*sizeof(Double));
 #if JVET_C0024_PBINTRA_FAST
-          ::memcpy(uiSavedHadModeListNSST, uiHadModeList, (numModesForFullRD + 2)*sizeof(UInt));
-          ::memcpy(dSavedHadListNSST, CandHadList, (numModesForFullRD + 2)*sizeof(Double));
+          ::memcpy(m_uiSavedHadModeListNSST, uiHadModeList, (numModesForFullRD + 2)*sizeof(UInt));
+          ::memcpy(m_dSavedHadListNSST, CandHadList, (numModesForFullRD + 2)*sizeof(Double));
 #endif
       }
       }
@@ -5278,12 +5260,12 @@ TEncSearch::estIntraPredLumaQT(TComDataCU* pcCU,
 #else
           if (pcCU->getROTIdx(0) == 3){
 #endif
-              numModesForFullRD = uiSavedNumRdModesNSST;
-              ::memcpy(uiRdModeList, uiSavedRdModeListNSST, (numModesForFullRD + 2)*sizeof(UInt));
-              ::memcpy(CandCostList, dSavedModeCostNSST, (numModesForFullRD + 2)*sizeof(Double));
+              numModesForFullRD = m_uiSavedNumRdModesNSST;
+              ::memcpy(uiRdModeList, m_uiSavedRdModeListNSST, (numModesForFullRD + 2)*sizeof(UInt));
+              ::memcpy(CandCostList, m_dSavedModeCostNSST, (numModesForFullRD + 2)*sizeof(Double));
 #if JVET_C0024_PBINTRA_FAST
-              ::memcpy(uiHadModeList, uiSavedHadModeListNSST, (numModesForFullRD + 2)*sizeof(UInt));
-              ::memcpy(CandHadList, dSavedHadListNSST, (numModesForFullRD + 2)*sizeof(Double));
+              ::memcpy(uiHadModeList, m_uiSavedHadModeListNSST, (numModesForFullRD + 2)*sizeof(UInt));
+              ::memcpy(CandHadList, m_dSavedHadListNSST, (numModesForFullRD + 2)*sizeof(Double));
 #endif
               Int cnt = 0;
               Int i = 0;
@@ -5314,11 +5296,11 @@ TEncSearch::estIntraPredLumaQT(TComDataCU* pcCU,
 #endif
           }
           else{
-              numModesForFullRD = uiSavedNumRdModesNSST;
-              ::memcpy(uiRdModeList, uiSavedRdModeListNSST, numModesForFullRD*sizeof(UInt));
-              ::memcpy(CandCostList, dSavedModeCostNSST, numModesForFullRD*sizeof(Double));
+              numModesForFullRD = m_uiSavedNumRdModesNSST;
+              ::memcpy(uiRdModeList, m_uiSavedRdModeListNSST, numModesForFullRD*sizeof(UInt));
+              ::memcpy(CandCostList, m_dSavedModeCostNSST, numModesForFullRD*sizeof(Double));
 #if JVET_C0024_PBINTRA_FAST
-              ::memcpy(CandHadList, dSavedHadListNSST, numModesForFullRD*sizeof(Double));
+              ::memcpy(CandHadList, m_dSavedHadListNSST, numModesForFullRD*sizeof(Double));
 #endif
           }
 
@@ -5460,11 +5442,11 @@ TEncSearch::estIntraPredLumaQT(TComDataCU* pcCU,
     {
       // Store the modes to be checked with RD
 #if JVET_C0024_QTBT
-      uiSavedNumRdModes = numModesForFullRD;
-      ::memcpy( uiSavedRdModeList, uiRdModeList, numModesForFullRD*sizeof(UInt) );
+      m_uiSavedNumRdModes = numModesForFullRD;
+      ::memcpy( m_uiSavedRdModeList, uiRdModeList, numModesForFullRD*sizeof(UInt) );
 #else
-      uiSavedNumRdModes[uiPU] = numModesForFullRD;
-      ::memcpy( uiSavedRdModeList[uiPU], uiRdModeList, numModesForFullRD*sizeof(UInt) );
+      m_uiSavedNumRdModes[uiPU] = numModesForFullRD;
+      ::memcpy( m_uiSavedRdModeList[uiPU], uiRdModeList, numModesForFullRD*sizeof(UInt) );
 #endif
     }
     }
@@ -5493,19 +5475,19 @@ TEncSearch::estIntraPredLumaQT(TComDataCU* pcCU,
 
         // Skip checking the modes with much larger R-D cost than the best mode
 #if JVET_C0024_QTBT
-        for( Int i=0; i < uiSavedNumRdModes; i++)
+        for( Int i=0; i < m_uiSavedNumRdModes; i++)
         {
-          if( dModeCostStore[i] <= dThrFastMode * dBestModeCostStore )
+          if( m_dModeCostStore[i] <= dThrFastMode * m_dBestModeCostStore )
           {
-            uiRdModeList[numModesForFullRD++] = uiSavedRdModeList[i];
+            uiRdModeList[numModesForFullRD++] = m_uiSavedRdModeList[i];
           }
         }
 #else
-        for( Int i=0; i < uiSavedNumRdModes[uiPU]; i++)
+        for( Int i=0; i < m_uiSavedNumRdModes[uiPU]; i++)
         {
-          if( dModeCostStore[uiPU][i] <= dThrFastMode * dBestModeCostStore[uiPU] )
+          if( m_dModeCostStore[uiPU][i] <= dThrFastMode * m_dBestModeCostStore[uiPU] )
           {
-            uiRdModeList[numModesForFullRD++] = uiSavedRdModeList[uiPU][i];
+            uiRdModeList[numModesForFullRD++] = m_uiSavedRdModeList[uiPU][i];
           }
         }
 #endif
@@ -5514,11 +5496,11 @@ TEncSearch::estIntraPredLumaQT(TComDataCU* pcCU,
       {
         // Restore the modes to be checked with RD
 #if JVET_C0024_QTBT
-        numModesForFullRD = uiSavedNumRdModes;
-        ::memcpy( uiRdModeList, uiSavedRdModeList, numModesForFullRD*sizeof(UInt) );
+        numModesForFullRD = m_uiSavedNumRdModes;
+        ::memcpy( uiRdModeList, m_uiSavedRdModeList, numModesForFullRD*sizeof(UInt) );
 #else
-        numModesForFullRD = uiSavedNumRdModes[uiPU];
-        ::memcpy( uiRdModeList, uiSavedRdModeList[uiPU], numModesForFullRD*sizeof(UInt) );
+        numModesForFullRD = m_uiSavedNumRdModes[uiPU];
+        ::memcpy( uiRdModeList, m_uiSavedRdModeList[uiPU], numModesForFullRD*sizeof(UInt) );
 #endif
       }
     }
@@ -5670,9 +5652,9 @@ TEncSearch::estIntraPredLumaQT(TComDataCU* pcCU,
       if ( 1==ucEmtUsageFlag && m_pcEncCfg->getUseFastIntraEMT() )
       {
 #if JVET_C0024_QTBT
-        dModeCostStore[uiMode] = dPUCost;
+        m_dModeCostStore[uiMode] = dPUCost;
 #else
-        dModeCostStore[uiPU][uiMode] = dPUCost;
+        m_dModeCostStore[uiPU][uiMode] = dPUCost;
 #endif
       }
 #endif
@@ -5699,9 +5681,9 @@ TEncSearch::estIntraPredLumaQT(TComDataCU* pcCU,
         if ( 1==ucEmtUsageFlag && m_pcEncCfg->getUseFastIntraEMT() )
         {
 #if JVET_C0024_QTBT
-          dBestModeCostStore = dPUCost;
+          m_dBestModeCostStore = dPUCost;
 #else
-          dBestModeCostStore[uiPU] = dPUCost;
+          m_dBestModeCostStore[uiPU] = dPUCost;
 #endif
         }
 #endif
@@ -11901,6 +11883,14 @@ Void TEncSearch::xAffineMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, I
 
   // malloc buffer
   Int iParaNum = 5;
+#if AFFINE_FAST_GRADIENT_ME
+  Double adEqualCoeff[5][5];
+  Double *pdEqualCoeff[5];
+  for ( Int i = 0; i < iParaNum; i++ )
+  {
+    pdEqualCoeff[i] = adEqualCoeff[i];
+  }
+#else
   Double **pdEqualCoeff;
   pdEqualCoeff = new Double *[iParaNum];
   for ( Int i = 0; i < iParaNum; i++ )
@@ -11911,6 +11901,7 @@ Void TEncSearch::xAffineMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, I
       pdEqualCoeff[i][j] = 0.0;
     }
   }
+#endif
 
   Int    *piError = m_tmpError;
   Double *pdDerivate[2];
@@ -11974,11 +11965,54 @@ Void TEncSearch::xAffineMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, I
 #endif
 
   Int iIterTime = bBi ? 5 : 7;
+#if AFFINE_FAST_GRADIENT_ME
+  // control point Mvs evaluated so far: an iteration coming back to them would repeat the iterations that followed them
+  TComMv acMvVisited[8][2];
+  Int    iNumVisited = 1;
+  acMvVisited[0][0] = acMvTemp[0];
+  acMvVisited[0][1] = acMvTemp[1];
+#endif
   for ( Int iter=0; iter<iIterTime; iter++ )    // iterate loop
   {
 /*********************************************************************************
  *                         use gradient to update mv
  *********************************************************************************/
+#if AFFINE_FAST_GRADIENT_ME
+    // get Error Matrix and the sobel x and y gradients of the prediction in one pass, the gradients of the border repeat the nearest inner ones
+    Pel* pOrg  = pcYuv->getAddr(COMPONENT_Y, uiPartAddr);
+    Pel* pPred = pPredYuv->getAddr(COMPONENT_Y, uiPartAddr);
+    for ( Int j = 0; j < iRoiHeight; j++ )
+    {
+      for ( Int i = 0; i < iRoiWidth; i++ )
+      {
+        piError[i + j * iRoiWidth] = pOrg[i] - pPred[i];
+      }
+
+      if ( j > 0 && j < iRoiHeight - 1 )
+      {
+        Double* pdGradX = pdDerivate[0] + j * iRoiWidth;
+        Double* pdGradY = pdDerivate[1] + j * iRoiWidth;
+        for ( Int k = 1; k < iRoiWidth - 1; k++ )
+        {
+          const Pel* p = pPred + k;
+          pdGradX[k] = (Double)( p[1 - iPredStride] - p[-1 - iPredStride] + ( p[1] << 1 ) - ( p[-1] << 1 ) + p[1 + iPredStride] - p[-1 + iPredStride] ) / 8;
+          pdGradY[k] = (Double)( p[iPredStride - 1] - p[-iPredStride - 1] + ( p[iPredStride] << 1 ) - ( p[-iPredStride] << 1 ) + p[iPredStride + 1] - p[-iPredStride + 1] ) / 8;
+        }
+        pdGradX[0]             = pdGradX[1];
+        pdGradX[iRoiWidth - 1] = pdGradX[iRoiWidth - 2];
+        pdGradY[0]             = pdGradY[1];
+        pdGradY[iRoiWidth - 1] = pdGradY[iRoiWidth - 2];
+      }
+      pOrg  += iOrgStride;
+      pPred += iPredStride;
+    }
+    for ( Int i = 0; i < 2; i++ )
+    {
+      memcpy( pdDerivate[i],                                pdDerivate[i] + iRoiWidth,                    iRoiWidth * sizeof( Double ) );
+      memcpy( pdDerivate[i] + ( iRoiHeight - 1 ) * iRoiWidth, pdDerivate[i] + ( iRoiHeight - 2 ) * iRoiWidth, iRoiWidth * sizeof( Double ) );
+    }
+
+#else
     // get Error Matrix
     Pel* pOrg  = pcYuv->getAddr(COMPONENT_Y, uiPartAddr);
     Pel* pPred = pPredYuv->getAddr(COMPONENT_Y, uiPartAddr);
@@ -12050,6 +12084,7 @@ Void TEncSearch::xAffineMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, I
       pdDerivate[1][j*iRoiWidth+iRoiWidth-1] = pdDerivate[1][j*iRoiWidth+iRoiWidth-2];
     }
 
+#endif
     // solve delta x and y
     for ( Int m = 0; m != iParaNum; m++ )
     {
@@ -12059,6 +12094,43 @@ Void TEncSearch::xAffineMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, I
       }
     }
 
+#if AFFINE_FAST_GRADIENT_ME
+    // the products dC[col] * dC[row] are symmetric: sum the upper half in locals, in the same order, and mirror it
+    Double adSum[4][5];
+    for ( Int col=0; col<4; col++ )
+    {
+      for ( Int row=0; row<5; row++ )
+      {
+        adSum[col][row] = 0.0;
+      }
+    }
+    for ( Int j = 0; j != iRoiHeight; j++ )
+    {
+      for ( Int k = 0; k != iRoiWidth; k++ )
+      {
+        Int iIdx = j * iRoiWidth + k;
+        const Double dGradX = pdDerivate[0][iIdx];
+        const Double dGradY = pdDerivate[1][iIdx];
+        const Double dC[4]  = { dGradX, k * dGradX + j * dGradY, dGradY, j * dGradX - k * dGradY };
+
+        for ( Int col=0; col<4; col++ )
+        {
+          for ( Int row=col; row<4; row++ )
+          {
+            adSum[col][row] += dC[col] * dC[row];
+          }
+          adSum[col][4] += (Double)( piError[iIdx] * dC[col] );
+        }
+      }
+    }
+    for ( Int col=0; col<4; col++ )
+    {
+      for ( Int row=0; row<5; row++ )
+      {
+        pdEqualCoeff[col+1][row] = row < col ? adSum[row][col] : adSum[col][row];
+      }
+    }
+#else
     for ( Int j = 0; j != iRoiHeight; j++ )
     {
       for ( Int k = 0; k != iRoiWidth; k++ )
@@ -12080,6 +12152,7 @@ Void TEncSearch::xAffineMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, I
         }
       }
     }
+#endif
     solveEqual( pdEqualCoeff, 4, dAffinePara );
 
     // convert to delta mv
@@ -12121,6 +12194,20 @@ Void TEncSearch::xAffineMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, I
       acMvTemp[i] += acDeltaMv[i];
       pcCU->clipMv(acMvTemp[i]);
     }
+#if AFFINE_FAST_GRADIENT_ME
+    Bool bVisited = false;
+    for ( Int i = 0; i < iNumVisited && !bVisited; i++ )
+    {
+      bVisited = acMvVisited[i][0] == acMvTemp[0] && acMvVisited[i][1] == acMvTemp[1];
+    }
+    if ( bVisited )
+    {
+      break;
+    }
+    acMvVisited[iNumVisited][0] = acMvTemp[0];
+    acMvVisited[iNumVisited][1] = acMvTemp[1];
+    iNumVisited++;
+#endif
     vx2 =  - ( acMvTemp[1].getVer() - acMvTemp[0].getVer() ) * iRoiHeight / iRoiWidth + acMvTemp[0].getHor();
     vy2 =    ( acMvTemp[1].getHor() - acMvTemp[0].getHor() ) * iRoiHeight / iRoiWidth + acMvTemp[0].getVer();
     acMvTemp[2].set( vx2, vy2 );
@@ -12174,10 +12261,12 @@ Void TEncSearch::xAffineMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, I
     }
   }
 
+#if !AFFINE_FAST_GRADIENT_ME
   // free buffer
   for ( Int i=0; i<iParaNum; i++ )
     delete []pdEqualCoeff[i];
   delete []pdEqualCoeff;
+#endif
 
   ruiBits = uiBitsBest;
   ruiCost = uiCostBest;
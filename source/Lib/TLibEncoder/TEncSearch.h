@@ -151,6 +151,33 @@ private:
   Double*         m_tmpDerivate[2];
 #endif
 
+#if COM16_C806_EMT && HHI_RQT_INTRA_SPEEDUP
+  UInt            m_uiInitAbsPartIdx;                                  ///< first partition of the initial TU depth in xRecurIntraCodingLumaQT
+#if COM16_C983_RSAF && !JVET_C0024_QTBT
+  UInt            m_uiInitAbsPartIdxRSAF;                              ///< first partition of the initial TU depth in xRecurIntraCodingLumaQT_RSAF
+#endif
+#endif
+#if JVET_D0127_REDUNDANCY_REMOVAL
+  UInt            m_uiSavedRdModeListNSST[35];                         ///< intra RD mode list kept from the NSST-off pass
+  UInt            m_uiSavedNumRdModesNSST;
+  UInt            m_uiSavedHadModeListNSST[35];
+  Double          m_dSavedModeCostNSST[35];
+  Double          m_dSavedHadListNSST[FAST_UDI_MAX_RDMODE_NUM];
+#endif
+#if COM16_C806_EMT
+#if JVET_C0024_QTBT
+  Double          m_dBestModeCostStore;                                ///< RD cost of the best mode for each PU using DCT2
+  Double          m_dModeCostStore[35];                                ///< RD cost of each mode for each PU using DCT2
+  UInt            m_uiSavedRdModeList[35];
+  UInt            m_uiSavedNumRdModes;
+#else
+  Double          m_dBestModeCostStore[4];                             ///< RD cost of the best mode for each PU using DCT2
+  Double          m_dModeCostStore[4][35];                             ///< RD cost of each mode for each PU using DCT2
+  UInt            m_uiSavedRdModeList[4][35];
+  UInt            m_uiSavedNumRdModes[4];
+#endif
+#endif
+
 
 #if JVET_D0077_SAVE_LOAD_ENC_INFO
   UInt            m_SaveLoadPartIdx[MAX_CU_DEPTH-MIN_CU_LOG2+1][MAX_CU_DEPTH-MIN_CU_LOG2+1]; ///< partition index of the block for save/load encoder decision 
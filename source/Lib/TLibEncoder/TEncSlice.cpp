@@ -38,6 +38,10 @@
 #include "TEncTop.h"
 #include "TEncSlice.h"
 #include <math.h>
+#if PARALLEL_SUBSTREAM_ENCODING
+#include <thread>
+#include <algorithm>
+#endif
 
 //! \ingroup TLibEncoder
 //! \{
@@ -48,6 +52,11 @@
 
 TEncSlice::TEncSlice()
  : m_encCABACTableIdx(I_SLICE)
+#if PARALLEL_SUBSTREAM_ENCODING
+ , m_substreamOffset(0)
+ , m_ctuDependencyRange(1)
+ , m_crossTileDependencyRange(0)
+#endif
 {
   m_apcPicYuvPred = NULL;
   m_apcPicYuvResi = NULL;
@@ -112,6 +121,20 @@ Void TEncSlice::destroy()
     xFree( m_piRdPicQp );
     m_piRdPicQp = NULL;
   }
+
+#if PARALLEL_SUBSTREAM_ENCODING
+  for (UInt i = 0; i < m_substreamEncoders.size(); i++)
+  {
+    m_substreamEncoders[i]->destroy();
+    delete m_substreamEncoders[i];
+  }
+  m_substreamEncoders.clear();
+  for (UInt i = 0; i < m_substreamSyncContextStates.size(); i++)
+  {
+    delete m_substreamSyncContextStates[i];
+  }
+  m_substreamSyncContextStates.clear();
+#endif
 }
 
 Void TEncSlice::init( TEncTop* pcEncTop )
@@ -579,6 +602,12 @@ Void TEncSlice::setSearchRange( TComSlice* pcSlice )
       iRefPOC = pcSlice->getRefPic(e, iRefIdx)->getPOC();
       Int iNewSR = Clip3(8, iMaxSR, (iMaxSR*ADAPT_SR_SCALE*abs(iCurrPOC - iRefPOC)+iOffset)/iGOPSize);
       m_pcPredSearch->setAdaptiveSearchRange(iDir, iRefIdx, iNewSR);
+#if PARALLEL_SUBSTREAM_ENCODING
+      for (UInt i = 0; i < m_substreamEncoders.size(); i++)
+      {
+        m_substreamEncoders[i]->getPredSearch()->setAdaptiveSearchRange(iDir, iRefIdx, iNewSR);
+      }
+#endif
     }
   }
 }
@@ -826,6 +855,14 @@ Void TEncSlice::compressSlice( TComPic* pcPic, const Bool bCompressEntireSlice,
   }
 #endif
 
+#if PARALLEL_SUBSTREAM_ENCODING
+  if (xUseSubstreamThreads(pcPic, pcSlice, startCtuTsAddr, boundingCtuTsAddr))
+  {
+    xCompressSubstreams(pcPic, startCtuTsAddr, boundingCtuTsAddr, bFastDeltaQP);
+    return;
+  }
+#endif
+
   // Adjust initial state if this is the start of a dependent slice.
   {
     const UInt      ctuRsAddr               = pcPic->getPicSym()->getCtuTsToRsAddrMap( startCtuTsAddr);
@@ -1591,6 +1628,504 @@ Void TEncSlice::xGenUpdateMap (UInt uiSliceType, Int iQP,  TComStats* apcStats)
 }
 #endif
 
+#if PARALLEL_SUBSTREAM_ENCODING
+TEncSubstreamEncoder::TEncSubstreamEncoder()
+#if JVET_C0024_QTBT
+: m_ppppcRDSbacCoder  ( NULL )
+, m_ppppcBinCoderCABAC( NULL )
+, m_uiNumSizeIdx      ( 0 )
+#else
+: m_pppcRDSbacCoder   ( NULL )
+, m_pppcBinCoderCABAC ( NULL )
+, m_uiNumDepths       ( 0 )
+#endif
+{
+  m_cRDGoOnSbacCoder.init( &m_cRDGoOnBinCoderCABAC );
+}
+
+TEncSubstreamEncoder::~TEncSubstreamEncoder()
+{
+}
+
+/** Create the private encoding state of a substream encoding thread, set up like the one of the encoder class in TEncTop::create() and TEncTop::init().
+ */
+Void TEncSubstreamEncoder::create( TEncTop* pcEncTop )
+{
+  TComSPS &sps = *(pcEncTop->getSPS());
+#if JVET_C0024_QTBT
+  m_cCuEncoder.create( sps.getMaxTotalCUDepth(), sps.getCTUSize(), sps.getCTUSize(), sps.getChromaFormatIdc() );
+
+  m_uiNumSizeIdx = g_aucConvertToBit[sps.getCTUSize()] + 1;
+  m_ppppcRDSbacCoder   = new TEncSbac*** [m_uiNumSizeIdx];
+  m_ppppcBinCoderCABAC = new TEncBinCABACCounter*** [m_uiNumSizeIdx];
+  for (UInt w = 0; w < m_uiNumSizeIdx; w++)
+  {
+    m_ppppcRDSbacCoder[w]   = new TEncSbac** [m_uiNumSizeIdx];
+    m_ppppcBinCoderCABAC[w] = new TEncBinCABACCounter** [m_uiNumSizeIdx];
+    for (UInt h = 0; h < m_uiNumSizeIdx; h++)
+    {
+      m_ppppcRDSbacCoder[w][h]   = new TEncSbac* [CI_NUM];
+      m_ppppcBinCoderCABAC[w][h] = new TEncBinCABACCounter* [CI_NUM];
+      for (Int iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx++)
+      {
+        m_ppppcRDSbacCoder[w][h][iCIIdx]   = new TEncSbac;
+        m_ppppcBinCoderCABAC[w][h][iCIIdx] = new TEncBinCABACCounter;
+        m_ppppcRDSbacCoder[w][h][iCIIdx]->init( m_ppppcBinCoderCABAC[w][h][iCIIdx] );
+      }
+    }
+  }
+#else
+  m_cCuEncoder.create( sps.getMaxTotalCUDepth(), sps.getMaxCUWidth(), sps.getMaxCUHeight(), sps.getChromaFormatIdc() );
+
+  m_uiNumDepths = sps.getMaxTotalCUDepth() + 1;
+  m_pppcRDSbacCoder = new TEncSbac** [m_uiNumDepths];
+#if FAST_BIT_EST
+  m_pppcBinCoderCABAC = new TEncBinCABACCounter** [m_uiNumDepths];
+#else
+  m_pppcBinCoderCABAC = new TEncBinCABAC** [m_uiNumDepths];
+#endif
+  for (UInt iDepth = 0; iDepth < m_uiNumDepths; iDepth++)
+  {
+    m_pppcRDSbacCoder[iDepth] = new TEncSbac* [CI_NUM];
+#if FAST_BIT_EST
+    m_pppcBinCoderCABAC[iDepth] = new TEncBinCABACCounter* [CI_NUM];
+#else
+    m_pppcBinCoderCABAC[iDepth] = new TEncBinCABAC* [CI_NUM];
+#endif
+    for (Int iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx++)
+    {
+      m_pppcRDSbacCoder[iDepth][iCIIdx] = new TEncSbac;
+#if FAST_BIT_EST
+      m_pppcBinCoderCABAC[iDepth][iCIIdx] = new TEncBinCABACCounter;
+#else
+      m_pppcBinCoderCABAC[iDepth][iCIIdx] = new TEncBinCABAC;
+#endif
+      m_pppcRDSbacCoder[iDepth][iCIIdx]->init( m_pppcBinCoderCABAC[iDepth][iCIIdx] );
+    }
+  }
+#endif
+
+#if JVET_C0024_QTBT
+  m_cTrQuant.init( sps.getCTUSize(),
+#else
+  m_cTrQuant.init( 1 << pcEncTop->getQuadtreeTULog2MaxSize(),
+#endif
+#if VCEG_AZ08_USE_KLT
+                   pcEncTop->getUseKLT(),
+#endif
+                   pcEncTop->getUseRDOQ(),
+                   pcEncTop->getUseRDOQTS(),
+#if T0196_SELECTIVE_RDOQ
+                   pcEncTop->getUseSelectiveRDOQ(),
+#endif
+                   true
+                  ,pcEncTop->getUseTransformSkipFast()
+#if ADAPTIVE_QP_SELECTION
+                  ,pcEncTop->getUseAdaptQpSelect()
+#endif
+                  );
+
+  const Int maxLog2TrDynamicRange[MAX_NUM_CHANNEL_TYPE] =
+  {
+    sps.getMaxLog2TrDynamicRange(CHANNEL_TYPE_LUMA),
+    sps.getMaxLog2TrDynamicRange(CHANNEL_TYPE_CHROMA)
+  };
+  if (pcEncTop->getUseScalingListId() == SCALING_LIST_OFF)
+  {
+    m_cTrQuant.setFlatScalingList(maxLog2TrDynamicRange, sps.getBitDepths());
+    m_cTrQuant.setUseScalingList(false);
+  }
+  else
+  {
+    m_cTrQuant.setScalingList(&(sps.getScalingList()), maxLog2TrDynamicRange, sps.getBitDepths());
+    m_cTrQuant.setUseScalingList(true);
+  }
+
+#if JVET_C0024_QTBT
+  m_cSearch.init( pcEncTop, &m_cTrQuant, pcEncTop->getSearchRange(), pcEncTop->getBipredSearchRange(), pcEncTop->getFastSearch(), sps.getCTUSize(), sps.getCTUSize(), sps.getMaxTotalCUDepth(),
+                  &m_cEntropyCoder, &m_cRdCost, m_ppppcRDSbacCoder, &m_cRDGoOnSbacCoder );
+  m_cCuEncoder.init( pcEncTop, &m_cSearch, &m_cTrQuant, &m_cRdCost, &m_cEntropyCoder, m_ppppcRDSbacCoder, &m_cRDGoOnSbacCoder, pcEncTop->getRateCtrl() );
+#else
+  m_cSearch.init( pcEncTop, &m_cTrQuant, pcEncTop->getSearchRange(), pcEncTop->getBipredSearchRange(), pcEncTop->getFastSearch(), sps.getMaxCUWidth(), sps.getMaxCUHeight(), sps.getMaxTotalCUDepth(),
+                  &m_cEntropyCoder, &m_cRdCost, m_pppcRDSbacCoder, &m_cRDGoOnSbacCoder );
+  m_cCuEncoder.init( pcEncTop, &m_cSearch, &m_cTrQuant, &m_cRdCost, &m_cEntropyCoder, m_pppcRDSbacCoder, &m_cRDGoOnSbacCoder, pcEncTop->getRateCtrl() );
+#endif
+}
+
+Void TEncSubstreamEncoder::destroy()
+{
+  m_cCuEncoder.destroy();
+  m_cSearch.destroy();
+#if JVET_C0024_QTBT
+  for (UInt w = 0; w < m_uiNumSizeIdx; w++)
+  {
+    for (UInt h = 0; h < m_uiNumSizeIdx; h++)
+    {
+      for (Int iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx++)
+      {
+        delete m_ppppcRDSbacCoder[w][h][iCIIdx];
+        delete m_ppppcBinCoderCABAC[w][h][iCIIdx];
+      }
+      delete[] m_ppppcRDSbacCoder[w][h];
+      delete[] m_ppppcBinCoderCABAC[w][h];
+    }
+    delete[] m_ppppcRDSbacCoder[w];
+    delete[] m_ppppcBinCoderCABAC[w];
+  }
+  delete[] m_ppppcRDSbacCoder;
+  delete[] m_ppppcBinCoderCABAC;
+  m_ppppcRDSbacCoder   = NULL;
+  m_ppppcBinCoderCABAC = NULL;
+  m_uiNumSizeIdx       = 0;
+#else
+  for (UInt iDepth = 0; iDepth < m_uiNumDepths; iDepth++)
+  {
+    for (Int iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx++)
+    {
+      delete m_pppcRDSbacCoder[iDepth][iCIIdx];
+      delete m_pppcBinCoderCABAC[iDepth][iCIIdx];
+    }
+    delete[] m_pppcRDSbacCoder[iDepth];
+    delete[] m_pppcBinCoderCABAC[iDepth];
+  }
+  delete[] m_pppcRDSbacCoder;
+  delete[] m_pppcBinCoderCABAC;
+  m_pppcRDSbacCoder   = NULL;
+  m_pppcBinCoderCABAC = NULL;
+  m_uiNumDepths       = 0;
+#endif
+}
+
+/** Create the private encoding state of the substream encoding threads (called once the SPS and the scaling lists are set up).
+ */
+Void TEncSlice::createSubstreamEncoders( TEncTop* pcEncTop )
+{
+  const UInt numEncoders = pcEncTop->getNumSubstreamThreads() > 1 ? UInt(pcEncTop->getNumSubstreamThreads()) : 0;
+  while (m_substreamEncoders.size() < numEncoders)
+  {
+    m_substreamEncoders.push_back(new TEncSubstreamEncoder);
+    m_substreamEncoders.back()->create(pcEncTop);
+  }
+
+  const TComSPS &sps = *(pcEncTop->getSPS());
+  m_ctuDependencyRange       = 1;
+  m_crossTileDependencyRange = 0;
+#if VCEG_AZ08_INTRA_KLT
+#if VCEG_AZ08_USE_KLT
+  if (sps.getUseIntraKLT())
+#endif
+  {
+    // the intra template matching search of the KLT reaches SEARCHRANGEINTRA samples beyond the current CTU,
+    // without regard to tile boundaries
+    m_crossTileDependencyRange = (SEARCHRANGEINTRA + sps.getCTUSize() - 1) / sps.getCTUSize();
+    m_ctuDependencyRange      += m_crossTileDependencyRange;
+  }
+#endif
+}
+
+#if JVET_C0024_AMAX_BT && PARALLEL_SEGMENT_ENCODING
+Void TEncSlice::getBlkStats( Int iLayer, UInt& ruiBlkSize, UInt& ruiNumBlk )
+{
+  ruiBlkSize = m_pcCuEncoder->getBlkSize( iLayer );
+  ruiNumBlk  = m_pcCuEncoder->getNumBlk( iLayer );
+  for (UInt i = 0; i < m_substreamEncoders.size(); i++)
+  {
+    ruiBlkSize += m_substreamEncoders[i]->getCuEncoder()->getBlkSize( iLayer );
+    ruiNumBlk  += m_substreamEncoders[i]->getCuEncoder()->getNumBlk( iLayer );
+  }
+}
+
+Void TEncSlice::clearBlkStats( Int iLayer )
+{
+  m_pcCuEncoder->clearBlkStats( iLayer );
+  for (UInt i = 0; i < m_substreamEncoders.size(); i++)
+  {
+    m_substreamEncoders[i]->getCuEncoder()->clearBlkStats( iLayer );
+  }
+}
+
+Void TEncSlice::clearBlkStats()
+{
+  m_pcCuEncoder->clearBlkStats();
+  for (UInt i = 0; i < m_substreamEncoders.size(); i++)
+  {
+    m_substreamEncoders[i]->getCuEncoder()->clearBlkStats();
+  }
+}
+
+#if PARALLEL_PICTURE_ENCODING
+Void TEncSlice::addBlkStats( TEncSlice* pcSrc )
+{
+  for (Int iLayer = 0; iLayer < 10; iLayer++)
+  {
+    UInt uiBlkSize, uiNumBlk;
+    pcSrc->getBlkStats( iLayer, uiBlkSize, uiNumBlk );
+    m_pcCuEncoder->addBlkStats( iLayer, uiBlkSize, uiNumBlk );
+  }
+  pcSrc->clearBlkStats();
+}
+#endif
+#endif
+Bool TEncSlice::xUseSubstreamThreads( TComPic* pcPic, TComSlice* pcSlice, UInt startCtuTsAddr, UInt boundingCtuTsAddr )
+{
+  if (m_substreamEncoders.size() < 2 || m_pcCfg->getUseRateCtrl()
+#if ADAPTIVE_QP_SELECTION
+      || m_pcCfg->getUseAdaptQpSelect()
+#endif
+      || pcSlice->getSliceMode() == FIXED_NUMBER_OF_BYTES || pcSlice->getSliceSegmentMode() == FIXED_NUMBER_OF_BYTES
+      || pcSlice->getPPS()->getDependentSliceSegmentsEnabledFlag() )
+  {
+    // the CTU-level rate control and the adaptive QP selection are updated after each CTU in coding order,
+    // a byte limit on the slice (segment) ends it after a CTU that is not known in advance,
+    // and a dependent slice segment continues with the context states left by the previous slice segment in coding order
+    return false;
+  }
+  // a slice segment has several substreams if it spans several tiles or wavefront rows
+  return pcPic->getSubstreamForCtuAddr(boundingCtuTsAddr-1, false, pcSlice) != pcPic->getSubstreamForCtuAddr(startCtuTsAddr, false, pcSlice);
+}
+
+/** Compress the substreams (wavefront rows or tiles) of the current slice segment on several threads.
+ * The substreams are distributed over the substream encoding threads in turn, so that the encoding result does not depend on the timing
+ * of the threads. Before a CTU is compressed, its thread waits until the CTUs referenced by it (the upper-right CTU for the wavefront
+ * context synchronisation and the intra prediction, and any CTU in reach of the intra template search) have been compressed.
+ */
+Void TEncSlice::xCompressSubstreams( TComPic* pcPic, UInt startCtuTsAddr, UInt boundingCtuTsAddr, const Bool bFastDeltaQP )
+{
+  TComSlice* pcSlice = pcPic->getSlice(getSliceIdx());
+
+  m_substreamOffset = pcPic->getSubstreamForCtuAddr(startCtuTsAddr, false, pcSlice);
+  m_substreamStartCtuTsAddr.clear();
+  for (UInt ctuTsAddr = startCtuTsAddr; ctuTsAddr < boundingCtuTsAddr; ctuTsAddr++)
+  {
+    if (pcPic->getSubstreamForCtuAddr(ctuTsAddr, false, pcSlice) - m_substreamOffset == m_substreamStartCtuTsAddr.size())
+    {
+      m_substreamStartCtuTsAddr.push_back(ctuTsAddr);
+    }
+  }
+  m_substreamCompressedCtuTsAddr = m_substreamStartCtuTsAddr;
+  const UInt numSubstreams = UInt(m_substreamStartCtuTsAddr.size());
+
+  while (m_substreamSyncContextStates.size() < numSubstreams)
+  {
+    m_substreamSyncContextStates.push_back(new TEncSbac);
+  }
+
+  // the substream encoders work with the lambdas, distortion weights and search ranges of the current slice
+  const UInt numThreads = std::min<UInt>(UInt(m_substreamEncoders.size()), numSubstreams);
+  for (UInt i = 0; i < numThreads; i++)
+  {
+    TEncSubstreamEncoder *pcEncoder = m_substreamEncoders[i];
+    *(pcEncoder->getRdCost()) = *m_pcRdCost;
+#if RDOQ_CHROMA_LAMBDA
+    pcEncoder->getTrQuant()->setLambdas( m_pcTrQuant->getLambdas() );
+#else
+    pcEncoder->getTrQuant()->setLambda( m_pcTrQuant->getLambda() );
+#endif
+    pcEncoder->getCuEncoder()->setFastDeltaQp( bFastDeltaQP );
+#if VCEG_AZ07_BAC_ADAPT_WDOW || VCEG_AZ07_INIT_PREVFRAME
+    pcEncoder->getEntropyCoder()->setStatsHandle( pcSlice->getStatsHandle() );
+#endif
+    pcEncoder->getEntropyCoder()->setEntropyCoder( pcEncoder->getRDSbacCoder() );
+#if ALF_HM3_REFACTOR
+    pcEncoder->getEntropyCoder()->setAlfCtrl(false);
+    pcEncoder->getEntropyCoder()->setMaxAlfCtrlDepth(0);
+#endif
+  }
+
+#if JVET_C0024_QTBT
+  // each thread follows the luma/chroma coding tree of its own CTU
+  m_sliceEndTextType = pcSlice->getTextType();
+  pcSlice->setThreadTextType(true);
+#endif
+
+  std::vector<std::thread> threads;
+  for (UInt i = 0; i < numThreads; i++)
+  {
+    threads.push_back(std::thread(&TEncSlice::xCompressSubstreamsThread, this, i, pcPic, boundingCtuTsAddr));
+  }
+  for (UInt i = 0; i < numThreads; i++)
+  {
+    threads[i].join();
+  }
+
+#if JVET_C0024_QTBT
+  pcSlice->setThreadTextType(false);
+  pcSlice->setTextType(m_sliceEndTextType);
+#endif
+}
+
+Void TEncSlice::xCompressSubstreamsThread( UInt threadIdx, TComPic* pcPic, UInt boundingCtuTsAddr )
+{
+  TComSlice* pcSlice                   = pcPic->getSlice(getSliceIdx());
+  const UInt frameWidthInCtus          = pcPic->getPicSym()->getFrameWidthInCtus();
+  const UInt numThreads                = std::min<UInt>(UInt(m_substreamEncoders.size()), UInt(m_substreamStartCtuTsAddr.size()));
+  TEncSubstreamEncoder *pcEncoder      = m_substreamEncoders[threadIdx];
+  TEncEntropy          *pcEntropyCoder = pcEncoder->getEntropyCoder();
+  TEncSbac             *pcRDSbacCoder  = pcEncoder->getRDSbacCoder();
+  TEncSbac             *pcGoOnSbac     = pcEncoder->getRDGoOnSbacCoder();
+  TEncCu               *pcCuEncoder    = pcEncoder->getCuEncoder();
+  TEncBinCABAC         *pRDSbacCoder   = (TEncBinCABAC *) pcRDSbacCoder->getEncBinIf();
+  TComBitCounter        tempBitCounter;
+  UInt64                uiPicTotalBits = 0;
+  UInt64                uiPicDist      = 0;
+  Double                dPicRdCost     = 0;
+#if JVET_D0033_ADAPTIVE_CLIPPING
+  g_ClipParam = pcPic->m_aclip_prm;
+#endif
+
+  pRDSbacCoder->setBinCountingEnableFlag( false );
+  pRDSbacCoder->setBinsCoded( 0 );
+
+  for (UInt substreamIdx = threadIdx; substreamIdx < m_substreamStartCtuTsAddr.size(); substreamIdx += numThreads)
+  {
+    const UInt substreamStartCtuTsAddr = m_substreamStartCtuTsAddr[substreamIdx];
+
+    pcEntropyCoder->setEntropyCoder( pcRDSbacCoder );
+    pcEntropyCoder->resetEntropy   ( pcSlice );
+
+    for (UInt ctuTsAddr = substreamStartCtuTsAddr; ctuTsAddr < boundingCtuTsAddr && pcPic->getSubstreamForCtuAddr(ctuTsAddr, false, pcSlice) - m_substreamOffset == substreamIdx; ctuTsAddr++)
+    {
+      xWaitForReferenceCtus( pcPic, pcSlice, ctuTsAddr );
+
+      const UInt ctuRsAddr = pcPic->getPicSym()->getCtuTsToRsAddrMap(ctuTsAddr);
+      TComDataCU* pCtu = pcPic->getCtu( ctuRsAddr );
+      pCtu->initCtu( pcPic, ctuRsAddr );
+
+      // update CABAC state
+      const UInt firstCtuRsAddrOfTile = pcPic->getPicSym()->getTComTile(pcPic->getPicSym()->getTileIdxMap(ctuRsAddr))->getFirstCtuRsAddr();
+      const UInt tileXPosInCtus = firstCtuRsAddrOfTile % frameWidthInCtus;
+      const UInt ctuXPosInCtus  = ctuRsAddr % frameWidthInCtus;
+
+      if (ctuRsAddr == firstCtuRsAddrOfTile)
+      {
+        pcRDSbacCoder->resetEntropy(pcSlice);
+      }
+      else if ( ctuXPosInCtus == tileXPosInCtus && m_pcCfg->getWaveFrontsynchro())
+      {
+        // reset and then update contexts to the state at the end of the top-right CTU (if within current slice and tile).
+        pcRDSbacCoder->resetEntropy(pcSlice);
+        TComDataCU *pCtuUp = pCtu->getCtuAbove();
+        if ( pCtuUp && ((ctuRsAddr%frameWidthInCtus+1) < frameWidthInCtus)  )
+        {
+          TComDataCU *pCtuTR = pcPic->getCtu( ctuRsAddr - frameWidthInCtus + 1 );
+          if ( pCtu->CUIsFromSameSliceAndTile(pCtuTR) )
+          {
+            // the top-right CTU is the second CTU of the row above, which is the previous substream
+            pcRDSbacCoder->loadContexts( m_substreamSyncContextStates[substreamIdx-1] );
+          }
+        }
+      }
+
+      // set go-on entropy coder (used for all trial encodings - the cu encoder and encoder search also have a copy of the same pointer)
+      pcEntropyCoder->setEntropyCoder ( pcGoOnSbac );
+      pcEntropyCoder->setBitstream( &tempBitCounter );
+      tempBitCounter.resetBits();
+
+#if VCEG_AZ07_INIT_PREVFRAME
+      if( pcSlice->getSliceType() != I_SLICE && ctuTsAddr == 0 )
+      {
+        pcRDSbacCoder->loadContextsFromPrev( pcSlice->getStatsHandle(), pcSlice->getSliceType(), pcSlice->getCtxMapQPIdx(), true, pcSlice->getCtxMapQPIdxforStore(), (pcSlice->getPOC() >  pcSlice->getStatsHandle()->m_uiLastIPOC) ); 
+      }
+#endif
+
+      pcGoOnSbac->load( pcRDSbacCoder );
+      ((TEncBinCABAC*)pcGoOnSbac->getEncBinIf())->setBinCountingEnableFlag(true);
+
+      // run CTU trial encoder
+      pcCuEncoder->compressCtu( pCtu );
+
+      // encode CTU with the contexts of the substream, to update them and count the bits
+      pcEntropyCoder->setEntropyCoder ( pcRDSbacCoder );
+      pcEntropyCoder->setBitstream( &tempBitCounter );
+      pRDSbacCoder->setBinCountingEnableFlag( true );
+      pcRDSbacCoder->resetBits();
+      pRDSbacCoder->setBinsCoded( 0 );
+
+      pcCuEncoder->encodeCtu( pCtu );
+
+      pRDSbacCoder->setBinCountingEnableFlag( false );
+
+      const Int numberOfWrittenBits = pcEntropyCoder->getNumberOfWrittenBits();
+
+      // Store probabilities of second CTU in line into buffer - used only if wavefront-parallel-processing is enabled.
+      if ( ctuXPosInCtus == tileXPosInCtus+1 && m_pcCfg->getWaveFrontsynchro())
+      {
+        m_substreamSyncContextStates[substreamIdx]->loadContexts( pcRDSbacCoder );
+      }
+
+      uiPicTotalBits += pCtu->getTotalBits();
+      dPicRdCost     += pCtu->getTotalCost();
+      uiPicDist      += pCtu->getTotalDistortion();
+
+#if JVET_C0024_QTBT
+      if (ctuTsAddr + 1 == boundingCtuTsAddr)
+      {
+        m_sliceEndTextType = pcSlice->getTextType();
+      }
+#endif
+
+      {
+        std::lock_guard<std::mutex> lock(m_substreamMutex);
+        pcSlice->setSliceBits( (UInt)(pcSlice->getSliceBits() + numberOfWrittenBits) );
+        pcSlice->setSliceSegmentBits(pcSlice->getSliceSegmentBits()+numberOfWrittenBits);
+        m_substreamCompressedCtuTsAddr[substreamIdx] = ctuTsAddr + 1;
+      }
+      m_substreamProgress.notify_all();
+    }
+  }
+
+  pcRDSbacCoder->setBitstream(NULL);
+  pcGoOnSbac->setBitstream(NULL);
+
+  std::lock_guard<std::mutex> lock(m_substreamMutex);
+  m_uiPicTotalBits += uiPicTotalBits;
+  m_dPicRdCost     += dPicRdCost;
+  m_uiPicDist      += uiPicDist;
+}
+
+/** Wait until the CTUs of the current slice segment preceding the given CTU in coding order that may be referenced by its compression are compressed.
+ */
+Void TEncSlice::xWaitForReferenceCtus( TComPic* pcPic, TComSlice* pcSlice, UInt ctuTsAddr )
+{
+  const TComPicSym &picSym     = *(pcPic->getPicSym());
+  const Int  frameWidthInCtus  = picSym.getFrameWidthInCtus();
+  const UInt ctuRsAddr         = picSym.getCtuTsToRsAddrMap(ctuTsAddr);
+  const Int  ctuXPosInCtus     = ctuRsAddr % frameWidthInCtus;
+  const Int  ctuYPosInCtus     = ctuRsAddr / frameWidthInCtus;
+  const Int  frameHeightInCtus = picSym.getFrameHeightInCtus();
+  const UInt startCtuTsAddr    = m_substreamStartCtuTsAddr[0];
+  const UInt tileIdx           = picSym.getTileIdxMap(ctuRsAddr);
+  const Int  range             = std::max(m_ctuDependencyRange, m_crossTileDependencyRange);
+
+  std::unique_lock<std::mutex> lock(m_substreamMutex);
+  // within a tile the CTUs below are compressed later; the CTUs of another tile compressed earlier may also lie below, and read samples
+  // of the current CTU that must not be reconstructed before
+  for (Int y = std::max(0, ctuYPosInCtus - range); y <= std::min(frameHeightInCtus - 1, ctuYPosInCtus + m_crossTileDependencyRange); y++)
+  {
+    for (Int x = std::max(0, ctuXPosInCtus - range); x <= std::min(frameWidthInCtus - 1, ctuXPosInCtus + range); x++)
+    {
+      const UInt refCtuRsAddr = y * frameWidthInCtus + x;
+      const UInt refCtuTsAddr = picSym.getCtuRsToTsAddrMap(refCtuRsAddr);
+      if (refCtuTsAddr >= ctuTsAddr || refCtuTsAddr < startCtuTsAddr)
+      {
+        // compressed after the current CTU, or part of an earlier slice segment that is already complete
+        continue;
+      }
+      const Int refRange = picSym.getTileIdxMap(refCtuRsAddr) == tileIdx ? m_ctuDependencyRange : m_crossTileDependencyRange;
+      if (abs(x - ctuXPosInCtus) > refRange || abs(y - ctuYPosInCtus) > refRange)
+      {
+        continue;
+      }
+      const UInt substreamIdx = pcPic->getSubstreamForCtuAddr(refCtuRsAddr, true, pcSlice) - m_substreamOffset;
+      while (m_substreamCompressedCtuTsAddr[substreamIdx] <= refCtuTsAddr)
+      {
+        m_substreamProgress.wait(lock);
+      }
+    }
+  }
+}
+#endif
+
 #if VCEG_AZ08_INTER_KLT
 Void TEncSlice::InterpolatePic(TComPic* pcPic)
 {
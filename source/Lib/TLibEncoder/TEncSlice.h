@@ -46,6 +46,11 @@
 #include "TEncCu.h"
 #include "WeightPredAnalysis.h"
 #include "TEncRateCtrl.h"
+#if PARALLEL_SUBSTREAM_ENCODING
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#endif
 
 //! \ingroup TLibEncoder
 //! \{
@@ -57,6 +62,57 @@ class TEncGOP;
 // Class definition
 // ====================================================================================================================
 
+#if PARALLEL_SUBSTREAM_ENCODING
+/// private search, transform and RD entropy coding state of one substream encoding thread
+class TEncSubstreamEncoder
+{
+private:
+  TEncCu                  m_cCuEncoder;
+  TEncSearch              m_cSearch;
+  TComTrQuant             m_cTrQuant;
+  TComRdCost              m_cRdCost;
+  TEncEntropy             m_cEntropyCoder;
+#if JVET_C0024_QTBT
+  TEncSbac****            m_ppppcRDSbacCoder;
+  TEncBinCABACCounter**** m_ppppcBinCoderCABAC;
+  UInt                    m_uiNumSizeIdx;                       ///< number of width (and height) indices of the RD SBAC storage
+#else
+  TEncSbac***             m_pppcRDSbacCoder;
+#if FAST_BIT_EST
+  TEncBinCABACCounter***  m_pppcBinCoderCABAC;
+#else
+  TEncBinCABAC***         m_pppcBinCoderCABAC;
+#endif
+  UInt                    m_uiNumDepths;                        ///< number of depths of the RD SBAC storage
+#endif
+  TEncSbac                m_cRDGoOnSbacCoder;
+#if FAST_BIT_EST
+  TEncBinCABACCounter     m_cRDGoOnBinCoderCABAC;
+#else
+  TEncBinCABAC            m_cRDGoOnBinCoderCABAC;
+#endif
+
+public:
+  TEncSubstreamEncoder();
+  ~TEncSubstreamEncoder();
+
+  Void  create            ( TEncTop* pcEncTop );
+  Void  destroy           ();
+
+  TEncCu*         getCuEncoder      ()  { return &m_cCuEncoder;      }
+  TEncSearch*     getPredSearch     ()  { return &m_cSearch;         }
+  TComTrQuant*    getTrQuant        ()  { return &m_cTrQuant;        }
+  TComRdCost*     getRdCost         ()  { return &m_cRdCost;         }
+  TEncEntropy*    getEntropyCoder   ()  { return &m_cEntropyCoder;   }
+  TEncSbac*       getRDGoOnSbacCoder()  { return &m_cRDGoOnSbacCoder; }
+#if JVET_C0024_QTBT
+  TEncSbac*       getRDSbacCoder    ()  { return m_ppppcRDSbacCoder[m_uiNumSizeIdx-1][m_uiNumSizeIdx-1][CI_CURR_BEST]; }
+#else
+  TEncSbac*       getRDSbacCoder    ()  { return m_pppcRDSbacCoder[0][CI_CURR_BEST]; }
+#endif
+};
+#endif
+
 /// slice encoder class
 class TEncSlice
   : public WeightPredAnalysis
@@ -105,6 +161,20 @@ private:
 #if PARALLEL_ENCODING_RAS_CABAC_INIT_PRESENT  
   NalUnitType             m_eLastNALUType;
 #endif
+#if PARALLEL_SUBSTREAM_ENCODING
+  std::vector<TEncSubstreamEncoder*>  m_substreamEncoders;             ///< private encoding state of each substream encoding thread
+  std::vector<TEncSbac*>              m_substreamSyncContextStates;    ///< per-substream storage of the contexts at the second CTU of a wavefront row
+  std::vector<UInt>                   m_substreamStartCtuTsAddr;       ///< first CTU (tile-scan address) of each substream of the current slice segment
+  std::vector<UInt>                   m_substreamCompressedCtuTsAddr;  ///< first CTU (tile-scan address) of each substream that has not been compressed yet
+  UInt                                m_substreamOffset;               ///< global substream index of the first substream of the current slice segment
+  Int                                 m_ctuDependencyRange;            ///< distance in CTUs up to which the compression of a CTU depends on previously compressed CTUs of the same tile
+  Int                                 m_crossTileDependencyRange;      ///< distance in CTUs up to which the compression of a CTU reads samples of other tiles (0: tiles are independent)
+#if JVET_C0024_QTBT
+  ChannelType                         m_sliceEndTextType;              ///< channel type left by the last CTU of the slice segment
+#endif
+  std::mutex                          m_substreamMutex;
+  std::condition_variable             m_substreamProgress;
+#endif
 
   Void     setUpLambda(TComSlice* slice, const Double dLambda, Int iQP);
   Void     calculateBoundingCtuTsAddrForSlice(UInt &startCtuTSAddrSlice, UInt &boundingCtuTSAddrSlice, Bool &haveReachedTileBoundary, TComPic* pcPic, const Int sliceMode, const Int sliceArgument);
@@ -156,8 +226,27 @@ public:
 #if VCEG_AZ08_INTER_KLT
   Void   InterpolatePic(TComPic* pcPic);
 #endif
+#if PARALLEL_SUBSTREAM_ENCODING
+  Void    createSubstreamEncoders ( TEncTop* pcEncTop );
+#endif
+#if JVET_C0024_AMAX_BT && PARALLEL_SEGMENT_ENCODING
+  /// block size statistics of the inter slices of a temporal layer, summed over all CU encoders of the slice encoder
+  Void    getBlkStats         ( Int iLayer, UInt& ruiBlkSize, UInt& ruiNumBlk );
+  Void    clearBlkStats       ( Int iLayer );
+  Void    clearBlkStats       ();
+#if PARALLEL_PICTURE_ENCODING
+  /// moves the statistics gathered by the slice encoder of a picture encoding thread to this one
+  Void    addBlkStats         ( TEncSlice* pcSrc );
+#endif
+#endif
 private:
   Double  xGetQPValueAccordingToLambda ( Double lambda );
+#if PARALLEL_SUBSTREAM_ENCODING
+  Bool    xUseSubstreamThreads        ( TComPic* pcPic, TComSlice* pcSlice, UInt startCtuTsAddr, UInt boundingCtuTsAddr );
+  Void    xCompressSubstreams         ( TComPic* pcPic, UInt startCtuTsAddr, UInt boundingCtuTsAddr, const Bool bFastDeltaQP );
+  Void    xCompressSubstreamsThread   ( UInt threadIdx, TComPic* pcPic, UInt boundingCtuTsAddr );
+  Void    xWaitForReferenceCtus       ( TComPic* pcPic, TComSlice* pcSlice, UInt ctuTsAddr );
+#endif
 };
 
 //! \}
@@ -194,6 +194,9 @@ Void TEncTop::create ()
     m_cAdaptiveLoopFilter.create( getSourceWidth(), getSourceHeight(), getChromaFormatIdc(), m_CTUSize, m_CTUSize, m_maxTotalCUDepth , m_bitDepth[CHANNEL_TYPE_LUMA] , m_bitDepth[CHANNEL_TYPE_LUMA] );
 #else
     m_cAdaptiveLoopFilter.create( getSourceWidth(), getSourceHeight(), getChromaFormatIdc(), m_maxCUWidth, m_maxCUHeight, m_maxTotalCUDepth , m_bitDepth[CHANNEL_TYPE_LUMA] , m_bitDepth[CHANNEL_TYPE_LUMA] );
+#endif
+#if PARALLEL_ALF
+    m_cAdaptiveLoopFilter.setNumThreads( m_numAlfThreads );
 #endif
   }
 #endif
@@ -336,6 +339,14 @@ Void TEncTop::init(Bool isFieldCoding)
   m_iMaxRefPicNum = 0;
 
   xInitScalingLists();
+
+#if PARALLEL_SUBSTREAM_ENCODING
+  m_cSliceEncoder.createSubstreamEncoders( this );
+#endif
+#if PARALLEL_SEGMENT_ENCODING
+  // a segment spans one intra period; its pictures are numbered from 0 but carry their POC in the whole sequence
+  m_cCavlcCoder.setPOCLsbOffset( m_segmentIdx > 0 ? m_segmentIdx * m_uiIntraPeriod : 0 );
+#endif
 }
 
 Void TEncTop::xInitScalingLists()
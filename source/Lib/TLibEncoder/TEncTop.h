@@ -169,6 +169,13 @@ public:
 #endif
   TEncSbac*               getRDGoOnSbacCoder    () { return  &m_cRDGoOnSbacCoder;     }
   TEncRateCtrl*           getRateCtrl           () { return &m_cRateCtrl;             }
+#if PARALLEL_SUBSTREAM_ENCODING
+  TComSPS*                getSPS                () { return &m_cSPS;                  }
+#endif
+#if PARALLEL_SEGMENT_ENCODING
+  /// accumulate the statistics of the encoder of the next intra-period segment, for the summary
+  Void                    addSegmentStatistics  ( const TEncTop& rcSegment ) { m_uiNumAllPicCoded += m_cGOPEncoder.addSegmentStatistics( rcSegment.m_cGOPEncoder ); }
+#endif
   Void selectReferencePictureSet(TComSlice* slice, Int POCCurr, Int GOPid );
   Int getReferencePictureSetIdxForSOP(Int POCCurr, Int GOPid );
   // -------------------------------------------------------------------------------------------------------------------